@@ -39,6 +39,8 @@
 #define ZBX_RTC_PROXYPOLLER_PROCESS		19
 #define ZBX_RTC_PROF_ENABLE			20
 #define ZBX_RTC_PROF_DISABLE			21
+#define ZBX_RTC_LOCK_PROF_ENABLE		22
+#define ZBX_RTC_LOCK_PROF_DISABLE		23
 
 /* internal rtc messages */
 #define ZBX_RTC_SUBSCRIBE			100
@@ -68,5 +70,7 @@
 #define ZBX_PROXY_CONFIG_CACHE_RELOAD	"proxy_config_cache_reload"
 #define ZBX_PROF_ENABLE			"prof_enable"
 #define ZBX_PROF_DISABLE		"prof_disable"
+#define ZBX_LOCK_PROF_ENABLE		"lock_prof_enable"
+#define ZBX_LOCK_PROF_DISABLE		"lock_prof_disable"
 
 #endif
@@ -68,6 +68,7 @@ zbx_alerter_dispatch_t;
 typedef struct
 {
 	const char	*config_source_ip;
+	int		config_max_concurrent_alerts;
 }
 zbx_thread_alerter_args;
 
@@ -77,6 +78,7 @@ typedef struct
 	zbx_get_config_str_f		get_scripts_path_cb_arg;
 	const zbx_config_dbhigh_t	*config_dbhigh;
 	const char			*config_source_ip;
+	int				config_max_concurrent_alerts;
 }
 zbx_thread_alert_manager_args;
 
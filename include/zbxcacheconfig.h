@@ -28,6 +28,7 @@
 #include "zbxvault.h"
 #include "zbxregexp.h"
 #include "zbxtagfilter.h"
+#include "zbxshmem.h"
 
 #define	ZBX_NO_POLLER			255
 #define	ZBX_POLLER_TYPE_NORMAL		0
@@ -733,6 +734,35 @@ zbx_synced_new_config_t;
 typedef struct zbx_dc_um_shared_handle zbx_dc_um_shared_handle_t;
 typedef struct zbx_um_cache zbx_um_cache_t;
 
+/* resolved user macro cache statistics */
+typedef struct
+{
+	zbx_uint64_t	hits;
+	zbx_uint64_t	misses;
+}
+zbx_um_cache_stats_t;
+
+/* configuration cache memory used by objects of one type */
+typedef struct
+{
+	const char	*name;
+	zbx_uint64_t	objects_num;
+	zbx_uint64_t	size;		/* memory used by objects and their index, excluding strings */
+}
+zbx_dc_object_mem_stats_t;
+
+ZBX_VECTOR_DECL(dc_object_mem_stats, zbx_dc_object_mem_stats_t)
+
+/* configuration cache string pool statistics */
+typedef struct
+{
+	zbx_uint64_t	strings_num;
+	zbx_uint64_t	refs_num;	/* number of object fields referencing pooled strings */
+	zbx_uint64_t	size;		/* memory used by pooled strings */
+	zbx_uint64_t	shared_size;	/* memory that would be used by duplicate strings without pooling */
+}
+zbx_dc_strpool_stats_t;
+
 void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synced,
 		zbx_vector_uint64_t *deleted_itemids, const zbx_config_vault_t *config_vault,
 		int proxyconfig_frequency);
@@ -841,6 +871,7 @@ int	zbx_dc_get_host_inventory_value_by_hostid(zbx_uint64_t hostid, char **replac
 #define ZBX_CONFSTATS_BUFFER_FREE	3
 #define ZBX_CONFSTATS_BUFFER_PUSED	4
 #define ZBX_CONFSTATS_BUFFER_PFREE	5
+#define ZBX_CONFSTATS_BUFFER_HUGE_PAGES	6
 void	*zbx_dc_config_get_stats(int request);
 
 int	zbx_dc_config_get_last_sync_time(void);
@@ -938,6 +969,29 @@ void	zbx_dc_correlation_rules_get(zbx_correlation_rules_t *rules);
 
 void	zbx_dc_get_nested_hostgroupids(zbx_uint64_t *groupids, int groupids_num, zbx_vector_uint64_t *nested_groupids);
 void	zbx_dc_get_hostids_by_group_name(const char *name, zbx_vector_uint64_t *hostids);
+void	zbx_dc_match_hostgroup_objects(int object, const zbx_vector_uint64_t *groupids,
+		const zbx_vector_uint64_t *objectids, zbx_vector_uint64_t *matched, zbx_vector_uint64_t *unmatched,
+		zbx_vector_uint64_t *unresolved);
+void	zbx_dc_match_template_objects(int object, zbx_uint64_t templateid,
+		const zbx_vector_uint64_pair_t *objectids_pair, zbx_vector_uint64_t *matched,
+		zbx_vector_uint64_t *unmatched, zbx_vector_uint64_pair_t *unresolved);
+
+typedef int	(*zbx_dc_item_key_match_func_t)(const char *key, void *data);
+
+/* item query of aggregate calculations, unset conditions are not checked */
+typedef struct
+{
+	zbx_uint64_t			hostid;		/* host identifier */
+	const char			*host;		/* host name */
+	const zbx_vector_uint64_t	*hostids;	/* sorted identifiers of allowed hosts */
+	const char			*key;		/* item key */
+	zbx_dc_item_key_match_func_t	match_key;	/* item key matching callback, NULL - exact match */
+	void				*match_data;
+	const zbx_vector_str_t		*tags;		/* required item tags in <tag>[:<value>] format */
+}
+zbx_dc_item_query_t;
+
+void	zbx_dc_get_item_query_candidates(const zbx_dc_item_query_t *query, zbx_vector_uint64_pair_t *itemhosts);
 
 
 #define ZBX_DC_FLAG_META	0x01	/* contains meta information (lastlogsize and mtime) */
@@ -1157,6 +1211,10 @@ zbx_dc_um_handle_t	*zbx_dc_open_user_macros_masked(void);
 
 void	zbx_dc_close_user_macros(zbx_dc_um_handle_t *um_handle);
 
+void	zbx_dc_get_um_cache_stats(zbx_um_cache_stats_t *stats);
+void	zbx_dc_get_mem_stats(zbx_shmem_stats_t *mem, zbx_vector_dc_object_mem_stats_t *objects,
+		zbx_dc_strpool_stats_t *strpool);
+
 void	zbx_dc_get_user_macro(const zbx_dc_um_handle_t *um_handle, const char *macro, const zbx_uint64_t *hostids,
 		int hostids_num, char **value);
 
@@ -1226,6 +1284,7 @@ void	zbx_dc_drule_revisions_get(zbx_vector_uint64_pair_t *revisions);
 int	zbx_dc_httptest_next(time_t now, zbx_uint64_t *httptestid, time_t *nextcheck);
 void	zbx_dc_httptest_queue(time_t now, zbx_uint64_t httptestid, int delay);
 
+zbx_uint64_t	zbx_dc_get_config_revision(void);
 zbx_uint64_t	zbx_dc_get_received_revision(void);
 void	zbx_dc_update_received_revision(zbx_uint64_t revision);
 
@@ -49,6 +49,9 @@ typedef struct
 	zbx_uint64_t	index_total;
 	zbx_uint64_t	trend_free;
 	zbx_uint64_t	trend_total;
+	int		history_huge_pages;
+	int		index_huge_pages;
+	int		trend_huge_pages;
 }
 zbx_wcache_info_t;
 
@@ -91,6 +94,9 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 #define ZBX_STATS_HISTORY_INDEX_PUSED	20
 #define ZBX_STATS_HISTORY_INDEX_PFREE	21
 #define ZBX_STATS_HISTORY_BIN_COUNTER	22
+#define ZBX_STATS_HISTORY_HUGE_PAGES	23
+#define ZBX_STATS_HISTORY_INDEX_HUGE_PAGES	24
+#define ZBX_STATS_TREND_HUGE_PAGES	25
 
 /* 'zbx_pp_value_opt_t' element 'flags' values */
 #define ZBX_PP_VALUE_OPT_NONE		0x0000	/* 'zbx_pp_value_opt_t' has no data */
@@ -50,6 +50,10 @@
  *   either zbx_history_record_vector_destroy() function (free the zbx_vc_get_values()
  *   call output) or zbx_history_record_clear() function (free the zbx_vc_get_value() call output).
  *
+ *   When many requests are known in advance they can be prefetched with a single cache lock
+ *   by zbx_vc_prefetch_values() function. Until zbx_vc_prefetch_clear() is called requests
+ *   covered by prefetched data are served from process local memory without locking cache.
+ *
  * Locking
  *
  *   The cache ensures synchronization between processes by using automatic locks whenever
@@ -80,6 +84,9 @@ typedef struct
 
 	/* value cache operating mode - see ZBX_VC_MODE_* defines */
 	int		mode;
+
+	/* the type of memory pages - see ZBX_SHMEM_HUGE_PAGES_* defines */
+	int		huge_pages;
 }
 zbx_vc_stats_t;
 
@@ -92,6 +99,19 @@ typedef struct
 }
 zbx_vc_item_stats_t;
 
+/* history request to be prefetched, see zbx_vc_prefetch_values() */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	unsigned char	value_type;
+	int		seconds;
+	int		count;
+	zbx_timespec_t	ts;
+}
+zbx_vc_prefetch_t;
+
+ZBX_VECTOR_DECL(vc_prefetch, zbx_vc_prefetch_t)
+
 int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error);
 
 void	zbx_vc_destroy(void);
@@ -119,4 +139,7 @@ void	zbx_vc_get_mem_stats(zbx_shmem_stats_t *mem);
 void	zbx_vc_get_item_stats(zbx_vector_ptr_t *stats);
 void	zbx_vc_flush_stats(void);
 
+void	zbx_vc_prefetch_values(zbx_vector_vc_prefetch_t *requests);
+void	zbx_vc_prefetch_clear(void);
+
 #endif
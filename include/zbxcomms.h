@@ -291,6 +291,7 @@ void	zbx_tcp_unlisten(zbx_socket_t *s);
 
 int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout);
 void	zbx_tcp_unaccept(zbx_socket_t *s);
+void	zbx_tcp_unaccept_local(zbx_socket_t *s);
 
 #define ZBX_TCP_READ_UNTIL_CLOSE 0x01
 
@@ -40,6 +40,8 @@ typedef enum
 	ZBX_DIAGINFO_LOCKS,
 	ZBX_DIAGINFO_CONNECTOR,
 	ZBX_DIAGINFO_PROXYBUFFER,
+	ZBX_DIAGINFO_CONFIGCACHE,
+	ZBX_DIAGINFO_LATENCY,
 }
 zbx_diaginfo_section_t;
 
@@ -62,6 +64,8 @@ typedef int (*zbx_diag_add_section_info_func_t)(const char *section, const struc
 #define ZBX_DIAG_LOCKS		"locks"
 #define ZBX_DIAG_CONNECTOR	"connector"
 #define ZBX_DIAG_PROXYBUFFER	"proxybuffer"
+#define ZBX_DIAG_CONFIGCACHE	"configcache"
+#define ZBX_DIAG_LATENCY	"latency"
 
 void	zbx_diag_map_free(zbx_diag_map_t *map);
 int	zbx_diag_parse_request(const struct zbx_json_parse *jp, const zbx_diag_map_t *field_map, zbx_uint64_t
@@ -70,6 +74,8 @@ void	zbx_diag_add_mem_stats(struct zbx_json *json, const char *name, const zbx_s
 int	zbx_diag_add_historycache_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
 void	zbx_diag_add_locks_info(struct zbx_json *json);
 int	zbx_diag_add_connector_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
+int	zbx_diag_add_configcache_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
+int	zbx_diag_add_latency_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
 
 void	zbx_diag_init(zbx_diag_add_section_info_func_t cb);
 int	zbx_diag_get_info(const struct zbx_json_parse *jp, char **info);
@@ -195,6 +195,18 @@ zbx_eval_token_t;
 
 ZBX_VECTOR_DECL(eval_token, zbx_eval_token_t)
 
+/* compiled expression instruction, see zbx_eval_compile() */
+typedef struct
+{
+	unsigned char	op;
+	zbx_uint32_t	from;	/* the first token of the instruction */
+	zbx_uint32_t	index;	/* the last token of the instruction */
+	zbx_variant_t	value;	/* the numeric constant value */
+}
+zbx_eval_instr_t;
+
+ZBX_VECTOR_DECL(eval_instr, zbx_eval_instr_t)
+
 typedef struct
 {
 	const char		*expression;
@@ -205,6 +217,7 @@ typedef struct
 	zbx_timespec_t		ts;
 	zbx_vector_eval_token_t	stack;
 	zbx_vector_eval_token_t	ops;
+	zbx_vector_eval_instr_t	program;
 	zbx_eval_function_cb_t	common_func_cb;
 	zbx_eval_function_cb_t	history_func_cb;
 	void			*data_cb;
@@ -225,6 +238,7 @@ size_t	zbx_eval_serialize(const zbx_eval_context_t *ctx, zbx_mem_malloc_func_t m
 void	zbx_eval_deserialize(zbx_eval_context_t *ctx, const char *expression, zbx_uint64_t rules,
 		const unsigned char *data);
 void	zbx_eval_compose_expression(const zbx_eval_context_t *ctx, char **expression);
+void	zbx_eval_compile(zbx_eval_context_t *ctx);
 int	zbx_eval_execute(zbx_eval_context_t *ctx, const zbx_timespec_t *ts, zbx_variant_t *value, char **error);
 int	zbx_eval_execute_ext(zbx_eval_context_t *ctx, const zbx_timespec_t *ts, zbx_eval_function_cb_t common_func_cb,
 		zbx_eval_function_cb_t history_func_cb, void *data, zbx_variant_t *value, char **error);
@@ -271,6 +285,8 @@ void	zbx_eval_clear_query(zbx_item_query_t *query);
 
 void	zbx_eval_prepare_filter(zbx_eval_context_t *ctx);
 int	zbx_eval_get_group_filter(zbx_eval_context_t *ctx, zbx_vector_str_t *groups, char **filter, char **error);
+void	zbx_eval_get_required_properties(const zbx_eval_context_t *ctx, zbx_vector_str_t *groups,
+		zbx_vector_str_t *tags);
 
 typedef int	(*zbx_statistical_func_t)(zbx_vector_dbl_t *values, double *result, char **error);
 
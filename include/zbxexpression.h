@@ -123,6 +123,7 @@ typedef struct
 	zbx_dc_item_t				*dcitems;
 	int					*errcodes;
 	int					dcitems_num;
+	int					dcitems_cached;
 }
 zbx_expression_eval_t;
 
@@ -151,6 +152,8 @@ void	zbx_determine_items_in_expressions(zbx_vector_dc_trigger_t *trigger_order,
 
 void	zbx_expression_eval_init(zbx_expression_eval_t *eval, int mode, zbx_eval_context_t *ctx);
 void	zbx_expression_eval_clear(zbx_expression_eval_t *eval);
+void	zbx_expression_memo_open(void);
+void	zbx_expression_memo_close(zbx_uint64_t *hits, zbx_uint64_t *misses);
 void	zbx_expression_eval_resolve_item_hosts(zbx_expression_eval_t *eval, const zbx_dc_item_t *item);
 void	zbx_expression_eval_resolve_filter_macros(zbx_expression_eval_t *eval, const zbx_dc_item_t *item);
 void	zbx_expression_eval_resolve_trigger_hosts_items(zbx_expression_eval_t *eval, const zbx_db_trigger *trigger);
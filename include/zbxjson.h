@@ -386,4 +386,16 @@ void	zbx_jsonobj_clear(zbx_jsonobj_t *obj);
 int	zbx_jsonobj_query(zbx_jsonobj_t *obj, const char *path, char **output);
 int	zbx_jsonobj_to_string(char **str, size_t *str_alloc, size_t *str_offset, zbx_jsonobj_t *obj);
 
+/* one of the jsonpath queries performed together on the same json object */
+typedef struct
+{
+	const char	*path;
+	char		*output;	/* the query result, NULL if no data matched the path */
+	char		*error;		/* the query error, NULL if the query succeeded */
+}
+zbx_jsonobj_query_t;
+
+void	zbx_jsonobj_query_batch(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, zbx_jsonobj_query_t *queries,
+		int queries_num);
+
 #endif /* ZABBIX_ZJSON_H */
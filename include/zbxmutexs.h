@@ -56,6 +56,8 @@ typedef enum
 	ZBX_MUTEX_TREND_FUNC,
 	ZBX_MUTEX_REMOTE_COMMANDS,
 	ZBX_MUTEX_PROXY_BUFFER,
+	ZBX_MUTEX_PROXY_CONFIG,
+	ZBX_MUTEX_PROBLEM_CACHE,
 	/* NOTE: Do not forget to sync changes here with mutex names in diag_add_locks_info()! */
 	ZBX_MUTEX_COUNT
 }
@@ -156,6 +158,45 @@ int		zbx_rwlock_create(zbx_rwlock_t *rwlock, zbx_rwlock_name_t name, char **erro
 zbx_mutex_t	zbx_mutex_addr_get(zbx_mutex_name_t mutex_name);
 zbx_rwlock_t	zbx_rwlock_addr_get(zbx_rwlock_name_t rwlock_name);
 
+/* lock wait and hold time histogram buckets, upper bounds are 1us, 10us, ..., 1s and infinity */
+#define ZBX_LOCK_PROF_BUCKETS	8
+#define ZBX_LOCK_PROF_SITES_MAX	16
+
+/* lock profiling counters, times are in nanoseconds */
+typedef struct
+{
+	zbx_uint64_t	locked;
+	zbx_uint64_t	contended;
+	zbx_uint64_t	wait;
+	zbx_uint64_t	wait_max;
+	zbx_uint64_t	hold;
+	zbx_uint64_t	hold_max;
+	zbx_uint64_t	wait_hist[ZBX_LOCK_PROF_BUCKETS];
+	zbx_uint64_t	hold_hist[ZBX_LOCK_PROF_BUCKETS];
+}
+zbx_lock_counters_t;
+
+typedef struct
+{
+	const char		*filename;
+	int			line;
+	zbx_lock_counters_t	counters;
+}
+zbx_lock_site_t;
+
+typedef struct
+{
+	zbx_lock_counters_t	total;
+	zbx_lock_site_t		sites[ZBX_LOCK_PROF_SITES_MAX];
+	int			sites_num;
+}
+zbx_lock_stats_t;
+
+int	zbx_locks_prof_enable(char **error);
+void	zbx_locks_prof_disable(void);
+int	zbx_mutex_prof_get(zbx_mutex_name_t mutex_name, zbx_lock_stats_t *stats);
+int	zbx_rwlock_prof_get(zbx_rwlock_name_t rwlock_name, zbx_lock_stats_t *stats);
+
 #	define zbx_mutex_lock(mutex)					\
 									\
 	do								\
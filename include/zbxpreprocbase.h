@@ -70,6 +70,18 @@ void	zbx_pp_step_free(zbx_pp_step_t *step);
 
 ZBX_PTR_VECTOR_DECL(pp_step_ptr, zbx_pp_step_t *)
 
+#define ZBX_PP_STEP_COMPILED_STATIC	0x01	/* parameters have no user macros and can be used as is */
+#define ZBX_PP_STEP_COMPILED_ARGS	0x02	/* numeric step arguments are parsed */
+
+/* preprocessing step parameters parsed during configuration sync */
+typedef struct
+{
+	unsigned char	flags;
+	zbx_variant_t	arg1;	/* multiplier, range minimum or throttling period */
+	zbx_variant_t	arg2;	/* integer multiplier or range maximum */
+}
+zbx_pp_step_compiled_t;
+
 typedef struct
 {
 	zbx_uint32_t		refcount;
@@ -77,6 +89,7 @@ typedef struct
 	zbx_uint64_t		hostid;
 	int			steps_num;
 	zbx_pp_step_t		*steps;
+	zbx_pp_step_compiled_t	*compiled;	/* parsed step parameters, optional */
 
 	int			dep_itemids_num;
 	zbx_uint64_t		*dep_itemids;
@@ -95,6 +108,7 @@ zbx_pp_item_preproc_t	*zbx_pp_item_preproc_copy(zbx_pp_item_preproc_t *preproc);
 zbx_pp_item_preproc_t	*zbx_pp_item_preproc_create(zbx_uint64_t hostid, unsigned char type, unsigned char value_type,
 		unsigned char flags);
 void	zbx_pp_item_preproc_release(zbx_pp_item_preproc_t *preproc);
+void	zbx_pp_item_preproc_compile(zbx_pp_item_preproc_t *preproc);
 int	zbx_pp_preproc_has_history(int type);
 
 typedef struct
@@ -31,6 +31,16 @@
 
 typedef struct zbx_regexp zbx_regexp_t;
 
+/* regular expression statistics of a thread */
+typedef struct
+{
+	zbx_uint64_t	compiled;	/* number of compiled regular expressions */
+	zbx_uint64_t	jit_compiled;	/* number of regular expressions compiled to machine code */
+	zbx_uint64_t	cache_hits;
+	zbx_uint64_t	cache_misses;
+}
+zbx_regexp_stats_t;
+
 typedef struct
 {
 	char		*name;
@@ -46,6 +56,9 @@ ZBX_PTR_VECTOR_DECL(expression, zbx_expression_t *)
 /* regular expressions */
 int	zbx_regexp_compile(const char *pattern, zbx_regexp_t **regexp, char **err_msg);
 int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags, char **err_msg);
+int	zbx_regexp_compile_cached(const char *pattern, const zbx_regexp_t **regexp, char **err_msg);
+int	zbx_regexp_compile_ext_cached(const char *pattern, const zbx_regexp_t **regexp, int flags, char **err_msg);
+void	zbx_regexp_get_stats(zbx_regexp_stats_t *stats);
 void	zbx_regexp_free(zbx_regexp_t *regexp);
 int	zbx_regexp_match_precompiled(const char *string, const zbx_regexp_t *regexp);
 int	zbx_regexp_match_precompiled2(const char *string, const zbx_regexp_t *regexp, char **err_msg);
@@ -74,5 +87,6 @@ void	zbx_wildcard_minimize(char *str);
 int	zbx_wildcard_match(const char *value, const char *wildcard);
 
 void	zbx_init_regexp_env(void);
+void	zbx_deinit_regexp_env(void);
 
 #endif /* ZABBIX_ZBXREGEXP_H */
@@ -31,10 +31,39 @@
 
 #define ZBX_SELFMON_DELAY		1
 
+/* value ingestion pipeline stages, the latency is measured from the value timestamp */
+#define ZBX_LATENCY_STAGE_PREPROCESSING	0	/* value received by preprocessing manager */
+#define ZBX_LATENCY_STAGE_PREPROCESSED	1	/* value preprocessing finished */
+#define ZBX_LATENCY_STAGE_HISTORYCACHE	2	/* value added to history cache */
+#define ZBX_LATENCY_STAGE_SYNC		3	/* value taken from history cache by history syncer */
+#define ZBX_LATENCY_STAGE_HISTORY	4	/* value written to history storage */
+#define ZBX_LATENCY_STAGE_COUNT		5	/* number of latency stages */
+
 #ifndef _WINDOWS
 #include "zbxcommon.h"
 #include "zbxthreads.h"
 #include "zbxstats.h"
+#include "zbxtime.h"
+
+typedef struct
+{
+	zbx_uint64_t	count;
+	double		avg;
+	double		max;
+	double		p50;
+	double		p90;
+	double		p95;
+	double		p99;
+}
+zbx_latency_stats_t;
+
+/* statistics of aggregate function results shared between calculated items */
+typedef struct
+{
+	zbx_uint64_t	hits;
+	zbx_uint64_t	misses;
+}
+zbx_calc_cache_stats_t;
 
 ZBX_THREAD_ENTRY(zbx_selfmon_thread, args);
 
@@ -45,6 +74,14 @@ void	zbx_get_selfmon_stats(unsigned char proc_type, unsigned char aggr_func, int
 		double *value);
 int	zbx_get_all_process_stats(zbx_process_info_t *stats);
 void	zbx_sleep_loop(const zbx_thread_info_t *info, int sleeptime);
+
+void	zbx_latency_update(int stage, const zbx_timespec_t *now, const zbx_timespec_t *ts);
+void	zbx_latency_get_stats(int stage, zbx_latency_stats_t *stats);
+const char	*zbx_latency_stage_string(int stage);
+int	zbx_latency_get_stage(const char *name, int *stage);
+
+void	zbx_calc_cache_update(zbx_uint64_t hits, zbx_uint64_t misses);
+void	zbx_calc_cache_get_stats(zbx_calc_cache_stats_t *stats);
 #endif
 
 #endif	/* ZABBIX_ZBXSELF_H */
@@ -28,6 +28,15 @@
 #define SHMEM_MAX_BUCKET_SIZE		256 /* starting from this size all free chunks are put into the same bucket */
 #define ZBX_SHMEM_BUCKET_COUNT		((SHMEM_MAX_BUCKET_SIZE - ZBX_SHMEM_MIN_BUCKET_SIZE) / 8 + 1)
 
+#define ZBX_SHMEM_SLAB_CLASS_COUNT	24	/* size classes of the slab allocator, up to 512 bytes */
+
+struct zbx_shmem_slabs;
+
+/* shared memory page types */
+#define ZBX_SHMEM_HUGE_PAGES_NONE		0	/* normal pages */
+#define ZBX_SHMEM_HUGE_PAGES_EXPLICIT		1	/* preallocated huge pages (SHM_HUGETLB) */
+#define ZBX_SHMEM_HUGE_PAGES_TRANSPARENT	2	/* transparent huge pages advised and enabled for shmem */
+
 typedef struct
 {
 	void		*base;
@@ -45,8 +54,14 @@ typedef struct
 	/* Set this flag to 1 to allow execution in out of memory situations.     */
 	char		allow_oom;
 
+	/* the type of pages backing the segment, see ZBX_SHMEM_HUGE_PAGES_* defines */
+	unsigned char	huge_pages;
+
 	const char	*mem_descr;
 	const char	*mem_param;
+
+	/* slab allocator for small objects, NULL if disabled */
+	struct zbx_shmem_slabs	*slabs;
 }
 zbx_shmem_info_t;
 
@@ -60,9 +75,14 @@ typedef struct
 	unsigned int	chunks_num[ZBX_SHMEM_BUCKET_COUNT];
 	unsigned int	free_chunks;
 	unsigned int	used_chunks;
+	zbx_uint64_t	slab_size;		/* memory allocated for slab pages */
+	zbx_uint64_t	slab_used_size;		/* memory used by slab objects */
+	unsigned int	slab_pages_num[ZBX_SHMEM_SLAB_CLASS_COUNT];
+	unsigned int	slab_objects_num[ZBX_SHMEM_SLAB_CLASS_COUNT];
 }
 zbx_shmem_stats_t;
 
+void	zbx_shmem_set_huge_pages(int enable);
 int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error);
 int	zbx_shmem_create_min(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
@@ -85,6 +105,8 @@ void	*__zbx_shmem_realloc(const char *file, int line, zbx_shmem_info_t *info, vo
 void	__zbx_shmem_free(const char *file, int line, zbx_shmem_info_t *info, void *ptr);
 
 void	zbx_shmem_clear(zbx_shmem_info_t *info);
+void	zbx_shmem_enable_slabs(zbx_shmem_info_t *info);
+zbx_uint64_t	zbx_shmem_slab_class_size(int index);
 
 void	zbx_shmem_get_stats(const zbx_shmem_info_t *info, zbx_shmem_stats_t *stats);
 void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info);
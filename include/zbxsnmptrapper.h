@@ -25,6 +25,7 @@
 typedef struct
 {
 	const char	*config_snmptrap_file;
+	int		config_snmptrapper_threads;
 }
 zbx_thread_snmptrapper_args;
 
@@ -104,6 +104,31 @@ void	zbx_threads_kill_and_wait(ZBX_THREAD_HANDLE *threads, const int *threads_fl
 
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
 void	zbx_pthread_init_attr(pthread_attr_t *attr);
+
+typedef void	(*zbx_thread_pool_func_t)(void *data, int id);
+typedef void	(*zbx_thread_pool_init_func_t)(void);
+
+/* threads processing the same job in parallel, the calling thread serves the first slot */
+typedef struct
+{
+	const char			*name;
+	pthread_mutex_t			lock;
+	pthread_cond_t			event;		/* signaled when new job must be processed */
+	pthread_cond_t			done;		/* signaled when thread has processed its job part */
+	int				threads_num;	/* number of threads including the calling thread */
+	int				pending;	/* number of threads processing current job */
+	zbx_uint64_t			jobid;
+	zbx_thread_pool_init_func_t	thread_init;
+
+	/* current job */
+	zbx_thread_pool_func_t		func;
+	void				*data;
+}
+zbx_thread_pool_t;
+
+void	zbx_thread_pool_init(zbx_thread_pool_t *pool, const char *name, int threads_num,
+		zbx_thread_pool_init_func_t thread_init);
+void	zbx_thread_pool_run(zbx_thread_pool_t *pool, zbx_thread_pool_func_t func, void *data);
 #endif
 
 #endif	/* ZABBIX_THREADS_H */
@@ -83,6 +83,13 @@ void	zbx_tfc_destroy(void);
 int	zbx_tfc_get_stats(zbx_tfc_stats_t *stats, char **error);
 void	zbx_tfc_invalidate_trends(ZBX_DC_TREND *trends, int trends_num);
 
+/* trend rollups */
+void	zbx_trends_rollups_init(int enabled);
+int	zbx_trends_rollups_enabled(void);
+void	zbx_trends_update_rollups(const ZBX_DC_TREND *trends, int trends_num);
+int	zbx_trends_remove_rollups(const char *table, zbx_uint64_t itemid, int min_clock);
+void	zbx_trends_clear_rollups(void);
+
 int	zbx_baseline_get_data(zbx_uint64_t itemid, unsigned char value_type, time_t now, const char *period,
 		int season_num, zbx_time_unit_t season_unit, int skip, zbx_vector_dbl_t *values,
 		zbx_vector_uint64_t *index, char **error);
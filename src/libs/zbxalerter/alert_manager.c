@@ -1126,19 +1126,24 @@ static void	am_queue_watchdog_alerts(zbx_am_t *manager, const zbx_config_dbhigh_
  *                                                                            *
  * Purpose: initializes alert manager                                         *
  *                                                                            *
- * Parameters: manager      - [IN]                                            *
- *             get_forks_cb - [IN] process fork count callback                *
- *             error        - [OUT]                                           *
+ * Parameters: manager          - [IN]                                        *
+ *             get_forks_cb     - [IN] process fork count callback            *
+ *             alerter_sessions - [IN] number of concurrent alerts per        *
+ *                                     alerter process                        *
+ *             error            - [OUT]                                       *
  *                                                                            *
  * Return value: SUCCEED - the alert manager was initialized successfully     *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	am_init(zbx_am_t *manager, zbx_get_config_forks_f get_forks_cb, char **error)
+static int	am_init(zbx_am_t *manager, zbx_get_config_forks_f get_forks_cb, int alerter_sessions, char **error)
 {
-	int			ret;
+	int			ret, alerters_num;
+
+	/* each alerter process registers a connection for every concurrent alert it can send */
+	alerters_num = get_forks_cb(ZBX_PROCESS_TYPE_ALERTER) * alerter_sessions;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() alerters:%d", __func__, get_forks_cb(ZBX_PROCESS_TYPE_ALERTER));
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() alerters:%d", __func__, alerters_num);
 
 	if (FAIL == (ret = zbx_ipc_service_start(&manager->ipc, ZBX_IPC_SERVICE_ALERTER, error)))
 		goto out;
@@ -1150,7 +1155,7 @@ static int	am_init(zbx_am_t *manager, zbx_get_config_forks_f get_forks_cb, char
 
 	manager->next_alerter_index = 0;
 
-	for (int i = 0; i < get_forks_cb(ZBX_PROCESS_TYPE_ALERTER); i++)
+	for (int i = 0; i < alerters_num; i++)
 	{
 		zbx_am_alerter_t	*alerter = (zbx_am_alerter_t *)zbx_malloc(NULL, sizeof(zbx_am_alerter_t));
 
@@ -2314,7 +2319,8 @@ ZBX_THREAD_ENTRY(zbx_alert_manager_thread, args)
 
 	zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
-	if (FAIL == am_init(&manager, alert_manager_args_in->get_process_forks_cb_arg, &error))
+	if (FAIL == am_init(&manager, alert_manager_args_in->get_process_forks_cb_arg,
+			alert_manager_args_in->config_max_concurrent_alerts, &error))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize alert manager: %s", error);
 		zbx_free(error);
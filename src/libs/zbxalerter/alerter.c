@@ -38,7 +38,43 @@
 
 ZBX_PTR_VECTOR_IMPL(am_source_stats_ptr, zbx_am_source_stats_t *)
 
-static zbx_es_t	es_engine;
+/* alerter session - connection to alert manager used to send one alert at a time */
+typedef struct
+{
+	int			id;
+	zbx_ipc_socket_t	socket;
+	zbx_es_t		es_engine;
+	const char		*config_source_ip;
+	pthread_t		thread;
+	zbx_log_component_t	logger;
+}
+zbx_alerter_session_t;
+
+/* Scripts are executed with timeout relying on process wide SIGALRM, */
+/* so only one script can be executed at a time by alerter process.   */
+static pthread_mutex_t	exec_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* set when alerter runs multiple sessions and SIGALRM is blocked outside script execution */
+static int	exec_sigalrm_blocked = 0;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: blocks or unblocks SIGALRM signal in the calling thread           *
+ *                                                                            *
+ * Parameters: how - [IN] SIG_BLOCK or SIG_UNBLOCK                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	alerter_sigalrm_mask(int how)
+{
+	sigset_t	mask;
+	int		err;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGALRM);
+
+	if (0 != (err = pthread_sigmask(how, &mask, NULL)))
+		zabbix_log(LOG_LEVEL_WARNING, "cannot set SIGALRM signal mask: %s", zbx_strerror(err));
+}
 
 /******************************************************************************
  *                                                                            *
@@ -58,8 +94,21 @@ static int	execute_script_alert(const char *command, char *error, size_t max_err
 	char	*output = NULL;
 	int	ret = FAIL;
 
-	if (SUCCEED == (ret = zbx_execute(command, &output, error, max_error_len, ALARM_ACTION_TIMEOUT,
-			ZBX_EXIT_CODE_CHECKS_ENABLED, NULL)))
+	pthread_mutex_lock(&exec_lock);
+
+	/* let the timeout alarm interrupt only the thread executing the script */
+	if (0 != exec_sigalrm_blocked)
+		alerter_sigalrm_mask(SIG_UNBLOCK);
+
+	ret = zbx_execute(command, &output, error, max_error_len, ALARM_ACTION_TIMEOUT,
+			ZBX_EXIT_CODE_CHECKS_ENABLED, NULL);
+
+	if (0 != exec_sigalrm_blocked)
+		alerter_sigalrm_mask(SIG_BLOCK);
+
+	pthread_mutex_unlock(&exec_lock);
+
+	if (SUCCEED == ret)
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "%s output:\n%s", command, output);
 		zbx_free(output);
@@ -238,11 +287,12 @@ static void	alerter_process_exec(zbx_ipc_socket_t *socket, zbx_ipc_message_t *ip
  * Purpose: processes webhook alert                                                *
  *                                                                                 *
  * Parameters: socket           - [IN] connection socket                           *
+ *             es_engine        - [IN] session scripting engine                    *
  *             ipc_message      - [IN] ipc message with media type and alert data  *
  *             config_source_ip - [IN]                                             *
  *                                                                                 *
  ***********************************************************************************/
-static void	alerter_process_webhook(zbx_ipc_socket_t *socket, zbx_ipc_message_t *ipc_message,
+static void	alerter_process_webhook(zbx_ipc_socket_t *socket, zbx_es_t *es_engine, zbx_ipc_message_t *ipc_message,
 		const char *config_source_ip)
 {
 	char		*script_bin = NULL, *params = NULL, *error = NULL, *output = NULL;
@@ -251,31 +301,31 @@ static void	alerter_process_webhook(zbx_ipc_socket_t *socket, zbx_ipc_message_t
 
 	zbx_alerter_deserialize_webhook(ipc_message->data, &script_bin, &script_bin_sz, &timeout, &params, &debug);
 
-	if (SUCCEED != (ret = zbx_es_is_env_initialized(&es_engine)))
-		ret = zbx_es_init_env(&es_engine, config_source_ip, &error);
+	if (SUCCEED != (ret = zbx_es_is_env_initialized(es_engine)))
+		ret = zbx_es_init_env(es_engine, config_source_ip, &error);
 
 	if (SUCCEED == ret)
 	{
-		zbx_es_set_timeout(&es_engine, timeout);
+		zbx_es_set_timeout(es_engine, timeout);
 
 		if (ZBX_ALERT_DEBUG == debug)
-			zbx_es_debug_enable(&es_engine);
+			zbx_es_debug_enable(es_engine);
 
-		ret = zbx_es_execute(&es_engine, NULL, script_bin, script_bin_sz, params, &output, &error);
+		ret = zbx_es_execute(es_engine, NULL, script_bin, script_bin_sz, params, &output, &error);
 	}
 
-	if (ZBX_ALERT_DEBUG == debug && SUCCEED == zbx_es_is_env_initialized(&es_engine))
+	if (ZBX_ALERT_DEBUG == debug && SUCCEED == zbx_es_is_env_initialized(es_engine))
 	{
-		alerter_send_result(socket, output, ret, error, zbx_es_debug_info(&es_engine));
-		zbx_es_debug_disable(&es_engine);
+		alerter_send_result(socket, output, ret, error, zbx_es_debug_info(es_engine));
+		zbx_es_debug_disable(es_engine);
 	}
 	else
 		alerter_send_result(socket, output, ret, error, NULL);
 
-	if (SUCCEED == zbx_es_fatal_error(&es_engine))
+	if (SUCCEED == zbx_es_fatal_error(es_engine))
 	{
 		char	*errmsg = NULL;
-		if (SUCCEED != zbx_es_destroy_env(&es_engine, &errmsg))
+		if (SUCCEED != zbx_es_destroy_env(es_engine, &errmsg))
 		{
 			zabbix_log(LOG_LEVEL_WARNING,
 					"Cannot destroy embedded scripting engine environment: %s", errmsg);
@@ -289,6 +339,187 @@ static void	alerter_process_webhook(zbx_ipc_socket_t *socket, zbx_ipc_message_t
 	zbx_free(script_bin);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes alert manager request                                   *
+ *                                                                            *
+ * Parameters: session - [IN] alerter session                                 *
+ *             message - [IN] alert manager request                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	alerter_process_message(zbx_alerter_session_t *session, zbx_ipc_message_t *message)
+{
+	switch (message->code)
+	{
+		case ZBX_IPC_ALERTER_EMAIL:
+			alerter_process_email(&session->socket, message, session->config_source_ip);
+			break;
+		case ZBX_IPC_ALERTER_SMS:
+			alerter_process_sms(&session->socket, message);
+			break;
+		case ZBX_IPC_ALERTER_EXEC:
+			alerter_process_exec(&session->socket, message);
+			break;
+		case ZBX_IPC_ALERTER_WEBHOOK:
+			alerter_process_webhook(&session->socket, &session->es_engine, message,
+					session->config_source_ip);
+			break;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: connects alerter session to alert manager                         *
+ *                                                                            *
+ * Parameters: session - [IN] alerter session                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	alerter_session_connect(zbx_alerter_session_t *session)
+{
+	char	*error = NULL;
+
+	if (FAIL == zbx_ipc_socket_open(&session->socket, ZBX_IPC_SERVICE_ALERTER, SEC_PER_MIN, &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot connect to alert manager service: %s", error);
+		zbx_free(error);
+		exit(EXIT_FAILURE);
+	}
+
+	alerter_register(&session->socket);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: additional alerter session thread entry                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	*alerter_session_entry(void *args)
+{
+	zbx_alerter_session_t	*session = (zbx_alerter_session_t *)args;
+	zbx_ipc_message_t	message;
+	char			component[MAX_ID_LEN + 1];
+	sigset_t		mask;
+	int			err;
+
+	zbx_snprintf(component, sizeof(component), "%d", session->id);
+	zbx_set_log_component(component, &session->logger);
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGUSR1);
+	sigaddset(&mask, SIGUSR2);
+	sigaddset(&mask, SIGHUP);
+	sigaddset(&mask, SIGQUIT);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGALRM);
+
+	if (0 != (err = pthread_sigmask(SIG_BLOCK, &mask, NULL)))
+		zabbix_log(LOG_LEVEL_WARNING, "cannot block signals: %s", zbx_strerror(err));
+
+	zabbix_log(LOG_LEVEL_DEBUG, "alerter session #%d started", session->id);
+
+	zbx_ipc_message_init(&message);
+
+	while (ZBX_IS_RUNNING())
+	{
+		if (SUCCEED != zbx_ipc_socket_read(&session->socket, &message))
+		{
+			/* the session socket was shut down by the main thread */
+			if (!ZBX_IS_RUNNING())
+				break;
+
+			zabbix_log(LOG_LEVEL_CRIT, "cannot read alert manager service request");
+			exit(EXIT_FAILURE);
+		}
+
+		alerter_process_message(session, &message);
+		zbx_ipc_message_clean(&message);
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "alerter session #%d stopped", session->id);
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts additional alerter sessions                                *
+ *                                                                            *
+ * Parameters: sessions     - [IN] alerter sessions, the first session is     *
+ *                                 served by the main thread                  *
+ *             sessions_num - [IN] number of sessions                         *
+ *                                                                            *
+ * Comments: The curl library is initialized here, before any session thread  *
+ *           is created, because curl_global_init() is not thread safe.       *
+ *                                                                            *
+ ******************************************************************************/
+static void	alerter_start_sessions(zbx_alerter_session_t *sessions, int sessions_num)
+{
+	pthread_attr_t	attr;
+	int		err;
+
+#ifdef HAVE_LIBCURL
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+#endif
+	alerter_session_connect(&sessions[0]);
+
+	if (1 == sessions_num)
+		return;
+
+	/* SIGALRM must be blocked before starting threads so they inherit the mask */
+	exec_sigalrm_blocked = 1;
+	alerter_sigalrm_mask(SIG_BLOCK);
+
+	zbx_pthread_init_attr(&attr);
+
+	for (int i = 1; i < sessions_num; i++)
+	{
+		/* connect before starting the thread so that the socket can be shut down when stopping sessions */
+		alerter_session_connect(&sessions[i]);
+
+		if (0 != (err = pthread_create(&sessions[i].thread, &attr, alerter_session_entry, &sessions[i])))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "cannot create alerter session thread: %s", zbx_strerror(err));
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	pthread_attr_destroy(&attr);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stops additional alerter sessions and releases curl library       *
+ *                                                                            *
+ * Parameters: sessions     - [IN] alerter sessions, the first session is     *
+ *                                 served by the main thread                  *
+ *             sessions_num - [IN] number of sessions                         *
+ *                                                                            *
+ * Comments: Session sockets are shut down to wake up threads waiting for     *
+ *           alert manager requests, the threads sending alerts are waited    *
+ *           for before curl_global_cleanup() is called.                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	alerter_stop_sessions(zbx_alerter_session_t *sessions, int sessions_num)
+{
+	for (int i = 1; i < sessions_num; i++)
+		shutdown(sessions[i].socket.fd, SHUT_RDWR);
+
+	for (int i = 1; i < sessions_num; i++)
+	{
+		void	*retval;
+
+		pthread_join(sessions[i].thread, &retval);
+	}
+
+	for (int i = 0; i < sessions_num; i++)
+		zbx_ipc_socket_close(&sessions[i].socket);
+
+#ifdef HAVE_LIBCURL
+	curl_global_cleanup();
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: periodically check table alerts and send notifications if needed  *
@@ -296,9 +527,8 @@ static void	alerter_process_webhook(zbx_ipc_socket_t *socket, zbx_ipc_message_t
  ******************************************************************************/
 ZBX_THREAD_ENTRY(zbx_alerter_thread, args)
 {
-	char			*error = NULL;
-	int			success_num = 0, fail_num = 0;
-	zbx_ipc_socket_t	alerter_socket;
+	int			success_num = 0, fail_num = 0, sessions_num;
+	zbx_alerter_session_t	*sessions;
 	zbx_ipc_message_t	message;
 	double			time_stat, time_idle = 0, time_now, time_read;
 	const zbx_thread_info_t	*info = &((zbx_thread_args_t *)args)->info;
@@ -314,18 +544,20 @@ ZBX_THREAD_ENTRY(zbx_alerter_thread, args)
 
 	zbx_setproctitle("%s [connecting to the database]", get_process_type_string(process_type));
 
-	zbx_es_init(&es_engine);
-
-	zbx_ipc_message_init(&message);
+	sessions_num = alerter_args_in->config_max_concurrent_alerts;
+	sessions = (zbx_alerter_session_t *)zbx_malloc(NULL, sizeof(zbx_alerter_session_t) * (size_t)sessions_num);
 
-	if (FAIL == zbx_ipc_socket_open(&alerter_socket, ZBX_IPC_SERVICE_ALERTER, SEC_PER_MIN, &error))
+	for (int i = 0; i < sessions_num; i++)
 	{
-		zabbix_log(LOG_LEVEL_CRIT, "cannot connect to alert manager service: %s", error);
-		zbx_free(error);
-		exit(EXIT_FAILURE);
+		memset(&sessions[i], 0, sizeof(zbx_alerter_session_t));
+		sessions[i].id = i + 1;
+		sessions[i].config_source_ip = alerter_args_in->config_source_ip;
+		zbx_es_init(&sessions[i].es_engine);
 	}
 
-	alerter_register(&alerter_socket);
+	zbx_ipc_message_init(&message);
+
+	alerter_start_sessions(sessions, sessions_num);
 
 	time_stat = zbx_time();
 
@@ -356,8 +588,11 @@ ZBX_THREAD_ENTRY(zbx_alerter_thread, args)
 
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
 
-		if (SUCCEED != zbx_ipc_socket_read(&alerter_socket, &message))
+		if (SUCCEED != zbx_ipc_socket_read(&sessions[0].socket, &message))
 		{
+			if (!ZBX_IS_RUNNING())
+				break;
+
 			zabbix_log(LOG_LEVEL_CRIT, "cannot read alert manager service request");
 			exit(EXIT_FAILURE);
 		}
@@ -368,29 +603,14 @@ ZBX_THREAD_ENTRY(zbx_alerter_thread, args)
 		time_idle += time_read - time_now;
 		zbx_update_env(get_process_type_string(process_type), time_read);
 
-		switch (message.code)
-		{
-			case ZBX_IPC_ALERTER_EMAIL:
-				alerter_process_email(&alerter_socket, &message, alerter_args_in->config_source_ip);
-				break;
-			case ZBX_IPC_ALERTER_SMS:
-				alerter_process_sms(&alerter_socket, &message);
-				break;
-			case ZBX_IPC_ALERTER_EXEC:
-				alerter_process_exec(&alerter_socket, &message);
-				break;
-			case ZBX_IPC_ALERTER_WEBHOOK:
-				alerter_process_webhook(&alerter_socket, &message, alerter_args_in->config_source_ip);
-				break;
-		}
-
+		alerter_process_message(&sessions[0], &message);
 		zbx_ipc_message_clean(&message);
 	}
 
+	alerter_stop_sessions(sessions, sessions_num);
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
 		zbx_sleep(SEC_PER_MIN);
-
-	zbx_ipc_socket_close(&alerter_socket);
 }
@@ -246,6 +246,24 @@ clean:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if cached item is processed by server                       *
+ *                                                                            *
+ * Comments: Only internal item keys are checked, so other item keys are not  *
+ *           copied from the string arena.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_is_processed_by_server(const ZBX_DC_ITEM *item)
+{
+	char	key[ZBX_DC_ITEM_KEY_SIZE];
+
+	if (ITEM_TYPE_INTERNAL != item->type)
+		return zbx_is_item_processed_by_server(item->type, "");
+
+	return zbx_is_item_processed_by_server(item->type, dc_item_key(item, key));
+}
+
 static int	cmp_key_id(const char *key_1, const char *key_2)
 {
 	const char	*p, *q;
@@ -479,7 +497,7 @@ int	DCitem_nextcheck_update(ZBX_DC_ITEM *item, const ZBX_DC_INTERFACE *interface
 	zbx_uint64_t		seed;
 	int			simple_interval, disable_until, ret;
 	zbx_custom_interval_t	*custom_intervals;
-	char			*delay_s;
+	char			*delay_s, key[ZBX_DC_ITEM_KEY_SIZE];
 
 	if (0 == (flags & ZBX_ITEM_COLLECTED) && 0 != item->nextcheck &&
 			0 == (flags & ZBX_ITEM_KEY_CHANGED) && 0 == (flags & ZBX_ITEM_TYPE_CHANGED) &&
@@ -488,9 +506,9 @@ int	DCitem_nextcheck_update(ZBX_DC_ITEM *item, const ZBX_DC_INTERFACE *interface
 		return SUCCEED;	/* avoid unnecessary nextcheck updates when syncing items in cache */
 	}
 
-	seed = get_item_nextcheck_seed(item->itemid, item->interfaceid, item->type, item->key);
+	seed = get_item_nextcheck_seed(item->itemid, item->interfaceid, item->type, dc_item_key(item, key));
 
-	delay_s = dc_expand_user_macros_dyn(item->delay, &item->hostid, 1, ZBX_MACRO_ENV_NONSECURE);
+	delay_s = dc_expand_user_macros_dyn(dc_strarena_get(item->delay), &item->hostid, 1, ZBX_MACRO_ENV_NONSECURE);
 	ret = zbx_interval_preproc(delay_s, &simple_interval, &custom_intervals, error);
 	zbx_free(delay_s);
 
@@ -539,8 +557,11 @@ static void	DCitem_poller_type_update(ZBX_DC_ITEM *dc_item, const ZBX_DC_HOST *d
 {
 	unsigned char	poller_type;
 	unsigned char	snmp_oid_type = ZBX_SNMP_OID_TYPE_MACRO; /* oid type is only used by ITEM_TYPE_SNMP*/
+	char		key[ZBX_DC_ITEM_KEY_SIZE];
 
-	if (0 != dc_host->proxyid && SUCCEED != zbx_is_item_processed_by_server(dc_item->type, dc_item->key))
+	dc_item_key(dc_item, key);
+
+	if (0 != dc_host->proxyid && SUCCEED != zbx_is_item_processed_by_server(dc_item->type, key))
 	{
 		dc_item->poller_type = ZBX_NO_POLLER;
 		return;
@@ -554,7 +575,7 @@ static void	DCitem_poller_type_update(ZBX_DC_ITEM *dc_item, const ZBX_DC_HOST *d
 			snmp_oid_type = snmpitem->snmp_oid_type;
 	}
 
-	poller_type = poller_by_item(dc_item->type, dc_item->key, snmp_oid_type);
+	poller_type = poller_by_item(dc_item->type, key, snmp_oid_type);
 
 	if (0 != (flags & ZBX_HOST_UNREACHABLE))
 	{
@@ -623,8 +644,11 @@ ZBX_DC_ITEM	*DCfind_item(zbx_uint64_t hostid, const char *key)
 {
 	ZBX_DC_ITEM_HK	*item_hk, item_hk_local;
 
+	/* the key cannot be used by any item if it is not interned */
+	if (0 == (item_hk_local.key = dc_strarena_find(key, ZBX_DC_STR_KEY)))
+		return NULL;
+
 	item_hk_local.hostid = hostid;
-	item_hk_local.key = key;
 
 	if (NULL == (item_hk = (ZBX_DC_ITEM_HK *)zbx_hashset_search(&config->items_hk, &item_hk_local)))
 		return NULL;
@@ -749,6 +773,309 @@ int	dc_strpool_replace(int found, const char **curr, const char *new_str)
 	return SUCCEED;	/* indicate that the string has been replaced */
 }
 
+/* private string arena functions */
+
+/******************************************************************************
+ *                                                                            *
+ * String arena record layout:                                                *
+ *                                                                            *
+ *   zbx_uint32_t  refcount                                                   *
+ *   zbx_dc_str_t  prefix    - reference to the shared prefix record or 0     *
+ *   char          suffix[]  - the rest of the string, zero terminated        *
+ *                                                                            *
+ * Records are hashset entries allocated from the configuration cache shared  *
+ * memory, so they are 8 byte aligned and can be referenced by 32-bit offset  *
+ * from the shared memory base in ZBX_DC_STR_ALIGN units.                     *
+ *                                                                            *
+ ******************************************************************************/
+
+#define STRREC_HEADER_SIZE	(2 * sizeof(zbx_uint32_t))
+#define STRREC_REFCOUNT(rec)	(*(zbx_uint32_t *)(rec))
+#define STRREC_PREFIX(rec)	(*(const zbx_dc_str_t *)((const char *)(rec) + sizeof(zbx_uint32_t)))
+#define STRREC_SUFFIX(rec)	((const char *)(rec) + STRREC_HEADER_SIZE)
+
+/* search records are built on stack for strings up to this size */
+#define STRREC_LOCAL_SIZE	256
+
+static zbx_hash_t	__config_strarena_hash(const void *data)
+{
+	const char	*suffix = STRREC_SUFFIX(data);
+
+	return ZBX_DEFAULT_STRING_HASH_ALGO(suffix, strlen(suffix), STRREC_PREFIX(data));
+}
+
+static int	__config_strarena_compare(const void *d1, const void *d2)
+{
+	ZBX_RETURN_IF_NOT_EQUAL(STRREC_PREFIX(d1), STRREC_PREFIX(d2));
+
+	return strcmp(STRREC_SUFFIX(d1), STRREC_SUFFIX(d2));
+}
+
+static zbx_dc_str_t	dc_strarena_ref(const void *rec)
+{
+	return (zbx_dc_str_t)(((const char *)rec - (const char *)config_mem->base) / ZBX_DC_STR_ALIGN);
+}
+
+static char	*dc_strarena_rec(zbx_dc_str_t ref)
+{
+	return (char *)config_mem->base + (size_t)ref * ZBX_DC_STR_ALIGN;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find or add string arena record                                   *
+ *                                                                            *
+ * Parameters: prefix - [IN] shared prefix reference, 0 if none               *
+ *             suffix - [IN] the rest of the string                           *
+ *             insert - [IN] 1 - add record if not found                      *
+ *                                                                            *
+ * Return value: the record or NULL if it was not found and not added         *
+ *                                                                            *
+ ******************************************************************************/
+static char	*dc_strarena_lookup(zbx_dc_str_t prefix, const char *suffix, int insert)
+{
+	char	local[STRREC_LOCAL_SIZE], *search = local, *rec;
+	size_t	size;
+
+	size = STRREC_HEADER_SIZE + strlen(suffix) + 1;
+
+	if (STRREC_LOCAL_SIZE < size)
+		search = (char *)zbx_malloc(NULL, size);
+
+	STRREC_REFCOUNT(search) = 0;
+	*(zbx_dc_str_t *)(search + sizeof(zbx_uint32_t)) = prefix;
+	memcpy(search + STRREC_HEADER_SIZE, suffix, size - STRREC_HEADER_SIZE);
+
+	if (0 == insert)
+		rec = (char *)zbx_hashset_search(&config->strarena, search);
+	else
+		rec = (char *)zbx_hashset_insert_ext(&config->strarena, search, size, 0);
+
+	if (local != search)
+		zbx_free(search);
+
+	return rec;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get length of shared item key prefix                              *
+ *                                                                            *
+ * Return value: length of key name with opening bracket or 0 if the key has  *
+ *               no parameters                                                *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	dc_strarena_prefix_len(const char *str, int mode)
+{
+	const char	*ptr;
+
+	if (ZBX_DC_STR_KEY != mode || NULL == (ptr = strchr(str, '[')) || '\0' == ptr[1])
+		return 0;
+
+	return (size_t)(ptr - str) + 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: intern string in configuration cache string arena                 *
+ *                                                                            *
+ * Parameters: str  - [IN] the string to intern, can be NULL                  *
+ *             mode - [IN] ZBX_DC_STR_PLAIN - store the whole string          *
+ *                         ZBX_DC_STR_KEY   - share item key name prefix      *
+ *                                                                            *
+ * Return value: reference to the interned string or 0 if str is NULL         *
+ *                                                                            *
+ * Comments: The same mode must be used to intern, find and compare values    *
+ *           of the same field.                                               *
+ *                                                                            *
+ ******************************************************************************/
+zbx_dc_str_t	dc_strarena_intern(const char *str, int mode)
+{
+	zbx_dc_str_t	prefix = 0;
+	size_t		prefix_len;
+	char		*rec;
+
+	if (NULL == str)
+		return 0;
+
+	if (0 != (prefix_len = dc_strarena_prefix_len(str, mode)))
+	{
+		char	*name;
+
+		name = zbx_dsprintf(NULL, "%.*s", (int)prefix_len, str);
+		prefix = dc_strarena_intern(name, ZBX_DC_STR_PLAIN);
+		zbx_free(name);
+	}
+
+	rec = dc_strarena_lookup(prefix, str + prefix_len, 1);
+
+	/* new record already holds prefix reference acquired above */
+	if (0 != STRREC_REFCOUNT(rec)++ && 0 != prefix)
+		dc_strarena_release(prefix);
+
+	return dc_strarena_ref(rec);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find interned string without acquiring it                         *
+ *                                                                            *
+ * Return value: reference to the interned string or 0 if it was not found    *
+ *                                                                            *
+ ******************************************************************************/
+zbx_dc_str_t	dc_strarena_find(const char *str, int mode)
+{
+	zbx_dc_str_t	prefix = 0;
+	size_t		prefix_len;
+	char		*rec;
+
+	if (0 != (prefix_len = dc_strarena_prefix_len(str, mode)))
+	{
+		char	*name;
+
+		name = zbx_dsprintf(NULL, "%.*s", (int)prefix_len, str);
+		prefix = dc_strarena_find(name, ZBX_DC_STR_PLAIN);
+		zbx_free(name);
+
+		if (0 == prefix)
+			return 0;
+	}
+
+	if (NULL == (rec = dc_strarena_lookup(prefix, str + prefix_len, 0)))
+		return 0;
+
+	return dc_strarena_ref(rec);
+}
+
+zbx_dc_str_t	dc_strarena_acquire(zbx_dc_str_t ref)
+{
+	if (0 != ref)
+		STRREC_REFCOUNT(dc_strarena_rec(ref))++;
+
+	return ref;
+}
+
+void	dc_strarena_release(zbx_dc_str_t ref)
+{
+	char		*rec;
+	zbx_dc_str_t	prefix;
+
+	if (0 == ref)
+		return;
+
+	rec = dc_strarena_rec(ref);
+
+	if (0 != --STRREC_REFCOUNT(rec))
+		return;
+
+	prefix = STRREC_PREFIX(rec);
+	zbx_hashset_remove_direct(&config->strarena, rec);
+	dc_strarena_release(prefix);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compare interned string with a string                             *
+ *                                                                            *
+ * Return value: 0 if the strings are equal, otherwise strcmp() like result   *
+ *                                                                            *
+ ******************************************************************************/
+int	dc_strarena_cmp(zbx_dc_str_t ref, const char *str)
+{
+	const char	*rec = dc_strarena_rec(ref);
+	zbx_dc_str_t	prefix;
+
+	if (0 != (prefix = STRREC_PREFIX(rec)))
+	{
+		const char	*name = STRREC_SUFFIX(dc_strarena_rec(prefix));
+		size_t		len = strlen(name);
+		int		ret;
+
+		if (0 != (ret = strncmp(name, str, len)))
+			return ret;
+
+		str += len;
+	}
+
+	return strcmp(STRREC_SUFFIX(rec), str);
+}
+
+int	dc_strarena_replace(int found, zbx_dc_str_t *curr, const char *new_str, int mode)
+{
+	if (1 == found)
+	{
+		if (0 == dc_strarena_cmp(*curr, new_str))
+			return FAIL;
+
+		dc_strarena_release(*curr);
+	}
+
+	*curr = dc_strarena_intern(new_str, mode);
+
+	return SUCCEED;	/* indicate that the string has been replaced */
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get string interned with ZBX_DC_STR_PLAIN mode                    *
+ *                                                                            *
+ * Return value: the string or NULL if reference is 0                         *
+ *                                                                            *
+ ******************************************************************************/
+const char	*dc_strarena_get(zbx_dc_str_t ref)
+{
+	if (0 == ref)
+		return NULL;
+
+	return STRREC_SUFFIX(dc_strarena_rec(ref));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the leading part of interned string without copying it        *
+ *                                                                            *
+ * Return value: the shared prefix (item key name with opening bracket) if    *
+ *               the string has one, otherwise the whole string               *
+ *                                                                            *
+ * Comments: Can be used for item key name checks like strncmp(key, "log[")   *
+ *                                                                            *
+ ******************************************************************************/
+const char	*dc_strarena_head(zbx_dc_str_t ref)
+{
+	const char	*rec = dc_strarena_rec(ref);
+	zbx_dc_str_t	prefix;
+
+	if (0 != (prefix = STRREC_PREFIX(rec)))
+		rec = dc_strarena_rec(prefix);
+
+	return STRREC_SUFFIX(rec);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copy string interned with any mode to buffer                      *
+ *                                                                            *
+ * Parameters: ref  - [IN] the interned string reference                      *
+ *             buf  - [OUT] the output buffer                                 *
+ *             size - [IN] the buffer size                                    *
+ *                                                                            *
+ * Return value: the output buffer                                            *
+ *                                                                            *
+ ******************************************************************************/
+char	*dc_strarena_copy(zbx_dc_str_t ref, char *buf, size_t size)
+{
+	const char	*rec = dc_strarena_rec(ref);
+	zbx_dc_str_t	prefix;
+	size_t		offset = 0;
+
+	if (0 != (prefix = STRREC_PREFIX(rec)))
+		offset = zbx_strlcpy(buf, STRREC_SUFFIX(dc_strarena_rec(prefix)), size);
+
+	zbx_strlcpy(buf + offset, STRREC_SUFFIX(rec), size - offset);
+
+	return buf;
+}
+
 static void	DCupdate_item_queue(ZBX_DC_ITEM *item, unsigned char old_poller_type, int old_nextcheck)
 {
 	zbx_binary_heap_elem_t	elem;
@@ -2610,6 +2937,77 @@ char	*zbx_dc_get_global_item_type_timeout(unsigned char item_type)
 	return tmt;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get item key index entry for the specified key                    *
+ *                                                                            *
+ * Parameters: key    - [IN] the item key                                     *
+ *             insert - [IN] 1 - create the entry if it does not exist        *
+ *                                                                            *
+ * Return value: the item key index entry or NULL if it was not found         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_dc_item_key_index_t	*dc_item_key_index_get(const char *key, int insert)
+{
+	zbx_dc_item_key_index_t	*index, index_local;
+	char			*name;
+
+	name = zbx_dsprintf(NULL, "%.*s", (int)strcspn(key, "["), key);
+	index_local.name = name;
+
+	if (NULL == (index = (zbx_dc_item_key_index_t *)zbx_hashset_search(&config->item_key_index,
+			&index_local)) && 0 != insert)
+	{
+		index_local.name = dc_strpool_intern(name);
+		index = (zbx_dc_item_key_index_t *)zbx_hashset_insert(&config->item_key_index, &index_local,
+				sizeof(index_local));
+		zbx_hashset_create_ext(&index->itemids, 0, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC, NULL, __config_shmem_malloc_func,
+				__config_shmem_realloc_func, __config_shmem_free_func);
+	}
+
+	zbx_free(name);
+
+	return index;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add item to the item key index                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_key_index_add(const ZBX_DC_ITEM *item)
+{
+	zbx_dc_item_key_index_t	*index;
+	char			key[ZBX_DC_ITEM_KEY_SIZE];
+
+	index = dc_item_key_index_get(dc_item_key(item, key), 1);
+	zbx_hashset_insert(&index->itemids, &item->itemid, sizeof(item->itemid));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove item from the item key index                               *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_key_index_remove(const ZBX_DC_ITEM *item)
+{
+	zbx_dc_item_key_index_t	*index;
+	char			key[ZBX_DC_ITEM_KEY_SIZE];
+
+	if (NULL == (index = dc_item_key_index_get(dc_item_key(item, key), 0)))
+		return;
+
+	zbx_hashset_remove(&index->itemids, &item->itemid);
+
+	if (0 == index->itemids.num_data)
+	{
+		zbx_hashset_destroy(&index->itemids);
+		dc_strpool_release(index->name);
+		zbx_hashset_remove_direct(&config->item_key_index, index);
+	}
+}
+
 static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, zbx_synced_new_config_t synced,
 		zbx_vector_uint64_t *deleted_itemids)
 {
@@ -2676,7 +3074,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 
 		update_index = 0;
 
-		if (0 == found || item->hostid != hostid || 0 != strcmp(item->key, row[5]))
+		if (0 == found || item->hostid != hostid || 0 != dc_strarena_cmp(item->key, row[5]))
 		{
 			if (1 == found)
 			{
@@ -2692,14 +3090,17 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 				}
 				else if (item == item_hk->item_ptr)
 				{
-					dc_strpool_release(item_hk->key);
+					dc_strarena_release(item_hk->key);
 					zbx_hashset_remove_direct(&config->items_hk, item_hk);
 				}
 			}
 
 			item_hk_local.hostid = hostid;
-			item_hk_local.key = row[5];
-			item_hk = (ZBX_DC_ITEM_HK *)zbx_hashset_search(&config->items_hk, &item_hk_local);
+
+			if (0 != (item_hk_local.key = dc_strarena_find(row[5], ZBX_DC_STR_KEY)))
+				item_hk = (ZBX_DC_ITEM_HK *)zbx_hashset_search(&config->items_hk, &item_hk_local);
+			else
+				item_hk = NULL;
 
 			if (NULL != item_hk)
 				item_hk->item_ptr = item;
@@ -2713,7 +3114,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		item->flags = (unsigned char)atoi(row[18]);
 		ZBX_DBROW2UINT64(interfaceid, row[19]);
 
-		dc_strpool_replace(found, &item->history_period, row[22]);
+		dc_strarena_replace(found, &item->history_period, row[22], ZBX_DC_STR_PLAIN);
 
 		ZBX_STR2UCHAR(item->inventory_link, row[24]);
 		ZBX_DBROW2UINT64(item->valuemapid, row[25]);
@@ -2723,8 +3124,14 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		else
 			ZBX_STR2UCHAR(value_type, row[4]);
 
-		if (SUCCEED == dc_strpool_replace(found, &item->key, row[5]))
+		if (1 == found && 0 != dc_strarena_cmp(item->key, row[5]))
+			dc_item_key_index_remove(item);
+
+		if (SUCCEED == dc_strarena_replace(found, &item->key, row[5], ZBX_DC_STR_KEY))
+		{
 			flags |= ZBX_ITEM_KEY_CHANGED;
+			dc_item_key_index_add(item);
+		}
 
 		if (0 == found)
 		{
@@ -2734,18 +3141,17 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 			item->state = (unsigned char)atoi(row[12]);
 			ZBX_STR2UINT64(item->lastlogsize, row[20]);
 			item->mtime = atoi(row[21]);
-			dc_strpool_replace(found, &item->error, row[27]);
+			dc_strarena_replace(found, &item->error, row[27], ZBX_DC_STR_PLAIN);
 			item->data_expected_from = now;
 			item->location = ZBX_LOC_NOWHERE;
 			item->poller_type = ZBX_NO_POLLER;
 			item->queue_priority = ZBX_QUEUE_PRIORITY_NORMAL;
-			item->delay_ex = NULL;
+			item->delay_ex = 0;
 
 			if (ZBX_SYNCED_NEW_CONFIG_YES == synced && 0 == host->proxyid)
 				flags |= ZBX_ITEM_NEW;
 
-			zbx_vector_ptr_create_ext(&item->tags, __config_shmem_malloc_func, __config_shmem_realloc_func,
-					__config_shmem_free_func);
+			item->tags = NULL;
 
 			zbx_vector_dc_item_ptr_append(&host->items, item);
 
@@ -2789,26 +3195,26 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		if (1 == update_index)
 		{
 			item_hk_local.hostid = item->hostid;
-			item_hk_local.key = dc_strpool_acquire(item->key);
+			item_hk_local.key = dc_strarena_acquire(item->key);
 			item_hk_local.item_ptr = item;
 			zbx_hashset_insert(&config->items_hk, &item_hk_local, sizeof(ZBX_DC_ITEM_HK));
 		}
 
 		/* process item intervals and update item nextcheck */
 
-		if (SUCCEED == dc_strpool_replace(found, &item->delay, row[8]))
+		if (SUCCEED == dc_strarena_replace(found, &item->delay, row[8], ZBX_DC_STR_PLAIN))
 		{
 			flags |= ZBX_ITEM_DELAY_CHANGED;
 
 			/* reset expanded delay if raw value was changed */
-			if (NULL != item->delay_ex)
+			if (0 != item->delay_ex)
 			{
-				dc_strpool_release(item->delay_ex);
-				item->delay_ex = NULL;
+				dc_strarena_release(item->delay_ex);
+				item->delay_ex = 0;
 			}
 		}
 
-		dc_strpool_replace(found, &item->timeout, row[30]);
+		dc_strarena_replace(found, &item->timeout, row[30], ZBX_DC_STR_PLAIN);
 
 		/* numeric items */
 
@@ -3165,7 +3571,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		{
 			DCitem_poller_type_update(item, host, flags);
 
-			if (SUCCEED == zbx_is_counted_in_item_queue(item->type, item->key))
+			if (SUCCEED == zbx_is_counted_in_item_queue(item->type, dc_strarena_head(item->key)))
 			{
 				char	*error = NULL;
 
@@ -3447,25 +3853,26 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		}
 		else if (item == item_hk->item_ptr)
 		{
-			dc_strpool_release(item_hk->key);
+			dc_strarena_release(item_hk->key);
 			zbx_hashset_remove_direct(&config->items_hk, item_hk);
 		}
 
 		if (ZBX_LOC_QUEUE == item->location)
 			zbx_binary_heap_remove_direct(&config->queues[item->poller_type], item->itemid);
 
-		dc_strpool_release(item->key);
-		dc_strpool_release(item->error);
-		dc_strpool_release(item->delay);
-		dc_strpool_release(item->history_period);
-
-		if (NULL != item->delay_ex)
-			dc_strpool_release(item->delay_ex);
+		dc_item_key_index_remove(item);
+		dc_strarena_release(item->key);
+		dc_strarena_release(item->error);
+		dc_strarena_release(item->delay);
+		dc_strarena_release(item->delay_ex);
+		dc_strarena_release(item->history_period);
+		dc_strarena_release(item->timeout);
 
 		if (NULL != item->triggers)
 			config->items.mem_free_func(item->triggers);
 
-		zbx_vector_ptr_destroy(&item->tags);
+		if (NULL != item->tags)
+			config->items.mem_free_func(item->tags);
 
 		if (NULL != item->preproc_item)
 			dc_preprocitem_free(item->preproc_item);
@@ -3615,6 +4022,7 @@ static void	DCsync_triggers(zbx_dbsync_t *sync, zbx_uint64_t revision)
 		/* store new information in trigger structure */
 
 		ZBX_STR2UCHAR(trigger->flags, row[19]);
+		ZBX_DBROW2UINT64(trigger->templateid, row[20]);
 
 		if (ZBX_FLAG_DISCOVERY_PROTOTYPE == trigger->flags)
 			continue;
@@ -5177,6 +5585,65 @@ static void	DCsync_trigger_tags(zbx_dbsync_t *sync)
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds tag to the NULL terminated item tag array                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_tag_append(ZBX_DC_ITEM *item, zbx_dc_item_tag_t *item_tag)
+{
+	int	tags_num = 0;
+
+	if (NULL != item->tags)
+	{
+		while (NULL != item->tags[tags_num])
+			tags_num++;
+	}
+
+	item->tags = (zbx_dc_item_tag_t **)config->items.mem_realloc_func(item->tags,
+			sizeof(zbx_dc_item_tag_t *) * (size_t)(tags_num + 2));
+
+	item->tags[tags_num] = item_tag;
+	item->tags[tags_num + 1] = NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes tag from the NULL terminated item tag array               *
+ *                                                                            *
+ * Comments: The array is released when the last tag is removed.              *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_tag_remove(ZBX_DC_ITEM *item, const zbx_dc_item_tag_t *item_tag)
+{
+	int	i, last;
+
+	if (NULL == item->tags)
+		return;
+
+	for (i = 0; NULL != item->tags[i] && item_tag != item->tags[i]; i++)
+		;
+
+	if (NULL == item->tags[i])
+		return;
+
+	for (last = i; NULL != item->tags[last + 1]; last++)
+		;
+
+	if (0 == last)
+	{
+		config->items.mem_free_func(item->tags);
+		item->tags = NULL;
+		return;
+	}
+
+	item->tags[i] = item->tags[last];
+	item->tags[last] = NULL;
+
+	item->tags = (zbx_dc_item_tag_t **)config->items.mem_realloc_func(item->tags,
+			sizeof(zbx_dc_item_tag_t *) * (size_t)(last + 1));
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Updates item tags in configuration cache                          *
@@ -5195,7 +5662,7 @@ static void	DCsync_item_tags(zbx_dbsync_t *sync)
 	char			**row;
 	zbx_uint64_t		rowid;
 	unsigned char		tag;
-	int			found, ret, index;
+	int			found, ret;
 	zbx_uint64_t		itemid, itemtagid;
 	ZBX_DC_ITEM		*item;
 	zbx_dc_item_tag_t	*item_tag;
@@ -5217,13 +5684,14 @@ static void	DCsync_item_tags(zbx_dbsync_t *sync)
 
 		item_tag = (zbx_dc_item_tag_t *)DCfind_id(&config->item_tags, itemtagid, sizeof(zbx_dc_item_tag_t),
 				&found);
+
 		dc_strpool_replace(found, &item_tag->tag, row[2]);
 		dc_strpool_replace(found, &item_tag->value, row[3]);
 
 		if (0 == found)
 		{
 			item_tag->itemid = itemid;
-			zbx_vector_ptr_append(&item->tags, item_tag);
+			dc_item_tag_append(item, item_tag);
 		}
 	}
 
@@ -5235,21 +5703,7 @@ static void	DCsync_item_tags(zbx_dbsync_t *sync)
 			continue;
 
 		if (NULL != (item = (ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &item_tag->itemid)))
-		{
-			if (FAIL != (index = zbx_vector_ptr_search(&item->tags, item_tag,
-					ZBX_DEFAULT_PTR_COMPARE_FUNC)))
-			{
-				zbx_vector_ptr_remove_noorder(&item->tags, index);
-
-				/* recreate empty tags vector to release used memory */
-				if (0 == item->tags.values_num)
-				{
-					zbx_vector_ptr_destroy(&item->tags);
-					zbx_vector_ptr_create_ext(&item->tags, __config_shmem_malloc_func,
-							__config_shmem_realloc_func, __config_shmem_free_func);
-				}
-			}
-		}
+			dc_item_tag_remove(item, item_tag);
 
 		dc_strpool_release(item_tag->tag);
 		dc_strpool_release(item_tag->value);
@@ -7778,6 +8232,8 @@ void	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config_t synce
 				config->items.num_data, config->items.num_slots);
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() items_hk   : %d (%d slots)", __func__,
 				config->items_hk.num_data, config->items_hk.num_slots);
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() item_key_index: %d (%d slots)", __func__,
+				config->item_key_index.num_data, config->item_key_index.num_slots);
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() numitems   : %d (%d slots)", __func__,
 				config->numitems.num_data, config->numitems.num_slots);
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() preprocitems: %d (%d slots)", __func__,
@@ -7892,6 +8348,8 @@ out:
 	config->status->last_update = 0;
 	config->sync_ts = time(NULL);
 
+	um_cache_flush_stats(&config->um_stats);
+
 	FINISH_SYNC;
 
 #ifdef HAVE_ORACLE
@@ -8013,8 +8471,9 @@ static zbx_hash_t	__config_item_hk_hash(const void *data)
 
 	zbx_hash_t		hash;
 
+	/* interned keys are unique, so the key reference identifies the key */
 	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&item_hk->hostid);
-	hash = ZBX_DEFAULT_STRING_HASH_ALGO(item_hk->key, strlen(item_hk->key), hash);
+	hash = ZBX_DEFAULT_HASH_ALGO(&item_hk->key, sizeof(item_hk->key), hash);
 
 	return hash;
 }
@@ -8025,8 +8484,9 @@ static int	__config_item_hk_compare(const void *d1, const void *d2)
 	const ZBX_DC_ITEM_HK	*item_hk_2 = (const ZBX_DC_ITEM_HK *)d2;
 
 	ZBX_RETURN_IF_NOT_EQUAL(item_hk_1->hostid, item_hk_2->hostid);
+	ZBX_RETURN_IF_NOT_EQUAL(item_hk_1->key, item_hk_2->key);
 
-	return item_hk_1->key == item_hk_2->key ? 0 : strcmp(item_hk_1->key, item_hk_2->key);
+	return 0;
 }
 
 static zbx_hash_t	__config_host_h_hash(const void *data)
@@ -8240,6 +8700,21 @@ static int	__config_regexp_compare(const void *d1, const void *d2)
 	return r1->name == r2->name ? 0 : strcmp(r1->name, r2->name);
 }
 
+static zbx_hash_t	__config_item_key_index_hash(const void *data)
+{
+	const zbx_dc_item_key_index_t	*index = (const zbx_dc_item_key_index_t *)data;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(index->name);
+}
+
+static int	__config_item_key_index_compare(const void *d1, const void *d2)
+{
+	const zbx_dc_item_key_index_t	*i1 = (const zbx_dc_item_key_index_t *)d1;
+	const zbx_dc_item_key_index_t	*i2 = (const zbx_dc_item_key_index_t *)d2;
+
+	return i1->name == i2->name ? 0 : strcmp(i1->name, i2->name);
+}
+
 #if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
 static zbx_hash_t	__config_psk_hash(const void *data)
 {
@@ -8352,12 +8827,23 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	if (SUCCEED != (ret = zbx_rwlock_create(&config_history_lock, ZBX_RWLOCK_CONFIG_HISTORY, error)))
 		goto out;
 
+	/* string arena references are 32-bit offsets in the configuration cache */
+	if (ZBX_DC_STR_CACHE_SIZE_MAX < conf_cache_size)
+	{
+		*error = zbx_dsprintf(*error, "configuration cache size cannot exceed " ZBX_FS_UI64 " bytes",
+				ZBX_DC_STR_CACHE_SIZE_MAX);
+		ret = FAIL;
+		goto out;
+	}
+
 	if (SUCCEED != (ret = zbx_shmem_create(&config_mem, conf_cache_size, "configuration cache",
 			"CacheSize", 0, error)))
 	{
 		goto out;
 	}
 
+	zbx_shmem_enable_slabs(config_mem);
+
 	config = (ZBX_DC_CONFIG *)__config_shmem_malloc_func(NULL, sizeof(ZBX_DC_CONFIG) +
 			(size_t)get_config_forks_cb(ZBX_PROCESS_TYPE_TIMER) * sizeof(zbx_vector_ptr_t));
 
@@ -8409,6 +8895,8 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	CREATE_HASHSET(config->action_conditions, 0);
 	CREATE_HASHSET(config->trigger_tags, 0);
 	CREATE_HASHSET(config->item_tags, 0);
+	CREATE_HASHSET_EXT(config->item_key_index, 0, __config_item_key_index_hash,
+			__config_item_key_index_compare);
 	CREATE_HASHSET(config->host_tags, 0);
 	CREATE_HASHSET(config->host_tags_index, 0);
 	CREATE_HASHSET(config->correlations, 0);
@@ -8439,6 +8927,7 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	CREATE_HASHSET_EXT(config->regexps, 0, __config_regexp_hash, __config_regexp_compare);
 
 	CREATE_HASHSET_EXT(config->strpool, 100, __config_strpool_hash, __config_strpool_compare);
+	CREATE_HASHSET_EXT(config->strarena, 100, __config_strarena_hash, __config_strarena_compare);
 
 #if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
 	CREATE_HASHSET_EXT(config->psks, 0, __config_psk_hash, __config_psk_compare);
@@ -8531,6 +9020,7 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	memset(&config->revision, 0, sizeof(config->revision));
 
 	config->um_cache = um_cache_create();
+	memset(&config->um_stats, 0, sizeof(config->um_stats));
 
 	/* maintenance data are used only when timers are defined (server) */
 	if (0 != get_config_forks_cb(ZBX_PROCESS_TYPE_TIMER))
@@ -9049,6 +9539,7 @@ static void	DCget_item(zbx_dc_item_t *dst_item, const ZBX_DC_ITEM *src_item)
 	const ZBX_DC_INTERFACE		*dc_interface;
 	const ZBX_DC_HTTPITEM		*httpitem;
 	const ZBX_DC_SCRIPTITEM		*scriptitem;
+	const char			*error, *timeout;
 
 	dst_item->type = src_item->type;
 	dst_item->value_type = src_item->value_type;
@@ -9059,17 +9550,18 @@ static void	DCget_item(zbx_dc_item_t *dst_item, const ZBX_DC_ITEM *src_item)
 
 	dst_item->status = src_item->status;
 
-	zbx_strscpy(dst_item->key_orig, src_item->key);
+	dc_item_key(src_item, dst_item->key_orig);
 
 	dst_item->itemid = src_item->itemid;
 	dst_item->flags = src_item->flags;
 	dst_item->key = NULL;
 	dst_item->timeout = 0;
 
-	dst_item->delay = zbx_strdup(NULL, src_item->delay);	/* not used, should be initialized */
+	/* not used, should be initialized */
+	dst_item->delay = zbx_strdup(NULL, dc_strarena_get(src_item->delay));
 
-	if ('\0' != *src_item->error)
-		dst_item->error = zbx_strdup(NULL, src_item->error);
+	if ('\0' != *(error = dc_strarena_get(src_item->error)))
+		dst_item->error = zbx_strdup(NULL, error);
 	else
 		dst_item->error = NULL;
 
@@ -9090,10 +9582,10 @@ static void	DCget_item(zbx_dc_item_t *dst_item, const ZBX_DC_ITEM *src_item)
 
 	DCget_interface(&dst_item->interface, dc_interface);
 
-	if ('\0' == *src_item->timeout)
+	if ('\0' == *(timeout = dc_strarena_get(src_item->timeout)))
 		zbx_strscpy(dst_item->timeout_orig, dc_get_global_item_type_timeout(src_item->type));
 	else
-		zbx_strscpy(dst_item->timeout_orig, src_item->timeout);
+		zbx_strscpy(dst_item->timeout_orig, timeout);
 
 	switch (src_item->type)
 	{
@@ -9104,7 +9596,7 @@ static void	DCget_item(zbx_dc_item_t *dst_item, const ZBX_DC_ITEM *src_item)
 
 			if (NULL != snmpitem && NULL != snmp)
 			{
-				if ('\0' != *src_item->timeout &&
+				if ('\0' != *timeout &&
 						0 != strncmp(snmpitem->snmp_oid, "walk[", ZBX_CONST_STRLEN("walk[")))
 				{
 					zbx_strscpy(dst_item->timeout_orig,
@@ -9752,7 +10244,10 @@ static void	dc_preproc_sync_item(zbx_hashset_t *items, ZBX_DC_ITEM *dc_item, zbx
 		dc_preproc_sync_masteritem(pp_item->preproc, dc_item->master_item);
 
 	if (NULL != dc_item->preproc_item)
+	{
 		dc_preproc_sync_preprocitem(pp_item->preproc, dc_item->preproc_item);
+		zbx_pp_item_preproc_compile(pp_item->preproc);
+	}
 
 	for (int i = 0; i < pp_item->preproc->steps_num; i++)
 	{
@@ -9841,7 +10336,7 @@ void	zbx_dc_config_get_preprocessable_items(zbx_hashset_t *items, zbx_dc_um_shar
 			}
 
 			if (0 == dc_host->proxyid ||
-					SUCCEED == zbx_is_item_processed_by_server(dc_item->type, dc_item->key))
+					SUCCEED == dc_item_is_processed_by_server(dc_item))
 			{
 				dc_preproc_add_item_rec(dc_item, &items_sync);
 			}
@@ -10987,7 +11482,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 		dc_interface = (ZBX_DC_INTERFACE *)zbx_hashset_search(&config->interfaces, &dc_item->interfaceid);
 
 		if (HOST_STATUS_MONITORED != dc_host->status || (0 != dc_host->proxyid &&
-				SUCCEED != zbx_is_item_processed_by_server(dc_item->type, dc_item->key)))
+				SUCCEED != dc_item_is_processed_by_server(dc_item)))
 		{
 			continue;
 		}
@@ -11295,7 +11790,7 @@ static void	dc_requeue_items(const zbx_uint64_t *itemids, const int *lastclocks,
 		if (HOST_STATUS_MONITORED != dc_host->status)
 			continue;
 
-		if (SUCCEED != zbx_is_counted_in_item_queue(dc_item->type, dc_item->key))
+		if (SUCCEED != zbx_is_counted_in_item_queue(dc_item->type, dc_strarena_head(dc_item->key)))
 			continue;
 
 		dc_interface = (ZBX_DC_INTERFACE *)zbx_hashset_search(&config->interfaces, &dc_item->interfaceid);
@@ -12009,6 +12504,9 @@ void	*zbx_dc_config_get_stats(int request)
 		case ZBX_CONFSTATS_BUFFER_PFREE:
 			value_double = 100 * (double)config_mem->free_size / config_mem->orig_size;
 			return &value_double;
+		case ZBX_CONFSTATS_BUFFER_HUGE_PAGES:
+			value_uint = config_mem->huge_pages;
+			return &value_uint;
 		default:
 			return NULL;
 	}
@@ -12272,7 +12770,7 @@ int	zbx_dc_get_item_queue(zbx_vector_ptr_t *queue, int from, int to)
 			if (ITEM_STATUS_ACTIVE != dc_item->status)
 				continue;
 
-			if (SUCCEED != zbx_is_counted_in_item_queue(dc_item->type, dc_item->key))
+			if (SUCCEED != zbx_is_counted_in_item_queue(dc_item->type, dc_strarena_head(dc_item->key)))
 				continue;
 
 			if (SUCCEED == DCin_maintenance_without_data_collection(dc_host, dc_item))
@@ -12300,8 +12798,8 @@ int	zbx_dc_get_item_queue(zbx_vector_ptr_t *queue, int from, int to)
 						data_expected_from = dc_host->data_expected_from;
 					}
 
-					delay_s = dc_expand_user_macros_dyn(dc_item->delay, &dc_item->hostid, 1,
-							ZBX_MACRO_ENV_NONSECURE);
+					delay_s = dc_expand_user_macros_dyn(dc_strarena_get(dc_item->delay),
+							&dc_item->hostid, 1, ZBX_MACRO_ENV_NONSECURE);
 					ret = zbx_interval_preproc(delay_s, &delay, NULL, NULL);
 					zbx_free(delay_s);
 
@@ -12403,8 +12901,8 @@ static void	get_host_statistics(ZBX_DC_HOST *dc_host, ZBX_DC_PROXY *dc_proxy, in
 						int	delay;
 						char	*delay_s;
 
-						delay_s = dc_expand_user_macros_dyn(dc_item->delay, &dc_item->hostid, 1,
-								ZBX_MACRO_ENV_NONSECURE);
+						delay_s = dc_expand_user_macros_dyn(dc_strarena_get(dc_item->delay),
+								&dc_item->hostid, 1, ZBX_MACRO_ENV_NONSECURE);
 
 						if (SUCCEED == zbx_interval_preproc(delay_s, &delay, NULL, NULL) &&
 								0 != delay)
@@ -13827,6 +14325,718 @@ void	zbx_dc_get_hostids_by_group_name(const char *name, zbx_vector_uint64_t *hos
 	zbx_vector_uint64_uniq(hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if host belongs to any of the specified host groups        *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_host_match_hostgroups(zbx_uint64_t hostid, const zbx_vector_ptr_t *groups)
+{
+	int	i;
+
+	for (i = 0; i < groups->values_num; i++)
+	{
+		const zbx_dc_hostgroup_t	*group = (const zbx_dc_hostgroup_t *)groups->values[i];
+
+		if (NULL != zbx_hashset_search(&group->hostids, &hostid))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if host of the specified object belongs to any of the      *
+ *          host groups                                                       *
+ *                                                                            *
+ * Parameters: object   - [IN] the object type (EVENT_OBJECT_TRIGGER,         *
+ *                             EVENT_OBJECT_ITEM or EVENT_OBJECT_LLDRULE)     *
+ *             objectid - [IN] the object identifier                          *
+ *             groups   - [IN] the host groups                                *
+ *             match    - [OUT] SUCCEED - object host belongs to the groups   *
+ *                              FAIL    - otherwise                           *
+ *                                                                            *
+ * Return value: SUCCEED - the object was resolved from configuration cache   *
+ *               FAIL    - object or its items are not cached                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_object_match_hostgroups(int object, zbx_uint64_t objectid, const zbx_vector_ptr_t *groups,
+		int *match)
+{
+	const ZBX_DC_ITEM	*item;
+
+	if (EVENT_OBJECT_TRIGGER == object)
+	{
+		const ZBX_DC_TRIGGER	*trigger;
+		const zbx_uint64_t	*itemid;
+
+		if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers, &objectid)) ||
+				NULL == trigger->itemids)
+		{
+			return FAIL;
+		}
+
+		for (itemid = trigger->itemids; 0 != *itemid; itemid++)
+		{
+			if (NULL == (item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, itemid)))
+				return FAIL;
+
+			if (SUCCEED == dc_host_match_hostgroups(item->hostid, groups))
+			{
+				*match = SUCCEED;
+				return SUCCEED;
+			}
+		}
+
+		*match = FAIL;
+
+		return SUCCEED;
+	}
+
+	if (NULL == (item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &objectid)))
+		return FAIL;
+
+	*match = dc_host_match_hostgroups(item->hostid, groups);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: matches objects against host groups using cached host group       *
+ *          membership                                                        *
+ *                                                                            *
+ * Parameters: object     - [IN] the object type (EVENT_OBJECT_TRIGGER,       *
+ *                               EVENT_OBJECT_ITEM or EVENT_OBJECT_LLDRULE)   *
+ *             groupids   - [IN] the host group identifiers, including nested *
+ *                               groups                                       *
+ *             objectids  - [IN] the object identifiers                       *
+ *             matched    - [OUT] objects with hosts in the host groups       *
+ *             unmatched  - [OUT] objects with hosts outside the host groups  *
+ *             unresolved - [OUT] objects not found in configuration cache    *
+ *                                                                            *
+ * Comments: Trigger matches if any of its items belongs to a host in the     *
+ *           host groups.                                                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_match_hostgroup_objects(int object, const zbx_vector_uint64_t *groupids,
+		const zbx_vector_uint64_t *objectids, zbx_vector_uint64_t *matched, zbx_vector_uint64_t *unmatched,
+		zbx_vector_uint64_t *unresolved)
+{
+	zbx_vector_ptr_t	groups;
+	zbx_dc_hostgroup_t	*group;
+	int			i, match;
+
+	zbx_vector_ptr_create(&groups);
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < groupids->values_num; i++)
+	{
+		if (NULL != (group = (zbx_dc_hostgroup_t *)zbx_hashset_search(&config->hostgroups,
+				&groupids->values[i])))
+		{
+			zbx_vector_ptr_append(&groups, group);
+		}
+	}
+
+	for (i = 0; i < objectids->values_num; i++)
+	{
+		if (SUCCEED != dc_object_match_hostgroups(object, objectids->values[i], &groups, &match))
+			zbx_vector_uint64_append(unresolved, objectids->values[i]);
+		else if (SUCCEED == match)
+			zbx_vector_uint64_append(matched, objectids->values[i]);
+		else
+			zbx_vector_uint64_append(unmatched, objectids->values[i]);
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_vector_ptr_destroy(&groups);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets host and parent template item of the specified item          *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the host, template or prototype item id      *
+ *             hostid     - [OUT] the item host                               *
+ *             templateid - [OUT] the parent template item, 0 if the item is  *
+ *                                not inherited                               *
+ *                                                                            *
+ * Return value: SUCCEED - the item was found in configuration cache          *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_get_template_link(zbx_uint64_t itemid, zbx_uint64_t *hostid, zbx_uint64_t *templateid)
+{
+	const ZBX_DC_ITEM		*item;
+	const ZBX_DC_TEMPLATE_ITEM	*template_item;
+	const ZBX_DC_PROTOTYPE_ITEM	*prototype_item;
+
+	if (NULL != (item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemid)))
+	{
+		*hostid = item->hostid;
+		*templateid = item->templateid;
+	}
+	else if (NULL != (template_item = (const ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_search(&config->template_items,
+			&itemid)))
+	{
+		*hostid = template_item->hostid;
+		*templateid = template_item->templateid;
+	}
+	else if (NULL != (prototype_item = (const ZBX_DC_PROTOTYPE_ITEM *)zbx_hashset_search(
+			&config->prototype_items, &itemid)))
+	{
+		*hostid = prototype_item->hostid;
+		*templateid = prototype_item->templateid;
+	}
+	else
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if item or its prototype is inherited from the specified   *
+ *          template                                                          *
+ *                                                                            *
+ * Parameters: itemid          - [IN] the item identifier                     *
+ *             source_itemid   - [IN] the item prototype identifier for       *
+ *                                    discovered items if known, otherwise    *
+ *                                    the item identifier                     *
+ *             templateid      - [IN] the template identifier                 *
+ *             match           - [OUT] SUCCEED - item is inherited from the   *
+ *                                               template                     *
+ *                                     FAIL    - otherwise                    *
+ *                                                                            *
+ * Return value: SUCCEED - the item hierarchy was resolved from configuration *
+ *                         cache                                              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_match_template(zbx_uint64_t itemid, zbx_uint64_t source_itemid, zbx_uint64_t templateid,
+		int *match)
+{
+	zbx_uint64_t	hostid, parent_itemid;
+
+	if (itemid == source_itemid)
+	{
+		const ZBX_DC_ITEM		*item;
+		const ZBX_DC_ITEM_DISCOVERY	*item_discovery;
+
+		if (NULL == (item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &itemid)))
+			return FAIL;
+
+		if (ZBX_FLAG_DISCOVERY_CREATED == item->flags)
+		{
+			if (NULL == (item_discovery = (const ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_search(
+					&config->item_discovery, &itemid)))
+			{
+				return FAIL;
+			}
+
+			source_itemid = item_discovery->parent_itemid;
+		}
+	}
+
+	if (SUCCEED != dc_item_get_template_link(source_itemid, &hostid, &parent_itemid))
+		return FAIL;
+
+	while (0 != parent_itemid)
+	{
+		if (SUCCEED != dc_item_get_template_link(parent_itemid, &hostid, &parent_itemid))
+			return FAIL;
+
+		if (hostid == templateid)
+		{
+			*match = SUCCEED;
+			return SUCCEED;
+		}
+	}
+
+	*match = FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if trigger or its prototype is inherited from the          *
+ *          specified template                                                *
+ *                                                                            *
+ * Parameters: triggerid        - [IN] the trigger identifier                 *
+ *             source_triggerid - [IN] the trigger prototype identifier for   *
+ *                                     discovered triggers, otherwise the     *
+ *                                     trigger identifier                     *
+ *             templateid       - [IN] the template identifier                *
+ *             itemids          - [IN/OUT] the vector for item identifiers    *
+ *                                         of the current hierarchy level     *
+ *             match            - [OUT] SUCCEED - trigger is inherited from   *
+ *                                                the template                *
+ *                                      FAIL    - otherwise                   *
+ *                                                                            *
+ * Return value: SUCCEED - the trigger hierarchy was resolved from            *
+ *                         configuration cache                                *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Functions are cached only for host triggers, so the template     *
+ *           trigger hosts are resolved by walking the template chain of      *
+ *           trigger items in parallel with the trigger template chain.       *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_trigger_match_template(zbx_uint64_t triggerid, zbx_uint64_t source_triggerid,
+		zbx_uint64_t templateid, zbx_vector_uint64_t *itemids, int *match)
+{
+	const ZBX_DC_TRIGGER	*trigger;
+	const zbx_uint64_t	*itemid;
+	zbx_uint64_t		hostid, parent_itemid, next_itemid;
+	int			i;
+
+	if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers, &triggerid)) ||
+			NULL == trigger->itemids)
+	{
+		return FAIL;
+	}
+
+	/* trigger prototype of a discovered trigger is not cached, it must be selected from database */
+	if (triggerid == source_triggerid && ZBX_FLAG_DISCOVERY_CREATED == trigger->flags)
+		return FAIL;
+
+	zbx_vector_uint64_clear(itemids);
+
+	for (itemid = trigger->itemids; 0 != *itemid; itemid++)
+	{
+		if (triggerid != source_triggerid)
+		{
+			const ZBX_DC_ITEM_DISCOVERY	*item_discovery;
+
+			/* discovered trigger items are created from the item prototypes of trigger prototype */
+			if (NULL == (item_discovery = (const ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_search(
+					&config->item_discovery, itemid)))
+			{
+				return FAIL;
+			}
+
+			zbx_vector_uint64_append(itemids, item_discovery->parent_itemid);
+		}
+		else
+			zbx_vector_uint64_append(itemids, *itemid);
+	}
+
+	if (triggerid != source_triggerid && NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(
+			&config->triggers, &source_triggerid)))
+	{
+		return FAIL;
+	}
+
+	*match = FAIL;
+
+	while (0 != trigger->templateid)
+	{
+		for (i = 0; i < itemids->values_num; i++)
+		{
+			if (SUCCEED != dc_item_get_template_link(itemids->values[i], &hostid, &parent_itemid) ||
+					0 == parent_itemid ||
+					SUCCEED != dc_item_get_template_link(parent_itemid, &hostid, &next_itemid))
+			{
+				return FAIL;
+			}
+
+			itemids->values[i] = parent_itemid;
+
+			if (hostid == templateid)
+				*match = SUCCEED;
+		}
+
+		if (SUCCEED == *match)
+			break;
+
+		if (NULL == (trigger = (const ZBX_DC_TRIGGER *)zbx_hashset_search(&config->triggers,
+				&trigger->templateid)))
+		{
+			return FAIL;
+		}
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: matches objects against template using cached template hierarchy  *
+ *                                                                            *
+ * Parameters: object         - [IN] the object type (EVENT_OBJECT_TRIGGER,   *
+ *                                   EVENT_OBJECT_ITEM or                     *
+ *                                   EVENT_OBJECT_LLDRULE)                    *
+ *             templateid     - [IN] the template identifier                  *
+ *             objectids_pair - [IN] pairs of (objectid, source objectid)     *
+ *                                   where source objectid is the prototype   *
+ *                                   id for discovered objects if known,      *
+ *                                   otherwise object id                      *
+ *             matched        - [OUT] objects inherited from the template     *
+ *             unmatched      - [OUT] objects not inherited from the template *
+ *             unresolved     - [OUT] objects with hierarchy not resolvable   *
+ *                                    from configuration cache                *
+ *                                                                            *
+ * Comments: Prototypes of discovered triggers are not cached, so discovered  *
+ *           triggers are returned as unresolved unless source objectid is    *
+ *           set to the trigger prototype.                                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_match_template_objects(int object, zbx_uint64_t templateid,
+		const zbx_vector_uint64_pair_t *objectids_pair, zbx_vector_uint64_t *matched,
+		zbx_vector_uint64_t *unmatched, zbx_vector_uint64_pair_t *unresolved)
+{
+	zbx_vector_uint64_t	itemids;
+	int			i, ret, match;
+
+	zbx_vector_uint64_create(&itemids);
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < objectids_pair->values_num; i++)
+	{
+		const zbx_uint64_pair_t	*pair = &objectids_pair->values[i];
+
+		if (EVENT_OBJECT_TRIGGER == object)
+			ret = dc_trigger_match_template(pair->first, pair->second, templateid, &itemids, &match);
+		else
+			ret = dc_item_match_template(pair->first, pair->second, templateid, &match);
+
+		if (SUCCEED != ret)
+			zbx_vector_uint64_pair_append(unresolved, *pair);
+		else if (SUCCEED == match)
+			zbx_vector_uint64_append(matched, pair->first);
+		else
+			zbx_vector_uint64_append(unmatched, pair->first);
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_vector_uint64_destroy(&itemids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if tag matches tag name and optional value                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_tag_match(const char *tag, const char *value, const char *name, size_t name_len,
+		const char *name_value)
+{
+	if (0 != strncmp(tag, name, name_len) || '\0' != tag[name_len])
+		return FAIL;
+
+	if (NULL != name_value && 0 != strcmp(value, name_value))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if cached host has the specified tag                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_host_match_tag(zbx_uint64_t hostid, const char *name, size_t name_len, const char *value)
+{
+	zbx_dc_host_tag_index_t	*tag_index;
+
+	if (NULL == (tag_index = (zbx_dc_host_tag_index_t *)zbx_hashset_search(&config->host_tags_index, &hostid)))
+		return FAIL;
+
+	for (int i = 0; i < tag_index->tags.values_num; i++)
+	{
+		const zbx_dc_host_tag_t	*host_tag = (const zbx_dc_host_tag_t *)tag_index->tags.values[i];
+
+		if (SUCCEED == dc_tag_match(host_tag->tag, host_tag->value, name, name_len, value))
+			return SUCCEED;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if any template in item template chain has the specified    *
+ *          tag                                                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_template_chain_match_tag(zbx_uint64_t templateid, const char *name, size_t name_len,
+		const char *value)
+{
+	const ZBX_DC_TEMPLATE_ITEM	*template_item;
+
+	while (0 != templateid && NULL != (template_item = (const ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_search(
+			&config->template_items, &templateid)))
+	{
+		if (SUCCEED == dc_host_match_tag(template_item->hostid, name, name_len, value))
+			return SUCCEED;
+
+		templateid = template_item->templateid;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if cached item has the specified tag                        *
+ *                                                                            *
+ * Parameters: item - [IN] the item                                           *
+ *             tag  - [IN] the tag in format <tag name>[:<tag value>]         *
+ *                                                                            *
+ * Return value: SUCCEED - the item has matching tag                          *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The item tags are gathered in the same way as by                 *
+ *           zbx_get_item_tags() - own item tags, host tags and the tags of   *
+ *           the template chain of the item (or its prototype for discovered  *
+ *           items).                                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_match_tag(const ZBX_DC_ITEM *item, const char *tag)
+{
+	const char	*value;
+	size_t		taglen;
+
+	if (NULL != (value = strchr(tag, ':')))
+		taglen = (size_t)(value++ - tag);
+	else
+		taglen = strlen(tag);
+
+	if (NULL != item->tags)
+	{
+		for (int i = 0; NULL != item->tags[i]; i++)
+		{
+			if (SUCCEED == dc_tag_match(item->tags[i]->tag, item->tags[i]->value, tag, taglen, value))
+				return SUCCEED;
+		}
+	}
+
+	if (SUCCEED == dc_host_match_tag(item->hostid, tag, taglen, value))
+		return SUCCEED;
+
+	if (SUCCEED == dc_template_chain_match_tag(item->templateid, tag, taglen, value))
+		return SUCCEED;
+
+	if (ZBX_FLAG_DISCOVERY_CREATED == item->flags)
+	{
+		const ZBX_DC_ITEM_DISCOVERY	*item_discovery;
+		const ZBX_DC_PROTOTYPE_ITEM	*prototype_item;
+
+		if (NULL != (item_discovery = (const ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_search(
+				&config->item_discovery, &item->itemid)) &&
+				NULL != (prototype_item = (const ZBX_DC_PROTOTYPE_ITEM *)zbx_hashset_search(
+				&config->prototype_items, &item_discovery->parent_itemid)))
+		{
+			return dc_template_chain_match_tag(prototype_item->templateid, tag, taglen, value);
+		}
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if cached item matches all item query conditions            *
+ *                                                                            *
+ * Parameters: item   - [IN] the item                                         *
+ *             query  - [IN] the item query                                   *
+ *             hostid - [IN] the resolved query host, 0 - any host            *
+ *                                                                            *
+ * Return value: SUCCEED - the item matches query                             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_match_query(const ZBX_DC_ITEM *item, const zbx_dc_item_query_t *query, zbx_uint64_t hostid)
+{
+	int	i;
+
+	if (0 != hostid && item->hostid != hostid)
+		return FAIL;
+
+	if (NULL != query->hostids && FAIL == zbx_vector_uint64_bsearch(query->hostids, item->hostid,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+	{
+		return FAIL;
+	}
+
+	if (NULL != query->key)
+	{
+		char	key[ZBX_DC_ITEM_KEY_SIZE];
+
+		if (NULL == query->match_key)
+		{
+			if (0 != dc_strarena_cmp(item->key, query->key))
+				return FAIL;
+		}
+		else if (SUCCEED != query->match_key(dc_item_key(item, key), query->match_data))
+			return FAIL;
+	}
+
+	if (NULL != query->tags)
+	{
+		for (i = 0; i < query->tags->values_num; i++)
+		{
+			if (SUCCEED != dc_item_match_tag(item, query->tags->values[i]))
+				return FAIL;
+		}
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add cached item to item query candidates if it matches query      *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_add_query_candidate(const ZBX_DC_ITEM *item, const zbx_dc_item_query_t *query,
+		zbx_uint64_t hostid, zbx_vector_uint64_pair_t *itemhosts)
+{
+	zbx_uint64_pair_t	pair;
+
+	if (NULL == item || SUCCEED != dc_item_match_query(item, query, hostid))
+		return;
+
+	pair.first = item->itemid;
+	pair.second = item->hostid;
+	zbx_vector_uint64_pair_append(itemhosts, pair);
+}
+
+#define ZBX_DC_ITEM_SOURCE_ALL		0
+#define ZBX_DC_ITEM_SOURCE_HOST		1
+#define ZBX_DC_ITEM_SOURCE_HOSTS	2
+#define ZBX_DC_ITEM_SOURCE_KEY		3
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get items that might match aggregate calculation item query       *
+ *                                                                            *
+ * Parameters: query     - [IN] the item query                                *
+ *             itemhosts - [OUT] itemid+hostid pairs of matching items,       *
+ *                               sorted by itemid                             *
+ *                                                                            *
+ * Comments: Candidates are selected from the most selective of host items,   *
+ *           item key and host list indexes and then checked against the      *
+ *           remaining query conditions. Tags are not indexed because item    *
+ *           tags are inherited from hosts and templates.                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_item_query_candidates(const zbx_dc_item_query_t *query, zbx_vector_uint64_pair_t *itemhosts)
+{
+	ZBX_DC_HOST		*host = NULL;
+	ZBX_DC_ITEM		*item;
+	zbx_dc_item_key_index_t	*key_index = NULL;
+	zbx_hashset_iter_t	iter;
+	zbx_uint64_t		hostid = 0, *pitemid;
+	int			i, j, source = ZBX_DC_ITEM_SOURCE_ALL, source_num, num;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	RDLOCK_CACHE;
+
+	source_num = config->items.num_data;
+
+	if (NULL != query->host || 0 != query->hostid)
+	{
+		if (NULL != query->host)
+			host = DCfind_host(query->host);
+		else
+			host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &query->hostid);
+
+		if (NULL == host)
+			goto out;
+
+		hostid = host->hostid;
+		source = ZBX_DC_ITEM_SOURCE_HOST;
+		source_num = host->items.values_num;
+	}
+
+	if (NULL != query->hostids)
+	{
+		for (i = 0, num = 0; i < query->hostids->values_num && num < source_num; i++)
+		{
+			if (NULL != (host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts,
+					&query->hostids->values[i])))
+			{
+				num += host->items.values_num;
+			}
+		}
+
+		if (num < source_num)
+		{
+			source = ZBX_DC_ITEM_SOURCE_HOSTS;
+			source_num = num;
+		}
+	}
+
+	if (NULL != query->key)
+	{
+		if (NULL == (key_index = dc_item_key_index_get(query->key, 0)))
+			goto out;
+
+		if (key_index->itemids.num_data < source_num)
+		{
+			source = ZBX_DC_ITEM_SOURCE_KEY;
+			source_num = key_index->itemids.num_data;
+		}
+	}
+
+	switch (source)
+	{
+		case ZBX_DC_ITEM_SOURCE_HOST:
+			host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &hostid);
+
+			for (i = 0; i < host->items.values_num; i++)
+				dc_item_add_query_candidate(host->items.values[i], query, hostid, itemhosts);
+			break;
+		case ZBX_DC_ITEM_SOURCE_HOSTS:
+			for (i = 0; i < query->hostids->values_num; i++)
+			{
+				if (NULL == (host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts,
+						&query->hostids->values[i])))
+				{
+					continue;
+				}
+
+				for (j = 0; j < host->items.values_num; j++)
+					dc_item_add_query_candidate(host->items.values[j], query, hostid, itemhosts);
+			}
+			break;
+		case ZBX_DC_ITEM_SOURCE_KEY:
+			zbx_hashset_iter_reset(&key_index->itemids, &iter);
+
+			while (NULL != (pitemid = (zbx_uint64_t *)zbx_hashset_iter_next(&iter)))
+			{
+				item = (ZBX_DC_ITEM *)zbx_hashset_search(&config->items, pitemid);
+				dc_item_add_query_candidate(item, query, hostid, itemhosts);
+			}
+			break;
+		default:
+			zbx_hashset_iter_reset(&config->items, &iter);
+
+			while (NULL != (item = (ZBX_DC_ITEM *)zbx_hashset_iter_next(&iter)))
+				dc_item_add_query_candidate(item, query, hostid, itemhosts);
+	}
+out:
+	UNLOCK_CACHE;
+
+	zbx_vector_uint64_pair_sort(itemhosts, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+	zbx_vector_uint64_pair_uniq(itemhosts, ZBX_DEFAULT_UINT64_PAIR_COMPARE_FUNC);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() source:%d items:%d", __func__, source, itemhosts->values_num);
+}
+
+#undef ZBX_DC_ITEM_SOURCE_ALL
+#undef ZBX_DC_ITEM_SOURCE_HOST
+#undef ZBX_DC_ITEM_SOURCE_HOSTS
+#undef ZBX_DC_ITEM_SOURCE_KEY
+
 /******************************************************************************
  *                                                                            *
  * Purpose: gets active proxy data by its name from configuration cache       *
@@ -14087,7 +15297,7 @@ void	zbx_dc_config_items_apply_changes(const zbx_vector_ptr_t *item_diff)
 			dc_item->mtime = diff->mtime;
 
 		if (0 != (ZBX_FLAGS_ITEM_DIFF_UPDATE_ERROR & diff->flags))
-			dc_strpool_replace(1, &dc_item->error, diff->error);
+			dc_strarena_replace(1, &dc_item->error, diff->error, ZBX_DC_STR_PLAIN);
 
 		if (0 != (ZBX_FLAGS_ITEM_DIFF_UPDATE_STATE & diff->flags))
 			dc_item->state = diff->state;
@@ -14301,13 +15511,15 @@ void	zbx_dc_reschedule_items(const zbx_vector_uint64_t *itemids, time_t nextchec
 		}
 		else if (ZBX_JAN_2038 == dc_item->nextcheck)
 		{
+			char	key[ZBX_DC_ITEM_KEY_SIZE];
+
 			zabbix_log(LOG_LEVEL_WARNING, "cannot perform check now for item \"%s\" on host \"%s\""
-					": item configuration error", dc_item->key, dc_host->host);
+					": item configuration error", dc_item_key(dc_item, key), dc_host->host);
 
 			proxyid = 0;
 		}
 		else if (0 == (proxyid = dc_host->proxyid) ||
-				SUCCEED == zbx_is_item_processed_by_server(dc_item->type, dc_item->key))
+				SUCCEED == dc_item_is_processed_by_server(dc_item))
 		{
 			dc_requeue_item_at(dc_item, dc_host, nextcheck);
 			proxyid = 0;
@@ -14670,9 +15882,12 @@ void	zbx_dc_cleanup_autoreg_host(void)
 
 static void	zbx_gather_item_tags(ZBX_DC_ITEM *item, zbx_vector_item_tag_t *item_tags)
 {
-	for (int i = 0; i < item->tags.values_num; i++)
+	if (NULL == item->tags)
+		return;
+
+	for (int i = 0; NULL != item->tags[i]; i++)
 	{
-		zbx_dc_item_tag_t	*dc_tag = item->tags.values[i];
+		zbx_dc_item_tag_t	*dc_tag = item->tags[i];
 		zbx_item_tag_t		*tag = (zbx_item_tag_t *) zbx_malloc(NULL, sizeof(zbx_item_tag_t));
 
 		tag->tag.tag = zbx_strdup(NULL, dc_tag->tag);
@@ -15270,6 +16485,7 @@ void	zbx_dc_close_user_macros(zbx_dc_um_handle_t *um_handle)
 	{
 		WRLOCK_CACHE;
 		um_cache_release(*um_handle->cache);
+		um_cache_flush_stats(&config->um_stats);
 		UNLOCK_CACHE;
 
 		*um_handle->cache = NULL;
@@ -15279,6 +16495,135 @@ void	zbx_dc_close_user_macros(zbx_dc_um_handle_t *um_handle)
 	zbx_free(um_handle);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get resolved user macro cache statistics                          *
+ *                                                                            *
+ * Parameters: stats - [OUT] the statistics                                   *
+ *                                                                            *
+ * Comments: The statistics are collected from processes when they release    *
+ *           user macro cache or synchronize configuration cache.             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_um_cache_stats(zbx_um_cache_stats_t *stats)
+{
+	RDLOCK_CACHE;
+	*stats = config->um_stats;
+	UNLOCK_CACHE;
+}
+
+ZBX_VECTOR_IMPL(dc_object_mem_stats, zbx_dc_object_mem_stats_t)
+
+static void	dc_add_object_mem_stats(zbx_vector_dc_object_mem_stats_t *objects, const char *name,
+		const zbx_hashset_t *hashset, size_t object_size, zbx_uint64_t data_size)
+{
+	zbx_dc_object_mem_stats_t	stats;
+
+	stats.name = name;
+	stats.objects_num = (zbx_uint64_t)hashset->num_data;
+	stats.size = (zbx_uint64_t)hashset->num_slots * sizeof(ZBX_HASHSET_ENTRY_T *) +
+			(zbx_uint64_t)hashset->num_data * (ZBX_HASHSET_ENTRY_OFFSET + object_size) + data_size;
+
+	zbx_vector_dc_object_mem_stats_append(objects, stats);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get configuration cache memory usage statistics                   *
+ *                                                                            *
+ * Parameters: mem     - [OUT] shared memory statistics (optional)            *
+ *             objects - [OUT] memory used by main object types (optional)    *
+ *             strpool - [OUT] string pool statistics (optional)              *
+ *                                                                            *
+ * Comments: Object and string pool statistics iterate items and the string   *
+ *           pool under configuration cache read lock, so they should be      *
+ *           requested only on demand.                                        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_mem_stats(zbx_shmem_stats_t *mem, zbx_vector_dc_object_mem_stats_t *objects,
+		zbx_dc_strpool_stats_t *strpool)
+{
+	RDLOCK_CACHE;
+
+	if (NULL != mem)
+		zbx_shmem_get_stats(config_mem, mem);
+
+	if (NULL != objects)
+	{
+		zbx_dc_item_tag_t	**tags;
+		zbx_hashset_iter_t	iter;
+		ZBX_DC_ITEM		*item;
+		zbx_uint64_t		arrays_size = 0, strings_size = 0;
+		const char		*record;
+
+		/* item trigger and tag arrays are accounted to items */
+		zbx_hashset_iter_reset(&config->items, &iter);
+		while (NULL != (item = (ZBX_DC_ITEM *)zbx_hashset_iter_next(&iter)))
+		{
+			ZBX_DC_TRIGGER	**triggers;
+
+			if (NULL != (triggers = item->triggers))
+			{
+				while (NULL != *triggers++)
+					;
+				arrays_size += (zbx_uint64_t)(triggers - item->triggers) * sizeof(ZBX_DC_TRIGGER *);
+			}
+
+			if (NULL != (tags = item->tags))
+			{
+				while (NULL != *tags++)
+					;
+				arrays_size += (zbx_uint64_t)(tags - item->tags) * sizeof(zbx_dc_item_tag_t *);
+			}
+		}
+
+		dc_add_object_mem_stats(objects, "items", &config->items, sizeof(ZBX_DC_ITEM), arrays_size);
+		dc_add_object_mem_stats(objects, "item keys", &config->items_hk, sizeof(ZBX_DC_ITEM_HK), 0);
+		dc_add_object_mem_stats(objects, "numeric items", &config->numitems, sizeof(ZBX_DC_NUMITEM), 0);
+		dc_add_object_mem_stats(objects, "item tags", &config->item_tags, sizeof(zbx_dc_item_tag_t), 0);
+		dc_add_object_mem_stats(objects, "preprocessing", &config->preprocops, sizeof(zbx_dc_preproc_op_t), 0);
+		dc_add_object_mem_stats(objects, "hosts", &config->hosts, sizeof(ZBX_DC_HOST), 0);
+		dc_add_object_mem_stats(objects, "host tags", &config->host_tags, sizeof(zbx_dc_host_tag_t), 0);
+		dc_add_object_mem_stats(objects, "interfaces", &config->interfaces, sizeof(ZBX_DC_INTERFACE), 0);
+		dc_add_object_mem_stats(objects, "triggers", &config->triggers, sizeof(ZBX_DC_TRIGGER), 0);
+		dc_add_object_mem_stats(objects, "trigger tags", &config->trigger_tags, sizeof(zbx_dc_trigger_tag_t), 0);
+		dc_add_object_mem_stats(objects, "functions", &config->functions, sizeof(ZBX_DC_FUNCTION), 0);
+
+		/* string arena records have variable size, header size is passed as object size */
+		zbx_hashset_iter_reset(&config->strarena, &iter);
+		while (NULL != (record = (const char *)zbx_hashset_iter_next(&iter)))
+			strings_size += strlen(STRREC_SUFFIX(record)) + 1;
+
+		dc_add_object_mem_stats(objects, "string arena", &config->strarena, STRREC_HEADER_SIZE, strings_size);
+	}
+
+	if (NULL != strpool)
+	{
+		zbx_hashset_iter_t	iter;
+		const char		*record;
+
+		memset(strpool, 0, sizeof(zbx_dc_strpool_stats_t));
+
+		zbx_hashset_iter_reset(&config->strpool, &iter);
+		while (NULL != (record = (const char *)zbx_hashset_iter_next(&iter)))
+		{
+			zbx_uint32_t	refcount = *(const zbx_uint32_t *)record;
+			size_t		size;
+
+			size = ZBX_HASHSET_ENTRY_OFFSET + REFCOUNT_FIELD_SIZE + strlen(record + REFCOUNT_FIELD_SIZE) + 1;
+
+			strpool->strings_num++;
+			strpool->refs_num += refcount;
+			strpool->size += size;
+			strpool->shared_size += (zbx_uint64_t)(refcount - 1) * size;
+		}
+
+		strpool->size += (zbx_uint64_t)config->strpool.num_slots * sizeof(ZBX_HASHSET_ENTRY_T *);
+	}
+
+	UNLOCK_CACHE;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get user macro using the specified hosts                          *
@@ -15400,7 +16745,7 @@ static void	dc_check_item_activation(ZBX_DC_ITEM *item, ZBX_DC_HOST *host,
 	if (ZBX_LOC_NOWHERE != item->location)
 		return;
 
-	if (0 != host->proxyid && SUCCEED != zbx_is_item_processed_by_server(item->type, item->key))
+	if (0 != host->proxyid && SUCCEED != dc_item_is_processed_by_server(item))
 		return;
 
 	if (NULL == zbx_hashset_search(activated_hosts, &host->hostid))
@@ -15440,7 +16785,7 @@ static void	dc_get_items_to_reschedule(const zbx_hashset_t *activated_hosts, zbx
 	while (NULL != (item = (ZBX_DC_ITEM *)zbx_hashset_iter_next(&iter)))
 	{
 		if (ITEM_STATUS_ACTIVE != item->status ||
-				SUCCEED != zbx_is_counted_in_item_queue(item->type, item->key))
+				SUCCEED != zbx_is_counted_in_item_queue(item->type, dc_strarena_head(item->key)))
 		{
 			continue;
 		}
@@ -15451,10 +16796,10 @@ static void	dc_get_items_to_reschedule(const zbx_hashset_t *activated_hosts, zbx
 		if (HOST_STATUS_MONITORED != host->status)
 			continue;
 
-		if (NULL == strstr(item->delay, "{$"))
+		if (NULL == strstr(dc_strarena_get(item->delay), "{$"))
 		{
 			/* neither new item revision or the last one had macro in delay */
-			if (NULL == item->delay_ex)
+			if (0 == item->delay_ex)
 			{
 				dc_check_item_activation(item, host, activated_hosts, activated_items);
 				continue;
@@ -15463,9 +16808,12 @@ static void	dc_get_items_to_reschedule(const zbx_hashset_t *activated_hosts, zbx
 			delay_ex = NULL;
 		}
 		else
-			delay_ex = dc_expand_user_macros_dyn(item->delay, &item->hostid, 1, ZBX_MACRO_ENV_NONSECURE);
+		{
+			delay_ex = dc_expand_user_macros_dyn(dc_strarena_get(item->delay), &item->hostid, 1,
+					ZBX_MACRO_ENV_NONSECURE);
+		}
 
-		if (0 != zbx_strcmp_null(item->delay_ex, delay_ex))
+		if (0 != zbx_strcmp_null(dc_strarena_get(item->delay_ex), delay_ex))
 		{
 			zbx_item_delay_t	*item_delay;
 
@@ -15542,8 +16890,8 @@ static void	dc_reschedule_items(const zbx_hashset_t *activated_hosts)
 			{
 				/* Macro is removed form item delay, which means item was already */
 				/* rescheduled by syncer. Just reset the delay_ex in cache.       */
-				dc_strpool_release(item->delay_ex);
-				item->delay_ex = NULL;
+				dc_strarena_release(item->delay_ex);
+				item->delay_ex = 0;
 				continue;
 			}
 
@@ -15551,13 +16899,14 @@ static void	dc_reschedule_items(const zbx_hashset_t *activated_hosts)
 			{
 				/* update nextcheck for active and monitored by proxy items */
 				/* for queue requests by frontend.                          */
-				if (NULL != item->delay_ex)
+				if (0 != item->delay_ex)
 					(void)DCitem_nextcheck_update(item, NULL, ZBX_ITEM_DELAY_CHANGED, now, NULL);
 			}
-			else if (NULL != item->delay_ex)
+			else if (0 != item->delay_ex)
 				dc_reschedule_item(item, items.values[i]->host, now);
 
-			dc_strpool_replace(NULL != item->delay_ex, &item->delay_ex, items.values[i]->delay_ex);
+			dc_strarena_replace(0 != item->delay_ex, &item->delay_ex, items.values[i]->delay_ex,
+					ZBX_DC_STR_PLAIN);
 		}
 
 		for (i = 0; i < activated_items.values_num; i++)
@@ -15873,6 +17222,25 @@ void	zbx_dc_httptest_queue(time_t now, zbx_uint64_t httptestid, int delay)
 	UNLOCK_CACHE;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the configuration cache revision                              *
+ *                                                                            *
+ * Comments: The revision is increased on every configuration cache sync and  *
+ *           can be used to invalidate data derived from configuration.       *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint64_t	zbx_dc_get_config_revision(void)
+{
+	zbx_uint64_t	revision;
+
+	RDLOCK_CACHE;
+	revision = config->revision.config;
+	UNLOCK_CACHE;
+
+	return revision;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get the configuration revision received from server               *
@@ -16044,6 +17412,7 @@ void	zbx_dc_get_unused_macro_templates(zbx_hashset_t *templates, const zbx_vecto
 #ifdef HAVE_TESTS
 #	include "../../../tests/libs/zbxdbcache/dc_item_poller_type_update_test.c"
 #	include "../../../tests/libs/zbxdbcache/dc_function_calculate_nextcheck_test.c"
+#	include "../../../tests/libs/zbxdbcache/dc_item_match_tag_test.c"
 #endif
 
 void	zbx_recalc_time_period(time_t *ts_from, int table_group)
@@ -26,12 +26,29 @@
 #include "zbxmutexs.h"
 #include "zbxalgo.h"
 #include "zbxversion.h"
+#include "zbxstr.h"
 #include "zbx_trigger_constants.h"
 #include "zbx_host_constants.h"
 
 #define ZBX_MAINTENANCE_IDLE		0
 #define ZBX_MAINTENANCE_RUNNING		1
 
+/* Configuration cache string arena reference - offset of interned string record from the */
+/* configuration cache shared memory base in ZBX_DC_STR_ALIGN byte units, 0 if not set.    */
+/* Interned strings are unique, so equal references mean equal strings.                    */
+typedef zbx_uint32_t	zbx_dc_str_t;
+
+#define ZBX_DC_STR_ALIGN	8
+
+/* the largest configuration cache addressable by string arena references */
+#define ZBX_DC_STR_CACHE_SIZE_MAX	(ZBX_DC_STR_ALIGN * __UINT64_C(0x100000000))
+
+/* string arena interning modes */
+#define ZBX_DC_STR_PLAIN	0	/* whole string is stored in one record */
+#define ZBX_DC_STR_KEY		1	/* item key name with opening bracket is shared between keys */
+
+#define ZBX_DC_ITEM_KEY_SIZE	(ZBX_ITEM_KEY_LEN * ZBX_MAX_BYTES_IN_UTF8_CHAR + 1)
+
 #define ZBX_LOC_NOWHERE	0
 #define ZBX_LOC_QUEUE	1
 #define ZBX_LOC_POLLER	2
@@ -71,6 +88,7 @@ typedef struct
 	unsigned char		timer;
 	unsigned char		flags;
 
+	zbx_uint64_t		templateid;
 	zbx_uint64_t		*itemids;
 
 	zbx_vector_ptr_t	tags;
@@ -117,6 +135,17 @@ typedef struct
 }
 ZBX_DC_PREPROCITEM;
 
+typedef struct
+{
+	zbx_uint64_t	itemtagid;
+	zbx_uint64_t	itemid;
+	const char	*tag;
+	const char	*value;
+}
+zbx_dc_item_tag_t;
+
+/* Item fields are grouped by size to avoid padding, there are millions of items in large installations. */
+/* Variable length data is kept in NULL terminated arrays instead of vectors to save per item memory.    */
 typedef struct
 {
 	zbx_uint64_t		itemid;
@@ -124,17 +153,21 @@ typedef struct
 	zbx_uint64_t		interfaceid;
 	zbx_uint64_t		lastlogsize;
 	zbx_uint64_t		valuemapid;
-	const char		*key;
-	const char		*port;
-	const char		*error;
-	const char		*delay;
-	const char		*delay_ex;
-	const char		*history_period;
+	zbx_uint64_t		templateid;
+	zbx_uint64_t		revision;
 	ZBX_DC_TRIGGER		**triggers;
+	zbx_dc_item_tag_t	**tags;		/* NULL terminated array of item tags, NULL if item has no tags */
+	ZBX_DC_PREPROCITEM	*preproc_item;
+	ZBX_DC_MASTERITEM	*master_item;
 	int			nextcheck;
 	int			mtime;
 	int			data_expected_from;
-	zbx_uint64_t		revision;
+	zbx_dc_str_t		key;		/* interned with ZBX_DC_STR_KEY mode */
+	zbx_dc_str_t		error;
+	zbx_dc_str_t		delay;
+	zbx_dc_str_t		delay_ex;
+	zbx_dc_str_t		history_period;
+	zbx_dc_str_t		timeout;
 	unsigned char		type;
 	unsigned char		value_type;
 	unsigned char		poller_type;
@@ -146,12 +179,6 @@ typedef struct
 	unsigned char		status;
 	unsigned char		queue_priority;
 	unsigned char		update_triggers;
-	zbx_uint64_t		templateid;
-	ZBX_DC_PREPROCITEM	*preproc_item;
-	ZBX_DC_MASTERITEM	*master_item;
-
-	zbx_vector_ptr_t	tags;
-	const char		*timeout;
 }
 ZBX_DC_ITEM;
 
@@ -181,8 +208,8 @@ ZBX_DC_PROTOTYPE_ITEM;
 typedef struct
 {
 	zbx_uint64_t	hostid;
-	const char	*key;
 	ZBX_DC_ITEM	*item_ptr;
+	zbx_dc_str_t	key;
 }
 ZBX_DC_ITEM_HK;
 
@@ -676,15 +703,6 @@ typedef struct
 }
 zbx_dc_trigger_tag_t;
 
-typedef struct
-{
-	zbx_uint64_t	itemtagid;
-	zbx_uint64_t	itemid;
-	const char	*tag;
-	const char	*value;
-}
-zbx_dc_item_tag_t;
-
 typedef struct
 {
 	zbx_uint64_t	hosttagid;
@@ -702,6 +720,13 @@ typedef struct
 }
 zbx_dc_host_tag_index_t;
 
+typedef struct
+{
+	const char	*name;		/* item key name without parameters */
+	zbx_hashset_t	itemids;
+}
+zbx_dc_item_key_index_t;
+
 typedef struct
 {
 	const char	*tag;
@@ -965,6 +990,7 @@ typedef struct
 	zbx_hashset_t		action_conditions;
 	zbx_hashset_t		trigger_tags;
 	zbx_hashset_t		item_tags;
+	zbx_hashset_t		item_key_index;		/* item index by key name */
 	zbx_hashset_t		host_tags;
 	zbx_hashset_t		host_tags_index;	/* host tag index by hostid */
 	zbx_hashset_t		correlations;
@@ -1002,7 +1028,9 @@ typedef struct
 	ZBX_DC_CONFIG_TABLE	*config;
 	ZBX_DC_STATUS		*status;
 	zbx_hashset_t		strpool;
+	zbx_hashset_t		strarena;
 	zbx_um_cache_t		*um_cache;
+	zbx_um_cache_stats_t	um_stats;		/* resolved user macro cache statistics */
 	char			autoreg_psk_identity[HOST_TLS_PSK_IDENTITY_LEN_MAX];	/* autoregistration PSK */
 	char			autoreg_psk[HOST_TLS_PSK_LEN_MAX];
 }
@@ -1039,6 +1067,20 @@ const char	*dc_strpool_acquire(const char *str);
 void	dc_strpool_release(const char *str);
 int	dc_strpool_replace(int found, const char **curr, const char *new_str);
 
+/* string arena */
+zbx_dc_str_t	dc_strarena_intern(const char *str, int mode);
+zbx_dc_str_t	dc_strarena_find(const char *str, int mode);
+zbx_dc_str_t	dc_strarena_acquire(zbx_dc_str_t ref);
+void	dc_strarena_release(zbx_dc_str_t ref);
+int	dc_strarena_replace(int found, zbx_dc_str_t *curr, const char *new_str, int mode);
+int	dc_strarena_cmp(zbx_dc_str_t ref, const char *str);
+const char	*dc_strarena_get(zbx_dc_str_t ref);
+const char	*dc_strarena_head(zbx_dc_str_t ref);
+char	*dc_strarena_copy(zbx_dc_str_t ref, char *buf, size_t size);
+
+/* copy item key to buffer, the buffer must be an array of ZBX_DC_ITEM_KEY_SIZE bytes */
+#define dc_item_key(item, buf)	dc_strarena_copy((item)->key, buf, sizeof(buf))
+
 /* host groups */
 void	dc_get_nested_hostgroupids(zbx_uint64_t groupid, zbx_vector_uint64_t *nested_groupids);
 void	dc_hostgroup_cache_nested_groupids(zbx_dc_hostgroup_t *parent_group);
@@ -573,7 +573,9 @@ static void	DCdump_item_tags(const ZBX_DC_ITEM *item)
 
 	zbx_vector_ptr_create(&index);
 
-	zbx_vector_ptr_append_array(&index, item->tags.values, item->tags.values_num);
+	for (i = 0; NULL != item->tags[i]; i++)
+		zbx_vector_ptr_append(&index, item->tags[i]);
+
 	zbx_vector_ptr_sort(&index, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
 
 	zabbix_log(LOG_LEVEL_TRACE, "  tags:");
@@ -595,6 +597,7 @@ static void	DCdump_items(void)
 	int			i, j;
 	zbx_vector_ptr_t	index;
 	void			*ptr;
+	char			key[ZBX_DC_ITEM_KEY_SIZE];
 	zbx_trace_item_t	trace_items[] =
 	{
 		{&config->numitems, (zbx_dc_dump_func_t)DCdump_numitem},
@@ -626,16 +629,16 @@ static void	DCdump_items(void)
 	{
 		item = (ZBX_DC_ITEM *)index.values[i];
 		zabbix_log(LOG_LEVEL_TRACE, "itemid:" ZBX_FS_UI64 " hostid:" ZBX_FS_UI64 " key:'%s' revision:" ZBX_FS_UI64,
-				item->itemid, item->hostid, item->key, item->revision);
+				item->itemid, item->hostid, dc_item_key(item, key), item->revision);
 		zabbix_log(LOG_LEVEL_TRACE, "  type:%u value_type:%u", item->type, item->value_type);
 		zabbix_log(LOG_LEVEL_TRACE, "  interfaceid:" ZBX_FS_UI64, item->interfaceid);
-		zabbix_log(LOG_LEVEL_TRACE, "  state:%u error:'%s'", item->state, item->error);
+		zabbix_log(LOG_LEVEL_TRACE, "  state:%u error:'%s'", item->state, dc_strarena_get(item->error));
 		zabbix_log(LOG_LEVEL_TRACE, "  flags:%u status:%u", item->flags, item->status);
 		zabbix_log(LOG_LEVEL_TRACE, "  valuemapid:" ZBX_FS_UI64, item->valuemapid);
 		zabbix_log(LOG_LEVEL_TRACE, "  lastlogsize:" ZBX_FS_UI64 " mtime:%d", item->lastlogsize, item->mtime);
-		zabbix_log(LOG_LEVEL_TRACE, "  delay:'%s' nextcheck:%d", item->delay, item->nextcheck);
+		zabbix_log(LOG_LEVEL_TRACE, "  delay:'%s' nextcheck:%d", dc_strarena_get(item->delay), item->nextcheck);
 		zabbix_log(LOG_LEVEL_TRACE, "  data_expected_from:%d", item->data_expected_from);
-		zabbix_log(LOG_LEVEL_TRACE, "  history:%s", item->history_period);
+		zabbix_log(LOG_LEVEL_TRACE, "  history:%s", dc_strarena_get(item->history_period));
 		zabbix_log(LOG_LEVEL_TRACE, "  poller_type:%u location:%u", item->poller_type, item->location);
 		zabbix_log(LOG_LEVEL_TRACE, "  inventory_link:%u", item->inventory_link);
 		zabbix_log(LOG_LEVEL_TRACE, "  priority:%u", item->queue_priority);
@@ -652,7 +655,7 @@ static void	DCdump_items(void)
 		if (NULL != item->preproc_item)
 			DCdump_preprocitem(item->preproc_item);
 
-		if (0 != item->tags.values_num)
+		if (NULL != item->tags)
 			DCdump_item_tags(item);
 
 		if (NULL != item->triggers)
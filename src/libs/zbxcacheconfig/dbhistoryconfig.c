@@ -53,6 +53,7 @@ static void	dc_get_history_sync_host(zbx_history_sync_host_t *dst_host, const ZB
 static void	dc_get_history_sync_item(zbx_history_sync_item_t *dst_item, const ZBX_DC_ITEM *src_item)
 {
 	const ZBX_DC_NUMITEM	*numitem;
+	const char		*error;
 
 	dst_item->type = src_item->type;
 	dst_item->value_type = src_item->value_type;
@@ -61,8 +62,8 @@ static void	dc_get_history_sync_item(zbx_history_sync_item_t *dst_item, const ZB
 	dst_item->lastlogsize = src_item->lastlogsize;
 	dst_item->mtime = src_item->mtime;
 
-	if ('\0' != *src_item->error)
-		dst_item->error = zbx_strdup(NULL, src_item->error);
+	if ('\0' != *(error = dc_strarena_get(src_item->error)))
+		dst_item->error = zbx_strdup(NULL, error);
 	else
 		dst_item->error = NULL;
 
@@ -70,10 +71,10 @@ static void	dc_get_history_sync_item(zbx_history_sync_item_t *dst_item, const ZB
 	dst_item->valuemapid = src_item->valuemapid;
 	dst_item->status = src_item->status;
 
-	dst_item->history_period = zbx_strdup(NULL, src_item->history_period);
+	dst_item->history_period = zbx_strdup(NULL, dc_strarena_get(src_item->history_period));
 	dst_item->flags = src_item->flags;
 
-	zbx_strscpy(dst_item->key_orig, src_item->key);
+	dc_item_key(src_item, dst_item->key_orig);
 
 	switch (src_item->value_type)
 	{
@@ -528,7 +529,7 @@ static void	dc_get_history_recv_item(zbx_history_recv_item_t *dst_item, const ZB
 	dst_item->state = ITEM_STATE_NORMAL;
 	dst_item->status = src_item->status;
 
-	zbx_strscpy(dst_item->key_orig, src_item->key);
+	dc_item_key(src_item, dst_item->key_orig);
 
 	dst_item->itemid = src_item->itemid;
 	dst_item->flags = src_item->flags;
@@ -831,12 +831,15 @@ int	zbx_dbsync_next(zbx_dbsync_t *sync, zbx_uint64_t *rowid, char ***row, unsign
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static char	*encode_expression(const zbx_eval_context_t *ctx)
+static char	*encode_expression(zbx_eval_context_t *ctx)
 {
 	unsigned char	*data;
 	size_t		len;
 	char		*str = NULL;
 
+	/* compile expression once during sync so evaluations can skip interpreting numeric parts */
+	zbx_eval_compile(ctx);
+
 	len = zbx_eval_serialize(ctx, NULL, &data);
 	zbx_base64_encode_dyn((const char *)data, &str, len);
 	zbx_free(data);
@@ -2012,6 +2015,8 @@ static char	**dbsync_trigger_preproc_row(char **row)
  *          serialized expression/recovery expression.                        *
  *          The 18th field is placeholder for trigger timer flag (set if      *
  *          expression/recovery expression contains timer functions).         *
+ *          Template triggers are also cached (without functions) to resolve  *
+ *          trigger template hierarchy.                                       *
  *                                                                            *
  ******************************************************************************/
 int	zbx_dbsync_compare_triggers(zbx_dbsync_t *sync)
@@ -2023,10 +2028,10 @@ int	zbx_dbsync_compare_triggers(zbx_dbsync_t *sync)
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
 			"select triggerid,description,expression,error,priority,type,value,state,lastchange,status,"
 			"recovery_mode,recovery_expression,correlation_mode,correlation_tag,opdata,event_name,null,"
-			"null,null,flags"
+			"null,null,flags,templateid"
 			" from triggers");
 
-	dbsync_prepare(sync, 20, dbsync_trigger_preproc_row);
+	dbsync_prepare(sync, 21, dbsync_trigger_preproc_row);
 
 	if (ZBX_DBSYNC_INIT == sync->mode)
 	{
@@ -45,6 +45,30 @@ typedef enum
 }
 zbx_um_update_cause_t;
 
+/* the maximum number of resolved macros cached by process before the cache is reset */
+#define ZBX_UM_RESOLVED_MAX	100000
+
+/* user macro resolved in the scope of specified hosts */
+typedef struct
+{
+	zbx_uint64_t	*hostids;
+	int		hostids_num;
+	char		*macro;			/* the macro token with optional context */
+	size_t		macro_len;
+	char		*value;
+	zbx_uint64_t	cache_version;		/* user macro cache version the value was validated against */
+	zbx_uint64_t	scope_version;		/* the highest version of the hosts, their templates and */
+						/* global macros at the time the value was resolved      */
+	unsigned char	type;
+	unsigned char	found;
+}
+zbx_um_resolved_t;
+
+/* process (thread) local cache of resolved user macros */
+static ZBX_THREAD_LOCAL zbx_hashset_t		um_resolved;
+static ZBX_THREAD_LOCAL int			um_resolved_init = 0;
+static ZBX_THREAD_LOCAL zbx_um_cache_stats_t	um_resolved_stats;
+
 /*********************************************************************************
  *                                                                               *
  * Purpose: create duplicate user macro cache                                    *
@@ -65,6 +89,7 @@ static zbx_um_cache_t	*um_cache_dup(zbx_um_cache_t *cache)
 
 	dup = (zbx_um_cache_t *)__config_shmem_malloc_func(NULL, sizeof(zbx_um_cache_t));
 	dup->refcount = 1;
+	dup->version = cache->version;
 
 	zbx_hashset_copy(&dup->hosts, &cache->hosts, sizeof(zbx_um_host_t *));
 	zbx_hashset_iter_reset(&dup->hosts, &iter);
@@ -141,6 +166,7 @@ zbx_um_cache_t	*um_cache_create(void)
 	cache = (zbx_um_cache_t *)__config_shmem_malloc_func(NULL, sizeof(zbx_um_cache_t));
 	cache->refcount = 1;
 	cache->revision = 0;
+	cache->version = 0;
 	zbx_hashset_create_ext(&cache->hosts, 10, um_host_hash, um_host_compare, NULL,
 			__config_shmem_malloc_func, __config_shmem_realloc_func, __config_shmem_free_func);
 
@@ -246,6 +272,7 @@ static zbx_um_host_t	*um_host_dup(zbx_um_host_t *host)
 	dup->refcount = 1;
 	dup->macro_revision = host->macro_revision;
 	dup->link_revision = host->link_revision;
+	dup->version = host->version;
 
 	zbx_vector_uint64_create_ext(&dup->templateids, __config_shmem_malloc_func, __config_shmem_realloc_func,
 			__config_shmem_free_func);
@@ -306,6 +333,7 @@ static zbx_um_host_t	*um_cache_create_host(zbx_um_cache_t *cache, zbx_uint64_t h
 	host->refcount = 1;
 	host->macro_revision = cache->revision;
 	host->link_revision = cache->revision;
+	host->version = cache->version;
 	zbx_vector_uint64_create_ext(&host->templateids, __config_shmem_malloc_func, __config_shmem_realloc_func,
 			__config_shmem_free_func);
 	zbx_vector_um_macro_create_ext(&host->macros, __config_shmem_malloc_func, __config_shmem_realloc_func,
@@ -349,6 +377,8 @@ static zbx_um_host_t	*um_cache_acquire_host(zbx_um_cache_t *cache, zbx_uint64_t
 				break;
 		}
 
+		(*phost)->version = cache->version;
+
 		return *phost;
 
 	}
@@ -873,6 +903,7 @@ zbx_um_cache_t	*um_cache_sync(zbx_um_cache_t *cache, zbx_uint64_t revision, zbx_
 	}
 
 	cache->revision = revision;
+	cache->version++;
 
 	um_cache_sync_macros(cache, gmacros, 1, config_vault, program_type);
 	um_cache_sync_macros(cache, hmacros, 2, config_vault, program_type);
@@ -1055,6 +1086,203 @@ static void	um_cache_get_macro(const zbx_um_cache_t *cache, const zbx_uint64_t *
 	zbx_free(context);
 }
 
+/* resolved user macro hashset support */
+
+static zbx_hash_t	um_resolved_hash(const void *d)
+{
+	const zbx_um_resolved_t	*resolved = (const zbx_um_resolved_t *)d;
+	zbx_hash_t		hash;
+
+	hash = ZBX_DEFAULT_STRING_HASH_ALGO(resolved->macro, resolved->macro_len, ZBX_DEFAULT_HASH_SEED);
+
+	return ZBX_DEFAULT_HASH_ALGO(resolved->hostids, sizeof(zbx_uint64_t) * (size_t)resolved->hostids_num, hash);
+}
+
+static int	um_resolved_compare(const void *d1, const void *d2)
+{
+	const zbx_um_resolved_t	*r1 = (const zbx_um_resolved_t *)d1;
+	const zbx_um_resolved_t	*r2 = (const zbx_um_resolved_t *)d2;
+	int			ret;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->hostids_num, r2->hostids_num);
+
+	if (0 != (ret = memcmp(r1->hostids, r2->hostids, sizeof(zbx_uint64_t) * (size_t)r1->hostids_num)))
+		return ret;
+
+	ZBX_RETURN_IF_NOT_EQUAL(r1->macro_len, r2->macro_len);
+
+	return memcmp(r1->macro, r2->macro, r1->macro_len);
+}
+
+static void	um_resolved_clean(void *d)
+{
+	zbx_um_resolved_t	*resolved = (zbx_um_resolved_t *)d;
+
+	zbx_free(resolved->hostids);
+	zbx_free(resolved->macro);
+	zbx_free(resolved->value);
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get the highest update version of the specified hosts and their      *
+ *          templates                                                            *
+ *                                                                               *
+ * Parameters: cache       - [IN] the user macro cache                           *
+ *             hostids     - [IN] the host identifiers                           *
+ *             hostids_num - [IN] the number of host identifiers                 *
+ *             version     - [IN/OUT] the version                                *
+ *                                                                               *
+ *********************************************************************************/
+static void	um_cache_get_scope_version(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids,
+		int hostids_num, zbx_uint64_t *version)
+{
+	int	i;
+
+	for (i = 0; i < hostids_num; i++)
+	{
+		const zbx_um_host_t	* const *phost;
+		const zbx_uint64_t	*phostid = &hostids[i];
+
+		if (NULL == (phost = (const zbx_um_host_t * const *)zbx_hashset_search(&cache->hosts, &phostid)))
+			continue;
+
+		if ((*phost)->version > *version)
+			*version = (*phost)->version;
+
+		um_cache_get_scope_version(cache, (*phost)->templateids.values, (*phost)->templateids.values_num,
+				version);
+	}
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get user macro (host/global) from local resolved macro cache         *
+ *                                                                               *
+ * Parameters: cache       - [IN] the user macro cache                           *
+ *             hostids     - [IN] the host identifiers                           *
+ *             hostids_num - [IN] the number of host identifiers                 *
+ *             macro       - [IN] the macro with optional context, can be        *
+ *                                followed by other text                         *
+ *                                                                               *
+ * Return value: The resolved macro.                                             *
+ *                                                                               *
+ * Comments: Resolved macros are validated against user macro cache version. If  *
+ *           it has changed the macro is resolved again only if the specified    *
+ *           hosts, their templates or global macros were updated.               *
+ *           Resolved macros are indexed by the macro token only, ignoring the   *
+ *           text following it.                                                  *
+ *           The returned object is valid until next call of this function.      *
+ *                                                                               *
+ *********************************************************************************/
+static const zbx_um_resolved_t	*um_cache_get_resolved(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids,
+		int hostids_num, const char *macro)
+{
+	zbx_um_resolved_t	resolved_local, *resolved;
+	const zbx_um_macro_t	*um_macro = NULL;
+	zbx_uint64_t		scope_version = 0, hostid = ZBX_UM_CACHE_GLOBAL_MACRO_HOSTID;
+	int			macro_r, context_l, context_r;
+	unsigned char		context_op;
+
+	if (0 == um_resolved_init)
+	{
+		zbx_hashset_create_ext(&um_resolved, 100, um_resolved_hash, um_resolved_compare, um_resolved_clean,
+				ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		um_resolved_init = 1;
+	}
+
+	resolved_local.hostids = (zbx_uint64_t *)hostids;
+	resolved_local.hostids_num = hostids_num;
+	resolved_local.macro = (char *)macro;
+
+	if (SUCCEED == zbx_user_macro_parse(macro, &macro_r, &context_l, &context_r, &context_op))
+		resolved_local.macro_len = (size_t)macro_r + 1;
+	else
+		resolved_local.macro_len = strlen(macro);
+
+	if (NULL != (resolved = (zbx_um_resolved_t *)zbx_hashset_search(&um_resolved, &resolved_local)))
+	{
+		if (resolved->cache_version == cache->version)
+		{
+			um_resolved_stats.hits++;
+			return resolved;
+		}
+
+		um_cache_get_scope_version(cache, hostids, hostids_num, &scope_version);
+		um_cache_get_scope_version(cache, &hostid, 1, &scope_version);
+
+		if (scope_version == resolved->scope_version)
+		{
+			resolved->cache_version = cache->version;
+			um_resolved_stats.hits++;
+			return resolved;
+		}
+
+		zbx_free(resolved->value);
+	}
+	else
+	{
+		if (ZBX_UM_RESOLVED_MAX <= um_resolved.num_data)
+			zbx_hashset_clear(&um_resolved);
+
+		if (0 != hostids_num)
+		{
+			resolved_local.hostids = (zbx_uint64_t *)zbx_malloc(NULL,
+					sizeof(zbx_uint64_t) * (size_t)hostids_num);
+			memcpy(resolved_local.hostids, hostids, sizeof(zbx_uint64_t) * (size_t)hostids_num);
+		}
+		else
+			resolved_local.hostids = NULL;
+
+		resolved_local.macro = (char *)zbx_malloc(NULL, resolved_local.macro_len + 1);
+		memcpy(resolved_local.macro, macro, resolved_local.macro_len);
+		resolved_local.macro[resolved_local.macro_len] = '\0';
+		resolved_local.value = NULL;
+
+		resolved = (zbx_um_resolved_t *)zbx_hashset_insert(&um_resolved, &resolved_local,
+				sizeof(resolved_local));
+
+		um_cache_get_scope_version(cache, hostids, hostids_num, &scope_version);
+		um_cache_get_scope_version(cache, &hostid, 1, &scope_version);
+	}
+
+	um_resolved_stats.misses++;
+
+	um_cache_get_macro(cache, hostids, hostids_num, macro, &um_macro);
+
+	resolved->cache_version = cache->version;
+	resolved->scope_version = scope_version;
+
+	if (NULL != um_macro)
+	{
+		resolved->found = 1;
+		resolved->type = um_macro->type;
+
+		if (NULL != um_macro->value)
+			resolved->value = zbx_strdup(NULL, um_macro->value);
+	}
+	else
+		resolved->found = 0;
+
+	return resolved;
+}
+
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: add local resolved user macro cache statistics to the specified      *
+ *          statistics and reset them                                            *
+ *                                                                               *
+ * Comments: This function must be called with configuration cache write lock.   *
+ *                                                                               *
+ *********************************************************************************/
+void	um_cache_flush_stats(zbx_um_cache_stats_t *stats)
+{
+	stats->hits += um_resolved_stats.hits;
+	stats->misses += um_resolved_stats.misses;
+
+	memset(&um_resolved_stats, 0, sizeof(um_resolved_stats));
+}
+
 /*********************************************************************************
  *                                                                               *
  * Purpose: resolve user macro (host/global)                                     *
@@ -1067,22 +1295,23 @@ static void	um_cache_get_macro(const zbx_um_cache_t *cache, const zbx_uint64_t *
  *                                  0 - secure                                   *
  *                                  1 - non-secure (secure macros are resolved   *
  *                                                  to ***** )                   *
- *             value       - [OUT] macro value, must be freed by the caller      *
+ *             value       - [OUT] macro value, valid until next macro is        *
+ *                                 resolved                                      *
  *                                                                               *
  *********************************************************************************/
 void	um_cache_resolve_const(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num,
 		const char *macro, int env, const char **value)
 {
-	const zbx_um_macro_t	*um_macro = NULL;
+	const zbx_um_resolved_t	*resolved;
 
-	um_cache_get_macro(cache, hostids, hostids_num, macro, &um_macro);
+	resolved = um_cache_get_resolved(cache, hostids, hostids_num, macro);
 
-	if (NULL != um_macro)
+	if (0 != resolved->found)
 	{
-		if (ZBX_MACRO_ENV_NONSECURE == env && ZBX_MACRO_VALUE_TEXT != um_macro->type)
+		if (ZBX_MACRO_ENV_NONSECURE == env && ZBX_MACRO_VALUE_TEXT != resolved->type)
 			*value = ZBX_MACRO_SECRET_MASK;
 		else
-			*value = (NULL != um_macro->value ? um_macro->value : ZBX_MACRO_NO_KVS_VALUE);
+			*value = (NULL != resolved->value ? resolved->value : ZBX_MACRO_NO_KVS_VALUE);
 	}
 }
 
@@ -1104,30 +1333,30 @@ void	um_cache_resolve_const(const zbx_um_cache_t *cache, const zbx_uint64_t *hos
 void	um_cache_resolve(const zbx_um_cache_t *cache, const zbx_uint64_t *hostids, int hostids_num, const char *macro,
 		int env, char **value)
 {
-	const zbx_um_macro_t	*um_macro = NULL;
+	const zbx_um_resolved_t	*resolved;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() macro:'%s'", __func__, macro);
 
-	um_cache_get_macro(cache, hostids, hostids_num, macro, &um_macro);
+	resolved = um_cache_get_resolved(cache, hostids, hostids_num, macro);
 
-	if (NULL != um_macro)
+	if (0 != resolved->found)
 	{
-		if (ZBX_MACRO_ENV_NONSECURE == env && ZBX_MACRO_VALUE_TEXT != um_macro->type)
+		if (ZBX_MACRO_ENV_NONSECURE == env && ZBX_MACRO_VALUE_TEXT != resolved->type)
 			*value = zbx_strdup(*value, ZBX_MACRO_SECRET_MASK);
 		else
-			*value = zbx_strdup(NULL, (NULL != um_macro->value ? um_macro->value : ZBX_MACRO_NO_KVS_VALUE));
+			*value = zbx_strdup(NULL, (NULL != resolved->value ? resolved->value : ZBX_MACRO_NO_KVS_VALUE));
 	}
 
 	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_DEBUG))
 	{
 		const char	*out = NULL;
 
-		if (NULL != um_macro)
+		if (0 != resolved->found)
 		{
-			if (ZBX_MACRO_VALUE_TEXT == um_macro->type)
-				out = um_macro->value;
+			if (ZBX_MACRO_VALUE_TEXT == resolved->type)
+				out = resolved->value;
 			else
-				out = (NULL == um_macro->value ? ZBX_MACRO_SECRET_MASK : ZBX_MACRO_NO_KVS_VALUE);
+				out = (NULL == resolved->value ? ZBX_MACRO_SECRET_MASK : ZBX_MACRO_NO_KVS_VALUE);
 		}
 
 		zabbix_log(LOG_LEVEL_DEBUG, "End of %s(): %s", __func__, ZBX_NULL2EMPTY_STR(out));
@@ -1159,6 +1388,7 @@ zbx_um_cache_t	*um_cache_set_value_to_macros(zbx_um_cache_t *cache, zbx_uint64_t
 	}
 
 	cache->revision = revision;
+	cache->version++;
 
 	for (i = 0; i < host_macro_ids->values_num; i++)
 	{
@@ -1417,6 +1647,9 @@ void	um_cache_remove_hosts(zbx_um_cache_t *cache, const zbx_vector_uint64_t *hos
 	zbx_um_host_t	**phost;
 	int		i;
 
+	if (0 != hostids->values_num)
+		cache->version++;
+
 	for (i = 0; i < hostids->values_num; i++)
 	{
 		zbx_uint64_t	*phostid = &hostids->values[i];
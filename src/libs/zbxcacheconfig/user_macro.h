@@ -48,6 +48,7 @@ typedef struct
 	zbx_uint32_t		refcount;
 	zbx_uint64_t		macro_revision;
 	zbx_uint64_t		link_revision;
+	zbx_uint64_t		version;	/* user macro cache version of the last host update */
 }
 zbx_um_host_t;
 
@@ -58,6 +59,8 @@ struct zbx_um_cache
 	zbx_hashset_t	hosts;
 	zbx_uint32_t	refcount;
 	zbx_uint64_t	revision;
+	zbx_uint64_t	version;	/* incremented with every cache update, including secret updates */
+					/* which do not change configuration revision                    */
 };
 
 zbx_hash_t	um_macro_hash(const void *d);
@@ -84,6 +87,8 @@ void	um_cache_get_unused_templates(zbx_um_cache_t *cache, zbx_hashset_t *templat
 		const zbx_vector_uint64_t *hostids, zbx_vector_uint64_t *templateids);
 void	um_cache_remove_hosts(zbx_um_cache_t *cache, const zbx_vector_uint64_t *hostids);
 
+void	um_cache_flush_stats(zbx_um_cache_stats_t *stats);
+
 void	um_cache_dump(zbx_um_cache_t *cache);
 
 #endif
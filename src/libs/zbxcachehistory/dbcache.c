@@ -37,6 +37,7 @@
 #include "zbxtagfilter.h"
 #include "zbxcrypto.h"
 #include "zbxeval.h"
+#include "zbxself.h"
 
 static zbx_shmem_info_t	*hc_index_mem = NULL;
 static zbx_shmem_info_t	*hc_mem = NULL;
@@ -194,11 +195,14 @@ void	zbx_dc_get_stats_all(zbx_wcache_info_t *wcache_info)
 	wcache_info->history_total = hc_mem->total_size;
 	wcache_info->index_free = hc_index_mem->free_size;
 	wcache_info->index_total = hc_index_mem->total_size;
+	wcache_info->history_huge_pages = hc_mem->huge_pages;
+	wcache_info->index_huge_pages = hc_index_mem->huge_pages;
 
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
 	{
 		wcache_info->trend_free = trend_mem->free_size;
 		wcache_info->trend_total = trend_mem->orig_size;
+		wcache_info->trend_huge_pages = trend_mem->huge_pages;
 	}
 
 	UNLOCK_CACHE;
@@ -313,6 +317,18 @@ void	*zbx_dc_get_stats(int request)
 			value_uint = cache->stats.history_bin_counter;
 			ret = (void *)&value_uint;
 			break;
+		case ZBX_STATS_HISTORY_HUGE_PAGES:
+			value_uint = hc_mem->huge_pages;
+			ret = (void *)&value_uint;
+			break;
+		case ZBX_STATS_HISTORY_INDEX_HUGE_PAGES:
+			value_uint = hc_index_mem->huge_pages;
+			ret = (void *)&value_uint;
+			break;
+		case ZBX_STATS_TREND_HUGE_PAGES:
+			value_uint = trend_mem->huge_pages;
+			ret = (void *)&value_uint;
+			break;
 		default:
 			ret = NULL;
 	}
@@ -639,10 +655,11 @@ static void	dc_trends_fetch_and_update(ZBX_DC_TREND *trends, int trends_num, zbx
  ******************************************************************************/
 static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uint64_pair_t *trends_diff)
 {
-	int		num, i, clock, inserts_num = 0, itemids_alloc, itemids_num = 0, trends_to = *trends_num;
+	int		num, i, clock, inserts_num = 0, itemids_alloc, itemids_num = 0, trends_to = *trends_num,
+			rollup_trends_num = 0;
 	unsigned char	value_type;
 	zbx_uint64_t	*itemids = NULL;
-	ZBX_DC_TREND	*trend = NULL;
+	ZBX_DC_TREND	*trend = NULL, *rollup_trends = NULL;
 	const char	*table_name;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() trends_num:%d", __func__, *trends_num);
@@ -686,6 +703,20 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 		}
 	}
 
+	/* keep the flushed trend data before it's merged with the existing trends to update rollups */
+	if (0 != zbx_trends_rollups_enabled())
+	{
+		rollup_trends = (ZBX_DC_TREND *)zbx_malloc(NULL, trends_to * sizeof(ZBX_DC_TREND));
+
+		for (i = 0; i < trends_to; i++)
+		{
+			if (clock != trends[i].clock || value_type != trends[i].value_type)
+				continue;
+
+			memcpy(&rollup_trends[rollup_trends_num++], &trends[i], sizeof(ZBX_DC_TREND));
+		}
+	}
+
 	if (0 != itemids_num)
 	{
 		dc_remove_updated_trends(trends, trends_to, table_name, value_type, itemids,
@@ -739,6 +770,12 @@ static void	DBflush_trends(ZBX_DC_TREND *trends, int *trends_num, zbx_vector_uin
 	if (0 != inserts_num)
 		dc_insert_trends_in_db(trends, trends_to, value_type, table_name, clock);
 
+	if (NULL != rollup_trends)
+	{
+		zbx_trends_update_rollups(rollup_trends, rollup_trends_num);
+		zbx_free(rollup_trends);
+	}
+
 	/* clean trends */
 	for (i = 0, num = 0; i < *trends_num; i++)
 	{
@@ -2069,6 +2106,25 @@ void	hc_free_item_values(zbx_dc_history_t *history, int history_num)
 		dc_history_clean_value(&history[i]);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: counts latency of values written to history storage               *
+ *                                                                            *
+ * Parameters: history     - [IN] history data                                *
+ *             history_num - [IN] number of values in history data            *
+ *                                                                            *
+ ******************************************************************************/
+void	hc_update_history_latency(const zbx_dc_history_t *history, int history_num)
+{
+	int		i;
+	zbx_timespec_t	now;
+
+	zbx_timespec(&now);
+
+	for (i = 0; i < history_num; i++)
+		zbx_latency_update(ZBX_LATENCY_STAGE_HISTORY, &now, &history[i].ts);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: sets history data to notsupported                                 *
@@ -3064,6 +3120,7 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 
 			if (FAIL != (ret = DBmass_add_history(history, history_num)))
 			{
+				hc_update_history_latency(history, history_num);
 				zbx_dc_config_items_apply_changes(&item_diff);
 				DCmass_update_trends(history, history_num, &trends, &trends_num, compression_age);
 
@@ -3158,8 +3215,14 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 				}
 				while (ZBX_DB_DOWN == txn_error);
 
-				if (ZBX_DB_OK == txn_error && NULL != events_cbs->events_update_itservices_cb)
-					events_cbs->events_update_itservices_cb();
+				if (ZBX_DB_OK == txn_error)
+				{
+					if (NULL != events_cbs->events_update_problem_cache_cb)
+						events_cbs->events_update_problem_cache_cb();
+
+					if (NULL != events_cbs->events_update_itservices_cb)
+						events_cbs->events_update_itservices_cb();
+				}
 			}
 		}
 
@@ -4336,6 +4399,9 @@ static void	hc_add_item_values(dc_item_value_t *values, int values_num)
 	dc_item_value_t	*item_value;
 	int		i;
 	zbx_hc_item_t	*item;
+	zbx_timespec_t	now;
+
+	zbx_timespec(&now);
 
 	for (i = 0; i < values_num; i++)
 	{
@@ -4387,6 +4453,8 @@ static void	hc_add_item_values(dc_item_value_t *values, int values_num)
 			item->head = data;
 		}
 		item->values_num++;
+
+		zbx_latency_update(ZBX_LATENCY_STAGE_HISTORYCACHE, &now, &item_value->ts);
 	}
 }
 
@@ -4494,6 +4562,9 @@ void	hc_get_item_values(zbx_dc_history_t *history, zbx_vector_ptr_t *history_ite
 {
 	int		i, history_num = 0;
 	zbx_hc_item_t	*item;
+	zbx_timespec_t	now;
+
+	zbx_timespec(&now);
 
 	/* we don't need to lock history cache because no other processes can  */
 	/* change item's history data until it is pushed back to history queue */
@@ -4505,6 +4576,7 @@ void	hc_get_item_values(zbx_dc_history_t *history, zbx_vector_ptr_t *history_ite
 			continue;
 
 		hc_copy_history_data(&history[history_num++], item->itemid, item->tail);
+		zbx_latency_update(ZBX_LATENCY_STAGE_SYNC, &now, &item->tail->ts);
 	}
 }
 
@@ -4663,6 +4735,8 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 		goto out;
 	}
 
+	zbx_shmem_enable_slabs(hc_mem);
+
 	if (SUCCEED != (ret = zbx_shmem_create(&hc_index_mem, history_index_cache_size, "history index cache",
 			"HistoryIndexCacheSize", 0, error)))
 	{
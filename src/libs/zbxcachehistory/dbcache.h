@@ -39,6 +39,7 @@ void	hc_push_items(zbx_vector_ptr_t *history_items);
 void	hc_get_item_values(zbx_dc_history_t *history, zbx_vector_ptr_t *history_items);
 int	hc_queue_get_size(void);
 void	hc_free_item_values(zbx_dc_history_t *history, int history_num);
+void	hc_update_history_latency(const zbx_dc_history_t *history, int history_num);
 
 void	dc_history_clean_value(zbx_dc_history_t *history);
 
@@ -404,6 +404,7 @@ void	zbx_sync_proxy_history(int *values_num, int *triggers_num, const zbx_events
 
 		DCmass_proxy_prepare_itemdiff(history, history_num, &item_diff);
 		DBmass_proxy_add_history(history, history_num);
+		hc_update_history_latency(history, history_num);
 
 		if (0 != item_diff.values_num)
 		{
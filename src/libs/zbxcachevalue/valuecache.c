@@ -267,6 +267,55 @@ static void	vc_cache_item_update(zbx_uint64_t itemid, zbx_vc_item_update_type_t
 	update->data[1] = arg2;
 }
 
+/* prefetched item history, see zbx_vc_prefetch_values() */
+typedef struct
+{
+	zbx_uint64_t			itemid;
+	zbx_timespec_t			ts;
+	unsigned char			value_type;
+	/* all item values newer than start and not newer than ts are prefetched */
+	zbx_timespec_t			start;
+	/* prefetched values in descending order */
+	zbx_vector_history_record_t	values;
+}
+zbx_vc_prefetch_item_t;
+
+/* process local prefetched history, indexed by itemid and period end timestamp */
+static zbx_hashset_t	vc_prefetch;
+
+/* the maximum number of values prefetched by one zbx_vc_prefetch_values() call */
+#define ZBX_VC_PREFETCH_VALUES_MAX	100000
+
+ZBX_VECTOR_IMPL(vc_prefetch, zbx_vc_prefetch_t)
+
+static zbx_hash_t	vc_prefetch_hash_func(const void *data)
+{
+	const zbx_vc_prefetch_item_t	*prefetch = (const zbx_vc_prefetch_item_t *)data;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&prefetch->itemid);
+	hash = ZBX_DEFAULT_HASH_ALGO(&prefetch->ts.sec, sizeof(prefetch->ts.sec), hash);
+
+	return ZBX_DEFAULT_HASH_ALGO(&prefetch->ts.ns, sizeof(prefetch->ts.ns), hash);
+}
+
+static int	vc_prefetch_compare_func(const void *d1, const void *d2)
+{
+	const zbx_vc_prefetch_item_t	*prefetch1 = (const zbx_vc_prefetch_item_t *)d1;
+	const zbx_vc_prefetch_item_t	*prefetch2 = (const zbx_vc_prefetch_item_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(prefetch1->itemid, prefetch2->itemid);
+
+	return zbx_timespec_compare(&prefetch1->ts, &prefetch2->ts);
+}
+
+static void	vc_prefetch_clean_func(void *data)
+{
+	zbx_vc_prefetch_item_t	*prefetch = (zbx_vc_prefetch_item_t *)data;
+
+	zbx_history_record_vector_destroy(&prefetch->values, prefetch->value_type);
+}
+
 /* the value cache */
 static zbx_vc_cache_t	*vc_cache = NULL;
 
@@ -2277,6 +2326,8 @@ out:
  *             seconds   - [IN] the time period to retrieve data for          *
  *             count     - [IN] the number of history values to retrieve      *
  *             ts        - [IN] the target timestamp                          *
+ *             account_hits - [IN] 1 - account returned values as cache hits  *
+ *                            0 - account only cache misses                   *
  *                                                                            *
  * Return value:  SUCCEED - the item history data was retrieved successfully  *
  *                FAIL    - the item history data was not retrieved           *
@@ -2291,7 +2342,7 @@ out:
  *                                                                            *
  ******************************************************************************/
 static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
-		int count, const zbx_timespec_t *ts)
+		int count, const zbx_timespec_t *ts, int account_hits)
 {
 	int	ret, records_read, hits, misses, range_start;
 
@@ -2327,7 +2378,7 @@ static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t
 			records_read = values->values_num;
 	}
 
-	hits = values->values_num - records_read;
+	hits = (0 != account_hits ? values->values_num - records_read : 0);
 	misses = records_read;
 
 	vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_STATS, hits, misses);
@@ -2437,6 +2488,10 @@ int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error)
 	zbx_vector_vc_itemupdate_create(&vc_itemupdates);
 	zbx_vector_vc_itemupdate_reserve(&vc_itemupdates, 256);
 
+	zbx_hashset_create_ext(&vc_prefetch, 0, vc_prefetch_hash_func, vc_prefetch_compare_func,
+			vc_prefetch_clean_func, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+
 	ret = SUCCEED;
 out:
 	zbx_vc_disable();
@@ -2458,6 +2513,7 @@ void	zbx_vc_destroy(void)
 	if (NULL != vc_cache)
 	{
 		zbx_vector_vc_itemupdate_destroy(&vc_itemupdates);
+		zbx_hashset_destroy(&vc_prefetch);
 
 		zbx_hashset_destroy(&vc_cache->items);
 		zbx_hashset_destroy(&vc_cache->strpool);
@@ -2574,6 +2630,126 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get item history data from cache, adding item to cache if         *
+ *          necessary                                                         *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the item id                                  *
+ *             value_type - [IN] the item value type                          *
+ *             values     - [OUT] the item history data stored time/value     *
+ *                          pairs in descending order                         *
+ *             seconds    - [IN] the time period to retrieve data for         *
+ *             count      - [IN] the number of history values to retrieve     *
+ *             ts         - [IN] the period end timestamp                     *
+ *             account_hits - [IN] 1 - account returned values as cache hits  *
+ *                             0 - account only cache misses                  *
+ *                                                                            *
+ * Return value:  SUCCEED - the item history data was retrieved successfully  *
+ *                FAIL    - the item history data was not retrieved from      *
+ *                          cache                                             *
+ *                                                                            *
+ * Comments: The cache must be locked.                                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_history_record_t *values,
+		int seconds, int count, const zbx_timespec_t *ts, int account_hits)
+{
+	zbx_vc_item_t	*item, new_item;
+
+	if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
+	{
+		if (ZBX_VC_MODE_NORMAL != vc_cache->mode)
+			return FAIL;
+
+		memset(&new_item, 0, sizeof(new_item));
+		new_item.itemid = itemid;
+		new_item.value_type = value_type;
+		item = &new_item;
+	}
+	else if (item->value_type != value_type)
+		return FAIL;
+
+	return vch_item_get_values(item, values, seconds, count, ts, account_hits);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get item history data from prefetched values                      *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the item id                                  *
+ *             value_type - [IN] the item value type                          *
+ *             values     - [OUT] the item history data stored time/value     *
+ *                          pairs in descending order                         *
+ *             seconds    - [IN] the time period to retrieve data for         *
+ *             count      - [IN] the number of history values to retrieve     *
+ *             ts         - [IN] the period end timestamp                     *
+ *                                                                            *
+ * Return value:  SUCCEED - the requested data was prefetched and returned    *
+ *                FAIL    - the requested data was not prefetched             *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_prefetch_get_values(zbx_uint64_t itemid, unsigned char value_type,
+		zbx_vector_history_record_t *values, int seconds, int count, const zbx_timespec_t *ts)
+{
+	zbx_vc_prefetch_item_t	*prefetch, prefetch_local;
+	zbx_timespec_t		start;
+	int			i, limit;
+
+	if (0 == vc_prefetch.num_data)
+		return FAIL;
+
+	prefetch_local.itemid = itemid;
+	prefetch_local.ts = *ts;
+
+	if (NULL == (prefetch = (zbx_vc_prefetch_item_t *)zbx_hashset_search(&vc_prefetch, &prefetch_local)) ||
+			value_type != prefetch->value_type)
+	{
+		return FAIL;
+	}
+
+	/* set start timestamp the same way as vch_item_get_values() does */
+	if (0 != seconds || 0 == count)
+	{
+		start.sec = ts->sec - seconds;
+		start.ns = ts->ns;
+	}
+	else
+	{
+		start.sec = 0;
+		start.ns = 0;
+	}
+
+	if (0 == count || count > prefetch->values.values_num)
+		limit = prefetch->values.values_num;
+	else
+		limit = count;
+
+	for (i = 0; i < limit; i++)
+	{
+		if (0 >= zbx_timespec_compare(&prefetch->values.values[i].timestamp, &start))
+			break;
+	}
+
+	/* when all prefetched values were taken without reaching the requested number of */
+	/* values or the start timestamp there might be older values that were not fetched */
+	if (i == prefetch->values.values_num && (0 == count || i < count) &&
+			0 > zbx_timespec_compare(&start, &prefetch->start))
+	{
+		return FAIL;
+	}
+
+	zbx_vector_history_record_clear(values);
+	zbx_vector_history_record_reserve(values, (size_t)i);
+
+	for (int j = 0; j < i; j++)
+		vc_history_record_vector_append(values, value_type, &prefetch->values.values[j]);
+
+	vc_cache_item_update(itemid, ZBX_VC_UPDATE_STATS, values->values_num, 0);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get item history data for the specified time period               *
@@ -2600,12 +2776,14 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_history_record_t *values,
 		int seconds, int count, const zbx_timespec_t *ts)
 {
-	zbx_vc_item_t	*item, new_item;
 	int 		ret = FAIL, cache_used = 1;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64 " value_type:%d count:%d period:%d end_timestamp"
 			" '%s'", __func__, itemid, value_type, count, seconds, zbx_timespec_str(ts));
 
+	if (SUCCEED == (ret = vc_prefetch_get_values(itemid, value_type, values, seconds, count, ts)))
+		goto prefetched;
+
 	RDLOCK_CACHE;
 
 	if (ZBX_VC_DISABLED == vc_state)
@@ -2614,20 +2792,7 @@ int	zbx_vc_get_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_
 	if (ZBX_VC_MODE_LOWMEM == vc_cache->mode)
 		vc_warn_low_memory();
 
-	if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
-	{
-		if (ZBX_VC_MODE_NORMAL != vc_cache->mode)
-			goto out;
-
-		memset(&new_item, 0, sizeof(new_item));
-		new_item.itemid = itemid;
-		new_item.value_type = value_type;
-		item = &new_item;
-	}
-	else if (item->value_type != value_type)
-		goto out;
-
-	ret = vch_item_get_values(item, values, seconds, count, ts);
+	ret = vc_get_values(itemid, value_type, values, seconds, count, ts, 1);
 out:
 	if (FAIL == ret)
 	{
@@ -2645,7 +2810,7 @@ out:
 	}
 
 	UNLOCK_CACHE;
-
+prefetched:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s count:%d cached:%d",
 			__func__, zbx_result_string(ret), values->values_num, cache_used);
 
@@ -2717,6 +2882,7 @@ int	zbx_vc_get_statistics(zbx_vc_stats_t *stats)
 
 	stats->total_size = vc_mem->total_size;
 	stats->free_size = vc_mem->free_size;
+	stats->huge_pages = vc_mem->huge_pages;
 
 	UNLOCK_CACHE;
 
@@ -2875,6 +3041,170 @@ void	zbx_vc_flush_stats(void)
 	zbx_vector_vc_itemupdate_clear(&vc_itemupdates);
 }
 
+static int	vc_prefetch_request_compare(const void *d1, const void *d2)
+{
+	const zbx_vc_prefetch_t	*request1 = (const zbx_vc_prefetch_t *)d1;
+	const zbx_vc_prefetch_t	*request2 = (const zbx_vc_prefetch_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(request1->itemid, request2->itemid);
+
+	return zbx_timespec_compare(&request1->ts, &request2->ts);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: fetches item values from cache to prefetched values               *
+ *                                                                            *
+ * Parameters: request     - [IN] the history request                         *
+ *             values_left - [IN/OUT] the number of values that still can be  *
+ *                                    prefetched                              *
+ *                                                                            *
+ * Return value:  SUCCEED - the item history data was prefetched              *
+ *                FAIL    - otherwise                                         *
+ *                                                                            *
+ * Comments: The cache must be locked.                                        *
+ *                                                                            *
+ *           Values are accounted as cache hits when returned from prefetched *
+ *           values, so only cache misses are accounted when prefetching.     *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_prefetch_item(const zbx_vc_prefetch_t *request, int *values_left)
+{
+	zbx_vc_prefetch_item_t	prefetch;
+
+	prefetch.itemid = request->itemid;
+	prefetch.ts = request->ts;
+	prefetch.value_type = request->value_type;
+	zbx_history_record_vector_create(&prefetch.values);
+
+	if (0 != request->seconds || 0 == request->count)
+	{
+		if (FAIL == vc_get_values(request->itemid, request->value_type, &prefetch.values, request->seconds,
+				0, &request->ts, 0))
+		{
+			goto fail;
+		}
+
+		prefetch.start.sec = request->ts.sec - request->seconds;
+		prefetch.start.ns = request->ts.ns;
+	}
+
+	if (prefetch.values.values_num < request->count)
+	{
+		/* the time period does not contain enough values, prefetch values by count instead */
+		vc_history_record_vector_clean(&prefetch.values, prefetch.value_type);
+
+		if (FAIL == vc_get_values(request->itemid, request->value_type, &prefetch.values, 0, request->count,
+				&request->ts, 0))
+		{
+			goto fail;
+		}
+
+		if (prefetch.values.values_num < request->count)
+		{
+			prefetch.start.sec = 0;
+			prefetch.start.ns = 0;
+		}
+		else
+			prefetch.start = prefetch.values.values[prefetch.values.values_num - 1].timestamp;
+	}
+
+	/* leave the request to be served directly from cache rather than exceeding the batch limit */
+	if (prefetch.values.values_num > *values_left)
+		goto fail;
+
+	*values_left -= prefetch.values.values_num;
+	zbx_hashset_insert(&vc_prefetch, &prefetch, sizeof(prefetch));
+
+	return SUCCEED;
+fail:
+	zbx_history_record_vector_destroy(&prefetch.values, prefetch.value_type);
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: fetches item history data for multiple requests with a single     *
+ *          cache lock                                                        *
+ *                                                                            *
+ * Parameters: requests - [IN/OUT] the history requests, sorted and merged    *
+ *                                 by itemid and period end timestamp         *
+ *                                                                            *
+ * Comments: Requests of the same item and period end timestamp are merged    *
+ *           into one request covering the longest period and the largest     *
+ *           number of values. Afterwards zbx_vc_get_values() returns         *
+ *           prefetched values for all requests covered by the merged request *
+ *           without locking cache until zbx_vc_prefetch_clear() is called.   *
+ *                                                                            *
+ *           Items that cannot be prefetched are left for zbx_vc_get_values() *
+ *           to read from database.                                           *
+ *                                                                            *
+ *           At most ZBX_VC_PREFETCH_VALUES_MAX values are prefetched, the    *
+ *           remaining requests are left for zbx_vc_get_values() to read from *
+ *           cache.                                                           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_prefetch_values(zbx_vector_vc_prefetch_t *requests)
+{
+	int	i, j, prefetched = 0, values_left = ZBX_VC_PREFETCH_VALUES_MAX;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() requests_num:%d", __func__, requests->values_num);
+
+	zbx_vc_prefetch_clear();
+
+	if (ZBX_VC_DISABLED == vc_state || 0 == requests->values_num)
+		goto out;
+
+	zbx_vector_vc_prefetch_sort(requests, vc_prefetch_request_compare);
+
+	for (i = 0, j = 1; j < requests->values_num; j++)
+	{
+		zbx_vc_prefetch_t	*request = &requests->values[i], *next = &requests->values[j];
+
+		if (0 != vc_prefetch_request_compare(request, next))
+		{
+			requests->values[++i] = *next;
+			continue;
+		}
+
+		if (request->seconds < next->seconds)
+			request->seconds = next->seconds;
+
+		if (request->count < next->count)
+			request->count = next->count;
+	}
+
+	requests->values_num = i + 1;
+
+	RDLOCK_CACHE;
+
+	if (ZBX_VC_MODE_LOWMEM == vc_cache->mode)
+		vc_warn_low_memory();
+
+	for (i = 0; i < requests->values_num && 0 < values_left; i++)
+	{
+		if (SUCCEED == vc_prefetch_item(&requests->values[i], &values_left))
+			prefetched++;
+	}
+
+	UNLOCK_CACHE;
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() requests_num:%d prefetched:%d values:%d", __func__,
+			requests->values_num, prefetched, ZBX_VC_PREFETCH_VALUES_MAX - values_left);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees item history data prefetched by zbx_vc_prefetch_values()    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_prefetch_clear(void)
+{
+	if (0 != vc_prefetch.num_data)
+		zbx_hashset_clear(&vc_prefetch);
+}
+
 #ifdef HAVE_TESTS
 #	include "../../../tests/libs/zbxdbcache/valuecache_test.c"
 #endif
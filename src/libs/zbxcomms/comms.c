@@ -1691,6 +1691,26 @@ void	zbx_tcp_unaccept(zbx_socket_t *s)
 	s->accepted = 0;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: close accepted connection in the current process only             *
+ *                                                                            *
+ * Comments: Used when the connection was handed over to a child process, so  *
+ *           it must not be shut down. Unencrypted connections only.          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_tcp_unaccept_local(zbx_socket_t *s)
+{
+	if (!s->accepted) return;
+
+	zbx_socket_free(s);
+	zbx_socket_close(s->socket);
+
+	s->socket = s->socket_orig;	/* restore main socket */
+	s->socket_orig = ZBX_SOCKET_ERROR;
+	s->accepted = 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: finds the next line in socket data buffer                         *
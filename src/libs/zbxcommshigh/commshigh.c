@@ -287,9 +287,7 @@ int	zbx_send_response_ext(zbx_socket_t *sock, int result, const char *info, cons
  ******************************************************************************/
 int	zbx_recv_response(zbx_socket_t *sock, int timeout, char **error)
 {
-	struct zbx_json_parse	jp;
-	char			value[16];
-	int			ret = FAIL;
+	int	ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -303,23 +301,49 @@ int	zbx_recv_response(zbx_socket_t *sock, int timeout, char **error)
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() '%s'", __func__, sock->buffer);
 
+	ret = zbx_check_response(sock->buffer, error);
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check received response for success value                         *
+ *                                                                            *
+ * Parameters: response - [IN] the received response                          *
+ *             error    - [OUT] the error message                             *
+ *                                                                            *
+ * Return value: SUCCEED - "response":"success" successfully retrieved        *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: When the "info" value is present in a negative response then it  *
+ *           is returned as the error message.                                *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_check_response(const char *response, char **error)
+{
+	struct zbx_json_parse	jp;
+	char			value[16];
+
 	/* deal with empty string here because zbx_json_open() does not produce an error message in this case */
-	if ('\0' == *sock->buffer)
+	if ('\0' == *response)
 	{
 		*error = zbx_strdup(*error, "empty string received");
-		goto out;
+		return FAIL;
 	}
 
-	if (SUCCEED != zbx_json_open(sock->buffer, &jp))
+	if (SUCCEED != zbx_json_open(response, &jp))
 	{
 		*error = zbx_strdup(*error, zbx_json_strerror());
-		goto out;
+		return FAIL;
 	}
 
 	if (SUCCEED != zbx_json_value_by_name(&jp, ZBX_PROTO_TAG_RESPONSE, value, sizeof(value), NULL))
 	{
 		*error = zbx_strdup(*error, "no \"" ZBX_PROTO_TAG_RESPONSE "\" tag");
-		goto out;
+		return FAIL;
 	}
 
 	if (0 != strcmp(value, ZBX_PROTO_VALUE_SUCCESS))
@@ -332,12 +356,9 @@ int	zbx_recv_response(zbx_socket_t *sock, int timeout, char **error)
 		else
 			*error = zbx_dsprintf(*error, "negative response \"%s\"", value);
 		zbx_free(info);
-		goto out;
-	}
 
-	ret = SUCCEED;
-out:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+		return FAIL;
+	}
 
-	return ret;
+	return SUCCEED;
 }
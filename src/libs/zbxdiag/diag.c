@@ -23,12 +23,14 @@
 #include "zbxalgo.h"
 #include "zbxshmem.h"
 #include "zbxcachehistory.h"
+#include "zbxcacheconfig.h"
 #include "zbxconnector.h"
 #include "zbxlog.h"
 #include "zbxmutexs.h"
 #include "zbxtime.h"
 #include "zbxnum.h"
 #include "zbxproxybuffer.h"
+#include "zbxself.h"
 
 #define ZBX_DIAG_SECTION_MAX	64
 #define ZBX_DIAG_FIELD_MAX	64
@@ -47,6 +49,16 @@
 #define ZBX_DIAG_CONNECTOR_VALUES			0x00000001
 #define ZBX_DIAG_CONNECTOR_SIMPLE		(ZBX_DIAG_CONNECTOR_VALUES)
 
+#define ZBX_DIAG_CONFIGCACHE_USERMACROS		0x00000001
+#define ZBX_DIAG_CONFIGCACHE_OBJECTS		0x00000002
+#define ZBX_DIAG_CONFIGCACHE_STRINGS		0x00000004
+#define ZBX_DIAG_CONFIGCACHE_MEMORY		0x00000008
+/* objects and strings scan the whole configuration cache, so they are returned only when requested */
+#define ZBX_DIAG_CONFIGCACHE_SIMPLE		(ZBX_DIAG_CONFIGCACHE_USERMACROS)
+
+#define ZBX_DIAG_LATENCY_STAGES			0x00000001
+#define ZBX_DIAG_LATENCY_SIMPLE			(ZBX_DIAG_LATENCY_STAGES)
+
 static zbx_diag_add_section_info_func_t	add_diag_cb;
 
 void	zbx_diag_map_free(zbx_diag_map_t *map)
@@ -200,6 +212,31 @@ void	zbx_diag_add_mem_stats(struct zbx_json *json, const char *name, const zbx_s
 
 	zbx_json_close(json);
 	zbx_json_close(json);
+
+	if (0 != stats->slab_size)
+	{
+		zbx_json_addobject(json, "slabs");
+		zbx_json_adduint64(json, "size", stats->slab_size);
+		zbx_json_adduint64(json, "used", stats->slab_used_size);
+
+		zbx_json_addarray(json, "classes");
+
+		for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+		{
+			if (0 == stats->slab_pages_num[i])
+				continue;
+
+			zbx_json_addobject(json, NULL);
+			zbx_json_adduint64(json, "size", zbx_shmem_slab_class_size(i));
+			zbx_json_adduint64(json, "objects", stats->slab_objects_num[i]);
+			zbx_json_adduint64(json, "pages", stats->slab_pages_num[i]);
+			zbx_json_close(json);
+		}
+
+		zbx_json_close(json);
+		zbx_json_close(json);
+	}
+
 	zbx_json_close(json);
 }
 
@@ -361,6 +398,195 @@ int	zbx_diag_add_historycache_info(const struct zbx_json_parse *jp, struct zbx_j
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add requested configuration cache diagnostic information to json  *
+ *          data                                                              *
+ *                                                                            *
+ * Parameters: jp    - [IN] the request                                       *
+ *             json  - [IN/OUT] the json to update                            *
+ *             error - [OUT] error message                                    *
+ *                                                                            *
+ * Return value: SUCCEED - the information was added successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_diag_add_configcache_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error)
+{
+	zbx_vector_ptr_t	tops;
+	int			ret;
+	double			time1, time2, time_total = 0;
+	zbx_uint64_t		fields;
+	zbx_diag_map_t		field_map[] = {
+					{"", ZBX_DIAG_CONFIGCACHE_SIMPLE | ZBX_DIAG_CONFIGCACHE_MEMORY},
+					{"usermacros", ZBX_DIAG_CONFIGCACHE_USERMACROS},
+					{"objects", ZBX_DIAG_CONFIGCACHE_OBJECTS},
+					{"strings", ZBX_DIAG_CONFIGCACHE_STRINGS},
+					{"memory", ZBX_DIAG_CONFIGCACHE_MEMORY},
+					{NULL, 0}
+					};
+
+	zbx_vector_ptr_create(&tops);
+
+	if (SUCCEED == (ret = zbx_diag_parse_request(jp, field_map, &fields, &tops, error)))
+	{
+		zbx_json_addobject(json, ZBX_DIAG_CONFIGCACHE);
+
+		if (0 != (fields & ZBX_DIAG_CONFIGCACHE_USERMACROS))
+		{
+			zbx_um_cache_stats_t	stats;
+
+			time1 = zbx_time();
+			zbx_dc_get_um_cache_stats(&stats);
+			time2 = zbx_time();
+			time_total += time2 - time1;
+
+			zbx_json_addobject(json, "usermacros");
+			zbx_json_adduint64(json, "hits", stats.hits);
+			zbx_json_adduint64(json, "misses", stats.misses);
+			zbx_json_close(json);
+		}
+
+		if (0 != (fields & (ZBX_DIAG_CONFIGCACHE_OBJECTS | ZBX_DIAG_CONFIGCACHE_STRINGS |
+				ZBX_DIAG_CONFIGCACHE_MEMORY)))
+		{
+			zbx_shmem_stats_t			mem;
+			zbx_vector_dc_object_mem_stats_t	objects;
+			zbx_dc_strpool_stats_t			strpool;
+
+			zbx_vector_dc_object_mem_stats_create(&objects);
+
+			time1 = zbx_time();
+			zbx_dc_get_mem_stats(0 != (fields & ZBX_DIAG_CONFIGCACHE_MEMORY) ? &mem : NULL,
+					0 != (fields & ZBX_DIAG_CONFIGCACHE_OBJECTS) ? &objects : NULL,
+					0 != (fields & ZBX_DIAG_CONFIGCACHE_STRINGS) ? &strpool : NULL);
+			time2 = zbx_time();
+			time_total += time2 - time1;
+
+			if (0 != (fields & ZBX_DIAG_CONFIGCACHE_OBJECTS))
+			{
+				zbx_json_addarray(json, "objects");
+
+				for (int i = 0; i < objects.values_num; i++)
+				{
+					zbx_json_addobject(json, NULL);
+					zbx_json_addstring(json, "type", objects.values[i].name, ZBX_JSON_TYPE_STRING);
+					zbx_json_adduint64(json, "count", objects.values[i].objects_num);
+					zbx_json_adduint64(json, "size", objects.values[i].size);
+					zbx_json_close(json);
+				}
+
+				zbx_json_close(json);
+			}
+
+			if (0 != (fields & ZBX_DIAG_CONFIGCACHE_STRINGS))
+			{
+				zbx_json_addobject(json, "strings");
+				zbx_json_adduint64(json, "count", strpool.strings_num);
+				zbx_json_adduint64(json, "references", strpool.refs_num);
+				zbx_json_adduint64(json, "size", strpool.size);
+				zbx_json_adduint64(json, "shared", strpool.shared_size);
+				zbx_json_close(json);
+			}
+
+			if (0 != (fields & ZBX_DIAG_CONFIGCACHE_MEMORY))
+				zbx_diag_add_mem_stats(json, "memory", &mem);
+
+			zbx_vector_dc_object_mem_stats_destroy(&objects);
+		}
+
+		if (0 != tops.values_num)
+		{
+			*error = zbx_dsprintf(*error, "Unsupported top field: %s",
+					((zbx_diag_map_t *)tops.values[0])->name);
+			ret = FAIL;
+		}
+
+		zbx_json_addfloat(json, "time", time_total);
+
+		zbx_json_close(json);
+	}
+
+	zbx_vector_ptr_clear_ext(&tops, (zbx_ptr_free_func_t)zbx_diag_map_free);
+	zbx_vector_ptr_destroy(&tops);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add requested value ingestion latency diagnostic information to   *
+ *          json data                                                         *
+ *                                                                            *
+ * Parameters: jp    - [IN] the request                                       *
+ *             json  - [IN/OUT] the json to update                            *
+ *             error - [OUT] error message                                    *
+ *                                                                            *
+ * Return value: SUCCEED - the information was added successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_diag_add_latency_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error)
+{
+	zbx_vector_ptr_t	tops;
+	int			ret;
+	double			time1, time2, time_total = 0;
+	zbx_uint64_t		fields;
+	zbx_diag_map_t		field_map[] = {
+					{"", ZBX_DIAG_LATENCY_SIMPLE},
+					{"stages", ZBX_DIAG_LATENCY_STAGES},
+					{NULL, 0}
+					};
+
+	zbx_vector_ptr_create(&tops);
+
+	if (SUCCEED == (ret = zbx_diag_parse_request(jp, field_map, &fields, &tops, error)))
+	{
+		zbx_json_addobject(json, ZBX_DIAG_LATENCY);
+
+		if (0 != (fields & ZBX_DIAG_LATENCY_STAGES))
+		{
+			int	stage;
+
+			for (stage = 0; stage < ZBX_LATENCY_STAGE_COUNT; stage++)
+			{
+				zbx_latency_stats_t	stats;
+
+				time1 = zbx_time();
+				zbx_latency_get_stats(stage, &stats);
+				time2 = zbx_time();
+				time_total += time2 - time1;
+
+				zbx_json_addobject(json, zbx_latency_stage_string(stage));
+				zbx_json_adduint64(json, "count", stats.count);
+				zbx_json_addfloat(json, "avg", stats.avg);
+				zbx_json_addfloat(json, "max", stats.max);
+				zbx_json_addfloat(json, "p50", stats.p50);
+				zbx_json_addfloat(json, "p90", stats.p90);
+				zbx_json_addfloat(json, "p95", stats.p95);
+				zbx_json_addfloat(json, "p99", stats.p99);
+				zbx_json_close(json);
+			}
+		}
+
+		if (0 != tops.values_num)
+		{
+			*error = zbx_dsprintf(*error, "Unsupported top field: %s",
+					((zbx_diag_map_t *)tops.values[0])->name);
+			ret = FAIL;
+		}
+
+		zbx_json_addfloat(json, "time", time_total);
+
+		zbx_json_close(json);
+	}
+
+	zbx_vector_ptr_clear_ext(&tops, (zbx_ptr_free_func_t)zbx_diag_map_free);
+	zbx_vector_ptr_destroy(&tops);
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add top list to output json                                       *
@@ -402,6 +628,85 @@ static void	zbx_json_addhex(struct zbx_json *j, const char *name, zbx_uint64_t v
 	zbx_json_addstring(j, name, buffer, ZBX_JSON_TYPE_STRING);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add lock profiling counters to json data                          *
+ *                                                                            *
+ * Parameters: json     - [IN/OUT] the json to update                         *
+ *             counters - [IN] the lock profiling counters                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_add_lock_counters(struct zbx_json *json, const zbx_lock_counters_t *counters)
+{
+	/* upper bounds of lock profiling histogram buckets */
+	const char	*buckets[ZBX_LOCK_PROF_BUCKETS] = {"1us", "10us", "100us", "1ms", "10ms", "100ms", "1s",
+			"inf"};
+	int		i;
+
+	zbx_json_adduint64(json, "locked", counters->locked);
+	zbx_json_adduint64(json, "contended", counters->contended);
+	zbx_json_addfloat(json, "wait", (double)counters->wait / 1e9);
+	zbx_json_addfloat(json, "wait.max", (double)counters->wait_max / 1e9);
+	zbx_json_addfloat(json, "hold", (double)counters->hold / 1e9);
+	zbx_json_addfloat(json, "hold.max", (double)counters->hold_max / 1e9);
+
+	zbx_json_addobject(json, "wait.histogram");
+	for (i = 0; i < ZBX_LOCK_PROF_BUCKETS; i++)
+		zbx_json_adduint64(json, buckets[i], counters->wait_hist[i]);
+	zbx_json_close(json);
+
+	zbx_json_addobject(json, "hold.histogram");
+	for (i = 0; i < ZBX_LOCK_PROF_BUCKETS; i++)
+		zbx_json_adduint64(json, buckets[i], counters->hold_hist[i]);
+	zbx_json_close(json);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add lock diagnostic information to json data                      *
+ *                                                                            *
+ * Parameters: json  - [IN/OUT] the json to update                            *
+ *             name  - [IN] the lock name                                     *
+ *             addr  - [IN] the lock address                                  *
+ *             stats - [IN] the lock profiling statistics (optional)          *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_add_lock(struct zbx_json *json, const char *name, zbx_uint64_t addr,
+		const zbx_lock_stats_t *stats)
+{
+	int	i;
+
+	zbx_json_addobject(json, NULL);
+	zbx_json_addhex(json, name, addr);
+
+	if (NULL != stats)
+	{
+		diag_add_lock_counters(json, &stats->total);
+
+		zbx_json_addarray(json, "sites");
+
+		for (i = 0; i < stats->sites_num; i++)
+		{
+			char	site[MAX_STRING_LEN];
+
+			/* skip sites being registered during statistics reset */
+			if (NULL == stats->sites[i].filename)
+				continue;
+
+			zbx_snprintf(site, sizeof(site), "%s:%d", stats->sites[i].filename, stats->sites[i].line);
+
+			zbx_json_addobject(json, NULL);
+			zbx_json_addstring(json, "site", site, ZBX_JSON_TYPE_STRING);
+			diag_add_lock_counters(json, &stats->sites[i].counters);
+			zbx_json_close(json);
+		}
+
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: add requested locks diagnostic information to json data           *
@@ -411,40 +716,39 @@ static void	zbx_json_addhex(struct zbx_json *j, const char *name, zbx_uint64_t v
  ******************************************************************************/
 void	zbx_diag_add_locks_info(struct zbx_json *json)
 {
-	int		i;
+	int			i;
+	zbx_lock_stats_t	stats;
 #ifdef HAVE_VMINFO_T_UPDATES
 	const char	*names[ZBX_MUTEX_COUNT] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
 				"ZBX_MUTEX_CACHE_IDS", "ZBX_MUTEX_SELFMON", "ZBX_MUTEX_CPUSTATS", "ZBX_MUTEX_DISKSTATS",
 				"ZBX_MUTEX_VALUECACHE", "ZBX_MUTEX_VMWARE", "ZBX_MUTEX_SQLITE3",
 				"ZBX_MUTEX_PROCSTAT", "ZBX_MUTEX_PROXY_HISTORY", "ZBX_MUTEX_KSTAT", "ZBX_MUTEX_MODBUS",
-				"ZBX_MUTEX_TREND_FUNC", "ZBX_MUTEX_REMOTE_COMMANDS", "ZBX_MUTEX_PROXY_BUFFER"};
+				"ZBX_MUTEX_TREND_FUNC", "ZBX_MUTEX_REMOTE_COMMANDS", "ZBX_MUTEX_PROXY_BUFFER",
+				"ZBX_MUTEX_PROXY_CONFIG", "ZBX_MUTEX_PROBLEM_CACHE"};
 #else
 	const char	*names[ZBX_MUTEX_COUNT] = {"ZBX_MUTEX_LOG", "ZBX_MUTEX_CACHE", "ZBX_MUTEX_TRENDS",
 				"ZBX_MUTEX_CACHE_IDS", "ZBX_MUTEX_SELFMON", "ZBX_MUTEX_CPUSTATS", "ZBX_MUTEX_DISKSTATS",
 				"ZBX_MUTEX_VALUECACHE", "ZBX_MUTEX_VMWARE", "ZBX_MUTEX_SQLITE3",
 				"ZBX_MUTEX_PROCSTAT", "ZBX_MUTEX_PROXY_HISTORY", "ZBX_MUTEX_MODBUS",
-				"ZBX_MUTEX_TREND_FUNC", "ZBX_MUTEX_REMOTE_COMMANDS", "ZBX_MUTEX_PROXY_BUFFER"};
+				"ZBX_MUTEX_TREND_FUNC", "ZBX_MUTEX_REMOTE_COMMANDS", "ZBX_MUTEX_PROXY_BUFFER",
+				"ZBX_MUTEX_PROXY_CONFIG", "ZBX_MUTEX_PROBLEM_CACHE"};
 #endif
+	const char	*rwlock_names[ZBX_RWLOCK_COUNT] = {"ZBX_RWLOCK_CONFIG", "ZBX_RWLOCK_CONFIG_HISTORY",
+				"ZBX_RWLOCK_VALUECACHE"};
+
 	zbx_json_addarray(json, ZBX_DIAG_LOCKS);
 
 	for (i = 0; i < ZBX_MUTEX_COUNT; i++)
 	{
-		zbx_json_addobject(json, NULL);
-		zbx_json_addhex(json, names[i], (zbx_uint64_t)zbx_mutex_addr_get(i));
-		zbx_json_close(json);
+		diag_add_lock(json, names[i], (zbx_uint64_t)zbx_mutex_addr_get(i),
+				SUCCEED == zbx_mutex_prof_get(i, &stats) ? &stats : NULL);
 	}
 
-	zbx_json_addobject(json, NULL);
-	zbx_json_addhex(json, "ZBX_RWLOCK_CONFIG", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_CONFIG));
-	zbx_json_close(json);
-
-	zbx_json_addobject(json, NULL);
-	zbx_json_addhex(json, "ZBX_RWLOCK_CONFIG_HISTORY", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_CONFIG_HISTORY));
-	zbx_json_close(json);
-
-	zbx_json_addobject(json, NULL);
-	zbx_json_addhex(json, "ZBX_RWLOCK_VALUECACHE", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_VALUECACHE));
-	zbx_json_close(json);
+	for (i = 0; i < ZBX_RWLOCK_COUNT; i++)
+	{
+		diag_add_lock(json, rwlock_names[i], (zbx_uint64_t)zbx_rwlock_addr_get(i),
+				SUCCEED == zbx_rwlock_prof_get(i, &stats) ? &stats : NULL);
+	}
 
 	zbx_json_close(json);
 }
@@ -553,6 +857,12 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 	if (0 != (flags & (1 << ZBX_DIAGINFO_PROXYBUFFER)))
 		diag_add_section_request(j, ZBX_DIAG_PROXYBUFFER, NULL);
 
+	if (0 != (flags & (1 << ZBX_DIAGINFO_CONFIGCACHE)))
+		diag_add_section_request(j, ZBX_DIAG_CONFIGCACHE, NULL);
+
+	if (0 != (flags & (1 << ZBX_DIAGINFO_LATENCY)))
+		diag_add_section_request(j, ZBX_DIAG_LATENCY, NULL);
+
 }
 
 /******************************************************************************
@@ -602,7 +912,7 @@ static void	diag_get_simple_values(const struct zbx_json_parse *jp, char **msg)
 static void	diag_log_memory_info(struct zbx_json_parse *jp, const char *field, const char *path, char **out,
 		size_t *out_alloc, size_t *out_offset)
 {
-	struct zbx_json_parse	jp_memory, jp_size, jp_chunks;
+	struct zbx_json_parse	jp_memory, jp_size, jp_chunks, jp_slabs;
 	char			*msg = NULL;
 
 	if (FAIL == zbx_json_open_path(jp, path, &jp_memory))
@@ -642,6 +952,33 @@ static void	diag_log_memory_info(struct zbx_json_parse *jp, const char *field, c
 			}
 		}
 	}
+
+	if (SUCCEED == zbx_json_brackets_by_name(&jp_memory, "slabs", &jp_slabs))
+	{
+		struct zbx_json_parse	jp_classes, jp_class;
+
+		diag_get_simple_values(&jp_slabs, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "  slabs: %s", msg);
+		zbx_free(msg);
+
+		if (SUCCEED == zbx_json_brackets_by_name(&jp_slabs, "classes", &jp_classes))
+		{
+			const char	*pnext;
+
+			zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "    classes:");
+
+			for (pnext = NULL; NULL != (pnext = zbx_json_next(&jp_classes, pnext));)
+			{
+				if (SUCCEED == zbx_json_brackets_open(pnext, &jp_class))
+				{
+					diag_get_simple_values(&jp_class, &msg);
+					zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "      %s",
+							msg);
+					zbx_free(msg);
+				}
+			}
+		}
+	}
 }
 
 /******************************************************************************
@@ -757,7 +1094,8 @@ static void	diag_log_preprocessing(struct zbx_json_parse *jp, char **out, size_t
 
 static void	diag_log_lld(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
 {
-	char	*msg = NULL;
+	char			*msg = NULL;
+	struct zbx_json_parse	jp_phases;
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "== LLD diagnostic information ==");
 
@@ -765,6 +1103,13 @@ static void	diag_log_lld(struct zbx_json_parse *jp, char **out, size_t *out_allo
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s", msg);
 	zbx_free(msg);
 
+	if (SUCCEED == zbx_json_brackets_by_name(jp, "phases", &jp_phases))
+	{
+		diag_get_simple_values(&jp_phases, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "phases: %s", msg);
+		zbx_free(msg);
+	}
+
 	diag_log_top_view(jp, "top.values", "$.top.values", out, out_alloc, out_offset);
 
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
@@ -791,6 +1136,78 @@ static void	diag_log_alerting(struct zbx_json_parse *jp, char **out, size_t *out
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: log lock profiling histograms                                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_log_lock_histograms(struct zbx_json_parse *jp, const char *indent, char **out,
+		size_t *out_alloc, size_t *out_offset)
+{
+	struct zbx_json_parse	jp_hist;
+	char			*msg = NULL;
+
+	if (SUCCEED == zbx_json_brackets_by_name(jp, "wait.histogram", &jp_hist))
+	{
+		diag_get_simple_values(&jp_hist, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%swait.histogram: %s", indent,
+				msg);
+		zbx_free(msg);
+	}
+
+	if (SUCCEED == zbx_json_brackets_by_name(jp, "hold.histogram", &jp_hist))
+	{
+		diag_get_simple_values(&jp_hist, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%shold.histogram: %s", indent,
+				msg);
+		zbx_free(msg);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: log locks diagnostic information                                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_log_locks(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
+{
+	struct zbx_json_parse	jp_lock, jp_sites, jp_site;
+	const char		*pnext, *psite;
+	char			*msg = NULL;
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "== locks diagnostic information ==");
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s:", ZBX_DIAG_LOCKS);
+
+	for (pnext = NULL; NULL != (pnext = zbx_json_next(jp, pnext));)
+	{
+		if (SUCCEED != zbx_json_brackets_open(pnext, &jp_lock))
+			continue;
+
+		diag_get_simple_values(&jp_lock, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "  %s", msg);
+		zbx_free(msg);
+
+		diag_log_lock_histograms(&jp_lock, "    ", out, out_alloc, out_offset);
+
+		if (SUCCEED != zbx_json_brackets_by_name(&jp_lock, "sites", &jp_sites))
+			continue;
+
+		for (psite = NULL; NULL != (psite = zbx_json_next(&jp_sites, psite));)
+		{
+			if (SUCCEED != zbx_json_brackets_open(psite, &jp_site))
+				continue;
+
+			diag_get_simple_values(&jp_site, &msg);
+			zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "    %s", msg);
+			zbx_free(msg);
+
+			diag_log_lock_histograms(&jp_site, "      ", out, out_alloc, out_offset);
+		}
+	}
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: log connector diagnostic information                              *
@@ -830,6 +1247,74 @@ static void	diag_log_proxybuffer(struct zbx_json_parse *jp, char **out, size_t *
 	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: log configuration cache diagnostic information                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_log_configcache(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
+{
+	char			*msg = NULL;
+	struct zbx_json_parse	jp_usermacros, jp_strings;
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset,
+			"== configuration cache diagnostic information ==");
+
+	diag_get_simple_values(jp, &msg);
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s", msg);
+	zbx_free(msg);
+
+	if (SUCCEED == zbx_json_brackets_by_name(jp, "usermacros", &jp_usermacros))
+	{
+		diag_get_simple_values(&jp_usermacros, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "usermacros: %s", msg);
+		zbx_free(msg);
+	}
+
+	if (SUCCEED == zbx_json_brackets_by_name(jp, "strings", &jp_strings))
+	{
+		diag_get_simple_values(&jp_strings, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "strings: %s", msg);
+		zbx_free(msg);
+	}
+
+	diag_log_top_view(jp, "objects", "$.objects", out, out_alloc, out_offset);
+	diag_log_memory_info(jp, "memory", "$.memory", out, out_alloc, out_offset);
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: log value ingestion latency diagnostic information                *
+ *                                                                            *
+ ******************************************************************************/
+static void	diag_log_latency(struct zbx_json_parse *jp, char **out, size_t *out_alloc, size_t *out_offset)
+{
+	char			*msg = NULL, stage[ZBX_DIAG_FIELD_MAX + 1];
+	const char		*pnext = NULL;
+	struct zbx_json_parse	jp_stage;
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset,
+			"== value latency diagnostic information ==");
+
+	diag_get_simple_values(jp, &msg);
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s", msg);
+	zbx_free(msg);
+
+	while (NULL != (pnext = zbx_json_pair_next(jp, pnext, stage, sizeof(stage))))
+	{
+		if (SUCCEED != zbx_json_brackets_open(pnext, &jp_stage))
+			continue;
+
+		diag_get_simple_values(&jp_stage, &msg);
+		zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "%s: %s", stage, msg);
+		zbx_free(msg);
+	}
+
+	zbx_strlog_alloc(LOG_LEVEL_INFORMATION, out, out_alloc, out_offset, "==");
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: log diagnostic information                                        *
@@ -885,17 +1370,15 @@ void	zbx_diag_log_info(unsigned int flags, char **result)
 			else if (0 == strcmp(section, ZBX_DIAG_ALERTING))
 				diag_log_alerting(&jp_section, result, &result_alloc, &result_offset);
 			else if (0 == strcmp(section, ZBX_DIAG_LOCKS))
-			{
-				zbx_strlog_alloc(LOG_LEVEL_INFORMATION, result, &result_alloc, &result_offset,
-						"== locks diagnostic information ==");
-				diag_log_top_view(&jp_section, ZBX_DIAG_LOCKS, NULL, result, &result_alloc,
-						&result_offset);
-				zbx_strlog_alloc(LOG_LEVEL_INFORMATION, result, &result_alloc, &result_offset, "==");
-			}
+				diag_log_locks(&jp_section, result, &result_alloc, &result_offset);
 			else if (0 == strcmp(section, ZBX_DIAG_CONNECTOR))
 				diag_log_connector(&jp_section, result, &result_alloc, &result_offset);
 			else if (0 == strcmp(section, ZBX_DIAG_PROXYBUFFER))
 				diag_log_proxybuffer(&jp_section, result, &result_alloc, &result_offset);
+			else if (0 == strcmp(section, ZBX_DIAG_CONFIGCACHE))
+				diag_log_configcache(&jp_section, result, &result_alloc, &result_offset);
+			else if (0 == strcmp(section, ZBX_DIAG_LATENCY))
+				diag_log_latency(&jp_section, result, &result_alloc, &result_offset);
 		}
 	}
 	else
@@ -0,0 +1,357 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "eval.h"
+
+#include "zbxnum.h"
+
+ZBX_VECTOR_IMPL(eval_instr, zbx_eval_instr_t)
+
+/* value stack entry used during compilation to track instructions producing the value */
+typedef struct
+{
+	int	from;	/* the first token */
+	int	instr;	/* the first instruction */
+}
+zbx_eval_compile_entry_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: converts numeric variant value to double                          *
+ *                                                                            *
+ ******************************************************************************/
+static double	eval_variant_dbl(const zbx_variant_t *value)
+{
+	return ZBX_VARIANT_DBL == value->type ? value->data.dbl : (double)value->data.ui64;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates unary operator with numeric operand                     *
+ *                                                                            *
+ * Parameters: type   - [IN] operator token type                              *
+ *             right  - [IN] operand (floating point or unsigned integer)     *
+ *             result - [OUT] operator result, can be the same as operand     *
+ *                                                                            *
+ * Return value: SUCCEED - operator was evaluated successfully                *
+ *               FAIL    - operator must be evaluated by the interpreter to   *
+ *                         produce error message                              *
+ *                                                                            *
+ * Comments: The result must match the interpreter result for the same        *
+ *           operands (see eval_execute_op_unary()).                          *
+ *                                                                            *
+ ******************************************************************************/
+int	eval_compiled_op_unary(zbx_token_type_t type, const zbx_variant_t *right, zbx_variant_t *result)
+{
+	double	value;
+
+	switch (type)
+	{
+		case ZBX_EVAL_TOKEN_OP_MINUS:
+			value = -eval_variant_dbl(right);
+			break;
+		case ZBX_EVAL_TOKEN_OP_NOT:
+			value = (SUCCEED == zbx_double_compare(eval_variant_dbl(right), 0) ? 1 : 0);
+			break;
+		default:
+			return FAIL;
+	}
+
+	if (FP_ZERO != fpclassify(value) && FP_NORMAL != fpclassify(value))
+		return FAIL;
+
+	zbx_variant_set_dbl(result, value);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates binary operator with numeric operands                   *
+ *                                                                            *
+ * Parameters: type   - [IN] operator token type                              *
+ *             left   - [IN] left operand (floating point or unsigned         *
+ *                           integer)                                         *
+ *             right  - [IN] right operand                                    *
+ *             result - [OUT] operator result, can be the same as left        *
+ *                            operand                                         *
+ *                                                                            *
+ * Return value: SUCCEED - operator was evaluated successfully                *
+ *               FAIL    - operator must be evaluated by the interpreter to   *
+ *                         produce error message                              *
+ *                                                                            *
+ * Comments: The result must match the interpreter result for the same        *
+ *           operands (see eval_execute_op_binary()).                         *
+ *                                                                            *
+ ******************************************************************************/
+int	eval_compiled_op_binary(zbx_token_type_t type, const zbx_variant_t *left, const zbx_variant_t *right,
+		zbx_variant_t *result)
+{
+	zbx_variant_t	dbl_l, dbl_r;
+	double		value;
+
+	/* equality of unsigned integers is checked without conversion to floating point values */
+	switch (type)
+	{
+		case ZBX_EVAL_TOKEN_OP_EQ:
+			value = (0 == zbx_variant_compare(left, right) ? 1 : 0);
+			goto out;
+		case ZBX_EVAL_TOKEN_OP_NE:
+			value = (0 == zbx_variant_compare(left, right) ? 0 : 1);
+			goto out;
+	}
+
+	zbx_variant_set_dbl(&dbl_l, eval_variant_dbl(left));
+	zbx_variant_set_dbl(&dbl_r, eval_variant_dbl(right));
+
+	switch (type)
+	{
+		case ZBX_EVAL_TOKEN_OP_AND:
+			if (SUCCEED == zbx_double_compare(dbl_l.data.dbl, 0) ||
+					SUCCEED == zbx_double_compare(dbl_r.data.dbl, 0))
+			{
+				value = 0;
+			}
+			else
+				value = 1;
+			goto out;
+		case ZBX_EVAL_TOKEN_OP_OR:
+			if (SUCCEED != zbx_double_compare(dbl_l.data.dbl, 0) ||
+					SUCCEED != zbx_double_compare(dbl_r.data.dbl, 0))
+			{
+				value = 1;
+			}
+			else
+				value = 0;
+			goto out;
+		case ZBX_EVAL_TOKEN_OP_LT:
+			value = (0 > zbx_variant_compare(&dbl_l, &dbl_r) ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_LE:
+			value = (0 >= zbx_variant_compare(&dbl_l, &dbl_r) ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_GT:
+			value = (0 < zbx_variant_compare(&dbl_l, &dbl_r) ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_GE:
+			value = (0 <= zbx_variant_compare(&dbl_l, &dbl_r) ? 1 : 0);
+			break;
+		case ZBX_EVAL_TOKEN_OP_ADD:
+			value = dbl_l.data.dbl + dbl_r.data.dbl;
+			break;
+		case ZBX_EVAL_TOKEN_OP_SUB:
+			value = dbl_l.data.dbl - dbl_r.data.dbl;
+			break;
+		case ZBX_EVAL_TOKEN_OP_MUL:
+			value = dbl_l.data.dbl * dbl_r.data.dbl;
+			break;
+		case ZBX_EVAL_TOKEN_OP_DIV:
+			if (SUCCEED == zbx_double_compare(dbl_r.data.dbl, 0))
+				return FAIL;
+			value = dbl_l.data.dbl / dbl_r.data.dbl;
+			break;
+		default:
+			return FAIL;
+	}
+
+	if (FP_ZERO != fpclassify(value) && FP_NORMAL != fpclassify(value))
+		return FAIL;
+out:
+	zbx_variant_set_dbl(result, value);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: appends instruction to compiled expression                        *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_eval_instr_t	*eval_compile_add(zbx_eval_context_t *ctx, unsigned char op, int from, int index)
+{
+	zbx_eval_instr_t	instr = {.op = op, .from = (zbx_uint32_t)from, .index = (zbx_uint32_t)index};
+
+	zbx_variant_set_none(&instr.value);
+	zbx_vector_eval_instr_append_ptr(&ctx->program, &instr);
+
+	return &ctx->program.values[ctx->program.values_num - 1];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns constant instruction if the value stack entry consists    *
+ *          only of it                                                        *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_eval_instr_t	*eval_compile_get_const(zbx_eval_context_t *ctx, const zbx_eval_compile_entry_t *entry)
+{
+	zbx_eval_instr_t	*instr;
+
+	if (entry->instr != ctx->program.values_num - 1)
+		return NULL;
+
+	instr = &ctx->program.values[entry->instr];
+
+	return ZBX_EVAL_INSTR_CONST == instr->op ? instr : NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles parsed expression into numeric instruction stream        *
+ *                                                                            *
+ * Parameters: ctx - [IN/OUT] evaluation context                              *
+ *                                                                            *
+ * Comments: The compiled program works with a small fixed value stack of     *
+ *           floating point and unsigned integer values without allocations:  *
+ *             - numeric constants are converted and constant operations are  *
+ *               folded during compilation,                                   *
+ *             - operand tokens (function results, macros) are loaded from    *
+ *               token values set before execution,                           *
+ *             - functions are executed by the interpreter together with      *
+ *               their arguments.                                             *
+ *           When a value is not numeric or an operator fails the execution   *
+ *           continues with the interpreter from the same token, so string    *
+ *           and error semantics and messages are not affected.               *
+ *           The program is kept in the context and (de)serialized together   *
+ *           with it. When the expression cannot be compiled the program is   *
+ *           left empty and the expression is interpreted.                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_eval_compile(zbx_eval_context_t *ctx)
+{
+	zbx_eval_compile_entry_t	stack[ZBX_EVAL_PROGRAM_STACK_SIZE], *left, *right;
+	zbx_eval_instr_t		*instr, *instr_l;
+	int				i, depth = 0;
+
+	if (NULL == ctx->program.values)
+		zbx_vector_eval_instr_create(&ctx->program);
+	else
+		ctx->program.values_num = 0;
+
+	for (i = 0; i < ctx->stack.values_num; i++)
+	{
+		const zbx_eval_token_t	*token = &ctx->stack.values[i];
+
+		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
+		{
+			if (1 > depth)
+				goto fail;
+
+			right = &stack[depth - 1];
+
+			if (NULL == (instr = eval_compile_get_const(ctx, right)) ||
+					SUCCEED != eval_compiled_op_unary(token->type, &instr->value, &instr->value))
+			{
+				eval_compile_add(ctx, ZBX_EVAL_INSTR_OP, i, i);
+			}
+			else
+				instr->index = (zbx_uint32_t)i;
+
+			continue;
+		}
+
+		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR2))
+		{
+			if (2 > depth)
+				goto fail;
+
+			left = &stack[depth - 2];
+			right = &stack[depth - 1];
+
+			if (NULL != (instr = eval_compile_get_const(ctx, right)) && left->instr == right->instr - 1 &&
+					ZBX_EVAL_INSTR_CONST == (instr_l = &ctx->program.values[left->instr])->op &&
+					SUCCEED == eval_compiled_op_binary(token->type, &instr_l->value, &instr->value,
+					&instr_l->value))
+			{
+				instr_l->index = (zbx_uint32_t)i;
+				ctx->program.values_num--;
+			}
+			else
+				eval_compile_add(ctx, ZBX_EVAL_INSTR_OP, i, i);
+
+			depth--;
+			continue;
+		}
+
+		switch (token->type)
+		{
+			case ZBX_EVAL_TOKEN_NOP:
+				continue;
+			case ZBX_EVAL_TOKEN_VAR_NUM:
+				if (ZBX_VARIANT_NONE == token->value.type)
+				{
+					instr = eval_compile_add(ctx, ZBX_EVAL_INSTR_CONST, i, i);
+					eval_convert_var_num(ctx, token, &instr->value);
+					break;
+				}
+				ZBX_FALLTHROUGH;
+			case ZBX_EVAL_TOKEN_VAR_STR:
+			case ZBX_EVAL_TOKEN_VAR_MACRO:
+			case ZBX_EVAL_TOKEN_VAR_USERMACRO:
+			case ZBX_EVAL_TOKEN_FUNCTIONID:
+			case ZBX_EVAL_TOKEN_ARG_QUERY:
+			case ZBX_EVAL_TOKEN_ARG_PERIOD:
+			case ZBX_EVAL_TOKEN_ARG_NULL:
+				eval_compile_add(ctx, ZBX_EVAL_INSTR_LOAD, i, i);
+				break;
+			case ZBX_EVAL_TOKEN_FUNCTION:
+			case ZBX_EVAL_TOKEN_HIST_FUNCTION:
+				if ((zbx_uint32_t)depth < token->opt)
+					goto fail;
+
+				/* replace argument instructions with function call */
+				if (0 != token->opt)
+				{
+					depth -= (int)token->opt;
+					ctx->program.values_num = stack[depth].instr;
+					eval_compile_add(ctx, ZBX_EVAL_INSTR_CALL, stack[depth].from, i);
+					depth++;
+					continue;
+				}
+
+				eval_compile_add(ctx, ZBX_EVAL_INSTR_CALL, i, i);
+				break;
+			default:
+				goto fail;
+		}
+
+		if (ZBX_EVAL_PROGRAM_STACK_SIZE == depth)
+			goto fail;
+
+		stack[depth].from = i;
+		stack[depth].instr = ctx->program.values_num - 1;
+		depth++;
+	}
+
+	if (1 != depth)
+		goto fail;
+
+	/* string constants outside function arguments would always fall back to interpreter */
+	for (i = 0; i < ctx->program.values_num; i++)
+	{
+		instr = &ctx->program.values[i];
+
+		if (ZBX_EVAL_INSTR_LOAD == instr->op && ZBX_EVAL_TOKEN_VAR_STR == ctx->stack.values[instr->index].type)
+			goto fail;
+	}
+
+	return;
+fail:
+	ctx->program.values_num = 0;
+}
@@ -27,4 +27,18 @@ int	eval_compare_token(const zbx_eval_context_t *ctx, const zbx_strloc_t *loc, c
 		size_t len);
 size_t	eval_parse_query(const char *str, const char **phost, const char **pkey, const char **pfilter);
 
+/* compiled expression instructions */
+#define ZBX_EVAL_INSTR_CONST	0	/* push numeric constant */
+#define ZBX_EVAL_INSTR_LOAD	1	/* push numeric value of the operand token */
+#define ZBX_EVAL_INSTR_CALL	2	/* push numeric result of function with its arguments interpreted */
+#define ZBX_EVAL_INSTR_OP	3	/* apply operator to the numeric values on stack */
+
+/* maximum value stack depth of compiled expressions */
+#define ZBX_EVAL_PROGRAM_STACK_SIZE	32
+
+void	eval_convert_var_num(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token, zbx_variant_t *value);
+int	eval_compiled_op_unary(zbx_token_type_t type, const zbx_variant_t *right, zbx_variant_t *result);
+int	eval_compiled_op_binary(zbx_token_type_t type, const zbx_variant_t *left, const zbx_variant_t *right,
+		zbx_variant_t *result);
+
 #endif
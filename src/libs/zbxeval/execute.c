@@ -436,6 +436,30 @@ int	 eval_suffixed_number_parse(const char *value, char *suffix)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: converts numeric constant token to variant value                  *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             token - [IN] numeric constant token                            *
+ *             value - [OUT] unsigned integer or floating point value         *
+ *                                                                            *
+ ******************************************************************************/
+void	eval_convert_var_num(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token, zbx_variant_t *value)
+{
+	zbx_uint64_t	ui64;
+
+	if (SUCCEED == zbx_is_uint64_n(ctx->expression + token->loc.l, token->loc.r - token->loc.l + 1, &ui64))
+	{
+		zbx_variant_set_ui64(value, ui64);
+	}
+	else
+	{
+		zbx_variant_set_dbl(value, atof(ctx->expression + token->loc.l) *
+				suffix2factor(ctx->expression[token->loc.r]));
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: pushes value in output stack                                      *
@@ -459,20 +483,7 @@ static int	eval_execute_push_value(const zbx_eval_context_t *ctx, const zbx_eval
 	if (ZBX_VARIANT_NONE == token->value.type)
 	{
 		if (ZBX_EVAL_TOKEN_VAR_NUM == token->type)
-		{
-			zbx_uint64_t	ui64;
-
-			if (SUCCEED == zbx_is_uint64_n(ctx->expression + token->loc.l, token->loc.r - token->loc.l + 1,
-					&ui64))
-			{
-				zbx_variant_set_ui64(&value, ui64);
-			}
-			else
-			{
-				zbx_variant_set_dbl(&value, atof(ctx->expression + token->loc.l) *
-						suffix2factor(ctx->expression[token->loc.r]));
-			}
-		}
+			eval_convert_var_num(ctx, token, &value);
 		else
 		{
 			dst = zbx_malloc(NULL, token->loc.r - token->loc.l + 2);
@@ -3198,37 +3209,36 @@ static void	eval_throw_exception(zbx_vector_var_t *output, char **error)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: evaluates pre-parsed expression                                   *
+ * Purpose: interprets range of pre-parsed expression tokens                  *
  *                                                                            *
- * Parameters: ctx   - [IN] evaluation context                                *
- *             value - [OUT] resulting value                                  *
- *             error - [OUT] error message in case of failure                 *
+ * Parameters: ctx    - [IN] evaluation context                               *
+ *             from   - [IN] the first token to interpret                     *
+ *             to     - [IN] the token after the last token to interpret      *
+ *             output - [IN/OUT] output value stack                           *
+ *             error  - [OUT] error message in case of failure                *
  *                                                                            *
- * Return value: SUCCEED - expression was evaluated successfully              *
+ * Return value: SUCCEED - tokens were interpreted successfully               *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, char **error)
+static int	eval_execute_tokens(const zbx_eval_context_t *ctx, int from, int to, zbx_vector_var_t *output,
+		char **error)
 {
-	zbx_vector_var_t	output;
-	int			i, ret = FAIL;
-	char			*errmsg = NULL;
-
-	zbx_vector_var_create(&output);
+	int	i;
 
-	for (i = 0; i < ctx->stack.values_num; i++)
+	for (i = from; i < to; i++)
 	{
 		zbx_eval_token_t	*token = &ctx->stack.values[i];
 
 		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
 		{
-			if (SUCCEED != eval_execute_op_unary(ctx, token, &output, &errmsg))
-				goto out;
+			if (SUCCEED != eval_execute_op_unary(ctx, token, output, error))
+				return FAIL;
 		}
 		else if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR2))
 		{
-			if (SUCCEED != eval_execute_op_binary(ctx, token, &output, &errmsg))
-				goto out;
+			if (SUCCEED != eval_execute_op_binary(ctx, token, output, error))
+				return FAIL;
 		}
 		else
 		{
@@ -3240,46 +3250,207 @@ static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, cha
 				case ZBX_EVAL_TOKEN_VAR_STR:
 				case ZBX_EVAL_TOKEN_VAR_MACRO:
 				case ZBX_EVAL_TOKEN_VAR_USERMACRO:
-					if (SUCCEED != eval_execute_push_value(ctx, token, &output, &errmsg))
-						goto out;
+					if (SUCCEED != eval_execute_push_value(ctx, token, output, error))
+						return FAIL;
 					break;
 				case ZBX_EVAL_TOKEN_ARG_QUERY:
 				case ZBX_EVAL_TOKEN_ARG_PERIOD:
-					if (SUCCEED != eval_execute_push_value(ctx, token, &output, &errmsg))
-						goto out;
+					if (SUCCEED != eval_execute_push_value(ctx, token, output, error))
+						return FAIL;
 					break;
 				case ZBX_EVAL_TOKEN_ARG_NULL:
-					eval_execute_push_null(&output);
+					eval_execute_push_null(output);
 					break;
 				case ZBX_EVAL_TOKEN_FUNCTION:
-					if (SUCCEED != eval_execute_common_function(ctx, token, &output, &errmsg))
-						goto out;
+					if (SUCCEED != eval_execute_common_function(ctx, token, output, error))
+						return FAIL;
 					break;
 				case ZBX_EVAL_TOKEN_HIST_FUNCTION:
-					if (SUCCEED != eval_execute_history_function(ctx, token, &output, &errmsg))
-						goto out;
+					if (SUCCEED != eval_execute_history_function(ctx, token, output, error))
+						return FAIL;
 					break;
 				case ZBX_EVAL_TOKEN_FUNCTIONID:
 					if (ZBX_VARIANT_NONE == token->value.type)
 					{
-						errmsg = zbx_strdup(errmsg, "trigger history functions must be"
+						*error = zbx_strdup(*error, "trigger history functions must be"
 								" pre-calculated");
-						goto out;
+						return FAIL;
 					}
-					if (SUCCEED != eval_execute_push_value(ctx, token, &output, &errmsg))
-						goto out;
+					if (SUCCEED != eval_execute_push_value(ctx, token, output, error))
+						return FAIL;
 					break;
 				case ZBX_EVAL_TOKEN_EXCEPTION:
-					eval_throw_exception(&output, &errmsg);
-					goto out;
+					eval_throw_exception(output, error);
+					return FAIL;
 				default:
-					errmsg = zbx_dsprintf(errmsg, "unknown token at \"%s\"",
+					*error = zbx_dsprintf(*error, "unknown token at \"%s\"",
 							ctx->expression + token->loc.l);
-					goto out;
+					return FAIL;
 			}
 		}
 	}
 
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets numeric value of operand token                               *
+ *                                                                            *
+ * Parameters: token - [IN] operand token                                     *
+ *             value - [OUT] unsigned integer or floating point value         *
+ *                                                                            *
+ * Return value: SUCCEED - numeric value was returned                         *
+ *               FAIL    - the operand must be pushed by interpreter          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute_load_value(const zbx_eval_token_t *token, zbx_variant_t *value)
+{
+	switch (token->value.type)
+	{
+		case ZBX_VARIANT_UI64:
+		case ZBX_VARIANT_DBL:
+			*value = token->value;
+			return SUCCEED;
+		case ZBX_VARIANT_STR:
+			if (ZBX_EVAL_TOKEN_VAR_USERMACRO == token->type)
+				return variant_convert_suffixed_num(value, &token->value);
+			return FAIL;
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes compiled expression                                      *
+ *                                                                            *
+ * Parameters: ctx    - [IN] evaluation context                               *
+ *             output - [IN/OUT] output value stack                           *
+ *             value  - [OUT] resulting value when the whole program was      *
+ *                            executed numerically                            *
+ *             error  - [OUT] error message in case of failure                *
+ *                                                                            *
+ * Return value: SUCCEED - expression was executed successfully, the result   *
+ *                         is returned either in value or output stack        *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Numeric values are kept in fixed value stack. When value is not  *
+ *           numeric or operator cannot be evaluated the value stack is moved *
+ *           to output stack and the execution continues with interpreter.    *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute_program(const zbx_eval_context_t *ctx, zbx_vector_var_t *output, zbx_variant_t *value,
+		char **error)
+{
+	zbx_variant_t	values[ZBX_EVAL_PROGRAM_STACK_SIZE], result;
+	int		i, values_num = 0, pos;
+
+	for (i = 0; i < ctx->program.values_num; i++)
+	{
+		const zbx_eval_instr_t	*instr = &ctx->program.values[i];
+		const zbx_eval_token_t	*token = &ctx->stack.values[instr->index];
+
+		switch (instr->op)
+		{
+			case ZBX_EVAL_INSTR_CONST:
+				values[values_num++] = instr->value;
+				continue;
+			case ZBX_EVAL_INSTR_LOAD:
+				if (SUCCEED != eval_execute_load_value(token, &values[values_num]))
+				{
+					pos = (int)instr->index;
+					goto fallback;
+				}
+				values_num++;
+				continue;
+			case ZBX_EVAL_INSTR_CALL:
+				if (SUCCEED != eval_execute_tokens(ctx, (int)instr->from, (int)instr->index + 1, output,
+						error))
+				{
+					return FAIL;
+				}
+
+				result = output->values[--output->values_num];
+
+				if (ZBX_VARIANT_UI64 != result.type && ZBX_VARIANT_DBL != result.type)
+				{
+					zbx_vector_var_append_array(output, values, values_num);
+					zbx_vector_var_append_ptr(output, &result);
+
+					return eval_execute_tokens(ctx, (int)instr->index + 1, ctx->stack.values_num,
+							output, error);
+				}
+
+				values[values_num++] = result;
+				continue;
+			case ZBX_EVAL_INSTR_OP:
+				if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
+				{
+					if (SUCCEED == eval_compiled_op_unary(token->type, &values[values_num - 1],
+							&values[values_num - 1]))
+					{
+						continue;
+					}
+				}
+				else if (SUCCEED == eval_compiled_op_binary(token->type, &values[values_num - 2],
+						&values[values_num - 1], &values[values_num - 2]))
+				{
+					values_num--;
+					continue;
+				}
+
+				pos = (int)instr->index;
+				goto fallback;
+		}
+	}
+
+	*value = values[0];
+
+	return SUCCEED;
+fallback:
+	zbx_vector_var_append_array(output, values, values_num);
+
+	return eval_execute_tokens(ctx, pos, ctx->stack.values_num, output, error);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates pre-parsed expression                                   *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             value - [OUT] resulting value                                  *
+ *             error - [OUT] error message in case of failure                 *
+ *                                                                            *
+ * Return value: SUCCEED - expression was evaluated successfully              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, char **error)
+{
+	zbx_vector_var_t	output;
+	int			i, ret = FAIL;
+	char			*errmsg = NULL;
+
+	zbx_vector_var_create(&output);
+
+	if (0 != ctx->program.values_num)
+	{
+		zbx_variant_set_none(value);
+
+		if (SUCCEED != eval_execute_program(ctx, &output, value, &errmsg))
+			goto out;
+
+		/* numeric result without falling back to interpreter */
+		if (ZBX_VARIANT_NONE != value->type)
+		{
+			ret = SUCCEED;
+			goto out;
+		}
+	}
+	else if (SUCCEED != eval_execute_tokens(ctx, 0, ctx->stack.values_num, &output, &errmsg))
+		goto out;
+
 	if (1 != output.values_num)
 	{
 		errmsg = zbx_strdup(errmsg, "output stack after expression execution must contain one value");
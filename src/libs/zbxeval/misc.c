@@ -186,6 +186,24 @@ size_t	zbx_eval_serialize(const zbx_eval_context_t *ctx, zbx_mem_malloc_func_t m
 		serialize_variant(&buffer, &buffer_size, &token->value, &ptr);
 	}
 
+	reserve_buffer(&buffer, &buffer_size, 6, &ptr);
+	ptr += zbx_serialize_uint31_compact(ptr, ctx->program.values_num);
+
+	for (i = 0; i < ctx->program.values_num; i++)
+	{
+		const zbx_eval_instr_t	*instr = &ctx->program.values[i];
+
+		/* reserve space for 1 byte instruction and 6 bytes per compact uint31 (1+2*6) */
+		reserve_buffer(&buffer, &buffer_size, 13, &ptr);
+
+		*ptr++ = instr->op;
+		ptr += zbx_serialize_uint31_compact(ptr, instr->from);
+		ptr += zbx_serialize_uint31_compact(ptr, instr->index);
+
+		if (ZBX_EVAL_INSTR_CONST == instr->op)
+			serialize_variant(&buffer, &buffer_size, &instr->value, &ptr);
+	}
+
 	len = ptr - buffer;
 
 	len_offset = zbx_serialize_uint31_compact(len_buff, len);
@@ -214,13 +232,15 @@ size_t	zbx_eval_serialize(const zbx_eval_context_t *ctx, zbx_mem_malloc_func_t m
 void	zbx_eval_deserialize(zbx_eval_context_t *ctx, const char *expression, zbx_uint64_t rules,
 		const unsigned char *data)
 {
-	zbx_uint32_t	i, tokens_num, len, pos;
+	zbx_uint32_t		i, tokens_num, len, pos, instr_num;
+	const unsigned char	*end;
 
 	memset(ctx, 0, sizeof(zbx_eval_context_t));
 	ctx->expression = expression;
 	ctx->rules = rules;
 
 	data += zbx_deserialize_uint31_compact(data, &len);
+	end = data + len;
 	data += zbx_deserialize_uint31_compact(data, &tokens_num);
 	zbx_vector_eval_token_create(&ctx->stack);
 	zbx_vector_eval_token_reserve(&ctx->stack, tokens_num);
@@ -240,6 +260,29 @@ void	zbx_eval_deserialize(zbx_eval_context_t *ctx, const char *expression, zbx_u
 
 		data += deserialize_variant(data, &token->value);
 	}
+
+	zbx_vector_eval_instr_create(&ctx->program);
+
+	if (data == end)
+		return;
+
+	data += zbx_deserialize_uint31_compact(data, &instr_num);
+	zbx_vector_eval_instr_reserve(&ctx->program, instr_num);
+	ctx->program.values_num = instr_num;
+
+	for (i = 0; i < instr_num; i++)
+	{
+		zbx_eval_instr_t	*instr = &ctx->program.values[i];
+
+		instr->op = *data++;
+		data += zbx_deserialize_uint31_compact(data, &instr->from);
+		data += zbx_deserialize_uint31_compact(data, &instr->index);
+
+		if (ZBX_EVAL_INSTR_CONST == instr->op)
+			data += deserialize_variant(data, &instr->value);
+		else
+			zbx_variant_set_none(&instr->value);
+	}
 }
 
 static int	compare_tokens_by_loc(const void *d1, const void *d2)
@@ -1038,6 +1081,12 @@ void	zbx_eval_copy(zbx_eval_context_t *dst, const zbx_eval_context_t *src, const
 		if (ZBX_VARIANT_NONE != src->stack.values[i].value.type)
 			zbx_variant_copy(&dst->stack.values[i].value, &src->stack.values[i].value);
 	}
+
+	/* compiled program holds only numeric values and can be copied directly */
+	zbx_vector_eval_instr_create(&dst->program);
+
+	if (0 != src->program.values_num)
+		zbx_vector_eval_instr_append_array(&dst->program, src->program.values, src->program.values_num);
 }
 
 /******************************************************************************
@@ -1191,6 +1191,9 @@ static void	eval_clear(zbx_eval_context_t *ctx)
 
 		zbx_vector_eval_token_destroy(&ctx->stack);
 	}
+
+	if (NULL != ctx->program.values)
+		zbx_vector_eval_instr_destroy(&ctx->program);
 }
 
 /******************************************************************************
@@ -1221,6 +1224,7 @@ static int	eval_parse_expression(zbx_eval_context_t *ctx, const char *expression
 	zbx_vector_eval_token_reserve(&ctx->stack, 16);
 	zbx_vector_eval_token_create(&ctx->ops);
 	zbx_vector_eval_token_reserve(&ctx->ops, 16);
+	zbx_vector_eval_instr_create(&ctx->program);
 
 	while ('\0' != expression[pos])
 	{
@@ -483,3 +483,117 @@ out:
 
 	return ret;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets group and tag comparisons required to match item filter      *
+ *                                                                            *
+ * Parameters: ctx    - [IN] prepared filter expression evaluation context    *
+ *             groups - [OUT] group values every matching item host must      *
+ *                            belong to                                       *
+ *             tags   - [OUT] tag values every matching item must have        *
+ *                                                                            *
+ * Comments: Only positive group/tag comparisons joined with 'and' operators  *
+ *           at the top level of filter are returned, so they can be used to  *
+ *           narrow down item candidates before evaluating the whole filter.  *
+ *           The filter expression token stack is 'evaluated' by tracking the *
+ *           number of required comparisons carried by each operand:          *
+ *             * group/tag comparison carries itself                          *
+ *             * <expression> and <expression> carries the comparisons of     *
+ *               both operands                                                *
+ *             * results of other operations carry no comparisons             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_eval_get_required_properties(const zbx_eval_context_t *ctx, zbx_vector_str_t *groups,
+		zbx_vector_str_t *tags)
+{
+	zbx_vector_uint64_pair_t	output;		/* pseudo output stack, containing pairs of operand token */
+							/* index and number of required comparisons it carries    */
+	zbx_vector_uint64_pair_t	required;	/* pairs of property and value token indexes of required */
+							/* comparisons                                            */
+	zbx_uint64_pair_t		operand;
+	int				i, j;
+
+	zbx_vector_uint64_pair_create(&output);
+	zbx_vector_uint64_pair_create(&required);
+
+	for (i = 0; i < ctx->stack.values_num; i++)
+	{
+		const zbx_eval_token_t	*token = &ctx->stack.values[i];
+
+		if (ZBX_EVAL_TOKEN_NOP == token->type)
+			continue;
+
+		operand.first = (zbx_uint64_t)i;
+		operand.second = 0;
+
+		if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR2))
+		{
+			zbx_uint64_t	carried;
+
+			if (2 > output.values_num)
+				goto out;
+
+			output.values_num -= 2;
+			carried = output.values[output.values_num].second + output.values[output.values_num + 1].second;
+
+			if (ZBX_EVAL_TOKEN_OP_AND == token->type)
+				operand.second = carried;
+			else
+				required.values_num -= (int)carried;
+		}
+		else if (0 != (token->type & ZBX_EVAL_CLASS_OPERATOR1))
+		{
+			if (1 > output.values_num)
+				goto out;
+
+			required.values_num -= (int)output.values[--output.values_num].second;
+		}
+		else if (ZBX_EVAL_TOKEN_FUNCTION == token->type)
+		{
+			if ((int)token->opt > output.values_num)
+				goto out;
+
+			for (j = 0; j < (int)token->opt; j++)
+				required.values_num -= (int)output.values[output.values_num - j - 1].second;
+
+			output.values_num -= (int)token->opt;
+
+			if (1 == token->opt && ZBX_EVAL_TOKEN_VAR_STR ==
+					ctx->stack.values[output.values[output.values_num].first].type)
+			{
+				zbx_uint64_pair_t	comparison;
+
+				comparison.first = (zbx_uint64_t)i;
+				comparison.second = output.values[output.values_num].first;
+				zbx_vector_uint64_pair_append(&required, comparison);
+				operand.second = 1;
+			}
+		}
+
+		zbx_vector_uint64_pair_append(&output, operand);
+	}
+
+	if (1 != output.values_num)
+		goto out;
+
+	for (i = 0; i < required.values_num; i++)
+	{
+		const zbx_eval_token_t	*prop = &ctx->stack.values[required.values[i].first];
+		size_t			len = prop->loc.r - prop->loc.l + 1;
+		zbx_vector_str_t	*values;
+
+		if (ZBX_CONST_STRLEN("group") == len && 0 == memcmp(ctx->expression + prop->loc.l, "group", len))
+			values = groups;
+		else if (ZBX_CONST_STRLEN("tag") == len && 0 == memcmp(ctx->expression + prop->loc.l, "tag", len))
+			values = tags;
+		else
+			continue;
+
+		prop = &ctx->stack.values[required.values[i].second];
+		zbx_vector_str_append(values, eval_unquote_str(zbx_substr(ctx->expression, prop->loc.l, prop->loc.r)));
+	}
+out:
+	zbx_vector_uint64_pair_destroy(&required);
+	zbx_vector_uint64_pair_destroy(&output);
+}
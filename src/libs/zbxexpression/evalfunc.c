@@ -3428,6 +3428,77 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get history period requested from value cache by function         *
+ *                                                                            *
+ * Parameters: function  - [IN] function (for example, 'max')                 *
+ *             parameter - [IN] parameter of function                         *
+ *             ts        - [IN] starting timestamp                            *
+ *             seconds   - [OUT] the time period                              *
+ *             count     - [OUT] the number of values                         *
+ *             ts_end    - [OUT] the period end timestamp                     *
+ *                                                                            *
+ * Return value: SUCCEED - the function reads the specified history period    *
+ *               FAIL - the function reads other or unknown history data      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_get_function_history_range(const char *function, const char *parameter, const zbx_timespec_t *ts,
+		int *seconds, int *count, zbx_timespec_t *ts_end)
+{
+	int			arg1 = 1, time_shift;
+	zbx_value_type_t	arg1_type = ZBX_VALUE_NVALUES;
+
+	*ts_end = *ts;
+	*seconds = 0;
+	*count = 0;
+
+	if (0 == strcmp(function, "change"))
+	{
+		*count = 2;
+		return SUCCEED;
+	}
+
+	if (0 != strcmp(function, "last") && 0 != strcmp(function, "min") && 0 != strcmp(function, "max") &&
+			0 != strcmp(function, "avg") && 0 != strcmp(function, "sum") &&
+			0 != strcmp(function, "percentile") && 0 != strcmp(function, "count") &&
+			0 != strcmp(function, "countunique") && 0 != strcmp(function, "find"))
+	{
+		return FAIL;
+	}
+
+	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameter, 1, &arg1, &arg1_type, &time_shift))
+		return FAIL;
+
+	ts_end->sec -= time_shift;
+
+	if (0 == strcmp(function, "last"))
+	{
+		*count = (ZBX_VALUE_NVALUES == arg1_type ? arg1 : 1);
+		return SUCCEED;
+	}
+
+	switch (arg1_type)
+	{
+		case ZBX_VALUE_SECONDS:
+			*seconds = arg1;
+			break;
+		case ZBX_VALUE_NVALUES:
+			*count = arg1;
+			break;
+		default:
+			if (0 != strcmp(function, "count") && 0 != strcmp(function, "countunique") &&
+					0 != strcmp(function, "find"))
+			{
+				return FAIL;
+			}
+
+			*count = 1;
+	}
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluate function.                                                *
@@ -56,6 +56,8 @@ int	zbx_evaluate_RATE(zbx_variant_t *value, zbx_dc_item_t *item, const char *par
 
 int	evaluate_function(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *function,
 		const char *parameter, const zbx_timespec_t *ts, char **error);
+int	zbx_get_function_history_range(const char *function, const char *parameter, const zbx_timespec_t *ts,
+		int *seconds, int *count, zbx_timespec_t *ts_end);
 int	evaluate_value_by_map(char *value, size_t max_len, zbx_vector_valuemaps_ptr_t *valuemaps,
 		unsigned char value_type);
 
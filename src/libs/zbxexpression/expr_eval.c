@@ -64,6 +64,31 @@ typedef struct
 }
 zbx_expression_query_many_t;
 
+/* item query resolved to itemids */
+typedef struct
+{
+	char			*query;
+	zbx_vector_uint64_t	itemids;
+}
+zbx_expression_memo_query_t;
+
+/* aggregate function result */
+typedef struct
+{
+	char		*call;
+	int		ret;
+	zbx_variant_t	value;
+	char		*error;
+}
+zbx_expression_memo_value_t;
+
+/* Item queries and aggregate function results shared between calculated items evaluated */
+/* in the same batch. Function results are shared only within the same second.           */
+static zbx_hashset_t	memo_queries;
+static zbx_hashset_t	memo_values;
+static int		memo_open = 0;
+static zbx_uint64_t	memo_hits, memo_misses;
+
 ZBX_PTR_VECTOR_IMPL(expression_group_ptr, zbx_expression_group_t *)
 ZBX_PTR_VECTOR_IMPL(expression_item_ptr, zbx_expression_item_t *)
 ZBX_PTR_VECTOR_IMPL(expression_query_ptr, zbx_expression_query_t *)
@@ -211,6 +236,16 @@ static zbx_expression_group_t	*expression_get_group(zbx_expression_eval_t *eval,
 	return group;
 }
 
+static int	expression_item_compare(const void *d1, const void *d2)
+{
+	const zbx_expression_item_t	*i1 = *(const zbx_expression_item_t * const *)d1;
+	const zbx_expression_item_t	*i2 = *(const zbx_expression_item_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(i1->itemid, i2->itemid);
+
+	return 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get item from cache by itemid.                                    *
@@ -220,26 +255,24 @@ static zbx_expression_group_t	*expression_get_group(zbx_expression_eval_t *eval,
  *                                                                            *
  * Return value: the cached item.                                             *
  *                                                                            *
- * Comments: cache item if necessary.                                         *
+ * Comments: cache item if necessary, cached items are kept sorted by itemid. *
  *                                                                            *
  ******************************************************************************/
 static zbx_expression_item_t	*expression_get_item(zbx_expression_eval_t *eval, zbx_uint64_t itemid)
 {
-	zbx_expression_item_t	*item;
+	zbx_expression_item_t	*item, item_local = {.itemid = itemid};
+	int			index;
 
-	for (int i = 0; i < eval->itemtags.values_num; i++)
-	{
-		item = eval->itemtags.values[i];
+	index = zbx_vector_expression_item_ptr_nearestindex(&eval->itemtags, &item_local, expression_item_compare);
 
-		if (item->itemid == itemid)
-			return item;
-	}
+	if (index < eval->itemtags.values_num && eval->itemtags.values[index]->itemid == itemid)
+		return eval->itemtags.values[index];
 
 	item = (zbx_expression_item_t *)zbx_malloc(NULL, sizeof(zbx_expression_item_t));
 	item->itemid = itemid;
 	zbx_vector_item_tag_create(&item->tags);
 	zbx_dc_get_item_tags(itemid, &item->tags);
-	zbx_vector_expression_item_ptr_append(&eval->itemtags, item);
+	zbx_vector_expression_item_ptr_insert(&eval->itemtags, item, index);
 
 	return item;
 }
@@ -268,48 +301,6 @@ static void	expression_init_query_one(zbx_expression_eval_t *eval, zbx_expressio
 	query->data = data;
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: replace wildcards '*'in key parameters with % and escape existing *
- *          %, \ characters for SQL like operation.                           *
- *                                                                            *
- ******************************************************************************/
-static int	replace_key_param_wildcard_cb(const char *data, int key_type, int level, int num, int quoted,
-		void *cb_data, char **param)
-{
-	char	*tmp;
-
-	ZBX_UNUSED(key_type);
-	ZBX_UNUSED(num);
-	ZBX_UNUSED(cb_data);
-
-	if (0 == level)
-		return SUCCEED;
-
-	if ('*' == data[0] && '\0' == data[1])
-	{
-		*param = zbx_strdup(NULL, "%");
-		return SUCCEED;
-	}
-
-	if (NULL == strchr(data, '%') && NULL == strchr(data, '\\'))
-		return SUCCEED;
-
-	tmp = zbx_strdup(NULL, data);
-	zbx_unquote_key_param(tmp);
-	*param = zbx_dyn_escape_string(tmp, "\\%%");
-	zbx_free(tmp);
-
-	/* escaping cannot result in unquotable parameter */
-	if (FAIL == zbx_quote_key_param(param, quoted))
-	{
-		THIS_SHOULD_NEVER_HAPPEN;
-		zbx_free(*param);
-	}
-
-	return SUCCEED;
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: check if item key matches the pattern.                            *
@@ -358,147 +349,99 @@ typedef struct
 }
 zbx_expression_eval_many_t;
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: item key matching callback for configuration cache item queries.  *
+ *                                                                            *
+ ******************************************************************************/
+static int	expression_match_item_key_cb(const char *key, void *data)
+{
+	return expression_match_item_key(key, (const AGENT_REQUEST *)data);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get itemids + hostids of items that might match query based on    *
- *          host, key and filter groups.                                      *
+ *          host, key and filter groups/tags.                                 *
  *                                                                            *
- * Parameters: eval            - [IN] evaluation data                         *
- *             query           - [IN] expression item query                   *
- *             groups          - [IN] groups in filter template               *
- *             filter_template - [IN] group filter template with {index}      *
- *                                    placeholders referring to a group in    *
- *                                    groups vector                           *
- *             itemhosts       - [out] itemid+hostid pairs matching query     *
+ * Parameters: eval      - [IN] evaluation data                               *
+ *             query     - [IN] expression item query                         *
+ *             groups    - [IN] groups required by filter                     *
+ *             tags      - [IN] tags required by filter                       *
+ *             itemhosts - [out] itemid+hostid pairs matching query           *
+ *                                                                            *
+ * Comments: The candidates are selected from configuration cache indexes,    *
+ *           the filter must still be evaluated for the returned items.       *
  *                                                                            *
  ******************************************************************************/
 static void	expression_get_item_candidates(zbx_expression_eval_t *eval, const zbx_expression_query_t *query,
-		const zbx_vector_str_t *groups, const char *filter_template, zbx_vector_uint64_pair_t *itemhosts)
+		const zbx_vector_str_t *groups, const zbx_vector_str_t *tags, zbx_vector_uint64_pair_t *itemhosts)
 {
-	zbx_db_result_t	result;
-	zbx_db_row_t	row;
-	char		*sql = NULL, *esc, *clause = "where";
-	size_t		sql_alloc = 0, sql_offset = 0;
-	AGENT_REQUEST	pattern;
+	zbx_dc_item_query_t	item_query = {0};
+	AGENT_REQUEST		pattern;
+	zbx_vector_uint64_t	hostids;
+	int			i, j, k;
 
-	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select i.itemid,i.hostid");
+	zbx_init_agent_request(&pattern);
+	zbx_vector_uint64_create(&hostids);
+
+	if (0 != (query->flags & ZBX_ITEM_QUERY_HOST_ONE))
+		item_query.host = query->ref.host;
+	else if (0 != (query->flags & ZBX_ITEM_QUERY_HOST_SELF))
+		item_query.hostid = eval->hostid;
 
 	if (0 != (query->flags & ZBX_ITEM_QUERY_KEY_SOME))
 	{
-		zbx_init_agent_request(&pattern);
 		if (SUCCEED != zbx_parse_item_key(query->ref.key, &pattern))
 		{
 			THIS_SHOULD_NEVER_HAPPEN;
-			zbx_free(sql);
-			return;
+			goto out;
 		}
 
-		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ",i.key_");
-	}
-
-	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " from items i");
-
-	if (0 != (query->flags & ZBX_ITEM_QUERY_HOST_ONE))
-	{
-		esc = zbx_db_dyn_escape_string(query->ref.host);
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, ",hosts h"
-				" where h.hostid=i.hostid"
-				" and h.host='%s'", esc);
-		zbx_free(esc);
-		clause = "and";
-	}
-	else if (0 != (query->flags & ZBX_ITEM_QUERY_HOST_SELF))
-	{
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " where i.hostid=" ZBX_FS_UI64,
-				eval->hostid);
-		clause = "and";
-	}
-
-	if (0 != (query->flags & ZBX_ITEM_QUERY_KEY_SOME))
-	{
-		char	*key;
-
-		key = zbx_strdup(NULL, query->ref.key);
-		zbx_replace_key_params_dyn(&key, ZBX_KEY_TYPE_ITEM, replace_key_param_wildcard_cb, NULL, NULL, 0);
-
-		esc = zbx_db_dyn_escape_string(key);
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " %s i.key_ like '%s'", clause, esc);
-		zbx_free(esc);
-		zbx_free(key);
-		clause = "and";
+		item_query.key = query->ref.key;
+		item_query.match_key = expression_match_item_key_cb;
+		item_query.match_data = &pattern;
 	}
 	else if (0 != (query->flags & ZBX_ITEM_QUERY_KEY_ONE))
-	{
-		esc = zbx_db_dyn_escape_string(query->ref.key);
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " %s i.key_='%s'", clause, esc);
-		zbx_free(esc);
-		clause = "and";
-	}
+		item_query.key = query->ref.key;
 
-	if (0 != (query->flags & ZBX_ITEM_QUERY_FILTER) && NULL != filter_template && '\0' != *filter_template)
+	if (0 != groups->values_num)
 	{
-		zbx_uint64_t		index;
-		int			pos = 0, last_pos = 0;
-		zbx_token_t		token;
 		zbx_expression_group_t	*group;
 
-		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " %s ", clause);
+		/* item host must belong to all required groups - intersect their hosts */
+		group = expression_get_group(eval, groups->values[0]);
+		zbx_vector_uint64_append_array(&hostids, group->hostids.values, group->hostids.values_num);
 
-		for (; SUCCEED == zbx_token_find(filter_template, pos, &token, ZBX_TOKEN_SEARCH_FUNCTIONID); pos++)
+		for (i = 1; i < groups->values_num && 0 != hostids.values_num; i++)
 		{
-			if (ZBX_TOKEN_OBJECTID != token.type)
-				continue;
-
-			if (SUCCEED != zbx_is_uint64_n(filter_template + token.loc.l + 1, token.loc.r - token.loc.l - 1,
-					&index) && (int)index < groups->values_num)
-			{
-				continue;
-			}
-
-			group = expression_get_group(eval, groups->values[index]);
+			group = expression_get_group(eval, groups->values[i]);
 
-			zbx_strncpy_alloc(&sql, &sql_alloc, &sql_offset, filter_template + last_pos,
-					token.loc.l - last_pos);
-
-			if (' ' == sql[sql_offset - 1])
-				sql_offset--;
-
-			if (0 < group->hostids.values_num)
+			for (j = 0, k = 0; j < hostids.values_num; j++)
 			{
-				zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "i.hostid",
-						group->hostids.values, group->hostids.values_num);
+				if (FAIL != zbx_vector_uint64_bsearch(&group->hostids, hostids.values[j],
+						ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+				{
+					hostids.values[k++] = hostids.values[j];
+				}
 			}
-			else
-				zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " 1=0");
 
-			last_pos = token.loc.r + 1;
-			pos = token.loc.r;
+			hostids.values_num = k;
 		}
 
-		if ('\0' != filter_template[last_pos])
-			zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, filter_template + last_pos);
-	}
-
-	result = zbx_db_select("%s", sql);
-
-	while (NULL != (row = zbx_db_fetch(result)))
-	{
-		zbx_uint64_pair_t	pair;
+		if (0 == hostids.values_num)
+			goto out;
 
-		if (0 == (query->flags & ZBX_ITEM_QUERY_KEY_SOME) ||
-				(NULL != pattern.key && SUCCEED == expression_match_item_key(row[2], &pattern)))
-		{
-			ZBX_STR2UINT64(pair.first, row[0]);
-			ZBX_STR2UINT64(pair.second, row[1]);
-			zbx_vector_uint64_pair_append(itemhosts, pair);
-		}
+		item_query.hostids = &hostids;
 	}
-	zbx_db_free_result(result);
 
-	if (0 != (query->flags & ZBX_ITEM_QUERY_KEY_SOME))
-		zbx_free_agent_request(&pattern);
+	if (0 != tags->values_num)
+		item_query.tags = tags;
 
-	zbx_free(sql);
+	zbx_dc_get_item_query_candidates(&item_query, itemhosts);
+out:
+	zbx_free_agent_request(&pattern);
+	zbx_vector_uint64_destroy(&hostids);
 }
 
 /******************************************************************************
@@ -616,6 +559,134 @@ static int	expression_eval_filter(const char *name, size_t len, int args_num, zb
 	}
 }
 
+static zbx_hash_t	expression_memo_hash(const void *data)
+{
+	const char	*key = *(const char * const *)data;
+
+	return ZBX_DEFAULT_STRING_HASH_FUNC(key);
+}
+
+static int	expression_memo_compare(const void *d1, const void *d2)
+{
+	const char	*key1 = *(const char * const *)d1;
+	const char	*key2 = *(const char * const *)d2;
+
+	return strcmp(key1, key2);
+}
+
+static void	expression_memo_query_clean(void *data)
+{
+	zbx_expression_memo_query_t	*query = (zbx_expression_memo_query_t *)data;
+
+	zbx_free(query->query);
+	zbx_vector_uint64_destroy(&query->itemids);
+}
+
+static void	expression_memo_value_clean(void *data)
+{
+	zbx_expression_memo_value_t	*value = (zbx_expression_memo_value_t *)data;
+
+	zbx_free(value->call);
+	zbx_variant_clear(&value->value);
+	zbx_free(value->error);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start sharing item queries and aggregate function results between *
+ *          the following expression evaluations                              *
+ *                                                                            *
+ * Comments: Used by history pollers to evaluate identical aggregate          *
+ *           functions of calculated items in one batch only once.            *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_expression_memo_open(void)
+{
+	zbx_hashset_create_ext(&memo_queries, 0, expression_memo_hash, expression_memo_compare,
+			expression_memo_query_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_hashset_create_ext(&memo_values, 0, expression_memo_hash, expression_memo_compare,
+			expression_memo_value_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	memo_hits = 0;
+	memo_misses = 0;
+	memo_open = 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stop sharing item queries and aggregate function results          *
+ *                                                                            *
+ * Parameters: hits   - [OUT] the number of function results taken from memo  *
+ *             misses - [OUT] the number of evaluated function results        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_expression_memo_close(zbx_uint64_t *hits, zbx_uint64_t *misses)
+{
+	*hits = memo_hits;
+	*misses = memo_misses;
+
+	if (0 == memo_open)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() queries:%d values:%d hits:" ZBX_FS_UI64 " misses:" ZBX_FS_UI64,
+			__func__, memo_queries.num_data, memo_values.num_data, memo_hits, memo_misses);
+
+	zbx_hashset_destroy(&memo_values);
+	zbx_hashset_destroy(&memo_queries);
+
+	memo_open = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get normalized item query used as memo key                        *
+ *                                                                            *
+ * Comments: The host and filter macros must be already resolved.             *
+ *                                                                            *
+ ******************************************************************************/
+static char	*expression_memo_query_key(const zbx_expression_query_t *query)
+{
+	return zbx_dsprintf(NULL, "/%s/%s%s%s%s", ZBX_NULL2EMPTY_STR(query->ref.host),
+			ZBX_NULL2EMPTY_STR(query->ref.key), NULL != query->ref.filter ? "?[" : "",
+			ZBX_NULL2EMPTY_STR(query->ref.filter), NULL != query->ref.filter ? "]" : "");
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get aggregate function call used as memo key                      *
+ *                                                                            *
+ * Parameters: query    - [IN] the item query                                 *
+ *             name     - [IN] the function name (not zero terminated)        *
+ *             len      - [IN] the function name length                       *
+ *             args_num - [IN] the number of function arguments after query   *
+ *             args     - [IN] the function arguments after query             *
+ *             ts       - [IN] the function execution time                    *
+ *                                                                            *
+ ******************************************************************************/
+static char	*expression_memo_call_key(const zbx_expression_query_t *query, const char *name, size_t len,
+		int args_num, const zbx_variant_t *args, const zbx_timespec_t *ts)
+{
+	char	*call = NULL, *query_key;
+	size_t	call_alloc = 0, call_offset = 0;
+	int	i;
+
+	query_key = expression_memo_query_key(query);
+	zbx_snprintf_alloc(&call, &call_alloc, &call_offset, "%d:%.*s(%s", ts->sec, (int)len, name, query_key);
+	zbx_free(query_key);
+
+	for (i = 0; i < args_num; i++)
+	{
+		zbx_snprintf_alloc(&call, &call_alloc, &call_offset, ",%s:%s", zbx_variant_type_desc(&args[i]),
+				zbx_variant_value_desc(&args[i]));
+	}
+
+	zbx_chrcpy_alloc(&call, &call_alloc, &call_offset, ')');
+
+	return call;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: initialize many item query.                                       *
@@ -627,12 +698,13 @@ static int	expression_eval_filter(const char *name, size_t len, int args_num, zb
 static void	expression_init_query_many(zbx_expression_eval_t *eval, zbx_expression_query_t *query)
 {
 	zbx_expression_query_many_t	*data;
-	char				*error = NULL, *errmsg = NULL, *filter_template = NULL;
+	char				*error = NULL, *errmsg = NULL;
 	int				i, ret = FAIL;
 	zbx_eval_context_t		ctx;
 	zbx_vector_uint64_pair_t	itemhosts;
-	zbx_vector_str_t		groups;
+	zbx_vector_str_t		groups, tags;
 	zbx_vector_uint64_t		itemids;
+	zbx_expression_memo_query_t	*memo_query, memo_query_local = {0};
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() /%s/%s?[%s]", __func__, ZBX_NULL2EMPTY_STR(query->ref.host),
 			ZBX_NULL2EMPTY_STR(query->ref.key), ZBX_NULL2EMPTY_STR(query->ref.filter));
@@ -642,6 +714,7 @@ static void	expression_init_query_many(zbx_expression_eval_t *eval, zbx_expressi
 	zbx_vector_uint64_create(&itemids);
 	zbx_vector_uint64_pair_create(&itemhosts);
 	zbx_vector_str_create(&groups);
+	zbx_vector_str_create(&tags);
 
 	if (ZBX_ITEM_QUERY_ITEM_ANY == (query->flags & ZBX_ITEM_QUERY_ITEM_ANY))
 	{
@@ -649,6 +722,19 @@ static void	expression_init_query_many(zbx_expression_eval_t *eval, zbx_expressi
 		goto out;
 	}
 
+	if (0 != memo_open)
+	{
+		memo_query_local.query = expression_memo_query_key(query);
+
+		if (NULL != (memo_query = (zbx_expression_memo_query_t *)zbx_hashset_search(&memo_queries,
+				&memo_query_local)))
+		{
+			zbx_vector_uint64_append_array(&itemids, memo_query->itemids.values,
+					memo_query->itemids.values_num);
+			goto done;
+		}
+	}
+
 	if (0 != (query->flags & ZBX_ITEM_QUERY_FILTER))
 	{
 		if (SUCCEED != zbx_eval_parse_expression(&ctx, query->ref.filter, ZBX_EVAL_PARSE_QUERY_EXPRESSION,
@@ -660,16 +746,10 @@ static void	expression_init_query_many(zbx_expression_eval_t *eval, zbx_expressi
 		}
 
 		zbx_eval_prepare_filter(&ctx);
-
-		if (FAIL == zbx_eval_get_group_filter(&ctx, &groups, &filter_template, &errmsg))
-		{
-			error = zbx_dsprintf(NULL, "failed to extract groups from item filter: %s", errmsg);
-			zbx_free(errmsg);
-			goto out;
-		}
+		zbx_eval_get_required_properties(&ctx, &groups, &tags);
 	}
 
-	expression_get_item_candidates(eval, query, &groups, filter_template, &itemhosts);
+	expression_get_item_candidates(eval, query, &groups, &tags, &itemhosts);
 
 	if (0 != (query->flags & ZBX_ITEM_QUERY_FILTER))
 	{
@@ -711,6 +791,16 @@ static void	expression_init_query_many(zbx_expression_eval_t *eval, zbx_expressi
 			zbx_vector_uint64_append(&itemids, itemhosts.values[i].first);
 	}
 
+	if (0 != memo_open)
+	{
+		memo_query = (zbx_expression_memo_query_t *)zbx_hashset_insert(&memo_queries, &memo_query_local,
+				sizeof(memo_query_local));
+		memo_query_local.query = NULL;
+
+		zbx_vector_uint64_create(&memo_query->itemids);
+		zbx_vector_uint64_append_array(&memo_query->itemids, itemids.values, itemids.values_num);
+	}
+done:
 	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_DEBUG))
 	{
 		for (i = 0; i < itemids.values_num; i++)
@@ -734,10 +824,11 @@ out:
 		zbx_vector_uint64_destroy(&itemids);
 	}
 
-	zbx_free(filter_template);
-
+	zbx_free(memo_query_local.query);
 	zbx_vector_uint64_pair_destroy(&itemhosts);
 
+	zbx_vector_str_clear_ext(&tags, zbx_str_free);
+	zbx_vector_str_destroy(&tags);
 	zbx_vector_str_clear_ext(&groups, zbx_str_free);
 	zbx_vector_str_destroy(&groups);
 
@@ -1806,6 +1897,83 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate historical function for many item query, sharing the     *
+ *          result with other expressions when memo is open.                  *
+ *                                                                            *
+ * Parameters: eval     - [IN] evaluation data                                *
+ *             query    - [IN] item query                                     *
+ *             name     - [IN] function name (not zero terminated)            *
+ *             len      - [IN] function name length                           *
+ *             args_num - [IN] number of function arguments                   *
+ *             args     - [IN] array of function arguments.                   *
+ *             ts       - [IN] function execution time                        *
+ *             value    - [OUT] function return value                         *
+ *             error    - [OUT]                                               *
+ *                                                                            *
+ * Return value: SUCCEED - the function was executed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	expression_eval_many_memo(zbx_expression_eval_t *eval, zbx_expression_query_t *query,
+		const char *name, size_t len, int args_num, zbx_variant_t *args, const zbx_timespec_t *ts,
+		zbx_variant_t *value, char **error)
+{
+	zbx_expression_memo_value_t	*memo_value, memo_value_local;
+
+	if (0 != memo_open)
+	{
+		memo_value_local.call = expression_memo_call_key(query, name, len, args_num, args, ts);
+
+		if (NULL != (memo_value = (zbx_expression_memo_value_t *)zbx_hashset_search(&memo_values,
+				&memo_value_local)))
+		{
+			zbx_free(memo_value_local.call);
+			memo_hits++;
+
+			if (SUCCEED != memo_value->ret)
+			{
+				*error = zbx_strdup(NULL, memo_value->error);
+				return FAIL;
+			}
+
+			zbx_variant_copy(value, &memo_value->value);
+
+			return SUCCEED;
+		}
+
+		memo_misses++;
+	}
+
+	/* items are cached only when needed as results of all functions might be already available */
+	if (0 == eval->dcitems_cached)
+	{
+		expression_cache_dcitems(eval);
+		eval->dcitems_cached = 1;
+	}
+
+	memo_value_local.ret = expression_eval_many(eval, query, name, len, args_num, args, ts, value, error);
+
+	if (0 != memo_open)
+	{
+		if (SUCCEED == memo_value_local.ret)
+		{
+			zbx_variant_copy(&memo_value_local.value, value);
+			memo_value_local.error = NULL;
+		}
+		else
+		{
+			zbx_variant_set_none(&memo_value_local.value);
+			memo_value_local.error = zbx_strdup(NULL, ZBX_NULL2EMPTY_STR(*error));
+		}
+
+		zbx_hashset_insert(&memo_values, &memo_value_local, sizeof(memo_value_local));
+	}
+
+	return memo_value_local.ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluate historical function.                                     *
@@ -1864,7 +2032,7 @@ static int	expression_eval_history(const char *name, size_t len, int args_num, z
 	}
 	else if (ZBX_EXPRESSION_AGGREGATE == eval->mode)
 	{
-		ret = expression_eval_many(eval, query, name, len, args_num - 1, args + 1, ts, value, &errmsg);
+		ret = expression_eval_many_memo(eval, query, name, len, args_num - 1, args + 1, ts, value, &errmsg);
 	}
 	else
 	{
@@ -1976,6 +2144,7 @@ void	zbx_expression_eval_init(zbx_expression_eval_t *eval, int mode, zbx_eval_co
 	eval->one_num = 0;
 	eval->many_num = 0;
 	eval->dcitems_num = 0;
+	eval->dcitems_cached = 0;
 	eval->hostid = 0;
 
 	for (i = 0; i < filters.values_num; i++)
@@ -2238,10 +2407,6 @@ int	zbx_expression_eval_execute(zbx_expression_eval_t *eval, const zbx_timespec_
 	if (0 != eval->one_num)
 		expression_cache_dcitems_hk(eval);
 
-	/* cache items for functions using many item queries */
-	if (0 != eval->many_num)
-		expression_cache_dcitems(eval);
-
 	zbx_variant_set_none(value);
 
 	ret = zbx_eval_execute_ext(eval->ctx, ts, expression_eval_common, expression_eval_history, (void *)eval, value,
@@ -362,15 +362,25 @@ static void	zbx_populate_function_items(const zbx_vector_uint64_t *functionids,
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() ifuncs_num:%d", __func__, ifuncs->num_data);
 }
 
+typedef struct
+{
+	zbx_func_t			*func;
+	const zbx_history_sync_item_t	*item;
+	char				*params;
+}
+zbx_func_eval_t;
+
 static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_uint64_t *history_itemids,
 		const zbx_history_sync_item_t *history_items, const int *history_errcodes,
 		zbx_history_sync_item_t **items, int **items_err, int *items_num)
 {
-	char			*error = NULL;
-	int			i;
-	zbx_func_t		*func;
-	zbx_vector_uint64_t	itemids;
-	zbx_hashset_iter_t	iter;
+	char				*error = NULL;
+	int				i, evals_num = 0;
+	zbx_func_t			*func;
+	zbx_vector_uint64_t		itemids;
+	zbx_vector_vc_prefetch_t	requests;
+	zbx_hashset_iter_t		iter;
+	zbx_func_eval_t			*evals;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() funcs_num:%d", __func__, funcs->num_data);
 
@@ -397,13 +407,16 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 				(size_t)itemids.values_num, ZBX_ITEM_GET_SYNC);
 	}
 
+	evals = (zbx_func_eval_t *)zbx_malloc(NULL, sizeof(zbx_func_eval_t) * (size_t)funcs->num_data);
+	zbx_vector_vc_prefetch_create(&requests);
+
 	zbx_hashset_iter_reset(funcs, &iter);
 	while (NULL != (func = (zbx_func_t *)zbx_hashset_iter_next(&iter)))
 	{
-		int				errcode, ret;
+		int				errcode;
 		const zbx_history_sync_item_t	*item;
-		char				*params;
-		zbx_dc_evaluate_item_t		evaluate_item;
+		zbx_func_eval_t			*eval;
+		zbx_vc_prefetch_t		request;
 
 		/* avoid double copying from configuration cache if already retrieved when saving history */
 		if (FAIL != (i = zbx_vector_uint64_bsearch(history_itemids, func->itemid,
@@ -480,28 +493,56 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 			continue;
 		}
 
-		params = zbx_dc_expand_user_macros_in_func_params(func->parameter, item->host.hostid);
+		eval = &evals[evals_num++];
+		eval->func = func;
+		eval->item = item;
+		eval->params = zbx_dc_expand_user_macros_in_func_params(func->parameter, item->host.hostid);
+
+		if (ZBX_FUNCTION_TYPE_HISTORY == func->type && SUCCEED == zbx_get_function_history_range(
+				func->function, eval->params, &func->timespec, &request.seconds, &request.count,
+				&request.ts))
+		{
+			request.itemid = item->itemid;
+			request.value_type = item->value_type;
+			zbx_vector_vc_prefetch_append(&requests, request);
+		}
+	}
+
+	/* functions of the same item often read the same or overlapping history periods - */
+	/* fetch the longest period of each item once and share it between functions       */
+	if (1 < requests.values_num)
+		zbx_vc_prefetch_values(&requests);
+
+	for (i = 0; i < evals_num; i++)
+	{
+		zbx_func_eval_t		*eval = &evals[i];
+		zbx_dc_evaluate_item_t	evaluate_item;
 
-		evaluate_item.itemid = item->itemid;
-		evaluate_item.value_type = item->value_type;
-		evaluate_item.proxyid = item->host.proxyid;
-		evaluate_item.host = item->host.host;
-		evaluate_item.key_orig = item->key_orig;
+		func = eval->func;
 
-		ret = evaluate_function(&func->value, &evaluate_item, func->function, params, &func->timespec, &error);
-		zbx_free(params);
+		evaluate_item.itemid = eval->item->itemid;
+		evaluate_item.value_type = eval->item->value_type;
+		evaluate_item.proxyid = eval->item->host.proxyid;
+		evaluate_item.host = eval->item->host.host;
+		evaluate_item.key_orig = eval->item->key_orig;
 
-		if (SUCCEED != ret)
+		if (SUCCEED != evaluate_function(&func->value, &evaluate_item, func->function, eval->params,
+				&func->timespec, &error))
 		{
 			/* compose and store error message for future use */
 			zbx_variant_set_error(&func->value,
-					zbx_eval_format_function_error(func->function, item->host.host,
-							item->key_orig, func->parameter, error));
+					zbx_eval_format_function_error(func->function, eval->item->host.host,
+							eval->item->key_orig, func->parameter, error));
 			zbx_free(error);
-			continue;
 		}
+
+		zbx_free(eval->params);
 	}
 
+	zbx_vc_prefetch_clear();
+	zbx_vector_vc_prefetch_destroy(&requests);
+	zbx_free(evals);
+
 	zbx_vc_flush_stats();
 	zbx_vector_uint64_destroy(&itemids);
 
@@ -1905,17 +1905,16 @@ static void	jsonpath_variant_to_boolean(zbx_variant_t *value)
  ******************************************************************************/
 static int	jsonpath_regexp_match(const char *text, const char *pattern, double *result)
 {
-	zbx_regexp_t	*rxp;
-	char		*error = NULL;
+	const zbx_regexp_t	*rxp;
+	char			*error = NULL;
 
-	if (FAIL == zbx_regexp_compile(pattern, &rxp, &error))
+	if (FAIL == zbx_regexp_compile_cached(pattern, &rxp, &error))
 	{
 		zbx_set_json_strerror("invalid regular expression in JSON path: %s", error);
 		zbx_free(error);
 		return FAIL;
 	}
 	*result = (0 == zbx_regexp_match_precompiled(text, rxp) ? 1.0 : 0.0);
-	zbx_regexp_free(rxp);
 
 	return SUCCEED;
 }
@@ -2939,6 +2938,303 @@ int	zbx_jsonobj_query(zbx_jsonobj_t *obj, const char *path, char **output)
 	return zbx_jsonobj_query_ext(obj, NULL, path, output);
 }
 
+/* jsonpath trie node, combining definite jsonpaths with common prefixes */
+typedef struct zbx_jsonpath_trie_node
+{
+	const char	*name;		/* object property name, NULL for array element */
+	int		index;		/* array element index */
+	int		query_index;	/* the query ending at this node, -1 if none */
+
+	struct zbx_jsonpath_trie_node	*children;
+	struct zbx_jsonpath_trie_node	*next;
+}
+zbx_jsonpath_trie_node_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if jsonpath consists only of single name or index           *
+ *          segments                                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	jsonpath_is_simple(const zbx_jsonpath_t *jsonpath)
+{
+	for (int i = 0; i < jsonpath->segments_num; i++)
+	{
+		const zbx_jsonpath_segment_t	*segment = &jsonpath->segments[i];
+
+		if (ZBX_JSONPATH_SEGMENT_MATCH_LIST != segment->type || 0 != segment->detached ||
+				NULL == segment->data.list.values || NULL != segment->data.list.values->next)
+		{
+			return FAIL;
+		}
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compare simple jsonpaths segment by segment                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	jsonpath_simple_compare(const void *d1, const void *d2)
+{
+	const zbx_jsonpath_t	*path1 = *(const zbx_jsonpath_t * const *)d1;
+	const zbx_jsonpath_t	*path2 = *(const zbx_jsonpath_t * const *)d2;
+
+	for (int i = 0; i < path1->segments_num && i < path2->segments_num; i++)
+	{
+		const zbx_jsonpath_list_t	*list1 = &path1->segments[i].data.list;
+		const zbx_jsonpath_list_t	*list2 = &path2->segments[i].data.list;
+		int				ret, index1, index2;
+
+		ZBX_RETURN_IF_NOT_EQUAL(list1->type, list2->type);
+
+		if (ZBX_JSONPATH_LIST_NAME == list1->type)
+		{
+			if (0 != (ret = strcmp(list1->values->data, list2->values->data)))
+				return ret;
+
+			continue;
+		}
+
+		memcpy(&index1, list1->values->data, sizeof(index1));
+		memcpy(&index2, list2->values->data, sizeof(index2));
+		ZBX_RETURN_IF_NOT_EQUAL(index1, index2);
+	}
+
+	ZBX_RETURN_IF_NOT_EQUAL(path1->segments_num, path2->segments_num);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add simple jsonpath to trie                                       *
+ *                                                                            *
+ * Parameters: root        - [IN/OUT] the trie root node                      *
+ *             jsonpath    - [IN] the compiled jsonpath                       *
+ *             query_index - [IN] the query index                             *
+ *                                                                            *
+ * Return value: The index of query with the same path that was added before  *
+ *               or -1 if the path was added.                                 *
+ *                                                                            *
+ * Comments: The jsonpaths must be added in jsonpath_simple_compare() order,  *
+ *           so the matching child node, if any, is always the last one added *
+ *           to its parent.                                                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	jsonpath_trie_add(zbx_jsonpath_trie_node_t *root, const zbx_jsonpath_t *jsonpath, int query_index)
+{
+	zbx_jsonpath_trie_node_t	*parent = root, *node;
+
+	for (int i = 0; i < jsonpath->segments_num; i++)
+	{
+		const zbx_jsonpath_list_t	*list = &jsonpath->segments[i].data.list;
+		const char			*name = NULL;
+		int				index = 0;
+
+		if (ZBX_JSONPATH_LIST_NAME == list->type)
+			name = list->values->data;
+		else
+			memcpy(&index, list->values->data, sizeof(index));
+
+		if (NULL == (node = parent->children) || (NULL == name ? NULL != node->name || index != node->index :
+				NULL == node->name || 0 != strcmp(name, node->name)))
+		{
+			node = (zbx_jsonpath_trie_node_t *)zbx_malloc(NULL, sizeof(zbx_jsonpath_trie_node_t));
+			node->name = name;
+			node->index = index;
+			node->query_index = -1;
+			node->children = NULL;
+			node->next = parent->children;
+			parent->children = node;
+		}
+
+		parent = node;
+	}
+
+	if (-1 != parent->query_index)
+		return parent->query_index;
+
+	parent->query_index = query_index;
+
+	return -1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free jsonpath trie nodes                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	jsonpath_trie_clear(zbx_jsonpath_trie_node_t *node)
+{
+	zbx_jsonpath_trie_node_t	*child;
+
+	while (NULL != (child = node->children))
+	{
+		node->children = child->next;
+		jsonpath_trie_clear(child);
+		zbx_free(child);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: match json object against trie, extracting values of all          *
+ *          jsonpaths ending at the matched nodes                             *
+ *                                                                            *
+ * Parameters: node    - [IN] the trie node matching the object               *
+ *             obj     - [IN] the json object                                 *
+ *             queries - [IN/OUT] the queries                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	jsonpath_trie_query(const zbx_jsonpath_trie_node_t *node, zbx_jsonobj_t *obj,
+		zbx_jsonobj_query_t *queries)
+{
+	const zbx_jsonpath_trie_node_t	*child;
+
+	if (-1 != node->query_index)
+	{
+		size_t	output_alloc = 0, output_offset = 0;
+
+		if (FAIL == jsonpath_str_copy_value(&queries[node->query_index].output, &output_alloc, &output_offset,
+				obj))
+		{
+			zbx_free(queries[node->query_index].output);
+			queries[node->query_index].error = zbx_strdup(NULL, zbx_json_strerror());
+		}
+	}
+
+	for (child = node->children; NULL != child; child = child->next)
+	{
+		zbx_jsonobj_t	*next = NULL;
+
+		if (NULL != child->name)
+		{
+			zbx_jsonobj_el_t	el_local, *el;
+
+			if (ZBX_JSON_TYPE_OBJECT != obj->type)
+				continue;
+
+			el_local.name = (char *)child->name;
+
+			if (NULL != (el = (zbx_jsonobj_el_t *)zbx_hashset_search(&obj->data.object, &el_local)))
+				next = &el->value;
+		}
+		else
+		{
+			int	index = child->index;
+
+			if (ZBX_JSON_TYPE_ARRAY != obj->type)
+				continue;
+
+			if (0 > index)
+				index += obj->data.array.values_num;
+
+			if (0 <= index && index < obj->data.array.values_num)
+				next = obj->data.array.values[index];
+		}
+
+		if (NULL != next)
+			jsonpath_trie_query(child, next, queries);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: perform multiple jsonpath queries on the specified json object    *
+ *                                                                            *
+ * Parameters: obj         - [IN] json object                                 *
+ *             index       - [IN] jsonpath index (optional)                   *
+ *             queries     - [IN/OUT] the queries to perform                  *
+ *             queries_num - [IN] the number of queries                       *
+ *                                                                            *
+ * Comments: Paths consisting only of single property names and array         *
+ *           indexes are combined into a trie and resolved during one walk    *
+ *           over the object, so common path prefixes are matched only once.  *
+ *           Other paths are queried one by one.                              *
+ *           The query results are the same as returned by                    *
+ *           zbx_jsonobj_query_ext() for each path.                           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_jsonobj_query_batch(zbx_jsonobj_t *obj, zbx_jsonpath_index_t *index, zbx_jsonobj_query_t *queries,
+		int queries_num)
+{
+	zbx_jsonpath_trie_node_t	root = {.name = NULL, .query_index = -1, .children = NULL};
+	zbx_jsonpath_t			*jsonpaths;
+	zbx_vector_ptr_t		simple;
+	int				*duplicates;
+
+	/* the trie references names stored in compiled jsonpaths, */
+	/* so they are kept until the trie is queried               */
+	jsonpaths = (zbx_jsonpath_t *)zbx_malloc(NULL, sizeof(zbx_jsonpath_t) * (size_t)queries_num);
+	duplicates = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)queries_num);
+	zbx_vector_ptr_create(&simple);
+
+	for (int i = 0; i < queries_num; i++)
+	{
+		queries[i].output = NULL;
+		queries[i].error = NULL;
+		duplicates[i] = -1;
+
+		if (FAIL == zbx_jsonpath_compile(queries[i].path, &jsonpaths[i]))
+		{
+			queries[i].error = zbx_strdup(NULL, zbx_json_strerror());
+			jsonpaths[i].segments_num = 0;
+			jsonpaths[i].segments = NULL;
+			continue;
+		}
+
+		if (SUCCEED == jsonpath_is_simple(&jsonpaths[i]))
+		{
+			zbx_vector_ptr_append(&simple, &jsonpaths[i]);
+			continue;
+		}
+
+		zbx_jsonpath_clear(&jsonpaths[i]);
+		jsonpaths[i].segments_num = 0;
+
+		if (FAIL == zbx_jsonobj_query_ext(obj, index, queries[i].path, &queries[i].output))
+			queries[i].error = zbx_strdup(NULL, zbx_json_strerror());
+	}
+
+	if (0 != simple.values_num)
+	{
+		zbx_vector_ptr_sort(&simple, jsonpath_simple_compare);
+
+		for (int i = 0; i < simple.values_num; i++)
+		{
+			int	query_index = (int)((zbx_jsonpath_t *)simple.values[i] - jsonpaths);
+
+			duplicates[query_index] = jsonpath_trie_add(&root, jsonpaths + query_index, query_index);
+		}
+
+		jsonpath_trie_query(&root, obj, queries);
+
+		for (int i = 0; i < queries_num; i++)
+		{
+			if (-1 == duplicates[i])
+				continue;
+
+			if (NULL != queries[duplicates[i]].output)
+				queries[i].output = zbx_strdup(NULL, queries[duplicates[i]].output);
+
+			if (NULL != queries[duplicates[i]].error)
+				queries[i].error = zbx_strdup(NULL, queries[duplicates[i]].error);
+		}
+
+		jsonpath_trie_clear(&root);
+	}
+
+	for (int i = 0; i < queries_num; i++)
+		zbx_jsonpath_clear(&jsonpaths[i]);
+
+	zbx_vector_ptr_destroy(&simple);
+	zbx_free(duplicates);
+	zbx_free(jsonpaths);
+}
+
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
 /* jsonobject index hashset support */
 
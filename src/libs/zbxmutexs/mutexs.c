@@ -24,15 +24,51 @@
 #	include "zbxlog.h"
 #else
 #ifdef HAVE_PTHREAD_PROCESS_SHARED
+#define ZBX_LOCK_PROF_MUTEX	0
+#define ZBX_LOCK_PROF_WRLOCK	1
+#define ZBX_LOCK_PROF_RDLOCK	2
+
 typedef struct
 {
 	pthread_mutex_t		mutexes[ZBX_MUTEX_COUNT];
 	pthread_rwlock_t	rwlocks[ZBX_RWLOCK_COUNT];
+
+	/* Lock profiling statistics, updated and reset while holding the profiled */
+	/* lock. Read lock holders update the statistics with atomic operations.   */
+	volatile int		prof_enabled;
+	zbx_lock_stats_t	stats[ZBX_MUTEX_COUNT + ZBX_RWLOCK_COUNT];
 }
 zbx_shared_lock_t;
 
+#ifdef HAVE_ATOMIC_BUILTINS
+#	define LOCK_PROF_LOAD(ptr)		__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#	define LOCK_PROF_STORE(ptr, value)	__atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#	define LOCK_PROF_ADD(ptr, value)	(void)__atomic_fetch_add(ptr, value, __ATOMIC_RELAXED)
+#	define LOCK_PROF_CAS(ptr, expected, desired)							\
+		__atomic_compare_exchange_n(ptr, expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+/* lock profiling is not enabled without atomic operations, these are only to compile the profiler */
+#	define LOCK_PROF_LOAD(ptr)		(*(ptr))
+#	define LOCK_PROF_STORE(ptr, value)	(*(ptr) = (value))
+#	define LOCK_PROF_ADD(ptr, value)	(*(ptr) += (value))
+#	define LOCK_PROF_CAS(ptr, expected, desired)	(*(ptr) == *(expected) ? (*(ptr) = (desired), 1) :	\
+		(*(expected) = *(ptr), 0))
+#endif
+
 static zbx_shared_lock_t	*shared_lock;
 static int			shm_id, locks_disabled;
+
+/* locks acquired by the current thread while profiling */
+typedef struct
+{
+	zbx_uint64_t	acquired;
+	int		site;
+	int		type;
+}
+zbx_lock_hold_t;
+
+static ZBX_THREAD_LOCAL zbx_lock_hold_t	lock_holds[ZBX_MUTEX_COUNT + ZBX_RWLOCK_COUNT];
+static ZBX_THREAD_LOCAL int		lock_holds_num;
 #else
 #	if !HAVE_SEMUN
 		union semun
@@ -257,6 +293,246 @@ int	zbx_rwlock_create(zbx_rwlock_t *rwlock, zbx_rwlock_name_t name, char **error
 	return SUCCEED;
 }
 #ifdef HAVE_PTHREAD_PROCESS_SHARED
+static zbx_uint64_t	lock_prof_time(void)
+{
+	struct timespec	ts;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (zbx_uint64_t)ts.tv_sec * 1000000000 + (zbx_uint64_t)ts.tv_nsec;
+}
+
+static int	lock_prof_bucket(zbx_uint64_t ns)
+{
+	int		i;
+	zbx_uint64_t	limit = 1000;
+
+	for (i = 0; i < ZBX_LOCK_PROF_BUCKETS - 1; i++, limit *= 10)
+	{
+		if (ns < limit)
+			break;
+	}
+
+	return i;
+}
+
+static int	lock_prof_index(int type, void *lock)
+{
+	if (ZBX_LOCK_PROF_MUTEX == type)
+		return (int)((pthread_mutex_t *)lock - shared_lock->mutexes);
+
+	return ZBX_MUTEX_COUNT + (int)((pthread_rwlock_t *)lock - shared_lock->rwlocks);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get index of lock call site statistics, adding new site if there  *
+ *          is free space                                                     *
+ *                                                                            *
+ * Return value: the call site index or -1 if site limit was reached          *
+ *                                                                            *
+ * Comments: The profiled lock must be held. Read lock holders can register   *
+ *           sites concurrently, so a site slot is reserved by incrementing   *
+ *           the number of sites and published by setting its line number.    *
+ *                                                                            *
+ ******************************************************************************/
+static int	lock_prof_get_site(zbx_lock_stats_t *stats, const char *filename, int line)
+{
+	int	i = 0, sites_num;
+
+	sites_num = LOCK_PROF_LOAD(&stats->sites_num);
+
+	while (1)
+	{
+		for (; i < sites_num; i++)
+		{
+			int	site_line;
+
+			/* wait until the site reserved by another read lock holder is published */
+			while (0 == (site_line = LOCK_PROF_LOAD(&stats->sites[i].line)))
+				;
+
+			if (line == site_line && filename == stats->sites[i].filename)
+				return i;
+		}
+
+		if (ZBX_LOCK_PROF_SITES_MAX == sites_num)
+			return -1;
+
+		if (0 != LOCK_PROF_CAS(&stats->sites_num, &sites_num, sites_num + 1))
+			break;
+	}
+
+	stats->sites[i].filename = filename;
+	LOCK_PROF_STORE(&stats->sites[i].line, line);
+
+	return i;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: update lock profiling counters                                    *
+ *                                                                            *
+ * Parameters: counter - [IN/OUT] the counter to update                       *
+ *             value   - [IN] the value to add or compare                     *
+ *             shared  - [IN] 1 - the lock is shared by read lock holders,    *
+ *                                the counter must be updated atomically      *
+ *                            0 - the lock is held exclusively                *
+ *                                                                            *
+ ******************************************************************************/
+static void	lock_prof_add(zbx_uint64_t *counter, zbx_uint64_t value, int shared)
+{
+	if (0 != shared)
+		LOCK_PROF_ADD(counter, value);
+	else
+		*counter += value;
+}
+
+static void	lock_prof_max(zbx_uint64_t *counter, zbx_uint64_t value, int shared)
+{
+	zbx_uint64_t	max;
+
+	if (0 == shared)
+	{
+		if (value > *counter)
+			*counter = value;
+
+		return;
+	}
+
+	max = LOCK_PROF_LOAD(counter);
+
+	while (value > max && 0 == LOCK_PROF_CAS(counter, &max, value))
+		;
+}
+
+static void	lock_prof_add_wait(zbx_lock_counters_t *counters, zbx_uint64_t wait, int contended, int shared)
+{
+	lock_prof_add(&counters->locked, 1, shared);
+	lock_prof_add(&counters->contended, (zbx_uint64_t)contended, shared);
+	lock_prof_add(&counters->wait, wait, shared);
+	lock_prof_max(&counters->wait_max, wait, shared);
+	lock_prof_add(&counters->wait_hist[lock_prof_bucket(wait)], 1, shared);
+}
+
+static void	lock_prof_add_hold(zbx_lock_counters_t *counters, zbx_uint64_t hold, int shared)
+{
+	lock_prof_add(&counters->hold, hold, shared);
+	lock_prof_max(&counters->hold_max, hold, shared);
+	lock_prof_add(&counters->hold_hist[lock_prof_bucket(hold)], 1, shared);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: acquire lock while recording wait time and call site              *
+ *                                                                            *
+ * Parameters: filename - [IN] source filename                                *
+ *             line     - [IN] source filename line number                    *
+ *             type     - [IN] the lock type (ZBX_LOCK_PROF_*)                *
+ *             lock     - [IN] the mutex or read-write lock                   *
+ *                                                                            *
+ * Return value: 0 on success, otherwise the locking function error code      *
+ *                                                                            *
+ * Comments: Try-lock is used first so that uncontended locking costs only    *
+ *           one clock reading.                                               *
+ *                                                                            *
+ *           The statistics are updated after acquiring the lock, so they     *
+ *           are protected by the profiled lock itself.                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	lock_prof_lock(const char *filename, int line, int type, void *lock)
+{
+	zbx_uint64_t		start, now, wait;
+	int			err, index, contended = 0, shared = (ZBX_LOCK_PROF_RDLOCK == type);
+	zbx_lock_stats_t	*stats;
+	zbx_lock_hold_t		*hold;
+
+	start = lock_prof_time();
+
+	switch (type)
+	{
+		case ZBX_LOCK_PROF_MUTEX:
+			if (EBUSY == (err = pthread_mutex_trylock((pthread_mutex_t *)lock)))
+			{
+				contended = 1;
+				err = pthread_mutex_lock((pthread_mutex_t *)lock);
+			}
+			break;
+		case ZBX_LOCK_PROF_WRLOCK:
+			if (EBUSY == (err = pthread_rwlock_trywrlock((pthread_rwlock_t *)lock)))
+			{
+				contended = 1;
+				err = pthread_rwlock_wrlock((pthread_rwlock_t *)lock);
+			}
+			break;
+		default:
+			if (EBUSY == (err = pthread_rwlock_tryrdlock((pthread_rwlock_t *)lock)))
+			{
+				contended = 1;
+				err = pthread_rwlock_rdlock((pthread_rwlock_t *)lock);
+			}
+	}
+
+	if (0 != err)
+		return err;
+
+	now = (0 != contended ? lock_prof_time() : start);
+	wait = now - start;
+
+	index = lock_prof_index(type, lock);
+	stats = &shared_lock->stats[index];
+	hold = &lock_holds[index];
+
+	hold->site = lock_prof_get_site(stats, filename, line);
+
+	lock_prof_add_wait(&stats->total, wait, contended, shared);
+
+	if (-1 != hold->site)
+		lock_prof_add_wait(&stats->sites[hold->site].counters, wait, contended, shared);
+
+	hold->acquired = now;
+	hold->type = type;
+	lock_holds_num++;
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: record hold time of a lock that is about to be unlocked           *
+ *                                                                            *
+ * Parameters: type - [IN] the lock type (ZBX_LOCK_PROF_MUTEX or              *
+ *                         ZBX_LOCK_PROF_WRLOCK for read-write locks)         *
+ *             lock - [IN] the mutex or read-write lock                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	lock_prof_unlock(int type, void *lock)
+{
+	int			index, shared;
+	zbx_uint64_t		time_hold;
+	zbx_lock_stats_t	*stats;
+	zbx_lock_hold_t		*hold;
+
+	index = lock_prof_index(type, lock);
+	hold = &lock_holds[index];
+
+	/* the lock was acquired before profiling was enabled */
+	if (0 == hold->acquired)
+		return;
+
+	time_hold = lock_prof_time() - hold->acquired;
+	stats = &shared_lock->stats[index];
+	shared = (ZBX_LOCK_PROF_RDLOCK == hold->type);
+
+	lock_prof_add_hold(&stats->total, time_hold, shared);
+
+	if (-1 != hold->site)
+		lock_prof_add_hold(&stats->sites[hold->site].counters, time_hold, shared);
+
+	hold->acquired = 0;
+	lock_holds_num--;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: acquire write lock for read-write lock (exclusive access)         *
@@ -274,7 +550,8 @@ void	__zbx_rwlock_wrlock(const char *filename, int line, zbx_rwlock_t rwlock)
 	if (0 != locks_disabled)
 		return;
 
-	if (0 != pthread_rwlock_wrlock(rwlock))
+	if (0 != (0 != shared_lock->prof_enabled ? lock_prof_lock(filename, line, ZBX_LOCK_PROF_WRLOCK, rwlock) :
+			pthread_rwlock_wrlock(rwlock)))
 	{
 		zbx_error("[file:'%s',line:%d] write lock failed: %s", filename, line, zbx_strerror(errno));
 		exit(EXIT_FAILURE);
@@ -298,7 +575,8 @@ void	__zbx_rwlock_rdlock(const char *filename, int line, zbx_rwlock_t rwlock)
 	if (0 != locks_disabled)
 		return;
 
-	if (0 != pthread_rwlock_rdlock(rwlock))
+	if (0 != (0 != shared_lock->prof_enabled ? lock_prof_lock(filename, line, ZBX_LOCK_PROF_RDLOCK, rwlock) :
+			pthread_rwlock_rdlock(rwlock)))
 	{
 		zbx_error("[file:'%s',line:%d] read lock failed: %s", filename, line, zbx_strerror(errno));
 		exit(EXIT_FAILURE);
@@ -322,6 +600,9 @@ void	__zbx_rwlock_unlock(const char *filename, int line, zbx_rwlock_t rwlock)
 	if (0 != locks_disabled)
 		return;
 
+	if (0 != lock_holds_num)
+		lock_prof_unlock(ZBX_LOCK_PROF_WRLOCK, rwlock);
+
 	if (0 != pthread_rwlock_unlock(rwlock))
 	{
 		zbx_error("[file:'%s',line:%d] read-write lock unlock failed: %s", filename, line, zbx_strerror(errno));
@@ -367,6 +648,136 @@ void	zbx_locks_enable(void)
 }
 
 #endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reset lock profiling statistics and start collecting them         *
+ *                                                                            *
+ * Parameters: error - [OUT] the error message                                *
+ *                                                                            *
+ * Return value: SUCCEED - lock profiling was enabled                         *
+ *               FAIL    - lock profiling is not supported                    *
+ *                                                                            *
+ * Comments: The statistics of each lock are reset while holding that lock    *
+ *           exclusively, so no profiled holder can update them meanwhile.    *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_locks_prof_enable(char **error)
+{
+#if defined(HAVE_PTHREAD_PROCESS_SHARED) && defined(HAVE_ATOMIC_BUILTINS)
+	int	i;
+
+	ZBX_UNUSED(error);
+
+	for (i = 0; i < ZBX_MUTEX_COUNT; i++)
+	{
+		pthread_mutex_lock(&shared_lock->mutexes[i]);
+		memset(&shared_lock->stats[i], 0, sizeof(zbx_lock_stats_t));
+		pthread_mutex_unlock(&shared_lock->mutexes[i]);
+	}
+
+	for (i = 0; i < ZBX_RWLOCK_COUNT; i++)
+	{
+		pthread_rwlock_wrlock(&shared_lock->rwlocks[i]);
+		memset(&shared_lock->stats[ZBX_MUTEX_COUNT + i], 0, sizeof(zbx_lock_stats_t));
+		pthread_rwlock_unlock(&shared_lock->rwlocks[i]);
+	}
+
+	shared_lock->prof_enabled = 1;
+
+	return SUCCEED;
+#elif defined(HAVE_PTHREAD_PROCESS_SHARED)
+	*error = zbx_strdup(*error, "lock profiling is not supported without compiler atomic operations");
+
+	return FAIL;
+#else
+	*error = zbx_strdup(*error, "lock profiling is not supported without process shared pthread locks");
+
+	return FAIL;
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stop collecting lock profiling statistics                         *
+ *                                                                            *
+ * Comments: The collected statistics are kept until profiling is enabled     *
+ *           again.                                                           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_locks_prof_disable(void)
+{
+#ifdef HAVE_PTHREAD_PROCESS_SHARED
+	shared_lock->prof_enabled = 0;
+#endif
+}
+
+#ifdef HAVE_PTHREAD_PROCESS_SHARED
+static int	lock_prof_get(int index, zbx_lock_stats_t *stats)
+{
+	if (ZBX_MUTEX_COUNT > index)
+	{
+		pthread_mutex_lock(&shared_lock->mutexes[index]);
+		*stats = shared_lock->stats[index];
+		pthread_mutex_unlock(&shared_lock->mutexes[index]);
+	}
+	else
+	{
+		/* read lock holders might still update the counters while they are copied */
+		pthread_rwlock_wrlock(&shared_lock->rwlocks[index - ZBX_MUTEX_COUNT]);
+		*stats = shared_lock->stats[index];
+		pthread_rwlock_unlock(&shared_lock->rwlocks[index - ZBX_MUTEX_COUNT]);
+	}
+
+	return 0 != stats->total.locked ? SUCCEED : FAIL;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get mutex profiling statistics                                    *
+ *                                                                            *
+ * Parameters: mutex_name - [IN] the mutex                                    *
+ *             stats      - [OUT] the profiling statistics                    *
+ *                                                                            *
+ * Return value: SUCCEED - the statistics were returned                       *
+ *               FAIL    - no statistics were collected for the mutex         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_mutex_prof_get(zbx_mutex_name_t mutex_name, zbx_lock_stats_t *stats)
+{
+#ifdef HAVE_PTHREAD_PROCESS_SHARED
+	return lock_prof_get(mutex_name, stats);
+#else
+	ZBX_UNUSED(mutex_name);
+	ZBX_UNUSED(stats);
+
+	return FAIL;
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get read-write lock profiling statistics                          *
+ *                                                                            *
+ * Parameters: rwlock_name - [IN] the read-write lock                         *
+ *             stats       - [OUT] the profiling statistics                   *
+ *                                                                            *
+ * Return value: SUCCEED - the statistics were returned                       *
+ *               FAIL    - no statistics were collected for the lock          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_rwlock_prof_get(zbx_rwlock_name_t rwlock_name, zbx_lock_stats_t *stats)
+{
+#ifdef HAVE_PTHREAD_PROCESS_SHARED
+	return lock_prof_get(ZBX_MUTEX_COUNT + rwlock_name, stats);
+#else
+	ZBX_UNUSED(rwlock_name);
+	ZBX_UNUSED(stats);
+
+	return FAIL;
+#endif
+}
 #endif	/* _WINDOWS */
 
 /******************************************************************************
@@ -451,7 +862,8 @@ void	__zbx_mutex_lock(const char *filename, int line, zbx_mutex_t mutex)
 	if (0 != locks_disabled)
 		return;
 
-	if (0 != pthread_mutex_lock(mutex))
+	if (0 != (0 != shared_lock->prof_enabled ? lock_prof_lock(filename, line, ZBX_LOCK_PROF_MUTEX, mutex) :
+			pthread_mutex_lock(mutex)))
 	{
 		zbx_error("[file:'%s',line:%d] lock failed: %s", filename, line, zbx_strerror(errno));
 		exit(EXIT_FAILURE);
@@ -505,6 +917,9 @@ void	__zbx_mutex_unlock(const char *filename, int line, zbx_mutex_t mutex)
 	if (0 != locks_disabled)
 		return;
 
+	if (0 != lock_holds_num)
+		lock_prof_unlock(ZBX_LOCK_PROF_MUTEX, mutex);
+
 	if (0 != pthread_mutex_unlock(mutex))
 	{
 		zbx_error("[file:'%s',line:%d] unlock failed: %s", filename, line, zbx_strerror(errno));
@@ -124,43 +124,63 @@ int	zbx_item_preproc_convert_value_to_numeric(zbx_variant_t *value_num, const zb
 
 /******************************************************************************
  *                                                                            *
- * Purpose: execute custom multiplier preprocessing operation on variant      *
- *          value type                                                        *
+ * Purpose: multiply variant value by parsed multiplier                       *
  *                                                                            *
- * Parameters: value_type - [IN] item type                                    *
- *             value      - [IN/OUT] value to process                         *
- *             params     - [IN] operation parameters                         *
- *             errmsg     - [OUT]                                             *
+ * Parameters: value_type      - [IN] item type                               *
+ *             value           - [IN/OUT] value to process                    *
+ *             multiplier_dbl  - [IN] floating point multiplier               *
+ *             multiplier_ui64 - [IN] integer multiplier, NULL if multiplier  *
+ *                                    is not an unsigned integer              *
+ *             errmsg          - [OUT]                                        *
  *                                                                            *
  * Return value: SUCCEED - the preprocessing step finished successfully       *
  *               FAIL - otherwise, errmsg contains the error message          *
  *                                                                            *
+ * Comments: Numeric values of the item value type are multiplied in place    *
+ *           without intermediate conversions.                                *
+ *                                                                            *
  ******************************************************************************/
-int	item_preproc_multiplier_variant(unsigned char value_type, zbx_variant_t *value, const char *params,
-		char **errmsg)
+int	item_preproc_multiplier_num(unsigned char value_type, zbx_variant_t *value, double multiplier_dbl,
+		const zbx_uint64_t *multiplier_ui64, char **errmsg)
 {
-	zbx_uint64_t	multiplier_ui64, value_ui64;
-	double		value_dbl;
 	zbx_variant_t	value_num;
 
+	if (ZBX_VARIANT_DBL == value->type && ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		value->data.dbl *= multiplier_dbl;
+		return SUCCEED;
+	}
+
+	if (ZBX_VARIANT_UI64 == value->type && ITEM_VALUE_TYPE_UINT64 == value_type)
+	{
+		if (NULL != multiplier_ui64)
+			value->data.ui64 *= *multiplier_ui64;
+		else
+			value->data.ui64 = (zbx_uint64_t)((double)value->data.ui64 * multiplier_dbl);
+
+		return SUCCEED;
+	}
+
 	if (FAIL == zbx_item_preproc_convert_value_to_numeric(&value_num, value, value_type, errmsg))
 		return FAIL;
 
+	zbx_variant_clear(value);
+
 	switch (value_num.type)
 	{
 		case ZBX_VARIANT_DBL:
-			value_dbl = value_num.data.dbl * atof(params);
-			zbx_variant_clear(value);
-			zbx_variant_set_dbl(value, value_dbl);
+			zbx_variant_set_dbl(value, value_num.data.dbl * multiplier_dbl);
 			break;
 		case ZBX_VARIANT_UI64:
-			if (SUCCEED == zbx_is_uint64(params, &multiplier_ui64))
-				value_ui64 = value_num.data.ui64 * multiplier_ui64;
+			if (NULL != multiplier_ui64)
+			{
+				zbx_variant_set_ui64(value, value_num.data.ui64 * *multiplier_ui64);
+			}
 			else
-				value_ui64 = (zbx_uint64_t)((double)value_num.data.ui64 * atof(params));
-
-			zbx_variant_clear(value);
-			zbx_variant_set_ui64(value, value_ui64);
+			{
+				zbx_variant_set_ui64(value, (zbx_uint64_t)((double)value_num.data.ui64 *
+						multiplier_dbl));
+			}
 			break;
 	}
 
@@ -169,6 +189,29 @@ int	item_preproc_multiplier_variant(unsigned char value_type, zbx_variant_t *val
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute custom multiplier preprocessing operation on variant      *
+ *          value type                                                        *
+ *                                                                            *
+ * Parameters: value_type - [IN] item type                                    *
+ *             value      - [IN/OUT] value to process                         *
+ *             params     - [IN] operation parameters                         *
+ *             errmsg     - [OUT]                                             *
+ *                                                                            *
+ * Return value: SUCCEED - the preprocessing step finished successfully       *
+ *               FAIL - otherwise, errmsg contains the error message          *
+ *                                                                            *
+ ******************************************************************************/
+int	item_preproc_multiplier_variant(unsigned char value_type, zbx_variant_t *value, const char *params,
+		char **errmsg)
+{
+	zbx_uint64_t	multiplier_ui64;
+
+	return item_preproc_multiplier_num(value_type, value, atof(params),
+			SUCCEED == zbx_is_uint64(params, &multiplier_ui64) ? &multiplier_ui64 : NULL, errmsg);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute delta type preprocessing operation                        *
@@ -581,10 +624,10 @@ int	item_preproc_2dec(zbx_variant_t *value, int op_type, char **errmsg)
  ******************************************************************************/
 int	item_preproc_regsub_op(zbx_variant_t *value, const char *params, char **errmsg)
 {
-	char		*pattern, *output, *new_value = NULL;
-	char		*regex_error = NULL;
-	zbx_regexp_t	*regex = NULL;
-	int		ret = FAIL;
+	char			*pattern, *output, *new_value = NULL;
+	char			*regex_error = NULL;
+	const zbx_regexp_t	*regex;
+	int			ret = FAIL;
 
 	if (FAIL == item_preproc_convert_value(value, ZBX_VARIANT_STR, errmsg))
 		return FAIL;
@@ -599,7 +642,8 @@ int	item_preproc_regsub_op(zbx_variant_t *value, const char *params, char **errm
 
 	*output++ = '\0';
 
-	if (FAIL == zbx_regexp_compile_ext(pattern, &regex, 0, &regex_error))	/* PCRE_MULTILINE is not used here */
+	/* PCRE_MULTILINE is not used here */
+	if (FAIL == zbx_regexp_compile_ext_cached(pattern, &regex, 0, &regex_error))
 	{
 		*errmsg = zbx_dsprintf(*errmsg, "invalid regular expression: %s", regex_error);
 		zbx_free(regex_error);
@@ -617,9 +661,6 @@ int	item_preproc_regsub_op(zbx_variant_t *value, const char *params, char **errm
 
 	ret = SUCCEED;
 out:
-	if (NULL != regex)
-		zbx_regexp_free(regex);
-
 	zbx_free(pattern);
 
 	return ret;
@@ -719,11 +760,11 @@ out:
  ******************************************************************************/
 int	item_preproc_validate_regex(const zbx_variant_t *value, const char *params, char **error)
 {
-	zbx_variant_t	value_str;
-	int		ret = FAIL;
-	zbx_regexp_t	*regex;
-	char		*errptr = NULL;
-	char		*errmsg;
+	zbx_variant_t		value_str;
+	int			ret = FAIL;
+	const zbx_regexp_t	*regex;
+	char			*errptr = NULL;
+	char			*errmsg;
 
 	zbx_variant_copy(&value_str, value);
 
@@ -733,7 +774,7 @@ int	item_preproc_validate_regex(const zbx_variant_t *value, const char *params,
 		goto out;
 	}
 
-	if (FAIL == zbx_regexp_compile(params, &regex, &errptr))
+	if (FAIL == zbx_regexp_compile_cached(params, &regex, &errptr))
 	{
 		errmsg = zbx_dsprintf(NULL, "invalid regular expression pattern: %s", errptr);
 		zbx_free(errptr);
@@ -744,8 +785,6 @@ int	item_preproc_validate_regex(const zbx_variant_t *value, const char *params,
 		errmsg = zbx_strdup(NULL, "value does not match regular expression");
 	else
 		ret = SUCCEED;
-
-	zbx_regexp_free(regex);
 out:
 	zbx_variant_clear(&value_str);
 
@@ -774,11 +813,11 @@ out:
  ******************************************************************************/
 int	item_preproc_validate_not_regex(const zbx_variant_t *value, const char *params, char **error)
 {
-	zbx_variant_t	value_str;
-	int		ret = FAIL;
-	zbx_regexp_t	*regex;
-	char		*errptr = NULL;
-	char		*errmsg;
+	zbx_variant_t		value_str;
+	int			ret = FAIL;
+	const zbx_regexp_t	*regex;
+	char			*errptr = NULL;
+	char			*errmsg;
 
 	zbx_variant_copy(&value_str, value);
 
@@ -788,7 +827,7 @@ int	item_preproc_validate_not_regex(const zbx_variant_t *value, const char *para
 		goto out;
 	}
 
-	if (FAIL == zbx_regexp_compile(params, &regex, &errptr))
+	if (FAIL == zbx_regexp_compile_cached(params, &regex, &errptr))
 	{
 		errmsg = zbx_dsprintf(NULL, "invalid regular expression pattern: %s", errptr);
 		zbx_free(errptr);
@@ -801,8 +840,6 @@ int	item_preproc_validate_not_regex(const zbx_variant_t *value, const char *para
 	}
 	else
 		ret = SUCCEED;
-
-	zbx_regexp_free(regex);
 out:
 	zbx_variant_clear(&value_str);
 
@@ -1052,10 +1089,10 @@ int	item_preproc_check_error_regex(const zbx_variant_t *value, const char *param
 {
 #define ZBX_PP_MATCH_TYPE_MATCHES	0
 #define ZBX_PP_MATCH_TYPE_ANY		-1
-	zbx_variant_t	value_str;
-	int		ret = SUCCEED, match_type = ZBX_PP_MATCH_TYPE_ANY;
-	char		*pattern = NULL, *newline, *out = NULL, *errptr = NULL;
-	zbx_regexp_t	*regex;
+	zbx_variant_t		value_str;
+	int			ret = SUCCEED, match_type = ZBX_PP_MATCH_TYPE_ANY;
+	char			*pattern = NULL, *newline, *out = NULL, *errptr = NULL;
+	const zbx_regexp_t	*regex;
 
 	zbx_variant_copy(&value_str, value);
 
@@ -1071,7 +1108,7 @@ int	item_preproc_check_error_regex(const zbx_variant_t *value, const char *param
 
 	if (ZBX_PP_MATCH_TYPE_MATCHES == match_type)
 	{
-		if (FAIL == zbx_regexp_compile_ext(pattern, &regex, 0, &errptr))
+		if (FAIL == zbx_regexp_compile_ext_cached(pattern, &regex, 0, &errptr))
 		{
 			*error = zbx_dsprintf(*error, "invalid regular expression: %s", errptr);
 			zbx_free(errptr);
@@ -1094,7 +1131,7 @@ int	item_preproc_check_error_regex(const zbx_variant_t *value, const char *param
 	{
 		int	res;
 
-		if (FAIL == zbx_regexp_compile(pattern, &regex, &errptr))
+		if (FAIL == zbx_regexp_compile_cached(pattern, &regex, &errptr))
 		{
 			*error = zbx_dsprintf(*error, "invalid regular expression: %s", errptr);
 			zbx_free(errptr);
@@ -1114,8 +1151,6 @@ int	item_preproc_check_error_regex(const zbx_variant_t *value, const char *param
 			ret = FAIL;
 		}
 	}
-
-	zbx_regexp_free(regex);
 out:
 	zbx_free(pattern);
 	zbx_variant_clear(&value_str);
@@ -1176,7 +1211,7 @@ int	item_preproc_throttle_value(zbx_variant_t *value, const zbx_timespec_t *ts,
 int	item_preproc_throttle_timed_value(zbx_variant_t *value, const zbx_timespec_t *ts, const char *params,
 		zbx_variant_t *history_value, zbx_timespec_t *history_ts, char **errmsg)
 {
-	int	ret, timeout, period = 0;
+	int	timeout;
 
 	if (FAIL == zbx_is_time_suffix(params, &timeout, (int)strlen(params)))
 	{
@@ -1185,6 +1220,29 @@ int	item_preproc_throttle_timed_value(zbx_variant_t *value, const zbx_timespec_t
 		return FAIL;
 	}
 
+	return item_preproc_throttle_timed_period(value, ts, timeout, history_value, history_ts);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: throttles value by suppressing identical values within the        *
+ *          specified period                                                  *
+ *                                                                            *
+ * Parameters: value         - [IN/OUT] value to process                      *
+ *             ts            - [IN] value timestamp                           *
+ *             timeout       - [IN] throttle period in seconds                *
+ *             history_value - [IN] historical data of item with delta        *
+ *                                  preprocessing operation                   *
+ *             history_ts    - [IN/OUT] timestamp of historical data          *
+ *                                                                            *
+ * Return value: SUCCEED - the value was calculated successfully              *
+ *                                                                            *
+ ******************************************************************************/
+int	item_preproc_throttle_timed_period(zbx_variant_t *value, const zbx_timespec_t *ts, int timeout,
+		zbx_variant_t *history_value, zbx_timespec_t *history_ts)
+{
+	int	ret, period = 0;
+
 	ret = zbx_variant_compare(value, history_value);
 
 	zbx_variant_clear(history_value);
@@ -28,6 +28,8 @@ int	zbx_item_preproc_convert_value_to_numeric(zbx_variant_t *value_num, const zb
 
 int	item_preproc_convert_value(zbx_variant_t *value, unsigned char type, char **errmsg);
 
+int	item_preproc_multiplier_num(unsigned char value_type, zbx_variant_t *value, double multiplier_dbl,
+		const zbx_uint64_t *multiplier_ui64, char **errmsg);
 int	item_preproc_multiplier_variant(unsigned char value_type, zbx_variant_t *value, const char *params,
 		char **errmsg);
 int	item_preproc_trim(zbx_variant_t *value, int op_type, const char *params, char **errmsg);
@@ -46,6 +48,8 @@ int	item_preproc_throttle_value(zbx_variant_t *value, const zbx_timespec_t *ts,
 		zbx_variant_t *history_value, zbx_timespec_t *history_ts);
 int	item_preproc_throttle_timed_value(zbx_variant_t *value, const zbx_timespec_t *ts, const char *params,
 		zbx_variant_t *history_value, zbx_timespec_t *history_ts, char **errmsg);
+int	item_preproc_throttle_timed_period(zbx_variant_t *value, const zbx_timespec_t *ts, int timeout,
+		zbx_variant_t *history_value, zbx_timespec_t *history_ts);
 int	item_preproc_script(zbx_es_t *es, zbx_variant_t *value, const char *params, zbx_variant_t *bytecode,
 		const char *config_source_ip, char **errmsg);
 int	item_preproc_csv_to_json(zbx_variant_t *value, const char *params, char **errmsg);
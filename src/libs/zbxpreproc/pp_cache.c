@@ -58,10 +58,37 @@ zbx_pp_cache_t	*pp_cache_create(const zbx_pp_item_preproc_t *preproc, const zbx_
 	cache->data = NULL;
 	cache->refcount = 1;
 	cache->error = NULL;
+	cache->jsonpaths = NULL;
 
 	return cache;
 }
 
+static void	pp_cache_jsonpath_result_clear(void *d)
+{
+	zbx_pp_cache_jsonpath_result_t	*result = (zbx_pp_cache_jsonpath_result_t *)d;
+
+	zbx_free(result->path);
+	zbx_free(result->output);
+	zbx_free(result->error);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free jsonpath cache data                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_cache_jsonpath_free(zbx_pp_cache_jsonpath_t *index)
+{
+	zbx_jsonobj_clear(&index->obj);
+	zbx_jsonpath_index_free(index->index);
+
+	if (NULL != index->results)
+	{
+		zbx_hashset_destroy(index->results);
+		zbx_free(index->results);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: free preprocessing cache                                          *
@@ -76,8 +103,7 @@ static void	pp_cache_free(zbx_pp_cache_t *cache)
 		switch (cache->type)
 		{
 			case ZBX_PREPROC_JSONPATH:
-				zbx_jsonobj_clear(&((zbx_pp_cache_jsonpath_t *)cache->data)->obj);
-				zbx_jsonpath_index_free(((zbx_pp_cache_jsonpath_t *)cache->data)->index);
+				pp_cache_jsonpath_free((zbx_pp_cache_jsonpath_t *)cache->data);
 				break;
 			case ZBX_PREPROC_PROMETHEUS_PATTERN:
 				zbx_prometheus_clear((zbx_prometheus_t *)cache->data);
@@ -90,6 +116,13 @@ static void	pp_cache_free(zbx_pp_cache_t *cache)
 		zbx_free(cache->data);
 	}
 
+	if (NULL != cache->jsonpaths)
+	{
+		zbx_vector_str_clear_ext(cache->jsonpaths, zbx_str_free);
+		zbx_vector_str_destroy(cache->jsonpaths);
+		zbx_free(cache->jsonpaths);
+	}
+
 	zbx_free(cache->error);
 	zbx_free(cache);
 }
@@ -124,6 +157,104 @@ zbx_pp_cache_t	*pp_cache_copy(zbx_pp_cache_t *cache)
 	return cache;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: set jsonpaths to be queried together when jsonpath cache is       *
+ *          initialized                                                       *
+ *                                                                            *
+ * Parameters: cache     - [IN] preprocessing cache                           *
+ *             jsonpaths - [IN] jsonpaths of dependent items, the vector is   *
+ *                              owned by cache afterwards                     *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_cache_add_jsonpaths(zbx_pp_cache_t *cache, zbx_vector_str_t *jsonpaths)
+{
+	cache->jsonpaths = jsonpaths;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: query jsonpaths of dependent items in one pass over the cached    *
+ *          json object                                                       *
+ *                                                                            *
+ * Parameters: cache - [IN] preprocessing cache                               *
+ *             index - [IN/OUT] initialized jsonpath cache data               *
+ *                                                                            *
+ * Comments: This function is called by the worker initializing the cache,    *
+ *           before the cache is shared with other workers.                   *
+ *                                                                            *
+ ******************************************************************************/
+void	pp_cache_query_jsonpaths(zbx_pp_cache_t *cache, zbx_pp_cache_jsonpath_t *index)
+{
+	zbx_jsonobj_query_t	*queries;
+	int			queries_num;
+
+	index->results = NULL;
+
+	if (NULL == cache->jsonpaths)
+		return;
+
+	queries_num = cache->jsonpaths->values_num;
+	queries = (zbx_jsonobj_query_t *)zbx_malloc(NULL, sizeof(zbx_jsonobj_query_t) * (size_t)queries_num);
+
+	for (int i = 0; i < queries_num; i++)
+		queries[i].path = cache->jsonpaths->values[i];
+
+	zbx_jsonobj_query_batch(&index->obj, index->index, queries, queries_num);
+
+	index->results = (zbx_hashset_t *)zbx_malloc(NULL, sizeof(zbx_hashset_t));
+	zbx_hashset_create_ext(index->results, (size_t)queries_num, ZBX_DEFAULT_STRING_PTR_HASH_FUNC,
+			ZBX_DEFAULT_STR_COMPARE_FUNC, pp_cache_jsonpath_result_clear, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	for (int i = 0; i < queries_num; i++)
+	{
+		zbx_pp_cache_jsonpath_result_t	result_local;
+
+		result_local.path = cache->jsonpaths->values[i];
+		result_local.output = queries[i].output;
+		result_local.error = queries[i].error;
+
+		if (NULL != zbx_hashset_search(index->results, &result_local))
+		{
+			pp_cache_jsonpath_result_clear(&result_local);
+			continue;
+		}
+
+		zbx_hashset_insert(index->results, &result_local, sizeof(result_local));
+	}
+
+	zbx_free(queries);
+
+	/* the path strings are owned by the results now */
+	zbx_vector_str_destroy(cache->jsonpaths);
+	zbx_free(cache->jsonpaths);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get jsonpath result extracted in advance                          *
+ *                                                                            *
+ * Parameters: index - [IN] jsonpath cache data                               *
+ *             path  - [IN] jsonpath                                          *
+ *                                                                            *
+ * Return value: The jsonpath result or NULL if the path was not queried in   *
+ *               advance.                                                     *
+ *                                                                            *
+ ******************************************************************************/
+const zbx_pp_cache_jsonpath_result_t	*pp_cache_get_jsonpath_result(const zbx_pp_cache_jsonpath_t *index,
+		const char *path)
+{
+	zbx_pp_cache_jsonpath_result_t	result_local;
+
+	if (NULL == index->results)
+		return NULL;
+
+	result_local.path = (char *)path;
+
+	return (const zbx_pp_cache_jsonpath_result_t *)zbx_hashset_search(index->results, &result_local);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: copy original value from cache if needed                          *
@@ -23,20 +23,32 @@
 #include "zbxpreproc.h"
 #include "zbxvariant.h"
 
+/* jsonpath query result extracted in advance for dependent item */
+typedef struct
+{
+	char	*path;
+	char	*output;
+	char	*error;
+}
+zbx_pp_cache_jsonpath_result_t;
+
 typedef struct
 {
 	zbx_jsonobj_t		obj;
 	zbx_jsonpath_index_t	*index;
+	zbx_hashset_t		*results;	/* results of dependent item jsonpaths, optional */
 }
 zbx_pp_cache_jsonpath_t;
 
 typedef struct
 {
-	zbx_uint32_t	refcount;
-	zbx_variant_t	value;
-	int		type;
-	void		*data;
-	char		*error;
+	zbx_uint32_t		refcount;
+	zbx_variant_t		value;
+	int			type;
+	void			*data;
+	char			*error;
+	zbx_vector_str_t	*jsonpaths;	/* jsonpaths to query together when the cache is */
+						/* initialized, optional                         */
 }
 zbx_pp_cache_t;
 
@@ -44,6 +56,11 @@ zbx_pp_cache_t	*pp_cache_create(const zbx_pp_item_preproc_t *preproc, const zbx_
 void		pp_cache_release(zbx_pp_cache_t *cache);
 zbx_pp_cache_t	*pp_cache_copy(zbx_pp_cache_t *cache);
 
+void	pp_cache_add_jsonpaths(zbx_pp_cache_t *cache, zbx_vector_str_t *jsonpaths);
+void	pp_cache_query_jsonpaths(zbx_pp_cache_t *cache, zbx_pp_cache_jsonpath_t *index);
+const zbx_pp_cache_jsonpath_result_t	*pp_cache_get_jsonpath_result(const zbx_pp_cache_jsonpath_t *index,
+		const char *path);
+
 void	pp_cache_prepare_output_value(zbx_pp_cache_t *cache, int step_type, zbx_variant_t *value);
 int	pp_cache_is_supported(zbx_pp_item_preproc_t *preproc);
 
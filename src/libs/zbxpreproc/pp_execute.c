@@ -77,6 +77,40 @@ static int	pp_execute_multiply(unsigned char value_type, zbx_variant_t *value, c
 	return FAIL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute 'multiply by' step with parsed multiplier                 *
+ *                                                                            *
+ * Parameters: value_type - [IN] item value type                              *
+ *             value      - [IN/OUT] input/output value                       *
+ *             params     - [IN] preprocessing parameters                     *
+ *             compiled   - [IN] parsed preprocessing parameters              *
+ *                                                                            *
+ * Result value: SUCCEED - the preprocessing step was executed successfully.  *
+ *               FAIL    - otherwise. The error message is stored in value.   *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_execute_multiply_compiled(unsigned char value_type, zbx_variant_t *value, const char *params,
+		const zbx_pp_step_compiled_t *compiled)
+{
+	char	*errmsg = NULL, *error;
+
+	if (SUCCEED == item_preproc_multiplier_num(value_type, value, compiled->arg1.data.dbl,
+			ZBX_VARIANT_UI64 == compiled->arg2.type ? &compiled->arg2.data.ui64 : NULL, &errmsg))
+	{
+		return SUCCEED;
+	}
+
+	error = zbx_dsprintf(NULL, "cannot apply multiplier \"%s\" to value of type \"%s\": %s", params,
+			zbx_variant_type_desc(value), errmsg);
+	zbx_free(errmsg);
+
+	zbx_variant_clear(value);
+	zbx_variant_set_error(value, error);
+
+	return FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: return preprocessing 'trim' step descriptions for error messages  *
@@ -274,7 +308,8 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
 	}
 	else
 	{
-		zbx_pp_cache_jsonpath_t	*index;
+		zbx_pp_cache_jsonpath_t			*index;
+		const zbx_pp_cache_jsonpath_result_t	*result;
 
 		if (NULL != cache->error)
 		{
@@ -305,10 +340,22 @@ static int	pp_excute_jsonpath_query(zbx_pp_cache_t *cache, zbx_variant_t *value,
 				return FAIL;
 			}
 
+			pp_cache_query_jsonpaths(cache, index);
 			cache->data = (void *)index;
 		}
 
-		if (FAIL == zbx_jsonobj_query_ext(&index->obj, index->index, params, &data))
+		if (NULL != (result = pp_cache_get_jsonpath_result(index, params)))
+		{
+			if (NULL != result->error)
+			{
+				*errmsg = zbx_strdup(*errmsg, result->error);
+				return FAIL;
+			}
+
+			if (NULL != result->output)
+				data = zbx_strdup(NULL, result->output);
+		}
+		else if (FAIL == zbx_jsonobj_query_ext(&index->obj, index->index, params, &data))
 		{
 			*errmsg = zbx_strdup(*errmsg, zbx_json_strerror());
 			return FAIL;
@@ -482,6 +529,49 @@ static int	pp_validate_range(unsigned char value_type, zbx_variant_t *value, con
 	return FAIL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute 'validate range' step with parsed range                   *
+ *                                                                            *
+ * Parameters: value_type - [IN] item value type                              *
+ *             value      - [IN/OUT] value to process                         *
+ *             params     - [IN] step parameters                              *
+ *             compiled   - [IN] parsed step parameters                       *
+ *                                                                            *
+ * Result value: SUCCEED - the preprocessing step was executed successfully.  *
+ *               FAIL    - otherwise. The error message is stored in value.   *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_validate_range_compiled(unsigned char value_type, zbx_variant_t *value, const char *params,
+		const zbx_pp_step_compiled_t *compiled)
+{
+	zbx_variant_t	value_num;
+	char		*errmsg = NULL;
+	int		ret;
+
+	if (SUCCEED == zbx_item_preproc_convert_value_to_numeric(&value_num, value, value_type, &errmsg))
+	{
+		ret = SUCCEED;
+
+		if ((ZBX_VARIANT_NONE != compiled->arg1.type && 0 > zbx_variant_compare(&value_num, &compiled->arg1)) ||
+				(ZBX_VARIANT_NONE != compiled->arg2.type &&
+				0 > zbx_variant_compare(&compiled->arg2, &value_num)))
+		{
+			ret = FAIL;
+		}
+
+		zbx_variant_clear(&value_num);
+
+		if (SUCCEED == ret)
+			return SUCCEED;
+	}
+
+	zbx_free(errmsg);
+
+	/* use the generic implementation to format the error message */
+	return pp_validate_range(value_type, value, params);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute 'validate regex' step                                     *
@@ -642,6 +732,47 @@ static int	pp_throttle_timed_value(zbx_variant_t *value, zbx_timespec_t ts, cons
 	return FAIL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute preprocessing steps with parsed parameters                *
+ *                                                                            *
+ * Parameters: value_type    - [IN] item value type                           *
+ *             value         - [IN/OUT] input/output value                    *
+ *             ts            - [IN] value timestamp                           *
+ *             step          - [IN] step to execute                           *
+ *             compiled      - [IN] parsed step parameters                    *
+ *             history_value - [IN/OUT] last value                            *
+ *             history_ts    - [IN/OUT] last value timestamp                  *
+ *             ret           - [OUT] step execution result                    *
+ *                                                                            *
+ * Result value: SUCCEED - the step was executed                              *
+ *               FAIL    - the step has no specialized implementation         *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_execute_step_compiled(unsigned char value_type, zbx_variant_t *value, zbx_timespec_t ts,
+		const zbx_pp_step_t *step, const zbx_pp_step_compiled_t *compiled, zbx_variant_t *history_value,
+		zbx_timespec_t *history_ts, int *ret)
+{
+	if (0 == (compiled->flags & ZBX_PP_STEP_COMPILED_ARGS))
+		return FAIL;
+
+	switch (step->type)
+	{
+		case ZBX_PREPROC_MULTIPLIER:
+			*ret = pp_execute_multiply_compiled(value_type, value, step->params, compiled);
+			return SUCCEED;
+		case ZBX_PREPROC_VALIDATE_RANGE:
+			*ret = pp_validate_range_compiled(value_type, value, step->params, compiled);
+			return SUCCEED;
+		case ZBX_PREPROC_THROTTLE_TIMED_VALUE:
+			*ret = item_preproc_throttle_timed_period(value, &ts, (int)compiled->arg1.data.ui64,
+					history_value, history_ts);
+			return SUCCEED;
+		default:
+			return FAIL;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute 'script' step                                             *
@@ -1039,6 +1170,7 @@ static int	pp_execute_snmp_get_to_value(zbx_variant_t *value, const char *params
  *             value            - [IN/OUT] input/output value                 *
  *             ts               - [IN] value timestamp                        *
  *             step             - [IN/OUT] step to execute                    *
+ *             compiled         - [IN] parsed step parameters (optional)      *
  *             history_value    - [IN/OUT] last value                         *
  *             history_ts       - [IN/OUT] last value timestamp               *
  *             config_source_ip - [IN]                                        *
@@ -1047,30 +1179,47 @@ static int	pp_execute_snmp_get_to_value(zbx_variant_t *value, const char *params
  *               FAIL    - otherwise. The error message is stored in value.   *
  *                                                                            *
  ******************************************************************************/
-int	pp_execute_step(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_dc_um_shared_handle_t *um_handle,
+static int	pp_execute_step_ext(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_dc_um_shared_handle_t *um_handle,
 		zbx_uint64_t hostid, unsigned char value_type, zbx_variant_t *value, zbx_timespec_t ts,
-		zbx_pp_step_t *step, zbx_variant_t *history_value, zbx_timespec_t *history_ts,
-		const char *config_source_ip)
+		zbx_pp_step_t *step, const zbx_pp_step_compiled_t *compiled, zbx_variant_t *history_value,
+		zbx_timespec_t *history_ts, const char *config_source_ip)
 {
-	int	ret;
-	char	*params = NULL;
+	int		ret;
+	char		*params_dyn = NULL;
+	const char	*params;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() step:%d params:'%s' value:'%s' cache:%p", __func__,
 			step->type, step->params, zbx_variant_value_desc(value), (void *)cache);
 
-	params = zbx_strdup(NULL, step->params);
+	if (NULL != compiled && 0 != (compiled->flags & ZBX_PP_STEP_COMPILED_STATIC))
+	{
+		if (SUCCEED == pp_execute_step_compiled(value_type, value, ts, step, compiled, history_value,
+				history_ts, &ret))
+		{
+			goto out;
+		}
 
-	if (NULL != um_handle)
+		params = step->params;
+	}
+	else
 	{
-		char	*error = NULL;
-		unsigned char	env = ZBX_PREPROC_SCRIPT == step->type ? ZBX_MACRO_ENV_SECURE : ZBX_MACRO_ENV_NONSECURE;
+		params_dyn = zbx_strdup(NULL, step->params);
 
-		if (SUCCEED != zbx_dc_expand_user_macros_from_cache(um_handle->um_cache, &params, &hostid, 1, env,
-				&error))
+		if (NULL != um_handle)
 		{
-			zabbix_log(LOG_LEVEL_DEBUG, "cannot resolve user macros: %s", error);
-			zbx_free(error);
+			char		*error = NULL;
+			unsigned char	env = ZBX_PREPROC_SCRIPT == step->type ? ZBX_MACRO_ENV_SECURE :
+					ZBX_MACRO_ENV_NONSECURE;
+
+			if (SUCCEED != zbx_dc_expand_user_macros_from_cache(um_handle->um_cache, &params_dyn, &hostid,
+					1, env, &error))
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "cannot resolve user macros: %s", error);
+				zbx_free(error);
+			}
 		}
+
+		params = params_dyn;
 	}
 
 	switch (step->type)
@@ -1161,7 +1310,7 @@ int	pp_execute_step(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_dc_um_shar
 			ret = FAIL;
 		}
 out:
-	zbx_free(params);
+	zbx_free(params_dyn);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() ret:%s value:%s", __func__, zbx_result_string(ret),
 			zbx_variant_value_desc(value));
@@ -1169,6 +1318,35 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: execute preprocessing step                                        *
+ *                                                                            *
+ * Parameters: ctx              - [IN] worker specific execution context      *
+ *             cache            - [IN] preprocessing cache                    *
+ *             um_handle        - [IN] shared user macro cache handle         *
+ *             hostid           - [IN] item host identifier                   *
+ *             value_type       - [IN] item value type                        *
+ *             value            - [IN/OUT] input/output value                 *
+ *             ts               - [IN] value timestamp                        *
+ *             step             - [IN/OUT] step to execute                    *
+ *             history_value    - [IN/OUT] last value                         *
+ *             history_ts       - [IN/OUT] last value timestamp               *
+ *             config_source_ip - [IN]                                        *
+ *                                                                            *
+ * Result value: SUCCEED - the preprocessing step was executed successfully.  *
+ *               FAIL    - otherwise. The error message is stored in value.   *
+ *                                                                            *
+ ******************************************************************************/
+int	pp_execute_step(zbx_pp_context_t *ctx, zbx_pp_cache_t *cache, zbx_dc_um_shared_handle_t *um_handle,
+		zbx_uint64_t hostid, unsigned char value_type, zbx_variant_t *value, zbx_timespec_t ts,
+		zbx_pp_step_t *step, zbx_variant_t *history_value, zbx_timespec_t *history_ts,
+		const char *config_source_ip)
+{
+	return pp_execute_step_ext(ctx, cache, um_handle, hostid, value_type, value, ts, step, NULL, history_value,
+			history_ts, config_source_ip);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute preprocessing steps                                       *
@@ -1228,8 +1406,9 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 
 	for (int i = 0; i < preproc->steps_num; i++)
 	{
-		zbx_variant_t	history_value;
-		zbx_timespec_t	history_ts;
+		zbx_variant_t			history_value;
+		zbx_timespec_t			history_ts;
+		const zbx_pp_step_compiled_t	*compiled = (NULL != preproc->compiled ? preproc->compiled + i : NULL);
 
 		if (ZBX_VARIANT_ERR == value_out->type && ZBX_PREPROC_VALIDATE_NOT_SUPPORTED != preproc->steps[i].type)
 			break;
@@ -1239,8 +1418,9 @@ void	pp_execute(zbx_pp_context_t *ctx, zbx_pp_item_preproc_t *preproc, zbx_pp_ca
 
 		zbx_pp_history_pop(preproc->history, i, &history_value, &history_ts);
 
-		if (SUCCEED != pp_execute_step(ctx, cache, um_handle, preproc->hostid, preproc->value_type, value_out,
-				ts, preproc->steps + i, &history_value, &history_ts, config_source_ip))
+		if (SUCCEED != pp_execute_step_ext(ctx, cache, um_handle, preproc->hostid, preproc->value_type,
+				value_out, ts, preproc->steps + i, compiled, &history_value, &history_ts,
+				config_source_ip))
 		{
 			zbx_variant_copy(&value_raw, value_out);
 			if (ZBX_PREPROC_FAIL_DEFAULT == (action = pp_error_on_fail(value_out, preproc->steps + i)))
@@ -18,6 +18,8 @@
 **/
 
 #include "zbxpreprocbase.h"
+#include "zbxnum.h"
+#include "zbxstr.h"
 
 ZBX_PTR_VECTOR_IMPL(pp_step_ptr, zbx_pp_step_t *)
 
@@ -41,6 +43,7 @@ zbx_pp_item_preproc_t	*zbx_pp_item_preproc_create(zbx_uint64_t hostid, unsigned
 	preproc->refcount = 1;
 	preproc->steps_num = 0;
 	preproc->steps = NULL;
+	preproc->compiled = NULL;
 	preproc->dep_itemids_num = 0;
 	preproc->dep_itemids = NULL;
 
@@ -75,9 +78,16 @@ static void	pp_item_preproc_free(zbx_pp_item_preproc_t *preproc)
 	{
 		zbx_free(preproc->steps[i].params);
 		zbx_free(preproc->steps[i].error_handler_params);
+
+		if (NULL != preproc->compiled)
+		{
+			zbx_variant_clear(&preproc->compiled[i].arg1);
+			zbx_variant_clear(&preproc->compiled[i].arg2);
+		}
 	}
 
 	zbx_free(preproc->steps);
+	zbx_free(preproc->compiled);
 	zbx_free(preproc->dep_itemids);
 
 	if (NULL != preproc->history)
@@ -120,6 +130,140 @@ void	zbx_pp_item_preproc_release(zbx_pp_item_preproc_t *preproc)
 	pp_item_preproc_free(preproc);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse 'multiply by' step parameters                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_step_compile_multiplier(const char *params, zbx_pp_step_compiled_t *compiled)
+{
+	char		buffer[MAX_STRING_LEN];
+	zbx_uint64_t	multiplier_ui64;
+
+	zbx_strlcpy(buffer, params, sizeof(buffer));
+	zbx_trim_float(buffer);
+
+	if (FAIL == zbx_is_double(buffer, NULL))
+		return FAIL;
+
+	zbx_variant_set_dbl(&compiled->arg1, atof(buffer));
+
+	if (SUCCEED == zbx_is_uint64(buffer, &multiplier_ui64))
+		zbx_variant_set_ui64(&compiled->arg2, multiplier_ui64);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse 'validate range' step parameters                            *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_step_compile_range(const char *params, zbx_pp_step_compiled_t *compiled)
+{
+	char	*min, *max;
+	int	ret = FAIL;
+
+	min = zbx_strdup(NULL, params);
+
+	if (NULL == (max = strchr(min, '\n')))
+		goto out;
+
+	*max++ = '\0';
+
+	if ('\0' != *min && FAIL == zbx_variant_set_numeric(&compiled->arg1, min))
+		goto out;
+
+	if ('\0' != *max && FAIL == zbx_variant_set_numeric(&compiled->arg2, max))
+		goto out;
+
+	ret = SUCCEED;
+out:
+	zbx_free(min);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse 'throttle with timeout' step parameters                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_step_compile_period(const char *params, zbx_pp_step_compiled_t *compiled)
+{
+	int	period;
+
+	if (FAIL == zbx_is_time_suffix(params, &period, (int)strlen(params)))
+		return FAIL;
+
+	zbx_variant_set_ui64(&compiled->arg1, (zbx_uint64_t)period);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse preprocessing step parameters in advance, so the numeric    *
+ *          steps can be executed without parsing parameters for each value   *
+ *                                                                            *
+ * Parameters: preproc - [IN/OUT] item preprocessing data                     *
+ *                                                                            *
+ * Comments: Parameters containing user macros are left for runtime           *
+ *           processing as macro values are resolved for each value.          *
+ *           Invalid parameters are also left for runtime processing to       *
+ *           report the error in the usual way.                               *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_pp_item_preproc_compile(zbx_pp_item_preproc_t *preproc)
+{
+	if (0 == preproc->steps_num || NULL != preproc->compiled)
+		return;
+
+	preproc->compiled = (zbx_pp_step_compiled_t *)zbx_malloc(NULL,
+			sizeof(zbx_pp_step_compiled_t) * (size_t)preproc->steps_num);
+
+	for (int i = 0; i < preproc->steps_num; i++)
+	{
+		zbx_pp_step_t		*step = preproc->steps + i;
+		zbx_pp_step_compiled_t	*compiled = preproc->compiled + i;
+		int			ret;
+
+		compiled->flags = 0;
+		zbx_variant_set_none(&compiled->arg1);
+		zbx_variant_set_none(&compiled->arg2);
+
+		if (NULL == step->params || NULL != strstr(step->params, "{$"))
+			continue;
+
+		compiled->flags |= ZBX_PP_STEP_COMPILED_STATIC;
+
+		switch (step->type)
+		{
+			case ZBX_PREPROC_MULTIPLIER:
+				ret = pp_step_compile_multiplier(step->params, compiled);
+				break;
+			case ZBX_PREPROC_VALIDATE_RANGE:
+				ret = pp_step_compile_range(step->params, compiled);
+				break;
+			case ZBX_PREPROC_THROTTLE_TIMED_VALUE:
+				ret = pp_step_compile_period(step->params, compiled);
+				break;
+			default:
+				continue;
+		}
+
+		if (SUCCEED == ret)
+		{
+			compiled->flags |= ZBX_PP_STEP_COMPILED_ARGS;
+		}
+		else
+		{
+			zbx_variant_clear(&compiled->arg1);
+			zbx_variant_clear(&compiled->arg2);
+		}
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: check if preprocessing step requires history                      *
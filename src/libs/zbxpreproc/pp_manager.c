@@ -347,6 +347,63 @@ static zbx_pp_item_t	*pp_manager_get_cacheable_dependent_item(zbx_pp_manager_t *
 	return NULL;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: collect first step jsonpaths of dependent items, so they can be   *
+ *          queried in one pass when the jsonpath cache is initialized        *
+ *                                                                            *
+ * Parameters: manager - [IN]                                                 *
+ *             preproc - [IN] master item preprocessing data                  *
+ *             cache   - [IN/OUT] jsonpath preprocessing cache                *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_manager_collect_jsonpaths(zbx_pp_manager_t *manager, const zbx_pp_item_preproc_t *preproc,
+		zbx_pp_cache_t *cache)
+{
+/* the minimum number of jsonpaths worth querying together */
+#define PP_JSONPATH_BATCH_MIN	2
+
+	zbx_vector_str_t	*jsonpaths;
+
+	if (PP_JSONPATH_BATCH_MIN > preproc->dep_itemids_num)
+		return;
+
+	jsonpaths = (zbx_vector_str_t *)zbx_malloc(NULL, sizeof(zbx_vector_str_t));
+	zbx_vector_str_create(jsonpaths);
+
+	for (int i = 0; i < preproc->dep_itemids_num; i++)
+	{
+		zbx_pp_item_t		*item;
+		zbx_pp_item_preproc_t	*dep_preproc;
+
+		if (NULL == (item = (zbx_pp_item_t *)zbx_hashset_search(&manager->items, &preproc->dep_itemids[i])))
+			continue;
+
+		dep_preproc = item->preproc;
+
+		if (0 == dep_preproc->steps_num || ZBX_PREPROC_JSONPATH != dep_preproc->steps[0].type)
+			continue;
+
+		/* jsonpaths with user macros are resolved when executing each dependent item */
+		if (NULL == dep_preproc->compiled || 0 == (dep_preproc->compiled[0].flags & ZBX_PP_STEP_COMPILED_STATIC))
+			continue;
+
+		zbx_vector_str_append(jsonpaths, zbx_strdup(NULL, dep_preproc->steps[0].params));
+	}
+
+	if (PP_JSONPATH_BATCH_MIN > jsonpaths->values_num)
+	{
+		zbx_vector_str_clear_ext(jsonpaths, zbx_str_free);
+		zbx_vector_str_destroy(jsonpaths);
+		zbx_free(jsonpaths);
+		return;
+	}
+
+	pp_cache_add_jsonpaths(cache, jsonpaths);
+
+#undef PP_JSONPATH_BATCH_MIN
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: create and queue tasks for dependent items                        *
@@ -440,6 +497,10 @@ static void	pp_manager_queue_value_task_result(zbx_pp_manager_t *manager, zbx_pp
 		zbx_pp_task_dependent_t	*d_dep = (zbx_pp_task_dependent_t *)PP_TASK_DATA(dep_task);
 
 		d_dep->cache = pp_cache_create(item->preproc, &d->result);
+
+		if (ZBX_PREPROC_JSONPATH == d_dep->cache->type)
+			pp_manager_collect_jsonpaths(manager, d->preproc, d_dep->cache);
+
 		zbx_variant_set_none(&value);
 
 		d_dep->primary = pp_task_value_create(item->itemid, item->preproc, d->um_handle, &value, d->ts,
@@ -647,12 +708,29 @@ zbx_hashset_t  *zbx_pp_manager_items(zbx_pp_manager_t *manager)
  *                                                                            *
  ******************************************************************************/
 static void	zbx_pp_manager_get_diag_stats(zbx_pp_manager_t *manager, zbx_uint64_t *preproc_num,
-		zbx_uint64_t *pending_num, zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num)
+		zbx_uint64_t *pending_num, zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num,
+		zbx_regexp_stats_t *regexp_stats)
 {
 	*preproc_num = (zbx_uint64_t)manager->items.num_data;
 	*pending_num = manager->queue.pending_num;
 	*finished_num = manager->queue.finished_num;
 	*sequences_num = (zbx_uint64_t)manager->queue.sequences.num_data;
+
+	memset(regexp_stats, 0, sizeof(zbx_regexp_stats_t));
+
+	pp_task_queue_lock(&manager->queue);
+
+	for (int i = 0; i < manager->workers_num; i++)
+	{
+		const zbx_regexp_stats_t	*worker_stats = &manager->workers[i].regexp_stats;
+
+		regexp_stats->compiled += worker_stats->compiled;
+		regexp_stats->jit_compiled += worker_stats->jit_compiled;
+		regexp_stats->cache_hits += worker_stats->cache_hits;
+		regexp_stats->cache_misses += worker_stats->cache_misses;
+	}
+
+	pp_task_queue_unlock(&manager->queue);
 }
 
 /******************************************************************************
@@ -850,6 +928,7 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 	zbx_preproc_item_value_t	value;
 	zbx_uint64_t			queued_num = 0;
 	zbx_vector_pp_task_ptr_t	tasks;
+	zbx_timespec_t			now;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -858,6 +937,8 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 
 	preprocessor_sync_configuration(manager);
 
+	zbx_timespec(&now);
+
 	while (offset < message->size)
 	{
 		zbx_variant_t		var;
@@ -867,9 +948,11 @@ static zbx_uint64_t	preprocessor_add_request(zbx_pp_manager_t *manager, zbx_ipc_
 
 		offset += zbx_preprocessor_unpack_value(&value, message->data + offset);
 		preproc_item_value_extract_data(&value, &var, &ts, &var_opt);
+		zbx_latency_update(ZBX_LATENCY_STAGE_PREPROCESSING, &now, &ts);
 
 		if (NULL == (task = zbx_pp_manager_create_task(manager, value.itemid, &var, ts, &var_opt)))
 		{
+			zbx_latency_update(ZBX_LATENCY_STAGE_PREPROCESSED, &now, &ts);
 			preprocessing_flush_value(manager, value.itemid, value.item_value_type, value.item_flags,
 					&var, ts, &var_opt);
 
@@ -932,9 +1015,11 @@ static void	preprocessor_reply_queue_size(zbx_pp_manager_t *manager, zbx_ipc_cli
  *                                                                            *
  * Parameters: manager - [IN] preprocessing manager                           *
  *             tasks   - [IN] processed tasks                                 *
+ *             now     - [IN] the current time                                *
  *                                                                            *
  ******************************************************************************/
-static void	prpeprocessor_flush_value_result(zbx_pp_manager_t *manager, zbx_pp_task_t *task)
+static void	prpeprocessor_flush_value_result(zbx_pp_manager_t *manager, zbx_pp_task_t *task,
+		const zbx_timespec_t *now)
 {
 	zbx_variant_t		*value;
 	unsigned char		value_type, flags;
@@ -942,6 +1027,7 @@ static void	prpeprocessor_flush_value_result(zbx_pp_manager_t *manager, zbx_pp_t
 	zbx_pp_value_opt_t	*value_opt;
 
 	zbx_pp_value_task_get_data(task, &value_type, &flags, &value, &ts, &value_opt);
+	zbx_latency_update(ZBX_LATENCY_STAGE_PREPROCESSED, now, &ts);
 	preprocessing_flush_value(manager, task->itemid, value_type, flags, value, ts, value_opt);
 }
 
@@ -980,13 +1066,17 @@ static void	preprocessor_reply_test_result(zbx_pp_task_t *task)
  ******************************************************************************/
 static void	preprocessor_flush_tasks(zbx_pp_manager_t *manager, zbx_vector_pp_task_ptr_t *tasks)
 {
+	zbx_timespec_t	now;
+
+	zbx_timespec(&now);
+
 	for (int i = 0; i < tasks->values_num; i++)
 	{
 		switch (tasks->values[i]->type)
 		{
 			case ZBX_PP_TASK_VALUE:
 			case ZBX_PP_TASK_VALUE_SEQ:	/* value and value_seq task contents are identical */
-				prpeprocessor_flush_value_result(manager, tasks->values[i]);
+				prpeprocessor_flush_value_result(manager, tasks->values[i], &now);
 				break;
 			case ZBX_PP_TASK_TEST:
 				preprocessor_reply_test_result(tasks->values[i]);
@@ -1008,12 +1098,15 @@ static void	preprocessor_flush_tasks(zbx_pp_manager_t *manager, zbx_vector_pp_ta
  ******************************************************************************/
 static void	preprocessor_reply_diag_info(zbx_pp_manager_t *manager, zbx_ipc_client_t *client)
 {
-	zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num;
-	unsigned char	*data;
-	zbx_uint32_t	data_len;
+	zbx_uint64_t		preproc_num, pending_num, finished_num, sequences_num;
+	zbx_regexp_stats_t	regexp_stats;
+	unsigned char		*data;
+	zbx_uint32_t		data_len;
 
-	zbx_pp_manager_get_diag_stats(manager, &preproc_num, &pending_num, &finished_num, &sequences_num);
-	data_len = zbx_preprocessor_pack_diag_stats(&data, preproc_num, pending_num, finished_num, sequences_num);
+	zbx_pp_manager_get_diag_stats(manager, &preproc_num, &pending_num, &finished_num, &sequences_num,
+			&regexp_stats);
+	data_len = zbx_preprocessor_pack_diag_stats(&data, preproc_num, pending_num, finished_num, sequences_num,
+			&regexp_stats);
 
 	zbx_ipc_client_send(client, ZBX_IPC_PREPROCESSOR_DIAG_STATS_RESULT, data, data_len);
 
@@ -170,6 +170,7 @@ static void	*pp_worker_entry(void *args)
 
 			pp_task_queue_lock(queue);
 			pp_task_queue_push_finished(queue, in);
+			zbx_regexp_get_stats(&worker->regexp_stats);
 
 			if (NULL != worker->finished_cb)
 				worker->finished_cb(worker->finished_data);
@@ -191,6 +192,8 @@ static void	*pp_worker_entry(void *args)
 	pp_task_queue_deregister_worker(queue);
 	pp_task_queue_unlock(queue);
 
+	zbx_deinit_regexp_env();
+
 	zabbix_log(LOG_LEVEL_INFORMATION, "thread stopped [%s #%d]",
 			get_process_type_string(ZBX_PROCESS_TYPE_PREPROCESSOR), worker->id);
 
@@ -24,6 +24,7 @@
 #include "pp_execute.h"
 #include "zbxtimekeeper.h"
 #include "zbxpreproc.h"
+#include "zbxregexp.h"
 
 
 typedef struct
@@ -47,6 +48,8 @@ typedef struct
 	zbx_log_component_t		logger;
 
 	const char			*config_source_ip;
+
+	zbx_regexp_stats_t		regexp_stats;	/* updated by worker under task queue lock */
 }
 zbx_pp_worker_t;
 
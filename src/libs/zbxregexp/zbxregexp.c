@@ -75,6 +75,59 @@ zbx_regmatch_t;
 
 ZBX_PTR_VECTOR_IMPL(expression, zbx_expression_t *)
 
+#define ZBX_REGEXP_CACHE_SIZE	64	/* max number of compiled regular expressions cached by a thread */
+
+/* compiled regular expression in per thread cache of recently used regular expressions */
+typedef struct
+{
+	char		*pattern;
+	int		flags;
+	zbx_regexp_t	*regexp;
+	zbx_uint64_t	lastaccess;	/* value of regexp_cache_access when entry was last used */
+}
+zbx_regexp_cache_entry_t;
+
+static ZBX_THREAD_LOCAL zbx_hashset_t		*regexp_cache = NULL;
+static ZBX_THREAD_LOCAL zbx_uint64_t		regexp_cache_access = 0;
+static ZBX_THREAD_LOCAL zbx_regexp_stats_t	regexp_stats;
+
+#ifdef HAVE_PCRE2_H
+#define ZBX_REGEXP_JIT_STACK_MIN	(32 * ZBX_KIBIBYTE)
+#define ZBX_REGEXP_JIT_STACK_MAX	(1024 * ZBX_KIBIBYTE)
+
+/* JIT stack and match data are reused by all matches of a thread */
+static ZBX_THREAD_LOCAL pcre2_jit_stack		*regexp_jit_stack = NULL;
+static ZBX_THREAD_LOCAL pcre2_match_data	*regexp_match_data = NULL;
+#endif
+
+static zbx_hash_t	regexp_cache_entry_hash(const void *d)
+{
+	const zbx_regexp_cache_entry_t	*entry = (const zbx_regexp_cache_entry_t *)d;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_STRING_HASH_FUNC(entry->pattern);
+
+	return ZBX_DEFAULT_HASH_ALGO(&entry->flags, sizeof(entry->flags), hash);
+}
+
+static int	regexp_cache_entry_compare(const void *d1, const void *d2)
+{
+	const zbx_regexp_cache_entry_t	*entry1 = (const zbx_regexp_cache_entry_t *)d1;
+	const zbx_regexp_cache_entry_t	*entry2 = (const zbx_regexp_cache_entry_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(entry1->flags, entry2->flags);
+
+	return strcmp(entry1->pattern, entry2->pattern);
+}
+
+static void	regexp_cache_entry_clean(void *d)
+{
+	zbx_regexp_cache_entry_t	*entry = (zbx_regexp_cache_entry_t *)d;
+
+	zbx_regexp_free(entry->regexp);
+	zbx_free(entry->pattern);
+}
+
 #if defined(HAVE_PCRE2_H)
 static char	*decode_pcre2_compile_error(int error_code, PCRE2_SIZE error_offset, int flags)
 {
@@ -149,6 +202,7 @@ static int	regexp_compile(const char *pattern, int flags, zbx_regexp_t **regexp,
 		}
 	}
 #endif
+	regexp_stats.compiled++;
 #ifdef HAVE_PCRE_H
 	if (NULL == (pcre_regexp = pcre_compile(pattern, flags, &err_msg_static, &error_offset, NULL)))
 	{
@@ -262,43 +316,158 @@ int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags
 	return regexp_compile(pattern, flags, regexp, err_msg);
 }
 
-/****************************************************************************************************
- *                                                                                                  *
- * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the last used regexp.                 *
- *                                                                                                  *
- ****************************************************************************************************/
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles regular expression and keeps it in per thread cache of   *
+ *          recently used regular expressions                                 *
+ *                                                                            *
+ * Parameters: pattern - [IN] regular expression as a text string             *
+ *             flags   - [IN] regexp compilation parameters                   *
+ *             regexp  - [OUT] compiled regular expression, owned by cache    *
+ *             err_msg - [OUT] dynamically allocated error message            *
+ *                                                                            *
+ * Return value: SUCCEED or FAIL                                              *
+ *                                                                            *
+ * Comments: Returned regular expression stays valid until another            *
+ *           ZBX_REGEXP_CACHE_SIZE regular expressions are prepared by the    *
+ *           same thread. Cached regular expressions are also compiled to     *
+ *           machine code when PCRE2 JIT is available.                        *
+ *                                                                            *
+ ******************************************************************************/
 static int	regexp_prepare(const char *pattern, int flags, zbx_regexp_t **regexp, char **err_msg)
 {
-	static ZBX_THREAD_LOCAL zbx_regexp_t	*curr_regexp = NULL;
-	static ZBX_THREAD_LOCAL char		*curr_pattern = NULL;
-	static ZBX_THREAD_LOCAL int		curr_flags = 0;
-	int					ret = SUCCEED;
+	zbx_regexp_cache_entry_t	entry_local, *entry;
 
-	if (NULL == curr_regexp || 0 != strcmp(curr_pattern, pattern) || curr_flags != flags)
+	if (NULL == regexp_cache)
 	{
-		if (NULL != curr_regexp)
-		{
-			zbx_regexp_free(curr_regexp);
-			zbx_free(curr_pattern);
-		}
+		regexp_cache = (zbx_hashset_t *)zbx_malloc(NULL, sizeof(zbx_hashset_t));
+		zbx_hashset_create_ext(regexp_cache, ZBX_REGEXP_CACHE_SIZE, regexp_cache_entry_hash,
+				regexp_cache_entry_compare, regexp_cache_entry_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
 
-		curr_regexp = NULL;
-		curr_pattern = NULL;
-		curr_flags = 0;
+	entry_local.pattern = (char *)pattern;
+	entry_local.flags = flags;
+
+	if (NULL != (entry = (zbx_regexp_cache_entry_t *)zbx_hashset_search(regexp_cache, &entry_local)))
+	{
+		regexp_stats.cache_hits++;
+		entry->lastaccess = ++regexp_cache_access;
+		*regexp = entry->regexp;
+
+		return SUCCEED;
+	}
+
+	regexp_stats.cache_misses++;
+
+	if (SUCCEED != regexp_compile(pattern, flags, &entry_local.regexp, err_msg))
+		return FAIL;
+#ifdef HAVE_PCRE2_H
+	/* JIT compilation pays off only for reused patterns, so it is done for cached ones only, */
+	/* if JIT is not available the pattern is matched by interpreter                          */
+	if (0 == pcre2_jit_compile(entry_local.regexp->pcre2_regexp, PCRE2_JIT_COMPLETE))
+		regexp_stats.jit_compiled++;
+#endif
+
+	if (ZBX_REGEXP_CACHE_SIZE <= regexp_cache->num_data)
+	{
+		zbx_hashset_iter_t		iter;
+		zbx_regexp_cache_entry_t	*lru = NULL;
 
-		if (SUCCEED == regexp_compile(pattern, flags, &curr_regexp, err_msg))
+		zbx_hashset_iter_reset(regexp_cache, &iter);
+
+		while (NULL != (entry = (zbx_regexp_cache_entry_t *)zbx_hashset_iter_next(&iter)))
 		{
-			curr_pattern = zbx_strdup(curr_pattern, pattern);
-			curr_flags = flags;
+			if (NULL == lru || entry->lastaccess < lru->lastaccess)
+				lru = entry;
 		}
-		else
-			ret = FAIL;
+
+		zbx_hashset_remove_direct(regexp_cache, lru);
 	}
 
-	*regexp = curr_regexp;
+	entry_local.pattern = zbx_strdup(NULL, pattern);
+	entry_local.lastaccess = ++regexp_cache_access;
+	zbx_hashset_insert(regexp_cache, &entry_local, sizeof(entry_local));
+
+	*regexp = entry_local.regexp;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles a regular expression with default options, using the     *
+ *          cache of recently used regular expressions                        *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     pattern   - [IN] regular expression as a text string. Empty            *
+ *                      string ("") is allowed, it will match everything.     *
+ *                      NULL is not allowed.                                  *
+ *     regexp    - [OUT] compiled regular expression, must not be freed       *
+ *     err_msg   - [OUT] error message if any.                                *
+ *                                                                            *
+ * Return value: SUCCEED or FAIL                                              *
+ *                                                                            *
+ * Comments: Use this function instead of zbx_regexp_compile() when the same  *
+ *           patterns are compiled repeatedly. The returned regular           *
+ *           expression must be used right away - it stays valid only until   *
+ *           the calling thread prepares a number of other patterns.          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_regexp_compile_cached(const char *pattern, const zbx_regexp_t **regexp, char **err_msg)
+{
+	zbx_regexp_t	*rxp;
+	int		ret;
+
+#ifdef ZBX_REGEXP_NO_AUTO_CAPTURE
+	ret = regexp_prepare(pattern, ZBX_REGEXP_MULTILINE | ZBX_REGEXP_NO_AUTO_CAPTURE, &rxp, err_msg);
+#else
+	ret = regexp_prepare(pattern, ZBX_REGEXP_MULTILINE, &rxp, err_msg);
+#endif
+	if (SUCCEED == ret)
+		*regexp = rxp;
+
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles a regular expression with specified compilation          *
+ *          parameters, using the cache of recently used regular expressions  *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     pattern   - [IN] regular expression as a text string                   *
+ *     regexp    - [OUT] compiled regular expression, must not be freed       *
+ *     flags     - [IN] regexp compilation parameters                         *
+ *     err_msg   - [OUT] error message if any.                                *
+ *                                                                            *
+ * Return value: SUCCEED or FAIL                                              *
+ *                                                                            *
+ * Comments: see zbx_regexp_compile_cached()                                  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_regexp_compile_ext_cached(const char *pattern, const zbx_regexp_t **regexp, int flags, char **err_msg)
+{
+	zbx_regexp_t	*rxp;
+
+	if (SUCCEED != regexp_prepare(pattern, flags, &rxp, err_msg))
+		return FAIL;
+
+	*regexp = rxp;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns regular expression statistics of the calling thread       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_regexp_get_stats(zbx_regexp_stats_t *stats)
+{
+	*stats = regexp_stats;
+}
+
 /* calculate recursion limit, PCRE man page suggests to reckon on about 500 bytes per recursion */
 /* but to be on the safe side - reckon on 800 bytes and do not set limit higher than 100000 */
 #define REGEXP_RECURSION_STEP	800
@@ -320,6 +489,41 @@ void	zbx_init_regexp_env(void)
 #endif
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: releases regular expression execution environment of the calling  *
+ *          thread                                                            *
+ *                                                                            *
+ * Comments: must be called by threads using regular expressions before       *
+ *           exiting                                                          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_deinit_regexp_env(void)
+{
+	zabbix_log(LOG_LEVEL_DEBUG, "regular expressions compiled:" ZBX_FS_UI64 " JIT compiled:" ZBX_FS_UI64
+			" cache hits:" ZBX_FS_UI64 " cache misses:" ZBX_FS_UI64, regexp_stats.compiled,
+			regexp_stats.jit_compiled, regexp_stats.cache_hits, regexp_stats.cache_misses);
+
+	if (NULL != regexp_cache)
+	{
+		zbx_hashset_destroy(regexp_cache);
+		zbx_free(regexp_cache);
+	}
+#ifdef HAVE_PCRE2_H
+	if (NULL != regexp_match_data)
+	{
+		pcre2_match_data_free(regexp_match_data);
+		regexp_match_data = NULL;
+	}
+
+	if (NULL != regexp_jit_stack)
+	{
+		pcre2_jit_stack_free(regexp_jit_stack);
+		regexp_jit_stack = NULL;
+	}
+#endif
+}
+
 static unsigned long int	compute_recursion_limit(void)
 {
 	if (0 == rxp_stacklimit)
@@ -453,7 +657,22 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 	pcre2_set_match_limit(regexp->match_ctx, 1000000);
 
 	pcre2_set_recursion_limit(regexp->match_ctx, (uint32_t)compute_recursion_limit());
-	match_data = pcre2_match_data_create((uint32_t)count, NULL);
+
+	if (NULL == regexp_jit_stack)
+		regexp_jit_stack = pcre2_jit_stack_create(ZBX_REGEXP_JIT_STACK_MIN, ZBX_REGEXP_JIT_STACK_MAX, NULL);
+
+	/* when JIT stack cannot be created the default 32K stack on machine stack is used */
+	pcre2_jit_stack_assign(regexp->match_ctx, NULL, regexp_jit_stack);
+
+	if (ZBX_REGEXP_GROUPS_MAX >= count)
+	{
+		if (NULL == regexp_match_data)
+			regexp_match_data = pcre2_match_data_create(ZBX_REGEXP_GROUPS_MAX, NULL);
+
+		match_data = regexp_match_data;
+	}
+	else
+		match_data = pcre2_match_data_create((uint32_t)count, NULL);
 
 	if (NULL == match_data)
 	{
@@ -465,9 +684,17 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 #ifdef PCRE2_MATCH_INVALID_UTF
 		flags |= PCRE2_NO_UTF_CHECK;
 #endif
+		r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, 0, flags, match_data,
+				regexp->match_ctx);
+
+		/* JIT stack is limited, retry with interpreter which has its own recursion limit */
+		if (PCRE2_ERROR_JIT_STACKLIMIT == r)
+		{
+			r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, 0,
+					flags | PCRE2_NO_JIT, match_data, regexp->match_ctx);
+		}
 
-		if (0 <= (r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, 0, flags,
-			match_data, regexp->match_ctx)))
+		if (0 <= r)
 		{
 			if (NULL != matches)
 			{
@@ -497,7 +724,8 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 			result = FAIL;
 		}
 
-		pcre2_match_data_free(match_data);
+		if (match_data != regexp_match_data)
+			pcre2_match_data_free(match_data);
 	}
 
 	return result;
@@ -181,6 +181,18 @@ int	zbx_rtc_parse_options(const char *opt, zbx_uint32_t *code, struct zbx_json *
 		return rtc_parse_profiler_parameter(opt, ZBX_CONST_STRLEN(ZBX_PROF_DISABLE), j, error);
 	}
 
+	if (0 == strcmp(opt, ZBX_LOCK_PROF_ENABLE))
+	{
+		*code = ZBX_RTC_LOCK_PROF_ENABLE;
+		return SUCCEED;
+	}
+
+	if (0 == strcmp(opt, ZBX_LOCK_PROF_DISABLE))
+	{
+		*code = ZBX_RTC_LOCK_PROF_DISABLE;
+		return SUCCEED;
+	}
+
 	if (0 == strcmp(opt, ZBX_CONFIG_CACHE_RELOAD))
 	{
 		*code = ZBX_RTC_CONFIG_CACHE_RELOAD;
@@ -27,6 +27,7 @@
 #include "zbxdiag.h"
 #include "zbxstr.h"
 #include "zbxnum.h"
+#include "zbxmutexs.h"
 
 ZBX_PTR_VECTOR_IMPL(rtc_sub, zbx_rtc_sub_t *)
 ZBX_PTR_VECTOR_IMPL(rtc_hook, zbx_rtc_hook_t *)
@@ -206,7 +207,8 @@ static void	rtc_process_diaginfo(const char *data, char **result)
 	if (0 == strcmp(buf, "all"))
 	{
 		scope = (1 << ZBX_DIAGINFO_HISTORYCACHE) | (1 << ZBX_DIAGINFO_PREPROCESSING) |
-				(1 << ZBX_DIAGINFO_LOCKS);
+				(1 << ZBX_DIAGINFO_LOCKS) | (1 << ZBX_DIAGINFO_CONFIGCACHE) |
+				(1 << ZBX_DIAGINFO_LATENCY);
 	}
 	else if (0 == strcmp(buf, ZBX_DIAG_HISTORYCACHE))
 	{
@@ -220,6 +222,14 @@ static void	rtc_process_diaginfo(const char *data, char **result)
 	{
 		scope = 1 << ZBX_DIAGINFO_LOCKS;
 	}
+	else if (0 == strcmp(buf, ZBX_DIAG_CONFIGCACHE))
+	{
+		scope = 1 << ZBX_DIAGINFO_CONFIGCACHE;
+	}
+	else if (0 == strcmp(buf, ZBX_DIAG_LATENCY))
+	{
+		scope = 1 << ZBX_DIAGINFO_LATENCY;
+	}
 	else
 	{
 		if (NULL == *result)
@@ -230,6 +240,39 @@ static void	rtc_process_diaginfo(const char *data, char **result)
 	zbx_diag_log_info(scope, result);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process lock profiler runtime control option                      *
+ *                                                                            *
+ * Parameters: code   - [IN] the request code                                 *
+ *             result - [OUT] the runtime control result                      *
+ *                                                                            *
+ * Comments: Lock profiling statistics are kept in shared memory, so the      *
+ *           option affects all processes immediately.                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	rtc_process_lock_profiler_option(zbx_uint32_t code, char **result)
+{
+	char	*error = NULL;
+
+	if (ZBX_RTC_LOCK_PROF_DISABLE == code)
+	{
+		zbx_locks_prof_disable();
+		*result = zbx_strdup(NULL, "Lock profiling disabled\n");
+		return;
+	}
+
+	if (SUCCEED != zbx_locks_prof_enable(&error))
+	{
+		*result = zbx_dsprintf(NULL, "Cannot enable lock profiling: %s\n", error);
+		zbx_free(error);
+		return;
+	}
+
+	*result = zbx_strdup(NULL, "Lock profiling enabled, statistics are available in \"" ZBX_DIAG_LOCKS
+			"\" diagnostic information section\n");
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: notify client based subscribers                                   *
@@ -443,6 +486,10 @@ static void	rtc_process_request(zbx_rtc_t *rtc, zbx_uint32_t code, const unsigne
 		case ZBX_RTC_DIAGINFO:
 			rtc_process_diaginfo((const char *)data, result);
 			return;
+		case ZBX_RTC_LOCK_PROF_ENABLE:
+		case ZBX_RTC_LOCK_PROF_DISABLE:
+			rtc_process_lock_profiler_option(code, result);
+			return;
 		default:
 			*result = zbx_strdup(*result, "Unknown runtime control option\n");
 	}
@@ -49,6 +49,44 @@ static zbx_mutex_t	sm_lock = ZBX_MUTEX_NULL;
 static zbx_shmem_info_t	*sm_mem = NULL;
 ZBX_SHMEM_FUNC_IMPL(__sm, sm_mem)
 
+/* Latency histograms are log-linear - latencies below ZBX_LATENCY_SUB_COUNT microseconds */
+/* have a bucket each, above that every power of two is split into ZBX_LATENCY_SUB_COUNT  */
+/* buckets, giving 25% resolution over the whole range.                                   */
+#define ZBX_LATENCY_SUB_BITS	2
+#define ZBX_LATENCY_SUB_COUNT	(1 << ZBX_LATENCY_SUB_BITS)
+#define ZBX_LATENCY_MAX_BITS	36	/* latencies are capped at 2^36 microseconds (~19 hours) */
+#define ZBX_LATENCY_BUCKETS	((ZBX_LATENCY_MAX_BITS - ZBX_LATENCY_SUB_BITS + 1) * ZBX_LATENCY_SUB_COUNT)
+
+typedef struct
+{
+	zbx_uint64_t	buckets[ZBX_LATENCY_BUCKETS];
+	zbx_uint64_t	count;
+	zbx_uint64_t	sum;	/* in microseconds */
+	zbx_uint64_t	max;	/* in microseconds */
+}
+zbx_latency_hist_t;
+
+/* latency statistics are reported for the last complete window of self-monitor */
+/* collection cycles, the same period as process utilization statistics         */
+#define ZBX_LATENCY_WINDOW	(MAX_HISTORY * ZBX_SELFMON_DELAY)
+
+typedef struct
+{
+	zbx_latency_hist_t	hist[2][ZBX_LATENCY_STAGE_COUNT];
+	int			current;	/* index of the window being filled */
+	time_t			window_start;
+}
+zbx_latency_windows_t;
+
+/* Values are counted in process local histograms without locking and added to  */
+/* the current window histograms in self-monitor cache at most once per second. */
+static zbx_latency_windows_t	*latency_shared = NULL;
+static zbx_latency_hist_t	latency_local[ZBX_LATENCY_STAGE_COUNT];
+static int			latency_local_num = 0;
+static time_t			latency_flush_time = 0;
+
+static zbx_calc_cache_stats_t	*calc_cache_shared = NULL;
+
 #endif
 
 static void	sm_sync_lock(void *data)
@@ -104,7 +142,9 @@ int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, char **e
 		units_num += get_config_forks_cb(proc_type);
 	}
 
-	sz_total = zbx_timekeeper_get_memmalloc_size(units_num);
+	/* timekeeper, latency histograms and calculated item cache statistics with allocation overhead */
+	sz_total = zbx_timekeeper_get_memmalloc_size(units_num) + sizeof(zbx_latency_windows_t) +
+			sizeof(zbx_calc_cache_stats_t) + 4 * sizeof(zbx_uint64_t);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() size:" ZBX_FS_SIZE_T, __func__, (zbx_fs_size_t)sz_total);
 
@@ -117,6 +157,13 @@ int	zbx_init_selfmon_collector(zbx_get_config_forks_f get_config_forks, char **e
 	zbx_timekeeper_sync_init(&collector.sync, sm_sync_lock, sm_sync_unlock, (void *)&sm_lock);
 	collector.monitor = zbx_timekeeper_create_ext(units_num, &collector.sync, __sm_shmem_malloc_func,
 			__sm_shmem_realloc_func, __sm_shmem_free_func);
+
+	latency_shared = (zbx_latency_windows_t *)__sm_shmem_malloc_func(NULL, sizeof(zbx_latency_windows_t));
+	memset(latency_shared, 0, sizeof(zbx_latency_windows_t));
+	latency_shared->window_start = time(NULL);
+
+	calc_cache_shared = (zbx_calc_cache_stats_t *)__sm_shmem_malloc_func(NULL, sizeof(zbx_calc_cache_stats_t));
+	memset(calc_cache_shared, 0, sizeof(zbx_calc_cache_stats_t));
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() collector.monitor:%p", __func__, (void *)collector.monitor);
 
@@ -136,12 +183,56 @@ void	zbx_free_selfmon_collector(void)
 		return;
 
 	zbx_timekeeper_free(collector.monitor);
+	latency_shared = NULL;
+	calc_cache_shared = NULL;
 
 	zbx_mutex_destroy(&sm_lock);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add process local latency histograms to the current window        *
+ *                                                                            *
+ * Parameters: now - [IN] the current time                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	latency_flush(time_t now)
+{
+	int	stage, i;
+
+	latency_flush_time = now;
+
+	if (NULL == latency_shared)
+		return;
+
+	zbx_mutex_lock(sm_lock);
+
+	for (stage = 0; stage < ZBX_LATENCY_STAGE_COUNT; stage++)
+	{
+		zbx_latency_hist_t	*local = &latency_local[stage];
+		zbx_latency_hist_t	*shared = &latency_shared->hist[latency_shared->current][stage];
+
+		if (0 == local->count)
+			continue;
+
+		for (i = 0; i < ZBX_LATENCY_BUCKETS; i++)
+			shared->buckets[i] += local->buckets[i];
+
+		shared->count += local->count;
+		shared->sum += local->sum;
+
+		if (local->max > shared->max)
+			shared->max = local->max;
+	}
+
+	zbx_mutex_unlock(sm_lock);
+
+	memset(latency_local, 0, sizeof(latency_local));
+	latency_local_num = 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Parameters: info  - [IN] caller process info                               *
@@ -157,6 +248,277 @@ void	zbx_update_selfmon_counter(const zbx_thread_info_t *info, unsigned char sta
 
 	zbx_timekeeper_update(collector.monitor, unit_index, state);
 
+	/* flush the latencies collected before going idle, otherwise they */
+	/* would not be flushed until the process receives new values      */
+	if (ZBX_PROCESS_STATE_IDLE == state && 0 != latency_local_num)
+	{
+		time_t	now = time(NULL);
+
+		if (now != latency_flush_time)
+			latency_flush(now);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get latency histogram bucket                                      *
+ *                                                                            *
+ * Parameters: latency - [IN] the latency in microseconds                     *
+ *                                                                            *
+ * Return value: The bucket index.                                            *
+ *                                                                            *
+ ******************************************************************************/
+static int	latency_get_bucket(zbx_uint64_t latency)
+{
+	int	bits = ZBX_LATENCY_SUB_BITS;
+
+	if (ZBX_LATENCY_SUB_COUNT > latency)
+		return (int)latency;
+
+	while (0 != (latency >> (bits + 1)))
+		bits++;
+
+	return (bits - ZBX_LATENCY_SUB_BITS + 1) * ZBX_LATENCY_SUB_COUNT +
+			(int)((latency >> (bits - ZBX_LATENCY_SUB_BITS)) & (ZBX_LATENCY_SUB_COUNT - 1));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get latency histogram bucket upper bound                          *
+ *                                                                            *
+ * Parameters: bucket - [IN] the bucket index                                 *
+ *                                                                            *
+ * Return value: The lowest latency in microseconds above the bucket.         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	latency_get_bucket_bound(int bucket)
+{
+	int	bits;
+
+	if (ZBX_LATENCY_SUB_COUNT > bucket)
+		return (zbx_uint64_t)bucket + 1;
+
+	bits = bucket / ZBX_LATENCY_SUB_COUNT + ZBX_LATENCY_SUB_BITS - 1;
+
+	return (zbx_uint64_t)(ZBX_LATENCY_SUB_COUNT + bucket % ZBX_LATENCY_SUB_COUNT + 1) <<
+			(bits - ZBX_LATENCY_SUB_BITS);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: count value latency at the specified ingestion pipeline stage     *
+ *                                                                            *
+ * Parameters: stage - [IN] the pipeline stage, ZBX_LATENCY_STAGE_*           *
+ *             now   - [IN] the current time                                  *
+ *             ts    - [IN] the value timestamp                               *
+ *                                                                            *
+ * Comments: The latency is counted in process local histogram. It's added    *
+ *           to the shared histogram when time changes to the next second or  *
+ *           the process goes idle.                                           *
+ *           Values without timestamp are ignored and values with timestamp   *
+ *           in future are counted with zero latency.                         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_latency_update(int stage, const zbx_timespec_t *now, const zbx_timespec_t *ts)
+{
+	zbx_latency_hist_t	*hist = &latency_local[stage];
+	zbx_int64_t		diff;
+	zbx_uint64_t		latency;
+
+	if (0 == ts->sec)
+		return;
+
+	diff = ((zbx_int64_t)now->sec - ts->sec) * 1000000 + (now->ns - ts->ns) / 1000;
+
+	if (0 > diff)
+		latency = 0;
+	else if (((zbx_uint64_t)1 << ZBX_LATENCY_MAX_BITS) <= (zbx_uint64_t)diff)
+		latency = ((zbx_uint64_t)1 << ZBX_LATENCY_MAX_BITS) - 1;
+	else
+		latency = (zbx_uint64_t)diff;
+
+	hist->buckets[latency_get_bucket(latency)]++;
+	hist->count++;
+	hist->sum += latency;
+
+	if (latency > hist->max)
+		hist->max = latency;
+
+	latency_local_num++;
+
+	if (now->sec != latency_flush_time)
+		latency_flush(now->sec);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get latency percentile from histogram                             *
+ *                                                                            *
+ * Parameters: hist       - [IN] the latency histogram                        *
+ *             percentile - [IN] the percentile (0-100)                       *
+ *                                                                            *
+ * Return value: The latency percentile in seconds.                           *
+ *                                                                            *
+ * Comments: The upper bound of bucket containing the percentile is returned, *
+ *           limited by the maximum latency.                                  *
+ *                                                                            *
+ ******************************************************************************/
+static double	latency_get_percentile(const zbx_latency_hist_t *hist, int percentile)
+{
+	zbx_uint64_t	target, total = 0, bound;
+	int		i;
+
+	if (0 == hist->count)
+		return 0;
+
+	target = (hist->count * (zbx_uint64_t)percentile + 99) / 100;
+
+	for (i = 0; i < ZBX_LATENCY_BUCKETS - 1; i++)
+	{
+		if (target <= (total += hist->buckets[i]))
+			break;
+	}
+
+	if ((bound = latency_get_bucket_bound(i)) > hist->max)
+		bound = hist->max;
+
+	return (double)bound / 1e6;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get value latency statistics of the specified pipeline stage      *
+ *                                                                            *
+ * Parameters: stage - [IN] the pipeline stage, ZBX_LATENCY_STAGE_*           *
+ *             stats - [OUT] the latency statistics of the last complete      *
+ *                           window                                           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_latency_get_stats(int stage, zbx_latency_stats_t *stats)
+{
+	zbx_latency_hist_t	hist;
+
+	memset(stats, 0, sizeof(zbx_latency_stats_t));
+
+	if (NULL == latency_shared)
+		return;
+
+	zbx_mutex_lock(sm_lock);
+	memcpy(&hist, &latency_shared->hist[latency_shared->current ^ 1][stage], sizeof(zbx_latency_hist_t));
+	zbx_mutex_unlock(sm_lock);
+
+	if (0 == (stats->count = hist.count))
+		return;
+
+	stats->avg = (double)hist.sum / (double)hist.count / 1e6;
+	stats->max = (double)hist.max / 1e6;
+	stats->p50 = latency_get_percentile(&hist, 50);
+	stats->p90 = latency_get_percentile(&hist, 90);
+	stats->p95 = latency_get_percentile(&hist, 95);
+	stats->p99 = latency_get_percentile(&hist, 99);
+}
+
+static const char	*latency_stages[ZBX_LATENCY_STAGE_COUNT] = {"preprocessing", "preprocessed", "historycache",
+		"sync", "history"};
+
+const char	*zbx_latency_stage_string(int stage)
+{
+	return latency_stages[stage];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get pipeline stage by name                                        *
+ *                                                                            *
+ * Parameters: name  - [IN] the stage name                                    *
+ *             stage - [OUT] the pipeline stage, ZBX_LATENCY_STAGE_*          *
+ *                                                                            *
+ * Return value: SUCCEED - the stage was found                                *
+ *               FAIL    - unknown stage name                                 *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_latency_get_stage(const char *name, int *stage)
+{
+	int	i;
+
+	for (i = 0; i < ZBX_LATENCY_STAGE_COUNT; i++)
+	{
+		if (0 == strcmp(name, latency_stages[i]))
+		{
+			*stage = i;
+			return SUCCEED;
+		}
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add aggregate function results shared between calculated items    *
+ *          to the calculated item cache statistics                           *
+ *                                                                            *
+ * Parameters: hits   - [IN] the number of results taken from cache           *
+ *             misses - [IN] the number of evaluated results                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_calc_cache_update(zbx_uint64_t hits, zbx_uint64_t misses)
+{
+	if (NULL == calc_cache_shared || 0 == hits + misses)
+		return;
+
+	zbx_mutex_lock(sm_lock);
+	calc_cache_shared->hits += hits;
+	calc_cache_shared->misses += misses;
+	zbx_mutex_unlock(sm_lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get calculated item cache statistics                              *
+ *                                                                            *
+ * Parameters: stats - [OUT] the statistics since server start                *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_calc_cache_get_stats(zbx_calc_cache_stats_t *stats)
+{
+	if (NULL == calc_cache_shared)
+	{
+		memset(stats, 0, sizeof(zbx_calc_cache_stats_t));
+		return;
+	}
+
+	zbx_mutex_lock(sm_lock);
+	*stats = *calc_cache_shared;
+	zbx_mutex_unlock(sm_lock);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start new latency window if the current one is complete           *
+ *                                                                            *
+ * Parameters: now - [IN] the current time                                    *
+ *                                                                            *
+ * Comments: The complete window becomes the previous one, statistics are     *
+ *           reported from it until the next window is complete.              *
+ *                                                                            *
+ ******************************************************************************/
+static void	latency_swap_windows(time_t now)
+{
+	if (NULL == latency_shared)
+		return;
+
+	zbx_mutex_lock(sm_lock);
+
+	if (now - latency_shared->window_start >= ZBX_LATENCY_WINDOW)
+	{
+		latency_shared->current ^= 1;
+		memset(latency_shared->hist[latency_shared->current], 0,
+				sizeof(latency_shared->hist[latency_shared->current]));
+		latency_shared->window_start = now;
+	}
+
+	zbx_mutex_unlock(sm_lock);
 }
 
 static void	collect_selfmon_stats(void)
@@ -164,6 +526,7 @@ static void	collect_selfmon_stats(void)
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	zbx_timekeeper_collect(collector.monitor);
+	latency_swap_windows(time(NULL));
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -21,6 +21,10 @@
 
 #include "zbxstr.h"
 
+#if defined(__linux__)
+#	include <sys/mman.h>
+#endif
+
 /******************************************************************************
  *                                                                            *
  *                     Some information on memory layout                      *
@@ -117,6 +121,69 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr);
 #define SHMEM_MIN_SIZE		__UINT64_C(128)
 #define SHMEM_MAX_SIZE		__UINT64_C(0x1000000000)	/* 64 GB */
 
+/* smaller segments are not worth reserving huge pages for */
+#define SHMEM_HUGE_PAGES_MIN_SIZE	(4 * ZBX_MEBIBYTE)
+
+static int	shmem_huge_pages = 0;
+
+/******************************************************************************
+ *                                                                            *
+ * (*) slabs: optional allocator for objects up to SHMEM_SLAB_MAX_ALLOC bytes *
+ *                                                                            *
+ *     Small objects are allocated from slab pages - chunks of                *
+ *     SHMEM_SLAB_PAGE_SIZE bytes split into slots of the same size class.    *
+ *     Each slot has SHMEM_SIZE_FIELD bytes header with SHMEM_FLG_SLAB bit    *
+ *     set and the slot offset from the page start, so slots can be told      *
+ *     apart from regular chunks when freeing memory.                         *
+ *                                                                            *
+ *  +------------------------- slab page (used chunk) -------------------+    *
+ *  |                                                                    |    *
+ *  v                                                                    v    *
+ *  |--------|-- page header --|--------|-- data --|--------|-- data --|...   *
+ *                              ^                   ^                         *
+ *                              slot header         slot header               *
+ *                                                                            *
+ *     Free slots are linked in a page free list (the link is stored in slot  *
+ *     data). Pages with free slots are linked in per size class lists. When  *
+ *     all slots of a page are freed the page is returned to the chunk        *
+ *     allocator, unless it is the only page with free slots in its class.    *
+ *                                                                            *
+ ******************************************************************************/
+
+#define SHMEM_FLG_SLAB		((__UINT64_C(1))<<62)
+#define SLAB_OBJECT(ptr)	(((*(zbx_uint64_t *)(ptr)) & SHMEM_FLG_SLAB) != 0)
+#define SLAB_OFFSET(ptr)	((*(zbx_uint64_t *)(ptr)) & ~(SHMEM_FLG_USED | SHMEM_FLG_SLAB))
+
+#define SHMEM_SLAB_PAGE_SIZE	(16 * ZBX_KIBIBYTE)
+#define SHMEM_SLAB_MAX_ALLOC	512
+/* in smaller segments pages of all size classes would take significant part of memory */
+#define SHMEM_SLAB_MIN_TOTAL	(4 * ZBX_MEBIBYTE)
+
+static const zbx_uint64_t	slab_class_sizes[ZBX_SHMEM_SLAB_CLASS_COUNT] = {8, 16, 24, 32, 40, 48, 56, 64, 72,
+		80, 88, 96, 104, 112, 120, 128, 160, 192, 224, 256, 320, 384, 448, SHMEM_SLAB_MAX_ALLOC};
+
+typedef struct zbx_shmem_slab_page
+{
+	struct zbx_shmem_slab_page	*prev;
+	struct zbx_shmem_slab_page	*next;
+	void				*free_slot;	/* the first slot in page free list */
+	zbx_uint32_t			slots_num;	/* the number of slots taken from page at least once */
+	zbx_uint32_t			slots_max;	/* the number of slots fitting in page */
+	zbx_uint32_t			used;		/* the number of used slots */
+	int				class_index;
+	int				partial;	/* 1 if the page is linked in partial pages list */
+}
+zbx_shmem_slab_page_t;
+
+#define SHMEM_SLAB_PAGE_HEADER	ZBX_SIZE_T_ALIGN8(sizeof(zbx_shmem_slab_page_t))
+
+struct zbx_shmem_slabs
+{
+	zbx_shmem_slab_page_t	*partial[ZBX_SHMEM_SLAB_CLASS_COUNT];
+	zbx_uint32_t		pages_num[ZBX_SHMEM_SLAB_CLASS_COUNT];
+	zbx_uint32_t		objects_num[ZBX_SHMEM_SLAB_CLASS_COUNT];
+};
+
 /* helper functions */
 
 static void	*ALIGN4(void *ptr)
@@ -523,13 +590,238 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr)
 	}
 }
 
+/* slab allocator functions */
+
+static int	mem_slab_class_by_size(zbx_uint64_t size)
+{
+	int	index;
+
+	if (size <= 128)
+		return (int)((size + 7) >> 3) - 1;
+
+	for (index = 16; slab_class_sizes[index] < size; index++)
+		;
+
+	return index;
+}
+
+static void	mem_slab_link_page(struct zbx_shmem_slabs *slabs, zbx_shmem_slab_page_t *page)
+{
+	page->prev = NULL;
+	page->next = slabs->partial[page->class_index];
+
+	if (NULL != page->next)
+		page->next->prev = page;
+
+	slabs->partial[page->class_index] = page;
+	page->partial = 1;
+}
+
+static void	mem_slab_unlink_page(struct zbx_shmem_slabs *slabs, zbx_shmem_slab_page_t *page)
+{
+	if (NULL != page->prev)
+		page->prev->next = page->next;
+	else
+		slabs->partial[page->class_index] = page->next;
+
+	if (NULL != page->next)
+		page->next->prev = page->prev;
+
+	page->partial = 0;
+}
+
+static zbx_shmem_slab_page_t	*mem_slab_get_page(void *slot)
+{
+	return (zbx_shmem_slab_page_t *)((char *)slot - SLAB_OFFSET(slot));
+}
+
+static zbx_uint64_t	mem_slab_size(void *slot)
+{
+	return slab_class_sizes[mem_slab_get_page(slot)->class_index];
+}
+
+static void	*mem_slab_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
+{
+	struct zbx_shmem_slabs	*slabs = info->slabs;
+	zbx_shmem_slab_page_t	*page;
+	int			index;
+	zbx_uint64_t		slot_size;
+	void			*slot;
+
+	index = mem_slab_class_by_size(size);
+	slot_size = SHMEM_SIZE_FIELD + slab_class_sizes[index];
+
+	if (NULL == (page = slabs->partial[index]))
+	{
+		void	*chunk;
+
+		if (NULL == (chunk = __mem_malloc(info, SHMEM_SLAB_PAGE_SIZE)))
+			return NULL;
+
+		page = (zbx_shmem_slab_page_t *)((char *)chunk + SHMEM_SIZE_FIELD);
+		page->free_slot = NULL;
+		page->slots_num = 0;
+		page->slots_max = (zbx_uint32_t)((SHMEM_SLAB_PAGE_SIZE - SHMEM_SLAB_PAGE_HEADER) / slot_size);
+		page->used = 0;
+		page->class_index = index;
+
+		mem_slab_link_page(slabs, page);
+		slabs->pages_num[index]++;
+	}
+
+	if (NULL != page->free_slot)
+	{
+		slot = page->free_slot;
+		page->free_slot = *(void **)((char *)slot + SHMEM_SIZE_FIELD);
+	}
+	else
+		slot = (char *)page + SHMEM_SLAB_PAGE_HEADER + page->slots_num++ * slot_size;
+
+	*(zbx_uint64_t *)slot = SHMEM_FLG_USED | SHMEM_FLG_SLAB | (zbx_uint64_t)((char *)slot - (char *)page);
+
+	slabs->objects_num[index]++;
+
+	if (++page->used == page->slots_max)
+		mem_slab_unlink_page(slabs, page);
+
+	return slot;
+}
+
+static void	mem_slab_free(zbx_shmem_info_t *info, void *slot)
+{
+	struct zbx_shmem_slabs	*slabs = info->slabs;
+	zbx_shmem_slab_page_t	*page;
+
+	page = mem_slab_get_page(slot);
+
+	*(zbx_uint64_t *)slot = SHMEM_FLG_SLAB | SLAB_OFFSET(slot);
+	*(void **)((char *)slot + SHMEM_SIZE_FIELD) = page->free_slot;
+	page->free_slot = slot;
+	page->used--;
+
+	slabs->objects_num[page->class_index]--;
+
+	if (0 == page->partial)
+		mem_slab_link_page(slabs, page);
+
+	/* keep the last partial page to avoid allocating and freeing pages repeatedly */
+	if (0 == page->used && (NULL != page->prev || NULL != page->next))
+	{
+		mem_slab_unlink_page(slabs, page);
+		slabs->pages_num[page->class_index]--;
+		__mem_free(info, page);
+	}
+}
+
+static void	*mem_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
+{
+	void	*chunk;
+
+	if (NULL != info->slabs && SHMEM_SLAB_MAX_ALLOC >= size && NULL != (chunk = mem_slab_malloc(info, size)))
+		return chunk;
+
+	return __mem_malloc(info, size);
+}
+
+static void	*mem_realloc(zbx_shmem_info_t *info, void *old, zbx_uint64_t size)
+{
+	void		*slot, *chunk;
+	zbx_uint64_t	slot_size;
+
+	slot = (void *)((char *)old - SHMEM_SIZE_FIELD);
+
+	if (0 == SLAB_OBJECT(slot))
+		return __mem_realloc(info, old, size);
+
+	slot_size = mem_slab_size(slot);
+
+	if (SHMEM_SLAB_MAX_ALLOC >= size && slot_size == slab_class_sizes[mem_slab_class_by_size(size)])
+		return slot;
+
+	if (NULL == (chunk = mem_malloc(info, size)))
+		return NULL;
+
+	memcpy((char *)chunk + SHMEM_SIZE_FIELD, old, MIN(size, slot_size));
+	mem_slab_free(info, slot);
+
+	return chunk;
+}
+
+static void	mem_free(zbx_shmem_info_t *info, void *ptr)
+{
+	void	*chunk = (void *)((char *)ptr - SHMEM_SIZE_FIELD);
+
+	if (0 != SLAB_OBJECT(chunk))
+		mem_slab_free(info, chunk);
+	else
+		__mem_free(info, ptr);
+}
+
 /* public memory interface */
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enable huge pages for shared memory segments created afterwards   *
+ *                                                                            *
+ * Parameters: enable - [IN] 1 - back large segments with huge pages          *
+ *                           0 - use normal pages                             *
+ *                                                                            *
+ * Comments: Preallocated huge pages (SHM_HUGETLB) are tried first, if none   *
+ *           are available transparent huge pages are advised for the         *
+ *           segment. Segments smaller than SHMEM_HUGE_PAGES_MIN_SIZE always  *
+ *           use normal pages.                                                *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_shmem_set_huge_pages(int enable)
+{
+	shmem_huge_pages = enable;
+}
+
+#ifdef MADV_HUGEPAGE
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if kernel uses transparent huge pages for shared memory     *
+ *          segments advised with MADV_HUGEPAGE                               *
+ *                                                                            *
+ * Return value: SUCCEED - transparent huge pages are used                    *
+ *               FAIL    - transparent huge pages are not used for shared     *
+ *                         memory or the setting cannot be read               *
+ *                                                                            *
+ * Comments: The selected value of shmem_enabled setting is enclosed in       *
+ *           brackets, for example "always within_size [advise] never deny    *
+ *           force".                                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	shmem_thp_enabled(void)
+{
+	FILE	*f;
+	char	buf[MAX_STRING_LEN], *start, *end;
+	int	ret = FAIL;
+
+	if (NULL == (f = fopen("/sys/kernel/mm/transparent_hugepage/shmem_enabled", "r")))
+		return FAIL;
+
+	if (NULL != fgets(buf, sizeof(buf), f) && NULL != (start = strchr(buf, '[')) &&
+			NULL != (end = strchr(++start, ']')))
+	{
+		*end = '\0';
+
+		if (0 != strcmp(start, "never") && 0 != strcmp(start, "deny"))
+			ret = SUCCEED;
+	}
+
+	zbx_fclose(f);
+
+	return ret;
+}
+#endif
+
 int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error)
 {
-	int	shm_id, index, ret = FAIL;
-	void	*base;
+	int		shm_id, index, ret = FAIL;
+	void		*base;
+	unsigned char	huge_pages;
 
 	descr = ZBX_NULL2STR(descr);
 	param = ZBX_NULL2STR(param);
@@ -552,7 +844,24 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 		goto out;
 	}
 
-	if (-1 == (shm_id = shmget(IPC_PRIVATE, size, 0600)))
+	huge_pages = ZBX_SHMEM_HUGE_PAGES_NONE;
+
+#ifdef SHM_HUGETLB
+	if (0 != shmem_huge_pages && SHMEM_HUGE_PAGES_MIN_SIZE <= size)
+	{
+		/* segment size is rounded up to huge page size by kernel */
+		if (-1 != (shm_id = shmget(IPC_PRIVATE, size, SHM_HUGETLB | 0600)))
+		{
+			huge_pages = ZBX_SHMEM_HUGE_PAGES_EXPLICIT;
+		}
+		else
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot get huge pages of shared memory for %s, falling back to"
+					" normal pages: %s", descr, zbx_strerror(errno));
+		}
+	}
+#endif
+	if (ZBX_SHMEM_HUGE_PAGES_NONE == huge_pages && -1 == (shm_id = shmget(IPC_PRIVATE, size, 0600)))
 	{
 		*error = zbx_dsprintf(*error, "cannot get private shared memory of size " ZBX_FS_SIZE_T " for %s: %s",
 				(zbx_fs_size_t)size, descr, zbx_strerror(errno));
@@ -565,6 +874,30 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 		goto out;
 	}
 
+#ifdef MADV_HUGEPAGE
+	/* transparent huge pages are used for shared memory if enabled in 'shmem_enabled' kernel setting */
+	if (0 != shmem_huge_pages && ZBX_SHMEM_HUGE_PAGES_NONE == huge_pages && SHMEM_HUGE_PAGES_MIN_SIZE <= size)
+	{
+		if (0 == madvise(base, size, MADV_HUGEPAGE))
+		{
+			if (SUCCEED == shmem_thp_enabled())
+			{
+				huge_pages = ZBX_SHMEM_HUGE_PAGES_TRANSPARENT;
+			}
+			else
+			{
+				zabbix_log(LOG_LEVEL_WARNING, "transparent huge pages are not enabled for shared memory"
+						" in kernel, using normal pages for %s", descr);
+			}
+		}
+		else
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "cannot advise transparent huge pages for %s: %s", descr,
+					zbx_strerror(errno));
+		}
+	}
+#endif
+
 	if (-1 == shmctl(shm_id, IPC_RMID, NULL))
 		zbx_error("cannot mark shared memory %d for destruction: %s", shm_id, zbx_strerror(errno));
 
@@ -596,6 +929,8 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 	base = (void *)((char *)base + strlen(param) + 1);
 
 	(*info)->allow_oom = allow_oom;
+	(*info)->huge_pages = huge_pages;
+	(*info)->slabs = NULL;
 
 	/* prepare shared memory for further allocation by creating one big chunk */
 	(*info)->lo_bound = ALIGN8(base);
@@ -613,10 +948,10 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 	(*info)->used_size = 0;
 	(*info)->free_size = (*info)->total_size;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "valid user addresses: [%p, %p] total size: " ZBX_FS_SIZE_T,
+	zabbix_log(LOG_LEVEL_DEBUG, "valid user addresses: [%p, %p] total size: " ZBX_FS_SIZE_T " huge pages:%d",
 			(void *)((char *)(*info)->lo_bound + SHMEM_SIZE_FIELD),
 			(void *)((char *)(*info)->hi_bound - SHMEM_SIZE_FIELD),
-			(zbx_fs_size_t)(*info)->total_size);
+			(zbx_fs_size_t)(*info)->total_size, (int)huge_pages);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
@@ -683,7 +1018,7 @@ void	*__zbx_shmem_malloc(const char *file, int line, zbx_shmem_info_t *info, con
 		exit(EXIT_FAILURE);
 	}
 
-	chunk = __mem_malloc(info, size);
+	chunk = mem_malloc(info, size);
 
 	if (NULL == chunk)
 	{
@@ -715,9 +1050,9 @@ void	*__zbx_shmem_realloc(const char *file, int line, zbx_shmem_info_t *info, vo
 	}
 
 	if (NULL == old)
-		chunk = __mem_malloc(info, size);
+		chunk = mem_malloc(info, size);
 	else
-		chunk = __mem_realloc(info, old, size);
+		chunk = mem_realloc(info, old, size);
 
 	if (NULL == chunk)
 	{
@@ -745,7 +1080,7 @@ void	__zbx_shmem_free(const char *file, int line, zbx_shmem_info_t *info, void *
 		exit(EXIT_FAILURE);
 	}
 
-	__mem_free(info, ptr);
+	mem_free(info, ptr);
 }
 
 void	zbx_shmem_clear(zbx_shmem_info_t *info)
@@ -763,9 +1098,55 @@ void	zbx_shmem_clear(zbx_shmem_info_t *info)
 	info->used_size = 0;
 	info->free_size = info->total_size;
 
+	/* slab allocator data was stored in the cleared memory */
+	if (NULL != info->slabs)
+	{
+		info->slabs = NULL;
+		zbx_shmem_enable_slabs(info);
+	}
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enable slab allocator for small objects                           *
+ *                                                                            *
+ * Parameters: info - [IN] the shared memory                                  *
+ *                                                                            *
+ * Comments: Allocations up to SHMEM_SLAB_MAX_ALLOC bytes are served from     *
+ *           per size class pages. This reduces per object overhead and       *
+ *           fragmentation of the chunk allocator by small objects, and keeps *
+ *           free lists short. Slabs are not enabled for segments smaller     *
+ *           than SHMEM_SLAB_MIN_TOTAL bytes.                                 *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_shmem_enable_slabs(zbx_shmem_info_t *info)
+{
+	void	*chunk;
+
+	if (NULL != info->slabs || SHMEM_SLAB_MIN_TOTAL > info->total_size)
+		return;
+
+	if (NULL == (chunk = __mem_malloc(info, sizeof(struct zbx_shmem_slabs))))
+		return;
+
+	info->slabs = (struct zbx_shmem_slabs *)((char *)chunk + SHMEM_SIZE_FIELD);
+	memset(info->slabs, 0, sizeof(struct zbx_shmem_slabs));
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s(): enabled slab allocator for %s", __func__, info->mem_descr);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get object size of the specified slab size class                  *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint64_t	zbx_shmem_slab_class_size(int index)
+{
+	return slab_class_sizes[index];
+}
+
 void	zbx_shmem_get_stats(const zbx_shmem_info_t *info, zbx_shmem_stats_t *stats)
 {
 	void		*chunk;
@@ -800,6 +1181,23 @@ void	zbx_shmem_get_stats(const zbx_shmem_info_t *info, zbx_shmem_stats_t *stats)
 	stats->used_chunks = stats->overhead / (2 * SHMEM_SIZE_FIELD) + 1 - stats->free_chunks;
 	stats->free_size = info->free_size;
 	stats->used_size = info->used_size;
+
+	stats->slab_size = 0;
+	stats->slab_used_size = 0;
+
+	for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+	{
+		if (NULL != info->slabs)
+		{
+			stats->slab_pages_num[i] = info->slabs->pages_num[i];
+			stats->slab_objects_num[i] = info->slabs->objects_num[i];
+		}
+		else
+			stats->slab_pages_num[i] = stats->slab_objects_num[i] = 0;
+
+		stats->slab_size += (zbx_uint64_t)stats->slab_pages_num[i] * SHMEM_SLAB_PAGE_SIZE;
+		stats->slab_used_size += (zbx_uint64_t)stats->slab_objects_num[i] * slab_class_sizes[i];
+	}
 }
 
 void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info)
@@ -833,6 +1231,27 @@ void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info)
 	zabbix_log(level, "of those, %10llu bytes are used by allocation overhead",
 			(unsigned long long)stats.overhead);
 
+	if (0 != stats.free_size)
+	{
+		zabbix_log(level, "external fragmentation: %.2f%%",
+				100.0 * (1.0 - (double)stats.max_chunk_size / (double)stats.free_size));
+	}
+
+	if (0 != stats.slab_size)
+	{
+		for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+		{
+			if (0 == stats.slab_pages_num[i])
+				continue;
+
+			zabbix_log(level, "slab objects of size %3d bytes: %8u in %6u pages", (int)slab_class_sizes[i],
+					stats.slab_objects_num[i], stats.slab_pages_num[i]);
+		}
+
+		zabbix_log(level, "slab pages take %10llu bytes, %10llu bytes are used by objects",
+				(unsigned long long)stats.slab_size, (unsigned long long)stats.slab_used_size);
+	}
+
 	zabbix_log(level, "================================");
 }
 
@@ -37,6 +37,90 @@
 #include "zbx_item_constants.h"
 #include "zbxpreproc.h"
 
+#define ZBX_SNMPTRAP_MATCH_IGNORE	0	/* item key is not a valid snmptrap key */
+#define ZBX_SNMPTRAP_MATCH_ANY		1	/* snmptrap key without regular expression */
+#define ZBX_SNMPTRAP_MATCH_REGEXP	2	/* snmptrap key with regular expression */
+#define ZBX_SNMPTRAP_MATCH_FALLBACK	3	/* snmptrap.fallback key */
+#define ZBX_SNMPTRAP_MATCH_ERROR	4	/* item key cannot be matched, item becomes not supported */
+
+#define ZBX_SNMPTRAP_PATTERN_PENDING	(-3)	/* pattern was not matched against trap yet */
+
+/* SNMP trap item matcher, prepared from item key once per configuration revision */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	unsigned char	type;
+	int		patternid;	/* index of regular expression in interface matcher patterns */
+	char		*error;		/* error message of ZBX_SNMPTRAP_MATCH_ERROR matcher */
+}
+zbx_snmptrap_matcher_t;
+
+/* regular expression used by snmptrap item keys, shared by items of the same interface */
+typedef struct
+{
+	char		*pattern;
+	zbx_regexp_t	*regexp;	/* precompiled regular expression, NULL for global regular */
+					/* expressions and for patterns that were not precompiled  */
+}
+zbx_snmptrap_pattern_t;
+
+ZBX_PTR_VECTOR_DECL(snmptrap_pattern_ptr, zbx_snmptrap_pattern_t *)
+ZBX_PTR_VECTOR_IMPL(snmptrap_pattern_ptr, zbx_snmptrap_pattern_t *)
+
+/* SNMP trap item matchers of one interface */
+typedef struct
+{
+	zbx_uint64_t				interfaceid;
+	zbx_hashset_t				matchers;
+	zbx_vector_snmptrap_pattern_ptr_t	patterns;
+	zbx_vector_expression_t			regexps;	/* global regular expressions used by patterns */
+}
+zbx_snmptrap_matchset_t;
+
+/* trap read from SNMP trapper file and waiting to be processed */
+typedef struct
+{
+	char		*addr;
+	char		*trap;
+	zbx_timespec_t	ts;
+	int		ret;		/* SUCCEED if trap was added to any item */
+}
+zbx_snmptrap_t;
+
+ZBX_PTR_VECTOR_DECL(snmptrap_ptr, zbx_snmptrap_t *)
+ZBX_PTR_VECTOR_IMPL(snmptrap_ptr, zbx_snmptrap_t *)
+
+/* SNMP trap item data required to add trap value */
+typedef struct
+{
+	zbx_uint64_t		itemid;
+	zbx_uint64_t		hostid;
+	zbx_snmptrap_matcher_t	*matcher;
+	char			*logtimefmt;	/* log time format of log items, NULL otherwise */
+	unsigned char		value_type;
+	unsigned char		flags;
+	int			errcode;	/* SUCCEED - trap matched, NOTSUPPORTED - matching failed, */
+						/* FAIL - trap did not match item                          */
+}
+zbx_snmptrap_item_t;
+
+/* trap to be matched against SNMP trap items of one interface */
+typedef struct
+{
+	zbx_snmptrap_t		*trap;
+	zbx_snmptrap_matchset_t	*matchset;
+	zbx_snmptrap_item_t	*items;
+	int			items_num;
+}
+zbx_snmptrap_match_t;
+
+ZBX_PTR_VECTOR_DECL(snmptrap_match_ptr, zbx_snmptrap_match_t *)
+ZBX_PTR_VECTOR_IMPL(snmptrap_match_ptr, zbx_snmptrap_match_t *)
+
+/* threads matching traps, matches are split between threads by interface so */
+/* precompiled regular expressions are never used by several threads at once */
+static zbx_thread_pool_t	workers;
+
 static int	trap_fd = -1;
 static off_t	trap_lastsize;
 static ino_t	trap_ino = 0;
@@ -44,6 +128,10 @@ static char	*buffer = NULL;
 static int	offset = 0;
 static int	force = 0;
 
+static zbx_hashset_t			matchsets;
+static zbx_uint64_t			matchsets_revision = 0;
+static zbx_vector_snmptrap_ptr_t	traps;
+
 static void	DBget_lastsize(void)
 {
 	zbx_db_result_t	result;
@@ -73,100 +161,341 @@ static void	db_update_lastsize(void)
 	zbx_db_commit();
 }
 
+static void	snmptrap_matcher_clean(void *data)
+{
+	zbx_snmptrap_matcher_t	*matcher = (zbx_snmptrap_matcher_t *)data;
+
+	zbx_free(matcher->error);
+}
+
+static void	snmptrap_pattern_free(zbx_snmptrap_pattern_t *pattern)
+{
+	if (NULL != pattern->regexp)
+		zbx_regexp_free(pattern->regexp);
+
+	zbx_free(pattern->pattern);
+	zbx_free(pattern);
+}
+
+static void	snmptrap_matchset_clean(void *data)
+{
+	zbx_snmptrap_matchset_t	*matchset = (zbx_snmptrap_matchset_t *)data;
+
+	zbx_hashset_destroy(&matchset->matchers);
+
+	zbx_vector_snmptrap_pattern_ptr_clear_ext(&matchset->patterns, snmptrap_pattern_free);
+	zbx_vector_snmptrap_pattern_ptr_destroy(&matchset->patterns);
+
+	zbx_regexp_clean_expressions(&matchset->regexps);
+	zbx_vector_expression_destroy(&matchset->regexps);
+}
+
+static void	snmptrap_free(zbx_snmptrap_t *trap)
+{
+	zbx_free(trap->addr);
+	zbx_free(trap->trap);
+	zbx_free(trap);
+}
+
+static void	snmptrap_match_free(zbx_snmptrap_match_t *match)
+{
+	for (int i = 0; i < match->items_num; i++)
+		zbx_free(match->items[i].logtimefmt);
+
+	zbx_free(match->items);
+	zbx_free(match);
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: adds trap to all matching items for specified interface           *
+ * Purpose: gets item matchers of the specified interface                     *
  *                                                                            *
- * Return value: SUCCEED - matching item was found                            *
- *               FAIL - no matching item was found (including fallback items) *
+ * Comments: Matchers are cached until configuration cache revision           *
+ *           changes.                                                         *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_snmptrap_matchset_t	*snmptrap_matchset_get(zbx_uint64_t interfaceid)
+{
+	zbx_snmptrap_matchset_t	*matchset, matchset_local;
+
+	if (NULL != (matchset = (zbx_snmptrap_matchset_t *)zbx_hashset_search(&matchsets, &interfaceid)))
+		return matchset;
+
+	matchset_local.interfaceid = interfaceid;
+	matchset = (zbx_snmptrap_matchset_t *)zbx_hashset_insert(&matchsets, &matchset_local,
+			sizeof(matchset_local));
+
+	zbx_hashset_create_ext(&matchset->matchers, 0, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, snmptrap_matcher_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+			ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_vector_snmptrap_pattern_ptr_create(&matchset->patterns);
+	zbx_vector_expression_create(&matchset->regexps);
+
+	return matchset;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds regular expression to interface matchers                     *
+ *                                                                            *
+ * Return value: index of the regular expression in matcher set patterns      *
+ *                                                                            *
+ * Comments: Items using the same regular expression share the pattern, so    *
+ *           it is matched only once per trap.                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmptrap_matchset_add_pattern(zbx_snmptrap_matchset_t *matchset, const char *regex)
+{
+	zbx_snmptrap_pattern_t	*pattern;
+	char			*error = NULL;
+
+	for (int i = 0; i < matchset->patterns.values_num; i++)
+	{
+		if (0 == strcmp(matchset->patterns.values[i]->pattern, regex))
+			return i;
+	}
+
+	pattern = (zbx_snmptrap_pattern_t *)zbx_malloc(NULL, sizeof(zbx_snmptrap_pattern_t));
+	pattern->pattern = zbx_strdup(NULL, regex);
+	pattern->regexp = NULL;
+
+	/* Regular expressions failing to compile without capture groups (back references) are left */
+	/* to zbx_regexp_match_ex(), which also reports invalid regular expressions.                */
+	if ('@' != *regex && FAIL == zbx_regexp_compile(regex, &pattern->regexp, &error))
+	{
+		pattern->regexp = NULL;
+		zbx_free(error);
+	}
+
+	zbx_vector_snmptrap_pattern_ptr_append(&matchset->patterns, pattern);
+
+	return matchset->patterns.values_num - 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets matcher of SNMP trap item                                    *
+ *                                                                            *
+ * Parameters: matchset - [IN] matchers of the item interface                 *
+ *             item     - [IN] SNMP trap item                                 *
+ *                                                                            *
+ * Return value: item matcher                                                 *
+ *                                                                            *
+ * Comments: Item key macros are resolved and the key is parsed only when     *
+ *           item matcher is created, it must be called with user macro cache *
+ *           opened.                                                          *
  *                                                                            *
  ******************************************************************************/
-static int	process_trap_for_interface(zbx_uint64_t interfaceid, char *trap, zbx_timespec_t *ts)
+static zbx_snmptrap_matcher_t	*snmptrap_matcher_get(zbx_snmptrap_matchset_t *matchset, zbx_dc_item_t *item)
 {
-	zbx_dc_item_t		*items = NULL;
+	zbx_snmptrap_matcher_t	*matcher, matcher_local;
 	const char		*regex;
 	char			error[ZBX_ITEM_ERROR_LEN_MAX];
-	int			ret = FAIL, fb = -1, value_type, regexp_ret;
 	AGENT_REQUEST		request;
-	zbx_vector_expression_t	regexps;
-	zbx_dc_um_handle_t	*um_handle;
 
-	zbx_vector_expression_create(&regexps);
+	if (NULL != (matcher = (zbx_snmptrap_matcher_t *)zbx_hashset_search(&matchset->matchers, &item->itemid)))
+		return matcher;
 
-	um_handle = zbx_dc_open_user_macros();
+	matcher_local.itemid = item->itemid;
+	matcher_local.type = ZBX_SNMPTRAP_MATCH_IGNORE;
+	matcher_local.patternid = -1;
+	matcher_local.error = NULL;
 
-	size_t			num = zbx_dc_config_get_snmp_items_by_interfaceid(interfaceid, &items);
-	zbx_uint64_t		*itemids = (zbx_uint64_t *)zbx_malloc(NULL, sizeof(zbx_uint64_t) * num);
-	int			*lastclocks = (int *)zbx_malloc(NULL, sizeof(int) * num),
-				*errcodes = (int *)zbx_malloc(NULL, sizeof(int) * num);
-	AGENT_RESULT		*results = (AGENT_RESULT *)zbx_malloc(NULL, sizeof(AGENT_RESULT) * num);
+	item->key = zbx_strdup(item->key, item->key_orig);
+	if (SUCCEED != zbx_substitute_key_macros(&item->key, NULL, item, NULL, NULL, ZBX_MACRO_TYPE_ITEM_KEY, error,
+			sizeof(error)))
+	{
+		matcher_local.type = ZBX_SNMPTRAP_MATCH_ERROR;
+		matcher_local.error = zbx_strdup(NULL, error);
+		goto out;
+	}
 
-	for (size_t i = 0; i < num; i++)
+	if (0 == strcmp(item->key, "snmptrap.fallback"))
 	{
-		zbx_init_agent_result(&results[i]);
-		errcodes[i] = FAIL;
+		matcher_local.type = ZBX_SNMPTRAP_MATCH_FALLBACK;
+		goto out;
+	}
 
-		items[i].key = zbx_strdup(items[i].key, items[i].key_orig);
-		if (SUCCEED != zbx_substitute_key_macros(&items[i].key, NULL, &items[i], NULL, NULL,
-				ZBX_MACRO_TYPE_ITEM_KEY, error, sizeof(error)))
+	zbx_init_agent_request(&request);
+
+	if (SUCCEED != zbx_parse_item_key(item->key, &request))
+		goto next;
+
+	if (0 != strcmp(get_rkey(&request), "snmptrap"))
+		goto next;
+
+	if (1 < get_rparams_num(&request))
+		goto next;
+
+	if (NULL == (regex = get_rparam(&request, 0)) || '\0' == *regex)
+	{
+		matcher_local.type = ZBX_SNMPTRAP_MATCH_ANY;
+		goto next;
+	}
+
+	if ('@' == *regex && SUCCEED != zbx_global_regexp_exists(regex + 1, &matchset->regexps))
+	{
+		zbx_dc_get_expressions_by_name(&matchset->regexps, regex + 1);
+
+		if (SUCCEED != zbx_global_regexp_exists(regex + 1, &matchset->regexps))
 		{
-			SET_MSG_RESULT(&results[i], zbx_strdup(NULL, error));
-			errcodes[i] = NOTSUPPORTED;
-			continue;
+			matcher_local.type = ZBX_SNMPTRAP_MATCH_ERROR;
+			matcher_local.error = zbx_dsprintf(NULL, "Global regular expression \"%s\" does not exist.",
+					regex + 1);
+			goto next;
 		}
+	}
+
+	matcher_local.type = ZBX_SNMPTRAP_MATCH_REGEXP;
+	matcher_local.patternid = snmptrap_matchset_add_pattern(matchset, regex);
+next:
+	zbx_free_agent_request(&request);
+out:
+	zbx_free(item->key);
 
-		if (0 == strcmp(items[i].key, "snmptrap.fallback"))
+	return (zbx_snmptrap_matcher_t *)zbx_hashset_insert(&matchset->matchers, &matcher_local,
+			sizeof(matcher_local));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: matches trap against SNMP trap items of one interface             *
+ *                                                                            *
+ * Comments: This function is called by matching threads, it must not         *
+ *           access configuration cache or modify interface matchers.         *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmptrap_match_items(zbx_snmptrap_match_t *match)
+{
+	int	*results, patterns_num = match->matchset->patterns.values_num;
+
+	/* every pattern is matched against the trap at most once */
+	results = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)patterns_num);
+
+	for (int i = 0; i < patterns_num; i++)
+		results[i] = ZBX_SNMPTRAP_PATTERN_PENDING;
+
+	for (int i = 0; i < match->items_num; i++)
+	{
+		zbx_snmptrap_item_t	*item = &match->items[i];
+		zbx_snmptrap_matcher_t	*matcher = item->matcher;
+		zbx_snmptrap_pattern_t	*pattern;
+
+		switch (matcher->type)
 		{
-			fb = i;
-			continue;
+			case ZBX_SNMPTRAP_MATCH_ANY:
+				item->errcode = SUCCEED;
+				break;
+			case ZBX_SNMPTRAP_MATCH_ERROR:
+				item->errcode = NOTSUPPORTED;
+				break;
+			case ZBX_SNMPTRAP_MATCH_REGEXP:
+				if (ZBX_SNMPTRAP_PATTERN_PENDING == results[matcher->patternid])
+				{
+					pattern = match->matchset->patterns.values[matcher->patternid];
+
+					if (NULL != pattern->regexp)
+					{
+						results[matcher->patternid] = zbx_regexp_match_precompiled2(
+								match->trap->trap, pattern->regexp, NULL);
+					}
+					else
+					{
+						results[matcher->patternid] = zbx_regexp_match_ex(
+								&match->matchset->regexps, match->trap->trap,
+								pattern->pattern, ZBX_CASE_SENSITIVE);
+					}
+				}
+
+				switch (results[matcher->patternid])
+				{
+					case ZBX_REGEXP_MATCH:
+						item->errcode = SUCCEED;
+						break;
+					case ZBX_REGEXP_NO_MATCH:
+						item->errcode = FAIL;
+						break;
+					default:
+						item->errcode = NOTSUPPORTED;
+				}
+				break;
+			default:
+				item->errcode = FAIL;
 		}
+	}
 
-		zbx_init_agent_request(&request);
+	zbx_free(results);
+}
 
-		if (SUCCEED != zbx_parse_item_key(items[i].key, &request))
-			goto next;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: matches traps of interfaces assigned to the specified thread      *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmptrap_workers_match(void *data, int id)
+{
+	zbx_vector_snmptrap_match_ptr_t	*matches = (zbx_vector_snmptrap_match_ptr_t *)data;
 
-		if (0 != strcmp(get_rkey(&request), "snmptrap"))
-			goto next;
+	for (int i = 0; i < matches->values_num; i++)
+	{
+		zbx_snmptrap_match_t	*match = matches->values[i];
 
-		if (1 < get_rparams_num(&request))
-			goto next;
+		if ((zbx_uint64_t)id == match->matchset->interfaceid % (zbx_uint64_t)workers.threads_num)
+			snmptrap_match_items(match);
+	}
+}
 
-		if (NULL != (regex = get_rparam(&request, 0)))
-		{
-			if ('@' == *regex)
-			{
-				zbx_dc_get_expressions_by_name(&regexps, regex + 1);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds matched trap to SNMP trap items of one interface             *
+ *                                                                            *
+ * Return value: SUCCEED - matching item was found                            *
+ *               FAIL - no matching item was found (including fallback items) *
+ *                                                                            *
+ ******************************************************************************/
+static int	process_trap_for_interface(zbx_snmptrap_match_t *match)
+{
+	zbx_snmptrap_item_t	*items = match->items;
+	int			ret = FAIL, fb = -1, value_type, num = match->items_num;
+	zbx_timespec_t		*ts = &match->trap->ts;
+	char			*trap = match->trap->trap;
+	zbx_uint64_t		*itemids = (zbx_uint64_t *)zbx_malloc(NULL, sizeof(zbx_uint64_t) * (size_t)num);
+	int			*lastclocks = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)num),
+				*errcodes = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)num);
+	AGENT_RESULT		*results = (AGENT_RESULT *)zbx_malloc(NULL, sizeof(AGENT_RESULT) * (size_t)num);
+
+	for (int i = 0; i < num; i++)
+	{
+		zbx_snmptrap_matcher_t	*matcher = items[i].matcher;
+
+		zbx_init_agent_result(&results[i]);
 
-				if (0 == regexps.values_num)
+		switch (errcodes[i] = items[i].errcode)
+		{
+			case SUCCEED:
+				value_type = (ITEM_VALUE_TYPE_LOG == items[i].value_type ? ITEM_VALUE_TYPE_LOG :
+						ITEM_VALUE_TYPE_TEXT);
+				zbx_set_agent_result_type(&results[i], value_type, trap);
+				ret = SUCCEED;
+				break;
+			case NOTSUPPORTED:
+				if (ZBX_SNMPTRAP_MATCH_ERROR == matcher->type)
 				{
-					SET_MSG_RESULT(&results[i], zbx_dsprintf(NULL,
-							"Global regular expression \"%s\" does not exist.", regex + 1));
-					errcodes[i] = NOTSUPPORTED;
-					goto next;
+					SET_MSG_RESULT(&results[i], zbx_strdup(NULL, matcher->error));
 				}
-			}
+				else
+				{
+					zbx_snmptrap_pattern_t	*pattern;
 
-			if (ZBX_REGEXP_NO_MATCH == (regexp_ret = zbx_regexp_match_ex(&regexps, trap, regex,
-					ZBX_CASE_SENSITIVE)))
-			{
-				goto next;
-			}
-			else if (FAIL == regexp_ret)
-			{
-				SET_MSG_RESULT(&results[i], zbx_dsprintf(NULL,
-						"Invalid regular expression \"%s\".", regex));
-				errcodes[i] = NOTSUPPORTED;
-				goto next;
-			}
+					pattern = match->matchset->patterns.values[matcher->patternid];
+					SET_MSG_RESULT(&results[i], zbx_dsprintf(NULL,
+							"Invalid regular expression \"%s\".", pattern->pattern));
+				}
+				break;
+			default:
+				if (ZBX_SNMPTRAP_MATCH_FALLBACK == matcher->type)
+					fb = i;
 		}
-
-		value_type = (ITEM_VALUE_TYPE_LOG == items[i].value_type ? ITEM_VALUE_TYPE_LOG : ITEM_VALUE_TYPE_TEXT);
-		zbx_set_agent_result_type(&results[i], value_type, trap);
-		errcodes[i] = SUCCEED;
-		ret = SUCCEED;
-next:
-		zbx_free_agent_request(&request);
 	}
 
 	if (FAIL == ret && -1 != fb)
@@ -177,7 +506,7 @@ next:
 		ret = SUCCEED;
 	}
 
-	for (size_t i = 0; i < num; i++)
+	for (int i = 0; i < num; i++)
 	{
 		switch (errcodes[i])
 		{
@@ -188,51 +517,38 @@ next:
 							items[i].logtimefmt);
 				}
 
-				items[i].state = ITEM_STATE_NORMAL;
-				zbx_preprocess_item_value(items[i].itemid, items[i].host.hostid, items[i].value_type,
-						items[i].flags, &results[i], ts, items[i].state, NULL);
+				zbx_preprocess_item_value(items[i].itemid, items[i].hostid, items[i].value_type,
+						items[i].flags, &results[i], ts, ITEM_STATE_NORMAL, NULL);
 
 				itemids[i] = items[i].itemid;
 				lastclocks[i] = ts->sec;
 				break;
 			case NOTSUPPORTED:
-				items[i].state = ITEM_STATE_NOTSUPPORTED;
-				zbx_preprocess_item_value(items[i].itemid, items[i].host.hostid, items[i].value_type,
-						items[i].flags, NULL, ts, items[i].state, results[i].msg);
+				zbx_preprocess_item_value(items[i].itemid, items[i].hostid, items[i].value_type,
+						items[i].flags, NULL, ts, ITEM_STATE_NOTSUPPORTED, results[i].msg);
 
 				itemids[i] = items[i].itemid;
 				lastclocks[i] = ts->sec;
 				break;
 		}
 
-		zbx_free(items[i].key);
 		zbx_free_agent_result(&results[i]);
 	}
 
 	zbx_free(results);
 
-	zbx_dc_requeue_items(itemids, lastclocks, errcodes, num);
+	zbx_dc_requeue_items(itemids, lastclocks, errcodes, (size_t)num);
 
 	zbx_free(errcodes);
 	zbx_free(lastclocks);
 	zbx_free(itemids);
 
-	zbx_dc_config_clean_items(items, NULL, num);
-	zbx_free(items);
-
-	zbx_dc_close_user_macros(um_handle);
-
-	zbx_regexp_clean_expressions(&regexps);
-	zbx_vector_expression_destroy(&regexps);
-
-	zbx_preprocessor_flush();
-
 	return ret;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: processes single trap                                             *
+ * Purpose: queues single trap for processing                                 *
  *                                                                            *
  * Parameters: addr  - [IN] address of target interface(s)                    *
  *             begin - [IN] beginning of trap message                         *
@@ -241,42 +557,162 @@ next:
  ******************************************************************************/
 static void	process_trap(const char *addr, char *begin, char *end)
 {
-	zbx_timespec_t	ts;
-	zbx_uint64_t	*interfaceids = NULL;
-	int		ret = FAIL;
-	char		*trap = NULL;
+	zbx_snmptrap_t	*trap;
+
+	trap = (zbx_snmptrap_t *)zbx_malloc(NULL, sizeof(zbx_snmptrap_t));
+	trap->addr = zbx_strdup(NULL, addr);
+	trap->trap = zbx_dsprintf(NULL, "%s%s", begin, end);
+	trap->ret = FAIL;
+	zbx_timespec(&trap->ts);
+
+	zbx_vector_snmptrap_ptr_append(&traps, trap);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares queued traps for matching against SNMP trap items of     *
+ *          their target interfaces                                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	prepare_trap_matches(zbx_vector_snmptrap_match_ptr_t *matches)
+{
+	zbx_uint64_t		revision;
+	zbx_dc_um_handle_t	*um_handle;
+
+	if (matchsets_revision != (revision = zbx_dc_get_config_revision()))
+	{
+		zbx_hashset_clear(&matchsets);
+		matchsets_revision = revision;
+	}
+
+	um_handle = zbx_dc_open_user_macros();
+
+	for (int i = 0; i < traps.values_num; i++)
+	{
+		zbx_snmptrap_t	*trap = traps.values[i];
+		zbx_uint64_t	*interfaceids = NULL;
+		int		count;
+
+		count = zbx_dc_config_get_snmp_interfaceids_by_addr(trap->addr, &interfaceids);
+
+		for (int j = 0; j < count; j++)
+		{
+			zbx_snmptrap_match_t	*match;
+			zbx_dc_item_t		*items = NULL;
+			size_t			items_num;
+
+			if (0 == (items_num = zbx_dc_config_get_snmp_items_by_interfaceid(interfaceids[j], &items)))
+			{
+				zbx_free(items);
+				continue;
+			}
+
+			match = (zbx_snmptrap_match_t *)zbx_malloc(NULL, sizeof(zbx_snmptrap_match_t));
+			match->trap = trap;
+			match->matchset = snmptrap_matchset_get(interfaceids[j]);
+			match->items = (zbx_snmptrap_item_t *)zbx_malloc(NULL, sizeof(zbx_snmptrap_item_t) * items_num);
+			match->items_num = (int)items_num;
+
+			/* keep only the item data required to add values, the traps are matched later */
+			for (size_t k = 0; k < items_num; k++)
+			{
+				zbx_snmptrap_item_t	*item = &match->items[k];
+
+				item->itemid = items[k].itemid;
+				item->hostid = items[k].host.hostid;
+				item->matcher = snmptrap_matcher_get(match->matchset, &items[k]);
+				item->logtimefmt = (ITEM_VALUE_TYPE_LOG == items[k].value_type ?
+						zbx_strdup(NULL, items[k].logtimefmt) : NULL);
+				item->value_type = items[k].value_type;
+				item->flags = items[k].flags;
+				item->errcode = FAIL;
+			}
+
+			zbx_dc_config_clean_items(items, NULL, items_num);
+			zbx_free(items);
+
+			zbx_vector_snmptrap_match_ptr_append(matches, match);
+		}
+
+		zbx_free(interfaceids);
+	}
 
-	zbx_timespec(&ts);
+	zbx_dc_close_user_macros(um_handle);
+}
 
-	trap = zbx_dsprintf(trap, "%s%s", begin, end);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes queued traps                                            *
+ *                                                                            *
+ * Comments: Traps are matched against items by matching threads, the item    *
+ *           values are added in the same order as traps were received.       *
+ *                                                                            *
+ ******************************************************************************/
+static void	process_traps(void)
+{
+	zbx_vector_snmptrap_match_ptr_t	matches;
+	int				unmatched_num = 0;
+
+	if (0 == traps.values_num)
+		return;
+
+	zbx_vector_snmptrap_match_ptr_create(&matches);
+
+	prepare_trap_matches(&matches);
+	zbx_thread_pool_run(&workers, snmptrap_workers_match, &matches);
+
+	for (int i = 0; i < matches.values_num; i++)
+	{
+		zbx_snmptrap_match_t	*match = matches.values[i];
+
+		if (SUCCEED == process_trap_for_interface(match))
+			match->trap->ret = SUCCEED;
+	}
 
-	int	count = zbx_dc_config_get_snmp_interfaceids_by_addr(addr, &interfaceids);
+	zbx_preprocessor_flush();
 
-	for (int i = 0; i < count; i++)
+	for (int i = 0; i < traps.values_num; i++)
 	{
-		if (SUCCEED == process_trap_for_interface(interfaceids[i], trap, &ts))
-			ret = SUCCEED;
+		if (FAIL == traps.values[i]->ret)
+			unmatched_num++;
 	}
 
-	if (FAIL == ret)
+	if (0 != unmatched_num)
 	{
 		zbx_config_t	cfg;
 
 		zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_SNMPTRAP_LOGGING);
 
 		if (ZBX_SNMPTRAP_LOGGING_ENABLED == cfg.snmptrap_logging)
-			zabbix_log(LOG_LEVEL_WARNING, "unmatched trap received from \"%s\": %s", addr, trap);
+		{
+			for (int i = 0; i < traps.values_num; i++)
+			{
+				zbx_snmptrap_t	*trap = traps.values[i];
+
+				if (FAIL == trap->ret)
+				{
+					zabbix_log(LOG_LEVEL_WARNING, "unmatched trap received from \"%s\": %s",
+							trap->addr, trap->trap);
+				}
+			}
+		}
 
 		zbx_config_clean(&cfg);
 	}
 
-	zbx_free(interfaceids);
-	zbx_free(trap);
+	zbx_vector_snmptrap_match_ptr_clear_ext(&matches, snmptrap_match_free);
+	zbx_vector_snmptrap_match_ptr_destroy(&matches);
+
+	zbx_vector_snmptrap_ptr_clear_ext(&traps, snmptrap_free);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: splits traps and processes them with process_trap()               *
+ * Purpose: splits traps and processes them with process_traps()              *
+ *                                                                            *
+ * Comments: All traps found in the buffer are processed before returning, so *
+ *           the processed file size is kept consistent with the buffer       *
+ *           offset.                                                          *
  *                                                                            *
  ******************************************************************************/
 static void	parse_traps(int flag)
@@ -378,6 +814,8 @@ static void	parse_traps(int flag)
 			*buffer = '\0';
 		}
 	}
+
+	process_traps();
 }
 
 /******************************************************************************
@@ -611,6 +1049,14 @@ ZBX_THREAD_ENTRY(zbx_snmptrapper_thread, args)
 	buffer = (char *)zbx_malloc(buffer, MAX_BUFFER_LEN);
 	*buffer = '\0';
 
+	zbx_hashset_create_ext(&matchsets, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			snmptrap_matchset_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC,
+			ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_vector_snmptrap_ptr_create(&traps);
+
+	zbx_thread_pool_init(&workers, "SNMP trapper", snmptrapper_args_in->config_snmptrapper_threads,
+			zbx_init_regexp_env);
+
 	while (ZBX_IS_RUNNING())
 	{
 		sec = zbx_time();
@@ -631,6 +1077,9 @@ ZBX_THREAD_ENTRY(zbx_snmptrapper_thread, args)
 
 	zbx_free(buffer);
 
+	zbx_vector_snmptrap_ptr_destroy(&traps);
+	zbx_hashset_destroy(&matchsets);
+
 	if (-1 != trap_fd)
 		close(trap_fd);
 
@@ -169,6 +169,8 @@ void	zbx_zabbix_stats_get(struct zbx_json *json, int config_startup_time)
 	zbx_json_addfloat(json, "pfree", *(double *)zbx_dc_config_get_stats(ZBX_CONFSTATS_BUFFER_PFREE));
 	zbx_json_adduint64(json, "used", *(zbx_uint64_t *)zbx_dc_config_get_stats(ZBX_CONFSTATS_BUFFER_USED));
 	zbx_json_addfloat(json, "pused", *(double *)zbx_dc_config_get_stats(ZBX_CONFSTATS_BUFFER_PUSED));
+	zbx_json_adduint64(json, "hugepages",
+			*(zbx_uint64_t *)zbx_dc_config_get_stats(ZBX_CONFSTATS_BUFFER_HUGE_PAGES));
 	zbx_json_close(json);
 
 	/* zabbix[version] */
@@ -196,6 +198,7 @@ void	zbx_zabbix_stats_get(struct zbx_json *json, int config_startup_time)
 	zbx_json_adduint64(json, "used", wcache_info.history_total - wcache_info.history_free);
 	zbx_json_addfloat(json, "pused", 100 * (double)(wcache_info.history_total - wcache_info.history_free) /
 			(double)wcache_info.history_total);
+	zbx_json_addint64(json, "hugepages", wcache_info.history_huge_pages);
 	zbx_json_close(json);
 
 	zbx_json_addobject(json, "index");
@@ -205,6 +208,7 @@ void	zbx_zabbix_stats_get(struct zbx_json *json, int config_startup_time)
 	zbx_json_adduint64(json, "used", wcache_info.index_total - wcache_info.index_free);
 	zbx_json_addfloat(json, "pused", 100 * (double)(wcache_info.index_total - wcache_info.index_free) /
 			(double)wcache_info.index_total);
+	zbx_json_addint64(json, "hugepages", wcache_info.index_huge_pages);
 	zbx_json_close(json);
 
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
@@ -216,6 +220,7 @@ void	zbx_zabbix_stats_get(struct zbx_json *json, int config_startup_time)
 		zbx_json_adduint64(json, "used", wcache_info.trend_total - wcache_info.trend_free);
 		zbx_json_addfloat(json, "pused", 100 * (double)(wcache_info.trend_total - wcache_info.trend_free) /
 				(double)wcache_info.trend_total);
+		zbx_json_addint64(json, "hugepages", wcache_info.trend_huge_pages);
 		zbx_json_close(json);
 	}
 
@@ -1271,6 +1271,67 @@ notsupported:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if agent item can block the caller for a long time          *
+ *                                                                            *
+ * Parameters: in_command - [IN] item key                                     *
+ *             flags      - [IN] ZBX_PROCESS_WITH_ALIAS to substitute alias   *
+ *                                                                            *
+ * Return value: SUCCEED - the item accesses file system trees, remote        *
+ *                         services or runs external commands                 *
+ *               FAIL    - the item is cheap to evaluate or is not supported  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_agent_check_can_block(const char *in_command, unsigned flags)
+{
+	static const char	*blocking_keys[] = {"system.run", "system.sw.packages", "system.sw.packages.get",
+				"vfs.dir.count", "vfs.dir.get", "vfs.dir.size", "vfs.file.cksum", "vfs.file.md5sum",
+				"vfs.fs.get", "vfs.fs.inode", "vfs.fs.size", "net.dns", "net.dns.perf", "net.dns.record",
+				"net.tcp.service", "net.tcp.service.perf", "net.udp.service", "net.udp.service.perf",
+				"web.page.get", "web.page.perf", "web.page.regexp", NULL};
+	const char		**key;
+	zbx_metric_t		*command;
+	AGENT_REQUEST		request;
+	int			ret = FAIL;
+
+	zbx_init_agent_request(&request);
+
+	if (SUCCEED != zbx_parse_item_key((0 == (flags & ZBX_PROCESS_WITH_ALIAS) ? in_command :
+			zbx_alias_get(in_command)), &request))
+	{
+		goto out;
+	}
+
+	for (command = commands; NULL != command->key; command++)
+	{
+		if (0 == strcmp(command->key, request.key))
+			break;
+	}
+
+	if (NULL == command->key)
+		goto out;
+
+	if (0 != (command->flags & CF_USERPARAMETER))
+	{
+		ret = SUCCEED;
+		goto out;
+	}
+
+	for (key = blocking_keys; NULL != *key; key++)
+	{
+		if (0 == strcmp(*key, request.key))
+		{
+			ret = SUCCEED;
+			break;
+		}
+	}
+out:
+	zbx_free_agent_request(&request);
+
+	return ret;
+}
+
 static void	add_log_result(AGENT_RESULT *result, const char *value)
 {
 	result->log = (zbx_log_t *)zbx_malloc(result->log, sizeof(zbx_log_t));
@@ -0,0 +1,180 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxthreads.h"
+
+#if !defined(_WINDOWS) && !defined(__MINGW32__)
+#include "zbxstr.h"
+#include "zbxlog.h"
+
+typedef struct
+{
+	zbx_thread_pool_t	*pool;
+	int			id;
+	zbx_uint64_t		jobid;
+	pthread_t		thread;
+}
+zbx_thread_pool_thread_t;
+
+static void	*thread_pool_entry(void *args)
+{
+	zbx_thread_pool_thread_t	*thread = (zbx_thread_pool_thread_t *)args;
+	zbx_thread_pool_t		*pool = thread->pool;
+	sigset_t			mask;
+	int				err;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGUSR1);
+	sigaddset(&mask, SIGUSR2);
+	sigaddset(&mask, SIGHUP);
+	sigaddset(&mask, SIGQUIT);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGALRM);
+
+	if (0 != (err = pthread_sigmask(SIG_BLOCK, &mask, NULL)))
+		zabbix_log(LOG_LEVEL_WARNING, "cannot block signals: %s", zbx_strerror(err));
+
+	zabbix_log(LOG_LEVEL_DEBUG, "%s thread #%d started", pool->name, thread->id);
+
+	if (NULL != pool->thread_init)
+		pool->thread_init();
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (1)
+	{
+		while (thread->jobid == pool->jobid)
+			pthread_cond_wait(&pool->event, &pool->lock);
+
+		thread->jobid = pool->jobid;
+		pthread_mutex_unlock(&pool->lock);
+
+		pool->func(pool->data, thread->id);
+
+		pthread_mutex_lock(&pool->lock);
+
+		if (0 == --pool->pending)
+			pthread_cond_signal(&pool->done);
+	}
+
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts worker threads of thread pool                              *
+ *                                                                            *
+ * Parameters: pool        - [OUT] thread pool                                *
+ *             name        - [IN] pool name used in log messages              *
+ *             threads_num - [IN] number of threads, including the main       *
+ *                                thread                                      *
+ *             thread_init - [IN] optional callback executed by every started *
+ *                                thread before processing jobs               *
+ *                                                                            *
+ * Comments: The first thread slot is served by the calling thread, so no     *
+ *           threads are started when threads_num is 1.                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_thread_pool_init(zbx_thread_pool_t *pool, const char *name, int threads_num,
+		zbx_thread_pool_init_func_t thread_init)
+{
+	zbx_thread_pool_thread_t	*threads;
+	pthread_attr_t			attr;
+	int				err;
+
+	pool->name = name;
+	pool->threads_num = threads_num;
+	pool->pending = 0;
+	pool->jobid = 0;
+	pool->thread_init = thread_init;
+	pool->func = NULL;
+	pool->data = NULL;
+
+	if (1 == threads_num)
+		return;
+
+	if (0 != (err = pthread_mutex_init(&pool->lock, NULL)) ||
+			0 != (err = pthread_cond_init(&pool->event, NULL)) ||
+			0 != (err = pthread_cond_init(&pool->done, NULL)))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize %s thread synchronization: %s", name,
+				zbx_strerror(err));
+		exit(EXIT_FAILURE);
+	}
+
+	threads = (zbx_thread_pool_thread_t *)zbx_malloc(NULL, sizeof(zbx_thread_pool_thread_t) *
+			(size_t)threads_num);
+
+	zbx_pthread_init_attr(&attr);
+
+	for (int i = 1; i < threads_num; i++)
+	{
+		threads[i].pool = pool;
+		threads[i].id = i;
+		threads[i].jobid = 0;
+
+		if (0 != (err = pthread_create(&threads[i].thread, &attr, thread_pool_entry, &threads[i])))
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "cannot create %s thread: %s", name, zbx_strerror(err));
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	pthread_attr_destroy(&attr);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes job callback by all pool threads and waits until every   *
+ *          thread has finished                                               *
+ *                                                                            *
+ * Parameters: pool - [IN] thread pool                                        *
+ *             func - [IN] job callback, called once per thread with the      *
+ *                         thread index (0 is the calling thread)             *
+ *             data - [IN] job data                                           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_thread_pool_run(zbx_thread_pool_t *pool, zbx_thread_pool_func_t func, void *data)
+{
+	pool->func = func;
+	pool->data = data;
+
+	if (1 == pool->threads_num)
+	{
+		func(data, 0);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->pending = pool->threads_num - 1;
+	pool->jobid++;
+	pthread_cond_broadcast(&pool->event);
+	pthread_mutex_unlock(&pool->lock);
+
+	func(data, 0);
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (0 != pool->pending)
+		pthread_cond_wait(&pool->done, &pool->lock);
+
+	pthread_mutex_unlock(&pool->lock);
+}
+#endif
@@ -0,0 +1,505 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "trends.h"
+
+#include "zbxcommon.h"
+#include "zbxdb.h"
+#include "zbxcacheconfig.h"
+
+static int	trends_rollups_enabled = 0;
+
+void	zbx_trends_rollups_init(int enabled)
+{
+	trends_rollups_enabled = enabled;
+}
+
+int	zbx_trends_rollups_enabled(void)
+{
+	return trends_rollups_enabled;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get rollup bucket containing the specified timestamp              *
+ *                                                                            *
+ * Parameters: clock  - [IN] timestamp                                        *
+ *             period - [IN] rollup period (ZBX_TRENDS_ROLLUP_*)              *
+ *             start  - [OUT] bucket start                                    *
+ *             next   - [OUT] next bucket start                               *
+ *                                                                            *
+ * Return value: SUCCEED - bucket was calculated                              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_trends_rollup_get_bucket(time_t clock, int period, time_t *start, time_t *next)
+{
+	struct tm	tm;
+	zbx_time_unit_t	unit = (ZBX_TRENDS_ROLLUP_DAY == period ? ZBX_TIME_UNIT_DAY : ZBX_TIME_UNIT_MONTH);
+
+	localtime_r(&clock, &tm);
+	zbx_tm_round_down(&tm, unit);
+
+	if (-1 == (*start = mktime(&tm)))
+		return FAIL;
+
+	zbx_tm_add(&tm, 1, unit);
+
+	if (-1 == (*next = mktime(&tm)))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merge trend data into rollup                                      *
+ *                                                                            *
+ * Parameters: rollup - [IN/OUT] rollup of the same value type as data        *
+ *             data   - [IN] trend data to merge                              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_trends_rollup_merge(zbx_trends_rollup_t *rollup, const zbx_trends_rollup_t *data)
+{
+	if (0 == data->num)
+		return;
+
+	rollup->sum += data->sum;
+
+	if (0 == rollup->num)
+	{
+		rollup->num = data->num;
+		rollup->value_min = data->value_min;
+		rollup->value_avg = data->value_avg;
+		rollup->value_max = data->value_max;
+		return;
+	}
+
+	if (ITEM_VALUE_TYPE_FLOAT == rollup->value_type)
+	{
+		if (data->value_min.dbl < rollup->value_min.dbl)
+			rollup->value_min.dbl = data->value_min.dbl;
+
+		if (data->value_max.dbl > rollup->value_max.dbl)
+			rollup->value_max.dbl = data->value_max.dbl;
+
+		rollup->value_avg.dbl = rollup->value_avg.dbl / (double)(rollup->num + data->num) *
+				(double)rollup->num + data->value_avg.dbl / (double)(rollup->num + data->num) *
+				(double)data->num;
+	}
+	else
+	{
+		if (data->value_min.ui64 < rollup->value_min.ui64)
+			rollup->value_min.ui64 = data->value_min.ui64;
+
+		if (data->value_max.ui64 > rollup->value_max.ui64)
+			rollup->value_max.ui64 = data->value_max.ui64;
+
+		zbx_uinc128_128(&rollup->value_avg.ui64, &data->value_avg.ui64);
+	}
+
+	rollup->num += data->num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merge hourly trend from history cache into rollup                 *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_trends_rollup_merge_trend(zbx_trends_rollup_t *rollup, const ZBX_DC_TREND *trend)
+{
+	zbx_trends_rollup_t	data = {.num = (zbx_uint64_t)trend->num, .value_min = trend->value_min,
+					.value_avg = trend->value_avg, .value_max = trend->value_max};
+
+	if (ITEM_VALUE_TYPE_FLOAT == rollup->value_type)
+		data.sum = trend->value_avg.dbl * (double)trend->num;
+
+	zbx_trends_rollup_merge(rollup, &data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merge trends database row (num,value_min,value_avg,value_max)     *
+ *          into rollup                                                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_trends_rollup_merge_row(zbx_trends_rollup_t *rollup, zbx_db_row_t row)
+{
+	zbx_trends_rollup_t	data = {0};
+
+	ZBX_STR2UINT64(data.num, row[0]);
+
+	if (ITEM_VALUE_TYPE_FLOAT == rollup->value_type)
+	{
+		data.value_min.dbl = atof(row[1]);
+		data.value_avg.dbl = atof(row[2]);
+		data.value_max.dbl = atof(row[3]);
+		data.sum = data.value_avg.dbl * (double)data.num;
+	}
+	else
+	{
+		zbx_uint64_t	avg;
+
+		ZBX_STR2UINT64(data.value_min.ui64, row[1]);
+		ZBX_STR2UINT64(avg, row[2]);
+		ZBX_STR2UINT64(data.value_max.ui64, row[3]);
+		zbx_umul64_64(&data.value_avg.ui64, avg, data.num);
+	}
+
+	zbx_trends_rollup_merge(rollup, &data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get unsigned rollup average value                                 *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uint64_t	zbx_trends_rollup_avg_uint64(const zbx_trends_rollup_t *rollup)
+{
+	zbx_uint128_t	avg;
+
+	if (0 == rollup->num)
+		return 0;
+
+	zbx_udiv128_64(&avg, &rollup->value_avg.ui64, rollup->num);
+
+	return avg.lo;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add hourly trends range to the ranges to read from trends table   *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_add_range(zbx_vector_uint64_pair_t *ranges, time_t from, time_t to)
+{
+	zbx_uint64_pair_t	range;
+
+	if (from >= to)
+		return;
+
+	if (0 != ranges->values_num && ranges->values[ranges->values_num - 1].second == (zbx_uint64_t)from)
+	{
+		ranges->values[ranges->values_num - 1].second = (zbx_uint64_t)to;
+		return;
+	}
+
+	range.first = (zbx_uint64_t)from;
+	range.second = (zbx_uint64_t)to;
+	zbx_vector_uint64_pair_append(ranges, range);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: split trends period into hourly head/tail ranges and the largest  *
+ *          daily/monthly rollup buckets covering the rest of the period      *
+ *                                                                            *
+ * Parameters: lo     - [IN] period start, aligned to hour                    *
+ *             hi     - [IN] period end (exclusive), aligned to hour          *
+ *             days   - [OUT] daily bucket clocks                             *
+ *             months - [OUT] monthly bucket clocks                           *
+ *             ranges - [OUT] hourly trend ranges [from, to)                  *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_split(time_t lo, time_t hi, zbx_vector_uint64_t *days, zbx_vector_uint64_t *months,
+		zbx_vector_uint64_pair_t *ranges)
+{
+	time_t	t = lo, from, next;
+
+	/* find the first local day boundary at or after period start */
+	if (SUCCEED != zbx_trends_rollup_get_bucket(t, ZBX_TRENDS_ROLLUP_DAY, &from, &next))
+		goto out;
+
+	if (from < t)
+		from = next;
+
+	if (SUCCEED != zbx_trends_rollup_get_bucket(from, ZBX_TRENDS_ROLLUP_DAY, &from, &next) || next > hi)
+		goto out;
+
+	trends_rollup_add_range(ranges, t, from);
+	t = from;
+
+	while (t < hi)
+	{
+		time_t	month_from, month_next;
+
+		if (SUCCEED != zbx_trends_rollup_get_bucket(t, ZBX_TRENDS_ROLLUP_MONTH, &month_from, &month_next))
+			break;
+
+		if (month_from == t && month_next <= hi)
+		{
+			zbx_vector_uint64_append(months, (zbx_uint64_t)t);
+			t = month_next;
+			continue;
+		}
+
+		if (SUCCEED != zbx_trends_rollup_get_bucket(t, ZBX_TRENDS_ROLLUP_DAY, &from, &next) || next > hi)
+			break;
+
+		zbx_vector_uint64_append(days, (zbx_uint64_t)t);
+		t = next;
+	}
+out:
+	trends_rollup_add_range(ranges, t, hi);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: mark rollup bucket as read                                        *
+ *                                                                            *
+ * Parameters: buckets - [IN] sorted bucket clocks                            *
+ *             read    - [IN/OUT] read flags, indexed like buckets            *
+ *             clock   - [IN] clock of the read bucket                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_mark_read(const zbx_vector_uint64_t *buckets, unsigned char *read, zbx_uint64_t clock)
+{
+	int	i;
+
+	if (FAIL != (i = zbx_vector_uint64_bsearch(buckets, clock, ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
+		read[i] = 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add hourly trend ranges of the buckets without rollups            *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_add_missing(const zbx_vector_uint64_t *buckets, const unsigned char *read, int period,
+		zbx_vector_uint64_pair_t *ranges)
+{
+	for (int i = 0; i < buckets->values_num; i++)
+	{
+		time_t	from, next;
+
+		if (0 != read[i])
+			continue;
+
+		if (SUCCEED == zbx_trends_rollup_get_bucket((time_t)buckets->values[i], period, &from, &next))
+			trends_rollup_add_range(ranges, from, next);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add rollup bucket clock condition to SQL query                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_add_clocks(char **sql, size_t *sql_alloc, size_t *sql_offset,
+		const zbx_vector_uint64_t *clocks)
+{
+	zbx_strcpy_alloc(sql, sql_alloc, sql_offset, " clock in (");
+
+	for (int i = 0; i < clocks->values_num; i++)
+	{
+		zbx_snprintf_alloc(sql, sql_alloc, sql_offset, "%s" ZBX_FS_UI64, 0 != i ? "," : "",
+				clocks->values[i]);
+	}
+
+	zbx_chrcpy_alloc(sql, sql_alloc, sql_offset, ')');
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate trend function using daily/monthly trend rollups         *
+ *                                                                            *
+ * Parameters: table    - [IN] trends table name                              *
+ *             itemid   - [IN]                                                *
+ *             start    - [IN] period start time in seconds since Epoch       *
+ *             end      - [IN] period end time in seconds since Epoch         *
+ *             function - [IN] trend function                                 *
+ *             value    - [OUT] evaluation result                             *
+ *             state    - [OUT] trend value state                             *
+ *                                                                            *
+ * Return value: SUCCEED - function was evaluated                             *
+ *               FAIL    - rollups are disabled or the period does not cover  *
+ *                         any rollup bucket, hourly trends must be used      *
+ *                                                                            *
+ * Comments: The hourly trends are read only for the period head and tail     *
+ *           and for the buckets without rollups (for example trends written  *
+ *           before the rollups were enabled).                                *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_trends_eval_rollup(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
+		zbx_trend_function_t function, double *value, zbx_trend_state_t *state)
+{
+	zbx_db_result_t			result;
+	zbx_db_row_t			row;
+	char				*sql = NULL;
+	size_t				sql_alloc = 0, sql_offset = 0;
+	time_t				lo, hi;
+	zbx_vector_uint64_t		days, months;
+	zbx_vector_uint64_pair_t	ranges;
+	zbx_trends_rollup_t		rollup = {0};
+	unsigned char			*days_read = NULL, *months_read = NULL;
+	int				ret = FAIL;
+
+	if (0 == trends_rollups_enabled)
+		return FAIL;
+
+	rollup.value_type = (0 == strcmp(table, "trends") ? ITEM_VALUE_TYPE_FLOAT : ITEM_VALUE_TYPE_UINT64);
+
+	zbx_recalc_time_period(&start, ZBX_RECALC_TIME_PERIOD_TRENDS);
+
+	if (start > end)
+		return FAIL;
+
+	/* hourly trend clocks are aligned to hours, align the period so it can be split into */
+	/* [from, to) ranges matching exactly the same trends as [start, end]                  */
+	lo = start + (SEC_PER_HOUR - start % SEC_PER_HOUR) % SEC_PER_HOUR;
+	hi = end - end % SEC_PER_HOUR + SEC_PER_HOUR;
+
+	if (SEC_PER_DAY > hi - lo)
+		return FAIL;
+
+	zbx_vector_uint64_create(&days);
+	zbx_vector_uint64_create(&months);
+	zbx_vector_uint64_pair_create(&ranges);
+
+	trends_rollup_split(lo, hi, &days, &months, &ranges);
+
+	if (0 == days.values_num && 0 == months.values_num)
+		goto out;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select period,clock,num,value_min,value_avg,value_max"
+			" from %s_rollup"
+			" where itemid=" ZBX_FS_UI64
+				" and (",
+			table, itemid);
+
+	if (0 != days.values_num)
+	{
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "period=%d and", ZBX_TRENDS_ROLLUP_DAY);
+		trends_rollup_add_clocks(&sql, &sql_alloc, &sql_offset, &days);
+	}
+
+	if (0 != months.values_num)
+	{
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%speriod=%d and",
+				0 != days.values_num ? " or " : "", ZBX_TRENDS_ROLLUP_MONTH);
+		trends_rollup_add_clocks(&sql, &sql_alloc, &sql_offset, &months);
+	}
+
+	zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
+
+	days_read = (unsigned char *)zbx_calloc(NULL, (size_t)days.values_num, sizeof(unsigned char));
+	months_read = (unsigned char *)zbx_calloc(NULL, (size_t)months.values_num, sizeof(unsigned char));
+
+	result = zbx_db_select("%s", sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t	clock;
+
+		ZBX_STR2UINT64(clock, row[1]);
+
+		if (ZBX_TRENDS_ROLLUP_DAY == atoi(row[0]))
+			trends_rollup_mark_read(&days, days_read, clock);
+		else
+			trends_rollup_mark_read(&months, months_read, clock);
+
+		zbx_trends_rollup_merge_row(&rollup, row + 2);
+	}
+	zbx_db_free_result(result);
+
+	trends_rollup_add_missing(&days, days_read, ZBX_TRENDS_ROLLUP_DAY, &ranges);
+	trends_rollup_add_missing(&months, months_read, ZBX_TRENDS_ROLLUP_MONTH, &ranges);
+
+	if (0 != ranges.values_num)
+	{
+		sql_offset = 0;
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+				"select num,value_min,value_avg,value_max"
+				" from %s"
+				" where itemid=" ZBX_FS_UI64
+					" and (",
+				table, itemid);
+
+		for (int i = 0; i < ranges.values_num; i++)
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%sclock>=" ZBX_FS_UI64 " and clock<"
+					ZBX_FS_UI64, 0 != i ? " or " : "", ranges.values[i].first,
+					ranges.values[i].second);
+		}
+
+		zbx_chrcpy_alloc(&sql, &sql_alloc, &sql_offset, ')');
+
+		result = zbx_db_select("%s", sql);
+
+		while (NULL != (row = zbx_db_fetch(result)))
+			zbx_trends_rollup_merge_row(&rollup, row);
+
+		zbx_db_free_result(result);
+	}
+
+	*state = ZBX_TREND_STATE_NORMAL;
+
+	if (ITEM_VALUE_TYPE_UINT64 == rollup.value_type)
+	{
+		rollup.sum = (double)rollup.value_avg.ui64.hi * 18446744073709551616.0 +
+				(double)rollup.value_avg.ui64.lo;
+	}
+
+	switch (function)
+	{
+		case ZBX_TREND_FUNCTION_AVG:
+			if (ITEM_VALUE_TYPE_FLOAT == rollup.value_type)
+				*value = rollup.value_avg.dbl;
+			else
+				*value = (0 != rollup.num ? rollup.sum / (double)rollup.num : 0);
+			break;
+		case ZBX_TREND_FUNCTION_COUNT:
+			*value = (double)rollup.num;
+			break;
+		case ZBX_TREND_FUNCTION_MAX:
+			if (ITEM_VALUE_TYPE_FLOAT == rollup.value_type)
+				*value = rollup.value_max.dbl;
+			else
+				*value = (double)rollup.value_max.ui64;
+			break;
+		case ZBX_TREND_FUNCTION_MIN:
+			if (ITEM_VALUE_TYPE_FLOAT == rollup.value_type)
+				*value = rollup.value_min.dbl;
+			else
+				*value = (double)rollup.value_min.ui64;
+			break;
+		case ZBX_TREND_FUNCTION_SUM:
+			if (ZBX_INFINITY == (*value = rollup.sum))
+				*state = ZBX_TREND_STATE_OVERFLOW;
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			goto out;
+	}
+
+	if (0 == rollup.num && ZBX_TREND_FUNCTION_COUNT != function && ZBX_TREND_FUNCTION_SUM != function)
+		*state = ZBX_TREND_STATE_NODATA;
+
+	ret = SUCCEED;
+out:
+	zbx_free(months_read);
+	zbx_free(days_read);
+	zbx_free(sql);
+	zbx_vector_uint64_pair_destroy(&ranges);
+	zbx_vector_uint64_destroy(&months);
+	zbx_vector_uint64_destroy(&days);
+
+	return ret;
+}
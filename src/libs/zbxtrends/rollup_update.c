@@ -0,0 +1,364 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "trends.h"
+
+#include "zbxcommon.h"
+#include "zbxdbhigh.h"
+#include "zbxdb.h"
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create rollups for items without rollup in the specified bucket   *
+ *          from hourly trends                                                *
+ *                                                                            *
+ * Parameters: table      - [IN] trends table name                            *
+ *             value_type - [IN] item value type                              *
+ *             period     - [IN] rollup period (ZBX_TRENDS_ROLLUP_*)          *
+ *             from       - [IN] bucket start                                 *
+ *             to         - [IN] next bucket start                            *
+ *             itemids    - [IN] items without rollup (sorted)                *
+ *                                                                            *
+ * Comments: Hourly trends are already flushed at this point, so the new      *
+ *           rollups include the flushed trend data.                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_create(const char *table, unsigned char value_type, int period, time_t from,
+		time_t to, const zbx_vector_uint64_t *itemids)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	char			*sql = NULL, rollup_table[32];
+	size_t			sql_alloc = 0, sql_offset = 0;
+	zbx_hashset_t		rollups;
+	zbx_hashset_iter_t	iter;
+	zbx_trends_rollup_t	*rollup, rollup_local = {.value_type = value_type};
+	zbx_db_insert_t		db_insert;
+
+	zbx_hashset_create(&rollups, (size_t)itemids->values_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select itemid,num,value_min,value_avg,value_max"
+			" from %s"
+			" where clock>=" ZBX_FS_I64
+				" and clock<" ZBX_FS_I64
+				" and",
+			table, (zbx_int64_t)from, (zbx_int64_t)to);
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
+
+	result = zbx_db_select("%s", sql);
+	zbx_free(sql);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(rollup_local.itemid, row[0]);
+
+		if (NULL == (rollup = (zbx_trends_rollup_t *)zbx_hashset_search(&rollups, &rollup_local)))
+		{
+			rollup = (zbx_trends_rollup_t *)zbx_hashset_insert(&rollups, &rollup_local,
+					sizeof(rollup_local));
+		}
+
+		zbx_trends_rollup_merge_row(rollup, row + 1);
+	}
+	zbx_db_free_result(result);
+
+	if (0 != rollups.num_data)
+	{
+		zbx_snprintf(rollup_table, sizeof(rollup_table), "%s_rollup", table);
+		zbx_db_insert_prepare(&db_insert, rollup_table, "itemid", "period", "clock", "num", "value_min",
+				"value_avg", "value_max", (char *)NULL);
+
+		zbx_hashset_iter_reset(&rollups, &iter);
+		while (NULL != (rollup = (zbx_trends_rollup_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (ITEM_VALUE_TYPE_FLOAT == value_type)
+			{
+				zbx_db_insert_add_values(&db_insert, rollup->itemid, period, (int)from, rollup->num,
+						rollup->value_min.dbl, rollup->value_avg.dbl, rollup->value_max.dbl);
+			}
+			else
+			{
+				zbx_db_insert_add_values(&db_insert, rollup->itemid, period, (int)from, rollup->num,
+						rollup->value_min.ui64, zbx_trends_rollup_avg_uint64(rollup),
+						rollup->value_max.ui64);
+			}
+		}
+
+		zbx_db_insert_execute(&db_insert);
+		zbx_db_insert_clean(&db_insert);
+	}
+
+	zbx_hashset_destroy(&rollups);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: merge flushed hourly trends into rollups of the specified period  *
+ *                                                                            *
+ * Parameters: table      - [IN] trends table name                            *
+ *             value_type - [IN] item value type                              *
+ *             period     - [IN] rollup period (ZBX_TRENDS_ROLLUP_*)          *
+ *             clock      - [IN] hourly trends clock                          *
+ *             deltas     - [IN/OUT] flushed trend data                       *
+ *             itemids    - [IN] flushed trend itemids (sorted)               *
+ *                                                                            *
+ ******************************************************************************/
+static void	trends_rollup_update(const char *table, unsigned char value_type, int period, int clock,
+		zbx_hashset_t *deltas, const zbx_vector_uint64_t *itemids)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	time_t			from, to;
+	zbx_vector_uint64_t	missing;
+	zbx_hashset_iter_t	iter;
+	zbx_trends_rollup_t	*delta, rollup;
+
+	if (SUCCEED != zbx_trends_rollup_get_bucket(clock, period, &from, &to))
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return;
+	}
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select itemid,num,value_min,value_avg,value_max"
+			" from %s_rollup"
+			" where period=%d"
+				" and clock=" ZBX_FS_I64
+				" and",
+			table, period, (zbx_int64_t)from);
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "itemid", itemids->values, itemids->values_num);
+
+	result = zbx_db_select("%s", sql);
+
+	sql_offset = 0;
+	zbx_db_begin_multiple_update(&sql, &sql_alloc, &sql_offset);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		memset(&rollup, 0, sizeof(rollup));
+		rollup.value_type = value_type;
+		ZBX_STR2UINT64(rollup.itemid, row[0]);
+
+		if (NULL == (delta = (zbx_trends_rollup_t *)zbx_hashset_search(deltas, &rollup)))
+		{
+			THIS_SHOULD_NEVER_HAPPEN;
+			continue;
+		}
+
+		zbx_trends_rollup_merge_row(&rollup, row + 1);
+		zbx_trends_rollup_merge(&rollup, delta);
+		delta->found = 1;
+
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "update %s_rollup set"
+					" num=" ZBX_FS_UI64 ",value_min=" ZBX_FS_DBL64_SQL ",value_avg="
+					ZBX_FS_DBL64_SQL ",value_max=" ZBX_FS_DBL64_SQL,
+					table, rollup.num, rollup.value_min.dbl, rollup.value_avg.dbl,
+					rollup.value_max.dbl);
+		}
+		else
+		{
+			zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "update %s_rollup set"
+					" num=" ZBX_FS_UI64 ",value_min=" ZBX_FS_UI64 ",value_avg=" ZBX_FS_UI64
+					",value_max=" ZBX_FS_UI64,
+					table, rollup.num, rollup.value_min.ui64, zbx_trends_rollup_avg_uint64(&rollup),
+					rollup.value_max.ui64);
+		}
+
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+				" where itemid=" ZBX_FS_UI64 " and period=%d and clock=" ZBX_FS_I64 ";\n",
+				rollup.itemid, period, (zbx_int64_t)from);
+
+		zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
+	}
+	zbx_db_free_result(result);
+
+	zbx_db_end_multiple_update(&sql, &sql_alloc, &sql_offset);
+
+	if (sql_offset > 16)	/* In ORACLE always present begin..end; */
+		zbx_db_execute("%s", sql);
+
+	zbx_free(sql);
+
+	zbx_vector_uint64_create(&missing);
+
+	zbx_hashset_iter_reset(deltas, &iter);
+	while (NULL != (delta = (zbx_trends_rollup_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (0 == delta->found)
+			zbx_vector_uint64_append(&missing, delta->itemid);
+		else
+			delta->found = 0;
+	}
+
+	if (0 != missing.values_num)
+	{
+		zbx_vector_uint64_sort(&missing, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		trends_rollup_create(table, value_type, period, from, to, &missing);
+	}
+
+	zbx_vector_uint64_destroy(&missing);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: update daily and monthly rollups with flushed hourly trends       *
+ *                                                                            *
+ * Parameters: trends     - [IN] trends with the same clock and value type    *
+ *                               as flushed to hourly trends table, before    *
+ *                               merging with existing database records       *
+ *             trends_num - [IN] number of trends                             *
+ *                                                                            *
+ * Comments: This function must be called after the hourly trends are written *
+ *           to database within the same transaction.                         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_trends_update_rollups(const ZBX_DC_TREND *trends, int trends_num)
+{
+	const char		*table;
+	unsigned char		value_type;
+	zbx_hashset_t		deltas;
+	zbx_vector_uint64_t	itemids;
+
+	if (0 == trends_num)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() trends_num:%d", __func__, trends_num);
+
+	value_type = trends[0].value_type;
+	table = (ITEM_VALUE_TYPE_FLOAT == value_type ? "trends" : "trends_uint");
+
+	zbx_hashset_create(&deltas, (size_t)trends_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_uint64_create(&itemids);
+	zbx_vector_uint64_reserve(&itemids, (size_t)trends_num);
+
+	for (int i = 0; i < trends_num; i++)
+	{
+		const ZBX_DC_TREND	*trend = &trends[i];
+		zbx_trends_rollup_t	delta = {.itemid = trend->itemid, .value_type = value_type};
+
+		if (0 == trend->num)
+			continue;
+
+		zbx_trends_rollup_merge_trend(&delta, trend);
+		zbx_hashset_insert(&deltas, &delta, sizeof(delta));
+		zbx_vector_uint64_append(&itemids, trend->itemid);
+	}
+
+	if (0 != itemids.values_num)
+	{
+		zbx_vector_uint64_sort(&itemids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_uniq(&itemids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+		trends_rollup_update(table, value_type, ZBX_TRENDS_ROLLUP_DAY, trends[0].clock, &deltas, &itemids);
+		trends_rollup_update(table, value_type, ZBX_TRENDS_ROLLUP_MONTH, trends[0].clock, &deltas,
+				&itemids);
+	}
+
+	zbx_vector_uint64_destroy(&itemids);
+	zbx_hashset_destroy(&deltas);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove rollups of the expired trends                              *
+ *                                                                            *
+ * Parameters: table     - [IN] trends table name                             *
+ *             itemid    - [IN] item identifier, 0 for all items              *
+ *             min_clock - [IN] the oldest kept trend clock, 0 to remove all  *
+ *                              item rollups                                  *
+ *                                                                            *
+ * Return value: number of removed rollups                                    *
+ *                                                                            *
+ * Comments: Rollups of all buckets starting before min_clock are removed,    *
+ *           including the buckets with trends only partially removed, so     *
+ *           that trend functions fall back to the remaining hourly trends.   *
+ *           If such bucket is still being filled, its rollup is recreated    *
+ *           from the remaining hourly trends on the next trends flush.       *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_trends_remove_rollups(const char *table, zbx_uint64_t itemid, int min_clock)
+{
+	char	*sql = NULL;
+	size_t	sql_alloc = 0, sql_offset = 0;
+	int	ret;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "delete from %s_rollup where", table);
+
+	if (0 != itemid)
+	{
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " itemid=" ZBX_FS_UI64, itemid);
+
+		if (0 == min_clock)
+			goto out;
+
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " and");
+	}
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, " clock<%d", min_clock);
+out:
+	ret = zbx_db_execute("%s", sql);
+	zbx_free(sql);
+
+	return ZBX_DB_OK < ret ? ret : 0;
+}
+
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove all rollups when they are disabled                         *
+ *                                                                            *
+ * Comments: Rollups are not updated while disabled, so they would miss the   *
+ *           trends flushed in the meantime when enabled again. Removing them *
+ *           on startup with rollups disabled makes trend functions fall back *
+ *           to hourly trends until the rollups are recreated.                *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_trends_clear_rollups(void)
+{
+	const char	*tables[] = {"trends_rollup", "trends_uint_rollup"};
+
+	for (size_t i = 0; i < ARRSIZE(tables); i++)
+	{
+		zbx_db_result_t	result;
+		char		sql[64];
+		int		found;
+
+		zbx_snprintf(sql, sizeof(sql), "select null from %s", tables[i]);
+		result = zbx_db_select_n(sql, 1);
+		found = (NULL != zbx_db_fetch(result));
+		zbx_db_free_result(result);
+
+		if (0 == found)
+			continue;
+
+		zabbix_log(LOG_LEVEL_WARNING, "removing %s records because trend rollups are disabled", tables[i]);
+
+		if (ZBX_DB_OK > zbx_db_execute("delete from %s", tables[i]))
+			zabbix_log(LOG_LEVEL_WARNING, "cannot remove %s records", tables[i]);
+	}
+}
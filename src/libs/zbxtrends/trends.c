@@ -595,7 +595,11 @@ int	zbx_trends_eval_avg(const char *table, zbx_uint64_t itemid, time_t start, ti
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_AVG, value, &state))
 	{
-		state = trends_eval_avg(table, itemid, start, end, value);
+		if (FAIL == zbx_trends_eval_rollup(table, itemid, start, end, ZBX_TREND_FUNCTION_AVG, value,
+				&state))
+		{
+			state = trends_eval_avg(table, itemid, start, end, value);
+		}
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_AVG, *value, state);
 	}
 
@@ -617,8 +621,13 @@ int	zbx_trends_eval_count(const char *table, zbx_uint64_t itemid, time_t start,
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_COUNT, value, &state))
 	{
-		if (ZBX_TREND_STATE_NORMAL != (state = trends_eval(table, itemid, start, end, "num", "sum(num)",
-				value)))
+		if (FAIL == zbx_trends_eval_rollup(table, itemid, start, end, ZBX_TREND_FUNCTION_COUNT, value,
+				&state))
+		{
+			state = trends_eval(table, itemid, start, end, "num", "sum(num)", value);
+		}
+
+		if (ZBX_TREND_STATE_NORMAL != state)
 		{
 			state = ZBX_TREND_STATE_NORMAL;
 			*value = 0;
@@ -637,7 +646,11 @@ int	zbx_trends_eval_max(const char *table, zbx_uint64_t itemid, time_t start, ti
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_MAX, value, &state))
 	{
-		state = trends_eval(table, itemid, start, end, "value_max", "max(value_max)", value);
+		if (FAIL == zbx_trends_eval_rollup(table, itemid, start, end, ZBX_TREND_FUNCTION_MAX, value,
+				&state))
+		{
+			state = trends_eval(table, itemid, start, end, "value_max", "max(value_max)", value);
+		}
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_MAX, *value, state);
 	}
 
@@ -657,7 +670,11 @@ int	zbx_trends_eval_min(const char *table, zbx_uint64_t itemid, time_t start, ti
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_MIN, value, &state))
 	{
-		state = trends_eval(table, itemid, start, end, "value_min", "min(value_min)", value);
+		if (FAIL == zbx_trends_eval_rollup(table, itemid, start, end, ZBX_TREND_FUNCTION_MIN, value,
+				&state))
+		{
+			state = trends_eval(table, itemid, start, end, "value_min", "min(value_min)", value);
+		}
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_MIN, *value, state);
 	}
 
@@ -677,7 +694,11 @@ int	zbx_trends_eval_sum(const char *table, zbx_uint64_t itemid, time_t start, ti
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_SUM, value, &state))
 	{
-		state = trends_eval_sum(table, itemid, start, end, value);
+		if (FAIL == zbx_trends_eval_rollup(table, itemid, start, end, ZBX_TREND_FUNCTION_SUM, value,
+				&state))
+		{
+			state = trends_eval_sum(table, itemid, start, end, value);
+		}
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_SUM, *value, state);
 	}
 
@@ -697,7 +718,11 @@ zbx_trend_state_t	zbx_trends_get_avg(const char *table, zbx_uint64_t itemid, tim
 
 	if (FAIL == zbx_tfc_get_value(itemid, start, end, ZBX_TREND_FUNCTION_AVG, value, &state))
 	{
-		state = trends_eval_avg(table, itemid, start, end, value);
+		if (FAIL == zbx_trends_eval_rollup(table, itemid, start, end, ZBX_TREND_FUNCTION_AVG, value,
+				&state))
+		{
+			state = trends_eval_avg(table, itemid, start, end, value);
+		}
 		zbx_tfc_put_value(itemid, start, end, ZBX_TREND_FUNCTION_AVG, *value, state);
 	}
 
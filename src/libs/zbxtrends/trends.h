@@ -19,6 +19,7 @@
 
 #include "zbxtrends.h"
 #include "zbxtypes.h"
+#include "zbxdb.h"
 
 #ifndef ZABBIX_TRENDS_H
 #define ZABBIX_TRENDS_H
@@ -45,11 +46,42 @@ typedef enum
 }
 zbx_trend_state_t;
 
+/* trend rollup periods */
+#define ZBX_TRENDS_ROLLUP_DAY	0
+#define ZBX_TRENDS_ROLLUP_MONTH	1
+
+/* Trend rollups are daily and monthly aggregates of hourly trends, stored in  */
+/* trends_rollup and trends_uint_rollup tables. Rollup buckets start at local  */
+/* midnight (the first day of month for monthly buckets) and contain all       */
+/* hourly trends with clock within the bucket.                                 */
+/* Like in hourly trends, the value_avg member holds the sum of the values     */
+/* for unsigned values, the average is calculated when writing to database.    */
+typedef struct
+{
+	zbx_uint64_t		itemid;
+	zbx_uint64_t		num;
+	zbx_history_value_t	value_min;
+	zbx_value_avg_t		value_avg;
+	zbx_history_value_t	value_max;
+	double			sum;
+	unsigned char		value_type;
+	int			found;
+}
+zbx_trends_rollup_t;
+
+int	zbx_trends_rollup_get_bucket(time_t clock, int period, time_t *start, time_t *next);
+void	zbx_trends_rollup_merge(zbx_trends_rollup_t *rollup, const zbx_trends_rollup_t *data);
+void	zbx_trends_rollup_merge_trend(zbx_trends_rollup_t *rollup, const ZBX_DC_TREND *trend);
+void	zbx_trends_rollup_merge_row(zbx_trends_rollup_t *rollup, zbx_db_row_t row);
+zbx_uint64_t	zbx_trends_rollup_avg_uint64(const zbx_trends_rollup_t *rollup);
+
 int	zbx_tfc_get_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function, double *value,
 		zbx_trend_state_t *state);
 void	zbx_tfc_put_value(zbx_uint64_t itemid, time_t start, time_t end, zbx_trend_function_t function, double value,
 		zbx_trend_state_t state);
 const char	*zbx_trends_error(zbx_trend_state_t state);
+int	zbx_trends_eval_rollup(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
+		zbx_trend_function_t function, double *value, zbx_trend_state_t *state);
 zbx_trend_state_t	zbx_trends_get_avg(const char *table, zbx_uint64_t itemid, time_t start, time_t end,
 		double *value);
 
@@ -25,6 +25,7 @@
 #include "zbxlog.h"
 #include "zbxstr.h"
 #include "zbxtime.h"
+#include "zbxthreads.h"
 #include "zbx_rtc_constants.h"
 
 #if defined(ZABBIX_SERVICE)
@@ -37,65 +38,171 @@
 static volatile sig_atomic_t	need_update_userparam;
 #endif
 
-static void	process_listener(zbx_socket_t *s, int config_timeout)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate requested item and send back its value                   *
+ *                                                                            *
+ * Parameters: s              - [IN] the connection with received request     *
+ *             config_timeout - [IN] the default check and network timeout    *
+ *                                                                            *
+ * Return value: SUCCEED - the reply was sent                                 *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	process_request(zbx_socket_t *s, int config_timeout)
 {
 	AGENT_RESULT	result;
 	char		**value = NULL;
-	int		ret;
+	zbx_uint32_t	timeout;
+	int		ret = SUCCEED;
 
-	if (SUCCEED == (ret = zbx_tcp_recv_to(s, config_timeout)))
+	if (0 != s->reserved_payload)
+		timeout = s->reserved_payload;
+	else
+		timeout = (zbx_uint32_t)config_timeout;
+
+	zbx_init_agent_result(&result);
+
+	if (SUCCEED == zbx_execute_agent_check(s->buffer, ZBX_PROCESS_WITH_ALIAS, &result, (int)timeout))
+	{
+		if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", *value);
+			ret = zbx_tcp_send_to(s, *value, config_timeout);
+		}
+	}
+	else
 	{
-		zbx_uint32_t	timeout;
+		value = ZBX_GET_MSG_RESULT(&result);
 
-		zbx_rtrim(s->buffer, "\r\n");
+		if (NULL != value)
+		{
+			static char	*buffer = NULL;
+			static size_t	buffer_alloc = 256;
+			size_t		buffer_offset = 0;
 
-		zabbix_log(LOG_LEVEL_DEBUG, "Requested [%s]", s->buffer);
+			zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED ": %s]", *value);
 
-		if (0 != s->reserved_payload)
-			timeout = s->reserved_payload;
-		else
-			timeout = (zbx_uint32_t)config_timeout;
+			if (NULL == buffer)
+				buffer = (char *)zbx_malloc(buffer, buffer_alloc);
 
-		zbx_init_agent_result(&result);
+			zbx_strncpy_alloc(&buffer, &buffer_alloc, &buffer_offset,
+					ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED));
+			buffer_offset++;
+			zbx_strcpy_alloc(&buffer, &buffer_alloc, &buffer_offset, *value);
 
-		if (SUCCEED == zbx_execute_agent_check(s->buffer, ZBX_PROCESS_WITH_ALIAS, &result, (int)timeout))
-		{
-			if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
-			{
-				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", *value);
-				ret = zbx_tcp_send_to(s, *value, config_timeout);
-			}
+			ret = zbx_tcp_send_bytes_to(s, buffer, buffer_offset, config_timeout);
 		}
 		else
 		{
-			value = ZBX_GET_MSG_RESULT(&result);
-
-			if (NULL != value)
-			{
-				static char	*buffer = NULL;
-				static size_t	buffer_alloc = 256;
-				size_t		buffer_offset = 0;
+			zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED "]");
+			ret = zbx_tcp_send_to(s, ZBX_NOTSUPPORTED, config_timeout);
+		}
+	}
 
-				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED ": %s]", *value);
+	zbx_free_agent_result(&result);
 
-				if (NULL == buffer)
-					buffer = (char *)zbx_malloc(buffer, buffer_alloc);
+	return ret;
+}
 
-				zbx_strncpy_alloc(&buffer, &buffer_alloc, &buffer_offset,
-						ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED));
-				buffer_offset++;
-				zbx_strcpy_alloc(&buffer, &buffer_alloc, &buffer_offset, *value);
+#ifndef _WINDOWS
+/* the maximum number of request workers running at the same time per listener */
+#define LISTENER_WORKERS_MAX	32
+
+static pid_t	workers[LISTENER_WORKERS_MAX];
+static int	workers_num;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reap finished request workers                                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	reap_workers(void)
+{
+	int	i, status;
+	pid_t	pid;
 
-				ret = zbx_tcp_send_bytes_to(s, buffer, buffer_offset, config_timeout);
-			}
-			else
-			{
-				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED "]");
-				ret = zbx_tcp_send_to(s, ZBX_NOTSUPPORTED, config_timeout);
-			}
+	for (i = 0; i < workers_num;)
+	{
+		if (0 == (pid = waitpid(workers[i], &status, WNOHANG)) || (-1 == pid && EINTR == errno))
+		{
+			i++;
+			continue;
 		}
 
-		zbx_free_agent_result(&result);
+		workers[i] = workers[--workers_num];
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: hand over request to a worker process if it can take long time    *
+ *                                                                            *
+ * Parameters: s              - [IN/OUT] the connection with received request *
+ *             config_timeout - [IN] the default check and network timeout    *
+ *                                                                            *
+ * Return value: SUCCEED - the request is processed by a worker and the       *
+ *                         connection is closed in the listener               *
+ *               FAIL    - the request must be processed by the listener      *
+ *                                                                            *
+ * Comments: Encrypted connections are not handed over because TLS session    *
+ *           state cannot be shared between processes.                        *
+ *                                                                            *
+ ******************************************************************************/
+static int	offload_request(zbx_socket_t *s, int process_num, int config_timeout)
+{
+	pid_t	pid;
+
+	if (ZBX_TCP_SEC_UNENCRYPTED != s->connection_type || LISTENER_WORKERS_MAX == workers_num ||
+			SUCCEED != zbx_agent_check_can_block(s->buffer, ZBX_PROCESS_WITH_ALIAS))
+	{
+		return FAIL;
+	}
+
+	if (-1 == (pid = zbx_fork()))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot fork request worker: %s", zbx_strerror(errno));
+		return FAIL;
+	}
+
+	if (0 == pid)
+	{
+		int	ret;
+
+		zbx_setproctitle("listener #%d worker [processing request]", process_num);
+
+		if (FAIL == (ret = process_request(s, config_timeout)))
+			zabbix_log(LOG_LEVEL_DEBUG, "Process listener error: %s", zbx_socket_strerror());
+
+		zbx_tcp_unaccept(s);
+
+		exit(SUCCEED == ret ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	workers[workers_num++] = pid;
+	zbx_tcp_unaccept_local(s);
+
+	return SUCCEED;
+}
+#endif
+
+static void	process_listener(zbx_socket_t *s, int process_num, int config_timeout)
+{
+	int	ret;
+
+	if (SUCCEED == (ret = zbx_tcp_recv_to(s, config_timeout)))
+	{
+		zbx_rtrim(s->buffer, "\r\n");
+
+		zabbix_log(LOG_LEVEL_DEBUG, "Requested [%s]", s->buffer);
+
+#ifndef _WINDOWS
+		if (SUCCEED == offload_request(s, process_num, config_timeout))
+			return;
+#else
+		ZBX_UNUSED(process_num);
+#endif
+		ret = process_request(s, config_timeout);
 	}
 
 	if (FAIL == ret)
@@ -152,6 +259,9 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 		}
 #endif
 
+#ifndef _WINDOWS
+		reap_workers();
+#endif
 		zbx_setproctitle("listener #%d [waiting for connection]", process_num);
 		ret = zbx_tcp_accept(&s, init_child_args_in->zbx_config_tls->accept_modes, POLL_TIMEOUT);
 		zbx_update_env(get_process_type_string(process_type), zbx_time());
@@ -175,7 +285,7 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 						&msg)))
 #endif
 				{
-					process_listener(&s, init_child_args_in->config_timeout);
+					process_listener(&s, process_num, init_child_args_in->config_timeout);
 				}
 			}
 
@@ -28,6 +28,7 @@
 #include "zbxlog.h"
 #include "zbxgetopt.h"
 #include "zbxmutexs.h"
+#include "zbxshmem.h"
 
 #include "zbxsysinfo.h"
 #include "zbxmodules.h"
@@ -102,12 +103,16 @@ const char	*help_message[] = {
 	"                                   target is not specified",
 	"      " ZBX_SNMP_CACHE_RELOAD "          Reload SNMP cache",
 	"      " ZBX_DIAGINFO "=section           Log internal diagnostic information of the",
-	"                                 section (historycache, preprocessing, locks) or",
-	"                                 everything if section is not specified",
+	"                                 section (historycache, preprocessing, locks,",
+	"                                 configcache, latency) or everything if section",
+	"                                 is not specified",
 	"      " ZBX_PROF_ENABLE "=target         Enable profiling, affects all processes if",
 	"                                   target is not specified",
 	"      " ZBX_PROF_DISABLE "=target        Disable profiling, affects all processes if",
 	"                                   target is not specified",
+	"      " ZBX_LOCK_PROF_ENABLE "           Enable lock contention profiling, statistics are",
+	"                                   reported in locks diagnostic information",
+	"      " ZBX_LOCK_PROF_DISABLE "          Disable lock contention profiling",
 	"",
 	"      Log level control targets:",
 	"        process-type             All processes of specified type",
@@ -270,6 +275,7 @@ static zbx_uint64_t	config_vmware_cache_size	= 8 * ZBX_MEBIBYTE;
 static int	config_unreachable_period		= 45;
 static int	config_unreachable_delay		= 15;
 static int	config_max_concurrent_checks_per_poller	= 1000;
+static int	config_huge_pages			= 0;
 
 static int	config_log_level		= LOG_LEVEL_WARNING;
 
@@ -286,6 +292,7 @@ static char	*config_hostname	= NULL;
 static char	*config_hostname_item	= NULL;
 
 char	*zbx_config_snmptrap_file	= NULL;
+static int	config_snmptrapper_threads	= 1;
 
 char	*CONFIG_JAVA_GATEWAY		= NULL;
 int	CONFIG_JAVA_GATEWAY_PORT	= ZBX_DEFAULT_GATEWAY_PORT;
@@ -339,7 +346,8 @@ static const zbx_events_funcs_t	events_cbs = {
 	.clean_events_cb		= NULL,
 	.reset_event_recovery_cb	= NULL,
 	.export_events_cb		= NULL,
-	.events_update_itservices_cb	= NULL
+	.events_update_itservices_cb	= NULL,
+	.events_update_problem_cache_cb	= NULL
 };
 
 int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num);
@@ -859,12 +867,16 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	0,			0},
 		{"StartSNMPTrapper",		&CONFIG_FORKS[ZBX_PROCESS_TYPE_SNMPTRAPPER],		TYPE_INT,
 			PARM_OPT,	0,			1},
+		{"SNMPTrapperThreads",		&config_snmptrapper_threads,		TYPE_INT,
+			PARM_OPT,	1,			64},
 		{"CacheSize",			&config_conf_cache_size,		TYPE_UINT64,
-			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(64) * ZBX_GIBIBYTE},
+			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(32) * ZBX_GIBIBYTE},
 		{"HistoryCacheSize",		&config_history_cache_size,		TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"HistoryIndexCacheSize",	&config_history_index_cache_size,	TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(2) * ZBX_GIBIBYTE},
+		{"HugePages",			&config_huge_pages,			TYPE_INT,
+			PARM_OPT,	0,			1},
 		{"HousekeepingFrequency",	&config_housekeeping_frequency,		TYPE_INT,
 			PARM_OPT,	0,			24},
 		{"ProxyLocalBuffer",		&config_proxy_local_buffer,		TYPE_INT,
@@ -1402,7 +1414,8 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 	zbx_thread_dbsyncer_args		dbsyncer_args = {&events_cbs, config_histsyncer_frequency};
 	zbx_thread_vmware_args			vmware_args = {zbx_config_source_ip, config_vmware_frequency,
 								config_vmware_perf_frequency, config_vmware_timeout};
-	zbx_thread_snmptrapper_args		snmptrapper_args = {zbx_config_snmptrap_file};
+	zbx_thread_snmptrapper_args		snmptrapper_args = {zbx_config_snmptrap_file,
+								config_snmptrapper_threads};
 
 	zbx_rtc_process_request_ex_func_t	rtc_process_request_func = NULL;
 
@@ -1519,6 +1532,8 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		exit(EXIT_FAILURE);
 	}
 
+	zbx_shmem_set_huge_pages(config_huge_pages);
+
 	if (SUCCEED != zbx_init_database_cache(get_program_type, zbx_sync_proxy_history, config_history_cache_size,
 			config_history_index_cache_size, &config_trends_cache_size, &error))
 	{
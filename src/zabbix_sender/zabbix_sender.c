@@ -29,6 +29,7 @@
 #include "zbxnum.h"
 #include "zbxtime.h"
 #include "zbxfile.h"
+#include "zbxip.h"
 
 #if !defined(_WINDOWS)
 #	include "zbxnix.h"
@@ -149,6 +150,9 @@ static int	CONFIG_SENDER_TIMEOUT = GET_SENDER_TIMEOUT;
 #define CONFIG_SENDER_TIMEOUT_MIN_STR	ZBX_STR(CONFIG_SENDER_TIMEOUT_MIN)
 #define CONFIG_SENDER_TIMEOUT_MAX_STR	ZBX_STR(CONFIG_SENDER_TIMEOUT_MAX)
 
+#define STREAM_WINDOW_MIN	1
+#define STREAM_WINDOW_MAX	1000
+
 const char	*help_message[] = {
 	"Utility for sending monitoring data to Zabbix server or proxy.",
 	"",
@@ -202,6 +206,12 @@ const char	*help_message[] = {
 	"                             received. This can be used when reading from",
 	"                             standard input",
 	"",
+	"  --stream window            Stream values from input file keeping up to",
+	"                             <window> batches in flight per destination and",
+	"                             report throughput and latency statistics at the",
+	"                             end. This can be used with --input-file option",
+	"                             and cannot be used with --real-time option",
+	"",
 	"  -v --verbose               Verbose mode, -vv for more details",
 	"",
 	"  -h --help                  Display this help message",
@@ -297,6 +307,7 @@ static struct zbx_option	longopts[] =
 	{"with-timestamps",		0,	NULL,	'T'},
 	{"with-ns",			0,	NULL,	'N'},
 	{"real-time",			0,	NULL,	'r'},
+	{"stream",			1,	NULL,	'S'},
 	{"verbose",			0,	NULL,	'v'},
 	{"help",			0,	NULL,	'h'},
 	{"version",			0,	NULL,	'V'},
@@ -325,6 +336,7 @@ static char	*INPUT_FILE = NULL;
 static int	WITH_TIMESTAMPS = 0;
 static int	WITH_NS = 0;
 static int	REAL_TIME = 0;
+static int	STREAM_WINDOW = 0;
 
 char		*config_source_ip = NULL;
 static char	*ZABBIX_SERVER = NULL;
@@ -382,9 +394,13 @@ static void	main_signal_handler(int sig)
 
 		for (i = 0; i < destinations_count; i++)
 		{
-			pid_t	child = *(destinations[i].thread);
+			pid_t	child;
 
-			if (ZBX_THREAD_HANDLE_NULL != child)
+			/* values are sent by the main process in streaming mode */
+			if (NULL == destinations[i].thread)
+				continue;
+
+			if (ZBX_THREAD_HANDLE_NULL != (child = *(destinations[i].thread)))
 				kill(child, sig);
 		}
 	}
@@ -519,96 +535,172 @@ static int	sender_threads_wait(ZBX_THREAD_HANDLE *threads, zbx_thread_args_t *th
  *          delimited by blanks                                               *
  *                                                                            *
  * Parameters:                                                                *
- *      p       - [IN] parameter list, delimited by blanks (' ' or '\t')      *
- *      buf     - [OUT] output buffer                                         *
- *      bufsize - [IN] output buffer size                                     *
+ *      p - [IN/OUT] parameter list, delimited by blanks (' ' or '\t'),       *
+ *                   points to the next string on return                      *
+ *                                                                            *
+ * Return value: the current string or NULL in case of invalid syntax         *
  *                                                                            *
- * Return value: pointer to the next string                                   *
+ * Comments: The string is terminated and quoted string is unescaped in place *
+ *           to avoid copying.                                                *
  *                                                                            *
  ******************************************************************************/
-static const char	*get_string(const char *p, char *buf, size_t bufsize)
+static char	*get_string(char **p)
 {
-/* 0 - init, 1 - inside quoted param, 2 - inside unquoted param */
-	int	state;
-	size_t	buf_i = 0;
+	char	*token, *in, *out;
 
-	bufsize--;	/* '\0' */
+	in = *p + strspn(*p, " \t");
 
-	for (state = 0; '\0' != *p; p++)
+	if ('"' != *in)
 	{
-		switch (state)
+		token = in;
+		in += strcspn(in, " \t");
+
+		if ('\0' != *in)
 		{
-			/* init state */
-			case 0:
-				if (' ' == *p || '\t' == *p)
-				{
-					/* skipping the leading spaces */
-				}
-				else if ('"' == *p)
-				{
-					state = 1;
-				}
-				else
-				{
-					state = 2;
-					p--;
-				}
-				break;
-			/* quoted */
-			case 1:
-				if ('"' == *p)
-				{
-					if (' ' != p[1] && '\t' != p[1] && '\0' != p[1])
-						return NULL;	/* incorrect syntax */
+			*in++ = '\0';
+			in += strspn(in, " \t");
+		}
 
-					while (' ' == p[1] || '\t' == p[1])
-						p++;
+		*p = in;
 
-					buf[buf_i] = '\0';
-					return ++p;
-				}
-				else if ('\\' == *p && ('"' == p[1] || '\\' == p[1]))
-				{
-					p++;
-					if (buf_i < bufsize)
-						buf[buf_i++] = *p;
-				}
-				else if ('\\' == *p && 'n' == p[1])
-				{
-					p++;
-					if (buf_i < bufsize)
-						buf[buf_i++] = '\n';
-				}
-				else if (buf_i < bufsize)
-				{
-					buf[buf_i++] = *p;
-				}
-				break;
-			/* unquoted */
-			case 2:
-				if (' ' == *p || '\t' == *p)
-				{
-					while (' ' == *p || '\t' == *p)
-						p++;
+		return token;
+	}
 
-					buf[buf_i] = '\0';
-					return p;
-				}
-				else if (buf_i < bufsize)
-				{
-					buf[buf_i++] = *p;
-				}
-				break;
+	for (token = out = ++in; '"' != *in; in++)
+	{
+		/* missing terminating '"' character */
+		if ('\0' == *in)
+			return NULL;
+
+		if ('\\' == *in && ('"' == in[1] || '\\' == in[1]))
+		{
+			in++;
+		}
+		else if ('\\' == *in && 'n' == in[1])
+		{
+			in++;
+			*out++ = '\n';
+			continue;
 		}
+
+		*out++ = *in;
 	}
 
-	/* missing terminating '"' character */
-	if (1 == state)
-		return NULL;
+	if (' ' != in[1] && '\t' != in[1] && '\0' != in[1])
+		return NULL;	/* incorrect syntax */
 
-	buf[buf_i] = '\0';
+	*out = '\0';
+	in++;
+	*p = in + strspn(in, " \t");
 
-	return p;
+	return token;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse input line and add its value to the request                 *
+ *                                                                            *
+ * Parameters: line     - [IN] the input line, modified during parsing        *
+ *             line_num - [IN] the input line number                          *
+ *             json     - [IN/OUT] the request                                *
+ *                                                                            *
+ * Return value: SUCCEED - the value was added                                *
+ *               FAIL    - the line is invalid                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	sender_parse_line(char *line, int line_num, struct zbx_json *json)
+{
+	char	*p = line, *hostname, *key, *clock, *key_value;
+	int	timestamp, ns;
+
+	/* line format: <hostname> <key> [<timestamp>] [<ns>] <value> */
+
+	if ('\0' == *p || NULL == (hostname = get_string(&p)) || '\0' == *hostname)
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Hostname' required", line_num);
+		return FAIL;
+	}
+
+	if (0 == strcmp(hostname, "-"))
+	{
+		if (NULL == ZABBIX_HOSTNAME)
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "[line %d] '-' encountered as 'Hostname',"
+					" but no default hostname was specified", line_num);
+			return FAIL;
+		}
+		else
+			hostname = ZABBIX_HOSTNAME;
+	}
+
+	if ('\0' == *p || NULL == (key = get_string(&p)) || '\0' == *key)
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Key' required", line_num);
+		return FAIL;
+	}
+
+	if (1 == WITH_TIMESTAMPS)
+	{
+		if ('\0' == *p || NULL == (clock = get_string(&p)) || '\0' == *clock)
+		{
+			zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Timestamp' required", line_num);
+			return FAIL;
+		}
+
+		if (FAIL == zbx_is_uint31(clock, &timestamp))
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "[line %d] invalid 'Timestamp' value detected", line_num);
+			return FAIL;
+		}
+
+		if (1 == WITH_NS)
+		{
+			if ('\0' == *p || NULL == (clock = get_string(&p)) || '\0' == *clock)
+			{
+				zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Nanoseconds' required", line_num);
+				return FAIL;
+			}
+
+			if (FAIL == zbx_is_uint_n_range(clock, strlen(clock), &ns, sizeof(ns), 0LL, 999999999LL))
+			{
+				zabbix_log(LOG_LEVEL_WARNING, "[line %d] invalid 'Nanoseconds' value detected",
+						line_num);
+				return FAIL;
+			}
+		}
+	}
+
+	if ('\0' != *p && '"' != *p)
+	{
+		key_value = p;
+	}
+	else if ('\0' == *p || NULL == (key_value = get_string(&p)))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Key value' required", line_num);
+		return FAIL;
+	}
+	else if ('\0' != *p)
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "[line %d] too many parameters", line_num);
+		return FAIL;
+	}
+
+	zbx_json_addobject(json, NULL);
+	zbx_json_addstring(json, ZBX_PROTO_TAG_HOST, hostname, ZBX_JSON_TYPE_STRING);
+	zbx_json_addstring(json, ZBX_PROTO_TAG_KEY, key, ZBX_JSON_TYPE_STRING);
+	zbx_json_addstring(json, ZBX_PROTO_TAG_VALUE, key_value, ZBX_JSON_TYPE_STRING);
+
+	if (1 == WITH_TIMESTAMPS)
+	{
+		zbx_json_adduint64(json, ZBX_PROTO_TAG_CLOCK, timestamp);
+
+		if (1 == WITH_NS)
+			zbx_json_adduint64(json, ZBX_PROTO_TAG_NS, ns);
+	}
+
+	zbx_json_close(json);
+
+	return SUCCEED;
 }
 
 /******************************************************************************
@@ -868,6 +960,7 @@ static int	sender_add_serveractive_host_cb(const zbx_vector_addr_ptr_t *addrs, z
 	zbx_vector_addr_ptr_create(&destinations[destinations_count - 1].addrs);
 
 	zbx_addr_copy(&destinations[destinations_count - 1].addrs, addrs);
+	destinations[destinations_count - 1].thread = NULL;
 
 	return SUCCEED;
 }
@@ -1065,6 +1158,15 @@ static void	parse_commandline(int argc, char **argv)
 			case 'r':
 				REAL_TIME = 1;
 				break;
+			case 'S':
+				if (FAIL == zbx_is_uint_n_range(zbx_optarg, ZBX_MAX_UINT64_LEN, &STREAM_WINDOW,
+						sizeof(STREAM_WINDOW), STREAM_WINDOW_MIN, STREAM_WINDOW_MAX))
+				{
+					zbx_error("Invalid stream window, valid range %d:%d", STREAM_WINDOW_MIN,
+							STREAM_WINDOW_MAX);
+					exit(EXIT_FAILURE);
+				}
+				break;
 			case 't':
 				if (FAIL == zbx_is_uint_n_range(zbx_optarg, ZBX_MAX_UINT64_LEN, &CONFIG_SENDER_TIMEOUT,
 						sizeof(CONFIG_SENDER_TIMEOUT), CONFIG_SENDER_TIMEOUT_MIN,
@@ -1435,6 +1537,13 @@ static void	parse_commandline(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
+	if (0 < opt_count['S'] && (0 == opt_count['i'] || 0 < opt_count['r']))
+	{
+		zbx_error("option \"--stream\" can be used only with \"--input-file\" and without \"--real-time\"");
+		zbx_usage();
+		exit(EXIT_FAILURE);
+	}
+
 	/* Parameters which are not option values are invalid. The check relies on zbx_getopt_internal() which */
 	/* always permutes command line arguments regardless of POSIXLY_CORRECT environment variable. */
 	if (argc > zbx_optind)
@@ -1491,10 +1600,676 @@ static char	*zbx_fgets_alloc(char **buffer, size_t *buffer_alloc, FILE *fp)
 /* take long and hit timeout, so we limit values to 250 per connection */
 #define VALUES_MAX	250
 
+/* the size of input file reads in streaming mode */
+#define STREAM_READ_SIZE	(1024 * 1024)
+
+typedef struct
+{
+	FILE	*in;
+	char	*buf;
+	size_t	buf_alloc;
+	size_t	offset;		/* the start of unprocessed data */
+	size_t	len;		/* the end of read data */
+	int	eof;
+}
+zbx_sender_reader_t;
+
+/* the batch of values sent to all destinations */
+typedef struct
+{
+	char	*data;
+	size_t	data_len;
+	int	values_num;
+	int	refcount;
+}
+zbx_sender_batch_t;
+
+typedef enum
+{
+	SENDER_STEP_IDLE = 0,
+	SENDER_STEP_CONNECT_WAIT,
+	SENDER_STEP_TLS_WAIT,
+	SENDER_STEP_SEND,
+	SENDER_STEP_RECV
+}
+zbx_sender_step_t;
+
+struct zbx_sender_stream;
+
+/* the connection sending one batch of values */
+typedef struct
+{
+	struct zbx_sender_stream	*stream;
+	zbx_sender_batch_t		*batch;
+	zbx_addr_t			*addr;
+	zbx_socket_t			s;
+	zbx_tcp_send_context_t		tcp_send_context;
+	zbx_tcp_recv_context_t		tcp_recv_context;
+	zbx_sender_step_t		step;
+	short				events;		/* the socket events to wait for */
+	int				tries;		/* the number of tried destination addresses */
+	double				time_start;
+}
+zbx_sender_slot_t;
+
+/* the window of batches being sent to a single destination */
+typedef struct zbx_sender_stream
+{
+	zbx_vector_addr_ptr_t	*addrs;
+	zbx_sender_slot_t	*slots;
+	int			busy;
+	int			failed;
+	int			partial;
+	int			values_sent;
+}
+zbx_sender_stream_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read a line from input using large buffered reads                 *
+ *                                                                            *
+ * Parameters: reader - [IN/OUT] the input reader                             *
+ *                                                                            *
+ * Return value: the line without terminating newline or NULL at the end of   *
+ *               input. The line is valid until the next call.                *
+ *                                                                            *
+ ******************************************************************************/
+static char	*sender_reader_getline(zbx_sender_reader_t *reader)
+{
+	char	*line, *end;
+	size_t	n;
+
+	while (1)
+	{
+		line = reader->buf + reader->offset;
+
+		if (NULL != (end = (char *)memchr(line, '\n', reader->len - reader->offset)))
+		{
+			*end = '\0';
+			reader->offset = (size_t)(end - reader->buf) + 1;
+
+			return line;
+		}
+
+		if (0 != reader->eof)
+		{
+			if (reader->offset == reader->len)
+				return NULL;
+
+			/* the last line without newline, the buffer always has room for terminating zero */
+			reader->buf[reader->len] = '\0';
+			reader->offset = reader->len;
+
+			return line;
+		}
+
+		/* move the incomplete line to the buffer start and read more data after it */
+		if (0 != reader->offset)
+		{
+			memmove(reader->buf, line, reader->len - reader->offset);
+			reader->len -= reader->offset;
+			reader->offset = 0;
+		}
+
+		if (reader->buf_alloc - reader->len < STREAM_READ_SIZE + 1)
+		{
+			reader->buf_alloc = reader->len + STREAM_READ_SIZE + 1;
+			reader->buf = (char *)zbx_realloc(reader->buf, reader->buf_alloc);
+		}
+
+		if (STREAM_READ_SIZE != (n = fread(reader->buf + reader->len, 1, STREAM_READ_SIZE, reader->in)))
+		{
+			if (0 != ferror(reader->in))
+				zabbix_log(LOG_LEVEL_WARNING, "cannot read input: %s", zbx_strerror(errno));
+
+			reader->eof = 1;
+		}
+
+		reader->len += n;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read the next batch of values from input                          *
+ *                                                                            *
+ * Parameters: reader        - [IN/OUT] the input reader                      *
+ *             json          - [IN/OUT] the request buffer                    *
+ *             total_count   - [IN/OUT] the number of read lines              *
+ *             succeed_count - [IN/OUT] the number of parsed values           *
+ *             ret           - [OUT] FAIL if invalid input line was found     *
+ *                                                                            *
+ * Return value: the batch or NULL at the end of input or on input error      *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_sender_batch_t	*sender_stream_read_batch(zbx_sender_reader_t *reader, struct zbx_json *json,
+		int *total_count, int *succeed_count, int *ret)
+{
+	zbx_sender_batch_t	*batch;
+	char			*line;
+	int			values_num = 0;
+
+	zbx_json_clean(json);
+	zbx_json_addstring(json, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_VALUE_SENDER_DATA, ZBX_JSON_TYPE_STRING);
+	zbx_json_addarray(json, ZBX_PROTO_TAG_DATA);
+
+	while (VALUES_MAX > values_num && NULL != (line = sender_reader_getline(reader)))
+	{
+		(*total_count)++;
+
+		zbx_rtrim(line, "\r");
+
+		if (SUCCEED != sender_parse_line(line, *total_count, json))
+		{
+			*ret = FAIL;
+			return NULL;
+		}
+
+		(*succeed_count)++;
+		values_num++;
+	}
+
+	if (0 == values_num)
+		return NULL;
+
+	zbx_json_close(json);
+
+	if (1 == WITH_TIMESTAMPS)
+	{
+		zbx_timespec_t	ts;
+
+		zbx_timespec(&ts);
+
+		zbx_json_adduint64(json, ZBX_PROTO_TAG_CLOCK, ts.sec);
+		zbx_json_adduint64(json, ZBX_PROTO_TAG_NS, ts.ns);
+	}
+
+	batch = (zbx_sender_batch_t *)zbx_malloc(NULL, sizeof(zbx_sender_batch_t));
+	batch->data_len = json->buffer_size;
+	batch->data = (char *)zbx_malloc(NULL, batch->data_len + 1);
+	memcpy(batch->data, json->buffer, batch->data_len + 1);
+	batch->values_num = values_num;
+	batch->refcount = 0;
+
+	return batch;
+}
+
+static void	sender_batch_release(zbx_sender_batch_t *batch)
+{
+	if (0 != --batch->refcount)
+		return;
+
+	zbx_free(batch->data);
+	zbx_free(batch);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finish sending batch over the connection                          *
+ *                                                                            *
+ * Parameters: slot      - [IN/OUT] the connection                            *
+ *             status    - [IN] SUCCEED, SUCCEED_PARTIAL or FAIL              *
+ *             latencies - [IN/OUT] the batch latencies in milliseconds       *
+ *                                                                            *
+ ******************************************************************************/
+static void	sender_slot_finish(zbx_sender_slot_t *slot, int status, zbx_vector_dbl_t *latencies)
+{
+	zbx_sender_stream_t	*stream = slot->stream;
+
+	if (FAIL == status)
+	{
+		stream->failed = 1;
+	}
+	else
+	{
+		if (SUCCEED_PARTIAL == status)
+			stream->partial = 1;
+
+		stream->values_sent += slot->batch->values_num;
+		zbx_vector_dbl_append(latencies, (zbx_time() - slot->time_start) * 1000);
+	}
+
+	zbx_tcp_send_context_clear(&slot->tcp_send_context);
+	zbx_tcp_close(&slot->s);
+	sender_batch_release(slot->batch);
+
+	slot->batch = NULL;
+	slot->step = SENDER_STEP_IDLE;
+	stream->busy--;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initiate connection to the current destination address, failing   *
+ *          over to the next addresses                                        *
+ *                                                                            *
+ * Parameters: slot - [IN/OUT] the connection                                 *
+ *                                                                            *
+ * Return value: SUCCEED - connection was initiated                           *
+ *               FAIL    - all destination addresses were tried               *
+ *                                                                            *
+ ******************************************************************************/
+static int	sender_slot_connect(zbx_sender_slot_t *slot)
+{
+	zbx_vector_addr_ptr_t	*addrs = slot->stream->addrs;
+
+	for (; slot->tries < addrs->values_num; slot->tries++)
+	{
+		slot->addr = addrs->values[0];
+
+		if (SUCCEED == zbx_socket_connect(&slot->s, SOCK_STREAM, config_source_ip, slot->addr->ip,
+				slot->addr->port, CONFIG_SENDER_TIMEOUT))
+		{
+			slot->step = SENDER_STEP_CONNECT_WAIT;
+			slot->events = POLLOUT;
+
+			return SUCCEED;
+		}
+
+		zbx_socket_clean(&slot->s);
+
+		zabbix_log(LOG_LEVEL_DEBUG, "Unable to connect to [%s]:%d [%s]", slot->addr->ip, slot->addr->port,
+				zbx_socket_strerror());
+
+		zbx_vector_addr_ptr_remove(addrs, 0);
+		zbx_vector_addr_ptr_append(addrs, slot->addr);
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start sending batch over the connection                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	sender_slot_start(zbx_sender_slot_t *slot, zbx_sender_batch_t *batch, zbx_vector_dbl_t *latencies)
+{
+	slot->batch = batch;
+	slot->tries = 0;
+	slot->time_start = zbx_time();
+	batch->refcount++;
+	slot->stream->busy++;
+
+	zbx_socket_clean(&slot->s);
+
+	if (SUCCEED != zbx_tcp_send_context_init(batch->data, batch->data_len, 0, ZBX_TCP_PROTOCOL,
+			&slot->tcp_send_context))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot send data: %s", zbx_socket_strerror());
+		sender_slot_finish(slot, FAIL, latencies);
+		return;
+	}
+
+	if (SUCCEED != sender_slot_connect(slot))
+		sender_slot_finish(slot, FAIL, latencies);
+}
+
+static int	sender_slot_wait(zbx_sender_slot_t *slot, short events)
+{
+	if (0 != (events & POLLIN))
+		slot->events = POLLIN;
+	else if (0 != (events & POLLOUT))
+		slot->events = POLLOUT;
+	else
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: advance batch sending on socket events                            *
+ *                                                                            *
+ * Parameters: slot      - [IN/OUT] the connection                            *
+ *             revents   - [IN] the socket events, 0 on timeout               *
+ *             latencies - [IN/OUT] the batch latencies in milliseconds       *
+ *                                                                            *
+ ******************************************************************************/
+static void	sender_slot_process(zbx_sender_slot_t *slot, short revents, zbx_vector_dbl_t *latencies)
+{
+	short		event_new;
+	int		errnum = 0, ret;
+	socklen_t	optlen = sizeof(int);
+
+	if (0 == revents)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "Timeout while sending data to [%s]:%d", slot->addr->ip, slot->addr->port);
+		sender_slot_finish(slot, FAIL, latencies);
+		return;
+	}
+
+	switch (slot->step)
+	{
+		case SENDER_STEP_CONNECT_WAIT:
+			if (0 == getsockopt(slot->s.socket, SOL_SOCKET, SO_ERROR, (char *)&errnum, &optlen) &&
+					0 != errnum)
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "Unable to connect to [%s]:%d [%s]", slot->addr->ip,
+						slot->addr->port, zbx_strerror(errnum));
+
+				zbx_tcp_close(&slot->s);
+
+				if (slot->addr == slot->stream->addrs->values[0])
+				{
+					zbx_vector_addr_ptr_remove(slot->stream->addrs, 0);
+					zbx_vector_addr_ptr_append(slot->stream->addrs, slot->addr);
+				}
+
+				slot->tries++;
+
+				if (SUCCEED != sender_slot_connect(slot))
+				{
+					zbx_socket_clean(&slot->s);
+					sender_slot_finish(slot, FAIL, latencies);
+				}
+
+				return;
+			}
+
+			slot->step = SENDER_STEP_TLS_WAIT;
+			ZBX_FALLTHROUGH;
+		case SENDER_STEP_TLS_WAIT:
+#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
+			if (ZBX_TCP_SEC_UNENCRYPTED != zbx_config_tls->connect_mode)
+			{
+				const char	*tls_arg1, *tls_arg2, *server_name = NULL;
+				char		*error = NULL;
+
+				if (ZBX_TCP_SEC_TLS_CERT == zbx_config_tls->connect_mode)
+				{
+					tls_arg1 = zbx_config_tls->server_cert_issuer;
+					tls_arg2 = zbx_config_tls->server_cert_subject;
+				}
+				else
+				{
+					tls_arg1 = zbx_config_tls->psk_identity;
+					tls_arg2 = NULL;	/* zbx_tls_connect() will find PSK */
+				}
+
+				if (SUCCEED != zbx_is_ip(slot->addr->ip))
+					server_name = slot->addr->ip;
+
+				if (SUCCEED != zbx_socket_tls_connect(&slot->s, zbx_config_tls->connect_mode, tls_arg1,
+						tls_arg2, server_name, &event_new, &error))
+				{
+					if (SUCCEED == sender_slot_wait(slot, event_new))
+						return;
+
+					zabbix_log(LOG_LEVEL_DEBUG, "Unable to connect to [%s]:%d [TCP successful,"
+							" cannot establish TLS: %s]", slot->addr->ip, slot->addr->port,
+							error);
+					zbx_free(error);
+					sender_slot_finish(slot, FAIL, latencies);
+					return;
+				}
+			}
+#endif
+			slot->step = SENDER_STEP_SEND;
+			ZBX_FALLTHROUGH;
+		case SENDER_STEP_SEND:
+			if (SUCCEED != zbx_tcp_send_context(&slot->s, &slot->tcp_send_context, &event_new))
+			{
+				if (SUCCEED == sender_slot_wait(slot, event_new))
+					return;
+
+				zabbix_log(LOG_LEVEL_DEBUG, "Unable to send to [%s]:%d [%s]", slot->addr->ip,
+						slot->addr->port, zbx_socket_strerror());
+				sender_slot_finish(slot, FAIL, latencies);
+				return;
+			}
+
+			slot->step = SENDER_STEP_RECV;
+			slot->events = POLLIN;
+			zbx_tcp_recv_context_init(&slot->s, &slot->tcp_recv_context, 0);
+
+			return;
+		case SENDER_STEP_RECV:
+			if (FAIL == zbx_tcp_recv_context(&slot->s, &slot->tcp_recv_context, 0, &event_new))
+			{
+				if (SUCCEED == sender_slot_wait(slot, event_new))
+					return;
+
+				zabbix_log(LOG_LEVEL_DEBUG, "Unable to receive from [%s]:%d [%s]", slot->addr->ip,
+						slot->addr->port, zbx_socket_strerror());
+				sender_slot_finish(slot, FAIL, latencies);
+				return;
+			}
+
+			zabbix_log(LOG_LEVEL_DEBUG, "answer [%s]", slot->s.buffer);
+
+			if (FAIL == (ret = check_response(slot->s.buffer, slot->addr->ip, slot->addr->port)))
+			{
+				zabbix_log(LOG_LEVEL_WARNING, "incorrect answer from \"%s:%hu\": [%s]", slot->addr->ip,
+						slot->addr->port, slot->s.buffer);
+			}
+
+			sender_slot_finish(slot, ret, latencies);
+			return;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if new batch can be sent to all working destinations        *
+ *                                                                            *
+ ******************************************************************************/
+static int	sender_streams_ready(const zbx_sender_stream_t *streams)
+{
+	int	i, working = 0;
+
+	for (i = 0; i < destinations_count; i++)
+	{
+		if (0 != streams[i].failed)
+			continue;
+
+		if (STREAM_WINDOW == streams[i].busy)
+			return FAIL;
+
+		working++;
+	}
+
+	return 0 != working ? SUCCEED : FAIL;
+}
+
+static double	sender_latency_percentile(const zbx_vector_dbl_t *latencies, double percentile)
+{
+	return latencies->values[(int)(percentile * (latencies->values_num - 1) / 100 + 0.5)];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: stream values from input file to all destinations, keeping a      *
+ *          bounded window of batches in flight per destination               *
+ *                                                                            *
+ * Parameters: total_count   - [OUT] the number of read lines                 *
+ *             succeed_count - [OUT] the number of parsed values              *
+ *                                                                            *
+ * Return value:  SUCCEED - success with all values at all destinations       *
+ *                FAIL - an error occurred                                    *
+ *                SUCCEED_PARTIAL - data sending was completed successfully   *
+ *                to at least one destination or processing of at least one   *
+ *                value at least at one destination failed                    *
+ *                                                                            *
+ * Comments: Trapper closes connection after each request, so every batch is  *
+ *           sent over a new connection.                                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	sender_stream(int *total_count, int *succeed_count)
+{
+	zbx_sender_reader_t	reader = {0};
+	zbx_sender_stream_t	*streams;
+	zbx_sender_slot_t	**pslots;
+	zbx_sender_batch_t	*batch;
+	zbx_pollfd_t		*pfds;
+	zbx_vector_dbl_t	latencies;
+	struct zbx_json		json;
+	int			i, j, pfds_num, ret = SUCCEED, failed = 0, partial = 0, values_sent = 0;
+	double			time_start, elapsed;
+
+	if (0 == strcmp(INPUT_FILE, "-"))
+	{
+		reader.in = stdin;
+	}
+	else if (NULL == (reader.in = fopen(INPUT_FILE, "r")))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot open [%s]: %s", INPUT_FILE, zbx_strerror(errno));
+		return FAIL;
+	}
+#if !defined(_WINDOWS)
+	/* write errors are handled for each connection */
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	streams = (zbx_sender_stream_t *)zbx_calloc(NULL, (size_t)destinations_count, sizeof(zbx_sender_stream_t));
+
+	for (i = 0; i < destinations_count; i++)
+	{
+		streams[i].addrs = &destinations[i].addrs;
+		streams[i].slots = (zbx_sender_slot_t *)zbx_calloc(NULL, (size_t)STREAM_WINDOW,
+				sizeof(zbx_sender_slot_t));
+
+		for (j = 0; j < STREAM_WINDOW; j++)
+			streams[i].slots[j].stream = &streams[i];
+	}
+
+	pfds = (zbx_pollfd_t *)zbx_malloc(NULL, sizeof(zbx_pollfd_t) * (size_t)(destinations_count * STREAM_WINDOW));
+	pslots = (zbx_sender_slot_t **)zbx_malloc(NULL,
+			sizeof(zbx_sender_slot_t *) * (size_t)(destinations_count * STREAM_WINDOW));
+
+	zbx_vector_dbl_create(&latencies);
+	zbx_json_init(&json, ZBX_JSON_STAT_BUF_LEN);
+
+	time_start = zbx_time();
+
+	while (0 == sig_exiting)
+	{
+		double	now;
+
+		while (SUCCEED == ret && SUCCEED == sender_streams_ready(streams))
+		{
+			if (NULL == (batch = sender_stream_read_batch(&reader, &json, total_count, succeed_count, &ret)))
+				break;
+
+			batch->refcount++;
+
+			for (i = 0; i < destinations_count; i++)
+			{
+				if (0 != streams[i].failed)
+					continue;
+
+				for (j = 0; SENDER_STEP_IDLE != streams[i].slots[j].step; j++)
+					;
+
+				sender_slot_start(&streams[i].slots[j], batch, &latencies);
+			}
+
+			sender_batch_release(batch);
+		}
+
+		for (pfds_num = 0, i = 0; i < destinations_count; i++)
+		{
+			for (j = 0; j < STREAM_WINDOW; j++)
+			{
+				zbx_sender_slot_t	*slot = &streams[i].slots[j];
+
+				if (SENDER_STEP_IDLE == slot->step)
+					continue;
+
+				pfds[pfds_num].fd = slot->s.socket;
+				pfds[pfds_num].events = slot->events;
+				pfds[pfds_num].revents = 0;
+				pslots[pfds_num++] = slot;
+			}
+		}
+
+		if (0 == pfds_num)
+			break;
+
+		if (-1 == zbx_socket_poll(pfds, (unsigned long)pfds_num, 1000))
+		{
+			if (EINTR == zbx_socket_last_error())
+				continue;
+
+			zabbix_log(LOG_LEVEL_WARNING, "cannot wait for socket events: %s",
+					zbx_strerror_from_system(zbx_socket_last_error()));
+			break;
+		}
+
+		now = zbx_time();
+
+		for (i = 0; i < pfds_num; i++)
+		{
+			if (0 != pfds[i].revents)
+				sender_slot_process(pslots[i], pfds[i].revents, &latencies);
+			else if (now - pslots[i]->time_start > CONFIG_SENDER_TIMEOUT)
+				sender_slot_process(pslots[i], 0, &latencies);
+		}
+	}
+
+	elapsed = zbx_time() - time_start;
+
+	for (i = 0; i < destinations_count; i++)
+	{
+		for (j = 0; j < STREAM_WINDOW; j++)
+		{
+			zbx_sender_slot_t	*slot = &streams[i].slots[j];
+
+			/* interrupted by signal */
+			if (SENDER_STEP_IDLE != slot->step)
+			{
+				zbx_tcp_send_context_clear(&slot->tcp_send_context);
+				zbx_tcp_close(&slot->s);
+				sender_batch_release(slot->batch);
+				streams[i].failed = 1;
+			}
+		}
+
+		if (0 != streams[i].failed)
+			failed++;
+		else if (0 != streams[i].partial)
+			partial++;
+
+		values_sent += streams[i].values_sent;
+		zbx_free(streams[i].slots);
+	}
+
+	printf("stream: sent %d values in %.3f seconds, %.1f values/sec", values_sent, elapsed,
+			0 < elapsed ? values_sent / elapsed : 0);
+
+	if (0 != latencies.values_num)
+	{
+		zbx_vector_dbl_sort(&latencies, ZBX_DEFAULT_DBL_COMPARE_FUNC);
+
+		printf("; batch latency ms: p50 %.1f, p90 %.1f, p99 %.1f, max %.1f",
+				sender_latency_percentile(&latencies, 50), sender_latency_percentile(&latencies, 90),
+				sender_latency_percentile(&latencies, 99),
+				latencies.values[latencies.values_num - 1]);
+	}
+
+	printf("\n");
+
+	zbx_json_free(&json);
+	zbx_vector_dbl_destroy(&latencies);
+	zbx_free(pslots);
+	zbx_free(pfds);
+	zbx_free(streams);
+	zbx_free(reader.buf);
+
+	if (reader.in != stdin)
+		fclose(reader.in);
+
+	if (FAIL == ret || destinations_count == failed)
+		return FAIL;
+
+	return 0 != failed || 0 != partial ? SUCCEED_PARTIAL : SUCCEED;
+}
+
 int	main(int argc, char **argv)
 {
 	char			*error = NULL;
-	int			total_count = 0, succeed_count = 0, ret = FAIL, timestamp, ns;
+	int			total_count = 0, succeed_count = 0, ret = FAIL;
 	zbx_thread_sendval_args	*sendval_args = NULL;
 	zbx_config_log_t	log_file_cfg = {NULL, NULL, ZBX_LOG_TYPE_UNDEFINED, 0};
 
@@ -1601,12 +2376,16 @@ int	main(int argc, char **argv)
 	zbx_json_addstring(&sendval_args->json, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_VALUE_SENDER_DATA, ZBX_JSON_TYPE_STRING);
 	zbx_json_addarray(&sendval_args->json, ZBX_PROTO_TAG_DATA);
 
-	if (INPUT_FILE)
+	if (0 != STREAM_WINDOW)
+	{
+		ret = sender_stream(&total_count, &succeed_count);
+	}
+	else if (INPUT_FILE)
 	{
 		FILE	*in;
-		char	*in_line = NULL, *key = NULL, *key_value = NULL;
+		char	*in_line = NULL;
 		int	buffer_count = 0;
-		size_t	key_alloc = 0, in_line_alloc = MAX_BUFFER_LEN;
+		size_t	in_line_alloc = MAX_BUFFER_LEN;
 		double	last_send = 0;
 
 		if (0 == strcmp(INPUT_FILE, "-"))
@@ -1632,130 +2411,18 @@ int	main(int argc, char **argv)
 		while (0 == sig_exiting && (SUCCEED == ret || SUCCEED_PARTIAL == ret) &&
 				NULL != zbx_fgets_alloc(&in_line, &in_line_alloc, in))
 		{
-			char		hostname[MAX_STRING_LEN], clock[32];
-			int		read_more = 0;
-			size_t		key_value_alloc = 0;
-			const char	*p;
-
-			/* line format: <hostname> <key> [<timestamp>] [<ns>] <value> */
+			int	read_more = 0;
 
 			total_count++; /* also used as inputline */
 
 			zbx_rtrim(in_line, "\r\n");
 
-			p = in_line;
-
-			if ('\0' == *p || NULL == (p = get_string(p, hostname, sizeof(hostname))) || '\0' == *hostname)
+			if (SUCCEED != sender_parse_line(in_line, total_count, &sendval_args->json))
 			{
-				zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Hostname' required", total_count);
 				ret = FAIL;
 				break;
 			}
 
-			if (0 == strcmp(hostname, "-"))
-			{
-				if (NULL == ZABBIX_HOSTNAME)
-				{
-					zabbix_log(LOG_LEVEL_CRIT, "[line %d] '-' encountered as 'Hostname',"
-							" but no default hostname was specified", total_count);
-					ret = FAIL;
-					break;
-				}
-				else
-					zbx_strlcpy(hostname, ZABBIX_HOSTNAME, sizeof(hostname));
-			}
-
-			if (key_alloc != in_line_alloc)
-			{
-				key_alloc = in_line_alloc;
-				key = (char *)zbx_realloc(key, key_alloc);
-			}
-
-			if ('\0' == *p || NULL == (p = get_string(p, key, key_alloc)) || '\0' == *key)
-			{
-				zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Key' required", total_count);
-				ret = FAIL;
-				break;
-			}
-
-			if (1 == WITH_TIMESTAMPS)
-			{
-				if ('\0' == *p || NULL == (p = get_string(p, clock, sizeof(clock))) || '\0' == *clock)
-				{
-					zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Timestamp' required", total_count);
-					ret = FAIL;
-					break;
-				}
-
-				if (FAIL == zbx_is_uint31(clock, &timestamp))
-				{
-					zabbix_log(LOG_LEVEL_WARNING, "[line %d] invalid 'Timestamp' value detected",
-							total_count);
-					ret = FAIL;
-					break;
-				}
-
-				if (1 == WITH_NS)
-				{
-					if ('\0' == *p || NULL == (p = get_string(p, clock, sizeof(clock))) ||
-							'\0' == *clock)
-					{
-						zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Nanoseconds' required",
-								total_count);
-						ret = FAIL;
-						break;
-					}
-
-					if (FAIL == zbx_is_uint_n_range(clock, sizeof(clock), &ns, sizeof(ns),
-							0LL, 999999999LL))
-					{
-						zabbix_log(LOG_LEVEL_WARNING,
-								"[line %d] invalid 'Nanoseconds' value detected",
-								total_count);
-						ret = FAIL;
-						break;
-					}
-				}
-			}
-
-			if (key_value_alloc != in_line_alloc)
-			{
-				key_value_alloc = in_line_alloc;
-				key_value = (char *)zbx_realloc(key_value, key_value_alloc);
-			}
-
-			if ('\0' != *p && '"' != *p)
-			{
-				zbx_strlcpy(key_value, p, key_value_alloc);
-			}
-			else if ('\0' == *p || NULL == (p = get_string(p, key_value, key_value_alloc)))
-			{
-				zabbix_log(LOG_LEVEL_CRIT, "[line %d] 'Key value' required", total_count);
-				ret = FAIL;
-				break;
-			}
-			else if ('\0' != *p)
-			{
-				zabbix_log(LOG_LEVEL_CRIT, "[line %d] too many parameters", total_count);
-				ret = FAIL;
-				break;
-			}
-
-			zbx_json_addobject(&sendval_args->json, NULL);
-			zbx_json_addstring(&sendval_args->json, ZBX_PROTO_TAG_HOST, hostname, ZBX_JSON_TYPE_STRING);
-			zbx_json_addstring(&sendval_args->json, ZBX_PROTO_TAG_KEY, key, ZBX_JSON_TYPE_STRING);
-			zbx_json_addstring(&sendval_args->json, ZBX_PROTO_TAG_VALUE, key_value, ZBX_JSON_TYPE_STRING);
-
-			if (1 == WITH_TIMESTAMPS)
-			{
-				zbx_json_adduint64(&sendval_args->json, ZBX_PROTO_TAG_CLOCK, timestamp);
-
-				if (1 == WITH_NS)
-					zbx_json_adduint64(&sendval_args->json, ZBX_PROTO_TAG_NS, ns);
-			}
-
-			zbx_json_close(&sendval_args->json);
-
 			succeed_count++;
 			buffer_count++;
 
@@ -1811,8 +2478,6 @@ int	main(int argc, char **argv)
 		if (in != stdin)
 			fclose(in);
 
-		zbx_free(key);
-		zbx_free(key_value);
 		zbx_free(in_line);
 	}
 	else
@@ -123,6 +123,64 @@ static void	get_object_ids(const zbx_vector_db_event_t *esc_events, zbx_vector_u
 	zbx_vector_uint64_uniq(objectids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add events of objects resolved from configuration cache to       *
+ *          condition matches                                                 *
+ *                                                                            *
+ * Parameters: esc_events - [IN] events to check                              *
+ *             condition  - [IN/OUT] condition for matching, outputs          *
+ *                                   event ids that match condition           *
+ *             object     - [IN] object, for example EVENT_OBJECT_TRIGGER     *
+ *             matched    - [IN] objects matching condition value             *
+ *             unmatched  - [IN] objects not matching condition value         *
+ *                                                                            *
+ ******************************************************************************/
+static void	add_cached_condition_matches(const zbx_vector_db_event_t *esc_events, zbx_condition_t *condition,
+		int object, const zbx_vector_uint64_t *matched, const zbx_vector_uint64_t *unmatched)
+{
+	const zbx_vector_uint64_t	*objectids;
+
+	objectids = (ZBX_CONDITION_OPERATOR_EQUAL == condition->op ? matched : unmatched);
+
+	for (int i = 0; i < objectids->values_num; i++)
+		add_condition_match(esc_events, condition, objectids->values[i], object);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check host group condition using configuration cache              *
+ *                                                                            *
+ * Parameters: object     - [IN] object, for example EVENT_OBJECT_TRIGGER     *
+ *             esc_events - [IN] events to check                              *
+ *             condition  - [IN/OUT] condition for matching, outputs          *
+ *                                   event ids that match condition           *
+ *             groupids   - [IN] condition host group and its nested groups   *
+ *             objectids  - [IN/OUT] objects to check, on output contains     *
+ *                                   objects that were not found in cache     *
+ *                                   and must be checked in database          *
+ *                                                                            *
+ ******************************************************************************/
+static void	check_cached_host_group_condition(int object, const zbx_vector_db_event_t *esc_events,
+		zbx_condition_t *condition, const zbx_vector_uint64_t *groupids, zbx_vector_uint64_t *objectids)
+{
+	zbx_vector_uint64_t	matched, unmatched, unresolved;
+
+	zbx_vector_uint64_create(&matched);
+	zbx_vector_uint64_create(&unmatched);
+	zbx_vector_uint64_create(&unresolved);
+
+	zbx_dc_match_hostgroup_objects(object, groupids, objectids, &matched, &unmatched, &unresolved);
+	add_cached_condition_matches(esc_events, condition, object, &matched, &unmatched);
+
+	zbx_vector_uint64_clear(objectids);
+	zbx_vector_uint64_append_array(objectids, unresolved.values, unresolved.values_num);
+
+	zbx_vector_uint64_destroy(&unresolved);
+	zbx_vector_uint64_destroy(&unmatched);
+	zbx_vector_uint64_destroy(&matched);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: check host group condition                                        *
@@ -155,6 +213,11 @@ static int	check_host_group_condition(const zbx_vector_db_event_t *esc_events, z
 	get_object_ids(esc_events, &objectids);
 	zbx_dc_get_nested_hostgroupids(&condition_value, 1, &groupids);
 
+	check_cached_host_group_condition(EVENT_OBJECT_TRIGGER, esc_events, condition, &groupids, &objectids);
+
+	if (0 == objectids.values_num)
+		goto out;
+
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
 		"select distinct f.triggerid"
 		" from hosts_groups hg,hosts h,items i,functions f"
@@ -199,7 +262,7 @@ static int	check_host_group_condition(const zbx_vector_db_event_t *esc_events, z
 		for (i = 0; i < objectids.values_num; i++)
 			add_condition_match(esc_events, condition, objectids.values[i], EVENT_OBJECT_TRIGGER);
 	}
-
+out:
 	zbx_vector_uint64_destroy(&groupids);
 	zbx_vector_uint64_destroy(&objectids);
 	zbx_free(sql);
@@ -389,6 +452,53 @@ static void	check_object_hierarchy(int object, const zbx_vector_db_event_t *esc_
 	zbx_vector_uint64_destroy(&objectids_tmp);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resolve template hierarchy of objects from configuration cache    *
+ *          in order to compare to condition                                  *
+ *                                                                            *
+ * Parameters: object          - [IN] type of the object that generated event *
+ *             esc_events      - [IN] events being checked                    *
+ *             objectids       - [IN/OUT] object ids of the esc_events, on    *
+ *                                    output contains ids of objects that     *
+ *                                    were not resolved from cache            *
+ *             objectids_pair  - [IN/OUT] pairs of (objectid, source          *
+ *                                    objectid), on output contains pairs of  *
+ *                                    objects that were not resolved from     *
+ *                                    cache                                   *
+ *             condition       - [IN/OUT] condition to evaluate, matched      *
+ *                                    events will be added to condition       *
+ *                                    eventids vector                         *
+ *             condition_value - [IN] condition value for matching            *
+ *                                                                            *
+ ******************************************************************************/
+static void	check_cached_object_hierarchy(int object, const zbx_vector_db_event_t *esc_events,
+		zbx_vector_uint64_t *objectids, zbx_vector_uint64_pair_t *objectids_pair, zbx_condition_t *condition,
+		zbx_uint64_t condition_value)
+{
+	zbx_vector_uint64_t		matched, unmatched;
+	zbx_vector_uint64_pair_t	unresolved;
+
+	zbx_vector_uint64_create(&matched);
+	zbx_vector_uint64_create(&unmatched);
+	zbx_vector_uint64_pair_create(&unresolved);
+
+	zbx_dc_match_template_objects(object, condition_value, objectids_pair, &matched, &unmatched, &unresolved);
+	add_cached_condition_matches(esc_events, condition, object, &matched, &unmatched);
+
+	zbx_vector_uint64_clear(objectids);
+	zbx_vector_uint64_pair_clear(objectids_pair);
+
+	for (int i = 0; i < unresolved.values_num; i++)
+		zbx_vector_uint64_append(objectids, unresolved.values[i].first);
+
+	zbx_vector_uint64_pair_append_array(objectids_pair, unresolved.values, unresolved.values_num);
+
+	zbx_vector_uint64_pair_destroy(&unresolved);
+	zbx_vector_uint64_destroy(&unmatched);
+	zbx_vector_uint64_destroy(&matched);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: check host template condition                                     *
@@ -422,6 +532,13 @@ static int	check_host_template_condition(const zbx_vector_db_event_t *esc_events
 
 	ZBX_STR2UINT64(condition_value, condition->value);
 
+	check_cached_object_hierarchy(EVENT_OBJECT_TRIGGER, esc_events, &objectids, &objectids_pair, condition,
+			condition_value);
+
+	/* discovered triggers are resolved through their prototypes, which are selected from database */
+	if (0 == objectids.values_num)
+		goto out;
+
 	trigger_parents_sql_alloc(&sql, &sql_alloc, &objectids);
 
 	result = zbx_db_select("%s", sql);
@@ -438,6 +555,9 @@ static int	check_host_template_condition(const zbx_vector_db_event_t *esc_events
 	}
 	zbx_db_free_result(result);
 
+	check_cached_object_hierarchy(EVENT_OBJECT_TRIGGER, esc_events, &objectids, &objectids_pair, condition,
+			condition_value);
+
 	check_object_hierarchy(EVENT_OBJECT_TRIGGER, esc_events, &objectids, &objectids_pair, condition, condition_value,
 			"select distinct t.triggerid,t.templateid,i.hostid"
 				" from items i,functions f,triggers t"
@@ -445,7 +565,7 @@ static int	check_host_template_condition(const zbx_vector_db_event_t *esc_events
 					" and f.triggerid=t.templateid"
 					" and",
 			"t.triggerid");
-
+out:
 	zbx_vector_uint64_destroy(&objectids);
 	zbx_vector_uint64_pair_destroy(&objectids_pair);
 	zbx_free(sql);
@@ -2155,6 +2275,11 @@ static int	check_intern_host_group_condition(const zbx_vector_db_event_t *esc_ev
 	{
 		size_t	sql_offset = 0;
 
+		if (0 == objectids[i].values_num)
+			continue;
+
+		check_cached_host_group_condition(objects[i], esc_events, condition, &groupids, &objectids[i]);
+
 		if (0 == objectids[i].values_num)
 			continue;
 
@@ -2304,6 +2429,12 @@ static int	check_intern_host_template_condition(const zbx_vector_db_event_t *esc
 
 		objectids_to_pair(objectids_ptr, objectids_pair_ptr);
 
+		check_cached_object_hierarchy(objects[i], esc_events, objectids_ptr, objectids_pair_ptr, condition,
+				condition_value);
+
+		if (0 == objectids_ptr->values_num)
+			continue;
+
 		if (EVENT_OBJECT_TRIGGER == objects[i])
 			trigger_parents_sql_alloc(&sql, &sql_alloc, objectids_ptr);
 		else	/* EVENT_OBJECT_ITEM, EVENT_OBJECT_LLDRULE */
@@ -2325,6 +2456,9 @@ static int	check_intern_host_template_condition(const zbx_vector_db_event_t *esc
 		}
 		zbx_db_free_result(result);
 
+		check_cached_object_hierarchy(objects[i], esc_events, objectids_ptr, objectids_pair_ptr, condition,
+				condition_value);
+
 		check_object_hierarchy(objects[i], esc_events, objectids_ptr, objectids_pair_ptr, condition, condition_value,
 				0 == i ?
 					"select distinct t.triggerid,t.templateid,i.hostid"
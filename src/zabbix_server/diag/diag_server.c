@@ -28,9 +28,11 @@
 
 #define ZBX_DIAG_LLD_RULES		0x00000001
 #define ZBX_DIAG_LLD_VALUES		0x00000002
+#define ZBX_DIAG_LLD_PHASES		0x00000004
 
 #define ZBX_DIAG_LLD_SIMPLE		(ZBX_DIAG_LLD_RULES | \
-					ZBX_DIAG_LLD_VALUES)
+					ZBX_DIAG_LLD_VALUES | \
+					ZBX_DIAG_LLD_PHASES)
 
 #define ZBX_DIAG_ALERTING_ALERTS	0x00000001
 
@@ -262,6 +264,7 @@ static int	diag_add_lld_info(const struct zbx_json_parse *jp, struct zbx_json *j
 					{"", ZBX_DIAG_LLD_SIMPLE},
 					{"rules", ZBX_DIAG_LLD_RULES},
 					{"values", ZBX_DIAG_LLD_VALUES},
+					{"phases", ZBX_DIAG_LLD_PHASES},
 					{NULL, 0}
 					};
 
@@ -273,10 +276,11 @@ static int	diag_add_lld_info(const struct zbx_json_parse *jp, struct zbx_json *j
 
 		if (0 != (fields & ZBX_DIAG_LLD_SIMPLE))
 		{
-			zbx_uint64_t	values_num, items_num;
+			zbx_uint64_t		values_num, items_num;
+			zbx_lld_phase_times_t	times;
 
 			time1 = zbx_time();
-			if (FAIL == (ret = zbx_lld_get_diag_stats(&items_num, &values_num, error)))
+			if (FAIL == (ret = zbx_lld_get_diag_stats(&items_num, &values_num, &times, error)))
 				goto out;
 			time2 = zbx_time();
 			time_total += time2 - time1;
@@ -285,6 +289,17 @@ static int	diag_add_lld_info(const struct zbx_json_parse *jp, struct zbx_json *j
 				zbx_json_addint64(json, "rules", items_num);
 			if (0 != (fields & ZBX_DIAG_LLD_VALUES))
 				zbx_json_addint64(json, "values", values_num);
+
+			if (0 != (fields & ZBX_DIAG_LLD_PHASES))
+			{
+				zbx_json_addobject(json, "phases");
+				zbx_json_addfloat(json, "filter", times.filter);
+				zbx_json_addfloat(json, "items", times.items);
+				zbx_json_addfloat(json, "triggers", times.triggers);
+				zbx_json_addfloat(json, "graphs", times.graphs);
+				zbx_json_addfloat(json, "hosts", times.hosts);
+				zbx_json_close(json);
+			}
 		}
 
 		if (0 != tops.values_num)
@@ -547,6 +562,10 @@ int	diag_add_section_info(const char *section, const struct zbx_json_parse *jp,
 	}
 	else if (0 == strcmp(section, ZBX_DIAG_CONNECTOR))
 		ret = zbx_diag_add_connector_info(jp, json, error);
+	else if (0 == strcmp(section, ZBX_DIAG_CONFIGCACHE))
+		ret = zbx_diag_add_configcache_info(jp, json, error);
+	else if (0 == strcmp(section, ZBX_DIAG_LATENCY))
+		ret = zbx_diag_add_latency_info(jp, json, error);
 	else
 		*error = zbx_dsprintf(*error, "Unsupported diagnostics section: %s", section);
 
@@ -50,6 +50,9 @@
 
 #define CONFIG_ESCALATOR_FREQUENCY	3
 
+/* full reload of in-memory escalation queue, used only as a safety net */
+#define ZBX_ESCALATION_QUEUE_RELOAD_FREQUENCY	SEC_PER_HOUR
+
 #define ZBX_ESCALATION_SOURCE_DEFAULT	0
 #define ZBX_ESCALATION_SOURCE_ITEM	1
 #define ZBX_ESCALATION_SOURCE_TRIGGER	2
@@ -101,6 +104,23 @@ typedef struct
 }
 zbx_service_role_t;
 
+/* scheduled escalation check */
+typedef struct
+{
+	zbx_uint64_t	escalationid;
+	int		nextcheck;
+}
+zbx_escalation_schedule_t;
+
+/* in-memory queue of escalations handled by escalator, ordered by their next check time */
+typedef struct
+{
+	zbx_binary_heap_t	heap;
+	zbx_hashset_t		escalations;
+	int			load_time;
+}
+zbx_escalation_queue_t;
+
 ZBX_VECTOR_DECL(service_alarm, zbx_service_alarm_t)
 ZBX_VECTOR_IMPL(service_alarm, zbx_service_alarm_t)
 
@@ -2972,10 +2992,177 @@ static void	service_role_clean(zbx_service_role_t *role)
 	zbx_vector_uint64_destroy(&role->serviceids);
 }
 
-static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalation_ptr_t *escalations,
-		zbx_vector_uint64_t *eventids, zbx_vector_uint64_t *problem_eventids, zbx_vector_uint64_t *actionids,
-		const char *default_timezone, int config_timeout, int config_trapper_timeout,
-		const char *config_source_ip, int *config_forks)
+static int	escalation_schedule_compare(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+	const zbx_escalation_schedule_t	*s1 = (const zbx_escalation_schedule_t *)e1->data;
+	const zbx_escalation_schedule_t	*s2 = (const zbx_escalation_schedule_t *)e2->data;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s1->nextcheck, s2->nextcheck);
+	ZBX_RETURN_IF_NOT_EQUAL(s1->escalationid, s2->escalationid);
+
+	return 0;
+}
+
+static void	escalation_queue_init(zbx_escalation_queue_t *queue)
+{
+	zbx_binary_heap_create(&queue->heap, escalation_schedule_compare, ZBX_BINARY_HEAP_OPTION_DIRECT);
+	zbx_hashset_create(&queue->escalations, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	queue->load_time = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: schedules escalation check                                        *
+ *                                                                            *
+ * Parameters: queue        - [IN/OUT] escalation queue                       *
+ *             escalationid - [IN]                                            *
+ *             nextcheck    - [IN] time of the next escalation check          *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_queue_update(zbx_escalation_queue_t *queue, zbx_uint64_t escalationid, int nextcheck)
+{
+	zbx_escalation_schedule_t	*schedule, schedule_local = {.escalationid = escalationid};
+	zbx_binary_heap_elem_t		elem = {.key = escalationid};
+
+	if (NULL != (schedule = (zbx_escalation_schedule_t *)zbx_hashset_search(&queue->escalations,
+			&schedule_local)))
+	{
+		if (schedule->nextcheck == nextcheck)
+			return;
+
+		schedule->nextcheck = nextcheck;
+		elem.data = (void *)schedule;
+		zbx_binary_heap_update_direct(&queue->heap, &elem);
+
+		return;
+	}
+
+	schedule_local.nextcheck = nextcheck;
+	schedule = (zbx_escalation_schedule_t *)zbx_hashset_insert(&queue->escalations, &schedule_local,
+			sizeof(schedule_local));
+
+	elem.data = (void *)schedule;
+	zbx_binary_heap_insert(&queue->heap, &elem);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: loads schedule of all escalations handled by escalator            *
+ *                                                                            *
+ * Parameters: queue  - [IN/OUT] escalation queue                             *
+ *             filter - [IN] SQL filter of escalations handled by escalator   *
+ *             now    - [IN] current time                                     *
+ *                                                                            *
+ * Comments: After the initial load only new and recovered escalations having *
+ *           zero nextcheck are read from database, all other escalations are *
+ *           scheduled in memory when processed. Queue is still periodically  *
+ *           reloaded to pick up any escalations changed outside of server.   *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_queue_load(zbx_escalation_queue_t *queue, const char *filter, int now)
+{
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	zbx_binary_heap_clear(&queue->heap);
+	zbx_hashset_clear(&queue->escalations);
+
+	result = zbx_db_select("select escalationid,nextcheck from escalations where %s", filter);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t	escalationid;
+
+		ZBX_STR2UINT64(escalationid, row[0]);
+		escalation_queue_update(queue, escalationid, atoi(row[1]));
+	}
+	zbx_db_free_result(result);
+
+	queue->load_time = now;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() escalations:%d", __func__, queue->escalations.num_data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes escalations due for check from queue                      *
+ *                                                                            *
+ * Parameters: queue         - [IN/OUT] escalation queue                      *
+ *             now           - [IN] current time                              *
+ *             escalationids - [OUT] identifiers of escalations to check      *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_queue_pop_due(zbx_escalation_queue_t *queue, int now, zbx_vector_uint64_t *escalationids)
+{
+#define ZBX_ESCALATIONS_PER_SELECT	10000
+
+	while (SUCCEED != zbx_binary_heap_empty(&queue->heap) &&
+			ZBX_ESCALATIONS_PER_SELECT > escalationids->values_num)
+	{
+		zbx_binary_heap_elem_t		*elem;
+		zbx_escalation_schedule_t	*schedule;
+
+		elem = zbx_binary_heap_find_min(&queue->heap);
+		schedule = (zbx_escalation_schedule_t *)elem->data;
+
+		if (schedule->nextcheck > now)
+			break;
+
+		zbx_vector_uint64_append(escalationids, schedule->escalationid);
+		zbx_binary_heap_remove_min(&queue->heap);
+		zbx_hashset_remove_direct(&queue->escalations, schedule);
+	}
+
+	zbx_vector_uint64_sort(escalationids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+#undef ZBX_ESCALATIONS_PER_SELECT
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: schedules next check of processed escalations                     *
+ *                                                                            *
+ * Parameters: queue         - [IN/OUT] escalation queue                      *
+ *             now           - [IN] current time                              *
+ *             escalations   - [IN] processed escalations                     *
+ *             escalationids - [IN] identifiers of deleted escalations        *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_queue_reschedule(zbx_escalation_queue_t *queue, int now,
+		const zbx_vector_db_escalation_ptr_t *escalations, zbx_vector_uint64_t *escalationids)
+{
+	zbx_vector_uint64_sort(escalationids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	for (int i = 0; i < escalations->values_num; i++)
+	{
+		const zbx_db_escalation	*escalation = escalations->values[i];
+		int			nextcheck = escalation->nextcheck;
+
+		if (ESCALATION_STATUS_COMPLETED == escalation->status)
+			continue;
+
+		if (FAIL != zbx_vector_uint64_bsearch(escalationids, escalation->escalationid,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+		{
+			continue;
+		}
+
+		/* skipped escalations are checked again during next escalator period */
+		if (nextcheck <= now)
+			nextcheck = now + CONFIG_ESCALATOR_FREQUENCY;
+
+		escalation_queue_update(queue, escalation->escalationid, nextcheck);
+	}
+}
+
+static int	process_db_escalations(zbx_escalation_queue_t *queue, int now, int *nextcheck,
+		zbx_vector_db_escalation_ptr_t *escalations, zbx_vector_uint64_t *eventids,
+		zbx_vector_uint64_t *problem_eventids, zbx_vector_uint64_t *actionids, const char *default_timezone,
+		int config_timeout, int config_trapper_timeout, const char *config_source_ip, int *config_forks)
 {
 	int					ret;
 	zbx_vector_uint64_t			escalationids, symptom_eventids;
@@ -3313,6 +3500,8 @@ static int	process_db_escalations(int now, int *nextcheck, zbx_vector_db_escalat
 
 	zbx_db_commit();
 out:
+	escalation_queue_reschedule(queue, now, escalations, &escalationids);
+
 	zbx_dc_close_user_macros(um_handle);
 
 	zbx_vector_escalation_diff_ptr_clear_ext(&diffs, (void (*)(zbx_escalation_diff_t *))zbx_ptr_free);
@@ -3353,7 +3542,8 @@ out:
  *          deletes completed escalations from the database;                   *
  *          cancels escalations due to changed configuration, etc.             *
  *                                                                             *
- * Parameters: now                    - [IN] current time                      *
+ * Parameters: queue                  - [IN/OUT] escalation queue              *
+ *             now                    - [IN] current time                      *
  *             nextcheck              - [IN/OUT] time of next invocation       *
  *             escalation_source      - [IN] type of escalations to be handled *
  *             default_timezone       - [IN]                                   *
@@ -3372,18 +3562,18 @@ out:
  *           in process_actions().                                             *
  *                                                                             *
  *******************************************************************************/
-static int	process_escalations(int now, int *nextcheck, unsigned int escalation_source,
-		const char *default_timezone, int process_num, int config_timeout, int config_trapper_timeout,
-		const char *config_source_ip, int *config_forks)
+static int	process_escalations(zbx_escalation_queue_t *queue, int now, int *nextcheck,
+		unsigned int escalation_source, const char *default_timezone, int process_num, int config_timeout,
+		int config_trapper_timeout, const char *config_source_ip, int *config_forks)
 {
 	int				ret = 0;
 	zbx_db_result_t			result;
 	zbx_db_row_t			row;
-	char				*filter = NULL;
-	size_t				filter_alloc = 0, filter_offset = 0;
+	char				*filter = NULL, *sql = NULL;
+	size_t				filter_alloc = 0, filter_offset = 0, sql_alloc = 0, sql_offset = 0;
 	const int			config_escalator_forks = config_forks[ZBX_PROCESS_TYPE_ESCALATOR];
 	zbx_vector_db_escalation_ptr_t	escalations;
-	zbx_vector_uint64_t		actionids, eventids, problem_eventids;
+	zbx_vector_uint64_t		actionids, eventids, problem_eventids, due_escalationids;
 	zbx_db_escalation		*escalation;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -3392,6 +3582,7 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 	zbx_vector_uint64_create(&actionids);
 	zbx_vector_uint64_create(&eventids);
 	zbx_vector_uint64_create(&problem_eventids);
+	zbx_vector_uint64_create(&due_escalationids);
 
 	/* Selection of escalations to be processed:                                                          */
 	/*                                                                                                    */
@@ -3452,27 +3643,47 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 			break;
 	}
 
-	result = zbx_db_select("select escalationid,actionid,triggerid,eventid,r_eventid,nextcheck,esc_step,status,"
-					"itemid,acknowledgeid,servicealarmid,serviceid"
-				" from escalations"
-				" where %s and nextcheck<=%d"
-				" order by actionid,triggerid,itemid," ZBX_SQL_SORT_ASC("r_eventid") ",escalationid",
-				filter, now + CONFIG_ESCALATOR_FREQUENCY);
+	if (ZBX_ESCALATION_QUEUE_RELOAD_FREQUENCY <= now - queue->load_time)
+		escalation_queue_load(queue, filter, now);
+
+	/* new and recovered escalations are created with zero nextcheck, */
+	/* other escalations are checked according to in-memory schedule */
+	escalation_queue_pop_due(queue, now, &due_escalationids);
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
+			"select escalationid,actionid,triggerid,eventid,r_eventid,nextcheck,esc_step,status,"
+				"itemid,acknowledgeid,servicealarmid,serviceid"
+			" from escalations"
+			" where %s and (nextcheck=0", filter);
+
+	if (0 != due_escalationids.values_num)
+	{
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, " or");
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "escalationid", due_escalationids.values,
+				due_escalationids.values_num);
+	}
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ")"
+			" order by actionid,triggerid,itemid," ZBX_SQL_SORT_ASC("r_eventid") ",escalationid");
+
+	result = zbx_db_select("%s", sql);
+	zbx_free(sql);
 	zbx_free(filter);
 
 	while (NULL != (row = zbx_db_fetch(result)) && ZBX_IS_RUNNING())
 	{
 #		define ZBX_ESCALATIONS_PER_STEP	1000
 
-		int	esc_nextcheck;
+		int		esc_nextcheck;
+		zbx_uint64_t	escalationid;
 
 		esc_nextcheck = atoi(row[5]);
 
-		/* skip escalations that must be checked in next CONFIG_ESCALATOR_FREQUENCY period */
+		/* reschedule escalations that are not due yet */
 		if (esc_nextcheck > now)
 		{
-			if (esc_nextcheck < *nextcheck)
-				*nextcheck = esc_nextcheck;
+			ZBX_STR2UINT64(escalationid, row[0]);
+			escalation_queue_update(queue, escalationid, esc_nextcheck);
 
 			continue;
 		}
@@ -3501,9 +3712,9 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 
 		if (ZBX_ESCALATIONS_PER_STEP <= escalations.values_num)
 		{
-			ret += process_db_escalations(now, nextcheck, &escalations, &eventids, &problem_eventids,
-					&actionids, default_timezone, config_timeout, config_trapper_timeout,
-					config_source_ip, config_forks);
+			ret += process_db_escalations(queue, now, nextcheck, &escalations, &eventids,
+					&problem_eventids, &actionids, default_timezone, config_timeout,
+					config_trapper_timeout, config_source_ip, config_forks);
 			zbx_vector_db_escalation_ptr_clear_ext(&escalations,
 					(void (*)(zbx_db_escalation *))zbx_ptr_free);
 			zbx_vector_uint64_clear(&actionids);
@@ -3517,16 +3728,27 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 
 	if (0 < escalations.values_num)
 	{
-		ret += process_db_escalations(now, nextcheck, &escalations, &eventids, &problem_eventids,
-				&actionids, default_timezone, config_timeout, config_trapper_timeout,
-				config_source_ip, config_forks);
+		ret += process_db_escalations(queue, now, nextcheck, &escalations, &eventids, &problem_eventids,
+				&actionids, default_timezone, config_timeout, config_trapper_timeout, config_source_ip,
+				config_forks);
 		zbx_vector_db_escalation_ptr_clear_ext(&escalations, (void (*)(zbx_db_escalation *))zbx_ptr_free);
 	}
 
+	if (SUCCEED != zbx_binary_heap_empty(&queue->heap))
+	{
+		const zbx_escalation_schedule_t	*schedule;
+
+		schedule = (const zbx_escalation_schedule_t *)zbx_binary_heap_find_min(&queue->heap)->data;
+
+		if (schedule->nextcheck < *nextcheck)
+			*nextcheck = schedule->nextcheck;
+	}
+
 	zbx_vector_db_escalation_ptr_destroy(&escalations);
 	zbx_vector_uint64_destroy(&actionids);
 	zbx_vector_uint64_destroy(&eventids);
 	zbx_vector_uint64_destroy(&problem_eventids);
+	zbx_vector_uint64_destroy(&due_escalationids);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
@@ -3552,12 +3774,18 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 	int				server_num = ((zbx_thread_args_t *)args)->info.server_num;
 	int				process_num = ((zbx_thread_args_t *)args)->info.process_num;
 	unsigned char			process_type = ((zbx_thread_args_t *)args)->info.process_type;
+	zbx_escalation_queue_t		trigger_queue, item_queue, service_queue, default_queue;
 
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
 
 	zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
+	escalation_queue_init(&trigger_queue);
+	escalation_queue_init(&item_queue);
+	escalation_queue_init(&service_queue);
+	escalation_queue_init(&default_queue);
+
 #if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
 	zbx_tls_init_child(escalator_args_in->zbx_config_tls, escalator_args_in->zbx_get_program_type_cb_arg);
 #endif
@@ -3588,22 +3816,22 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 		zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_DEFAULT_TIMEZONE);
 
 		nextcheck = time(NULL) + CONFIG_ESCALATOR_FREQUENCY;
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_TRIGGER,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_forks);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_ITEM,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_forks);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_SERVICE,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_forks);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_DEFAULT,
-				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
-				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
-				escalator_args_in->config_forks);
+		escalations_count += process_escalations(&trigger_queue, time(NULL), &nextcheck,
+				ZBX_ESCALATION_SOURCE_TRIGGER, cfg.default_timezone, process_num,
+				escalator_args_in->config_timeout, escalator_args_in->config_trapper_timeout,
+				escalator_args_in->config_source_ip, escalator_args_in->config_forks);
+		escalations_count += process_escalations(&item_queue, time(NULL), &nextcheck,
+				ZBX_ESCALATION_SOURCE_ITEM, cfg.default_timezone, process_num,
+				escalator_args_in->config_timeout, escalator_args_in->config_trapper_timeout,
+				escalator_args_in->config_source_ip, escalator_args_in->config_forks);
+		escalations_count += process_escalations(&service_queue, time(NULL), &nextcheck,
+				ZBX_ESCALATION_SOURCE_SERVICE, cfg.default_timezone, process_num,
+				escalator_args_in->config_timeout, escalator_args_in->config_trapper_timeout,
+				escalator_args_in->config_source_ip, escalator_args_in->config_forks);
+		escalations_count += process_escalations(&default_queue, time(NULL), &nextcheck,
+				ZBX_ESCALATION_SOURCE_DEFAULT, cfg.default_timezone, process_num,
+				escalator_args_in->config_timeout, escalator_args_in->config_trapper_timeout,
+				escalator_args_in->config_source_ip, escalator_args_in->config_forks);
 
 		zbx_config_clean(&cfg);
 		total_sec += zbx_time() - sec;
@@ -18,6 +18,7 @@
 **/
 
 #include "events.h"
+#include "problem_cache.h"
 
 #include "../db_lengths.h"
 #include "../actions.h"
@@ -51,16 +52,6 @@ typedef struct
 }
 zbx_event_recovery_t;
 
-/* problem event, used to cache open problems for recovery attempts */
-typedef struct
-{
-	zbx_uint64_t		eventid;
-	zbx_uint64_t		triggerid;
-
-	zbx_vector_tags_t	tags;
-}
-zbx_event_problem_t;
-
 typedef enum
 {
 	CORRELATION_MATCH = 0,
@@ -74,6 +65,10 @@ static zbx_hashset_t		event_recovery;
 static zbx_hashset_t		correlation_cache;
 static zbx_correlation_rules_t	correlation_rules;
 
+/* problem changes to be applied to problem cache after transaction is committed */
+static zbx_vector_db_event_t	problem_cache_events;
+static zbx_vector_uint64_t	problem_cache_r_eventids;
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Check that tag name is not empty and that tag is not duplicate.   *
@@ -525,6 +520,9 @@ static void	save_problems(void)
 			zbx_db_insert_add_values(&db_insert, event->eventid, event->source, event->object,
 					event->objectid, event->clock, event->ns, ZBX_NULL2EMPTY_STR(event->name),
 					event->severity);
+
+			if (EVENT_SOURCE_TRIGGERS == event->source)
+				zbx_vector_db_event_append(&problem_cache_events, (zbx_db_event *)event);
 		}
 
 		zbx_db_insert_execute(&db_insert);
@@ -611,6 +609,9 @@ static void	save_event_recovery(void)
 				recovery->eventid);
 
 		zbx_db_execute_overflowed_sql(&sql, &sql_alloc, &sql_offset);
+
+		if (EVENT_SOURCE_TRIGGERS == recovery->r_event->source)
+			zbx_vector_uint64_append(&problem_cache_r_eventids, recovery->eventid);
 	}
 
 	zbx_db_insert_execute(&db_insert);
@@ -1173,6 +1174,354 @@ typedef enum
 }
 zbx_problem_state_t;
 
+/* correlation rule filter for matching cached open problems */
+typedef struct
+{
+	/* correlation formula with new event conditions replaced by their values */
+	const char		*expression;
+	const zbx_db_event	*event;
+}
+zbx_corr_problem_filter_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if the old event correlation condition matches problem     *
+ *                                                                            *
+ * Parameters: condition - [IN] correlation condition to check                *
+ *             event     - [IN] new event                                     *
+ *             tags      - [IN] problem tags                                  *
+ *             tags_num  - [IN] number of problem tags                        *
+ *                                                                            *
+ * Return value: "1" - condition matches problem                              *
+ *               "0" - otherwise                                              *
+ *                                                                            *
+ * Comments: The matching follows sql filters created by                      *
+ *           correlation_condition_get_event_filter() function.               *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*correlation_condition_match_problem(const zbx_corr_condition_t *condition,
+		const zbx_db_event *event, const zbx_tag_t *tags, int tags_num)
+{
+	switch (condition->type)
+	{
+		int					i, j;
+		const zbx_tag_t				*tag;
+		const zbx_corr_condition_tag_value_t	*cond;
+		const char				*match, *no_match;
+		unsigned char				op;
+
+		case ZBX_CORR_CONDITION_OLD_EVENT_TAG:
+			for (i = 0; i < tags_num; i++)
+			{
+				if (0 == strcmp(tags[i].tag, condition->data.tag.tag))
+					return "1";
+			}
+			break;
+
+		case ZBX_CORR_CONDITION_EVENT_TAG_PAIR:
+			for (i = 0; i < tags_num; i++)
+			{
+				if (0 != strcmp(tags[i].tag, condition->data.tag_pair.oldtag))
+					continue;
+
+				for (j = 0; j < event->tags.values_num; j++)
+				{
+					tag = event->tags.values[j];
+
+					if (0 == strcmp(tag->tag, condition->data.tag_pair.newtag) &&
+							0 == strcmp(tag->value, tags[i].value))
+					{
+						return "1";
+					}
+				}
+			}
+			break;
+
+		case ZBX_CORR_CONDITION_OLD_EVENT_TAG_VALUE:
+			cond = &condition->data.tag_value;
+
+			/* negative operations match problems without tags matching positive operation */
+			switch (cond->op)
+			{
+				case ZBX_CONDITION_OPERATOR_NOT_EQUAL:
+					op = ZBX_CONDITION_OPERATOR_EQUAL;
+					match = "0";
+					no_match = "1";
+					break;
+				case ZBX_CONDITION_OPERATOR_NOT_LIKE:
+					op = ZBX_CONDITION_OPERATOR_LIKE;
+					match = "0";
+					no_match = "1";
+					break;
+				default:
+					op = cond->op;
+					match = "1";
+					no_match = "0";
+			}
+
+			for (i = 0; i < tags_num; i++)
+			{
+				if (0 == strcmp(tags[i].tag, cond->tag) &&
+						SUCCEED == zbx_strmatch_condition(tags[i].value, cond->value, op))
+				{
+					return match;
+				}
+			}
+
+			return no_match;
+	}
+
+	return "0";
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if cached open problem matches correlation rule            *
+ *                                                                            *
+ * Parameters: tags     - [IN] problem tags                                   *
+ *             tags_num - [IN] number of problem tags                         *
+ *             data     - [IN] correlation filter (zbx_corr_problem_filter_t) *
+ *                                                                            *
+ * Return value: SUCCEED - the problem matches correlation rule               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	correlation_match_problem(const zbx_tag_t *tags, int tags_num, void *data)
+{
+	const zbx_corr_problem_filter_t	*filter = (const zbx_corr_problem_filter_t *)data;
+	char				*expression, error[256];
+	zbx_token_t			token;
+	int				pos = 0, ret = FAIL;
+	zbx_uint64_t			conditionid;
+	zbx_strloc_t			*loc;
+	double				result;
+
+	if ('\0' == *filter->expression)
+		return SUCCEED;
+
+	expression = zbx_strdup(NULL, filter->expression);
+
+	for (; SUCCEED == zbx_token_find(expression, pos, &token, ZBX_TOKEN_SEARCH_BASIC); pos++)
+	{
+		const zbx_corr_condition_t	*condition;
+		const char			*value;
+
+		if (ZBX_TOKEN_OBJECTID != token.type)
+			continue;
+
+		loc = &token.data.objectid.name;
+
+		if (SUCCEED != zbx_is_uint64_n(expression + loc->l, loc->r - loc->l + 1, &conditionid))
+			continue;
+
+		if (NULL == (condition = (zbx_corr_condition_t *)zbx_hashset_search(&correlation_rules.conditions,
+				&conditionid)))
+		{
+			goto out;
+		}
+
+		value = correlation_condition_match_problem(condition, filter->event, tags, tags_num);
+
+		zbx_replace_string(&expression, token.loc.l, &token.loc.r, value);
+		pos = token.loc.r;
+	}
+
+	if (SUCCEED == zbx_evaluate_unknown(expression, &result, error, sizeof(error)) &&
+			SUCCEED == zbx_double_compare(result, 1))
+	{
+		ret = SUCCEED;
+	}
+out:
+	zbx_free(expression);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares correlation rule filter for matching cached problems     *
+ *                                                                            *
+ * Parameters: correlation - [IN] correlation rule                            *
+ *             event       - [IN] new event                                   *
+ *             expression  - [OUT] correlation formula with new event         *
+ *                                 conditions replaced by their values        *
+ *             tags        - [OUT] tag names used by old event conditions     *
+ *             check_all   - [OUT] SUCCEED - all problems must be checked     *
+ *                                 FAIL    - only problems having at least    *
+ *                                           one of the returned tags can     *
+ *                                           match                            *
+ *                                                                            *
+ * Return value: SUCCEED - the filter was prepared successfully               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The formula is evaluated for a problem not having any of the     *
+ *           returned tags, with negative tag value conditions left unknown.  *
+ *           If it evaluates to false, such problems cannot match and only    *
+ *           problems found by the tag index must be checked.                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	correlation_prepare_problem_filter(const zbx_correlation_t *correlation, const zbx_db_event *event,
+		char **expression, zbx_vector_str_t *tags, int *check_all)
+{
+	char			*filter, error[256];
+	const char		*value;
+	zbx_token_t		token;
+	int			pos;
+	zbx_uint64_t		conditionid;
+	zbx_strloc_t		*loc;
+	zbx_corr_condition_t	*condition;
+	double			result;
+
+	*expression = zbx_strdup(NULL, correlation->formula);
+	*check_all = SUCCEED;
+
+	for (pos = 0; SUCCEED == zbx_token_find(*expression, pos, &token, ZBX_TOKEN_SEARCH_BASIC); pos++)
+	{
+		if (ZBX_TOKEN_OBJECTID != token.type)
+			continue;
+
+		loc = &token.data.objectid.name;
+
+		if (SUCCEED != zbx_is_uint64_n(*expression + loc->l, loc->r - loc->l + 1, &conditionid))
+			continue;
+
+		if (NULL == (condition = (zbx_corr_condition_t *)zbx_hashset_search(&correlation_rules.conditions,
+				&conditionid)))
+		{
+			zbx_free(*expression);
+			return FAIL;
+		}
+
+		switch (condition->type)
+		{
+			case ZBX_CORR_CONDITION_OLD_EVENT_TAG:
+			case ZBX_CORR_CONDITION_EVENT_TAG_PAIR:
+			case ZBX_CORR_CONDITION_OLD_EVENT_TAG_VALUE:
+				pos = token.loc.r;
+				continue;
+		}
+
+		value = correlation_condition_match_new_event(condition, event, SUCCEED);
+
+		zbx_replace_string(expression, token.loc.l, &token.loc.r, value);
+		pos = token.loc.r;
+	}
+
+	if ('\0' == **expression)
+		return SUCCEED;
+
+	filter = zbx_strdup(NULL, *expression);
+
+	for (pos = 0; SUCCEED == zbx_token_find(filter, pos, &token, ZBX_TOKEN_SEARCH_BASIC); pos++)
+	{
+		if (ZBX_TOKEN_OBJECTID != token.type)
+			continue;
+
+		loc = &token.data.objectid.name;
+
+		if (SUCCEED != zbx_is_uint64_n(filter + loc->l, loc->r - loc->l + 1, &conditionid))
+			continue;
+
+		if (NULL == (condition = (zbx_corr_condition_t *)zbx_hashset_search(&correlation_rules.conditions,
+				&conditionid)))
+		{
+			continue;
+		}
+
+		switch (condition->type)
+		{
+			case ZBX_CORR_CONDITION_OLD_EVENT_TAG:
+				zbx_vector_str_append(tags, condition->data.tag.tag);
+				value = "0";
+				break;
+			case ZBX_CORR_CONDITION_EVENT_TAG_PAIR:
+				zbx_vector_str_append(tags, condition->data.tag_pair.oldtag);
+				value = "0";
+				break;
+			case ZBX_CORR_CONDITION_OLD_EVENT_TAG_VALUE:
+				if (ZBX_CONDITION_OPERATOR_NOT_EQUAL == condition->data.tag_value.op ||
+						ZBX_CONDITION_OPERATOR_NOT_LIKE == condition->data.tag_value.op)
+				{
+					value = ZBX_UNKNOWN_STR "0";
+				}
+				else
+				{
+					zbx_vector_str_append(tags, condition->data.tag_value.tag);
+					value = "0";
+				}
+				break;
+			default:
+				value = "0";
+		}
+
+		zbx_replace_string(&filter, token.loc.l, &token.loc.r, value);
+		pos = token.loc.r;
+	}
+
+	if (SUCCEED == zbx_evaluate_unknown(filter, &result, error, sizeof(error)) && ZBX_UNKNOWN != result &&
+			SUCCEED != zbx_double_compare(result, 1))
+	{
+		*check_all = FAIL;
+	}
+
+	zbx_free(filter);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find cached open problems matching correlation rule and execute   *
+ *          correlation operations                                            *
+ *                                                                            *
+ * Parameters: correlation - [IN] correlation rule                            *
+ *             event       - [IN/OUT] new event                               *
+ *                                                                            *
+ * Return value: SUCCEED - the correlation rule was processed                 *
+ *               FAIL    - open problem cache is not available                *
+ *                                                                            *
+ ******************************************************************************/
+static int	correlate_event_by_cached_problems(const zbx_correlation_t *correlation, zbx_db_event *event)
+{
+	zbx_corr_problem_filter_t	filter;
+	char				*expression;
+	zbx_vector_str_t		tags;
+	zbx_vector_uint64_pair_t	matches;
+	int				i, check_all, ret;
+
+	zbx_vector_str_create(&tags);
+
+	if (SUCCEED != correlation_prepare_problem_filter(correlation, event, &expression, &tags, &check_all))
+	{
+		zbx_vector_str_destroy(&tags);
+		return SUCCEED;
+	}
+
+	zbx_vector_uint64_pair_create(&matches);
+
+	filter.expression = expression;
+	filter.event = event;
+
+	ret = zbx_problem_cache_match(SUCCEED == check_all ? NULL : &tags, correlation_match_problem, &filter,
+			&matches);
+
+	for (i = 0; i < matches.values_num; i++)
+	{
+		/* check if this event is not already recovered by another correlation rule */
+		if (NULL != zbx_hashset_search(&correlation_cache, &matches.values[i].first))
+			continue;
+
+		correlation_execute_operations(correlation, event, matches.values[i].first,
+				matches.values[i].second);
+	}
+
+	zbx_vector_uint64_pair_destroy(&matches);
+	zbx_vector_str_destroy(&tags);
+	zbx_free(expression);
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: find problem events that must be recovered by global correlation  *
@@ -1187,8 +1536,9 @@ zbx_problem_state_t;
  *           The global event correlation matching is done in two parts:      *
  *             1) exclude correlations that can't possibly match the event    *
  *                based on new event tag/value/group conditions               *
- *             2) assemble sql statement to select problems/correlations      *
- *                based on the rest correlation conditions                    *
+ *             2) find matching problems in open problem cache or assemble    *
+ *                sql statement to select problems/correlations based on the  *
+ *                rest correlation conditions                                 *
  *                                                                            *
  ******************************************************************************/
 static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_state_t *problem_state)
@@ -1233,16 +1583,27 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 			if (ZBX_PROBLEM_STATE_UNKNOWN == *problem_state)
 			{
 				zbx_db_result_t	result;
+				int		problems_num;
 
-				result = zbx_db_select_n("select eventid from problem"
-						" where r_eventid is null and source="
-						ZBX_STR(EVENT_SOURCE_TRIGGERS), 1);
-
-				if (NULL == zbx_db_fetch(result))
-					*problem_state = ZBX_PROBLEM_STATE_RESOLVED;
+				if (SUCCEED == zbx_problem_cache_get_problems_num(&problems_num))
+				{
+					if (0 == problems_num)
+						*problem_state = ZBX_PROBLEM_STATE_RESOLVED;
+					else
+						*problem_state = ZBX_PROBLEM_STATE_OPEN;
+				}
 				else
-					*problem_state = ZBX_PROBLEM_STATE_OPEN;
-				zbx_db_free_result(result);
+				{
+					result = zbx_db_select_n("select eventid from problem"
+							" where r_eventid is null and source="
+							ZBX_STR(EVENT_SOURCE_TRIGGERS), 1);
+
+					if (NULL == zbx_db_fetch(result))
+						*problem_state = ZBX_PROBLEM_STATE_RESOLVED;
+					else
+						*problem_state = ZBX_PROBLEM_STATE_OPEN;
+					zbx_db_free_result(result);
+				}
 			}
 
 			if (ZBX_PROBLEM_STATE_RESOLVED == *problem_state)
@@ -1268,6 +1629,16 @@ static void	correlate_event_by_global_rules(zbx_db_event *event, zbx_problem_sta
 			correlation_execute_operations((zbx_correlation_t *)corr_new.values[i], event, 0, 0);
 	}
 
+	/* match old events in open problem cache, leaving correlations to be matched in database */
+	/* when the cache is not available                                                       */
+	for (i = 0; i < corr_old.values_num;)
+	{
+		if (SUCCEED == correlate_event_by_cached_problems((zbx_correlation_t *)corr_old.values[i], event))
+			zbx_vector_ptr_remove(&corr_old, i);
+		else
+			i++;
+	}
+
 	if (0 != corr_old.values_num)
 	{
 		zbx_db_result_t	result;
@@ -1680,6 +2051,8 @@ void	zbx_initialize_events(void)
 	zbx_vector_db_event_create(&events);
 	zbx_hashset_create(&event_recovery, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	zbx_hashset_create(&correlation_cache, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_vector_db_event_create(&problem_cache_events);
+	zbx_vector_uint64_create(&problem_cache_r_eventids);
 
 	zbx_dc_correlation_rules_init(&correlation_rules);
 }
@@ -1694,6 +2067,8 @@ void	zbx_uninitialize_events(void)
 	zbx_vector_db_event_destroy(&events);
 	zbx_hashset_destroy(&event_recovery);
 	zbx_hashset_destroy(&correlation_cache);
+	zbx_vector_db_event_destroy(&problem_cache_events);
+	zbx_vector_uint64_destroy(&problem_cache_r_eventids);
 
 	zbx_dc_correlation_rules_free(&correlation_rules);
 }
@@ -1706,6 +2081,7 @@ void	zbx_uninitialize_events(void)
 void	zbx_reset_event_recovery(void)
 {
 	zbx_hashset_clear(&event_recovery);
+	zbx_vector_uint64_clear(&problem_cache_r_eventids);
 }
 
 /******************************************************************************
@@ -1739,6 +2115,7 @@ static void	zbx_clean_event(zbx_db_event *event)
  ******************************************************************************/
 void	zbx_clean_events(void)
 {
+	zbx_vector_db_event_clear(&problem_cache_events);
 	zbx_vector_db_event_clear_ext(&events, zbx_clean_event);
 
 	zbx_reset_event_recovery();
@@ -2018,6 +2395,21 @@ void	zbx_events_update_itservices(void)
 	zbx_free(data);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: applies committed problem changes to open problem cache           *
+ *                                                                            *
+ * Comments: Must be called only after successful transaction commit.         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_events_update_problem_cache(void)
+{
+	zbx_problem_cache_update(&problem_cache_events, &problem_cache_r_eventids);
+
+	zbx_vector_db_event_clear(&problem_cache_events);
+	zbx_vector_uint64_clear(&problem_cache_r_eventids);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: adds event suppress data for problem events matching active       *
@@ -2368,6 +2760,9 @@ static void	process_internal_events_without_actions(zbx_vector_ptr_t *internal_p
  * Parameters: triggerids - [IN] trigger identifiers (sorted)                 *
  *             problems   - [OUT]                                             *
  *                                                                            *
+ * Comments: The problems are read from database only when open problem       *
+ *           cache is not available.                                          *
+ *                                                                            *
  ******************************************************************************/
 static void	get_open_problems(const zbx_vector_uint64_t *triggerids, zbx_vector_ptr_t *problems)
 {
@@ -2381,6 +2776,9 @@ static void	get_open_problems(const zbx_vector_uint64_t *triggerids, zbx_vector_
 	int			index;
 	zbx_vector_uint64_t	eventids;
 
+	if (SUCCEED == zbx_problem_cache_get_problems(triggerids, problems))
+		return;
+
 	zbx_vector_uint64_create(&eventids);
 
 	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset,
@@ -2945,6 +3343,7 @@ int	zbx_close_problem(zbx_uint64_t triggerid, zbx_uint64_t eventid, zbx_uint64_t
 
 			zbx_dc_config_triggers_apply_changes(&trigger_diff);
 
+			zbx_events_update_problem_cache();
 			zbx_events_update_itservices();
 
 			zbx_vector_connector_filter_create(&connector_filters_events);
@@ -0,0 +1,723 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "problem_cache.h"
+
+#include "zbxmutexs.h"
+#include "zbxshmem.h"
+#include "zbxdb.h"
+#include "zbxnum.h"
+
+typedef struct zbx_pc_problem	zbx_pc_problem_t;
+typedef struct zbx_pc_tag_link	zbx_pc_tag_link_t;
+
+/* problems having the same tag name */
+typedef struct
+{
+	char			*tag;
+	zbx_pc_tag_link_t	*head;
+}
+zbx_pc_tag_t;
+
+/* problem tag entry in the tag index list */
+struct zbx_pc_tag_link
+{
+	zbx_pc_problem_t	*problem;
+	zbx_pc_tag_t		*index;
+	zbx_pc_tag_link_t	*prev;
+	zbx_pc_tag_link_t	*next;
+};
+
+/* open trigger problem */
+struct zbx_pc_problem
+{
+	zbx_uint64_t		eventid;
+	zbx_uint64_t		triggerid;
+
+	/* trigger problem list */
+	zbx_pc_problem_t	*prev;
+	zbx_pc_problem_t	*next;
+
+	/* tag names are shared with the tag index, tags and links are allocated as single block */
+	zbx_tag_t		*tags;
+	zbx_pc_tag_link_t	*links;
+	int			tags_num;
+};
+
+/* open problems of a trigger */
+typedef struct
+{
+	zbx_uint64_t		triggerid;
+	zbx_pc_problem_t	*head;
+}
+zbx_pc_trigger_t;
+
+/* the cache is not loaded yet */
+#define ZBX_PC_STATE_EMPTY	0
+/* the cache contains all open trigger problems */
+#define ZBX_PC_STATE_READY	1
+/* the cache ran out of memory and cannot be used */
+#define ZBX_PC_STATE_DISABLED	2
+
+typedef struct
+{
+	zbx_hashset_t	problems;
+	zbx_hashset_t	triggers;
+	zbx_hashset_t	tags;
+	int		state;
+}
+zbx_pc_cache_t;
+
+static zbx_pc_cache_t	*cache = NULL;
+
+static zbx_shmem_info_t	*pc_mem = NULL;
+
+static zbx_mutex_t	pc_lock = ZBX_MUTEX_NULL;
+
+ZBX_SHMEM_FUNC_IMPL(__pc, pc_mem)
+
+#define LOCK_CACHE	zbx_mutex_lock(pc_lock)
+#define UNLOCK_CACHE	zbx_mutex_unlock(pc_lock)
+
+static char	*pc_strdup(const char *str)
+{
+	char	*ptr;
+	size_t	len;
+
+	len = strlen(str) + 1;
+
+	if (NULL != (ptr = (char *)__pc_shmem_malloc_func(NULL, len)))
+		memcpy(ptr, str, len);
+
+	return ptr;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove all problems and stop using the cache                      *
+ *                                                                            *
+ * Comments: Used when cache runs out of memory - a partially filled cache    *
+ *           cannot be used to find open problems.                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	pc_disable(void)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_pc_problem_t	*problem;
+	zbx_pc_tag_t		*index;
+	int			i;
+
+	zbx_hashset_iter_reset(&cache->problems, &iter);
+	while (NULL != (problem = (zbx_pc_problem_t *)zbx_hashset_iter_next(&iter)))
+	{
+		for (i = 0; i < problem->tags_num; i++)
+			__pc_shmem_free_func(problem->tags[i].value);
+
+		if (NULL != problem->tags)
+			__pc_shmem_free_func(problem->tags);
+	}
+
+	zbx_hashset_iter_reset(&cache->tags, &iter);
+	while (NULL != (index = (zbx_pc_tag_t *)zbx_hashset_iter_next(&iter)))
+		__pc_shmem_free_func(index->tag);
+
+	zbx_hashset_clear(&cache->problems);
+	zbx_hashset_clear(&cache->triggers);
+	zbx_hashset_clear(&cache->tags);
+
+	cache->state = ZBX_PC_STATE_DISABLED;
+
+	zabbix_log(LOG_LEVEL_WARNING, "problem cache is out of memory, open problems will be read from database;"
+			" consider increasing ProblemCacheSize configuration parameter");
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add open problem to cache                                         *
+ *                                                                            *
+ * Parameters: eventid   - [IN] the problem event identifier                  *
+ *             triggerid - [IN] the source trigger identifier                 *
+ *             tags      - [IN] the problem tags                              *
+ *             tags_num  - [IN] the number of problem tags                    *
+ *                                                                            *
+ * Return value: SUCCEED - the problem was added                              *
+ *               FAIL    - the cache is out of memory                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	pc_add_problem(zbx_uint64_t eventid, zbx_uint64_t triggerid, zbx_tag_t * const *tags, int tags_num)
+{
+	zbx_pc_problem_t	*problem, problem_local = {.eventid = eventid, .triggerid = triggerid};
+	zbx_pc_trigger_t	*trigger;
+	int			i;
+
+	if (NULL != zbx_hashset_search(&cache->problems, &eventid))
+		return SUCCEED;
+
+	if (NULL == (trigger = (zbx_pc_trigger_t *)zbx_hashset_search(&cache->triggers, &triggerid)))
+	{
+		zbx_pc_trigger_t	trigger_local = {.triggerid = triggerid};
+
+		if (NULL == (trigger = (zbx_pc_trigger_t *)zbx_hashset_insert(&cache->triggers, &trigger_local,
+				sizeof(trigger_local))))
+		{
+			return FAIL;
+		}
+	}
+
+	if (NULL == (problem = (zbx_pc_problem_t *)zbx_hashset_insert(&cache->problems, &problem_local,
+			sizeof(problem_local))))
+	{
+		return FAIL;
+	}
+
+	if (NULL != (problem->next = trigger->head))
+		problem->next->prev = problem;
+	trigger->head = problem;
+
+	if (0 == tags_num)
+		return SUCCEED;
+
+	if (NULL == (problem->tags = (zbx_tag_t *)__pc_shmem_malloc_func(NULL,
+			(sizeof(zbx_tag_t) + sizeof(zbx_pc_tag_link_t)) * (size_t)tags_num)))
+	{
+		return FAIL;
+	}
+
+	problem->links = (zbx_pc_tag_link_t *)(problem->tags + tags_num);
+
+	for (i = 0; i < tags_num; i++)
+	{
+		zbx_pc_tag_t		*index;
+		zbx_pc_tag_link_t	*link;
+		char			*value;
+
+		if (NULL == (index = (zbx_pc_tag_t *)zbx_hashset_search(&cache->tags, &tags[i]->tag)))
+		{
+			zbx_pc_tag_t	index_local = {.head = NULL};
+
+			if (NULL == (index_local.tag = pc_strdup(tags[i]->tag)))
+				return FAIL;
+
+			if (NULL == (index = (zbx_pc_tag_t *)zbx_hashset_insert(&cache->tags, &index_local,
+					sizeof(index_local))))
+			{
+				__pc_shmem_free_func(index_local.tag);
+				return FAIL;
+			}
+		}
+
+		if (NULL == (value = pc_strdup(tags[i]->value)))
+			return FAIL;
+
+		problem->tags[i].tag = index->tag;
+		problem->tags[i].value = value;
+
+		link = &problem->links[i];
+		link->problem = problem;
+		link->index = index;
+		link->prev = NULL;
+
+		if (NULL != (link->next = index->head))
+			link->next->prev = link;
+		index->head = link;
+
+		problem->tags_num++;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove problem from cache                                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	pc_remove_problem(zbx_pc_problem_t *problem)
+{
+	zbx_pc_trigger_t	*trigger;
+	int			i;
+
+	for (i = 0; i < problem->tags_num; i++)
+	{
+		zbx_pc_tag_link_t	*link = &problem->links[i];
+
+		if (NULL != link->prev)
+			link->prev->next = link->next;
+		else
+			link->index->head = link->next;
+
+		if (NULL != link->next)
+			link->next->prev = link->prev;
+
+		if (NULL == link->index->head)
+		{
+			__pc_shmem_free_func(link->index->tag);
+			zbx_hashset_remove_direct(&cache->tags, link->index);
+		}
+
+		__pc_shmem_free_func(problem->tags[i].value);
+	}
+
+	if (NULL != problem->tags)
+		__pc_shmem_free_func(problem->tags);
+
+	if (NULL != (trigger = (zbx_pc_trigger_t *)zbx_hashset_search(&cache->triggers, &problem->triggerid)))
+	{
+		if (NULL != problem->prev)
+			problem->prev->next = problem->next;
+		else
+			trigger->head = problem->next;
+
+		if (NULL != problem->next)
+			problem->next->prev = problem->prev;
+
+		if (NULL == trigger->head)
+			zbx_hashset_remove_direct(&cache->triggers, trigger);
+	}
+
+	zbx_hashset_remove_direct(&cache->problems, problem);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize open problem cache                                     *
+ *                                                                            *
+ * Parameters: cache_size - [IN] the cache size in bytes, 0 disables cache    *
+ *             error      - [OUT] the error message                           *
+ *                                                                            *
+ * Return value: SUCCEED - the cache was initialized successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_problem_cache_init(zbx_uint64_t cache_size, char **error)
+{
+	int	ret = FAIL;
+
+	if (0 == cache_size)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s(): problem cache disabled", __func__);
+		return SUCCEED;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (SUCCEED != zbx_mutex_create(&pc_lock, ZBX_MUTEX_PROBLEM_CACHE, error))
+		goto out;
+
+	if (SUCCEED != zbx_shmem_create(&pc_mem, cache_size, "problem cache size", "ProblemCacheSize", 1, error))
+		goto out;
+
+	cache = (zbx_pc_cache_t *)__pc_shmem_malloc_func(NULL, sizeof(zbx_pc_cache_t));
+
+	zbx_hashset_create_ext(&cache->problems, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			NULL, __pc_shmem_malloc_func, __pc_shmem_realloc_func, __pc_shmem_free_func);
+	zbx_hashset_create_ext(&cache->triggers, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC,
+			NULL, __pc_shmem_malloc_func, __pc_shmem_realloc_func, __pc_shmem_free_func);
+	zbx_hashset_create_ext(&cache->tags, 0, ZBX_DEFAULT_STRING_PTR_HASH_FUNC, ZBX_DEFAULT_STR_COMPARE_FUNC,
+			NULL, __pc_shmem_malloc_func, __pc_shmem_realloc_func, __pc_shmem_free_func);
+
+	cache->state = ZBX_PC_STATE_EMPTY;
+
+	ret = SUCCEED;
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s(): %s", __func__, ZBX_NULL2EMPTY_STR(*error));
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: destroy open problem cache                                        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_problem_cache_destroy(void)
+{
+	if (NULL != pc_mem)
+	{
+		zbx_shmem_destroy(pc_mem);
+		pc_mem = NULL;
+		cache = NULL;
+		zbx_mutex_destroy(&pc_lock);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: load open trigger problems from database                          *
+ *                                                                            *
+ * Comments: Must be called before starting processes that generate or close  *
+ *           problems, the cache is not used until loaded.                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_problem_cache_load(void)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	zbx_hashset_t		problems;
+	zbx_hashset_iter_t	iter;
+	zbx_event_problem_t	*problem, problem_local;
+	zbx_tag_t		*tag;
+	zbx_uint64_t		eventid;
+
+	if (NULL == cache)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	zbx_hashset_create(&problems, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	result = zbx_db_select("select eventid,objectid from problem"
+			" where source=%d"
+				" and object=%d"
+				" and r_eventid is null",
+			EVENT_SOURCE_TRIGGERS, EVENT_OBJECT_TRIGGER);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		ZBX_STR2UINT64(problem_local.eventid, row[0]);
+		ZBX_STR2UINT64(problem_local.triggerid, row[1]);
+
+		problem = (zbx_event_problem_t *)zbx_hashset_insert(&problems, &problem_local, sizeof(problem_local));
+		zbx_vector_tags_create(&problem->tags);
+	}
+	zbx_db_free_result(result);
+
+	if (0 != problems.num_data)
+	{
+		result = zbx_db_select("select pt.eventid,pt.tag,pt.value"
+				" from problem_tag pt,problem p"
+				" where pt.eventid=p.eventid"
+					" and p.source=%d"
+					" and p.object=%d"
+					" and p.r_eventid is null",
+				EVENT_SOURCE_TRIGGERS, EVENT_OBJECT_TRIGGER);
+
+		while (NULL != (row = zbx_db_fetch(result)))
+		{
+			ZBX_STR2UINT64(eventid, row[0]);
+
+			if (NULL == (problem = (zbx_event_problem_t *)zbx_hashset_search(&problems, &eventid)))
+				continue;
+
+			tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
+			tag->tag = zbx_strdup(NULL, row[1]);
+			tag->value = zbx_strdup(NULL, row[2]);
+			zbx_vector_tags_append(&problem->tags, tag);
+		}
+		zbx_db_free_result(result);
+	}
+
+	LOCK_CACHE;
+
+	cache->state = ZBX_PC_STATE_READY;
+
+	zbx_hashset_iter_reset(&problems, &iter);
+	while (NULL != (problem = (zbx_event_problem_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (SUCCEED != pc_add_problem(problem->eventid, problem->triggerid, problem->tags.values,
+				problem->tags.values_num))
+		{
+			pc_disable();
+			break;
+		}
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_hashset_iter_reset(&problems, &iter);
+	while (NULL != (problem = (zbx_event_problem_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_vector_tags_clear_ext(&problem->tags, zbx_free_tag);
+		zbx_vector_tags_destroy(&problem->tags);
+	}
+
+	zbx_hashset_destroy(&problems);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() problems:%d", __func__, cache->problems.num_data);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get number of open trigger problems                               *
+ *                                                                            *
+ * Parameters: problems_num - [OUT] the number of open problems               *
+ *                                                                            *
+ * Return value: SUCCEED - the number of problems was returned                *
+ *               FAIL    - the cache is not available                         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_problem_cache_get_problems_num(int *problems_num)
+{
+	int	ret = FAIL;
+
+	if (NULL == cache)
+		return FAIL;
+
+	LOCK_CACHE;
+
+	if (ZBX_PC_STATE_READY == cache->state)
+	{
+		*problems_num = cache->problems.num_data;
+		ret = SUCCEED;
+	}
+
+	UNLOCK_CACHE;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get open problems created by the specified triggers               *
+ *                                                                            *
+ * Parameters: triggerids - [IN] the trigger identifiers                      *
+ *             problems   - [OUT] the open problems (zbx_event_problem_t),    *
+ *                                sorted by event identifiers                 *
+ *                                                                            *
+ * Return value: SUCCEED - the problems were returned                         *
+ *               FAIL    - the cache is not available                         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_problem_cache_get_problems(const zbx_vector_uint64_t *triggerids, zbx_vector_ptr_t *problems)
+{
+	const zbx_pc_trigger_t	*trigger;
+	const zbx_pc_problem_t	*pc_problem;
+	zbx_event_problem_t	*problem;
+	zbx_tag_t		*tag;
+	int			i, j;
+
+	if (NULL == cache)
+		return FAIL;
+
+	LOCK_CACHE;
+
+	if (ZBX_PC_STATE_READY != cache->state)
+	{
+		UNLOCK_CACHE;
+		return FAIL;
+	}
+
+	for (i = 0; i < triggerids->values_num; i++)
+	{
+		if (NULL == (trigger = (const zbx_pc_trigger_t *)zbx_hashset_search(&cache->triggers,
+				&triggerids->values[i])))
+		{
+			continue;
+		}
+
+		for (pc_problem = trigger->head; NULL != pc_problem; pc_problem = pc_problem->next)
+		{
+			problem = (zbx_event_problem_t *)zbx_malloc(NULL, sizeof(zbx_event_problem_t));
+
+			problem->eventid = pc_problem->eventid;
+			problem->triggerid = pc_problem->triggerid;
+			zbx_vector_tags_create(&problem->tags);
+
+			if (0 != pc_problem->tags_num)
+				zbx_vector_tags_reserve(&problem->tags, (size_t)pc_problem->tags_num);
+
+			for (j = 0; j < pc_problem->tags_num; j++)
+			{
+				tag = (zbx_tag_t *)zbx_malloc(NULL, sizeof(zbx_tag_t));
+				tag->tag = zbx_strdup(NULL, pc_problem->tags[j].tag);
+				tag->value = zbx_strdup(NULL, pc_problem->tags[j].value);
+				zbx_vector_tags_append(&problem->tags, tag);
+			}
+
+			zbx_vector_ptr_append(problems, problem);
+		}
+	}
+
+	UNLOCK_CACHE;
+
+	zbx_vector_ptr_sort(problems, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find open problems matching the specified filter                  *
+ *                                                                            *
+ * Parameters: tags       - [IN] the tag names, a problem must have at least  *
+ *                               one of them to be checked (optional)         *
+ *             match_func - [IN] the filter callback                          *
+ *             data       - [IN] the filter callback data                     *
+ *             matches    - [OUT] the matching problem event identifier and   *
+ *                                trigger identifier pairs                    *
+ *                                                                            *
+ * Return value: SUCCEED - the matching problems were returned                *
+ *               FAIL    - the cache is not available                         *
+ *                                                                            *
+ * Comments: The filter callback is called while the cache is locked and      *
+ *           must not access the cache.                                       *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_problem_cache_match(const zbx_vector_str_t *tags, zbx_problem_cache_match_func_t match_func, void *data,
+		zbx_vector_uint64_pair_t *matches)
+{
+	const zbx_pc_problem_t	*problem;
+	zbx_uint64_pair_t	pair;
+
+	if (NULL == cache)
+		return FAIL;
+
+	LOCK_CACHE;
+
+	if (ZBX_PC_STATE_READY != cache->state)
+	{
+		UNLOCK_CACHE;
+		return FAIL;
+	}
+
+	if (NULL == tags)
+	{
+		zbx_hashset_iter_t	iter;
+
+		zbx_hashset_iter_reset(&cache->problems, &iter);
+		while (NULL != (problem = (const zbx_pc_problem_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (SUCCEED != match_func(problem->tags, problem->tags_num, data))
+				continue;
+
+			pair.first = problem->eventid;
+			pair.second = problem->triggerid;
+			zbx_vector_uint64_pair_append(matches, pair);
+		}
+	}
+	else
+	{
+		zbx_vector_ptr_t	candidates;
+		const zbx_pc_tag_t	*index;
+		const zbx_pc_tag_link_t	*link;
+		int			i;
+
+		zbx_vector_ptr_create(&candidates);
+
+		for (i = 0; i < tags->values_num; i++)
+		{
+			if (NULL == (index = (const zbx_pc_tag_t *)zbx_hashset_search(&cache->tags, &tags->values[i])))
+				continue;
+
+			for (link = index->head; NULL != link; link = link->next)
+				zbx_vector_ptr_append(&candidates, link->problem);
+		}
+
+		/* the same problem can be referenced by multiple tags */
+		zbx_vector_ptr_sort(&candidates, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+		zbx_vector_ptr_uniq(&candidates, ZBX_DEFAULT_PTR_COMPARE_FUNC);
+
+		for (i = 0; i < candidates.values_num; i++)
+		{
+			problem = (const zbx_pc_problem_t *)candidates.values[i];
+
+			if (SUCCEED != match_func(problem->tags, problem->tags_num, data))
+				continue;
+
+			pair.first = problem->eventid;
+			pair.second = problem->triggerid;
+			zbx_vector_uint64_pair_append(matches, pair);
+		}
+
+		zbx_vector_ptr_destroy(&candidates);
+	}
+
+	UNLOCK_CACHE;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: apply committed problem changes to cache                          *
+ *                                                                            *
+ * Parameters: problems   - [IN] the new trigger problem events               *
+ *             r_eventids - [IN] the recovered problem event identifiers      *
+ *                                                                            *
+ * Comments: Must be called only after the changes are committed to database. *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_problem_cache_update(const zbx_vector_db_event_t *problems, const zbx_vector_uint64_t *r_eventids)
+{
+	zbx_pc_problem_t	*problem;
+	int			i;
+
+	if (NULL == cache || (0 == problems->values_num && 0 == r_eventids->values_num))
+		return;
+
+	LOCK_CACHE;
+
+	if (ZBX_PC_STATE_READY != cache->state)
+		goto out;
+
+	for (i = 0; i < problems->values_num; i++)
+	{
+		const zbx_db_event	*event = problems->values[i];
+
+		if (SUCCEED != pc_add_problem(event->eventid, event->objectid, event->tags.values,
+				event->tags.values_num))
+		{
+			pc_disable();
+			goto out;
+		}
+	}
+
+	for (i = 0; i < r_eventids->values_num; i++)
+	{
+		if (NULL != (problem = (zbx_pc_problem_t *)zbx_hashset_search(&cache->problems,
+				&r_eventids->values[i])))
+		{
+			pc_remove_problem(problem);
+		}
+	}
+out:
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove deleted problems from cache                                *
+ *                                                                            *
+ * Parameters: eventids - [IN] the deleted problem event identifiers          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_problem_cache_remove(const zbx_vector_uint64_t *eventids)
+{
+	zbx_pc_problem_t	*problem;
+	int			i;
+
+	if (NULL == cache || 0 == eventids->values_num)
+		return;
+
+	LOCK_CACHE;
+
+	if (ZBX_PC_STATE_READY == cache->state)
+	{
+		for (i = 0; i < eventids->values_num; i++)
+		{
+			if (NULL != (problem = (zbx_pc_problem_t *)zbx_hashset_search(&cache->problems,
+					&eventids->values[i])))
+			{
+				pc_remove_problem(problem);
+			}
+		}
+	}
+
+	UNLOCK_CACHE;
+}
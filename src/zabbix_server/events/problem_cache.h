@@ -0,0 +1,51 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#ifndef ZABBIX_PROBLEM_CACHE_H
+#define ZABBIX_PROBLEM_CACHE_H
+
+#include "zbxdbhigh.h"
+#include "zbxalgo.h"
+
+/* problem event, used to cache open problems for recovery attempts */
+typedef struct
+{
+	zbx_uint64_t		eventid;
+	zbx_uint64_t		triggerid;
+
+	zbx_vector_tags_t	tags;
+}
+zbx_event_problem_t;
+
+/* returns SUCCEED if open problem with the specified tags matches the filter */
+typedef int	(*zbx_problem_cache_match_func_t)(const zbx_tag_t *tags, int tags_num, void *data);
+
+int	zbx_problem_cache_init(zbx_uint64_t cache_size, char **error);
+void	zbx_problem_cache_destroy(void);
+void	zbx_problem_cache_load(void);
+
+int	zbx_problem_cache_get_problems_num(int *problems_num);
+int	zbx_problem_cache_get_problems(const zbx_vector_uint64_t *triggerids, zbx_vector_ptr_t *problems);
+int	zbx_problem_cache_match(const zbx_vector_str_t *tags, zbx_problem_cache_match_func_t match_func, void *data,
+		zbx_vector_uint64_pair_t *matches);
+
+void	zbx_problem_cache_update(const zbx_vector_db_event_t *problems, const zbx_vector_uint64_t *r_eventids);
+void	zbx_problem_cache_remove(const zbx_vector_uint64_t *eventids);
+
+#endif
@@ -35,6 +35,7 @@
 #include "zbxdbhigh.h"
 #include "zbxipcservice.h"
 #include "zbxstr.h"
+#include "zbxtrends.h"
 
 #ifdef HAVE_POSTGRESQL
 #include "zbxjson.h"
@@ -692,6 +693,10 @@ static int	housekeeping_history_and_trends(int now)
 		if (ZBX_HK_MODE_PARTITION == *rule->poption_mode)
 		{
 			hk_drop_partition(rule->table, *rule->poption, now);
+
+			if (0 != zbx_trends_rollups_enabled() && 0 == strcmp(rule->history, "trends"))
+				deleted += zbx_trends_remove_rollups(rule->table, 0, now - *rule->poption);
+
 			goto skip;
 		}
 
@@ -741,6 +746,12 @@ process_delete_queue_for_housekeeping_rule:
 
 			if (ZBX_DB_OK < rc)
 				deleted += rc;
+
+			if (0 != zbx_trends_rollups_enabled() && 0 == strcmp(rule->history, "trends"))
+			{
+				deleted += zbx_trends_remove_rollups(rule->table, item_record->itemid,
+						item_record->min_clock);
+			}
 		}
 skip:
 		/* clear history rule delete queue so it's ready for the next housekeeping cycle */
@@ -1106,8 +1117,14 @@ static int	housekeeping_cleanup(int config_max_hk_delete)
 			}
 		}
 		else
+		{
 			deleted += hk_table_cleanup(row[1], row[2], objectid, config_max_hk_delete, &more);
 
+			/* rollups of deleted items are removed regardless of the rollups being currently enabled */
+			if (0 == more && (0 == strcmp(row[1], "trends") || 0 == strcmp(row[1], "trends_uint")))
+				deleted += zbx_trends_remove_rollups(row[1], objectid, 0);
+		}
+
 		if (0 == more)
 			zbx_vector_uint64_append(&housekeeperids, housekeeperid);
 	}
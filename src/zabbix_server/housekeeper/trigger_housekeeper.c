@@ -47,7 +47,7 @@ static void	housekeep_service_problems(const zbx_vector_uint64_t *eventids)
 	zbx_free(data);
 }
 
-static int	housekeep_problems_without_triggers(void)
+static int	housekeep_problems_without_triggers(zbx_remove_problems_func_t remove_problems_cb)
 {
 	zbx_db_result_t		result;
 	zbx_db_row_t		row;
@@ -104,8 +104,13 @@ static int	housekeep_problems_without_triggers(void)
 			zabbix_log(LOG_LEVEL_WARNING, "Failed to delete a problem without a trigger");
 		}
 		else
+		{
 			deleted = ids.values_num;
 
+			if (NULL != remove_problems_cb)
+				remove_problems_cb(&ids);
+		}
+
 		housekeep_service_problems(&ids);
 	}
 fail:
@@ -165,7 +170,7 @@ ZBX_THREAD_ENTRY(trigger_housekeeper_thread, args)
 		zbx_setproctitle("%s [removing deleted triggers problems]", get_process_type_string(process_type));
 
 		double	sec = zbx_time();
-		int	deleted = housekeep_problems_without_triggers();
+		int	deleted = housekeep_problems_without_triggers(trigger_housekeeper_args_in->remove_problems_cb);
 
 		zbx_setproctitle("%s [deleted %d problems records in " ZBX_FS_DBL " sec, idle for %d second(s)]",
 				get_process_type_string(process_type), deleted, zbx_time() - sec,
@@ -21,11 +21,15 @@
 #define ZABBIX_TRIGGER_HOUSEKEEPER_H
 
 #include "zbxthreads.h"
+#include "zbxalgo.h"
+
+typedef void	(*zbx_remove_problems_func_t)(const zbx_vector_uint64_t *eventids);
 
 typedef struct
 {
-	int	config_timeout;
-	int	config_problemhousekeeping_frequency;
+	int				config_timeout;
+	int				config_problemhousekeeping_frequency;
+	zbx_remove_problems_func_t	remove_problems_cb;
 }
 zbx_thread_server_trigger_housekeeper_args;
 
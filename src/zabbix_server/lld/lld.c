@@ -27,6 +27,7 @@
 #include "zbx_trigger_constants.h"
 #include "zbx_item_constants.h"
 #include "zbxvariant.h"
+#include "zbxtime.h"
 
 /* lld rule filter condition (item_condition table record) */
 typedef struct
@@ -963,14 +964,87 @@ int	lld_validate_item_override_no_discover(const zbx_vector_lld_override_t *over
 	return ZBX_PROTOTYPE_NO_DISCOVER == override_default ? FAIL : SUCCEED;
 }
 
+/* discovery data rows to be filtered by LLD worker threads */
+typedef struct
+{
+	const zbx_lld_filter_t			*filter;
+	const zbx_vector_lld_macro_path_t	*lld_macro_paths;
+	const zbx_vector_lld_override_t		*overrides;
+	const struct zbx_json_parse		*jp_rows;
+	zbx_lld_row_t				**lld_rows;	/* rows passing the filter, NULL for filtered */
+							/* out rows                                   */
+	char					**info;		/* filter warnings of each job part */
+}
+zbx_lld_rows_job_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates filter and overrides for discovery data row             *
+ *                                                                            *
+ * Parameters: jp_row          - [IN] lld data row                            *
+ *             filter          - [IN] lld rule filter                         *
+ *             lld_macro_paths - [IN] use json path to extract from jp_row    *
+ *             overrides       - [IN] lld rule overrides                      *
+ *             info            - [OUT] filter evaluation warnings             *
+ *                                                                            *
+ * Return value: lld row or NULL if row did not pass the filter               *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_lld_row_t	*lld_row_make(const struct zbx_json_parse *jp_row, const zbx_lld_filter_t *filter,
+		const zbx_vector_lld_macro_path_t *lld_macro_paths, const zbx_vector_lld_override_t *overrides,
+		char **info)
+{
+	zbx_lld_row_t	*lld_row;
+
+	if (SUCCEED != filter_evaluate(filter, jp_row, lld_macro_paths, info))
+		return NULL;
+
+	lld_row = (zbx_lld_row_t *)zbx_malloc(NULL, sizeof(zbx_lld_row_t));
+
+	lld_row->jp_row = *jp_row;
+	zbx_vector_lld_item_link_create(&lld_row->item_links);
+	zbx_vector_lld_override_create(&lld_row->overrides);
+
+#define OVERRIDE_STOP_TRUE	1
+
+	for (int i = 0; i < overrides->values_num; i++)
+	{
+		zbx_lld_override_t	*override = overrides->values[i];
+
+		if (SUCCEED != filter_evaluate(&override->filter, jp_row, lld_macro_paths, info))
+			continue;
+
+		zbx_vector_lld_override_append(&lld_row->overrides, override);
+
+		if (OVERRIDE_STOP_TRUE == override->stop)
+			break;
+	}
+
+#undef OVERRIDE_STOP_TRUE
+
+	return lld_row;
+}
+
+static void	lld_rows_filter(void *data, int part, int from, int to)
+{
+	zbx_lld_rows_job_t	*job = (zbx_lld_rows_job_t *)data;
+
+	for (int i = from; i < to; i++)
+	{
+		job->lld_rows[i] = lld_row_make(&job->jp_rows[i], job->filter, job->lld_macro_paths, job->overrides,
+				&job->info[part]);
+	}
+}
+
 static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_lld_row_t *lld_rows,
 		const zbx_vector_lld_macro_path_t *lld_macro_paths, const zbx_vector_lld_override_t *overrides,
 		char **info, char **error)
 {
-	struct zbx_json_parse	jp, jp_array, jp_row;
+	struct zbx_json_parse	jp, jp_array, *jp_rows = NULL;
 	const char		*p;
 	zbx_lld_row_t		*lld_row;
-	int			ret = FAIL, i;
+	int			ret = FAIL, i, rows_num = 0, rows_alloc = 0, parts_num;
+	zbx_lld_rows_job_t	job;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -994,37 +1068,48 @@ static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_
 	p = NULL;
 	while (NULL != (p = zbx_json_next(&jp_array, p)))
 	{
-		if (FAIL == zbx_json_brackets_open(p, &jp_row))
-			continue;
-
-		if (SUCCEED != filter_evaluate(filter, &jp_row, lld_macro_paths, info))
-			continue;
-
-		lld_row = (zbx_lld_row_t *)zbx_malloc(NULL, sizeof(zbx_lld_row_t));
-		zbx_vector_lld_row_append(lld_rows, lld_row);
+		if (rows_num == rows_alloc)
+		{
+			rows_alloc = (0 == rows_alloc ? 16 : rows_alloc * 2);
+			jp_rows = (struct zbx_json_parse *)zbx_realloc(jp_rows,
+					sizeof(struct zbx_json_parse) * (size_t)rows_alloc);
+		}
 
-		lld_row->jp_row = jp_row;
-		zbx_vector_lld_item_link_create(&lld_row->item_links);
-		zbx_vector_lld_override_create(&lld_row->overrides);
+		if (SUCCEED == zbx_json_brackets_open(p, &jp_rows[rows_num]))
+			rows_num++;
+	}
 
-#define OVERRIDE_STOP_TRUE	1
+	/* filters are evaluated by LLD worker threads, results are merged in the row order */
+	parts_num = lld_threads_parts(rows_num);
 
-		for (i = 0; i < overrides->values_num; i++)
-		{
-			zbx_lld_override_t	*override = overrides->values[i];
+	job.filter = filter;
+	job.lld_macro_paths = lld_macro_paths;
+	job.overrides = overrides;
+	job.jp_rows = jp_rows;
+	job.lld_rows = (zbx_lld_row_t **)zbx_malloc(NULL, sizeof(zbx_lld_row_t *) * (size_t)(rows_num + 1));
+	job.info = (char **)zbx_calloc(NULL, (size_t)parts_num, sizeof(char *));
 
-			if (SUCCEED != filter_evaluate(&override->filter, &jp_row, lld_macro_paths, info))
-				continue;
+	lld_threads_run(lld_rows_filter, &job, rows_num);
 
-			zbx_vector_lld_override_append(&lld_row->overrides, override);
+	for (i = 0; i < rows_num; i++)
+	{
+		if (NULL != job.lld_rows[i])
+			zbx_vector_lld_row_append(lld_rows, job.lld_rows[i]);
+	}
 
-			if (OVERRIDE_STOP_TRUE == override->stop)
-				break;
+	for (i = 0; i < parts_num; i++)
+	{
+		if (NULL != job.info[i])
+		{
+			*info = zbx_strdcat(*info, job.info[i]);
+			zbx_free(job.info[i]);
 		}
-
-#undef OVERRIDE_STOP_TRUE
 	}
 
+	zbx_free(job.info);
+	zbx_free(job.lld_rows);
+	zbx_free(jp_rows);
+
 	ret = SUCCEED;
 out:
 	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
@@ -1071,12 +1156,14 @@ static void	lld_row_free(zbx_lld_row_t *lld_row)
  *                                                                            *
  * Parameters: lld_ruleid - [IN] discovery item identifier from database      *
  *             value      - [IN] received value from agent                    *
+ *             times      - [IN/OUT] time spent in processing phases is added *
  *             error      - [OUT] error or informational message. Will be set *
  *                               to empty string on successful discovery      *
  *                               without additional information.              *
  *                                                                            *
  ******************************************************************************/
-int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char **error)
+int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, zbx_lld_phase_times_t *times,
+		char **error)
 {
 	zbx_db_result_t			result;
 	zbx_db_row_t			row;
@@ -1091,6 +1178,7 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	zbx_dc_um_handle_t		*um_handle;
 	zbx_vector_lld_override_t	overrides;
 	zbx_vector_lld_row_t		lld_rows;
+	double				time_start, time_end;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64, __func__, lld_ruleid);
 
@@ -1162,12 +1250,18 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 	if (SUCCEED != (ret = lld_overrides_load(&overrides, lld_ruleid, &item, error)))
 		goto out;
 
+	time_start = zbx_time();
+
 	if (SUCCEED != lld_rows_get(value, &filter, &lld_rows, &lld_macro_paths, &overrides, &info, error))
 	{
 		ret = FAIL;
 		goto out;
 	}
 
+	time_end = zbx_time();
+	times->filter += time_end - time_start;
+	time_start = time_end;
+
 	*error = zbx_strdup(*error, "");
 
 	now = time(NULL);
@@ -1184,6 +1278,10 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 
 	lld_item_links_sort(&lld_rows);
 
+	time_end = zbx_time();
+	times->items += time_end - time_start;
+	time_start = time_end;
+
 	if (SUCCEED != lld_update_triggers(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, error, lifetime, now))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add triggers because parent host was removed while"
@@ -1191,6 +1289,10 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 		goto out;
 	}
 
+	time_end = zbx_time();
+	times->triggers += time_end - time_start;
+	time_start = time_end;
+
 	if (SUCCEED != lld_update_graphs(hostid, lld_ruleid, &lld_rows, &lld_macro_paths, error, lifetime, now))
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "cannot update/add graphs because parent host was removed while"
@@ -1198,8 +1300,14 @@ int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char
 		goto out;
 	}
 
+	time_end = zbx_time();
+	times->graphs += time_end - time_start;
+	time_start = time_end;
+
 	lld_update_hosts(lld_ruleid, &lld_rows, &lld_macro_paths, error, lifetime, now);
 
+	times->hosts += zbx_time() - time_start;
+
 	/* add informative warning to the error message about lack of data for macros used in filter */
 	if (NULL != info)
 		*error = zbx_strdcat(*error, info);
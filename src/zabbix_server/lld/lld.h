@@ -24,6 +24,7 @@
 #include "zbxjson.h"
 #include "zbxdbhigh.h"
 #include "zbxcacheconfig.h"
+#include "lld_manager.h"
 
 typedef struct
 {
@@ -146,7 +147,6 @@ typedef struct
 	unsigned char		authtype;
 	unsigned char		allow_traps;
 	unsigned char		discover;
-	zbx_vector_lld_row_t	lld_rows;
 	zbx_vector_lld_item_preproc_t	preproc_ops;
 	zbx_vector_item_param_ptr_t	item_params;
 	zbx_vector_db_tag_ptr_t	item_tags;
@@ -325,6 +325,13 @@ typedef void	(*get_object_info_f)(const void *object, zbx_uint64_t *id, int *dis
 void	lld_remove_lost_objects(const char *table, const char *id_name, const zbx_vector_ptr_t *objects,
 		int lifetime, int lastcheck, delete_ids_f cb, get_object_info_f cb_info);
 
-int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, char **error);
+int	lld_process_discovery_rule(zbx_uint64_t lld_ruleid, const char *value, zbx_lld_phase_times_t *times,
+		char **error);
+
+typedef void	(*zbx_lld_job_func_t)(void *data, int part, int from, int to);
+
+void	lld_threads_init(int threads_num);
+int	lld_threads_parts(int num);
+void	lld_threads_run(zbx_lld_job_func_t func, void *data, int num);
 
 #endif
@@ -180,8 +180,6 @@ static void	lld_item_prototype_free(zbx_lld_item_prototype_t *item_prototype)
 	zbx_free(item_prototype->ssl_key_file);
 	zbx_free(item_prototype->ssl_key_password);
 
-	zbx_vector_lld_row_destroy(&item_prototype->lld_rows);
-
 	zbx_vector_lld_item_preproc_clear_ext(&item_prototype->preproc_ops, lld_item_preproc_free);
 	zbx_vector_lld_item_preproc_destroy(&item_prototype->preproc_ops);
 
@@ -2323,113 +2321,363 @@ static void	lld_item_update(const zbx_lld_item_prototype_t *item_prototype, cons
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
+/* item keys made from the key prototype of existing items for every lld row */
+typedef struct
+{
+	zbx_uint64_t	parent_itemid;
+	const char	*key_proto;
+	int		prototype_index;
+	char		**keys;		/* item key for every lld row, NULL if key cannot be made */
+	int		*next;		/* previous lld row with the same item key or -1 */
+	zbx_hashset_t	keys_index;	/* last lld row with the item key */
+}
+zbx_lld_item_keys_t;
+
+/* lld row by item key, the key must be the first member for lld_items_keys_* functions */
+typedef struct
+{
+	const char	*key;
+	int		row;
+}
+zbx_lld_item_key_row_t;
+
+static zbx_hash_t	lld_item_keys_hash_func(const void *data)
+{
+	const zbx_lld_item_keys_t	*keys = (const zbx_lld_item_keys_t *)data;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_ALGO(&keys->parent_itemid, sizeof(keys->parent_itemid), ZBX_DEFAULT_HASH_SEED);
+	return ZBX_DEFAULT_STRING_HASH_ALGO(keys->key_proto, strlen(keys->key_proto), hash);
+}
+
+static int	lld_item_keys_compare_func(const void *d1, const void *d2)
+{
+	const zbx_lld_item_keys_t	*k1 = (const zbx_lld_item_keys_t *)d1;
+	const zbx_lld_item_keys_t	*k2 = (const zbx_lld_item_keys_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(k1->parent_itemid, k2->parent_itemid);
+
+	return strcmp(k1->key_proto, k2->key_proto);
+}
+
+/* item keys to be made by LLD worker threads */
+typedef struct
+{
+	const zbx_vector_lld_macro_path_t	*lld_macro_paths;
+	const zbx_vector_lld_row_t		*lld_rows;
+	zbx_vector_ptr_t			keys;
+}
+zbx_lld_item_keys_job_t;
+
+static void	lld_item_keys_make(void *data, int part, int from, int to)
+{
+	zbx_lld_item_keys_job_t	*job = (zbx_lld_item_keys_job_t *)data;
+	int			rows_num = job->lld_rows->values_num;
+
+	ZBX_UNUSED(part);
+
+	for (int i = from; i < to; i++)
+	{
+		zbx_lld_item_keys_t	*keys = (zbx_lld_item_keys_t *)job->keys.values[i / rows_num];
+		int			row = i % rows_num;
+		char			*key;
+
+		key = zbx_strdup(NULL, keys->key_proto);
+
+		if (SUCCEED != zbx_substitute_key_macros(&key, NULL, NULL, &job->lld_rows->values[row]->jp_row,
+				job->lld_macro_paths, ZBX_MACRO_TYPE_ITEM_KEY, NULL, 0))
+		{
+			zbx_free(key);
+		}
+
+		keys->keys[row] = key;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
- * Purpose: updates existing items and creates new ones based on item,        *
- *          item prototypes and lld data                                      *
+ * Purpose: finds lld rows the existing items were discovered from            *
  *                                                                            *
  * Parameters: item_prototypes - [IN]                                         *
  *             lld_rows        - [IN] lld data rows                           *
  *             lld_macro_paths - [IN] use json path to extract from jp_row    *
- *             items           - [IN/OUT] sorted list of items                *
+ *             items           - [IN] sorted list of existing items           *
  *             items_index     - [OUT] index of items based on prototype ids  *
- *                                     and lld rows. Used to quckly find an   *
- *                                     item by prototype and lld_row.         *
- *             error           - [OUT] error message                          *
+ *                                     and lld rows                           *
+ *                                                                            *
+ * Comments: Item keys are made once for every key prototype and lld row and  *
+ *           indexed, so existing items are matched without substituting      *
+ *           macros for every item and lld row pair.                          *
  *                                                                            *
  ******************************************************************************/
-static void	lld_items_make(const zbx_vector_ptr_t *item_prototypes, zbx_vector_lld_row_t *lld_rows,
-		const zbx_vector_lld_macro_path_t *lld_macro_paths, zbx_vector_lld_item_full_t *items,
-		zbx_hashset_t *items_index, char **error)
+static void	lld_items_match(const zbx_vector_ptr_t *item_prototypes, const zbx_vector_lld_row_t *lld_rows,
+		const zbx_vector_lld_macro_path_t *lld_macro_paths, const zbx_vector_lld_item_full_t *items,
+		zbx_hashset_t *items_index)
 {
-	int				i, j, index;
-	zbx_lld_item_prototype_t	*item_prototype;
-	zbx_lld_item_full_t		*item;
-	zbx_lld_row_t			*lld_row;
-	zbx_lld_item_index_t		*item_index, item_index_local;
-	char				*buffer = NULL;
+	int				i, rows_num = lld_rows->values_num;
+	zbx_hashset_t			keys_set;
+	zbx_hashset_iter_t		iter;
+	zbx_lld_item_keys_t		*keys, keys_local;
+	zbx_lld_item_keys_job_t		job;
+	zbx_lld_item_index_t		item_index_local;
+	unsigned char			*matched;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	if (0 == items->values_num || 0 == rows_num)
+		return;
 
-	/* create the items index */
-	for (i = 0; i < item_prototypes->values_num; i++)
-	{
-		item_prototype = (zbx_lld_item_prototype_t *)item_prototypes->values[i];
+	zbx_hashset_create(&keys_set, (size_t)item_prototypes->values_num, lld_item_keys_hash_func,
+			lld_item_keys_compare_func);
 
-		for (j = 0; j < lld_rows->values_num; j++)
-			zbx_vector_lld_row_append(&item_prototype->lld_rows, lld_rows->values[j]);
-	}
+	job.lld_macro_paths = lld_macro_paths;
+	job.lld_rows = lld_rows;
+	zbx_vector_ptr_create(&job.keys);
 
-	/* Iterate in reverse order because usually the items are created in the same order as     */
-	/* incoming lld rows. Iterating in reverse optimizes lld_row removal from item prototypes. */
-	for (i = items->values_num - 1; i >= 0; i--)
+	for (i = 0; i < items->values_num; i++)
 	{
-		item = items->values[i];
+		zbx_lld_item_full_t	*item = items->values[i];
 
-		if (FAIL == (index = zbx_vector_ptr_bsearch(item_prototypes, &item->parent_itemid,
-				ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
+		keys_local.parent_itemid = item->parent_itemid;
+		keys_local.key_proto = item->key_proto;
+
+		if (NULL != zbx_hashset_search(&keys_set, &keys_local))
+			continue;
+
+		if (FAIL == (keys_local.prototype_index = zbx_vector_ptr_bsearch(item_prototypes,
+				&item->parent_itemid, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC)))
 		{
 			THIS_SHOULD_NEVER_HAPPEN;
 			continue;
 		}
 
-		item_prototype = (zbx_lld_item_prototype_t *)item_prototypes->values[index];
+		keys = (zbx_lld_item_keys_t *)zbx_hashset_insert(&keys_set, &keys_local, sizeof(keys_local));
+		keys->keys = (char **)zbx_malloc(NULL, sizeof(char *) * (size_t)rows_num);
+		keys->next = (int *)zbx_malloc(NULL, sizeof(int) * (size_t)rows_num);
+		zbx_hashset_create(&keys->keys_index, (size_t)rows_num, lld_items_keys_hash_func,
+				lld_items_keys_compare_func);
+
+		zbx_vector_ptr_append(&job.keys, keys);
+	}
 
-		for (j = item_prototype->lld_rows.values_num - 1; j >= 0; j--)
+	/* item keys are made by LLD worker threads */
+	lld_threads_run(lld_item_keys_make, &job, job.keys.values_num * rows_num);
+
+	for (i = 0; i < job.keys.values_num; i++)
+	{
+		keys = (zbx_lld_item_keys_t *)job.keys.values[i];
+
+		for (int j = 0; j < rows_num; j++)
 		{
-			lld_row = item_prototype->lld_rows.values[j];
+			zbx_lld_item_key_row_t	*key_row, key_row_local;
 
-			buffer = zbx_strdup(buffer, item->key_proto);
+			if (NULL == keys->keys[j])
+				continue;
 
-			if (SUCCEED != zbx_substitute_key_macros(&buffer, NULL, NULL, &lld_row->jp_row, lld_macro_paths,
-					ZBX_MACRO_TYPE_ITEM_KEY, NULL, 0))
-			{
+			key_row_local.key = keys->keys[j];
+			key_row_local.row = -1;
+
+			key_row = (zbx_lld_item_key_row_t *)zbx_hashset_insert(&keys->keys_index, &key_row_local,
+					sizeof(key_row_local));
+
+			keys->next[j] = key_row->row;
+			key_row->row = j;
+		}
+	}
+
+	matched = (unsigned char *)zbx_calloc(NULL, (size_t)item_prototypes->values_num * (size_t)rows_num,
+			sizeof(unsigned char));
+
+	/* Iterate in reverse order because usually the items are created in the same order as incoming lld */
+	/* rows. Rows with duplicate keys are matched starting with the last one.                           */
+	for (i = items->values_num - 1; i >= 0; i--)
+	{
+		zbx_lld_item_full_t		*item = items->values[i];
+		zbx_lld_item_prototype_t	*item_prototype;
+		zbx_lld_item_key_row_t		*key_row;
+		unsigned char			*prototype_matched;
+
+		keys_local.parent_itemid = item->parent_itemid;
+		keys_local.key_proto = item->key_proto;
+
+		if (NULL == (keys = (zbx_lld_item_keys_t *)zbx_hashset_search(&keys_set, &keys_local)))
+			continue;
+
+		if (NULL == (key_row = (zbx_lld_item_key_row_t *)zbx_hashset_search(&keys->keys_index, &item->key)))
+			continue;
+
+		item_prototype = (zbx_lld_item_prototype_t *)item_prototypes->values[keys->prototype_index];
+		prototype_matched = matched + (size_t)keys->prototype_index * (size_t)rows_num;
+
+		for (int j = key_row->row; -1 != j; j = keys->next[j])
+		{
+			zbx_lld_row_t	*lld_row = lld_rows->values[j];
+
+			if (0 != prototype_matched[j])
 				continue;
-			}
 
-			if (0 == strcmp(item->key, buffer) &&
-					SUCCEED == lld_validate_item_override_no_discover(&lld_row->overrides,
-					item->name, item_prototype->discover))
+			if (SUCCEED == lld_validate_item_override_no_discover(&lld_row->overrides, item->name,
+					item_prototype->discover))
 			{
 				item_index_local.parent_itemid = item->parent_itemid;
 				item_index_local.lld_row = lld_row;
 				item_index_local.item = item;
 				zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
 
-				zbx_vector_lld_row_remove_noorder(&item_prototype->lld_rows, j);
+				prototype_matched[j] = 1;
 				break;
 			}
 		}
 	}
 
-	zbx_free(buffer);
+	zbx_free(matched);
+
+	zbx_hashset_iter_reset(&keys_set, &iter);
+	while (NULL != (keys = (zbx_lld_item_keys_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_hashset_destroy(&keys->keys_index);
+
+		for (i = 0; i < rows_num; i++)
+			zbx_free(keys->keys[i]);
+
+		zbx_free(keys->keys);
+		zbx_free(keys->next);
+	}
+
+	zbx_vector_ptr_destroy(&job.keys);
+	zbx_hashset_destroy(&keys_set);
+}
+
+/* item to be created or updated from item prototype and lld row */
+typedef struct
+{
+	const zbx_lld_item_prototype_t	*item_prototype;
+	zbx_lld_row_t			*lld_row;
+	zbx_lld_item_full_t		*item;		/* existing item or created item */
+	int				created;
+}
+zbx_lld_item_task_t;
+
+/* items to be created or updated by LLD worker threads */
+typedef struct
+{
+	const zbx_vector_lld_macro_path_t	*lld_macro_paths;
+	zbx_lld_item_task_t			*tasks;
+	char					**errors;	/* error messages of each job part */
+}
+zbx_lld_items_job_t;
+
+static void	lld_items_make_part(void *data, int part, int from, int to)
+{
+	zbx_lld_items_job_t	*job = (zbx_lld_items_job_t *)data;
+
+	for (int i = from; i < to; i++)
+	{
+		zbx_lld_item_task_t	*task = &job->tasks[i];
+
+		if (NULL == task->item)
+		{
+			task->item = lld_item_make(task->item_prototype, task->lld_row, job->lld_macro_paths,
+					&job->errors[part]);
+			task->created = 1;
+		}
+		else
+		{
+			lld_item_update(task->item_prototype, task->lld_row, job->lld_macro_paths, task->item,
+					&job->errors[part]);
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates existing items and creates new ones based on item,        *
+ *          item prototypes and lld data                                      *
+ *                                                                            *
+ * Parameters: item_prototypes - [IN]                                         *
+ *             lld_rows        - [IN] lld data rows                           *
+ *             lld_macro_paths - [IN] use json path to extract from jp_row    *
+ *             items           - [IN/OUT] sorted list of items                *
+ *             items_index     - [OUT] index of items based on prototype ids  *
+ *                                     and lld rows. Used to quckly find an   *
+ *                                     item by prototype and lld_row.         *
+ *             error           - [OUT] error message                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_items_make(const zbx_vector_ptr_t *item_prototypes, zbx_vector_lld_row_t *lld_rows,
+		const zbx_vector_lld_macro_path_t *lld_macro_paths, zbx_vector_lld_item_full_t *items,
+		zbx_hashset_t *items_index, char **error)
+{
+	int			i, j, tasks_num, parts_num;
+	zbx_lld_item_index_t	*item_index, item_index_local;
+	zbx_lld_items_job_t	job;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	lld_items_match(item_prototypes, lld_rows, lld_macro_paths, items, items_index);
 
 	/* update/create discovered items */
-	for (i = 0; i < item_prototypes->values_num; i++)
+	tasks_num = item_prototypes->values_num * lld_rows->values_num;
+	parts_num = lld_threads_parts(tasks_num);
+
+	job.lld_macro_paths = lld_macro_paths;
+	job.tasks = (zbx_lld_item_task_t *)zbx_malloc(NULL, sizeof(zbx_lld_item_task_t) * (size_t)(tasks_num + 1));
+	job.errors = (char **)zbx_calloc(NULL, (size_t)parts_num, sizeof(char *));
+
+	for (i = 0, tasks_num = 0; i < item_prototypes->values_num; i++)
 	{
-		item_prototype = (zbx_lld_item_prototype_t *)item_prototypes->values[i];
+		zbx_lld_item_prototype_t	*item_prototype = (zbx_lld_item_prototype_t *)item_prototypes->values[i];
+
 		item_index_local.parent_itemid = item_prototype->itemid;
 
 		for (j = 0; j < lld_rows->values_num; j++)
 		{
+			zbx_lld_item_task_t	*task = &job.tasks[tasks_num++];
+
 			item_index_local.lld_row = lld_rows->values[j];
 
-			if (NULL == (item_index = (zbx_lld_item_index_t *)zbx_hashset_search(items_index,
+			task->item_prototype = item_prototype;
+			task->lld_row = lld_rows->values[j];
+			task->created = 0;
+
+			if (NULL != (item_index = (zbx_lld_item_index_t *)zbx_hashset_search(items_index,
 					&item_index_local)))
 			{
-				item = lld_item_make(item_prototype, item_index_local.lld_row, lld_macro_paths, error);
-
-				/* add the created item to items vector and update index */
-				zbx_vector_lld_item_full_append(items, item);
-				item_index_local.item = item;
-				zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
+				task->item = item_index->item;
 			}
 			else
-				lld_item_update(item_prototype, item_index_local.lld_row, lld_macro_paths,
-						item_index->item, error);
+				task->item = NULL;
 		}
 	}
 
+	lld_threads_run(lld_items_make_part, &job, tasks_num);
+
+	/* add the created items to items vector and update index in the same order as they were made */
+	for (i = 0; i < tasks_num; i++)
+	{
+		zbx_lld_item_task_t	*task = &job.tasks[i];
+
+		if (0 == task->created)
+			continue;
+
+		zbx_vector_lld_item_full_append(items, task->item);
+
+		item_index_local.parent_itemid = task->item_prototype->itemid;
+		item_index_local.lld_row = task->lld_row;
+		item_index_local.item = task->item;
+		zbx_hashset_insert(items_index, &item_index_local, sizeof(item_index_local));
+	}
+
+	for (i = 0; i < parts_num; i++)
+	{
+		if (NULL != job.errors[i])
+		{
+			*error = zbx_strdcat(*error, job.errors[i]);
+			zbx_free(job.errors[i]);
+		}
+	}
+
+	zbx_free(job.errors);
+	zbx_free(job.tasks);
+
 	zbx_vector_lld_item_full_sort(items, ZBX_DEFAULT_UINT64_PTR_COMPARE_FUNC);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%d items", __func__, items->values_num);
@@ -4219,7 +4467,6 @@ static void	lld_item_prototypes_get(zbx_uint64_t lld_ruleid, zbx_vector_ptr_t *i
 		ZBX_STR2UCHAR(item_prototype->allow_traps, row[43]);
 		ZBX_STR2UCHAR(item_prototype->discover, row[44]);
 
-		zbx_vector_lld_row_create(&item_prototype->lld_rows);
 		zbx_vector_lld_item_preproc_create(&item_prototype->preproc_ops);
 		zbx_vector_item_param_ptr_create(&item_prototype->item_params);
 		zbx_vector_db_tag_ptr_create(&item_prototype->item_tags);
@@ -66,6 +66,8 @@ typedef struct
 	/* the number of queued LLD rules */
 	zbx_uint64_t		queued_num;
 
+	/* time spent by workers in discovery rule processing phases */
+	zbx_lld_phase_times_t	times;
 }
 zbx_lld_manager_t;
 
@@ -181,6 +183,7 @@ static void	lld_manager_init(zbx_lld_manager_t *manager, zbx_get_config_forks_f
 	}
 
 	manager->queued_num = 0;
+	memset(&manager->times, 0, sizeof(manager->times));
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -401,16 +404,27 @@ static void	lld_process_queue(zbx_lld_manager_t *manager)
  *                                                                            *
  * Parameters: manager - [IN]                                                 *
  * Parameters: client  - [IN] worker's IPC client connection                  *
+ *             message - [IN] worker's response with processing phase times   *
  *                                                                            *
  ******************************************************************************/
-static void	lld_process_result(zbx_lld_manager_t *manager, zbx_ipc_client_t *client)
+static void	lld_process_result(zbx_lld_manager_t *manager, zbx_ipc_client_t *client,
+		const zbx_ipc_message_t *message)
 {
 	zbx_lld_worker_t	*worker;
 	zbx_lld_rule_t		*rule;
 	zbx_lld_data_t		*data;
+	zbx_lld_phase_times_t	times;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
+	zbx_lld_deserialize_phase_times(message->data, &times);
+
+	manager->times.filter += times.filter;
+	manager->times.items += times.items;
+	manager->times.triggers += times.triggers;
+	manager->times.graphs += times.graphs;
+	manager->times.hosts += times.hosts;
+
 	worker = lld_get_worker_by_client(manager, client);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "discovery rule:" ZBX_FS_UI64 " has been processed", worker->rule->head->itemid);
@@ -455,7 +469,8 @@ static void	lld_process_diag_stats(zbx_lld_manager_t *manager, zbx_ipc_client_t
 	unsigned char	*data;
 	zbx_uint32_t	data_len;
 
-	data_len = zbx_lld_serialize_diag_stats(&data, manager->rule_index.num_data, manager->queued_num);
+	data_len = zbx_lld_serialize_diag_stats(&data, manager->rule_index.num_data, manager->queued_num,
+			&manager->times);
 	zbx_ipc_client_send(client, ZBX_IPC_LLD_DIAG_STATS_RESULT, data, data_len);
 	zbx_free(data);
 }
@@ -622,7 +637,7 @@ ZBX_THREAD_ENTRY(lld_manager_thread, args)
 					lld_process_queue(&manager);
 					break;
 				case ZBX_IPC_LLD_DONE:
-					lld_process_result(&manager, client);
+					lld_process_result(&manager, client, message);
 					processed_num++;
 					manager.queued_num--;
 					break;
@@ -67,6 +67,17 @@ typedef struct
 }
 zbx_lld_rule_info_t;
 
+/* time spent in discovery rule processing phases */
+typedef struct
+{
+	double	filter;		/* discovery data parsing, filter and override evaluation */
+	double	items;
+	double	triggers;
+	double	graphs;
+	double	hosts;
+}
+zbx_lld_phase_times_t;
+
 typedef struct
 {
 	zbx_get_config_forks_f	get_process_forks_cb_arg;
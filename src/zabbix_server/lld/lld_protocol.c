@@ -80,28 +80,76 @@ void	zbx_lld_deserialize_item_value(const unsigned char *data, zbx_uint64_t *ite
 	}
 }
 
-zbx_uint32_t	zbx_lld_serialize_diag_stats(unsigned char **data, zbx_uint64_t items_num, zbx_uint64_t values_num)
+static zbx_uint32_t	lld_phase_times_prepare(const zbx_lld_phase_times_t *times)
+{
+	zbx_uint32_t	data_len = 0;
+
+	zbx_serialize_prepare_value(data_len, times->filter);
+	zbx_serialize_prepare_value(data_len, times->items);
+	zbx_serialize_prepare_value(data_len, times->triggers);
+	zbx_serialize_prepare_value(data_len, times->graphs);
+	zbx_serialize_prepare_value(data_len, times->hosts);
+
+	return data_len;
+}
+
+static unsigned char	*lld_phase_times_serialize(unsigned char *ptr, const zbx_lld_phase_times_t *times)
+{
+	ptr += zbx_serialize_value(ptr, times->filter);
+	ptr += zbx_serialize_value(ptr, times->items);
+	ptr += zbx_serialize_value(ptr, times->triggers);
+	ptr += zbx_serialize_value(ptr, times->graphs);
+	ptr += zbx_serialize_value(ptr, times->hosts);
+
+	return ptr;
+}
+
+void	zbx_lld_deserialize_phase_times(const unsigned char *data, zbx_lld_phase_times_t *times)
+{
+	data += zbx_deserialize_value(data, &times->filter);
+	data += zbx_deserialize_value(data, &times->items);
+	data += zbx_deserialize_value(data, &times->triggers);
+	data += zbx_deserialize_value(data, &times->graphs);
+	(void)zbx_deserialize_value(data, &times->hosts);
+}
+
+zbx_uint32_t	zbx_lld_serialize_phase_times(unsigned char **data, const zbx_lld_phase_times_t *times)
+{
+	zbx_uint32_t	data_len;
+
+	data_len = lld_phase_times_prepare(times);
+	*data = (unsigned char *)zbx_malloc(NULL, data_len);
+	(void)lld_phase_times_serialize(*data, times);
+
+	return data_len;
+}
+
+zbx_uint32_t	zbx_lld_serialize_diag_stats(unsigned char **data, zbx_uint64_t items_num, zbx_uint64_t values_num,
+		const zbx_lld_phase_times_t *times)
 {
 	unsigned char	*ptr;
 	zbx_uint32_t	data_len = 0;
 
 	zbx_serialize_prepare_value(data_len, items_num);
 	zbx_serialize_prepare_value(data_len, values_num);
+	data_len += lld_phase_times_prepare(times);
 
 	*data = (unsigned char *)zbx_malloc(NULL, data_len);
 
 	ptr = *data;
 	ptr += zbx_serialize_value(ptr, items_num);
-	(void)zbx_serialize_value(ptr, values_num);
+	ptr += zbx_serialize_value(ptr, values_num);
+	(void)lld_phase_times_serialize(ptr, times);
 
 	return data_len;
 }
 
 static void	zbx_lld_deserialize_diag_stats(const unsigned char *data, zbx_uint64_t *items_num,
-		zbx_uint64_t *values_num)
+		zbx_uint64_t *values_num, zbx_lld_phase_times_t *times)
 {
 	data += zbx_deserialize_value(data, items_num);
-	(void)zbx_deserialize_value(data, values_num);
+	data += zbx_deserialize_value(data, values_num);
+	zbx_lld_deserialize_phase_times(data, times);
 }
 
 static zbx_uint32_t	zbx_lld_serialize_top_items_request(unsigned char **data, int limit)
@@ -296,7 +344,8 @@ out:
  * Purpose: get lld manager diagnostic statistics                             *
  *                                                                            *
  ******************************************************************************/
-int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, char **error)
+int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, zbx_lld_phase_times_t *times,
+		char **error)
 {
 	unsigned char	*result;
 
@@ -306,7 +355,7 @@ int	zbx_lld_get_diag_stats(zbx_uint64_t *items_num, zbx_uint64_t *values_num, ch
 		return FAIL;
 	}
 
-	zbx_lld_deserialize_diag_stats(result, items_num, values_num);
+	zbx_lld_deserialize_diag_stats(result, items_num, values_num, times);
 	zbx_free(result);
 
 	return SUCCEED;
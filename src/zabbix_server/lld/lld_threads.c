@@ -0,0 +1,127 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "lld.h"
+
+#include "zbxthreads.h"
+#include "zbxregexp.h"
+
+#ifdef HAVE_LIBXML2
+#	include <libxml/parser.h>
+#endif
+
+#define LLD_THREADS_JOB_MIN	16	/* minimum number of job items processed by one thread */
+
+/* job started by LLD worker, split into parts processed by pool threads */
+typedef struct
+{
+	zbx_lld_job_func_t	func;
+	void			*data;
+	int			num;
+	int			parts_num;
+}
+zbx_lld_job_t;
+
+static zbx_thread_pool_t	pool = {.threads_num = 1};
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes the job part assigned to the thread                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	lld_threads_process(void *data, int part)
+{
+	zbx_lld_job_t	*job = (zbx_lld_job_t *)data;
+	int		from, to;
+
+	if (part >= job->parts_num)
+		return;
+
+	from = (int)((zbx_int64_t)job->num * part / job->parts_num);
+	to = (int)((zbx_int64_t)job->num * (part + 1) / job->parts_num);
+
+	job->func(job->data, part, from, to);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts threads for parallel processing of discovery rule data     *
+ *                                                                            *
+ * Parameters: threads_num - [IN] number of threads, including the main       *
+ *                                thread                                      *
+ *                                                                            *
+ ******************************************************************************/
+void	lld_threads_init(int threads_num)
+{
+#ifdef HAVE_LIBXML2
+	/* XML macros can be substituted by several threads */
+	if (1 != threads_num)
+		xmlInitParser();
+#endif
+	zbx_thread_pool_init(&pool, "LLD worker", threads_num, zbx_init_regexp_env);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns number of parts the job of specified size will be split   *
+ *          into                                                              *
+ *                                                                            *
+ * Parameters: num - [IN] number of job items                                 *
+ *                                                                            *
+ * Return value: The number of parts, callers use it to allocate per part     *
+ *               output.                                                      *
+ *                                                                            *
+ ******************************************************************************/
+int	lld_threads_parts(int num)
+{
+	int	parts_num;
+
+	if (pool.threads_num < (parts_num = num / LLD_THREADS_JOB_MIN))
+		parts_num = pool.threads_num;
+
+	return 0 == parts_num ? 1 : parts_num;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: processes job items in parallel                                   *
+ *                                                                            *
+ * Parameters: func - [IN] job callback, called for every part of the job     *
+ *                         with the part index and job item range             *
+ *             data - [IN] job data                                           *
+ *             num  - [IN] number of job items                                *
+ *                                                                            *
+ * Comments: Job items are split into lld_threads_parts(num) consecutive      *
+ *           ranges. The callback must not change data shared with other      *
+ *           parts, part index can be used to store results that are merged   *
+ *           in part order after this function returns.                       *
+ *                                                                            *
+ ******************************************************************************/
+void	lld_threads_run(zbx_lld_job_func_t func, void *data, int num)
+{
+	zbx_lld_job_t	job = {.func = func, .data = data, .num = num, .parts_num = lld_threads_parts(num)};
+
+	if (1 == job.parts_num)
+	{
+		func(data, 0, 0, num);
+		return;
+	}
+
+	zbx_thread_pool_run(&pool, lld_threads_process, &job);
+}
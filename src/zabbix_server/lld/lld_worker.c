@@ -54,9 +54,10 @@ static void	lld_register_worker(zbx_ipc_socket_t *socket)
  *          cache and database                                                *
  *                                                                            *
  * Parameters: message - [IN] message with LLD request                        *
+ *             times   - [OUT] time spent in discovery rule processing phases *
  *                                                                            *
  ******************************************************************************/
-static void	lld_process_task(zbx_ipc_message_t *message)
+static void	lld_process_task(zbx_ipc_message_t *message, zbx_lld_phase_times_t *times)
 {
 	zbx_uint64_t		itemid, hostid, lastlogsize;
 	char			*value, *error;
@@ -68,6 +69,8 @@ static void	lld_process_task(zbx_ipc_message_t *message)
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
+	memset(times, 0, sizeof(zbx_lld_phase_times_t));
+
 	zbx_lld_deserialize_item_value(message->data, &itemid, &hostid, &value, &ts, &meta, &lastlogsize, &mtime,
 			&error);
 
@@ -82,7 +85,7 @@ static void	lld_process_task(zbx_ipc_message_t *message)
 
 	if (NULL != error || NULL != value)
 	{
-		if (NULL == error && SUCCEED == lld_process_discovery_rule(itemid, value, &error))
+		if (NULL == error && SUCCEED == lld_process_discovery_rule(itemid, value, times, &error))
 			state = ITEM_STATE_NORMAL;
 		else
 			state = ITEM_STATE_NOTSUPPORTED;
@@ -169,15 +172,20 @@ out:
 
 ZBX_THREAD_ENTRY(lld_worker_thread, args)
 {
-	char			*error = NULL;
-	zbx_ipc_socket_t	lld_socket;
-	zbx_ipc_message_t	message;
-	double			time_stat, time_idle = 0, time_now, time_read;
-	zbx_uint64_t		processed_num = 0;
-	zbx_thread_info_t	*info = &((zbx_thread_args_t *)args)->info;
-	int			server_num = ((zbx_thread_args_t *)args)->info.server_num;
-	int			process_num = ((zbx_thread_args_t *)args)->info.process_num;
-	unsigned char		process_type = ((zbx_thread_args_t *)args)->info.process_type;
+	char				*error = NULL;
+	unsigned char			*data;
+	zbx_uint32_t			data_len;
+	zbx_ipc_socket_t		lld_socket;
+	zbx_ipc_message_t		message;
+	zbx_lld_phase_times_t		times;
+	double				time_stat, time_idle = 0, time_now, time_read;
+	zbx_uint64_t			processed_num = 0;
+	zbx_thread_info_t		*info = &((zbx_thread_args_t *)args)->info;
+	int				server_num = ((zbx_thread_args_t *)args)->info.server_num;
+	int				process_num = ((zbx_thread_args_t *)args)->info.process_num;
+	unsigned char			process_type = ((zbx_thread_args_t *)args)->info.process_type;
+	zbx_thread_lld_worker_args	*lld_worker_args_in = (zbx_thread_lld_worker_args *)
+							(((zbx_thread_args_t *)args)->args);
 
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
@@ -199,6 +207,8 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+	lld_threads_init(lld_worker_args_in->config_lld_worker_threads);
+
 	zbx_setproctitle("%s #%d started", get_process_type_string(process_type), process_num);
 
 	zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
@@ -234,8 +244,10 @@ ZBX_THREAD_ENTRY(lld_worker_thread, args)
 		switch (message.code)
 		{
 			case ZBX_IPC_LLD_TASK:
-				lld_process_task(&message);
-				zbx_ipc_socket_write(&lld_socket, ZBX_IPC_LLD_DONE, NULL, 0);
+				lld_process_task(&message, &times);
+				data_len = zbx_lld_serialize_phase_times(&data, &times);
+				zbx_ipc_socket_write(&lld_socket, ZBX_IPC_LLD_DONE, data, data_len);
+				zbx_free(data);
 				processed_num++;
 				break;
 		}
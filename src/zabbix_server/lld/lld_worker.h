@@ -22,6 +22,12 @@
 
 #include "zbxthreads.h"
 
+typedef struct
+{
+	int	config_lld_worker_threads;
+}
+zbx_thread_lld_worker_args;
+
 ZBX_THREAD_ENTRY(lld_worker_thread, args);
 
 #endif
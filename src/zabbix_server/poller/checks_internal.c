@@ -667,6 +667,8 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(ZBX_STATS_HISTORY_FREE));
 			else if (0 == strcmp(tmp1, "pused"))
 				SET_DBL_RESULT(result, *(double *)zbx_dc_get_stats(ZBX_STATS_HISTORY_PUSED));
+			else if (0 == strcmp(tmp1, "hugepages"))
+				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(ZBX_STATS_HISTORY_HUGE_PAGES));
 			else
 			{
 				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
@@ -691,6 +693,8 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(ZBX_STATS_TREND_FREE));
 			else if (0 == strcmp(tmp1, "pused"))
 				SET_DBL_RESULT(result, *(double *)zbx_dc_get_stats(ZBX_STATS_TREND_PUSED));
+			else if (0 == strcmp(tmp1, "hugepages"))
+				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(ZBX_STATS_TREND_HUGE_PAGES));
 			else
 			{
 				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
@@ -709,6 +713,11 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(ZBX_STATS_HISTORY_INDEX_FREE));
 			else if (0 == strcmp(tmp1, "pused"))
 				SET_DBL_RESULT(result, *(double *)zbx_dc_get_stats(ZBX_STATS_HISTORY_INDEX_PUSED));
+			else if (0 == strcmp(tmp1, "hugepages"))
+			{
+				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_get_stats(
+						ZBX_STATS_HISTORY_INDEX_HUGE_PAGES));
+			}
 			else
 			{
 				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
@@ -744,6 +753,11 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_config_get_stats(ZBX_CONFSTATS_BUFFER_FREE));
 			else if (0 == strcmp(tmp1, "pused"))
 				SET_DBL_RESULT(result, *(double *)zbx_dc_config_get_stats(ZBX_CONFSTATS_BUFFER_PUSED));
+			else if (0 == strcmp(tmp1, "hugepages"))
+			{
+				SET_UI64_RESULT(result, *(zbx_uint64_t *)zbx_dc_config_get_stats(
+						ZBX_CONFSTATS_BUFFER_HUGE_PAGES));
+			}
 			else
 			{
 				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
@@ -929,6 +943,46 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 
 		SET_UI64_RESULT(result, zbx_preprocessor_get_queue_size());
 	}
+	else if (0 == strcmp(tmp, "latency"))			/* zabbix[latency,<stage>,<mode>] */
+	{
+		int			stage;
+		zbx_latency_stats_t	stats;
+
+		if (2 > nparams || 3 < nparams)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		if (SUCCEED != zbx_latency_get_stage(get_rparam(&request, 1), &stage))
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
+			goto out;
+		}
+
+		tmp1 = get_rparam(&request, 2);
+		zbx_latency_get_stats(stage, &stats);
+
+		if (NULL == tmp1 || '\0' == *tmp1 || 0 == strcmp(tmp1, "avg"))
+			SET_DBL_RESULT(result, stats.avg);
+		else if (0 == strcmp(tmp1, "count"))
+			SET_UI64_RESULT(result, stats.count);
+		else if (0 == strcmp(tmp1, "max"))
+			SET_DBL_RESULT(result, stats.max);
+		else if (0 == strcmp(tmp1, "p50"))
+			SET_DBL_RESULT(result, stats.p50);
+		else if (0 == strcmp(tmp1, "p90"))
+			SET_DBL_RESULT(result, stats.p90);
+		else if (0 == strcmp(tmp1, "p95"))
+			SET_DBL_RESULT(result, stats.p95);
+		else if (0 == strcmp(tmp1, "p99"))
+			SET_DBL_RESULT(result, stats.p99);
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
+			goto out;
+		}
+	}
 	else if (0 == strcmp(tmp, "discovery_queue"))			/* zabbix[discovery_queue] */
 	{
 		zbx_uint64_t	size;
@@ -25,6 +25,7 @@
 #include "zbxconnector.h"
 #include "../ha/ha.h"
 #include "zbxproxybuffer.h"
+#include "zbxself.h"
 
 #include "checks_internal.h"
 #include "../lld/lld_protocol.h"
@@ -135,6 +136,36 @@ int	zbx_get_value_internal_ext(const char *param1, const AGENT_REQUEST *request,
 			SET_UI64_RESULT(result, value);
 		}
 	}
+	else if (0 == strcmp(param1, "calc_cache"))		/* zabbix[calc_cache,<parameter>] */
+	{
+		zbx_calc_cache_stats_t	stats;
+
+		if (2 != nparams)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		param2 = get_rparam(request, 1);
+		zbx_calc_cache_get_stats(&stats);
+
+		if (0 == strcmp(param2, "hits"))
+			SET_UI64_RESULT(result, stats.hits);
+		else if (0 == strcmp(param2, "misses"))
+			SET_UI64_RESULT(result, stats.misses);
+		else if (0 == strcmp(param2, "requests"))
+			SET_UI64_RESULT(result, stats.hits + stats.misses);
+		else if (0 == strcmp(param2, "phits"))
+		{
+			SET_DBL_RESULT(result, 0 == stats.hits + stats.misses ? 0 :
+					(double)stats.hits / (stats.hits + stats.misses) * 100);
+		}
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
+			goto out;
+		}
+	}
 	else if (0 == strcmp(param1, "vcache"))
 	{
 		const char	*param3;
@@ -170,6 +201,8 @@ int	zbx_get_value_internal_ext(const char *param1, const AGENT_REQUEST *request,
 			else if (0 == strcmp(param3, "pused"))
 				SET_DBL_RESULT(result, (double)(stats.total_size - stats.free_size) /
 						stats.total_size * 100);
+			else if (0 == strcmp(param3, "hugepages"))
+				SET_UI64_RESULT(result, stats.huge_pages);
 			else
 			{
 				SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
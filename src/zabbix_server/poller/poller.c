@@ -897,8 +897,21 @@ static int	get_values(unsigned char poller_type, int *nextcheck, const zbx_confi
 	zbx_vector_ptr_create(&add_results);
 
 	zbx_prepare_items(items, errcodes, num, results, ZBX_MACRO_EXPAND_YES);
+
+	/* share identical aggregate queries between calculated items of the batch */
+	if (ZBX_POLLER_TYPE_HISTORY == poller_type)
+		zbx_expression_memo_open();
+
 	zbx_check_items(items, errcodes, num, results, &add_results, poller_type, config_comms, config_startup_time);
 
+	if (ZBX_POLLER_TYPE_HISTORY == poller_type)
+	{
+		zbx_uint64_t	hits, misses;
+
+		zbx_expression_memo_close(&hits, &misses);
+		zbx_calc_cache_update(hits, misses);
+	}
+
 	zbx_timespec(&timespec);
 
 	/* process item values */
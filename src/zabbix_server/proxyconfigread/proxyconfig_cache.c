@@ -0,0 +1,370 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "proxyconfig_read.h"
+
+#include "zbxalgo.h"
+#include "zbxmutexs.h"
+#include "zbxshmem.h"
+
+/* snapshots older than this are discarded to pick up changes not tracked by */
+/* configuration revisions (for example secret macro values from vault)      */
+#define ZBX_PCC_SNAPSHOT_TTL	(10 * SEC_PER_MIN)
+
+/* serialized and compressed configuration update from one configuration revision */
+/* to another for the specified set of configuration objects, shared by all       */
+/* proxies requesting the same update                                             */
+typedef struct
+{
+	zbx_uint64_t			from_revision;
+	zbx_uint64_t			to_revision;
+	zbx_uint64_t			*objects;
+	int				objects_num;
+	zbx_dc_item_type_timeouts_t	timeouts;
+	char				*data;
+	size_t				data_size;
+	size_t				reserved;
+	time_t				timestamp;
+}
+zbx_pcc_snapshot_t;
+
+static zbx_hashset_t	*cache = NULL;
+
+static zbx_shmem_info_t	*pcc_mem = NULL;
+
+static zbx_mutex_t	pcc_lock = ZBX_MUTEX_NULL;
+
+ZBX_SHMEM_FUNC_IMPL(__pcc, pcc_mem)
+
+#define LOCK_CACHE	zbx_mutex_lock(pcc_lock)
+#define UNLOCK_CACHE	zbx_mutex_unlock(pcc_lock)
+
+static zbx_hash_t	pcc_snapshot_hash(const void *data)
+{
+	const zbx_pcc_snapshot_t	*snapshot = (const zbx_pcc_snapshot_t *)data;
+	zbx_hash_t			hash;
+
+	hash = ZBX_DEFAULT_UINT64_HASH_FUNC(&snapshot->from_revision);
+	hash = ZBX_DEFAULT_UINT64_HASH_ALGO(&snapshot->to_revision, sizeof(snapshot->to_revision), hash);
+
+	return ZBX_DEFAULT_HASH_ALGO(snapshot->objects, sizeof(zbx_uint64_t) * (size_t)snapshot->objects_num, hash);
+}
+
+static int	pcc_snapshot_compare(const void *d1, const void *d2)
+{
+	const zbx_pcc_snapshot_t	*s1 = (const zbx_pcc_snapshot_t *)d1;
+	const zbx_pcc_snapshot_t	*s2 = (const zbx_pcc_snapshot_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s1->from_revision, s2->from_revision);
+	ZBX_RETURN_IF_NOT_EQUAL(s1->to_revision, s2->to_revision);
+	ZBX_RETURN_IF_NOT_EQUAL(s1->objects_num, s2->objects_num);
+
+	if (0 != memcmp(s1->objects, s2->objects, sizeof(zbx_uint64_t) * (size_t)s1->objects_num))
+		return 1;
+
+	return memcmp(&s1->timeouts, &s2->timeouts, sizeof(s1->timeouts));
+}
+
+static void	pcc_snapshot_free(zbx_pcc_snapshot_t *snapshot)
+{
+	__pcc_shmem_free_func(snapshot->data);
+	__pcc_shmem_free_func(snapshot->objects);
+	zbx_hashset_remove_direct(cache, snapshot);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepare snapshot search key                                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	pcc_snapshot_init_key(zbx_pcc_snapshot_t *snapshot, zbx_uint64_t from_revision,
+		zbx_uint64_t to_revision, const zbx_vector_uint64_t *objects,
+		const zbx_dc_item_type_timeouts_t *timeouts)
+{
+	memset(snapshot, 0, sizeof(zbx_pcc_snapshot_t));
+
+	snapshot->from_revision = from_revision;
+	snapshot->to_revision = to_revision;
+	snapshot->objects = objects->values;
+	snapshot->objects_num = objects->values_num;
+	snapshot->timeouts = *timeouts;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove snapshots that cannot be requested anymore                 *
+ *                                                                            *
+ * Parameters: to_revision - [IN] the current configuration cache revision    *
+ *             now         - [IN] the current time                            *
+ *                                                                            *
+ * Comments: Configuration cache revision only increases, so snapshots built  *
+ *           for older revisions will not be requested again.                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	pcc_remove_outdated(zbx_uint64_t to_revision, time_t now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_pcc_snapshot_t	*snapshot;
+
+	zbx_hashset_iter_reset(cache, &iter);
+	while (NULL != (snapshot = (zbx_pcc_snapshot_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (snapshot->to_revision < to_revision || now - snapshot->timestamp >= ZBX_PCC_SNAPSHOT_TTL)
+		{
+			__pcc_shmem_free_func(snapshot->data);
+			__pcc_shmem_free_func(snapshot->objects);
+			zbx_hashset_iter_remove(&iter);
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free the oldest snapshot except the specified one                 *
+ *                                                                            *
+ * Parameters: keep - [IN] the snapshot to keep                               *
+ *                                                                            *
+ * Return value: SUCCEED - a snapshot was freed                               *
+ *               FAIL    - there are no other snapshots to free               *
+ *                                                                            *
+ ******************************************************************************/
+static int	pcc_evict_oldest(const zbx_pcc_snapshot_t *keep)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_pcc_snapshot_t	*snapshot, *oldest = NULL;
+
+	zbx_hashset_iter_reset(cache, &iter);
+	while (NULL != (snapshot = (zbx_pcc_snapshot_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (snapshot == keep)
+			continue;
+
+		if (NULL == oldest || snapshot->timestamp < oldest->timestamp)
+			oldest = snapshot;
+	}
+
+	if (NULL == oldest)
+		return FAIL;
+
+	pcc_snapshot_free(oldest);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocate memory in snapshot cache, evicting old snapshots if      *
+ *          necessary                                                         *
+ *                                                                            *
+ * Parameters: keep - [IN] the snapshot to keep                               *
+ *             size - [IN] the number of bytes to allocate                    *
+ *                                                                            *
+ * Return value: the allocated memory or NULL if there was not enough space   *
+ *                                                                            *
+ ******************************************************************************/
+static void	*pcc_malloc(const zbx_pcc_snapshot_t *keep, size_t size)
+{
+	void	*ptr;
+
+	while (NULL == (ptr = __pcc_shmem_malloc_func(NULL, size)))
+	{
+		if (SUCCEED != pcc_evict_oldest(keep))
+			break;
+	}
+
+	return ptr;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize proxy configuration snapshot cache                     *
+ *                                                                            *
+ * Parameters: cache_size - [IN] the cache size in bytes, 0 disables cache    *
+ *             error      - [OUT] the error message                           *
+ *                                                                            *
+ * Return value: SUCCEED - the cache was initialized successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_pcc_init(zbx_uint64_t cache_size, char **error)
+{
+	int	ret = FAIL;
+
+	if (0 == cache_size)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s(): proxy configuration cache disabled", __func__);
+		return SUCCEED;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	if (SUCCEED != zbx_mutex_create(&pcc_lock, ZBX_MUTEX_PROXY_CONFIG, error))
+		goto out;
+
+	if (SUCCEED != zbx_shmem_create(&pcc_mem, cache_size, "proxy configuration cache size",
+			"ProxyConfigCacheSize", 1, error))
+	{
+		goto out;
+	}
+
+	cache = (zbx_hashset_t *)__pcc_shmem_malloc_func(NULL, sizeof(zbx_hashset_t));
+
+	zbx_hashset_create_ext(cache, 0, pcc_snapshot_hash, pcc_snapshot_compare, NULL,
+			 __pcc_shmem_malloc_func, __pcc_shmem_realloc_func, __pcc_shmem_free_func);
+
+	ret = SUCCEED;
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s(): %s", __func__, ZBX_NULL2EMPTY_STR(*error));
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: destroy proxy configuration snapshot cache                        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_pcc_destroy(void)
+{
+	if (NULL != pcc_mem)
+	{
+		zbx_shmem_destroy(pcc_mem);
+		pcc_mem = NULL;
+		cache = NULL;
+		zbx_mutex_destroy(&pcc_lock);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compressed proxy configuration from snapshot cache            *
+ *                                                                            *
+ * Parameters: from_revision - [IN] the configuration revision on proxy       *
+ *             to_revision   - [IN] the current configuration cache revision  *
+ *             objects       - [IN] the configuration objects to be synced    *
+ *             timeouts      - [IN] the item type timeouts of proxy           *
+ *             data          - [OUT] the compressed configuration data        *
+ *             data_size     - [OUT] the compressed data size                 *
+ *             reserved      - [OUT] the uncompressed data size               *
+ *                                                                            *
+ * Return value: SUCCEED - matching snapshot was found, the returned data     *
+ *                         must be freed by the caller                        *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_pcc_get(zbx_uint64_t from_revision, zbx_uint64_t to_revision, const zbx_vector_uint64_t *objects,
+		const zbx_dc_item_type_timeouts_t *timeouts, char **data, size_t *data_size, size_t *reserved)
+{
+	zbx_pcc_snapshot_t	*snapshot, snapshot_local;
+	int			ret = FAIL;
+
+	if (NULL == cache)
+		return FAIL;
+
+	pcc_snapshot_init_key(&snapshot_local, from_revision, to_revision, objects, timeouts);
+
+	LOCK_CACHE;
+
+	if (NULL != (snapshot = (zbx_pcc_snapshot_t *)zbx_hashset_search(cache, &snapshot_local)) &&
+			time(NULL) - snapshot->timestamp < ZBX_PCC_SNAPSHOT_TTL)
+	{
+		*data = (char *)zbx_malloc(NULL, snapshot->data_size);
+		memcpy(*data, snapshot->data, snapshot->data_size);
+		*data_size = snapshot->data_size;
+		*reserved = snapshot->reserved;
+
+		ret = SUCCEED;
+	}
+
+	UNLOCK_CACHE;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: store compressed proxy configuration in snapshot cache            *
+ *                                                                            *
+ * Parameters: from_revision - [IN] the configuration revision on proxy       *
+ *             to_revision   - [IN] the current configuration cache revision  *
+ *             objects       - [IN] the configuration objects to be synced    *
+ *             timeouts      - [IN] the item type timeouts of proxy           *
+ *             data          - [IN] the compressed configuration data         *
+ *             data_size     - [IN] the compressed data size                  *
+ *             reserved      - [IN] the uncompressed data size                *
+ *                                                                            *
+ * Comments: Snapshots are shared by proxies requesting the same objects      *
+ *           between the same revisions. Snapshots built for older            *
+ *           configuration cache revisions are dropped. When cache runs out   *
+ *           of memory the oldest snapshots are dropped.                      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_pcc_put(zbx_uint64_t from_revision, zbx_uint64_t to_revision, const zbx_vector_uint64_t *objects,
+		const zbx_dc_item_type_timeouts_t *timeouts, const char *data, size_t data_size, size_t reserved)
+{
+	zbx_pcc_snapshot_t	*snapshot, snapshot_local;
+	zbx_uint64_t		*objects_copy;
+	size_t			objects_size;
+	time_t			now;
+
+	objects_size = sizeof(zbx_uint64_t) * (size_t)objects->values_num;
+
+	if (NULL == cache || data_size + objects_size > pcc_mem->total_size / 2)
+		return;
+
+	pcc_snapshot_init_key(&snapshot_local, from_revision, to_revision, objects, timeouts);
+	now = time(NULL);
+
+	LOCK_CACHE;
+
+	pcc_remove_outdated(to_revision, now);
+
+	/* snapshot could have been stored by another process building the same update */
+	if (NULL != zbx_hashset_search(cache, &snapshot_local))
+		goto out;
+
+	if (NULL == (snapshot = (zbx_pcc_snapshot_t *)zbx_hashset_insert(cache, &snapshot_local,
+			sizeof(snapshot_local))))
+	{
+		goto out;
+	}
+
+	/* the inserted key references local objects until they are copied into shared memory */
+	if (NULL == (objects_copy = (zbx_uint64_t *)pcc_malloc(snapshot, objects_size)))
+	{
+		zbx_hashset_remove_direct(cache, snapshot);
+		goto out;
+	}
+
+	if (NULL == (snapshot->data = (char *)pcc_malloc(snapshot, data_size)))
+	{
+		__pcc_shmem_free_func(objects_copy);
+		zbx_hashset_remove_direct(cache, snapshot);
+		goto out;
+	}
+
+	memcpy(objects_copy, objects->values, objects_size);
+	snapshot->objects = objects_copy;
+	memcpy(snapshot->data, data, data_size);
+	snapshot->data_size = data_size;
+	snapshot->reserved = reserved;
+	snapshot->timestamp = now;
+out:
+	UNLOCK_CACHE;
+}
@@ -345,16 +345,16 @@ out:
 	return ret;
 }
 
-static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct zbx_json *j, char **error)
+static int	proxyconfig_get_config_table_data(const zbx_dc_item_type_timeouts_t *timeouts, struct zbx_json *j,
+		char **error)
 {
-	zbx_db_result_t			result;
-	zbx_db_row_t			row;
-	const zbx_db_table_t		*table;
-	char				*sql = NULL;
-	size_t				sql_alloc =  4 * ZBX_KIBIBYTE, sql_offset = 0;
-	int				ret = FAIL, i, fld = 0;
-	const char			*alias = "t.", *alias_from = " t";
-	zbx_dc_item_type_timeouts_t	timeouts;
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	const zbx_db_table_t	*table;
+	char			*sql = NULL;
+	size_t			sql_alloc =  4 * ZBX_KIBIBYTE, sql_offset = 0;
+	int			ret = FAIL, i, fld = 0;
+	const char		*alias = "t.", *alias_from = " t";
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -374,8 +374,6 @@ static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct
 		goto out;
 	}
 
-	zbx_dc_get_proxy_timeouts(proxy->proxyid, &timeouts);
-
 	if (NULL != (row = zbx_db_fetch(result)))
 	{
 		zbx_json_addarray(j, NULL);
@@ -389,46 +387,45 @@ static int	proxyconfig_get_config_table_data(const zbx_dc_proxy_t *proxy, struct
 
 			if (0 == strncmp(table->fields[i].name, "timeout_", ZBX_CONST_STRLEN("timeout_")))
 			{
-				char		*timeout_value;
-				const char	*item_type;
+				const char	*timeout_value, *item_type;
 
 				item_type = table->fields[i].name + ZBX_CONST_STRLEN("timeout_");
 
 				if (0 == strcmp(item_type, "zabbix_agent"))
 				{
-					timeout_value = timeouts.agent;
+					timeout_value = timeouts->agent;
 				}
 				else if (0 == strcmp(item_type, "simple_check"))
 				{
-					timeout_value = timeouts.simple;
+					timeout_value = timeouts->simple;
 				}
 				else if (0 == strcmp(item_type, "snmp_agent"))
 				{
-					timeout_value = timeouts.snmp;
+					timeout_value = timeouts->snmp;
 				}
 				else if (0 == strcmp(item_type, "external_check"))
 				{
-					timeout_value = timeouts.external;
+					timeout_value = timeouts->external;
 				}
 				else if (0 == strcmp(item_type, "db_monitor"))
 				{
-					timeout_value = timeouts.odbc;
+					timeout_value = timeouts->odbc;
 				}
 				else if (0 == strcmp(item_type, "ssh_agent"))
 				{
-					timeout_value = timeouts.ssh;
+					timeout_value = timeouts->ssh;
 				}
 				else if (0 == strcmp(item_type, "http_agent"))
 				{
-					timeout_value = timeouts.http;
+					timeout_value = timeouts->http;
 				}
 				else if (0 == strcmp(item_type, "telnet_agent"))
 				{
-					timeout_value = timeouts.telnet;
+					timeout_value = timeouts->telnet;
 				}
 				else if (0 == strcmp(item_type, "script"))
 				{
-					timeout_value = timeouts.script;
+					timeout_value = timeouts->script;
 				}
 				else
 				{
@@ -1026,10 +1023,6 @@ out:
 	return ret;
 }
 
-static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_config_revision,
-		const zbx_dc_revision_t *dc_revision, struct zbx_json *j, zbx_proxyconfig_status_t *status,
-		const zbx_config_vault_t *config_vault, const char *config_source_ip, char **error)
-{
 #define ZBX_PROXYCONFIG_SYNC_HOSTS		0x0001
 #define ZBX_PROXYCONFIG_SYNC_GMACROS		0x0002
 #define ZBX_PROXYCONFIG_SYNC_HMACROS		0x0004
@@ -1044,64 +1037,160 @@ static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t prox
 					ZBX_PROXYCONFIG_SYNC_EXPRESSIONS | ZBX_PROXYCONFIG_SYNC_CONFIG | 	\
 					ZBX_PROXYCONFIG_SYNC_HTTPTESTS | ZBX_PROXYCONFIG_SYNC_AUTOREG)
 
-	zbx_vector_uint64_t	hostids, httptestids, updated_hostids, removed_hostids, del_macro_hostids,
-				macro_hostids;
-	zbx_vector_ptr_t	keys_paths;
-	int			global_macros = FAIL, ret = FAIL, i;
-	zbx_uint64_t		flags = 0;
+/* configuration objects to be synced to proxy, resolved from configuration cache */
+typedef struct
+{
+	zbx_uint64_t			flags;
+	zbx_vector_uint64_t		updated_hostids;
+	zbx_vector_uint64_t		removed_hostids;
+	zbx_vector_uint64_t		httptestids;
+	zbx_vector_uint64_t		macro_hostids;
+	zbx_vector_uint64_t		del_macro_hostids;
+	zbx_dc_item_type_timeouts_t	timeouts;
+}
+zbx_proxyconfig_objects_t;
+
+static void	proxyconfig_objects_init(zbx_proxyconfig_objects_t *objects)
+{
+	objects->flags = 0;
+
+	zbx_vector_uint64_create(&objects->updated_hostids);
+	zbx_vector_uint64_create(&objects->removed_hostids);
+	zbx_vector_uint64_create(&objects->httptestids);
+	zbx_vector_uint64_create(&objects->macro_hostids);
+	zbx_vector_uint64_create(&objects->del_macro_hostids);
+
+	/* timeouts are compared as binary data when looking up cached configuration */
+	memset(&objects->timeouts, 0, sizeof(objects->timeouts));
+}
+
+static void	proxyconfig_objects_clear(zbx_proxyconfig_objects_t *objects)
+{
+	zbx_vector_uint64_destroy(&objects->del_macro_hostids);
+	zbx_vector_uint64_destroy(&objects->macro_hostids);
+	zbx_vector_uint64_destroy(&objects->httptestids);
+	zbx_vector_uint64_destroy(&objects->removed_hostids);
+	zbx_vector_uint64_destroy(&objects->updated_hostids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get configuration objects to be synced to proxy from              *
+ *          configuration cache                                               *
+ *                                                                            *
+ * Parameters: proxy                 - [IN] the target proxy                  *
+ *             proxy_config_revision - [IN] the configuration revision on     *
+ *                                          proxy, 0 for full sync            *
+ *             dc_revision           - [IN] the configuration cache revision  *
+ *             objects               - [OUT] the objects to sync              *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxyconfig_get_objects(const zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_config_revision,
+		const zbx_dc_revision_t *dc_revision, zbx_proxyconfig_objects_t *objects)
+{
+	zbx_vector_uint64_t	hostids;
+	int			global_macros = FAIL;
 
 	zbx_vector_uint64_create(&hostids);
-	zbx_vector_uint64_create(&updated_hostids);
-	zbx_vector_uint64_create(&removed_hostids);
-	zbx_vector_uint64_create(&httptestids);
-	zbx_vector_uint64_create(&macro_hostids);
-	zbx_vector_uint64_create(&del_macro_hostids);
-	zbx_vector_ptr_create(&keys_paths);
 
 	if (proxy_config_revision < proxy->revision || proxy_config_revision < proxy->macro_revision)
 	{
 		zbx_vector_uint64_reserve(&hostids, 1000);
-		zbx_vector_uint64_reserve(&updated_hostids, 1000);
-		zbx_vector_uint64_reserve(&removed_hostids, 100);
-		zbx_vector_uint64_reserve(&httptestids, 100);
-		zbx_vector_uint64_reserve(&macro_hostids, 1000);
-		zbx_vector_uint64_reserve(&del_macro_hostids, 100);
-
-		zbx_dc_get_proxy_config_updates(proxy->proxyid, proxy_config_revision, &hostids, &updated_hostids,
-				&removed_hostids, &httptestids);
-
-		zbx_dc_get_macro_updates(&hostids, &updated_hostids, proxy_config_revision, &macro_hostids,
-				&global_macros, &del_macro_hostids);
+		zbx_vector_uint64_reserve(&objects->updated_hostids, 1000);
+		zbx_vector_uint64_reserve(&objects->removed_hostids, 100);
+		zbx_vector_uint64_reserve(&objects->httptestids, 100);
+		zbx_vector_uint64_reserve(&objects->macro_hostids, 1000);
+		zbx_vector_uint64_reserve(&objects->del_macro_hostids, 100);
+
+		zbx_dc_get_proxy_config_updates(proxy->proxyid, proxy_config_revision, &hostids,
+				&objects->updated_hostids, &objects->removed_hostids, &objects->httptestids);
+
+		zbx_dc_get_macro_updates(&hostids, &objects->updated_hostids, proxy_config_revision,
+				&objects->macro_hostids, &global_macros, &objects->del_macro_hostids);
+
+		/* keep identifiers ordered so that the same object set always has the same key */
+		zbx_vector_uint64_sort(&objects->updated_hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_sort(&objects->removed_hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_sort(&objects->httptestids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_sort(&objects->macro_hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_sort(&objects->del_macro_hostids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 	}
 
 	if (0 != proxy_config_revision)
 	{
-		if (0 != updated_hostids.values_num)
-			flags |= ZBX_PROXYCONFIG_SYNC_HOSTS;
+		if (0 != objects->updated_hostids.values_num)
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_HOSTS;
 
 		if (SUCCEED == global_macros)
-			flags |= ZBX_PROXYCONFIG_SYNC_GMACROS;
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_GMACROS;
 
-		if(0 != macro_hostids.values_num)
-			flags |= ZBX_PROXYCONFIG_SYNC_HMACROS;
+		if(0 != objects->macro_hostids.values_num)
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_HMACROS;
 
 		if (proxy_config_revision < proxy->revision)
-			flags |= ZBX_PROXYCONFIG_SYNC_DRULES;
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_DRULES;
 
 		if (proxy_config_revision < dc_revision->expression)
-			flags |= ZBX_PROXYCONFIG_SYNC_EXPRESSIONS;
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_EXPRESSIONS;
 
 		/* force config table sync because of possible proxy timeout changes overriding global timeouts */
-		flags |= ZBX_PROXYCONFIG_SYNC_CONFIG;
+		objects->flags |= ZBX_PROXYCONFIG_SYNC_CONFIG;
 
-		if (0 != httptestids.values_num)
-			flags |= ZBX_PROXYCONFIG_SYNC_HTTPTESTS;
+		if (0 != objects->httptestids.values_num)
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_HTTPTESTS;
 
 		if (proxy_config_revision < dc_revision->autoreg_tls)
-			flags |= ZBX_PROXYCONFIG_SYNC_AUTOREG;
+			objects->flags |= ZBX_PROXYCONFIG_SYNC_AUTOREG;
 	}
 	else
-		flags = ZBX_PROXYCONFIG_SYNC_ALL;
+		objects->flags = ZBX_PROXYCONFIG_SYNC_ALL;
+
+	zbx_dc_get_proxy_timeouts(proxy->proxyid, &objects->timeouts);
+
+	zbx_vector_uint64_destroy(&hostids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: serialize configuration objects into configuration update         *
+ *          cache key                                                         *
+ *                                                                            *
+ * Parameters: proxy   - [IN] the target proxy                                *
+ *             objects - [IN] the objects to sync                             *
+ *             key     - [OUT] the cache key                                  *
+ *                                                                            *
+ * Comments: Only discovery rules are selected by proxy, so proxy identifier  *
+ *           is part of the key only when they must be synced. Otherwise the  *
+ *           same update is shared by all proxies with the same object set.   *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxyconfig_objects_serialize(const zbx_dc_proxy_t *proxy, const zbx_proxyconfig_objects_t *objects,
+		zbx_vector_uint64_t *key)
+{
+	const zbx_vector_uint64_t	*ids[] = {&objects->updated_hostids, &objects->removed_hostids,
+							&objects->httptestids, &objects->macro_hostids,
+							&objects->del_macro_hostids};
+	size_t				i;
+
+	zbx_vector_uint64_append(key, objects->flags);
+	zbx_vector_uint64_append(key, 0 != (objects->flags & ZBX_PROXYCONFIG_SYNC_DRULES) ? proxy->proxyid : 0);
+
+	for (i = 0; i < ARRSIZE(ids); i++)
+	{
+		zbx_vector_uint64_append(key, (zbx_uint64_t)ids[i]->values_num);
+		zbx_vector_uint64_append_array(key, ids[i]->values, ids[i]->values_num);
+	}
+}
+
+static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, const zbx_proxyconfig_objects_t *objects,
+		struct zbx_json *j, zbx_proxyconfig_status_t *status, const zbx_config_vault_t *config_vault,
+		const char *config_source_ip, char **error)
+{
+	zbx_vector_ptr_t	keys_paths;
+	int			ret = FAIL, i;
+	zbx_uint64_t		flags = objects->flags;
+
+	zbx_vector_ptr_create(&keys_paths);
 
 	zbx_json_addobject(j, ZBX_PROTO_TAG_DATA);
 
@@ -1110,7 +1199,7 @@ static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t prox
 		zbx_db_begin();
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HOSTS) &&
-				SUCCEED != proxyconfig_get_host_data(&updated_hostids, j, error))
+				SUCCEED != proxyconfig_get_host_data(&objects->updated_hostids, j, error))
 		{
 			goto out;
 		}
@@ -1124,14 +1213,14 @@ static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t prox
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HMACROS))
 		{
-			if (SUCCEED != proxyconfig_get_table_data("hosts_templates", "hostid", &macro_hostids, NULL,
-					NULL, j, error))
+			if (SUCCEED != proxyconfig_get_table_data("hosts_templates", "hostid", &objects->macro_hostids,
+					NULL, NULL, j, error))
 			{
 				goto out;
 			}
 
-			if (SUCCEED != proxyconfig_get_macro_updates("hostmacro", &macro_hostids, config_vault->db_path,
-					&keys_paths, j, error))
+			if (SUCCEED != proxyconfig_get_macro_updates("hostmacro", &objects->macro_hostids,
+					config_vault->db_path, &keys_paths, j, error))
 			{
 				goto out;
 			}
@@ -1150,13 +1239,13 @@ static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t prox
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_CONFIG) &&
-				SUCCEED != proxyconfig_get_config_table_data(proxy, j, error))
+				SUCCEED != proxyconfig_get_config_table_data(&objects->timeouts, j, error))
 		{
 			goto out;
 		}
 
 		if (0 != (flags & ZBX_PROXYCONFIG_SYNC_HTTPTESTS) &&
-				SUCCEED != proxyconfig_get_httptest_data(&httptestids, j, error))
+				SUCCEED != proxyconfig_get_httptest_data(&objects->httptestids, j, error))
 		{
 			goto out;
 		}
@@ -1171,22 +1260,22 @@ static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t prox
 
 	zbx_json_close(j);
 
-	if (0 != removed_hostids.values_num)
+	if (0 != objects->removed_hostids.values_num)
 	{
 		zbx_json_addarray(j, ZBX_PROTO_TAG_REMOVED_HOSTIDS);
 
-		for (i = 0; i < removed_hostids.values_num; i++)
-			zbx_json_adduint64(j, NULL, removed_hostids.values[i]);
+		for (i = 0; i < objects->removed_hostids.values_num; i++)
+			zbx_json_adduint64(j, NULL, objects->removed_hostids.values[i]);
 
 		zbx_json_close(j);
 	}
 
-	if (0 != del_macro_hostids.values_num)
+	if (0 != objects->del_macro_hostids.values_num)
 	{
 		zbx_json_addarray(j, ZBX_PROTO_TAG_REMOVED_MACRO_HOSTIDS);
 
-		for (i = 0; i < del_macro_hostids.values_num; i++)
-			zbx_json_adduint64(j, NULL, del_macro_hostids.values[i]);
+		for (i = 0; i < objects->del_macro_hostids.values_num; i++)
+			zbx_json_adduint64(j, NULL, objects->del_macro_hostids.values[i]);
 
 		zbx_json_close(j);
 	}
@@ -1194,7 +1283,7 @@ static int	proxyconfig_get_tables(const zbx_dc_proxy_t *proxy, zbx_uint64_t prox
 	if (0 != keys_paths.values_num)
 		get_macro_secrets(&keys_paths, j, config_vault, config_source_ip);
 
-	if (0 == flags && 0 == removed_hostids.values_num && 0 == del_macro_hostids.values_num)
+	if (0 == flags && 0 == objects->removed_hostids.values_num && 0 == objects->del_macro_hostids.values_num)
 		*status = ZBX_PROXYCONFIG_STATUS_EMPTY;
 	else
 		*status = ZBX_PROXYCONFIG_STATUS_DATA;
@@ -1206,89 +1295,177 @@ out:
 
 	zbx_vector_ptr_clear_ext(&keys_paths, key_path_free);
 	zbx_vector_ptr_destroy(&keys_paths);
-	zbx_vector_uint64_destroy(&httptestids);
-	zbx_vector_uint64_destroy(&macro_hostids);
-	zbx_vector_uint64_destroy(&del_macro_hostids);
-	zbx_vector_uint64_destroy(&removed_hostids);
-	zbx_vector_uint64_destroy(&updated_hostids);
-	zbx_vector_uint64_destroy(&hostids);
 
 	return ret;
-
-#undef ZBX_PROXYCONFIG_SYNC_HOSTS
-#undef ZBX_PROXYCONFIG_SYNC_GMACROS
-#undef ZBX_PROXYCONFIG_SYNC_HMACROS
-#undef ZBX_PROXYCONFIG_SYNC_DRULES
-#undef ZBX_PROXYCONFIG_SYNC_EXPRESSIONS
-#undef ZBX_PROXYCONFIG_SYNC_CONFIG
-#undef ZBX_PROXYCONFIG_SYNC_HTTPTESTS
-#undef ZBX_PROXYCONFIG_SYNC_AUTOREG
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: prepare proxy configuration data                                  *
+ * Purpose: get proxy configuration revision from request and register        *
+ *          configuration session                                             *
+ *                                                                            *
+ * Parameters: proxy                 - [IN] the proxy                         *
+ *             jp_request            - [IN] the configuration request         *
+ *             proxy_config_revision - [OUT] the proxy configuration revision,*
+ *                                           0 if full sync is required       *
+ *             dc_revision           - [OUT] the configuration cache revision *
+ *             error                 - [OUT] the error message                *
+ *                                                                            *
+ * Return value: SUCCEED - the request was parsed successfully                *
+ *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request, struct zbx_json *j,
-		zbx_proxyconfig_status_t *status, const zbx_config_vault_t *config_vault,
-		const char *config_source_ip, char **error)
+static int	proxyconfig_get_revision(const zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request,
+		zbx_uint64_t *proxy_config_revision, zbx_dc_revision_t *dc_revision, char **error)
 {
-	int			ret = FAIL;
-	char			token[ZBX_SESSION_TOKEN_SIZE + 1], tmp[ZBX_MAX_UINT64_LEN + 1];
-	zbx_uint64_t		proxy_config_revision;
-	zbx_dc_revision_t	dc_revision;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxyid:" ZBX_FS_UI64, __func__, proxy->proxyid);
+	char	token[ZBX_SESSION_TOKEN_SIZE + 1], tmp[ZBX_MAX_UINT64_LEN + 1];
 
 	if (SUCCEED != zbx_json_value_by_name(jp_request, ZBX_PROTO_TAG_SESSION, token, sizeof(token), NULL))
 	{
 		*error = zbx_strdup(NULL, "cannot get session from proxy configuration request");
-		goto out;
+		return FAIL;
 	}
 
 	if (SUCCEED != zbx_json_value_by_name(jp_request, ZBX_PROTO_TAG_CONFIG_REVISION, tmp, sizeof(tmp), NULL))
 	{
 		*error = zbx_strdup(NULL, "cannot get revision from proxy configuration request");
-		goto out;
+		return FAIL;
 	}
 
-	if (SUCCEED != zbx_is_uint64(tmp, &proxy_config_revision))
+	if (SUCCEED != zbx_is_uint64(tmp, proxy_config_revision))
 	{
 		*error = zbx_dsprintf(NULL, "invalid proxy configuration revision: %s", tmp);
-		goto out;
+		return FAIL;
 	}
 
-	if (0 != zbx_dc_register_config_session(proxy->proxyid, token, proxy_config_revision, &dc_revision) ||
-			0 == proxy_config_revision)
+	if (0 != zbx_dc_register_config_session(proxy->proxyid, token, *proxy_config_revision, dc_revision) ||
+			0 == *proxy_config_revision)
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() forcing full proxy configuration sync", __func__);
-		proxy_config_revision = 0;
-		zbx_json_addint64(j, ZBX_PROTO_TAG_FULL_SYNC, 1);
+		*proxy_config_revision = 0;
 	}
 	else
 	{
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() updating proxy configuration " ZBX_FS_UI64 "->" ZBX_FS_UI64,
-				__func__, proxy_config_revision, dc_revision.config);
+				__func__, *proxy_config_revision, dc_revision->config);
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepare proxy configuration data for the specified revision       *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxyconfig_get_data(const zbx_dc_proxy_t *proxy, zbx_uint64_t proxy_config_revision,
+		const zbx_dc_revision_t *dc_revision, const zbx_proxyconfig_objects_t *objects, struct zbx_json *j,
+		zbx_proxyconfig_status_t *status, const zbx_config_vault_t *config_vault,
+		const char *config_source_ip, char **error)
+{
+	if (0 == proxy_config_revision)
+		zbx_json_addint64(j, ZBX_PROTO_TAG_FULL_SYNC, 1);
+
+	if (proxy_config_revision == dc_revision->config)
+	{
+		*status = ZBX_PROXYCONFIG_STATUS_EMPTY;
+		return SUCCEED;
+	}
+
+	if (SUCCEED != proxyconfig_get_tables(proxy, objects, j, status, config_vault, config_source_ip, error))
+		return FAIL;
+
+	zbx_json_adduint64(j, ZBX_PROTO_TAG_CONFIG_REVISION, dc_revision->config);
+
+	zabbix_log(LOG_LEVEL_TRACE, "%s() configuration: %s", __func__, j->buffer);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepare compressed proxy configuration data                       *
+ *                                                                            *
+ * Parameters: proxy            - [IN] the proxy                              *
+ *             jp_request       - [IN] the configuration request              *
+ *             data             - [OUT] the compressed configuration data     *
+ *             data_size        - [OUT] the compressed data size              *
+ *             reserved         - [OUT] the uncompressed data size            *
+ *             status           - [OUT] the configuration data status         *
+ *             config_vault     - [IN]                                        *
+ *             config_source_ip - [IN]                                        *
+ *             error            - [OUT] the error message                     *
+ *                                                                            *
+ * Return value: SUCCEED - the configuration data was prepared successfully   *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The compressed configuration update is cached by configuration   *
+ *           revisions and the set of objects to sync, so proxies on the same *
+ *           revision requesting the same objects (for example after global   *
+ *           macro or regular expression changes) share one update that is    *
+ *           read from database only once.                                    *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_proxyconfig_get_compressed_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request,
+		char **data, size_t *data_size, size_t *reserved, zbx_proxyconfig_status_t *status,
+		const zbx_config_vault_t *config_vault, const char *config_source_ip, char **error)
+{
+	int				ret;
+	zbx_uint64_t			proxy_config_revision;
+	zbx_dc_revision_t		dc_revision;
+	zbx_proxyconfig_objects_t	objects;
+	zbx_vector_uint64_t		objects_key;
+	struct zbx_json			j;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxyid:" ZBX_FS_UI64, __func__, proxy->proxyid);
+
+	if (SUCCEED != (ret = proxyconfig_get_revision(proxy, jp_request, &proxy_config_revision, &dc_revision,
+			error)))
+	{
+		goto out;
 	}
 
+	proxyconfig_objects_init(&objects);
+	zbx_vector_uint64_create(&objects_key);
+
 	if (proxy_config_revision != dc_revision.config)
 	{
-		if (SUCCEED != (ret = proxyconfig_get_tables(proxy, proxy_config_revision, &dc_revision, j, status,
-				config_vault, config_source_ip, error)))
+		proxyconfig_get_objects(proxy, proxy_config_revision, &dc_revision, &objects);
+		proxyconfig_objects_serialize(proxy, &objects, &objects_key);
+
+		if (SUCCEED == zbx_pcc_get(proxy_config_revision, dc_revision.config, &objects_key,
+				&objects.timeouts, data, data_size, reserved))
 		{
-			goto out;
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() using cached configuration " ZBX_FS_UI64 "->" ZBX_FS_UI64,
+					__func__, proxy_config_revision, dc_revision.config);
+			*status = ZBX_PROXYCONFIG_STATUS_DATA;
+			goto clean;
 		}
+	}
 
-		zbx_json_adduint64(j, ZBX_PROTO_TAG_CONFIG_REVISION, dc_revision.config);
+	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
 
-		zabbix_log(LOG_LEVEL_TRACE, "%s() configuration: %s", __func__, j->buffer);
-	}
-	else
+	if (SUCCEED == (ret = proxyconfig_get_data(proxy, proxy_config_revision, &dc_revision, &objects, &j,
+			status, config_vault, config_source_ip, error)))
 	{
-		*status = ZBX_PROXYCONFIG_STATUS_EMPTY;
-		ret = SUCCEED;
+		if (SUCCEED == (ret = zbx_compress(j.buffer, j.buffer_size, data, data_size)))
+		{
+			*reserved = j.buffer_size;
+
+			if (ZBX_PROXYCONFIG_STATUS_DATA == *status)
+			{
+				zbx_pcc_put(proxy_config_revision, dc_revision.config, &objects_key, &objects.timeouts,
+						*data, *data_size, *reserved);
+			}
+		}
+		else
+			*error = zbx_dsprintf(NULL, "cannot compress data: %s", zbx_compress_strerror());
 	}
+
+	zbx_json_free(&j);
+clean:
+	zbx_vector_uint64_destroy(&objects_key);
+	proxyconfig_objects_clear(&objects);
 out:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
@@ -1306,7 +1483,6 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		const char *config_source_ip)
 {
 	char				*error = NULL, *buffer = NULL, *version_str = NULL;
-	struct zbx_json			j;
 	zbx_dc_proxy_t			proxy;
 	int				ret, flags = ZBX_TCP_PROTOCOL, loglevel, version_int;
 	size_t				buffer_size, reserved = 0;
@@ -1344,28 +1520,17 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		goto out;
 	}
 
-	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
-
-	if (SUCCEED != zbx_proxyconfig_get_data(&proxy, jp, &j, &status, config_vault, config_source_ip, &error))
+	if (SUCCEED != zbx_proxyconfig_get_compressed_data(&proxy, jp, &buffer, &buffer_size, &reserved, &status,
+			config_vault, config_source_ip, &error))
 	{
 		(void)zbx_send_response_ext(sock, FAIL, error, NULL, flags, config_timeout);
 		zabbix_log(LOG_LEVEL_WARNING, "cannot collect configuration data for proxy \"%s\" at \"%s\": %s",
 				proxy.name, sock->peer, error);
-		goto clean;
+		goto out;
 	}
 
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
-	{
-		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
-		goto clean;
-	}
-
-	reserved = j.buffer_size;
-
-	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
-
 	zabbix_log(loglevel, "sending configuration data to proxy \"%s\" at \"%s\", datalen "
 			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with compression ratio %.1f", proxy.name,
 			sock->peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
@@ -1379,8 +1544,6 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		zabbix_log(LOG_LEVEL_WARNING, "cannot send configuration data to proxy \"%s\" at \"%s\": %s",
 				proxy.name, sock->peer, zbx_socket_strerror());
 	}
-clean:
-	zbx_json_free(&j);
 out:
 	zbx_free(error);
 	zbx_free(buffer);
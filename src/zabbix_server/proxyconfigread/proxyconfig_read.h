@@ -28,12 +28,19 @@ typedef enum {
 }
 zbx_proxyconfig_status_t;
 
-int	zbx_proxyconfig_get_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request, struct zbx_json *j,
-		zbx_proxyconfig_status_t *status, const zbx_config_vault_t *config_vault, const char *config_source_ip,
-		char **error);
+int	zbx_proxyconfig_get_compressed_data(zbx_dc_proxy_t *proxy, const struct zbx_json_parse *jp_request,
+		char **data, size_t *data_size, size_t *reserved, zbx_proxyconfig_status_t *status,
+		const zbx_config_vault_t *config_vault, const char *config_source_ip, char **error);
 
 void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 		const zbx_config_vault_t *config_vault, int config_timeout, int config_trapper_timeout,
 		const char *config_source_ip);
 
+int	zbx_pcc_init(zbx_uint64_t cache_size, char **error);
+void	zbx_pcc_destroy(void);
+int	zbx_pcc_get(zbx_uint64_t from_revision, zbx_uint64_t to_revision, const zbx_vector_uint64_t *objects,
+		const zbx_dc_item_type_timeouts_t *timeouts, char **data, size_t *data_size, size_t *reserved);
+void	zbx_pcc_put(zbx_uint64_t from_revision, zbx_uint64_t to_revision, const zbx_vector_uint64_t *objects,
+		const zbx_dc_item_type_timeouts_t *timeouts, const char *data, size_t data_size, size_t reserved);
+
 #endif
@@ -36,315 +36,126 @@
 #include "zbxtime.h"
 #include "zbxversion.h"
 #include "zbx_rtc_constants.h"
+#include "zbxasyncpoller.h"
+#include "zbxip.h"
 
-static zbx_get_program_type_f		zbx_get_program_type_cb = NULL;
+#include <event2/dns.h>
 
-static int	connect_to_proxy(const zbx_dc_proxy_t *proxy, zbx_socket_t *sock, int timeout,
-		const char *config_source_ip)
-{
-	int		ret = FAIL;
-	const char	*tls_arg1, *tls_arg2;
+static zbx_get_program_type_f		zbx_get_program_type_cb = NULL;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() address:%s port:%hu timeout:%d conn:%u", __func__, proxy->addr,
-			proxy->port, timeout, (unsigned int)proxy->tls_connect);
+/* the maximum number of passive proxies served concurrently by a proxy poller */
+#define PROXYPOLLER_MAX_CONCURRENT	1000
+/* the maximum number of proxies taken from configuration cache queue at once */
+#define PROXYPOLLER_BATCH_SIZE		100
 
-	switch (proxy->tls_connect)
-	{
-		case ZBX_TCP_SEC_UNENCRYPTED:
-			tls_arg1 = NULL;
-			tls_arg2 = NULL;
-			break;
-#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
-		case ZBX_TCP_SEC_TLS_CERT:
-			tls_arg1 = proxy->tls_issuer;
-			tls_arg2 = proxy->tls_subject;
-			break;
-		case ZBX_TCP_SEC_TLS_PSK:
-			tls_arg1 = proxy->tls_psk_identity;
-			tls_arg2 = proxy->tls_psk;
-			break;
-#else
-		case ZBX_TCP_SEC_TLS_CERT:
-		case ZBX_TCP_SEC_TLS_PSK:
-			zabbix_log(LOG_LEVEL_ERR, "TLS connection is configured to be used with passive proxy \"%s\""
-					" but support for TLS was not compiled into %s.", proxy->name,
-					get_program_type_string(zbx_get_program_type_cb()));
-			ret = CONFIG_ERROR;
-			goto out;
-#endif
-		default:
-			THIS_SHOULD_NEVER_HAPPEN;
-			goto out;
-	}
-
-	if (FAIL == (ret = zbx_tcp_connect(sock, config_source_ip, proxy->addr, proxy->port, timeout,
-			proxy->tls_connect, tls_arg1, tls_arg2)))
-	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot connect to proxy \"%s\": %s", proxy->name, zbx_socket_strerror());
-		ret = NETWORK_ERROR;
-	}
-out:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
-
-	return ret;
+typedef enum
+{
+	PROXY_EXCHANGE_NONE = 0,
+	PROXY_EXCHANGE_CONFIG,
+	PROXY_EXCHANGE_DATA,
+	PROXY_EXCHANGE_TASKS
 }
+zbx_proxy_exchange_t;
 
-static int	send_data_to_proxy(const zbx_dc_proxy_t *proxy, zbx_socket_t *sock, const char *data, size_t size,
-		size_t reserved, int flags)
+typedef enum
 {
-	int	ret;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
-
-	if (FAIL == (ret = zbx_tcp_send_ext(sock, data, size, reserved, flags, 0)))
-	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot send data to proxy \"%s\": %s", proxy->name, zbx_socket_strerror());
-
-		ret = NETWORK_ERROR;
-	}
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+	PROXY_STEP_CONNECT_WAIT = 0,
+	PROXY_STEP_TLS_WAIT,
+	PROXY_STEP_SEND_REQUEST,
+	PROXY_STEP_RECV_REPLY,
+	PROXY_STEP_SEND_CONFIG,
+	PROXY_STEP_RECV_RESPONSE
+}
+zbx_proxy_step_t;
 
-	return ret;
+typedef struct
+{
+	struct event_base		*base;
+	struct evdns_base		*dnsbase;
+	const zbx_config_vault_t	*config_vault;
+	int				config_timeout;
+	int				config_trapper_timeout;
+	const char			*config_source_ip;
+	const zbx_events_funcs_t	*events_cbs;
+	int				proxyconfig_frequency;
+	int				proxydata_frequency;
+	const zbx_thread_info_t		*info;
+	unsigned char			state;
+	int				processing;	/* the number of proxies being served */
+	int				processed;	/* the number of proxies served since last statistics */
+	zbx_dc_proxy_t			*proxies;	/* the buffer for proxies taken from queue */
 }
+zbx_proxy_poller_t;
 
-static int	recv_data_from_proxy(const zbx_dc_proxy_t *proxy, zbx_socket_t *sock)
+/* passive proxy exchange context, a proxy is served by a sequence of exchanges using separate connections */
+typedef struct
 {
-	int	ret;
+	zbx_proxy_poller_t	*poller;
+	zbx_dc_proxy_t		proxy;
+	zbx_dc_proxy_t		proxy_old;
+	zbx_socket_t		s;
+	zbx_tcp_send_context_t	tcp_send_context;
+	zbx_tcp_recv_context_t	tcp_recv_context;
+	char			*buffer;	/* the request or configuration data being sent */
+	zbx_proxy_exchange_t	exchange;
+	zbx_proxy_step_t	step;
+	zbx_timespec_t		ts;		/* the time when connection was established */
+	const char		*tls_arg1;
+	const char		*tls_arg2;
+	int			ret;
+	int			check_config;
+	int			check_data;
+	int			check_tasks;
+	unsigned char		update_nextcheck;
+}
+zbx_proxy_context_t;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+static void	proxy_exchange_next(zbx_proxy_context_t *context);
 
-	if (FAIL == (ret = zbx_tcp_recv(sock)))
+static const char	*get_proxy_step_string(zbx_proxy_step_t step)
+{
+	switch (step)
 	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot obtain data from proxy \"%s\": %s", proxy->name,
-				zbx_socket_strerror());
+		case PROXY_STEP_CONNECT_WAIT:
+			return "connect";
+		case PROXY_STEP_TLS_WAIT:
+			return "tls";
+		case PROXY_STEP_SEND_REQUEST:
+		case PROXY_STEP_SEND_CONFIG:
+			return "send";
+		case PROXY_STEP_RECV_REPLY:
+		case PROXY_STEP_RECV_RESPONSE:
+			return "receive";
+		default:
+			return "unknown";
 	}
-	else
-		zabbix_log(LOG_LEVEL_DEBUG, "obtained data from proxy \"%s\": [%s]", proxy->name, sock->buffer);
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
-
-	return ret;
 }
 
-static void	disconnect_proxy(zbx_socket_t *sock)
+static zbx_async_task_state_t	get_task_state_for_event(short event)
 {
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	if (POLLIN & event)
+		return ZBX_ASYNC_TASK_READ;
 
-	zbx_tcp_close(sock);
+	if (POLLOUT & event)
+		return ZBX_ASYNC_TASK_WRITE;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+	return ZBX_ASYNC_TASK_STOP;
 }
 
-/********************************************************************************
- *                                                                              *
- * Purpose: get historical data from proxy                                      *
- *                                                                              *
- * Parameters: proxy                  - [IN/OUT] proxy data                     *
- *             request                - [IN] requested data type                *
- *             config_timeout         - [IN]                                    *
- *             config_trapper_timeout - [IN]                                    *
- *             config_source_ip       - [IN]                                    *
- *             data                   - [OUT] data received from proxy          *
- *             ts                     - [OUT] timestamp when the proxy          *
- *                                            connection was established        *
- *                                                                              *
- * Return value: SUCCESS - processed successfully                               *
- *               other code - an error occurred                                 *
- *                                                                              *
- * Comments: The proxy->compress property is updated depending on the           *
- *           protocol flags sent by proxy.                                      *
- *                                                                              *
- ********************************************************************************/
-static int	get_data_from_proxy(zbx_dc_proxy_t *proxy, const char *request, int config_timeout,
-		int config_trapper_timeout, const char *config_source_ip, char **data, zbx_timespec_t *ts)
+static void	proxy_context_close(zbx_proxy_context_t *context)
 {
-	zbx_socket_t	s;
-	struct zbx_json	j;
-	int		ret, flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS;
-	char		*buffer = NULL;
-	size_t		buffer_size, reserved = 0;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() request:'%s'", __func__, request);
-
-	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
-
-	zbx_json_addstring(&j, "request", request, ZBX_JSON_TYPE_STRING);
-
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
-	{
-		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
-		ret = FAIL;
-		goto out;
-	}
-
-	reserved = j.buffer_size;
-	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
-
-	if (SUCCEED == (ret = connect_to_proxy(proxy, &s, config_trapper_timeout, config_source_ip)))
-	{
-		/* get connection timestamp if required */
-		if (NULL != ts)
-			zbx_timespec(ts);
-
-		ret = send_data_to_proxy(proxy, &s, buffer, buffer_size, reserved, flags);
-		zbx_free(buffer);
-
-		if (SUCCEED == ret)
-		{
-			if (SUCCEED == (ret = recv_data_from_proxy(proxy, &s)))
-			{
-				if (!ZBX_IS_RUNNING())
-				{
-					int	flags_response = ZBX_TCP_PROTOCOL;
-
-					if (0 != (s.protocol & ZBX_TCP_COMPRESS))
-						flags_response |= ZBX_TCP_COMPRESS;
-
-					zbx_send_response_ext(&s, FAIL, "Zabbix server shutdown in progress", NULL,
-							flags_response, config_timeout);
-
-					zabbix_log(LOG_LEVEL_WARNING, "cannot process proxy data from passive proxy at"
-							" \"%s\": Zabbix server shutdown in progress", s.peer);
-					ret = FAIL;
-				}
-				else
-				{
-					ret = zbx_send_proxy_data_response(proxy, &s, NULL, SUCCEED,
-							ZBX_PROXY_UPLOAD_UNDEFINED, 0);
-
-					if (SUCCEED == ret)
-						*data = zbx_strdup(*data, s.buffer);
-				}
-			}
-		}
-
-		disconnect_proxy(&s);
-	}
-out:
-	zbx_json_free(&j);
-	zbx_free(buffer);
-
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
-
-	return ret;
+	/* reset closed socket, so it can be safely closed again */
+	zbx_tcp_close(&context->s);
+	zbx_socket_clean(&context->s);
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: sends configuration data to proxy                                 *
- *                                                                            *
- * Parameters: proxy                  - [IN/OUT] proxy data                   *
- *             config_vault           - [IN]                                  *
- *             config_trapper_timeout - [IN]                                  *
- *             config_source_ip       - [IN]                                  *
- *                                                                            *
- * Return value: SUCCEED - processed successfully                             *
- *               other code - an error occurred                               *
- *                                                                            *
- * Comments: This function updates proxy version, compress and lastaccess     *
- *           properties.                                                      *
- *                                                                            *
- ******************************************************************************/
-static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vault_t *config_vault,
-		int config_trapper_timeout, const char *config_source_ip)
+static void	proxy_poller_set_busy(zbx_proxy_poller_t *poller)
 {
-	char				*error = NULL, *buffer = NULL;
-	int				ret, flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, loglevel;
-	zbx_socket_t			s;
-	struct zbx_json			j;
-	struct zbx_json_parse		jp;
-	size_t				buffer_size, reserved = 0;
-	zbx_proxyconfig_status_t	status;
-
-
-	zbx_json_init(&j, 512 * ZBX_KIBIBYTE);
-	zbx_json_addstring(&j, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_VALUE_PROXY_CONFIG, ZBX_JSON_TYPE_STRING);
-
-	if (SUCCEED != (ret = connect_to_proxy(proxy, &s, config_trapper_timeout, config_source_ip)))
-		goto out;
-
-	if (SUCCEED != (ret = send_data_to_proxy(proxy, &s, j.buffer, j.buffer_size, reserved, ZBX_TCP_PROTOCOL)))
-		goto clean;
-
-	if (FAIL == (ret = zbx_tcp_recv_ext(&s, 0, 0)))
+	if (ZBX_PROCESS_STATE_IDLE == poller->state)
 	{
-		zabbix_log(LOG_LEVEL_WARNING, "cannot receive configuration information from proxy \"%s\": %s",
-				proxy->name, zbx_socket_strerror());
-		goto clean;
+		zbx_update_selfmon_counter(poller->info, ZBX_PROCESS_STATE_BUSY);
+		poller->state = ZBX_PROCESS_STATE_BUSY;
 	}
-
-	if (SUCCEED != (ret = zbx_json_open(s.buffer, &jp)))
-	{
-		zabbix_log(LOG_LEVEL_WARNING, "cannot parse configuration information from proxy \"%s\": %s",
-				proxy->name, zbx_socket_strerror());
-		goto clean;
-	}
-
-	zbx_json_clean(&j);
-
-	if (SUCCEED != (ret = zbx_proxyconfig_get_data(proxy, &jp, &j, &status, config_vault, config_source_ip,
-			&error)))
-	{
-		zabbix_log(LOG_LEVEL_ERR, "cannot collect configuration data for proxy \"%s\": %s",
-				proxy->name, error);
-		goto clean;
-	}
-
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
-	{
-		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
-		ret = FAIL;
-		goto clean;
-	}
-
-	reserved = j.buffer_size;
-	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
-
-	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
-
-	zabbix_log(loglevel, "sending configuration data to proxy \"%s\" at \"%s\", datalen "
-			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with compression ratio %.1f", proxy->name,
-			s.peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
-			(double)reserved / buffer_size);
-
-	ret = send_data_to_proxy(proxy, &s, buffer, buffer_size, reserved, flags);
-	zbx_free(buffer);		/* json buffer can be large, free as fast as possible */
-
-	if (SUCCEED == ret)
-	{
-		if (SUCCEED != (ret = zbx_recv_response(&s, 0, &error)))
-		{
-			zabbix_log(LOG_LEVEL_WARNING, "cannot send configuration data to proxy"
-					" \"%s\" at \"%s\": %s", proxy->name, s.peer, error);
-		}
-		else
-		{
-			if (SUCCEED != zbx_json_open(s.buffer, &jp))
-			{
-				zabbix_log(LOG_LEVEL_WARNING, "invalid configuration data response received from proxy"
-						" \"%s\" at \"%s\": %s", proxy->name, s.peer, zbx_json_strerror());
-			}
-			else
-			{
-				char	*version_str;
-
-				version_str = zbx_get_proxy_protocol_version_str(&jp);
-				zbx_strlcpy(proxy->version_str, version_str, sizeof(proxy->version_str));
-				proxy->version_int = zbx_get_proxy_protocol_version_int(version_str);
-				proxy->lastaccess = time(NULL);
-				zbx_free(version_str);
-			}
-		}
-	}
-clean:
-	disconnect_proxy(&s);
-out:
-	zbx_free(buffer);
-	zbx_free(error);
-	zbx_json_free(&j);
-
-	return ret;
 }
 
 /******************************************************************************
@@ -420,242 +231,653 @@ out:
 
 /******************************************************************************
  *                                                                            *
- * Purpose: gets data from proxy ('proxy data' request)                       *
+ * Purpose: process 'proxy data' or 'proxy tasks' request reply               *
  *                                                                            *
- * Parameters: proxy                  - [IN/OUT] proxy data                   *
- *             config_timeout         - [IN]                                  *
- *             config_trapper_timeout - [IN]                                  *
- *             events_cbs             - [IN]                                  *
- *             proxydata_frequency    - [IN]                                  *
- *             config_source_ip       - [IN]                                  *
- *             more                   - [OUT] available data flag             *
- *                                                                            *
- * Return value: SUCCEED - data were received and processed successfully      *
- *               other code - an error occurred                               *
+ * Parameters: context - [IN/OUT] the proxy context                           *
  *                                                                            *
  * Comments: This function updates proxy version, compress and lastaccess     *
  *           properties.                                                      *
  *                                                                            *
  ******************************************************************************/
-static int	proxy_get_data(zbx_dc_proxy_t *proxy, int config_timeout, int config_trapper_timeout,
-		const zbx_events_funcs_t *events_cbs, int proxydata_frequency, const char *config_source_ip, int *more)
+static void	proxy_process_reply(zbx_proxy_context_t *context)
 {
-	char		*answer = NULL;
-	int		ret;
-	zbx_timespec_t	ts;
+	zbx_proxy_poller_t	*poller = context->poller;
+	zbx_dc_proxy_t		*proxy = &context->proxy;
+	char			*answer;
+	int			more;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	zabbix_log(LOG_LEVEL_DEBUG, "obtained data from proxy \"%s\": [%s]", proxy->name, context->s.buffer);
 
-	if (SUCCEED != (ret = get_data_from_proxy(proxy, ZBX_PROTO_VALUE_PROXY_DATA, config_timeout,
-			config_trapper_timeout, config_source_ip, &answer, &ts)))
+	if (!ZBX_IS_RUNNING())
 	{
-		goto out;
+		int	flags_response = ZBX_TCP_PROTOCOL;
+
+		if (0 != (context->s.protocol & ZBX_TCP_COMPRESS))
+			flags_response |= ZBX_TCP_COMPRESS;
+
+		zbx_send_response_ext(&context->s, FAIL, "Zabbix server shutdown in progress", NULL, flags_response,
+				poller->config_timeout);
+
+		zabbix_log(LOG_LEVEL_WARNING, "cannot process proxy data from passive proxy at \"%s\": Zabbix server"
+				" shutdown in progress", context->s.peer);
+		context->ret = FAIL;
+		return;
+	}
+
+	if (SUCCEED != (context->ret = zbx_send_proxy_data_response(proxy, &context->s, NULL, SUCCEED,
+			ZBX_PROXY_UPLOAD_UNDEFINED, 0)))
+	{
+		return;
 	}
 
+	answer = zbx_strdup(NULL, context->s.buffer);
+
+	/* data processing can take time, release connection first */
+	proxy_context_close(context);
+
 	/* handle pre 3.4 proxies that did not support proxy data request and active/passive configuration mismatch */
 	if ('\0' == *answer)
 	{
 		zbx_strlcpy(proxy->version_str, ZBX_VERSION_UNDEFINED_STR, sizeof(proxy->version_str));
 		proxy->version_int = ZBX_COMPONENT_VERSION_UNDEFINED;
-		zbx_free(answer);
-		ret = FAIL;
+		context->ret = FAIL;
 		goto out;
 	}
 
 	proxy->lastaccess = time(NULL);
-	ret = proxy_process_proxy_data(proxy, answer, &ts, events_cbs, proxydata_frequency, more);
-	zbx_free(answer);
-out:
-	if (SUCCEED == ret)
-		zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s more:%d", __func__, zbx_result_string(ret), *more);
-	else
-		zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
-	return ret;
+	context->ret = proxy_process_proxy_data(proxy, answer, &context->ts, poller->events_cbs,
+			poller->proxydata_frequency, &more);
+
+	if (PROXY_EXCHANGE_DATA == context->exchange && SUCCEED == context->ret)
+	{
+		context->check_tasks = 0;
+
+		if (ZBX_PROXY_DATA_MORE != more)
+			context->check_data = 0;
+	}
+out:
+	zbx_free(answer);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: gets data from proxy ('proxy data' request)                       *
+ * Purpose: prepare configuration data requested by proxy for sending         *
  *                                                                            *
- * Parameters: proxy                  - [IN/OUT] proxy data                   *
- *             config_timeout         - [IN]                                  *
- *             config_trapper_timeout - [IN]                                  *
- *             config_source_ip       - [IN]                                  *
- *             events_cbs             - [IN]                                  *
- *             proxydata_frequency    - [IN]                                  *
+ * Parameters: context - [IN/OUT] the proxy context                           *
  *                                                                            *
- * Return value: SUCCEED - data were received and processed successfully      *
+ * Return value: SUCCEED - configuration data is ready for sending            *
  *               other code - an error occurred                               *
  *                                                                            *
- * Comments: This function updates proxy version, compress and lastaccess     *
- *           properties.                                                      *
- *                                                                            *
  ******************************************************************************/
-static int	proxy_get_tasks(zbx_dc_proxy_t *proxy, int config_timeout, int config_trapper_timeout,
-		const char *config_source_ip, const zbx_events_funcs_t *events_cbs, int proxydata_frequency)
+static int	proxy_prepare_configuration(zbx_proxy_context_t *context)
 {
-	char		*answer = NULL;
-	int		ret = FAIL, more;
-	zbx_timespec_t	ts;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	zbx_proxy_poller_t		*poller = context->poller;
+	zbx_dc_proxy_t			*proxy = &context->proxy;
+	struct zbx_json_parse		jp;
+	char				*error = NULL;
+	size_t				buffer_size, reserved = 0;
+	zbx_proxyconfig_status_t	status;
+	int				ret, loglevel;
 
-	if (SUCCEED != (ret = get_data_from_proxy(proxy, ZBX_PROTO_VALUE_PROXY_TASKS, config_timeout,
-			config_trapper_timeout, config_source_ip, &answer, &ts)))
+	if (SUCCEED != (ret = zbx_json_open(context->s.buffer, &jp)))
 	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot parse configuration information from proxy \"%s\": %s",
+				proxy->name, zbx_json_strerror());
 		goto out;
 	}
 
-	/* handle pre 3.4 proxies that did not support proxy data request and active/passive configuration mismatch */
-	if ('\0' == *answer)
+	if (SUCCEED != (ret = zbx_proxyconfig_get_compressed_data(proxy, &jp, &context->buffer, &buffer_size,
+			&reserved, &status, poller->config_vault, poller->config_source_ip, &error)))
 	{
-		zbx_strlcpy(proxy->version_str, ZBX_VERSION_UNDEFINED_STR, sizeof(proxy->version_str));
-		proxy->version_int = ZBX_COMPONENT_VERSION_UNDEFINED;
-		zbx_free(answer);
-		ret = FAIL;
+		zabbix_log(LOG_LEVEL_ERR, "cannot collect configuration data for proxy \"%s\": %s",
+				proxy->name, error);
 		goto out;
 	}
 
-	proxy->lastaccess = time(NULL);
+	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
-	ret = proxy_process_proxy_data(proxy, answer, &ts, events_cbs, proxydata_frequency, &more);
+	zabbix_log(loglevel, "sending configuration data to proxy \"%s\" at \"%s\", datalen "
+			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with compression ratio %.1f", proxy->name,
+			context->s.peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
+			(double)reserved / buffer_size);
 
-	zbx_free(answer);
+	if (SUCCEED != (ret = zbx_tcp_send_context_init(context->buffer, buffer_size, reserved,
+			ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, &context->tcp_send_context)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot send data to proxy \"%s\": %s", proxy->name,
+				zbx_socket_strerror());
+		ret = NETWORK_ERROR;
+	}
 out:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+	zbx_free(error);
 
 	return ret;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: retrieve values of metrics from monitored hosts                   *
+ * Purpose: process proxy response to sent configuration data                 *
+ *                                                                            *
+ * Parameters: context - [IN/OUT] the proxy context                           *
+ *                                                                            *
+ * Comments: This function updates proxy version and lastaccess properties.   *
  *                                                                            *
  ******************************************************************************/
-static int	process_proxy(const zbx_config_vault_t *config_vault, int config_timeout, int config_trapper_timeout,
-		const char *config_source_ip, const zbx_events_funcs_t *events_cbs, int proxyconfig_frequency,
-		int proxydata_frequency)
+static void	proxy_process_config_response(zbx_proxy_context_t *context)
 {
-	zbx_dc_proxy_t		proxy, proxy_old;
-	int			num, i;
-	time_t			now;
-	zbx_dc_um_handle_t	*um_handle;
+	zbx_dc_proxy_t		*proxy = &context->proxy;
+	struct zbx_json_parse	jp;
+	char			*error = NULL, *version_str;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+	if (SUCCEED != (context->ret = zbx_check_response(context->s.buffer, &error)))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "cannot send configuration data to proxy \"%s\" at \"%s\": %s",
+				proxy->name, context->s.peer, error);
+		zbx_free(error);
+		return;
+	}
 
-	if (0 == (num = zbx_dc_config_get_proxypoller_hosts(&proxy, 1)))
-		goto exit;
+	if (SUCCEED != zbx_json_open(context->s.buffer, &jp))
+	{
+		zabbix_log(LOG_LEVEL_WARNING, "invalid configuration data response received from proxy \"%s\" at"
+				" \"%s\": %s", proxy->name, context->s.peer, zbx_json_strerror());
+		return;
+	}
 
-	now = time(NULL);
+	version_str = zbx_get_proxy_protocol_version_str(&jp);
+	zbx_strlcpy(proxy->version_str, version_str, sizeof(proxy->version_str));
+	proxy->version_int = zbx_get_proxy_protocol_version_int(version_str);
+	proxy->lastaccess = time(NULL);
+	zbx_free(version_str);
+}
 
-	um_handle = zbx_dc_open_user_macros();
+/******************************************************************************
+ *                                                                            *
+ * Purpose: advance proxy exchange state machine on socket events             *
+ *                                                                            *
+ * Parameters: event  - [IN] the libevent event flags, 0 on initialization    *
+ *             data   - [IN] the proxy context                                *
+ *             fd     - [OUT] the socket to wait events on                    *
+ *             addr   - [IN] the resolved proxy address                       *
+ *             dnserr - [IN] the address resolving error if any               *
+ *                                                                            *
+ * Return value: the next async task state                                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxy_task_process(short event, void *data, int *fd, const char *addr, char *dnserr)
+{
+	zbx_proxy_context_t	*context = (zbx_proxy_context_t *)data;
+	zbx_proxy_poller_t	*poller = context->poller;
+	zbx_dc_proxy_t		*proxy = &context->proxy;
+	zbx_async_task_state_t	state;
+	short			event_new;
+	int			errnum = 0;
+	socklen_t		optlen = sizeof(int);
 
-	for (i = 0; i < num; i++)
+	proxy_poller_set_busy(poller);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxy:\"%s\" step:'%s' event:%d", __func__, proxy->name,
+			get_proxy_step_string(context->step), event);
+
+	if (0 == event)
 	{
-		int		ret = FAIL;
-		unsigned char	update_nextcheck = 0;
+		if (SUCCEED != zbx_socket_connect(&context->s, SOCK_STREAM, poller->config_source_ip, addr,
+				proxy->port, poller->config_trapper_timeout))
+		{
+			zabbix_log(LOG_LEVEL_ERR, "cannot connect to proxy \"%s\": %s", proxy->name,
+					zbx_socket_strerror());
+			/* the socket is already closed on connection failure */
+			zbx_socket_clean(&context->s);
+			context->ret = NETWORK_ERROR;
+			goto stop;
+		}
 
-		memcpy(&proxy_old, &proxy, sizeof(zbx_dc_proxy_t));
+		*fd = context->s.socket;
 
-		if (proxy.proxy_config_nextcheck <= now)
-			update_nextcheck |= ZBX_PROXY_CONFIG_NEXTCHECK;
-		if (proxy.proxy_data_nextcheck <= now)
-			update_nextcheck |= ZBX_PROXY_DATA_NEXTCHECK;
-		if (proxy.proxy_tasks_nextcheck <= now)
-			update_nextcheck |= ZBX_PROXY_TASKS_NEXTCHECK;
+		return ZBX_ASYNC_TASK_WRITE;
+	}
 
-		/* Check if passive proxy has been misconfigured on the server side. If it has happened more */
-		/* recently than last synchronisation of cache then there is no point to retry connecting to */
-		/* proxy again. The next reconnection attempt will happen after cache synchronisation. */
-		if (proxy.last_cfg_error_time < zbx_dc_config_get_last_sync_time())
+	if (0 != (event & EV_TIMEOUT))
+	{
+		if (NULL != dnserr)
 		{
-			char	*port = NULL;
-			int	check_tasks = 0;
+			zabbix_log(LOG_LEVEL_ERR, "cannot connect to proxy \"%s\": cannot resolve address: %s",
+					proxy->name, dnserr);
+			context->ret = NETWORK_ERROR;
+		}
+		else
+		{
+			zabbix_log(LOG_LEVEL_ERR, "cannot exchange data with proxy \"%s\": %s timed out", proxy->name,
+					get_proxy_step_string(context->step));
 
-			proxy.addr = zbx_strdup(NULL, proxy.addr_orig);
-			zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-					NULL, &proxy.addr, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+			if (PROXY_STEP_RECV_REPLY == context->step || PROXY_STEP_RECV_RESPONSE == context->step)
+				context->ret = FAIL;
+			else
+				context->ret = NETWORK_ERROR;
+		}
 
-			port = zbx_strdup(port, proxy.port_orig);
-			zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-					NULL, &port, ZBX_MACRO_TYPE_COMMON, NULL, 0);
-			if (FAIL == zbx_is_ushort(port, &proxy.port))
+		goto stop;
+	}
+
+	switch (context->step)
+	{
+		case PROXY_STEP_CONNECT_WAIT:
+			if (0 == getsockopt(context->s.socket, SOL_SOCKET, SO_ERROR, &errnum, &optlen) && 0 != errnum)
 			{
-				zabbix_log(LOG_LEVEL_ERR, "invalid proxy \"%s\" port: \"%s\"", proxy.name, port);
-				ret = CONFIG_ERROR;
-				zbx_free(port);
-				goto error;
+				zabbix_log(LOG_LEVEL_ERR, "cannot connect to proxy \"%s\": %s", proxy->name,
+						zbx_strerror(errnum));
+				context->ret = NETWORK_ERROR;
+				break;
 			}
-			zbx_free(port);
 
-			if (proxy.proxy_config_nextcheck <= now && proxy.compatibility == ZBX_PROXY_VERSION_CURRENT)
+			context->step = PROXY_STEP_TLS_WAIT;
+			ZBX_FALLTHROUGH;
+		case PROXY_STEP_TLS_WAIT:
+			if (ZBX_TCP_SEC_UNENCRYPTED != proxy->tls_connect)
 			{
-				if (SUCCEED != (ret = proxy_send_configuration(&proxy, config_vault,
-						config_trapper_timeout, config_source_ip)))
+				char		*error = NULL;
+				const char	*server_name;
+
+				server_name = (SUCCEED == zbx_is_ip(proxy->addr) ? NULL : proxy->addr);
+
+				if (SUCCEED != zbx_socket_tls_connect(&context->s, proxy->tls_connect, context->tls_arg1,
+						context->tls_arg2, server_name, &event_new, &error))
 				{
-					goto error;
+					if (ZBX_ASYNC_TASK_STOP != (state = get_task_state_for_event(event_new)))
+						return state;
+
+					zabbix_log(LOG_LEVEL_ERR, "cannot connect to proxy \"%s\": %s", proxy->name,
+							error);
+					zbx_free(error);
+					context->ret = NETWORK_ERROR;
+					break;
 				}
 			}
 
-			if (proxy.proxy_tasks_nextcheck <= now)
-				check_tasks = 1;
+			zbx_timespec(&context->ts);
+			context->step = PROXY_STEP_SEND_REQUEST;
+			ZBX_FALLTHROUGH;
+		case PROXY_STEP_SEND_REQUEST:
+		case PROXY_STEP_SEND_CONFIG:
+			if (SUCCEED != zbx_tcp_send_context(&context->s, &context->tcp_send_context, &event_new))
+			{
+				if (ZBX_ASYNC_TASK_STOP != (state = get_task_state_for_event(event_new)))
+					return state;
 
-			if (proxy.proxy_data_nextcheck <= now && (proxy.compatibility == ZBX_PROXY_VERSION_CURRENT ||
-					proxy.compatibility == ZBX_PROXY_VERSION_OUTDATED))
+				zabbix_log(LOG_LEVEL_ERR, "cannot send data to proxy \"%s\": %s", proxy->name,
+						zbx_socket_strerror());
+				context->ret = NETWORK_ERROR;
+				break;
+			}
+
+			/* the sent data can be large, free as fast as possible */
+			zbx_tcp_send_context_clear(&context->tcp_send_context);
+			zbx_free(context->buffer);
+
+			context->step = (PROXY_STEP_SEND_REQUEST == context->step ? PROXY_STEP_RECV_REPLY :
+					PROXY_STEP_RECV_RESPONSE);
+			zbx_tcp_recv_context_init(&context->s, &context->tcp_recv_context, 0);
+
+			return ZBX_ASYNC_TASK_READ;
+		case PROXY_STEP_RECV_REPLY:
+		case PROXY_STEP_RECV_RESPONSE:
+			if (FAIL == zbx_tcp_recv_context(&context->s, &context->tcp_recv_context, 0, &event_new))
 			{
-				int	more;
+				if (ZBX_ASYNC_TASK_STOP != (state = get_task_state_for_event(event_new)))
+					return state;
 
-				do
+				if (PROXY_STEP_RECV_RESPONSE == context->step)
 				{
-					if (FAIL == zbx_hc_check_proxy(proxy.proxyid))
-						break;
+					zabbix_log(LOG_LEVEL_WARNING, "cannot send configuration data to proxy \"%s\""
+							" at \"%s\": %s", proxy->name, context->s.peer,
+							zbx_socket_strerror());
+				}
+				else
+				{
+					zabbix_log(LOG_LEVEL_ERR, "cannot obtain data from proxy \"%s\": %s",
+							proxy->name, zbx_socket_strerror());
+				}
 
-					if (SUCCEED != (ret = proxy_get_data(&proxy, config_timeout,
-							config_trapper_timeout, events_cbs, proxydata_frequency,
-							config_source_ip, &more)))
-					{
-						goto error;
-					}
+				context->ret = FAIL;
+				break;
+			}
 
-					check_tasks = 0;
-				}
-				while (ZBX_PROXY_DATA_MORE == more);
+			if (PROXY_STEP_RECV_RESPONSE == context->step)
+			{
+				proxy_process_config_response(context);
+				break;
 			}
 
-			if (1 == check_tasks)
+			if (PROXY_EXCHANGE_CONFIG != context->exchange)
 			{
-				if (SUCCEED != (ret = proxy_get_tasks(&proxy, config_timeout, config_trapper_timeout,
-						config_source_ip, events_cbs, proxydata_frequency)))
-				{
-					goto error;
-				}
+				proxy_process_reply(context);
+				break;
 			}
+
+			if (SUCCEED != (context->ret = proxy_prepare_configuration(context)))
+				break;
+
+			context->step = PROXY_STEP_SEND_CONFIG;
+
+			return ZBX_ASYNC_TASK_WRITE;
+	}
+stop:
+	zbx_tcp_send_context_clear(&context->tcp_send_context);
+	proxy_context_close(context);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() proxy:\"%s\":%s", __func__, proxy->name,
+			zbx_result_string(context->ret));
+
+	return ZBX_ASYNC_TASK_STOP;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: continue with the next exchange when the current one is finished  *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxy_task_clear(void *data)
+{
+	zbx_proxy_context_t	*context = (zbx_proxy_context_t *)data;
+
+	zbx_free(context->buffer);
+	proxy_exchange_next(context);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start new exchange with proxy                                     *
+ *                                                                            *
+ * Parameters: context  - [IN/OUT] the proxy context                          *
+ *             exchange - [IN] the exchange to start                          *
+ *                                                                            *
+ * Return value: SUCCEED - the exchange was started                           *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxy_exchange_start(zbx_proxy_context_t *context, zbx_proxy_exchange_t exchange)
+{
+	zbx_proxy_poller_t	*poller = context->poller;
+	struct zbx_json		j;
+	const char		*request;
+	unsigned char		flags;
+
+	switch (exchange)
+	{
+		case PROXY_EXCHANGE_CONFIG:
+			request = ZBX_PROTO_VALUE_PROXY_CONFIG;
+			flags = ZBX_TCP_PROTOCOL;
+			break;
+		case PROXY_EXCHANGE_DATA:
+			request = ZBX_PROTO_VALUE_PROXY_DATA;
+			flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS;
+			break;
+		default:
+			request = ZBX_PROTO_VALUE_PROXY_TASKS;
+			flags = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS;
+			break;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() proxy:\"%s\" request:'%s'", __func__, context->proxy.name, request);
+
+	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
+	zbx_json_addstring(&j, ZBX_PROTO_TAG_REQUEST, request, ZBX_JSON_TYPE_STRING);
+	context->buffer = zbx_strdup(context->buffer, j.buffer);
+	zbx_json_free(&j);
+
+	zbx_socket_clean(&context->s);
+
+	if (SUCCEED != zbx_tcp_send_context_init(context->buffer, strlen(context->buffer), 0, flags,
+			&context->tcp_send_context))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot send data to proxy \"%s\": %s", context->proxy.name,
+				zbx_socket_strerror());
+		zbx_free(context->buffer);
+		context->ret = FAIL;
+
+		return FAIL;
+	}
+
+	context->exchange = exchange;
+	context->step = PROXY_STEP_CONNECT_WAIT;
+
+	zbx_async_poller_add_task(poller->base, poller->dnsbase, context->proxy.addr, context,
+			poller->config_trapper_timeout, proxy_task_process, proxy_task_clear);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finish serving proxy                                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxy_context_finish(zbx_proxy_context_t *context)
+{
+	zbx_proxy_poller_t	*poller = context->poller;
+	zbx_dc_proxy_t		*proxy = &context->proxy;
+
+	zbx_free(proxy->addr);
+
+	if (0 != strcmp(context->proxy_old.version_str, proxy->version_str) ||
+			context->proxy_old.lastaccess != proxy->lastaccess)
+	{
+		zbx_update_proxy_data(&context->proxy_old, proxy->version_str, proxy->version_int, proxy->lastaccess,
+				0);
+	}
+
+	zbx_dc_requeue_proxy(proxy->proxyid, context->update_nextcheck, context->ret, poller->proxyconfig_frequency,
+			poller->proxydata_frequency);
+
+	poller->processing--;
+	poller->processed++;
+
+	zbx_free(context);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start the next pending exchange with proxy or finish serving it   *
+ *          when there are no more exchanges or the last one failed           *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxy_exchange_next(zbx_proxy_context_t *context)
+{
+	if (PROXY_EXCHANGE_NONE != context->exchange && SUCCEED != context->ret)
+		goto finish;
+
+	if (1 == context->check_config)
+	{
+		context->check_config = 0;
+
+		if (SUCCEED == proxy_exchange_start(context, PROXY_EXCHANGE_CONFIG))
+			return;
+
+		goto finish;
+	}
+
+	if (1 == context->check_data)
+	{
+		if (SUCCEED == zbx_hc_check_proxy(context->proxy.proxyid))
+		{
+			if (SUCCEED == proxy_exchange_start(context, PROXY_EXCHANGE_DATA))
+				return;
+
+			goto finish;
 		}
-error:
-		zbx_free(proxy.addr);
-		if (0 != strcmp(proxy_old.version_str, proxy.version_str) ||
-				proxy_old.lastaccess != proxy.lastaccess)
+
+		context->check_data = 0;
+	}
+
+	if (1 == context->check_tasks)
+	{
+		context->check_tasks = 0;
+
+		if (SUCCEED == proxy_exchange_start(context, PROXY_EXCHANGE_TASKS))
+			return;
+	}
+finish:
+	proxy_context_finish(context);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start serving passive proxy                                       *
+ *                                                                            *
+ * Parameters: poller - [IN] the proxy poller                                 *
+ *             proxy  - [IN] the proxy taken from queue                       *
+ *             now    - [IN] the current time                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	proxy_context_start(zbx_proxy_poller_t *poller, const zbx_dc_proxy_t *proxy, time_t now)
+{
+	zbx_proxy_context_t	*context;
+	char			*port = NULL;
+
+	context = (zbx_proxy_context_t *)zbx_malloc(NULL, sizeof(zbx_proxy_context_t));
+	memset(context, 0, sizeof(zbx_proxy_context_t));
+
+	context->poller = poller;
+	memcpy(&context->proxy, proxy, sizeof(zbx_dc_proxy_t));
+	memcpy(&context->proxy_old, proxy, sizeof(zbx_dc_proxy_t));
+	context->proxy.addr = NULL;
+	context->exchange = PROXY_EXCHANGE_NONE;
+	context->ret = FAIL;
+	zbx_socket_clean(&context->s);
+
+	poller->processing++;
+
+	if (proxy->proxy_config_nextcheck <= now)
+		context->update_nextcheck |= ZBX_PROXY_CONFIG_NEXTCHECK;
+	if (proxy->proxy_data_nextcheck <= now)
+		context->update_nextcheck |= ZBX_PROXY_DATA_NEXTCHECK;
+	if (proxy->proxy_tasks_nextcheck <= now)
+		context->update_nextcheck |= ZBX_PROXY_TASKS_NEXTCHECK;
+
+	/* Check if passive proxy has been misconfigured on the server side. If it has happened more */
+	/* recently than last synchronisation of cache then there is no point to retry connecting to */
+	/* proxy again. The next reconnection attempt will happen after cache synchronisation. */
+	if (proxy->last_cfg_error_time >= zbx_dc_config_get_last_sync_time())
+		goto finish;
+
+	context->proxy.addr = zbx_strdup(NULL, proxy->addr_orig);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+			&context->proxy.addr, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+
+	port = zbx_strdup(port, proxy->port_orig);
+	zbx_substitute_simple_macros(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+			&port, ZBX_MACRO_TYPE_COMMON, NULL, 0);
+
+	if (FAIL == zbx_is_ushort(port, &context->proxy.port))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "invalid proxy \"%s\" port: \"%s\"", proxy->name, port);
+		context->ret = CONFIG_ERROR;
+		zbx_free(port);
+		goto finish;
+	}
+
+	zbx_free(port);
+
+	switch (proxy->tls_connect)
+	{
+		case ZBX_TCP_SEC_UNENCRYPTED:
+			context->tls_arg1 = NULL;
+			context->tls_arg2 = NULL;
+			break;
+#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
+		case ZBX_TCP_SEC_TLS_CERT:
+			context->tls_arg1 = context->proxy.tls_issuer;
+			context->tls_arg2 = context->proxy.tls_subject;
+			break;
+		case ZBX_TCP_SEC_TLS_PSK:
+			context->tls_arg1 = context->proxy.tls_psk_identity;
+			context->tls_arg2 = context->proxy.tls_psk;
+			break;
+#else
+		case ZBX_TCP_SEC_TLS_CERT:
+		case ZBX_TCP_SEC_TLS_PSK:
+			zabbix_log(LOG_LEVEL_ERR, "TLS connection is configured to be used with passive proxy \"%s\""
+					" but support for TLS was not compiled into %s.", proxy->name,
+					get_program_type_string(zbx_get_program_type_cb()));
+			context->ret = CONFIG_ERROR;
+			goto finish;
+#endif
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			goto finish;
+	}
+
+	if (proxy->proxy_config_nextcheck <= now && ZBX_PROXY_VERSION_CURRENT == proxy->compatibility)
+		context->check_config = 1;
+
+	if (proxy->proxy_data_nextcheck <= now && (ZBX_PROXY_VERSION_CURRENT == proxy->compatibility ||
+			ZBX_PROXY_VERSION_OUTDATED == proxy->compatibility))
+	{
+		context->check_data = 1;
+	}
+
+	if (proxy->proxy_tasks_nextcheck <= now)
+		context->check_tasks = 1;
+
+	proxy_exchange_next(context);
+
+	return;
+finish:
+	proxy_context_finish(context);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start serving passive proxies that are due for data exchange      *
+ *                                                                            *
+ * Parameters: poller - [IN] the proxy poller                                 *
+ *                                                                            *
+ * Return value: the number of started proxies                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	proxy_poller_start_proxies(zbx_proxy_poller_t *poller)
+{
+	int			num, i, total = 0;
+	time_t			now;
+	zbx_dc_um_handle_t	*um_handle;
+
+	um_handle = zbx_dc_open_user_macros();
+
+	while (PROXYPOLLER_MAX_CONCURRENT > poller->processing)
+	{
+		if (0 == (num = zbx_dc_config_get_proxypoller_hosts(poller->proxies,
+				MIN(PROXYPOLLER_BATCH_SIZE, PROXYPOLLER_MAX_CONCURRENT - poller->processing))))
 		{
-			zbx_update_proxy_data(&proxy_old, proxy.version_str, proxy.version_int, proxy.lastaccess, 0);
+			break;
 		}
 
-		zbx_dc_requeue_proxy(proxy.proxyid, update_nextcheck, ret, proxyconfig_frequency, proxydata_frequency);
+		proxy_poller_set_busy(poller);
+
+		now = time(NULL);
+
+		for (i = 0; i < num; i++)
+			proxy_context_start(poller, &poller->proxies[i], now);
+
+		total += num;
 	}
 
 	zbx_dc_close_user_macros(um_handle);
-exit:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
-	return num;
+	return total;
+}
+
+static void	proxy_poller_wake(evutil_socket_t fd, short events, void *arg)
+{
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(events);
+	ZBX_UNUSED(arg);
 }
 
 ZBX_THREAD_ENTRY(proxypoller_thread, args)
 {
 	zbx_thread_proxy_poller_args	*proxy_poller_args_in = (zbx_thread_proxy_poller_args *)
 							(((zbx_thread_args_t *)args)->args);
-	int				nextcheck, sleeptime = -1, processed = 0, old_processed = 0;
-	double				sec, total_sec = 0.0, old_total_sec = 0.0;
 	time_t				last_stat_time;
 	zbx_ipc_async_socket_t		rtc;
 	const zbx_thread_info_t		*info = &((zbx_thread_args_t *)args)->info;
@@ -663,6 +885,10 @@ ZBX_THREAD_ENTRY(proxypoller_thread, args)
 	int				process_num = ((zbx_thread_args_t *)args)->info.process_num;
 	unsigned char			process_type = ((zbx_thread_args_t *)args)->info.process_type;
 	zbx_uint32_t			rtc_msgs[] = {ZBX_RTC_PROXYPOLLER_PROCESS};
+	zbx_proxy_poller_t		poller;
+	struct event			*wake_event, *rtc_event;
+	struct timeval			tv = {1, 0};
+	char				*timeout;
 
 	zbx_get_program_type_cb = proxy_poller_args_in->zbx_get_program_type_cb_arg;
 
@@ -685,58 +911,94 @@ ZBX_THREAD_ENTRY(proxypoller_thread, args)
 	zbx_rtc_subscribe(process_type, process_num, rtc_msgs, ARRSIZE(rtc_msgs), proxy_poller_args_in->config_timeout,
 			&rtc);
 
+	memset(&poller, 0, sizeof(poller));
+	poller.config_vault = proxy_poller_args_in->config_vault;
+	poller.config_timeout = proxy_poller_args_in->config_timeout;
+	poller.config_trapper_timeout = proxy_poller_args_in->config_trapper_timeout;
+	poller.config_source_ip = proxy_poller_args_in->config_source_ip;
+	poller.events_cbs = proxy_poller_args_in->events_cbs;
+	poller.proxyconfig_frequency = proxy_poller_args_in->proxyconfig_frequency;
+	poller.proxydata_frequency = proxy_poller_args_in->proxydata_frequency;
+	poller.info = info;
+	poller.state = ZBX_PROCESS_STATE_BUSY;
+	poller.proxies = (zbx_dc_proxy_t *)zbx_malloc(NULL, sizeof(zbx_dc_proxy_t) * PROXYPOLLER_BATCH_SIZE);
+
+	if (NULL == (poller.base = event_base_new()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize event base");
+		exit(EXIT_FAILURE);
+	}
+
+	if (NULL == (poller.dnsbase = evdns_base_new(poller.base, EVDNS_BASE_INITIALIZE_NAMESERVERS)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize asynchronous DNS library");
+		exit(EXIT_FAILURE);
+	}
+
+	timeout = zbx_dsprintf(NULL, "%d", proxy_poller_args_in->config_timeout);
+
+	if (0 != evdns_base_set_option(poller.dnsbase, "timeout:", timeout))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot set timeout to asynchronous DNS library");
+		exit(EXIT_FAILURE);
+	}
+
+	zbx_free(timeout);
+
+	/* wake up every second to check for proxies due for data exchange */
+	if (NULL == (wake_event = event_new(poller.base, -1, EV_PERSIST, proxy_poller_wake, NULL)))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot create proxy poller timer event");
+		exit(EXIT_FAILURE);
+	}
+
+	evtimer_add(wake_event, &tv);
+
+	rtc_event = event_new(poller.base, zbx_ipc_client_get_fd(rtc.client), EV_READ | EV_PERSIST,
+			proxy_poller_wake, NULL);
+	event_add(rtc_event, NULL);
+
 	while (ZBX_IS_RUNNING())
 	{
 		zbx_uint32_t	rtc_cmd;
 		unsigned char	*rtc_data;
 
-		sec = zbx_time();
-		zbx_update_env(get_process_type_string(process_type), sec);
+		zbx_update_env(get_process_type_string(process_type), zbx_time());
 
-		if (0 != sleeptime)
-		{
-			zbx_setproctitle("%s #%d [exchanged data with %d proxies in " ZBX_FS_DBL " sec,"
-					" exchanging data]", get_process_type_string(process_type), process_num,
-					old_processed, old_total_sec);
-		}
+		proxy_poller_start_proxies(&poller);
 
-		processed += process_proxy(proxy_poller_args_in->config_vault, proxy_poller_args_in->config_timeout,
-				proxy_poller_args_in->config_trapper_timeout, proxy_poller_args_in->config_source_ip,
-				proxy_poller_args_in->events_cbs, proxy_poller_args_in->proxyconfig_frequency,
-				proxy_poller_args_in->proxydata_frequency);
-		total_sec += zbx_time() - sec;
+		if (STAT_INTERVAL <= time(NULL) - last_stat_time)
+		{
+			zbx_setproctitle("%s #%d [exchanged data with %d proxies in %d sec, exchanging data with %d"
+					" proxies]", get_process_type_string(process_type), process_num,
+					poller.processed, STAT_INTERVAL, poller.processing);
 
-		nextcheck = zbx_dc_config_get_proxypoller_nextcheck();
-		sleeptime = zbx_calculate_sleeptime(nextcheck, POLLER_DELAY);
+			poller.processed = 0;
+			last_stat_time = time(NULL);
+		}
 
-		if (0 != sleeptime || STAT_INTERVAL <= time(NULL) - last_stat_time)
+		if (ZBX_PROCESS_STATE_BUSY == poller.state)
 		{
-			if (0 == sleeptime)
-			{
-				zbx_setproctitle("%s #%d [exchanged data with %d proxies in " ZBX_FS_DBL " sec,"
-						" exchanging data]", get_process_type_string(process_type), process_num,
-						processed, total_sec);
-			}
-			else
-			{
-				zbx_setproctitle("%s #%d [exchanged data with %d proxies in " ZBX_FS_DBL " sec,"
-						" idle %d sec]", get_process_type_string(process_type), process_num,
-						processed, total_sec, sleeptime);
-				old_processed = processed;
-				old_total_sec = total_sec;
-			}
-			processed = 0;
-			total_sec = 0.0;
-			last_stat_time = time(NULL);
+			zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
+			poller.state = ZBX_PROCESS_STATE_IDLE;
 		}
 
-		if (SUCCEED == zbx_rtc_wait(&rtc, info, &rtc_cmd, &rtc_data, sleeptime) && 0 != rtc_cmd)
+		event_base_loop(poller.base, EVLOOP_ONCE);
+
+		if (SUCCEED == zbx_rtc_wait(&rtc, info, &rtc_cmd, &rtc_data, 0) && 0 != rtc_cmd)
 		{
 			if (ZBX_RTC_SHUTDOWN == rtc_cmd)
 				break;
 		}
 	}
 
+	/* exchanges in progress are abandoned on shutdown, proxies are polled again after restart */
+	evdns_base_free(poller.dnsbase, 0);
+	event_free(rtc_event);
+	event_free(wake_event);
+	event_base_free(poller.base);
+	zbx_free(poller.proxies);
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
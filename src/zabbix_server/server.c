@@ -31,6 +31,7 @@
 #include "zbxlog.h"
 #include "zbxgetopt.h"
 #include "zbxmutexs.h"
+#include "zbxshmem.h"
 #include "zbxmodules.h"
 #include "zbxnix.h"
 #include "zbxcomms.h"
@@ -47,6 +48,7 @@
 #include "trapper/trapper.h"
 #include "escalator/escalator.h"
 #include "proxypoller/proxypoller.h"
+#include "proxyconfigread/proxyconfig_read.h"
 #include "vmware/vmware.h"
 #include "taskmanager/taskmanager.h"
 #include "connector/connector_manager.h"
@@ -59,6 +61,7 @@
 #include "reporter/report_manager.h"
 #include "reporter/report_writer.h"
 #include "events/events.h"
+#include "events/problem_cache.h"
 #include "zbxcachevalue.h"
 #include "zbxcachehistory.h"
 #include "zbxhistory.h"
@@ -123,12 +126,16 @@ const char	*help_message[] = {
 	"      " ZBX_SECRETS_RELOAD "                  Reload secrets from Vault",
 	"      " ZBX_DIAGINFO "=section                Log internal diagnostic information of the",
 	"                                        section (historycache, preprocessing, alerting,",
-	"                                        lld, valuecache, locks, connector) or everything if section is",
-	"                                        not specified",
+	"                                        lld, valuecache, locks, connector, configcache,",
+	"                                        latency) or everything if section is not",
+	"                                        specified",
 	"      " ZBX_PROF_ENABLE "=target              Enable profiling, affects all processes if",
 	"                                        target is not specified",
 	"      " ZBX_PROF_DISABLE "=target             Disable profiling, affects all processes if",
 	"                                        target is not specified",
+	"      " ZBX_LOCK_PROF_ENABLE "                Enable lock contention profiling, statistics are",
+	"                                        reported in locks diagnostic information",
+	"      " ZBX_LOCK_PROF_DISABLE "               Disable lock contention profiling",
 	"      " ZBX_SERVICE_CACHE_RELOAD "             Reload service manager cache",
 	"      " ZBX_HA_STATUS "                        Display HA cluster status",
 	"      " ZBX_HA_REMOVE_NODE "=target            Remove the HA node specified by its name or ID",
@@ -303,10 +310,15 @@ static zbx_uint64_t	config_trends_cache_size	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	CONFIG_TREND_FUNC_CACHE_SIZE	= 4 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_value_cache_size		= 8 * ZBX_MEBIBYTE;
 static zbx_uint64_t	config_vmware_cache_size	= 8 * ZBX_MEBIBYTE;
+static zbx_uint64_t	config_proxy_config_cache_size	= 8 * ZBX_MEBIBYTE;
+static zbx_uint64_t	config_problem_cache_size	= 8 * ZBX_MEBIBYTE;
 
 static int	config_unreachable_period		= 45;
 static int	config_unreachable_delay		= 15;
 static int	config_max_concurrent_checks_per_poller	= 1000;
+static int	config_max_concurrent_alerts_per_alerter	= 1;
+static int	config_trend_rollups			= 0;
+static int	config_huge_pages			= 0;
 int	CONFIG_LOG_LEVEL		= LOG_LEVEL_WARNING;
 char	*CONFIG_EXTERNALSCRIPTS		= NULL;
 int	CONFIG_ALLOW_UNSUPPORTED_DB_VERSIONS = 0;
@@ -316,6 +328,9 @@ ZBX_GET_CONFIG_VAR(int, zbx_config_log_remote_commands, 0)
 ZBX_GET_CONFIG_VAR(int, zbx_config_unsafe_user_parameters, 0)
 
 char	*zbx_config_snmptrap_file	= NULL;
+static int	config_snmptrapper_threads	= 1;
+
+static int	config_lld_worker_threads	= 1;
 
 char	*CONFIG_JAVA_GATEWAY		= NULL;
 int	CONFIG_JAVA_GATEWAY_PORT	= ZBX_DEFAULT_GATEWAY_PORT;
@@ -371,7 +386,8 @@ static	const zbx_events_funcs_t	events_cbs = {
 	.clean_events_cb		= zbx_clean_events,
 	.reset_event_recovery_cb	= zbx_reset_event_recovery,
 	.export_events_cb		= zbx_export_events,
-	.events_update_itservices_cb	= zbx_events_update_itservices
+	.events_update_itservices_cb	= zbx_events_update_itservices,
+	.events_update_problem_cache_cb	= zbx_events_update_problem_cache
 };
 
 int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num);
@@ -692,6 +708,20 @@ static void	zbx_validate_config(ZBX_TASK_EX *task)
 		err = 1;
 	}
 
+	if (0 != config_proxy_config_cache_size && 128 * ZBX_KIBIBYTE > config_proxy_config_cache_size)
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "\"ProxyConfigCacheSize\" configuration parameter must be either 0"
+				" or greater than 128KB");
+		err = 1;
+	}
+
+	if (0 != config_problem_cache_size && 128 * ZBX_KIBIBYTE > config_problem_cache_size)
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "\"ProblemCacheSize\" configuration parameter must be either 0"
+				" or greater than 128KB");
+		err = 1;
+	}
+
 	if (NULL != zbx_config_source_ip && SUCCEED != zbx_is_supported_ip(zbx_config_source_ip))
 	{
 		zabbix_log(LOG_LEVEL_CRIT, "invalid \"SourceIP\" configuration parameter: '%s'", zbx_config_source_ip);
@@ -835,8 +865,10 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	0,			0},
 		{"StartSNMPTrapper",		&CONFIG_FORKS[ZBX_PROCESS_TYPE_SNMPTRAPPER],		TYPE_INT,
 			PARM_OPT,	0,			1},
+		{"SNMPTrapperThreads",		&config_snmptrapper_threads,		TYPE_INT,
+			PARM_OPT,	1,			64},
 		{"CacheSize",			&config_conf_cache_size,		TYPE_UINT64,
-			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(64) * ZBX_GIBIBYTE},
+			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(32) * ZBX_GIBIBYTE},
 		{"HistoryCacheSize",		&config_history_cache_size,		TYPE_UINT64,
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"HistoryIndexCacheSize",	&config_history_index_cache_size,	TYPE_UINT64,
@@ -845,8 +877,16 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	128 * ZBX_KIBIBYTE,	__UINT64_C(2) * ZBX_GIBIBYTE},
 		{"TrendFunctionCacheSize",	&CONFIG_TREND_FUNC_CACHE_SIZE,		TYPE_UINT64,
 			PARM_OPT,	0,			__UINT64_C(2) * ZBX_GIBIBYTE},
+		{"TrendRollups",		&config_trend_rollups,			TYPE_INT,
+			PARM_OPT,	0,			1},
+		{"ProxyConfigCacheSize",	&config_proxy_config_cache_size,	TYPE_UINT64,
+			PARM_OPT,	0,			__UINT64_C(2) * ZBX_GIBIBYTE},
+		{"ProblemCacheSize",		&config_problem_cache_size,		TYPE_UINT64,
+			PARM_OPT,	0,			__UINT64_C(64) * ZBX_GIBIBYTE},
 		{"ValueCacheSize",		&config_value_cache_size,		TYPE_UINT64,
 			PARM_OPT,	0,			__UINT64_C(64) * ZBX_GIBIBYTE},
+		{"HugePages",			&config_huge_pages,			TYPE_INT,
+			PARM_OPT,	0,			1},
 		{"CacheUpdateFrequency",	&CONFIG_CONFSYNCER_FREQUENCY,		TYPE_INT,
 			PARM_OPT,	1,			SEC_PER_HOUR},
 		{"HousekeepingFrequency",	&config_housekeeping_frequency,		TYPE_INT,
@@ -1003,6 +1043,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	ZBX_MEBIBYTE,	ZBX_GIBIBYTE},
 		{"StartLLDProcessors",		&CONFIG_FORKS[ZBX_PROCESS_TYPE_LLDWORKER],		TYPE_INT,
 			PARM_OPT,	1,			100},
+		{"LLDWorkerThreads",		&config_lld_worker_threads,		TYPE_INT,
+			PARM_OPT,	1,			32},
 		{"StatsAllowedIP",		&CONFIG_STATS_ALLOWED_IP,		TYPE_STRING_LIST,
 			PARM_OPT,	0,			0},
 		{"StartHistoryPollers",		&CONFIG_FORKS[ZBX_PROCESS_TYPE_HISTORYPOLLER],		TYPE_INT,
@@ -1033,6 +1075,8 @@ static void	zbx_load_config(ZBX_TASK_EX *task)
 			PARM_OPT,	0,			1000},
 		{"MaxConcurrentChecksPerPoller",	&config_max_concurrent_checks_per_poller,	TYPE_INT,
 			PARM_OPT,	1,			1000},
+		{"MaxConcurrentAlertsPerAlerter",	&config_max_concurrent_alerts_per_alerter,	TYPE_INT,
+			PARM_OPT,	1,			100},
 		{NULL}
 	};
 
@@ -1377,6 +1421,18 @@ static void	zbx_db_save_server_status(void)
 	zbx_json_free(&json);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove trend rollups left from the time they were enabled         *
+ *                                                                            *
+ ******************************************************************************/
+static void	zbx_db_clear_trend_rollups(void)
+{
+	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
+	zbx_trends_clear_rollups();
+	zbx_db_close();
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: initialize shared resources and start processes                   *
@@ -1416,12 +1472,13 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 	zbx_thread_housekeeper_args	housekeeper_args = {&db_version_info, zbx_config_timeout,
 							config_housekeeping_frequency, config_max_housekeeper_delete};
 	zbx_thread_server_trigger_housekeeper_args	trigger_housekeeper_args = {zbx_config_timeout,
-							config_problemhousekeeping_frequency};
+							config_problemhousekeeping_frequency, zbx_problem_cache_remove};
 	zbx_thread_taskmanager_args	taskmanager_args = {zbx_config_timeout, config_startup_time};
 	zbx_thread_dbconfig_args	dbconfig_args = {&zbx_config_vault, zbx_config_timeout,
 							config_proxyconfig_frequency, config_proxydata_frequency,
 							zbx_config_source_ip};
-	zbx_thread_alerter_args		alerter_args = {zbx_config_source_ip};
+	zbx_thread_alerter_args		alerter_args = {zbx_config_source_ip,
+							config_max_concurrent_alerts_per_alerter};
 	zbx_thread_pinger_args		pinger_args = {zbx_config_timeout};
 	zbx_thread_pp_manager_args	preproc_man_args = {
 						.workers_num = CONFIG_FORKS[ZBX_PROCESS_TYPE_PREPROCESSOR],
@@ -1435,14 +1492,15 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 	zbx_thread_report_manager_args	report_manager_args = {get_config_forks};
 	zbx_thread_alert_syncer_args	alert_syncer_args = {CONFIG_CONFSYNCER_FREQUENCY};
 	zbx_thread_alert_manager_args	alert_manager_args = {get_config_forks, get_zbx_config_alert_scripts_path,
-			zbx_config_dbhigh, zbx_config_source_ip};
+			zbx_config_dbhigh, zbx_config_source_ip, config_max_concurrent_alerts_per_alerter};
 	zbx_thread_lld_manager_args	lld_manager_args = {get_config_forks};
+	zbx_thread_lld_worker_args	lld_worker_args = {config_lld_worker_threads};
 	zbx_thread_connector_manager_args	connector_manager_args = {get_config_forks};
 	zbx_thread_dbsyncer_args		dbsyncer_args = {&events_cbs, config_histsyncer_frequency};
 	zbx_thread_vmware_args			vmware_args = {zbx_config_source_ip, config_vmware_frequency,
 								config_vmware_perf_frequency, config_vmware_timeout};
 	zbx_thread_timer_args		timer_args = {get_config_forks};
-	zbx_thread_snmptrapper_args	snmptrapper_args = {zbx_config_snmptrap_file};
+	zbx_thread_snmptrapper_args	snmptrapper_args = {zbx_config_snmptrap_file, config_snmptrapper_threads};
 
 	if (SUCCEED != zbx_init_database_cache(get_program_type, zbx_sync_server_history, config_history_cache_size,
 			config_history_index_cache_size, &config_trends_cache_size, &error))
@@ -1487,6 +1545,22 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 		return FAIL;
 	}
 
+	zbx_trends_rollups_init(config_trend_rollups);
+
+	if (SUCCEED != zbx_pcc_init(config_proxy_config_cache_size, &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize proxy configuration cache: %s", error);
+		zbx_free(error);
+		return FAIL;
+	}
+
+	if (SUCCEED != zbx_problem_cache_init(config_problem_cache_size, &error))
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "cannot initialize problem cache: %s", error);
+		zbx_free(error);
+		return FAIL;
+	}
+
 	if (0 != CONFIG_FORKS[ZBX_PROCESS_TYPE_CONNECTORMANAGER])
 		zbx_connector_init();
 
@@ -1585,6 +1659,9 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 				/* update maintenance states */
 				zbx_dc_update_maintenances();
 
+				/* load open problems before starting processes that generate or close them */
+				zbx_problem_cache_load();
+
 				zbx_db_close();
 				break;
 			case ZBX_PROCESS_TYPE_POLLER:
@@ -1682,6 +1759,7 @@ static int	server_startup(zbx_socket_t *listen_sock, int *ha_stat, int *ha_failo
 				zbx_thread_start(lld_manager_thread, &thread_args, &threads[i]);
 				break;
 			case ZBX_PROCESS_TYPE_LLDWORKER:
+				thread_args.args = &lld_worker_args;
 				zbx_thread_start(lld_worker_thread, &thread_args, &threads[i]);
 				break;
 			case ZBX_PROCESS_TYPE_ALERTSYNCER:
@@ -1824,6 +1902,8 @@ static void	server_teardown(zbx_rtc_t *rtc, zbx_socket_t *listen_sock)
 		zbx_tcp_unlisten(listen_sock);
 
 	/* destroy shared caches */
+	zbx_problem_cache_destroy();
+	zbx_pcc_destroy();
 	zbx_tfc_destroy();
 	zbx_vc_destroy();
 	zbx_vmware_destroy();
@@ -2071,6 +2151,8 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 		exit(EXIT_FAILURE);
 	}
 
+	zbx_shmem_set_huge_pages(config_huge_pages);
+
 	if (SUCCEED != zbx_init_database_cache(get_program_type, zbx_sync_server_history, config_history_cache_size,
 			config_history_index_cache_size, &config_trends_cache_size, &error))
 	{
@@ -2083,6 +2165,9 @@ int	MAIN_ZABBIX_ENTRY(int flags)
 	zbx_check_db();
 	zbx_db_save_server_status();
 
+	if (0 == config_trend_rollups)
+		zbx_db_clear_trend_rollups();
+
 	if (SUCCEED != zbx_db_check_instanceid())
 		exit(EXIT_FAILURE);
 
@@ -90,6 +90,28 @@ typedef struct
 }
 zbx_services_diff_t;
 
+#define ZBX_SERVICE_LEVEL_UNKNOWN	-1
+#define ZBX_SERVICE_LEVEL_PENDING	-2
+
+/* service queued for status recalculation */
+typedef struct
+{
+	zbx_uint64_t	serviceid;
+	zbx_service_t	*service;
+	zbx_timespec_t	ts;
+	int		flags;
+	int		processed;
+}
+zbx_service_dirty_t;
+
+/* services queued for status recalculation, ordered by their topological level */
+typedef struct
+{
+	zbx_binary_heap_t	heap;
+	zbx_hashset_t		services;
+}
+zbx_service_queue_t;
+
 /* preprocessing manager data */
 typedef struct
 {
@@ -1259,6 +1281,86 @@ int	service_get_status(const zbx_service_t	*service, int *status)
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get index of the status in service children statistics            *
+ *                                                                            *
+ ******************************************************************************/
+static int	service_status_index(int status)
+{
+	if (ZBX_SERVICE_STATUS_OK >= status)
+		return 0;
+
+	if (TRIGGER_SEVERITY_COUNT <= status)
+		return ZBX_SERVICE_STATUS_NUM - 1;
+
+	return status - ZBX_SERVICE_STATUS_OK;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add or remove child propagated status to/from parent service      *
+ *          children statistics                                               *
+ *                                                                            *
+ * Parameters: parent - [IN] the parent service                               *
+ *             child  - [IN] the child service                                *
+ *             sign   - [IN] 1 - add child, -1 - remove child                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	service_add_child_stats(zbx_service_t *parent, const zbx_service_t *child, int sign)
+{
+	int	status, index;
+
+	if (SUCCEED != service_get_status(child, &status))
+		return;
+
+	index = service_status_index(status);
+	parent->children_num[index] += sign;
+	parent->children_weight[index] += sign * child->weight;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: recalculate service children statistics                           *
+ *                                                                            *
+ * Parameters: service - [IN] the service                                     *
+ *                                                                            *
+ ******************************************************************************/
+void	service_update_children_stats(zbx_service_t *service)
+{
+	int	i;
+
+	memset(service->children_num, 0, sizeof(service->children_num));
+	memset(service->children_weight, 0, sizeof(service->children_weight));
+
+	for (i = 0; i < service->children.values_num; i++)
+		service_add_child_stats(service, (zbx_service_t *)service->children.values[i], 1);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: set service status and update parent children statistics         *
+ *                                                                            *
+ * Parameters: service - [IN] the service                                     *
+ *             status  - [IN] the new status                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	service_set_status(zbx_service_t *service, int status)
+{
+	int	i;
+
+	if (service->status == status)
+		return;
+
+	for (i = 0; i < service->parents.values_num; i++)
+		service_add_child_stats((zbx_service_t *)service->parents.values[i], service, -1);
+
+	service->status = status;
+
+	for (i = 0; i < service->parents.values_num; i++)
+		service_add_child_stats((zbx_service_t *)service->parents.values[i], service, 1);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: adds an update to the queue                                       *
@@ -1299,7 +1401,7 @@ static zbx_service_update_t	*update_service(zbx_hashset_t *service_updates, zbx_
 	}
 
 	update->ts = *ts;
-	service->status = status;
+	service_set_status(service, status);
 
 	return update;
 }
@@ -1519,38 +1621,19 @@ out:
  ******************************************************************************/
 int	service_get_main_status(const zbx_service_t *service)
 {
-	int	status = ZBX_SERVICE_STATUS_OK, child_status, i;
+	int	i;
 
 	switch (service->algorithm)
 	{
 		case ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ALL:
-			for (i = 0; i < service->children.values_num; i++)
-			{
-				zbx_service_t	*child = (zbx_service_t *)service->children.values[i];
-
-				if (SUCCEED != service_get_status(child, &child_status))
-					continue;
-
-				if (ZBX_SERVICE_STATUS_OK == child_status)
-				{
-					status = child_status;
-					break;
-				}
-
-				if (status < child_status)
-					status = child_status;
-			}
-			break;
+			if (0 != service->children_num[service_status_index(ZBX_SERVICE_STATUS_OK)])
+				return ZBX_SERVICE_STATUS_OK;
+			ZBX_FALLTHROUGH;
 		case ZBX_SERVICE_STATUS_CALC_MOST_CRITICAL_ONE:
-			for (i = 0; i < service->children.values_num; i++)
+			for (i = ZBX_SERVICE_STATUS_NUM - 1; 0 < i; i--)
 			{
-				zbx_service_t	*child = (zbx_service_t *)service->children.values[i];
-
-				if (SUCCEED != service_get_status(child, &child_status))
-					continue;
-
-				if (status < child_status)
-					status = child_status;
+				if (0 != service->children_num[i])
+					return i + ZBX_SERVICE_STATUS_OK;
 			}
 			break;
 		case ZBX_SERVICE_STATUS_CALC_SET_OK:
@@ -1561,7 +1644,7 @@ int	service_get_main_status(const zbx_service_t *service)
 			break;
 	}
 
-	return status;
+	return ZBX_SERVICE_STATUS_OK;
 }
 
 /******************************************************************************
@@ -1598,25 +1681,6 @@ static void	service_get_children_by_status(const zbx_service_t *service, int sta
 	}
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: get total weight of all specified services                        *
- *                                                                            *
- ******************************************************************************/
-static int	services_get_weight(const zbx_vector_ptr_t *services)
-{
-	int	i, weight = 0;
-
-	for (i = 0; i < services->values_num; i++)
-	{
-		zbx_service_t	*service = (zbx_service_t *)services->values[i];
-
-		weight += service->weight;
-	}
-
-	return weight;
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: get service status according to the specified rule                *
@@ -1629,14 +1693,12 @@ static int	services_get_weight(const zbx_vector_ptr_t *services)
  ******************************************************************************/
 int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule_t *rule)
 {
-	zbx_vector_ptr_t	children;
-	int			status = ZBX_SERVICE_STATUS_OK, status_limit, total_num, total_weight, weight;
+	int	status = ZBX_SERVICE_STATUS_OK, status_limit, total_num = 0, total_weight = 0, num = 0, weight = 0,
+		i;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() service:" ZBX_FS_UI64 ", rule:" ZBX_FS_UI64, __func__, service->serviceid,
 			rule->service_ruleid);
 
-	zbx_vector_ptr_create(&children);
-
 	switch (rule->type)
 	{
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_GE:
@@ -1656,43 +1718,50 @@ int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule
 			goto out;
 	}
 
-	service_get_children_by_status(service, status_limit, &children, &total_weight, &total_num);
+	/* count children with status greater or equal to the limit from children statistics */
+	for (i = 0; i < ZBX_SERVICE_STATUS_NUM; i++)
+	{
+		total_num += service->children_num[i];
+		total_weight += service->children_weight[i];
+
+		if (i + ZBX_SERVICE_STATUS_OK >= status_limit)
+		{
+			num += service->children_num[i];
+			weight += service->children_weight[i];
+		}
+	}
 
 	switch (rule->type)
 	{
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_GE:
-			if (children.values_num < rule->limit_value)
+			if (num < rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_NP_GE:
-			if (0 == total_num || children.values_num * 100 / total_num < rule->limit_value)
+			if (0 == total_num || num * 100 / total_num < rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_N_L:
-			if (total_num - children.values_num >= rule->limit_value)
+			if (total_num - num >= rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_NP_L:
-			if (0 == total_num || (total_num - children.values_num) * 100 / total_num >= rule->limit_value)
+			if (0 == total_num || (total_num - num) * 100 / total_num >= rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_W_GE:
-			weight = services_get_weight(&children);
 			if (weight < rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_WP_GE:
-			weight = services_get_weight(&children);
 			if (0 == total_weight || weight * 100 / total_weight < rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_W_L:
-			weight = services_get_weight(&children);
 			if (total_weight - weight >= rule->limit_value)
 				goto out;
 			break;
 		case ZBX_SERVICE_STATUS_RULE_TYPE_WP_L:
-			weight = services_get_weight(&children);
 			if (0 == total_weight || (total_weight - weight) * 100 / total_weight >= rule->limit_value)
 				goto out;
 			break;
@@ -1703,8 +1772,6 @@ int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule
 
 	status = rule->new_status;
 out:
-	zbx_vector_ptr_destroy(&children);
-
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() status:%d", __func__, status);
 
 	return status;
@@ -1921,22 +1988,26 @@ void	service_get_rootcause_eventids(const zbx_service_t *parent, zbx_vector_uint
 
 /******************************************************************************
  *                                                                            *
- * Purpose: updates service and its parents statuses                          *
+ * Purpose: updates service status                                            *
  *                                                                            *
- * Parameters: service    - [IN] the service to update                        *
- *             ts         - [IN] the update timestamp                         *
- *             alarms     - [OUT] the alarms update queue                     *
+ * Parameters: itservice       - [IN] the service to update                   *
+ *             ts              - [IN] the update timestamp                    *
+ *             alarms          - [OUT] the alarms update queue                *
+ *             service_updates - [OUT] the service updates                    *
+ *                                                                            *
+ * Return value: SUCCEED - the service status was changed                     *
+ *               FAIL    - otherwise                                          *
  *                                                                            *
  * Comments: This function recalculates service status according to the       *
- *           algorithm and status of the children services. If the status     *
- *           has been changed, an alarm is generated and parent services      *
- *           (up until the root service) are updated too.                     *
+ *           algorithm and status of the children services. Parent services   *
+ *           are updated by the caller through service update queue.          *
  *                                                                            *
  ******************************************************************************/
-static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_timespec_t *ts,
-		zbx_vector_ptr_t *alarms, zbx_hashset_t *service_updates, int flags)
+static int	its_itservice_update_status(zbx_service_t *itservice, const zbx_timespec_t *ts,
+		zbx_vector_ptr_t *alarms, zbx_hashset_t *service_updates)
 {
-	int	status, rule_status, i;
+	int			status, rule_status, i;
+	zbx_service_update_t	*update;
 
 	status = service_get_main_status(itservice);
 
@@ -1948,31 +2019,191 @@ static void	its_itservice_update_status(zbx_service_t *itservice, const zbx_time
 			status = rule_status;
 	}
 
-	if (itservice->status != status)
+	if (itservice->status == status)
+		return FAIL;
+
+	update = update_service(service_updates, itservice, status, ts);
+	update->alarm = its_updates_append(alarms, itservice->serviceid, status, ts->sec);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compare queued services by their topological level                *
+ *                                                                            *
+ ******************************************************************************/
+static int	service_queue_compare(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+	const zbx_service_dirty_t	*s1 = (const zbx_service_dirty_t *)e1->data;
+	const zbx_service_dirty_t	*s2 = (const zbx_service_dirty_t *)e2->data;
+
+	ZBX_RETURN_IF_NOT_EQUAL(s1->service->level, s2->service->level);
+	ZBX_RETURN_IF_NOT_EQUAL(s1->serviceid, s2->serviceid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize service update queue                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	service_queue_init(zbx_service_queue_t *queue)
+{
+	zbx_binary_heap_create(&queue->heap, service_queue_compare, ZBX_BINARY_HEAP_OPTION_EMPTY);
+	zbx_hashset_create(&queue->services, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+}
+
+static void	service_queue_destroy(zbx_service_queue_t *queue)
+{
+	zbx_binary_heap_destroy(&queue->heap);
+	zbx_hashset_destroy(&queue->services);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: mark parent services for status recalculation                     *
+ *                                                                            *
+ * Parameters: queue   - [IN/OUT] the service update queue                    *
+ *             service - [IN] the service with changed status                 *
+ *             ts      - [IN] the status change timestamp                     *
+ *             flags   - [IN] the update flags                                *
+ *                                                                            *
+ * Comments: Each service is queued only once per update batch, the latest    *
+ *           timestamp and combined flags of all changed children are kept.   *
+ *                                                                            *
+ ******************************************************************************/
+static void	service_queue_parents(zbx_service_queue_t *queue, const zbx_service_t *service,
+		const zbx_timespec_t *ts, int flags)
+{
+	int	i;
+
+	for (i = 0; i < service->parents.values_num; i++)
 	{
-		zbx_service_update_t	*update;
+		zbx_service_t		*parent = (zbx_service_t *)service->parents.values[i];
+		zbx_service_dirty_t	dirty_local, *dirty;
+		zbx_binary_heap_elem_t	elem;
 
-		update = update_service(service_updates, itservice, status, ts);
-		update->alarm = its_updates_append(alarms, itservice->serviceid, status, ts->sec);
+		dirty_local.serviceid = parent->serviceid;
 
-		/* update parent services */
-		for (i = 0; i < itservice->parents.values_num; i++)
+		if (NULL != (dirty = (zbx_service_dirty_t *)zbx_hashset_search(&queue->services, &dirty_local)))
 		{
-			its_itservice_update_status((zbx_service_t *)itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
+			/* services can be updated only once per batch, which also guards against loops */
+			if (0 != dirty->processed)
+				continue;
+
+			if (0 > zbx_timespec_compare(&dirty->ts, ts))
+				dirty->ts = *ts;
+
+			dirty->flags |= flags;
+			continue;
 		}
+
+		dirty_local.service = parent;
+		dirty_local.ts = *ts;
+		dirty_local.flags = flags;
+		dirty_local.processed = 0;
+
+		dirty = (zbx_service_dirty_t *)zbx_hashset_insert(&queue->services, &dirty_local, sizeof(dirty_local));
+
+		elem.key = parent->serviceid;
+		elem.data = (void *)dirty;
+		zbx_binary_heap_insert(&queue->heap, &elem);
 	}
-	else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & flags))
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: recalculate statuses of queued services                           *
+ *                                                                            *
+ * Parameters: queue           - [IN/OUT] the service update queue            *
+ *             alarms          - [OUT] the alarms update queue                *
+ *             service_updates - [OUT] the service updates                    *
+ *                                                                            *
+ * Comments: Services are processed in the order of their topological level,  *
+ *           so each service is recalculated once after all of its children   *
+ *           are updated.                                                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	service_queue_flush(zbx_service_queue_t *queue, zbx_vector_ptr_t *alarms,
+		zbx_hashset_t *service_updates)
+{
+	while (SUCCEED != zbx_binary_heap_empty(&queue->heap))
 	{
-		/* update parent services */
-		for (i = 0; i < itservice->parents.values_num; i++)
+		zbx_binary_heap_elem_t	*elem;
+		zbx_service_dirty_t	*dirty;
+
+		elem = zbx_binary_heap_find_min(&queue->heap);
+		dirty = (zbx_service_dirty_t *)elem->data;
+		zbx_binary_heap_remove_min(&queue->heap);
+
+		dirty->processed = 1;
+
+		if (SUCCEED == its_itservice_update_status(dirty->service, &dirty->ts, alarms, service_updates) ||
+				0 != (ZBX_FLAG_SERVICE_RECALCULATE & dirty->flags))
 		{
-			its_itservice_update_status((zbx_service_t *)itservice->parents.values[i], ts, alarms,
-					service_updates, flags);
+			service_queue_parents(queue, dirty->service, &dirty->ts, dirty->flags);
 		}
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculate service topological level                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	service_calculate_level(zbx_service_t *service)
+{
+	int	i, level = 0, child_level;
+
+	if (0 <= service->level)
+		return service->level;
+
+	/* circular references are not allowed, but avoid infinite recursion just in case */
+	if (ZBX_SERVICE_LEVEL_PENDING == service->level)
+		return 0;
+
+	service->level = ZBX_SERVICE_LEVEL_PENDING;
+
+	for (i = 0; i < service->children.values_num; i++)
+	{
+		if (level < (child_level = service_calculate_level((zbx_service_t *)service->children.values[i]) + 1))
+			level = child_level;
+	}
+
+	return service->level = level;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: update service topological levels and children statistics after  *
+ *          configuration sync                                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	services_update_topology(zbx_service_manager_t *service_manager)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_service_t		*service;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
+
+	zbx_hashset_iter_reset(&service_manager->services, &iter);
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+		service->level = ZBX_SERVICE_LEVEL_UNKNOWN;
+
+	zbx_hashset_iter_reset(&service_manager->services, &iter);
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+	{
+		service_calculate_level(service);
+		service_update_children_stats(service);
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
+}
+
 static char	*service_get_event_name(zbx_service_manager_t *manager, const char *name, int status)
 {
 	const char	*severity;
@@ -2487,6 +2718,7 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	zbx_vector_ptr_t	alarms, service_problems_new;
 	zbx_vector_uint64_t	service_problemids;
 	zbx_hashset_t		service_updates;
+	zbx_service_queue_t	queue;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -2494,6 +2726,7 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	zbx_vector_ptr_create(&service_problems_new);
 	zbx_vector_uint64_create(&service_problemids);
 	zbx_hashset_create(&service_updates, 100, service_update_hash_func, service_update_compare_func);
+	service_queue_init(&queue);
 
 	zbx_hashset_iter_reset(&manager->service_diffs, &iter);
 	while (NULL != (service_diff = (zbx_services_diff_t *)zbx_hashset_iter_next(&iter)))
@@ -2591,24 +2824,15 @@ static void	db_update_services(zbx_service_manager_t *manager)
 			update = update_service(&service_updates, service, status, &ts);
 			update->alarm = its_updates_append(&alarms, service->serviceid, service->status, ts.sec);
 
-			/* update parent services */
-			for (i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
+			service_queue_parents(&queue, service, &ts, service_diff->flags);
 		}
 		else if (0 != (ZBX_FLAG_SERVICE_RECALCULATE & service_diff->flags))
-		{
-			/* update parent services */
-			for (i = 0; i < service->parents.values_num; i++)
-			{
-				its_itservice_update_status((zbx_service_t *)service->parents.values[i], &ts, &alarms,
-						&service_updates, service_diff->flags);
-			}
-		}
+			service_queue_parents(&queue, service, &ts, service_diff->flags);
 	}
 
+	/* update parent services */
+	service_queue_flush(&queue, &alarms, &service_updates);
+
 	do
 	{
 		zbx_db_begin();
@@ -2619,6 +2843,7 @@ static void	db_update_services(zbx_service_manager_t *manager)
 	}
 	while (ZBX_DB_DOWN == zbx_db_commit());
 
+	service_queue_destroy(&queue);
 	zbx_vector_uint64_destroy(&service_problemids);
 	zbx_vector_ptr_destroy(&service_problems_new);
 	zbx_hashset_destroy(&service_updates);
@@ -3356,6 +3581,9 @@ ZBX_THREAD_ENTRY(service_manager_thread, args)
 			}
 			while (ZBX_DB_DOWN == zbx_db_commit());
 
+			/* service links are rebuilt during every sync */
+			services_update_topology(&service_manager);
+
 			if (0 != updated)
 				recalculate_services(&service_manager);
 
@@ -19,12 +19,16 @@
 
 #include "zbxalgo.h"
 #include "zbxtime.h"
+#include "zbx_trigger_constants.h"
 
 #ifndef ZABBIX_SERVICE_MANAGER_IMPL_H
 #define ZABBIX_SERVICE_MANAGER_IMPL_H
 
 #define ZBX_SERVICE_STATUS_OK		-1
 
+/* number of possible service statuses - OK and trigger severities */
+#define ZBX_SERVICE_STATUS_NUM		(TRIGGER_SEVERITY_COUNT + 1)
+
 #define ZBX_SERVICE_STATUS_PROPAGATION_AS_IS	0
 #define ZBX_SERVICE_STATUS_PROPAGATION_INCREASE	1
 #define ZBX_SERVICE_STATUS_PROPAGATION_DECREASE	2
@@ -87,6 +91,14 @@ typedef struct
 	int			weight;
 	int			propagation_rule;
 	int			propagation_value;
+
+	/* the topological level - 0 for services without children, otherwise 1 + highest child level */
+	int			level;
+
+	/* number and weight of not ignored children per their propagated status, indexed by */
+	/* status - ZBX_SERVICE_STATUS_OK                                                    */
+	int			children_num[ZBX_SERVICE_STATUS_NUM];
+	int			children_weight[ZBX_SERVICE_STATUS_NUM];
 }
 zbx_service_t;
 
@@ -142,6 +154,8 @@ typedef struct
 zbx_service_action_condition_t;
 
 int	service_get_status(const zbx_service_t	*service, int *status);
+void	service_set_status(zbx_service_t *service, int status);
+void	service_update_children_stats(zbx_service_t *service);
 int	service_get_main_status(const zbx_service_t *service);
 int	service_get_rule_status(const zbx_service_t *service, const zbx_service_rule_t *rule);
 void	service_get_rootcause_eventids(const zbx_service_t *parent, zbx_vector_uint64_t *eventids);
@@ -84,6 +84,7 @@ void	zbx_server_stats_ext_get(struct zbx_json *json, const void *arg)
 		zbx_json_adduint64(json, "used", vc_stats.total_size - vc_stats.free_size);
 		zbx_json_addfloat(json, "pused", (double)(vc_stats.total_size - vc_stats.free_size) /
 				vc_stats.total_size * 100);
+		zbx_json_addint64(json, "hugepages", vc_stats.huge_pages);
 		zbx_json_close(json);
 
 		zbx_json_addobject(json, "cache");
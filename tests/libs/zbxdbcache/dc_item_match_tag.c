@@ -0,0 +1,174 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcacheconfig.h"
+#include "dbconfig.h"
+#include "dc_item_match_tag_test.h"
+
+static void	mock_read_host_tags(ZBX_DC_CONFIG *cache, zbx_vector_ptr_t *host_tags)
+{
+	zbx_mock_handle_t	hhosts, hhost, htags, htag;
+	zbx_mock_error_t	err;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter_exists("in.hosts"))
+		return;
+
+	hhosts = zbx_mock_get_parameter_handle("in.hosts");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hhosts, &hhost))))
+	{
+		zbx_dc_host_tag_index_t	index_local, *index;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("Cannot read host: %s", zbx_mock_error_string(err));
+
+		index_local.hostid = zbx_mock_get_object_member_uint64(hhost, "hostid");
+		index = (zbx_dc_host_tag_index_t *)zbx_hashset_insert(&cache->host_tags_index, &index_local,
+				sizeof(index_local));
+		zbx_vector_ptr_create(&index->tags);
+
+		htags = zbx_mock_get_object_member_handle(hhost, "tags");
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(htags, &htag))))
+		{
+			zbx_dc_host_tag_t	*tag;
+
+			if (ZBX_MOCK_SUCCESS != err)
+				fail_msg("Cannot read host tag: %s", zbx_mock_error_string(err));
+
+			tag = (zbx_dc_host_tag_t *)zbx_malloc(NULL, sizeof(zbx_dc_host_tag_t));
+			tag->hostid = index->hostid;
+			tag->tag = zbx_mock_get_object_member_string(htag, "tag");
+			tag->value = zbx_mock_get_object_member_string(htag, "value");
+
+			zbx_vector_ptr_append(&index->tags, tag);
+			zbx_vector_ptr_append(host_tags, tag);
+		}
+	}
+}
+
+static void	mock_read_template_items(zbx_hashset_t *items, const char *path)
+{
+	zbx_mock_handle_t	hitems, hitem;
+	zbx_mock_error_t	err;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter_exists(path))
+		return;
+
+	hitems = zbx_mock_get_parameter_handle(path);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hitems, &hitem))))
+	{
+		ZBX_DC_TEMPLATE_ITEM	item_local;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("Cannot read template item: %s", zbx_mock_error_string(err));
+
+		item_local.itemid = zbx_mock_get_object_member_uint64(hitem, "itemid");
+		item_local.hostid = zbx_mock_get_object_member_uint64(hitem, "hostid");
+		item_local.templateid = zbx_mock_get_object_member_uint64(hitem, "templateid");
+
+		zbx_hashset_insert(items, &item_local, sizeof(item_local));
+	}
+}
+
+static zbx_dc_item_tag_t	**mock_read_item_tags(zbx_mock_handle_t hitem)
+{
+	zbx_mock_handle_t	htags, htag;
+	zbx_mock_error_t	err;
+	zbx_dc_item_tag_t	**tags = NULL;
+	int			tags_num = 0;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_object_member(hitem, "tags", &htags))
+		return NULL;
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(htags, &htag))))
+	{
+		zbx_dc_item_tag_t	*tag;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("Cannot read item tag: %s", zbx_mock_error_string(err));
+
+		tag = (zbx_dc_item_tag_t *)zbx_malloc(NULL, sizeof(zbx_dc_item_tag_t));
+		tag->tag = zbx_mock_get_object_member_string(htag, "tag");
+		tag->value = zbx_mock_get_object_member_string(htag, "value");
+
+		tags = (zbx_dc_item_tag_t **)zbx_realloc(tags, sizeof(zbx_dc_item_tag_t *) * (size_t)(tags_num + 2));
+		tags[tags_num++] = tag;
+		tags[tags_num] = NULL;
+	}
+
+	return tags;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	ZBX_DC_CONFIG		*cache;
+	ZBX_DC_ITEM		item = {0};
+	zbx_mock_handle_t	hitem;
+	zbx_vector_ptr_t	host_tags;
+	int			returned_ret, expected_ret;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_ptr_create(&host_tags);
+
+	cache = init_test_item_tags_cache();
+
+	mock_read_host_tags(cache, &host_tags);
+	mock_read_template_items(&cache->template_items, "in.template_items");
+	mock_read_template_items(&cache->prototype_items, "in.prototype_items");
+
+	hitem = zbx_mock_get_parameter_handle("in.item");
+	item.itemid = zbx_mock_get_object_member_uint64(hitem, "itemid");
+	item.hostid = zbx_mock_get_object_member_uint64(hitem, "hostid");
+	item.templateid = zbx_mock_get_object_member_uint64(hitem, "templateid");
+	item.tags = mock_read_item_tags(hitem);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.item.parent_itemid"))
+	{
+		ZBX_DC_ITEM_DISCOVERY	item_discovery;
+
+		item.flags = ZBX_FLAG_DISCOVERY_CREATED;
+		item_discovery.itemid = item.itemid;
+		item_discovery.parent_itemid = zbx_mock_get_parameter_uint64("in.item.parent_itemid");
+		zbx_hashset_insert(&cache->item_discovery, &item_discovery, sizeof(item_discovery));
+	}
+
+	returned_ret = dc_item_match_tag_test(&item, zbx_mock_get_parameter_string("in.tag"));
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return"));
+	zbx_mock_assert_result_eq("dc_item_match_tag() return value", expected_ret, returned_ret);
+
+	if (NULL != item.tags)
+	{
+		for (int i = 0; NULL != item.tags[i]; i++)
+			zbx_free(item.tags[i]);
+
+		zbx_free(item.tags);
+	}
+
+	zbx_vector_ptr_clear_ext(&host_tags, zbx_ptr_free);
+	zbx_vector_ptr_destroy(&host_tags);
+}
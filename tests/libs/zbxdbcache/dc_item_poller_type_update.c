@@ -223,7 +223,7 @@ void	zbx_mock_test_entry(void **state)
 		memset((void*)&item, 0, sizeof(item));
 
 		item.type = test_config.type;
-		item.key = test_config.key;
+		item.key = dc_strarena_intern(test_config.key, ZBX_DC_STR_KEY);
 		item.poller_type = test_config.poller_type;
 		item.itemid = 1;
 
@@ -270,5 +270,7 @@ void	zbx_mock_test_entry(void **state)
 		DCitem_poller_type_update_test(&item, &host, test_config.flags);
 
 		zbx_mock_assert_int_eq(buffer, test_config.result_poller_type, item.poller_type);
+
+		dc_strarena_release(item.key);
 	}
 }
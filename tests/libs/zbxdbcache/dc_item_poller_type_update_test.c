@@ -26,7 +26,19 @@ void	DCitem_poller_type_update_test(ZBX_DC_ITEM *dc_item, const ZBX_DC_HOST *dc_
 
 void	init_test_configuration_cache(zbx_get_config_forks_f get_config_forks)
 {
+	char	*error = NULL;
+
 	get_config_forks_cb = get_config_forks;
+
+	/* item keys are referenced by offsets in configuration cache shared memory */
+	if (SUCCEED != zbx_shmem_create(&config_mem, ZBX_MEBIBYTE, "configuration cache", "CacheSize", 0, &error))
+	{
+		printf("cannot create configuration cache: %s\n", error);
+		exit(EXIT_FAILURE);
+	}
+
 	config = (ZBX_DC_CONFIG *)zbx_malloc(NULL, sizeof(ZBX_DC_CONFIG));
 	zbx_hashset_create(&config->snmpitems, 1, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_hashset_create_ext(&config->strarena, 0, __config_strarena_hash, __config_strarena_compare, NULL,
+			__config_shmem_malloc_func, __config_shmem_realloc_func, __config_shmem_free_func);
 }
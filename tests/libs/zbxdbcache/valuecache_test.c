@@ -62,7 +62,7 @@ int	zbx_vc_precache_values(zbx_uint64_t itemid, int value_type, int seconds, int
 	/* perform request to cache values */
 	zbx_history_record_vector_create(&values);
 	RDLOCK_CACHE;
-	ret = vch_item_get_values(item, &values, seconds, count, ts);
+	ret = vch_item_get_values(item, &values, seconds, count, ts, 1);
 	UNLOCK_CACHE;
 	zbx_vc_flush_stats();
 	zbx_history_record_vector_destroy(&values, value_type);
@@ -104,3 +104,16 @@ int	zbx_vc_get_cache_state(int *mode, zbx_uint64_t *hits, zbx_uint64_t *misses)
 
 	return SUCCEED;
 }
+
+int	zbx_vc_get_prefetched_values(zbx_uint64_t itemid, unsigned char value_type, zbx_vector_history_record_t *values,
+		int seconds, int count, const zbx_timespec_t *ts)
+{
+	int	ret;
+
+	ret = vc_prefetch_get_values(itemid, value_type, values, seconds, count, ts);
+
+	/* discard statistics, values are accounted when requested with zbx_vc_get_values() */
+	zbx_vector_vc_itemupdate_clear(&vc_itemupdates);
+
+	return ret;
+}
@@ -0,0 +1,98 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcachevalue.h"
+#include "valuecache_test.h"
+#include "mocks/valuecache/valuecache_mock.h"
+
+#include "zbx_vc_common.h"
+
+static void	zbx_vc_test_prefetch_values_setup(zbx_mock_handle_t *handle, zbx_uint64_t *itemid,
+		unsigned char *value_type, zbx_timespec_t *ts, int *err, zbx_vector_history_record_t *expected,
+		zbx_vector_history_record_t *returned, int *seconds, int *count)
+{
+	zbx_vector_vc_prefetch_t	requests;
+	zbx_mock_handle_t		hrequests, hrequest;
+	zbx_mock_error_t		mock_err;
+
+	*handle = zbx_mock_get_parameter_handle("in.test");
+	zbx_vcmock_set_time(*handle, "time");
+	zbx_vcmock_set_mode(*handle, "cache mode");
+
+	/* prefetch values */
+
+	zbx_vector_vc_prefetch_create(&requests);
+
+	hrequests = zbx_mock_get_parameter_handle("in.prefetch");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (mock_err = (zbx_mock_vector_element(hrequests, &hrequest))))
+	{
+		zbx_vc_prefetch_t	request;
+
+		if (ZBX_MOCK_SUCCESS != mock_err)
+			fail_msg("Cannot read prefetch request: %s", zbx_mock_error_string(mock_err));
+
+		zbx_vcmock_get_request_params(hrequest, &request.itemid, &request.value_type, &request.seconds,
+				&request.count, &request.ts);
+		zbx_vector_vc_prefetch_append(&requests, request);
+	}
+
+	zbx_vc_prefetch_values(&requests);
+	zbx_vc_flush_stats();
+	zbx_vector_vc_prefetch_destroy(&requests);
+
+	/* check if the request is served from prefetched values */
+
+	zbx_vcmock_get_request_params(*handle, itemid, value_type, seconds, count, ts);
+	zbx_vcmock_read_values(zbx_mock_get_parameter_handle("out.values"), *value_type, expected);
+
+	*err = zbx_vc_get_prefetched_values(*itemid, *value_type, returned, *seconds, *count, ts);
+	zbx_mock_assert_result_eq("zbx_vc_get_prefetched_values() return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.prefetched")), *err);
+
+	if (SUCCEED == *err)
+	{
+		zbx_vcmock_check_records("Prefetched values", *value_type, expected, returned);
+		zbx_history_record_vector_clean(returned, *value_type);
+	}
+
+	/* perform request */
+
+	*err = zbx_vc_get_values(*itemid, *value_type, returned, *seconds, *count, ts);
+	zbx_vc_flush_stats();
+	zbx_mock_assert_result_eq("zbx_vc_get_values() return value", SUCCEED, *err);
+
+	zbx_vcmock_check_records("Returned values", *value_type, expected, returned);
+
+	zbx_history_record_vector_clean(returned, *value_type);
+	zbx_history_record_vector_clean(expected, *value_type);
+
+	zbx_vc_prefetch_clear();
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vc_common_test_func(state, NULL, NULL, zbx_vc_test_prefetch_values_setup, 1);
+}
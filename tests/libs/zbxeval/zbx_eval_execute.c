@@ -27,6 +27,52 @@
 #include "zbxlog.h"
 #include "mock_eval.h"
 
+/* checks that compiled expression gives the same result as the interpreted one */
+static void	mock_eval_execute_compiled(zbx_eval_context_t *ctx, const zbx_timespec_t *ts, int expected_ret,
+		const zbx_variant_t *expected_value, const char *expected_error)
+{
+	zbx_eval_context_t	ctx_compiled;
+	unsigned char		*data;
+	zbx_variant_t		value;
+	char			*error = NULL;
+	int			returned_ret;
+
+	/* compile and serialize the expression the same way as configuration cache does */
+	if (SUCCEED != zbx_eval_parse_expression(&ctx_compiled, ctx->expression, ctx->rules, &error))
+		fail_msg("failed to parse expression: %s", error);
+
+	zbx_eval_compile(&ctx_compiled);
+	zbx_eval_serialize(&ctx_compiled, NULL, &data);
+	zbx_eval_clear(&ctx_compiled);
+
+	zbx_eval_deserialize(&ctx_compiled, ctx->expression, ctx->rules, data);
+	zbx_free(data);
+
+	mock_eval_read_values(&ctx_compiled, "in.replace");
+
+	returned_ret = zbx_eval_execute(&ctx_compiled, ts, &value, &error);
+	zbx_mock_assert_result_eq("compiled return value", expected_ret, returned_ret);
+
+	if (SUCCEED == returned_ret)
+	{
+		char	*expected_desc;
+
+		zbx_mock_assert_int_eq("compiled value type", expected_value->type, value.type);
+
+		expected_desc = zbx_strdup(NULL, zbx_variant_value_desc(expected_value));
+		zbx_mock_assert_str_eq("compiled value", expected_desc, zbx_variant_value_desc(&value));
+		zbx_free(expected_desc);
+
+		zbx_variant_clear(&value);
+	}
+	else
+		zbx_mock_assert_str_eq("compiled error", expected_error, error);
+
+	zbx_free(error);
+
+	zbx_eval_clear(&ctx_compiled);
+}
+
 void	zbx_mock_test_entry(void **state)
 {
 	zbx_eval_context_t	ctx;
@@ -82,6 +128,8 @@ void	zbx_mock_test_entry(void **state)
 
 	zbx_mock_assert_result_eq("return value", expected_ret, returned_ret);
 
+	mock_eval_execute_compiled(&ctx, pts, returned_ret, &value, error);
+
 	if (SUCCEED == expected_ret)
 	{
 		/* use custom epsilon for floating point values to account for */
@@ -0,0 +1,145 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+/* benchmark of compiled versus interpreted expression execution, not a test    */
+/* suite - run it manually with test cases of zbx_eval_execute.yaml on standard */
+/* input, the same way tests_run.pl passes them to zbx_eval_execute             */
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxeval.h"
+#include "zbxtime.h"
+#include "mock_eval.h"
+
+#define MOCK_EVAL_BENCHMARK_ITERATIONS	100000
+
+static double	mock_eval_benchmark(zbx_eval_context_t *ctx, const zbx_timespec_t *ts, int expected_ret,
+		const char *expected_desc)
+{
+	double		start;
+	int		i, returned_ret;
+	zbx_variant_t	value;
+	char		*error = NULL;
+
+	start = zbx_time();
+
+	for (i = 0; i < MOCK_EVAL_BENCHMARK_ITERATIONS; i++)
+	{
+		returned_ret = zbx_eval_execute(ctx, ts, &value, &error);
+
+		if (expected_ret != returned_ret)
+			fail_msg("expected return code %d while got %d", expected_ret, returned_ret);
+
+		if (SUCCEED == returned_ret)
+		{
+			if (0 != strcmp(expected_desc, zbx_variant_value_desc(&value)))
+			{
+				fail_msg("expected value \"%s\" while got \"%s\"", expected_desc,
+						zbx_variant_value_desc(&value));
+			}
+
+			zbx_variant_clear(&value);
+		}
+		else
+			zbx_free(error);
+	}
+
+	return zbx_time() - start;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_eval_context_t	ctx, ctx_compiled;
+	char			*error = NULL, *value_desc = NULL;
+	unsigned char		*data;
+	zbx_uint64_t		rules;
+	int			ret;
+	zbx_variant_t		value;
+	zbx_mock_handle_t	htime;
+	zbx_timespec_t		ts, *pts = NULL;
+	const char		*expression;
+	double			interpreted, compiled;
+
+	ZBX_UNUSED(state);
+
+	rules = mock_eval_read_rules("in.rules");
+	expression = zbx_mock_get_parameter_string("in.expression");
+
+	if (SUCCEED != zbx_eval_parse_expression(&ctx, expression, rules, &error))
+	{
+		printf("%s: cannot parse expression: %s\n", expression, error);
+		zbx_free(error);
+		return;
+	}
+
+	mock_eval_read_values(&ctx, "in.replace");
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("in.time", &htime))
+	{
+		const char	*str;
+
+		if (ZBX_MOCK_SUCCESS != zbx_mock_string(htime, &str))
+			fail_msg("invalid in.time field");
+
+		if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(str, &ts))
+			fail_msg("Invalid in.time format");
+
+		if (0 != setenv("TZ", zbx_mock_get_parameter_string("in.timezone"), 1))
+			fail_msg("Cannot set 'TZ' environment variable: %s", zbx_strerror(errno));
+
+		pts = &ts;
+	}
+
+	/* compile and serialize the expression the same way as configuration cache does */
+	if (SUCCEED != zbx_eval_parse_expression(&ctx_compiled, expression, rules, &error))
+		fail_msg("failed to parse expression: %s", error);
+
+	zbx_eval_compile(&ctx_compiled);
+	zbx_eval_serialize(&ctx_compiled, NULL, &data);
+	zbx_eval_clear(&ctx_compiled);
+
+	zbx_eval_deserialize(&ctx_compiled, expression, rules, data);
+	zbx_free(data);
+
+	mock_eval_read_values(&ctx_compiled, "in.replace");
+
+	/* both paths must give the same result for timings to be comparable */
+	if (SUCCEED == (ret = zbx_eval_execute(&ctx, pts, &value, &error)))
+	{
+		value_desc = zbx_strdup(NULL, zbx_variant_value_desc(&value));
+		zbx_variant_clear(&value);
+	}
+	else
+		zbx_free(error);
+
+	interpreted = mock_eval_benchmark(&ctx, pts, ret, value_desc);
+	compiled = mock_eval_benchmark(&ctx_compiled, pts, ret, value_desc);
+
+	printf("%s: %d instructions, %d iterations, interpreted: " ZBX_FS_DBL " sec, compiled: " ZBX_FS_DBL
+			" sec\n", expression, ctx_compiled.program.values_num, MOCK_EVAL_BENCHMARK_ITERATIONS,
+			interpreted, compiled);
+
+	zbx_free(value_desc);
+	zbx_eval_clear(&ctx_compiled);
+	zbx_eval_clear(&ctx);
+}
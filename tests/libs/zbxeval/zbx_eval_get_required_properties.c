@@ -0,0 +1,82 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxeval.h"
+#include "zbxlog.h"
+#include "mock_eval.h"
+
+static void	compare_values(const char *path, const zbx_vector_str_t *values)
+{
+	const char		*value;
+	int			index = 0;
+	zbx_mock_handle_t	hvalues, hvalue;
+	zbx_mock_error_t	err;
+
+	hvalues = zbx_mock_get_parameter_handle(path);
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hvalues, &hvalue))))
+	{
+		if (index >= values->values_num)
+			fail_msg("got %d %s while expected more", values->values_num, path);
+
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_string(hvalue, &value)))
+			fail_msg("Cannot read %s #%d: %s", path, index, zbx_mock_error_string(err));
+
+		zbx_mock_assert_str_eq(path, value, values->values[index++]);
+	}
+
+	if (index != values->values_num)
+		fail_msg("got %d %s while expected %d", values->values_num, path, index);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_eval_context_t	ctx;
+	char			*error = NULL;
+	zbx_vector_str_t	groups, tags;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_str_create(&groups);
+	zbx_vector_str_create(&tags);
+
+	if (SUCCEED != zbx_eval_parse_expression(&ctx, zbx_mock_get_parameter_string("in.expression"),
+				ZBX_EVAL_PARSE_QUERY_EXPRESSION, &error))
+	{
+		fail_msg("failed to parse expression: %s", error);
+	}
+
+	zbx_eval_prepare_filter(&ctx);
+	zbx_eval_get_required_properties(&ctx, &groups, &tags);
+
+	compare_values("out.groups", &groups);
+	compare_values("out.tags", &tags);
+
+	zbx_vector_str_clear_ext(&tags, zbx_str_free);
+	zbx_vector_str_destroy(&tags);
+	zbx_vector_str_clear_ext(&groups, zbx_str_free);
+	zbx_vector_str_destroy(&groups);
+
+	zbx_eval_clear(&ctx);
+}
@@ -51,6 +51,28 @@ static void	check_indefinite_path_result(zbx_mock_handle_t handle, const char *r
 	zbx_mock_assert_json_eq("Indefinite query result", expected_output, returned_output);
 }
 
+static void	test_query_batch(zbx_jsonobj_t *obj, const char *path, int expected_ret, const char *expected_output)
+{
+	/* query the same path twice to check duplicate path handling */
+	zbx_jsonobj_query_t	queries[2] = {{.path = path}, {.path = path}};
+
+	zbx_jsonobj_query_batch(obj, NULL, queries, 2);
+
+	for (int i = 0; i < 2; i++)
+	{
+		zbx_mock_assert_result_eq("zbx_jsonobj_query_batch() return value", expected_ret,
+				NULL == queries[i].error ? SUCCEED : FAIL);
+
+		if (NULL == expected_output)
+			zbx_mock_assert_ptr_eq("Batch query result", NULL, queries[i].output);
+		else
+			zbx_mock_assert_str_eq("Batch query result", expected_output, queries[i].output);
+
+		zbx_free(queries[i].output);
+		zbx_free(queries[i].error);
+	}
+}
+
 static void	test_query(zbx_jsonobj_t *obj, const char *path, int expected_ret)
 {
 	char			*output = NULL;
@@ -83,6 +105,8 @@ static void	test_query(zbx_jsonobj_t *obj, const char *path, int expected_ret)
 	else
 		zbx_mock_assert_str_ne("tzbx_jsonpath_query() error", "", zbx_json_strerror());
 
+	test_query_batch(obj, path, expected_ret, output);
+
 	zbx_free(output);
 
 }
@@ -0,0 +1,199 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxregexp.h"
+
+typedef struct
+{
+	char			*pattern;
+	const zbx_regexp_t	*regexp;	/* regular expression returned when the pattern was compiled */
+}
+mock_regexp_t;
+
+static int	mock_regexp_compare(const void *d1, const void *d2)
+{
+	const mock_regexp_t	*r1 = *(const mock_regexp_t * const *)d1;
+	const mock_regexp_t	*r2 = *(const mock_regexp_t * const *)d2;
+
+	return strcmp(r1->pattern, r2->pattern);
+}
+
+static void	mock_regexp_free(void *data)
+{
+	mock_regexp_t	*regexp = (mock_regexp_t *)data;
+
+	zbx_free(regexp->pattern);
+	zbx_free(regexp);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepares pattern through the cache and checks if it was a cache   *
+ *          hit or miss                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	mock_prepare(zbx_vector_ptr_t *regexps, const char *pattern, const char *result, const char *match)
+{
+	zbx_regexp_stats_t	stats_before, stats_after;
+	const zbx_regexp_t	*regexp;
+	char			*error = NULL;
+	mock_regexp_t		regexp_local, *pregexp = &regexp_local, *mregexp;
+	int			index;
+
+	zbx_regexp_get_stats(&stats_before);
+
+	if (SUCCEED != zbx_regexp_compile_cached(pattern, &regexp, &error))
+		fail_msg("cannot compile \"%s\": %s", pattern, error);
+
+	zbx_regexp_get_stats(&stats_after);
+
+	regexp_local.pattern = (char *)pattern;
+	index = zbx_vector_ptr_search(regexps, pregexp, mock_regexp_compare);
+
+	if (0 == strcmp(result, "hit"))
+	{
+		zbx_mock_assert_uint64_eq("cache hits", stats_before.cache_hits + 1, stats_after.cache_hits);
+		zbx_mock_assert_uint64_eq("cache misses", stats_before.cache_misses, stats_after.cache_misses);
+
+		if (FAIL == index)
+			fail_msg("pattern \"%s\" was not compiled before", pattern);
+
+		mregexp = (mock_regexp_t *)regexps->values[index];
+		zbx_mock_assert_ptr_eq("cached regular expression", mregexp->regexp, regexp);
+
+		/* the regular expression returned by the first prepare must still be usable */
+		if (NULL != match)
+			zbx_mock_assert_int_eq("match result", 0, zbx_regexp_match_precompiled(match, mregexp->regexp));
+	}
+	else if (0 == strcmp(result, "miss"))
+	{
+		zbx_mock_assert_uint64_eq("cache hits", stats_before.cache_hits, stats_after.cache_hits);
+		zbx_mock_assert_uint64_eq("cache misses", stats_before.cache_misses + 1, stats_after.cache_misses);
+		zbx_mock_assert_uint64_eq("compiled", stats_before.compiled + 1, stats_after.compiled);
+
+		if (FAIL == index)
+		{
+			mregexp = (mock_regexp_t *)zbx_malloc(NULL, sizeof(mock_regexp_t));
+			mregexp->pattern = zbx_strdup(NULL, pattern);
+			zbx_vector_ptr_append(regexps, mregexp);
+		}
+		else
+			mregexp = (mock_regexp_t *)regexps->values[index];
+
+		mregexp->regexp = regexp;
+
+		if (NULL != match)
+			zbx_mock_assert_int_eq("match result", 0, zbx_regexp_match_precompiled(match, regexp));
+	}
+	else
+		fail_msg("unknown prepare result \"%s\"", result);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles pattern without cache and checks that it is neither      *
+ *          cached nor JIT compiled                                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	mock_compile_uncached(const char *pattern)
+{
+	zbx_regexp_stats_t	stats_before, stats_after;
+	zbx_regexp_t		*regexp;
+	char			*error = NULL;
+
+	zbx_regexp_get_stats(&stats_before);
+
+	if (SUCCEED != zbx_regexp_compile(pattern, &regexp, &error))
+		fail_msg("cannot compile \"%s\": %s", pattern, error);
+
+	zbx_regexp_get_stats(&stats_after);
+	zbx_regexp_free(regexp);
+
+	zbx_mock_assert_uint64_eq("compiled", stats_before.compiled + 1, stats_after.compiled);
+	zbx_mock_assert_uint64_eq("JIT compiled", stats_before.jit_compiled, stats_after.jit_compiled);
+	zbx_mock_assert_uint64_eq("cache hits", stats_before.cache_hits, stats_after.cache_hits);
+	zbx_mock_assert_uint64_eq("cache misses", stats_before.cache_misses, stats_after.cache_misses);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_mock_handle_t	hsteps, hstep, hmatch;
+	zbx_mock_error_t	err;
+	zbx_vector_ptr_t	regexps;
+	int			fill_index = 0;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_ptr_create(&regexps);
+	zbx_init_regexp_env();
+
+	hsteps = zbx_mock_get_parameter_handle("in.steps");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hsteps, &hstep))))
+	{
+		zbx_mock_handle_t	hfill;
+		const char		*pattern, *result, *match = NULL;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("Cannot read step: %s", zbx_mock_error_string(err));
+
+		/* prepare the specified number of new patterns */
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "fill", &hfill))
+		{
+			int	i, fill_num;
+			char	fill_pattern[32];
+
+			if (ZBX_MOCK_SUCCESS != (err = zbx_mock_int(hfill, &fill_num)))
+				fail_msg("Cannot read fill count: %s", zbx_mock_error_string(err));
+
+			for (i = 0; i < fill_num; i++)
+			{
+				zbx_snprintf(fill_pattern, sizeof(fill_pattern), "^fill%d$", fill_index++);
+				mock_prepare(&regexps, fill_pattern, "miss", NULL);
+			}
+
+			continue;
+		}
+
+		pattern = zbx_mock_get_object_member_string(hstep, "pattern");
+		result = zbx_mock_get_object_member_string(hstep, "result");
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hstep, "match", &hmatch) &&
+				ZBX_MOCK_SUCCESS != (err = zbx_mock_string(hmatch, &match)))
+		{
+			fail_msg("Cannot read match string: %s", zbx_mock_error_string(err));
+		}
+
+		if (0 == strcmp(result, "uncached"))
+			mock_compile_uncached(pattern);
+		else
+			mock_prepare(&regexps, pattern, result, match);
+	}
+
+	/* free the cache so that test cases do not affect each other */
+	zbx_deinit_regexp_env();
+
+	zbx_vector_ptr_clear_ext(&regexps, mock_regexp_free);
+	zbx_vector_ptr_destroy(&regexps);
+}
@@ -0,0 +1,115 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxmockdb.h"
+
+#include "zbxcommon.h"
+#include "zbxtrends.h"
+#include "zbxdb.h"
+#include "zbxdbhigh.h"
+#include "../../../src/libs/zbxtrends/trends.h"
+
+zbx_db_result_t	__wrap_zbx_db_vselect(const char *fmt, va_list args);
+zbx_db_row_t	__wrap_zbx_db_fetch_basic(zbx_db_result_t result);
+
+zbx_db_result_t	__wrap_zbx_db_select(const char *fmt, ...);
+zbx_db_row_t	__wrap_zbx_db_fetch(zbx_db_result_t result);
+void	__wrap_zbx_recalc_time_period(time_t *tm_start, int table_group);
+
+zbx_db_result_t	__wrap_zbx_db_select(const char *fmt, ...)
+{
+	va_list		args;
+	zbx_db_result_t	result;
+
+	va_start(args, fmt);
+	result = __wrap_zbx_db_vselect(fmt, args);
+	va_end(args);
+
+	return result;
+}
+
+zbx_db_row_t	__wrap_zbx_db_fetch(zbx_db_result_t result)
+{
+	return __wrap_zbx_db_fetch_basic(result);
+}
+
+void	__wrap_zbx_recalc_time_period(time_t *tm_start, int table_group)
+{
+	ZBX_UNUSED(tm_start);
+	ZBX_UNUSED(table_group);
+}
+
+static zbx_trend_function_t	mock_str_to_trend_function(const char *str)
+{
+	if (0 == strcmp(str, "avg"))
+		return ZBX_TREND_FUNCTION_AVG;
+
+	if (0 == strcmp(str, "count"))
+		return ZBX_TREND_FUNCTION_COUNT;
+
+	if (0 == strcmp(str, "max"))
+		return ZBX_TREND_FUNCTION_MAX;
+
+	if (0 == strcmp(str, "min"))
+		return ZBX_TREND_FUNCTION_MIN;
+
+	if (0 == strcmp(str, "sum"))
+		return ZBX_TREND_FUNCTION_SUM;
+
+	fail_msg("unknown trend function \"%s\"", str);
+
+	return ZBX_TREND_FUNCTION_UNKNOWN;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_timespec_t		start, end;
+	zbx_trend_state_t	trend_state;
+	double			value;
+	int			ret;
+
+	ZBX_UNUSED(state);
+
+	if (0 != setenv("TZ", zbx_mock_get_parameter_string("in.timezone"), 1))
+		fail_msg("Cannot set 'TZ' environment variable: %s", zbx_strerror(errno));
+
+	tzset();
+
+	if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(zbx_mock_get_parameter_string("in.start"), &start))
+		fail_msg("Invalid period start time format");
+
+	if (ZBX_MOCK_SUCCESS != zbx_strtime_to_timespec(zbx_mock_get_parameter_string("in.end"), &end))
+		fail_msg("Invalid period end time format");
+
+	zbx_mockdb_init();
+	zbx_trends_rollups_init(1);
+
+	ret = zbx_trends_eval_rollup(zbx_mock_get_parameter_string("in.table"), 1, start.sec, end.sec,
+			mock_str_to_trend_function(zbx_mock_get_parameter_string("in.function")), &value, &trend_state);
+
+	zbx_mock_assert_result_eq("zbx_trends_eval_rollup() return value", SUCCEED, ret);
+	zbx_mock_assert_int_eq("trend state", ZBX_TREND_STATE_NORMAL, trend_state);
+	zbx_mock_assert_double_eq("trend value", atof(zbx_mock_get_parameter_string("out.value")), value);
+
+	zbx_mockdb_destroy();
+}
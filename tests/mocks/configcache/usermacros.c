@@ -80,6 +80,7 @@ void	mock_config_load_user_macros(const char *path)
 			host = (zbx_um_host_t *)zbx_malloc(NULL, sizeof(zbx_um_host_t));
 			host->hostid = host_local.hostid;
 			host->refcount = 0;
+			host->version = 0;
 			zbx_vector_um_macro_create(&host->macros);
 			zbx_vector_uint64_create(&host->templateids);
 
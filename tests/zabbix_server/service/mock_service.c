@@ -303,6 +303,12 @@ void	mock_init_service_cache(const char *path)
 		zbx_vector_ptr_sort(&service->children, ZBX_DEFAULT_PTR_COMPARE_FUNC);
 		zbx_vector_ptr_uniq(&service->children, ZBX_DEFAULT_PTR_COMPARE_FUNC);
 	}
+
+	zbx_hashset_iter_reset(&cache.services, &iter);
+
+	/* calculate children statistics used by status calculations */
+	while (NULL != (service = (zbx_service_t *)zbx_hashset_iter_next(&iter)))
+		service_update_children_stats(service);
 }
 
 void	mock_destroy_service_cache(void)
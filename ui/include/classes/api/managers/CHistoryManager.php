@@ -1351,6 +1351,15 @@ class CHistoryManager {
 			if (!DBexecute('DELETE FROM '.$table_name.' WHERE '.dbConditionInt('itemid', $itemids))) {
 				return false;
 			}
+
+			// Remove daily and monthly trend rollups together with the trends.
+			if ($table_name === 'trends' || $table_name === 'trends_uint') {
+				$sql = 'DELETE FROM '.$table_name.'_rollup WHERE '.dbConditionInt('itemid', $itemids);
+
+				if (!DBexecute($sql)) {
+					return false;
+				}
+			}
 		}
 
 		return true;
@@ -362,6 +362,7 @@ final class CItemData {
 		],
 		ITEM_TYPE_INTERNAL => [
 			'zabbix[boottime]',
+			'zabbix[calc_cache,<parameter>]',
 			'zabbix[connector_queue]',
 			'zabbix[discovery_queue]',
 			'zabbix[host,,items]',
@@ -373,6 +374,7 @@ final class CItemData {
 			'zabbix[items]',
 			'zabbix[items_unsupported]',
 			'zabbix[java,,<param>]',
+			'zabbix[latency,<stage>,<mode>]',
 			'zabbix[lld_queue]',
 			'zabbix[preprocessing_queue]',
 			'zabbix[process,<type>,<mode>,<state>]',
@@ -2753,6 +2755,13 @@ final class CItemData {
 					ITEM_TYPE_INTERNAL => 'config/items/itemtypes/internal#boottime'
 				]
 			],
+			'zabbix[calc_cache,<parameter>]' => [
+				'description' => _('Effectiveness of aggregate function results shared between calculated items. Valid parameters are: requests, hits, misses and phits.'),
+				'value_type' => null,
+				'documentation_link' => [
+					ITEM_TYPE_INTERNAL => 'config/items/itemtypes/internal#calc_cache'
+				]
+			],
 			'zabbix[connector_queue]' => [
 				'description' => _('Count of values enqueued in the connector queue.'),
 				'value_type' => ITEM_VALUE_TYPE_UINT64,
@@ -2830,6 +2839,13 @@ final class CItemData {
 					ITEM_TYPE_INTERNAL => 'config/items/itemtypes/internal#java'
 				]
 			],
+			'zabbix[latency,<stage>,<mode>]' => [
+				'description' => _('Latency of collected values at value processing <stage> (preprocessing, preprocessed, historycache, sync, history) since the value timestamp, in seconds. Valid modes are: avg (default), max, p50, p90, p95, p99 and count.'),
+				'value_type' => ITEM_VALUE_TYPE_FLOAT,
+				'documentation_link' => [
+					ITEM_TYPE_INTERNAL => 'config/items/itemtypes/internal#latency'
+				]
+			],
 			'zabbix[lld_queue]' => [
 				'description' => _('Count of values enqueued in the low-level discovery processing queue.'),
 				'value_type' => ITEM_VALUE_TYPE_UINT64,
@@ -22,7 +22,7 @@ define('ZABBIX_VERSION',		'7.0.0alpha8');
 define('ZABBIX_API_VERSION',	'7.0.0');
 define('ZABBIX_EXPORT_VERSION',	'7.0');
 
-define('ZABBIX_DB_VERSION',		6050143);
+define('ZABBIX_DB_VERSION',		6050145);
 
 define('DB_VERSION_SUPPORTED',						0);
 define('DB_VERSION_LOWER_THAN_MINIMUM',				1);
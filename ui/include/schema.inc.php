@@ -5131,6 +5131,99 @@ return [
 			]
 		]
 	],
+	'trends_rollup' => [
+		'key' => 'itemid,period,clock',
+		'fields' => [
+			'itemid' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_ID,
+				'length' => 20,
+				'ref_table' => 'items',
+				'ref_field' => 'itemid'
+			],
+			'period' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_INT,
+				'length' => 10,
+				'default' => '0'
+			],
+			'clock' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_INT,
+				'length' => 10,
+				'default' => '0'
+			],
+			'num' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_UINT,
+				'length' => 20,
+				'default' => '0'
+			],
+			'value_min' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_FLOAT,
+				'default' => '0.0000'
+			],
+			'value_avg' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_FLOAT,
+				'default' => '0.0000'
+			],
+			'value_max' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_FLOAT,
+				'default' => '0.0000'
+			]
+		]
+	],
+	'trends_uint_rollup' => [
+		'key' => 'itemid,period,clock',
+		'fields' => [
+			'itemid' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_ID,
+				'length' => 20,
+				'ref_table' => 'items',
+				'ref_field' => 'itemid'
+			],
+			'period' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_INT,
+				'length' => 10,
+				'default' => '0'
+			],
+			'clock' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_INT,
+				'length' => 10,
+				'default' => '0'
+			],
+			'num' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_UINT,
+				'length' => 20,
+				'default' => '0'
+			],
+			'value_min' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_UINT,
+				'length' => 20,
+				'default' => '0'
+			],
+			'value_avg' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_UINT,
+				'length' => 20,
+				'default' => '0'
+			],
+			'value_max' => [
+				'null' => false,
+				'type' => DB::FIELD_TYPE_UINT,
+				'length' => 20,
+				'default' => '0'
+			]
+		]
+	],
 	'acknowledges' => [
 		'key' => 'acknowledgeid',
 		'fields' => [